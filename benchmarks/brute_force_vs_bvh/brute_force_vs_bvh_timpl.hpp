@@ -10,10 +10,12 @@
  ****************************************************************************/
 
 #include <ArborX_BruteForce.hpp>
+#include <ArborX_BucketedBVH.hpp>
 #include <ArborX_HyperBox.hpp>
 #include <ArborX_HyperPoint.hpp>
 #include <ArborX_HyperSphere.hpp>
 #include <ArborX_LinearBVH.hpp>
+#include <ArborX_WideBVH.hpp>
 
 #include <Kokkos_Core.hpp>
 
@@ -107,6 +109,38 @@ static void run_fp(int nprimitives, int nqueries, int nrepeats)
       out_count = indices.extent(0);
     }
 
+    {
+      Kokkos::Timer timer;
+      ArborX::Experimental::WideBoundingVolumeHierarchy<MemorySpace, 4, Box>
+          wide_bvh{space, primitives};
+
+      Kokkos::View<int *, ExecutionSpace> indices("Benchmark::indices", 0);
+      Kokkos::View<int *, ExecutionSpace> offset("Benchmark::offset", 0);
+      wide_bvh.query(space, predicates, indices, offset);
+
+      space.fence();
+      double time = timer.seconds();
+      printf("Time WBVH : %lf\n", time);
+      assert(out_count == indices.extent(0));
+    }
+
+    {
+      Kokkos::Timer timer;
+      ArborX::Experimental::BucketedBoundingVolumeHierarchy<
+          MemorySpace, Box,
+          ArborX::ExperimentalHyperGeometry::Point<DIM, FloatingPoint>>
+          bucketed_bvh{space, primitives};
+
+      Kokkos::View<int *, ExecutionSpace> indices("Benchmark::indices", 0);
+      Kokkos::View<int *, ExecutionSpace> offset("Benchmark::offset", 0);
+      bucketed_bvh.query(space, predicates, indices, offset);
+
+      space.fence();
+      double time = timer.seconds();
+      printf("Time BBVH : %lf\n", time);
+      assert(out_count == indices.extent(0));
+    }
+
     {
       Kokkos::Timer timer;
       ArborX::BruteForce<MemorySpace, Box> brute{space, primitives};
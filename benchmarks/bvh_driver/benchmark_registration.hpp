@@ -12,13 +12,22 @@
 #ifndef BENCHMARK_REGISTRATION_HPP
 #define BENCHMARK_REGISTRATION_HPP
 
+#include <ArborX_DetailsNode.hpp>
+#include <ArborX_DetailsQuantizedNode.hpp>
+#include <ArborX_DetailsSortUtils.hpp>
+#include <ArborX_DetailsTreeConstruction.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_IndexableGetter.hpp>
 #include <ArborX_Point.hpp>
 #include <ArborX_Predicates.hpp>
+#include <ArborX_SpaceFillingCurves.hpp>
 
 #include <Kokkos_Core.hpp>
 
 #include <chrono>
 #include <cmath> // cbrt
+#include <type_traits>
+#include <utility>
 
 #include <benchmark/benchmark.h>
 #include <point_clouds.hpp>
@@ -58,9 +67,12 @@ struct Spec
       throw std::runtime_error("Backend " + backends + " invalid!");
   }
 
-  std::string create_label_construction(std::string const &tree_name) const
+  std::string create_label_construction(std::string const &tree_name,
+                                        std::string const &stage = "") const
   {
-    std::string s = std::string("BM_construction<") + tree_name + ">";
+    std::string s = std::string("BM_construction") +
+                    (stage.empty() ? "" : "_" + stage) + "<" + tree_name +
+                    ">";
     for (auto const &var :
          {n_values, static_cast<int>(source_point_cloud_type)})
       s += "/" + std::to_string(var);
@@ -109,7 +121,8 @@ constructPoints(int n_values, PointCloudType point_cloud_type)
   // boxes 2x2x2 centered around a random point) will remain constant as
   // problem size is changed.
   auto const a = std::cbrt(n_values);
-  generatePointCloud(point_cloud_type, a, random_points);
+  generatePointCloud(typename DeviceType::execution_space{}, point_cloud_type,
+                     a, random_points);
 
   return random_points;
 }
@@ -124,7 +137,8 @@ makeSpatialQueries(int n_values, int n_queries, int n_neighbors,
                          "Benchmark::random_points"),
       n_queries);
   auto const a = std::cbrt(n_values);
-  generatePointCloud(target_point_cloud_type, a, random_points);
+  generatePointCloud(typename DeviceType::execution_space{},
+                     target_point_cloud_type, a, random_points);
 
   Kokkos::View<decltype(ArborX::intersects(ArborX::Sphere{})) *, DeviceType>
       queries(
@@ -154,7 +168,8 @@ makeNearestQueries(int n_values, int n_queries, int n_neighbors,
                          "Benchmark::random_points"),
       n_queries);
   auto const a = std::cbrt(n_values);
-  generatePointCloud(target_point_cloud_type, a, random_points);
+  generatePointCloud(typename DeviceType::execution_space{},
+                     target_point_cloud_type, a, random_points);
 
   Kokkos::View<ArborX::Nearest<ArborX::Point> *, DeviceType> queries(
       Kokkos::view_alloc(Kokkos::WithoutInitializing, "Benchmark::queries"),
@@ -229,6 +244,125 @@ void BM_construction(benchmark::State &state, Spec const &spec)
       spec.n_values, benchmark::Counter::kIsIterationInvariantRate);
 }
 
+// Stages of the construction of a BVH along the Morton curve
+enum class ConstructionStage
+{
+  SceneBoundingBox,
+  LinearOrdering,
+  Sort,
+  Hierarchy
+};
+
+// Time one stage of the construction at a time. The stages preceding it are
+// run once before the timing loop, so that each stage is given the same input
+// as in the constructor.
+template <typename ExecutionSpace, class TreeType>
+void BM_construction_stage(benchmark::State &state, Spec const &spec,
+                           ConstructionStage stage)
+{
+  using MemorySpace = typename TreeType::memory_space;
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+  namespace TreeConstruction = ArborX::Details::TreeConstruction;
+
+  auto const points =
+      constructPoints<DeviceType>(spec.n_values, spec.source_point_cloud_type);
+  int const n = points.extent(0);
+  using Points = std::decay_t<decltype(points)>;
+  ArborX::Details::Indexables<Points> const indexables{points};
+
+  ExecutionSpace exec_space;
+
+  ArborX::ExperimentalHyperGeometry::Box<3> scene_bounding_box{};
+  TreeConstruction::calculateBoundingBoxOfTheScene(exec_space, indexables,
+                                                   scene_bounding_box);
+
+  ArborX::Experimental::Morton64 const curve;
+  Kokkos::View<unsigned long long *, MemorySpace> linear_ordering(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "Benchmark::linear_ordering"),
+      n);
+  TreeConstruction::projectOntoSpaceFillingCurve(
+      exec_space, indexables, curve, scene_bounding_box, linear_ordering);
+
+  Kokkos::View<unsigned long long *, MemorySpace> sorted_linear_ordering(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "Benchmark::sorted_linear_ordering"),
+      n);
+  Kokkos::deep_copy(exec_space, sorted_linear_ordering, linear_ordering);
+  auto const permutation_indices =
+      ArborX::Details::sortObjects(exec_space, sorted_linear_ordering);
+
+  using BoundingVolume = ArborX::Box;
+  using LeafNode = ArborX::Details::LeafNode<
+      ArborX::Details::PairIndexVolume<BoundingVolume>>;
+  using InternalNode =
+      typename ArborX::Details::InternalNodeTraits<BoundingVolume>::type;
+  Kokkos::View<LeafNode *, MemorySpace> leaf_nodes(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "Benchmark::leaf_nodes"),
+      n);
+  Kokkos::View<InternalNode *, MemorySpace> internal_nodes(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "Benchmark::internal_nodes"),
+      n > 1 ? n - 1 : 0);
+
+  for (auto _ : state)
+  {
+    // Sorting is in place, so its input is restored outside of the timing
+    if (stage == ConstructionStage::Sort)
+      Kokkos::deep_copy(exec_space, sorted_linear_ordering, linear_ordering);
+
+    exec_space.fence();
+    auto const start = std::chrono::high_resolution_clock::now();
+
+    switch (stage)
+    {
+    case ConstructionStage::SceneBoundingBox:
+    {
+      ArborX::ExperimentalHyperGeometry::Box<3> bbox{};
+      TreeConstruction::calculateBoundingBoxOfTheScene(exec_space, indexables,
+                                                       bbox);
+      break;
+    }
+    case ConstructionStage::LinearOrdering:
+      TreeConstruction::projectOntoSpaceFillingCurve(
+          exec_space, indexables, curve, scene_bounding_box, linear_ordering);
+      break;
+    case ConstructionStage::Sort:
+      ArborX::Details::sortObjects(exec_space, sorted_linear_ordering);
+      break;
+    case ConstructionStage::Hierarchy:
+    {
+      // Quantized internal nodes are generated on the grid spanned by the
+      // bounds of the scene
+      BoundingVolume bounds;
+      if constexpr (ArborX::Details::is_quantized_internal_node<
+                        InternalNode>::value)
+      {
+        for (int d = 0; d < 3; ++d)
+        {
+          bounds.minCorner()[d] = scene_bounding_box.minCorner()[d];
+          bounds.maxCorner()[d] = scene_bounding_box.maxCorner()[d];
+        }
+      }
+      TreeConstruction::generateHierarchy(
+          exec_space,
+          ArborX::Details::LegacyValues<Points, BoundingVolume>{points},
+          ArborX::Details::DefaultIndexableGetter{}, permutation_indices,
+          sorted_linear_ordering, leaf_nodes, internal_nodes, bounds);
+      break;
+    }
+    }
+
+    exec_space.fence();
+    auto const end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+  state.counters["rate"] = benchmark::Counter(
+      spec.n_values, benchmark::Counter::kIsIterationInvariantRate);
+}
+
 template <typename ExecutionSpace, class TreeType>
 void BM_radius_search(benchmark::State &state, Spec const &spec)
 {
@@ -388,6 +522,24 @@ void register_benchmark_construction(Spec const &spec,
       ->Unit(benchmark::kMicrosecond);
 }
 
+template <typename ExecutionSpace, typename TreeType>
+void register_benchmark_construction_stages(Spec const &spec,
+                                            std::string const &description)
+{
+  for (auto [stage, name] :
+       {std::make_pair(ConstructionStage::SceneBoundingBox, "bounding_box"),
+        std::make_pair(ConstructionStage::LinearOrdering, "linear_ordering"),
+        std::make_pair(ConstructionStage::Sort, "sort"),
+        std::make_pair(ConstructionStage::Hierarchy, "hierarchy")})
+    benchmark::RegisterBenchmark(
+        spec.create_label_construction(description, name).c_str(),
+        [=, stage = stage](benchmark::State &state) {
+          BM_construction_stage<ExecutionSpace, TreeType>(state, spec, stage);
+        })
+        ->UseManualTime()
+        ->Unit(benchmark::kMicrosecond);
+}
+
 template <typename ExecutionSpace, typename TreeType>
 void register_benchmark_spatial_query_no_callback(
     Spec const &spec, std::string const &description)
@@ -41,6 +41,8 @@ struct BenchmarkRegistration<ExecutionSpace, ArborX::BVH<MemorySpace>>
   {
     register_benchmark_construction<ExecutionSpace, TreeType>(spec,
                                                               description);
+    register_benchmark_construction_stages<ExecutionSpace, TreeType>(
+        spec, description);
     register_benchmark_spatial_query_no_callback<ExecutionSpace, TreeType>(
         spec, description);
     register_benchmark_spatial_query_callback<ExecutionSpace, TreeType>(
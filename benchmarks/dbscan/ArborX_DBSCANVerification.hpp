@@ -12,14 +12,15 @@
 #ifndef ARBORX_DETAILSDBSCANVERIFICATION_HPP
 #define ARBORX_DETAILSDBSCANVERIFICATION_HPP
 
+#include <ArborX_DetailsSortUtils.hpp>
+#include <ArborX_DetailsUnionFind.hpp>
 #include <ArborX_DetailsUtils.hpp>
 #include <ArborX_HyperBox.hpp>
 #include <ArborX_LinearBVH.hpp>
 
 #include <Kokkos_Core.hpp>
 
-#include <set>
-#include <stack>
+#include <algorithm>
 #include <vector>
 
 namespace ArborX
@@ -159,107 +160,81 @@ bool verifyBorderAndNoisePoints(ExecutionSpace const &exec_space,
   return (num_incorrect == 0);
 }
 
-// Check that cluster indices are unique
+// Check that cluster indices are unique, i.e., that the core points of
+// distinct components of the graph connecting core points within distance
+// eps of each other have distinct indices. The components are found with a
+// union-find, and the core points are sorted by index, so that points with the
+// same index are next to each other and compared. Border points are left out,
+// so that two clusters bridged through a border point are caught.
 template <typename ExecutionSpace, typename IndicesView, typename OffsetView,
           typename LabelsView>
 bool verifyClustersAreUnique(ExecutionSpace const &exec_space,
                              IndicesView indices, OffsetView offset,
                              LabelsView labels, int core_min_size)
 {
-  int n = labels.size();
+  using MemorySpace = typename LabelsView::memory_space;
 
-  // FIXME we don't want to modify the labels view in this check. What we
-  // want here is to create a view on the host, and deep_copy into it.
-  // create_mirror_view_and_copy won't work, because it is a no-op if labels
-  // is already on the host.
-  decltype(Kokkos::create_mirror_view(Kokkos::HostSpace{},
-                                      std::declval<LabelsView>()))
-      labels_host(Kokkos::view_alloc(Kokkos::WithoutInitializing,
-                                     "ArborX::DBSCAN::labels_host"),
-                  labels.size());
-  Kokkos::deep_copy(exec_space, labels_host, labels);
-  auto offset_host =
-      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset);
-  auto indices_host =
-      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices);
-
-  auto is_core_point = [&](int i) {
-    return offset_host(i + 1) - offset_host(i) >= core_min_size;
-  };
-
-  // Remove all border points from consideration (noise points are already -1)
-  // The idea is that this way if labels were bridged through a border
-  // point, we will count them as separate labels but with a shared cluster
-  // index, which will fail the unique labels check
-  for (int i = 0; i < n; ++i)
-  {
-    if (!is_core_point(i))
-    {
-      for (int jj = offset_host(i); jj < offset_host(i + 1); ++jj)
-      {
-        int j = indices_host(jj);
-        if (is_core_point(j))
+  int n = labels.size();
+  if (n == 0)
+    return true;
+
+  Kokkos::View<int *, MemorySpace> components(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::components"),
+      n);
+  ArborX::iota(exec_space, components);
+  UnionFind<MemorySpace> union_find(components);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::verify_unique_clusters::connect_core_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        if (offset(i + 1) - offset(i) < core_min_size)
+          return;
+        for (int jj = offset(i); jj < offset(i + 1); ++jj)
         {
-          // The point is a border point
-          labels_host(i) = -1;
-          break;
+          int j = indices(jj);
+          if (offset(j + 1) - offset(j) >= core_min_size)
+            union_find.merge(i, j);
         }
-      }
-    }
-  }
-
-  // Record all unique cluster indices
-  std::set<int> unique_cluster_indices;
-  for (int i = 0; i < n; ++i)
-    if (labels_host(i) != -1)
-      unique_cluster_indices.insert(labels_host(i));
-  auto num_unique_cluster_indices = unique_cluster_indices.size();
-
-  // Record all cluster indices, assigning a unique index to each (which is
-  // different from the original cluster index). This will only use noise and
-  // core points (see above).
-  unsigned int num_clusters = 0;
-  std::set<int> cluster_sets;
-  for (int i = 0; i < n; ++i)
-  {
-    if (labels_host(i) >= 0)
-    {
-      auto id = labels_host(i);
-      cluster_sets.insert(id);
-      num_clusters++;
-
-      // DFS search
-      std::stack<int> stack;
-      stack.push(i);
-      while (!stack.empty())
-      {
-        auto k = stack.top();
-        stack.pop();
-        if (labels_host(k) >= 0)
+      });
+
+  // Core points have nonnegative indices, as checked before, so that the
+  // other points can be given -1
+  Kokkos::View<int *, MemorySpace> core_labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::core_labels"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::verify_unique_clusters::find_components",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        bool self_is_core_point = (offset(i + 1) - offset(i) >= core_min_size);
+        core_labels(i) = self_is_core_point ? labels(i) : -1;
+        components(i) = union_find.representative(i);
+      });
+  auto const permute = sortObjects(exec_space, core_labels);
+
+  int num_incorrect = 0;
+  Kokkos::parallel_reduce(
+      "ArborX::DBSCAN::verify_unique_clusters",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 1, n),
+      KOKKOS_LAMBDA(int k, int &update) {
+        int i = permute(k - 1);
+        int j = permute(k);
+        if (core_labels(k) >= 0 && core_labels(k) == core_labels(k - 1) &&
+            components(i) != components(j))
         {
-          labels_host(k) = -1;
-          for (int jj = offset_host(k); jj < offset_host(k + 1); ++jj)
-          {
-            int j = indices_host(jj);
-            if (is_core_point(j) || (labels_host(j) == id))
-              stack.push(j);
-          }
+#ifdef __SYCL_DEVICE_ONLY__
+          using sycl::ext::oneapi::experimental::printf;
+#endif
+          printf("Disconnected cores belong to the same cluster: "
+                 "%d [%d] -> %d [%d]\n",
+                 i, labels(i), j, labels(j));
+          update++;
         }
-      }
-    }
-  }
-  if (cluster_sets.size() != num_unique_cluster_indices)
-  {
-    std::cerr << "Number of components does not match" << std::endl;
-    return false;
-  }
-  if (num_clusters != num_unique_cluster_indices)
-  {
-    std::cerr << "Cluster IDs are not unique" << std::endl;
-    return false;
-  }
-
-  return true;
+      },
+      num_incorrect);
+  return (num_incorrect == 0);
 }
 
 template <typename ExecutionSpace, typename IndicesView, typename OffsetView,
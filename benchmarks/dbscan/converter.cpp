@@ -21,6 +21,8 @@
 #include <stdexcept>
 #include <vector>
 
+#include "point_cloud_file.hpp"
+
 #ifdef _MSC_VER
 #define ARBORX_STRTOK_R strtok_s
 #else
@@ -59,6 +61,8 @@ public:
     assert(d < dimension());
     return _data[d];
   }
+
+  std::vector<std::vector<float>> const &columns() const { return _data; }
 };
 
 auto loadHACCData(std::string const &filename)
@@ -443,6 +447,7 @@ int main(int argc, char *argv[])
   std::string input_file;
   std::string output_file;
   std::string reader;
+  bool legacy;
 
   bpo::options_description desc("Allowed options");
   // clang-format off
@@ -451,6 +456,7 @@ int main(int argc, char *argv[])
         ( "input", bpo::value<std::string>(&input_file), "file containing data" )
         ( "output", bpo::value<std::string>(&output_file), "file to contain the results" )
         ( "reader", bpo::value<std::string>(&reader), "reader type" )
+        ( "legacy", bpo::bool_switch(&legacy), "write the legacy row-wise binary format instead of the columnar point cloud format" )
         ;
   // clang-format on
   bpo::variables_map vm;
@@ -464,6 +470,13 @@ int main(int argc, char *argv[])
   }
 
   auto points = loadData(input_file, reader);
+
+  if (!legacy)
+  {
+    ArborXBenchmark::writePointCloud(output_file, points.columns());
+    return EXIT_SUCCESS;
+  }
+
   int n = points.size();
   int dim = points.dimension();
 
@@ -18,6 +18,8 @@
 #include <random>
 #include <vector>
 
+#include "point_cloud_file.hpp"
+
 using ArborX::ExperimentalHyperGeometry::Point;
 
 template <int DIM>
@@ -59,6 +61,36 @@ std::vector<Point<DIM>> loadData(std::string const &filename,
             << (binary ? "binary" : "text") << " mode...";
   std::cout.flush();
 
+  std::vector<Point<DIM>> v;
+
+  if (binary && ArborXBenchmark::isPointCloudFile(filename))
+  {
+    ArborXBenchmark::MappedFile const file(filename);
+    auto const header = file.header();
+    ARBORX_ASSERT((int)header.dim == DIM);
+
+    int num_points = header.count;
+    if (max_num_points > 0 && max_num_points < num_points)
+      num_points = max_num_points;
+
+    v.resize(num_points);
+    for (int d = 0; d < DIM; ++d)
+    {
+      auto const *column = file.column(header, d);
+      for (int i = 0; i < num_points; ++i)
+        v[i][d] = (header.dtype == ArborXBenchmark::PointCloudDataType::Float32
+                       ? reinterpret_cast<float const *>(column)[i]
+                       : reinterpret_cast<double const *>(column)[i]);
+    }
+    std::cout << "done\nRead in " << num_points << " " << DIM << "D points"
+              << std::endl;
+
+    if (num_samples > 0 && num_samples < (int)v.size())
+      v = sampleData(v, num_samples);
+
+    return v;
+  }
+
   std::ifstream input;
   if (!binary)
     input.open(filename);
@@ -66,8 +98,6 @@ std::vector<Point<DIM>> loadData(std::string const &filename,
     input.open(filename, std::ifstream::binary);
   ARBORX_ASSERT(input.good());
 
-  std::vector<Point<DIM>> v;
-
   int num_points = 0;
   int dim = 0;
   if (!binary)
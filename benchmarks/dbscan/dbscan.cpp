@@ -10,7 +10,9 @@
  ****************************************************************************/
 
 #include "dbscan.hpp"
+#include "point_cloud_file.hpp"
 
+#include <ArborX_DimensionDispatch.hpp>
 #include <ArborX_Version.hpp>
 
 #include <Kokkos_Core.hpp>
@@ -28,6 +30,9 @@
 // which would result in multiple duplicate symbols. So it is kept here.
 int getDataDimension(std::string const &filename, bool binary)
 {
+  if (binary && ArborXBenchmark::isPointCloudFile(filename))
+    return ArborXBenchmark::MappedFile(filename).header().dim;
+
   std::ifstream input;
   if (!binary)
     input.open(filename);
@@ -79,8 +84,10 @@ int main(int argc, char *argv[])
   int dim;
 
   std::vector<std::string> allowed_algorithms = {"dbscan", "hdbscan", "mst"};
-  std::vector<std::string> allowed_dendrograms = {"boruvka", "union-find"};
-  std::vector<std::string> allowed_impls = {"fdbscan", "fdbscan-densebox"};
+  std::vector<std::string> allowed_dendrograms = {"boruvka", "union-find",
+                                                 "parallel-union-find"};
+  std::vector<std::string> allowed_impls = {"fdbscan", "fdbscan-densebox",
+                                           "fdbscan-cellstencil"};
 
   bpo::options_description desc("Allowed options");
   // clang-format off
@@ -99,6 +106,7 @@ int main(int argc, char *argv[])
       ( "max-num-points", bpo::value<int>(&params.max_num_points)->default_value(-1), "max number of points to read in")
       ( "n", bpo::value<int>(&params.n)->default_value(10), "number of points to generate" )
       ( "samples", bpo::value<int>(&params.num_samples)->default_value(-1), "number of samples" )
+      ( "shifted-dense-cells", bpo::bool_switch(&params.shifted_dense_cells), "look for dense cells in a shifted grid (fdbscan-densebox)")
       ( "variable-density", bpo::bool_switch(&params.variable_density), "type of cluster density to generate" )
       ( "verbose", bpo::bool_switch(&params.verbose), "verbose")
       ( "verify", bpo::bool_switch(&params.verify), "verify connected components")
@@ -153,6 +161,8 @@ int main(int argc, char *argv[])
     printf("eps               : %f\n", params.eps);
     printf("cluster min size  : %d\n", params.cluster_min_size);
     printf("implementation    : %s\n", ss.str().c_str());
+    printf("shifted cells     : %s\n",
+           (params.shifted_dense_cells ? "true" : "false"));
     printf("verify            : %s\n", (params.verify ? "true" : "false"));
   }
   if (params.algorithm == "hdbscan")
@@ -183,28 +193,12 @@ int main(int argc, char *argv[])
 
   using ArborXBenchmark::run;
 
-  bool success;
-  switch (dim)
-  {
-  case 2:
-    success = run<2>(params);
-    break;
-  case 3:
-    success = run<3>(params);
-    break;
-  case 4:
-    success = run<4>(params);
-    break;
-  case 5:
-    success = run<5>(params);
-    break;
-  case 6:
-    success = run<6>(params);
-    break;
-  default:
+  bool success = false;
+  if (!ArborX::Experimental::dispatchDimension<
+          ARBORX_BENCHMARK_DBSCAN_DIMENSIONS>(dim, [&](auto dim_c) {
+        success = run<decltype(dim_c)::value>(params);
+      }))
     std::cerr << "Error: dimension " << dim << " not allowed\n" << std::endl;
-    success = false;
-  }
 
   return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -28,6 +28,7 @@ struct Parameters
   int max_num_points;
   int n;
   int num_samples;
+  bool shifted_dense_cells;
   bool variable_density;
   bool verbose;
   bool verify;
@@ -21,6 +21,7 @@
 
 #include "data.hpp"
 #include "dbscan.hpp"
+#include "point_cloud_loader.hpp"
 #include "print_timers.hpp"
 
 using ArborX::ExperimentalHyperGeometry::Point;
@@ -169,20 +170,39 @@ bool ArborXBenchmark::run(ArborXBenchmark::Parameters const &params)
 
   ExecutionSpace exec_space;
 
-  std::vector<ArborX::ExperimentalHyperGeometry::Point<DIM>> data;
-  if (!params.filename.empty())
+  using Point = ArborX::ExperimentalHyperGeometry::Point<DIM>;
+
+  Kokkos::View<Point *, MemorySpace> primitives;
+  if (!params.filename.empty() && params.binary && params.num_samples <= 0 &&
+      isPointCloudFile(params.filename))
   {
-    // Read in data
-    data = loadData<DIM>(params.filename, params.binary, params.max_num_points,
-                         params.num_samples);
+    // Map the columnar file and read it in parallel straight into the view
+    std::cout << "Reading in \"" << params.filename
+              << "\" as a point cloud...";
+    std::cout.flush();
+    primitives = loadPointCloud<DIM, MemorySpace>(
+        exec_space, params.filename, 0,
+        (params.max_num_points > 0 ? params.max_num_points : -1));
+    std::cout << "done\nRead in " << primitives.size() << " " << DIM
+              << "D points" << std::endl;
   }
   else
   {
-    // Generate data
-    data = GanTao<DIM>(params.n, params.variable_density);
-  }
+    std::vector<Point> data;
+    if (!params.filename.empty())
+    {
+      // Read in data
+      data = loadData<DIM>(params.filename, params.binary,
+                           params.max_num_points, params.num_samples);
+    }
+    else
+    {
+      // Generate data
+      data = GanTao<DIM>(params.n, params.variable_density);
+    }
 
-  auto const primitives = vec2view<MemorySpace>(data, "Benchmark::primitives");
+    primitives = vec2view<MemorySpace>(data, "Benchmark::primitives");
+  }
 
   using Primitives = decltype(primitives);
 
@@ -194,10 +214,13 @@ bool ArborXBenchmark::run(ArborXBenchmark::Parameters const &params)
     Implementation implementation = Implementation::FDBSCAN;
     if (params.implementation == "fdbscan-densebox")
       implementation = Implementation::FDBSCAN_DenseBox;
+    else if (params.implementation == "fdbscan-cellstencil")
+      implementation = Implementation::FDBSCAN_CellStencil;
 
     ArborX::DBSCAN::Parameters dbscan_params;
     dbscan_params.setVerbosity(params.verbose)
-        .setImplementation(implementation);
+        .setImplementation(implementation)
+        .setShiftedDenseCells(params.shifted_dense_cells);
 
     Kokkos::Profiling::pushRegion("ArborX::DBSCAN::total");
 
@@ -223,6 +246,10 @@ bool ArborXBenchmark::run(ArborXBenchmark::Parameters const &params)
       if (implementation == ArborX::DBSCAN::Implementation::FDBSCAN_DenseBox)
         printf("-- dense cells      : %10.3f\n",
                ArborX_Benchmark::get_time("ArborX::DBSCAN::dense_cells"));
+      if (implementation ==
+          ArborX::DBSCAN::Implementation::FDBSCAN_CellStencil)
+        printf("-- cells            : %10.3f\n",
+               ArborX_Benchmark::get_time("ArborX::DBSCAN::cells"));
       printf("-- construction     : %10.3f\n",
              ArborX_Benchmark::get_time("ArborX::DBSCAN::tree_construction"));
       printf("-- query+cluster    : %10.3f\n",
@@ -264,6 +291,8 @@ bool ArborXBenchmark::run(ArborXBenchmark::Parameters const &params)
     DendrogramImplementation dendrogram_impl;
     if (params.dendrogram == "union-find")
       dendrogram_impl = DendrogramImplementation::UNION_FIND;
+    else if (params.dendrogram == "parallel-union-find")
+      dendrogram_impl = DendrogramImplementation::PARALLEL_UNION_FIND;
     else if (params.dendrogram == "boruvka")
       dendrogram_impl = DendrogramImplementation::BORUVKA;
     else
@@ -9,6 +9,7 @@
  * SPDX-License-Identifier: BSD-3-Clause                                    *
  ****************************************************************************/
 
+#include <ArborX_DistributedRepartition.hpp>
 #include <ArborX_DistributedTree.hpp>
 #include <ArborX_Version.hpp>
 
@@ -20,13 +21,18 @@
 #include <chrono>
 #include <cmath> // sqrt, cbrt
 #include <iomanip>
+#include <map>
 #include <numeric>
 #include <random>
+#include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include <mpi.h>
 
+#include <point_cloud_mpi_loader.hpp>
+
 struct HelpPrinted
 {};
 
@@ -168,6 +174,129 @@ public:
   }
 };
 
+// Minimum, mean and maximum over the processes of quantities that may only be
+// known to some of them, e.g. the phases of a search reached by some ranks
+// only, printed along with the imbalance max / mean. Processes missing a
+// quantity count as zeros.
+inline void summarizeOverProcesses(MPI_Comm comm, std::string const &title,
+                                   std::map<std::string, double> const &local,
+                                   std::ostream &os = std::cout)
+{
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+
+  // Gather the names of the quantities of all the processes on the first one
+  std::string names;
+  for (auto const &[name, value] : local)
+    names += name + '\n';
+  int const length = names.size();
+  std::vector<int> lengths(comm_size);
+  MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, comm);
+  std::vector<int> displacements(comm_size + 1, 0);
+  std::partial_sum(lengths.begin(), lengths.end(), displacements.begin() + 1);
+  std::string all_names(displacements.back(), ' ');
+  MPI_Gatherv(names.data(), length, MPI_CHAR, all_names.data(), lengths.data(),
+              displacements.data(), MPI_CHAR, 0, comm);
+
+  // and broadcast their union (sorted, through the map)
+  std::map<std::string, double> values;
+  if (comm_rank == 0)
+  {
+    std::istringstream is(all_names);
+    for (std::string name; std::getline(is, name);)
+      values[name] = 0.;
+    names.clear();
+    for (auto const &[name, value] : values)
+      names += name + '\n';
+  }
+  int n_chars = names.size();
+  MPI_Bcast(&n_chars, 1, MPI_INT, 0, comm);
+  names.resize(n_chars);
+  MPI_Bcast(names.data(), n_chars, MPI_CHAR, 0, comm);
+  if (comm_rank != 0)
+  {
+    std::istringstream is(names);
+    for (std::string name; std::getline(is, name);)
+      values[name] = 0.;
+  }
+
+  std::vector<double> mins;
+  for (auto &[name, value] : values)
+  {
+    auto const it = local.find(name);
+    value = (it != local.end() ? it->second : 0.);
+    mins.push_back(value);
+  }
+  int const n = mins.size();
+  std::vector<double> maxs = mins;
+  std::vector<double> sums = mins;
+  MPI_Allreduce(MPI_IN_PLACE, mins.data(), n, MPI_DOUBLE, MPI_MIN, comm);
+  MPI_Allreduce(MPI_IN_PLACE, maxs.data(), n, MPI_DOUBLE, MPI_MAX, comm);
+  MPI_Allreduce(MPI_IN_PLACE, sums.data(), n, MPI_DOUBLE, MPI_SUM, comm);
+
+  if (comm_rank != 0)
+    return;
+
+  std::size_t width = title.size();
+  for (auto const &[name, value] : values)
+    width = std::max(width, name.size());
+  std::string const header =
+      " | MinOverProcs | MeanOverProcs | MaxOverProcs | Max/Mean";
+  os << std::left << std::scientific;
+  os << std::string(width + header.size(), '=') << "\n\n";
+  os << std::setw(width) << title << header << '\n';
+  os << std::string(width + header.size(), '-') << '\n';
+  int i = 0;
+  for (auto const &[name, value] : values)
+  {
+    double const mean = sums[i] / comm_size;
+    os << std::setw(width) << name << " | " << mins[i] << " |  " << mean
+       << " | " << maxs[i] << " | " << (mean > 0 ? maxs[i] / mean : 1.)
+       << '\n';
+    ++i;
+  }
+  os << std::string(width + header.size(), '=') << '\n';
+}
+
+// Wall-clock times of the profiling regions entered by the library, e.g.
+// ArborX::DistributedTree::forwardQueries, recorded through the region
+// callbacks of the profiling interface while enabled. The device is fenced
+// when entering and leaving a region so that each one accounts for its own
+// kernels, which delays the asynchronous ones. The times of the regions
+// entered several times, e.g. in each round of the nearest search, are
+// summed, and the enclosing regions include the nested ones.
+struct PhaseMonitor
+{
+  static inline std::vector<std::pair<std::string, Kokkos::Timer>> open;
+  static inline std::map<std::string, double> seconds;
+
+  static void push(char const *label)
+  {
+    Kokkos::fence("Benchmark::PhaseMonitor::push");
+    open.emplace_back(label, Kokkos::Timer{});
+  }
+  static void pop()
+  {
+    Kokkos::fence("Benchmark::PhaseMonitor::pop");
+    seconds[open.back().first] += open.back().second.seconds();
+    open.pop_back();
+  }
+
+  static void enable()
+  {
+    seconds.clear();
+    Kokkos::Profiling::Experimental::set_push_region_callback(&push);
+    Kokkos::Profiling::Experimental::set_pop_region_callback(&pop);
+  }
+  static void disable()
+  {
+    Kokkos::Profiling::Experimental::set_push_region_callback(nullptr);
+    Kokkos::Profiling::Experimental::set_pop_region_callback(nullptr);
+  }
+};
+
 template <typename DeviceType>
 struct NearestNeighborsSearches
 {
@@ -233,6 +362,10 @@ int main_(std::vector<std::string> const &args, const MPI_Comm comm)
   bool perform_knn_search = true;
   bool perform_radius_search = true;
   bool shift_queries = false;
+  std::string filename;
+  double radius_override;
+  bool repartition = false;
+  bool report_phases = false;
 
   bpo::options_description desc("Allowed options");
   // clang-format off
@@ -253,6 +386,16 @@ int main_(std::vector<std::string> const &args, const MPI_Comm comm)
         ( "shift-queries" , "By default, points are reused for the queries. Enabling this option shrinks the local box queries are created "
                             "in to a third of its size and moves it to the center of the global box. The result is a huge imbalance for the "
                             "number of queries that need to be processed by each processor.")
+        ( "filename", bpo::value<std::string>(&filename), "Columnar 3D point cloud file to read the values from instead of generating them. "
+                                                            "The file is split evenly among the MPI ranks, which read their range in "
+                                                            "parallel with MPI-IO, and --values is ignored. The queries are the first values "
+                                                            "of each rank." )
+        ( "repartition", "Repartition the values read from the file along a space-filling curve before building the tree." )
+        ( "radius", bpo::value<double>(&radius_override)->default_value(-1.), "Radius of the searches. By default, computed for the "
+                                                                             "number of neighbors in uniformly distributed clouds." )
+        ( "report-phases", "Time the phases of the searches on each rank (deviseStrategy, forwardQueries, bottom tree queries, "
+                           "communicateResultsBack, sortResults, ...) and report their imbalance over the ranks along with the "
+                           "numbers of queries received and of results returned. The device is fenced around each phase." )
         ;
   // clang-format on
   bpo::variables_map vm;
@@ -277,6 +420,10 @@ int main_(std::vector<std::string> const &args, const MPI_Comm comm)
     perform_radius_search = false;
   if (vm.count("shift-queries") > 0)
     shift_queries = true;
+  if (vm.count("repartition") > 0)
+    repartition = true;
+  if (vm.count("report-phases") > 0)
+    report_phases = true;
 
   if (comm_rank == 0)
   {
@@ -289,6 +436,9 @@ int main_(std::vector<std::string> const &args, const MPI_Comm comm)
               << "size of shift           : " << shift << '\n'
               << "dimension               : " << partition_dim << '\n'
               << "shift-queries           : " << shift_queries << '\n'
+              << "filename                : " << filename << '\n'
+              << "repartition             : " << repartition << '\n'
+              << "report phases           : " << report_phases << '\n'
               << '\n';
   }
 
@@ -298,6 +448,40 @@ int main_(std::vector<std::string> const &args, const MPI_Comm comm)
   Kokkos::View<ArborX::Point *, DeviceType> random_queries(
       Kokkos::view_alloc(Kokkos::WithoutInitializing, "Benchmark::queries"),
       n_queries);
+  if (!filename.empty())
+  {
+    auto read = time_monitor.getNewTimer("read");
+    MPI_Barrier(comm);
+    read->start();
+    auto points = ArborXBenchmark::loadPointCloud<3, MemorySpace>(
+        comm, ExecutionSpace{}, filename);
+    read->stop();
+
+    if (repartition)
+    {
+      // Values read in file order may be scattered across the whole domain
+      auto repartition_timer = time_monitor.getNewTimer("repartition");
+      MPI_Barrier(comm);
+      repartition_timer->start();
+      points = ArborX::Experimental::repartition(comm, ExecutionSpace{}, points)
+                   ._primitives;
+      repartition_timer->stop();
+    }
+
+    n_values = points.extent_int(0);
+    n_queries = std::min(n_queries, n_values);
+    Kokkos::realloc(Kokkos::WithoutInitializing, random_values, n_values);
+    Kokkos::realloc(Kokkos::WithoutInitializing, random_queries, n_queries);
+    Kokkos::parallel_for(
+        "Benchmark::convert_points",
+        Kokkos::RangePolicy<ExecutionSpace>(0, n_values), KOKKOS_LAMBDA(int i) {
+          random_values(i) = {{points(i)[0], points(i)[1], points(i)[2]}};
+        });
+    Kokkos::deep_copy(
+        random_queries,
+        Kokkos::subview(random_values, Kokkos::pair<int, int>(0, n_queries)));
+  }
+  else
   {
     double a = 0.;
     double offset_x = 0.;
@@ -431,12 +615,22 @@ int main_(std::vector<std::string> const &args, const MPI_Comm comm)
 
     auto knn = time_monitor.getNewTimer("knn");
     MPI_Barrier(comm);
+    if (report_phases)
+      PhaseMonitor::enable();
     knn->start();
     distributed_tree.query(
         ExecutionSpace{},
         NearestNeighborsSearches<DeviceType>{random_queries, n_neighbors},
         values, offsets);
     knn->stop();
+    if (report_phases)
+    {
+      PhaseMonitor::disable();
+      summarizeOverProcesses(comm, "knn phase", PhaseMonitor::seconds);
+      summarizeOverProcesses(comm, "knn count",
+                             {{"queries", n_queries},
+                              {"results returned", values.extent(0)}});
+    }
 
     if (comm_rank == 0)
       os << "knn done\n";
@@ -473,17 +667,39 @@ int main_(std::vector<std::string> const &args, const MPI_Comm comm)
       break;
     }
 
+    if (radius_override > 0)
+      r = radius_override;
+
     Kokkos::View<int *, DeviceType> offsets("Testing::offsets", 0);
     Kokkos::View<ArborX::PairIndexRank *, DeviceType> values("Testing::values",
                                                              0);
 
+    auto const query_counts_before =
+        report_phases ? distributed_tree.queryCounts()
+                      : std::vector<long long>{};
+
     auto radius = time_monitor.getNewTimer("radius");
     MPI_Barrier(comm);
+    if (report_phases)
+      PhaseMonitor::enable();
     radius->start();
     distributed_tree.query(ExecutionSpace{},
                            RadiusSearches<DeviceType>{random_queries, r},
                            values, offsets);
     radius->stop();
+    if (report_phases)
+    {
+      PhaseMonitor::disable();
+      // Queries forwarded to the rank by the top tree, including its own
+      auto const query_counts = distributed_tree.queryCounts();
+      summarizeOverProcesses(comm, "radius phase", PhaseMonitor::seconds);
+      summarizeOverProcesses(
+          comm, "radius count",
+          {{"queries", n_queries},
+           {"queries received",
+            query_counts[comm_rank] - query_counts_before[comm_rank]},
+           {"results returned", values.extent(0)}});
+    }
 
     if (comm_rank == 0)
       os << "radius done\n";
@@ -0,0 +1,440 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <ArborX_Box.hpp>
+#include <ArborX_DetailsAlgorithms.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_HyperSphere.hpp>
+#include <ArborX_HyperTriangle.hpp>
+#include <ArborX_KDOP.hpp>
+#include <ArborX_Point.hpp>
+#include <ArborX_Ray.hpp>
+#include <ArborX_Version.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_Random.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+// Throughput of the geometry kernels dispatched by the traversals, each
+// applied to the pairs of geometries of two large arrays and reduced so that
+// the compiler cannot drop it. Changes to the algorithms that break the
+// vectorization of a kernel show as a drop of its rate.
+
+// Random geometries of each kind, in the unit cube, built from a generator
+// returning uniform coordinates in [0, 1)
+template <typename Geometry>
+struct MakeGeometry;
+
+template <int DIM, typename Coordinate>
+struct MakeGeometry<ArborX::ExperimentalHyperGeometry::Point<DIM, Coordinate>>
+{
+  template <typename Generator>
+  KOKKOS_FUNCTION static auto apply(Generator &next)
+  {
+    ArborX::ExperimentalHyperGeometry::Point<DIM, Coordinate> point;
+    for (int d = 0; d < DIM; ++d)
+      point[d] = next();
+    return point;
+  }
+};
+
+template <int DIM, typename Coordinate>
+struct MakeGeometry<ArborX::ExperimentalHyperGeometry::Box<DIM, Coordinate>>
+{
+  template <typename Generator>
+  KOKKOS_FUNCTION static auto apply(Generator &next)
+  {
+    ArborX::ExperimentalHyperGeometry::Box<DIM, Coordinate> box;
+    for (int d = 0; d < DIM; ++d)
+    {
+      box.minCorner()[d] = next();
+      box.maxCorner()[d] = box.minCorner()[d] + Coordinate(0.1) * next();
+    }
+    return box;
+  }
+};
+
+template <int DIM, typename Coordinate>
+struct MakeGeometry<ArborX::ExperimentalHyperGeometry::Sphere<DIM, Coordinate>>
+{
+  template <typename Generator>
+  KOKKOS_FUNCTION static auto apply(Generator &next)
+  {
+    using Point = ArborX::ExperimentalHyperGeometry::Point<DIM, Coordinate>;
+    auto const center = MakeGeometry<Point>::apply(next);
+    return ArborX::ExperimentalHyperGeometry::Sphere<DIM, Coordinate>{
+        center, Coordinate(0.1) * next()};
+  }
+};
+
+template <int DIM, typename Coordinate>
+struct MakeGeometry<
+    ArborX::ExperimentalHyperGeometry::Triangle<DIM, Coordinate>>
+{
+  template <typename Generator>
+  KOKKOS_FUNCTION static auto apply(Generator &next)
+  {
+    using Point = ArborX::ExperimentalHyperGeometry::Point<DIM, Coordinate>;
+    ArborX::ExperimentalHyperGeometry::Triangle<DIM, Coordinate> triangle{
+        MakeGeometry<Point>::apply(next), {}, {}};
+    for (int d = 0; d < DIM; ++d)
+    {
+      triangle.b[d] = triangle.a[d] + Coordinate(0.1) * next();
+      triangle.c[d] = triangle.a[d] + Coordinate(0.1) * next();
+    }
+    return triangle;
+  }
+};
+
+template <>
+struct MakeGeometry<ArborX::Point>
+{
+  template <typename Generator>
+  KOKKOS_FUNCTION static auto apply(Generator &next)
+  {
+    return ArborX::Point{(float)next(), (float)next(), (float)next()};
+  }
+};
+
+template <>
+struct MakeGeometry<ArborX::Box>
+{
+  template <typename Generator>
+  KOKKOS_FUNCTION static auto apply(Generator &next)
+  {
+    auto const min_corner = MakeGeometry<ArborX::Point>::apply(next);
+    ArborX::Box box{min_corner, min_corner};
+    for (int d = 0; d < 3; ++d)
+      box.maxCorner()[d] += 0.1f * (float)next();
+    return box;
+  }
+};
+
+template <int k>
+struct MakeGeometry<ArborX::Experimental::KDOP<k>>
+{
+  template <typename Generator>
+  KOKKOS_FUNCTION static auto apply(Generator &next)
+  {
+    ArborX::Experimental::KDOP<k> kdop{};
+    kdop += MakeGeometry<ArborX::Box>::apply(next);
+    return kdop;
+  }
+};
+
+template <>
+struct MakeGeometry<ArborX::Experimental::Ray>
+{
+  template <typename Generator>
+  KOKKOS_FUNCTION static auto apply(Generator &next)
+  {
+    auto const origin = MakeGeometry<ArborX::Point>::apply(next);
+    return ArborX::Experimental::Ray{
+        origin, ArborX::Experimental::Vector{(float)next() - 0.5f,
+                                             (float)next() - 0.5f,
+                                             (float)next() - 0.5f}};
+  }
+};
+
+template <typename Geometry, typename ExecutionSpace>
+Kokkos::View<Geometry *, typename ExecutionSpace::memory_space>
+makeGeometries(ExecutionSpace const &exec_space, int n, int seed)
+{
+  using MemorySpace = typename ExecutionSpace::memory_space;
+  Kokkos::View<Geometry *, MemorySpace> geometries(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "Benchmark::geometries"),
+      n);
+
+  Kokkos::Random_XorShift1024_Pool<ExecutionSpace> rand_pool(seed);
+  Kokkos::parallel_for(
+      "Benchmark::init_geometries",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        auto rand_gen = rand_pool.get_state();
+        auto next = [&rand_gen]() { return rand_gen.drand(); };
+        geometries(i) = MakeGeometry<Geometry>::apply(next);
+        rand_pool.free_state(rand_gen);
+      });
+  return geometries;
+}
+
+struct Intersects
+{
+  static constexpr char const *name = "intersects";
+
+  template <typename Geometry1, typename Geometry2>
+  KOKKOS_FUNCTION static double apply(Geometry1 const &a, Geometry2 const &b)
+  {
+    using ArborX::Details::intersects;
+    return intersects(a, b) ? 1 : 0;
+  }
+};
+
+struct Distance
+{
+  static constexpr char const *name = "distance";
+
+  template <typename Geometry1, typename Geometry2>
+  KOKKOS_FUNCTION static double apply(Geometry1 const &a, Geometry2 const &b)
+  {
+    using ArborX::Details::distance;
+    return distance(a, b);
+  }
+};
+
+struct Expand
+{
+  static constexpr char const *name = "expand";
+
+  template <typename Box, typename Geometry>
+  KOKKOS_FUNCTION static double apply(Box box, Geometry const &geometry)
+  {
+    using ArborX::Details::expand;
+    expand(box, geometry);
+    return box.minCorner()[0];
+  }
+};
+
+// Centroids of both geometries
+struct Centroid
+{
+  static constexpr char const *name = "centroid";
+
+  template <typename Geometry1, typename Geometry2>
+  KOKKOS_FUNCTION static double apply(Geometry1 const &a, Geometry2 const &b)
+  {
+    using ArborX::Details::returnCentroid;
+    return returnCentroid(a)[0] + returnCentroid(b)[0];
+  }
+};
+
+template <typename ExecutionSpace, typename Kernel, typename Geometry1,
+          typename Geometry2>
+void BM_geometry_kernel(benchmark::State &state, int n)
+{
+  ExecutionSpace exec_space;
+
+  auto const a = makeGeometries<Geometry1>(exec_space, n, 1984);
+  auto const b = makeGeometries<Geometry2>(exec_space, n, 2023);
+
+  for (auto _ : state)
+  {
+    exec_space.fence();
+    auto const start = std::chrono::high_resolution_clock::now();
+
+    double result = 0;
+    Kokkos::parallel_reduce(
+        "Benchmark::geometry_kernel",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+        KOKKOS_LAMBDA(int i, double &update) {
+          update += Kernel::apply(a(i), b(i));
+        },
+        result);
+    benchmark::DoNotOptimize(result);
+
+    auto const end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+  state.counters["rate"] =
+      benchmark::Counter(n, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename ExecutionSpace, typename Kernel, typename Geometry1,
+          typename Geometry2>
+void registerBenchmark(std::string const &backend, std::string const &pair,
+                       int n)
+{
+  std::string const label = std::string("BM_") + Kernel::name + "<" +
+                            backend + ">/" + pair + "/" + std::to_string(n);
+  benchmark::RegisterBenchmark(
+      label.c_str(),
+      [n](benchmark::State &state) {
+        BM_geometry_kernel<ExecutionSpace, Kernel, Geometry1, Geometry2>(state,
+                                                                         n);
+      })
+      ->UseManualTime()
+      ->Unit(benchmark::kMicrosecond);
+}
+
+template <typename ExecutionSpace, int DIM, typename Coordinate>
+void registerHyperGeometryBenchmarks(std::string const &backend,
+                                     std::string const &precision, int n)
+{
+  using Point = ArborX::ExperimentalHyperGeometry::Point<DIM, Coordinate>;
+  using Box = ArborX::ExperimentalHyperGeometry::Box<DIM, Coordinate>;
+  using Sphere = ArborX::ExperimentalHyperGeometry::Sphere<DIM, Coordinate>;
+  using Triangle =
+      ArborX::ExperimentalHyperGeometry::Triangle<DIM, Coordinate>;
+
+  std::string const suffix = "/" + std::to_string(DIM) + "d/" + precision;
+  auto const add = [&](auto kernel, auto geometries, std::string const &pair) {
+    using Kernel = decltype(kernel);
+    using Geometry1 = std::tuple_element_t<0, decltype(geometries)>;
+    using Geometry2 = std::tuple_element_t<1, decltype(geometries)>;
+    registerBenchmark<ExecutionSpace, Kernel, Geometry1, Geometry2>(
+        backend, pair + suffix, n);
+  };
+
+  add(Intersects{}, std::tuple<Point, Box>{}, "point_box");
+  add(Intersects{}, std::tuple<Box, Box>{}, "box_box");
+  add(Intersects{}, std::tuple<Sphere, Box>{}, "sphere_box");
+  add(Intersects{}, std::tuple<Point, Sphere>{}, "point_sphere");
+  add(Intersects{}, std::tuple<Sphere, Sphere>{}, "sphere_sphere");
+
+  add(Distance{}, std::tuple<Point, Point>{}, "point_point");
+  add(Distance{}, std::tuple<Point, Box>{}, "point_box");
+  add(Distance{}, std::tuple<Point, Sphere>{}, "point_sphere");
+  add(Distance{}, std::tuple<Box, Box>{}, "box_box");
+  add(Distance{}, std::tuple<Sphere, Box>{}, "sphere_box");
+  add(Distance{}, std::tuple<Point, Triangle>{}, "point_triangle");
+
+  add(Expand{}, std::tuple<Box, Point>{}, "box_point");
+  add(Expand{}, std::tuple<Box, Box>{}, "box_box");
+  add(Expand{}, std::tuple<Box, Sphere>{}, "box_sphere");
+  add(Expand{}, std::tuple<Box, Triangle>{}, "box_triangle");
+
+  add(Centroid{}, std::tuple<Point, Point>{}, "point");
+  add(Centroid{}, std::tuple<Box, Box>{}, "box");
+  add(Centroid{}, std::tuple<Sphere, Sphere>{}, "sphere");
+  add(Centroid{}, std::tuple<Triangle, Triangle>{}, "triangle");
+}
+
+template <typename ExecutionSpace, int... DIMS>
+void registerBenchmarks(std::string const &backend, int n,
+                        std::integer_sequence<int, DIMS...>)
+{
+  (registerHyperGeometryBenchmarks<ExecutionSpace, DIMS, float>(backend,
+                                                                "float", n),
+   ...);
+  (registerHyperGeometryBenchmarks<ExecutionSpace, DIMS, double>(backend,
+                                                                 "double", n),
+   ...);
+
+  // The rays and k-DOPs are only defined in 3D single precision
+  using KDOP = ArborX::Experimental::KDOP<14>;
+  using Ray = ArborX::Experimental::Ray;
+  using ArborX::Box;
+  std::string const suffix = "/3d/float";
+  registerBenchmark<ExecutionSpace, Intersects, Box, KDOP>(
+      backend, "box_kdop14" + suffix, n);
+  registerBenchmark<ExecutionSpace, Intersects, KDOP, Box>(
+      backend, "kdop14_box" + suffix, n);
+  registerBenchmark<ExecutionSpace, Expand, Box, KDOP>(
+      backend, "box_kdop14" + suffix, n);
+  registerBenchmark<ExecutionSpace, Intersects, Ray, Box>(
+      backend, "ray_box" + suffix, n);
+  registerBenchmark<ExecutionSpace, Distance, Ray, Box>(
+      backend, "ray_box" + suffix, n);
+  registerBenchmark<ExecutionSpace, Intersects, Ray,
+                    ArborX::ExperimentalHyperGeometry::Triangle<3>>(
+      backend, "ray_triangle" + suffix, n);
+}
+
+template <typename ExecutionSpace>
+void registerBenchmarks(std::string const &backend, int n)
+{
+  registerBenchmarks<ExecutionSpace>(backend, n,
+                                     std::integer_sequence<int, 2, 3, 4, 5, 6,
+                                                           7, 8>{});
+}
+
+int main(int argc, char *argv[])
+{
+  Kokkos::ScopeGuard guard(argc, argv);
+
+  std::cout << "ArborX version: " << ArborX::version() << std::endl;
+  std::cout << "ArborX hash   : " << ArborX::gitCommitHash() << std::endl;
+  std::cout << "Kokkos version: " << KokkosExt::version() << std::endl;
+
+  namespace bpo = boost::program_options;
+  bpo::options_description desc("Allowed options");
+  std::string backends;
+  int n;
+  // clang-format off
+  desc.add_options()
+      ( "help", "produce help message" )
+      ( "backends", bpo::value<std::string>(&backends)->default_value("all"), "backend to run on (all, serial, openmp, threads, cuda, hip, sycl, openmptarget)" )
+      ( "values", bpo::value<int>(&n)->default_value(1 << 22), "number of pairs of geometries" )
+  ;
+  // clang-format on
+  bpo::variables_map vm;
+  bpo::store(bpo::command_line_parser(argc, argv)
+                 .options(desc)
+                 .allow_unregistered()
+                 .run(),
+             vm);
+  bpo::notify(vm);
+
+  if (vm.count("help") > 0)
+  {
+    std::cout << desc << "\n";
+    return EXIT_SUCCESS;
+  }
+
+  // Google Benchmark removes its own arguments, all the remaining ones must
+  // have been recognized above
+  benchmark::Initialize(&argc, argv);
+  std::ignore = bpo::command_line_parser(argc, argv).options(desc).run();
+
+  bool found = false;
+  auto const selected = [&backends, &found](std::string const &backend) {
+    bool const is_selected = (backends == "all" || backends == backend);
+    found |= is_selected;
+    return is_selected;
+  };
+#ifdef KOKKOS_ENABLE_SERIAL
+  if (selected("serial"))
+    registerBenchmarks<Kokkos::Serial>("Serial", n);
+#endif
+#ifdef KOKKOS_ENABLE_OPENMP
+  if (selected("openmp"))
+    registerBenchmarks<Kokkos::OpenMP>("OpenMP", n);
+#endif
+#ifdef KOKKOS_ENABLE_THREADS
+  if (selected("threads"))
+    registerBenchmarks<Kokkos::Threads>("Threads", n);
+#endif
+#ifdef KOKKOS_ENABLE_CUDA
+  if (selected("cuda"))
+    registerBenchmarks<Kokkos::Cuda>("Cuda", n);
+#endif
+#ifdef KOKKOS_ENABLE_HIP
+  if (selected("hip"))
+    registerBenchmarks<Kokkos::HIP>("HIP", n);
+#endif
+#ifdef KOKKOS_ENABLE_SYCL
+  if (selected("sycl"))
+    registerBenchmarks<Kokkos::Experimental::SYCL>("SYCL", n);
+#endif
+#ifdef KOKKOS_ENABLE_OPENMPTARGET
+  if (selected("openmptarget"))
+    registerBenchmarks<Kokkos::Experimental::OpenMPTarget>("OpenMPTarget", n);
+#endif
+  if (!found)
+    throw std::runtime_error("Backend " + backends + " not available!");
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,420 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+// Single driver for the main workloads of the library (construction, spatial,
+// nearest, ray and ordered queries, DBSCAN, HDBSCAN and minimum spanning tree)
+// on every enabled backend. Every benchmark reports its throughput as "rate"
+// (primitives or queries per second) and the peak of the memory allocated
+// through Kokkos while it runs as "peak_memory" (bytes). The JSON output of
+// a run (--benchmark_out=<file> --benchmark_out_format=json) can be stored
+// as a baseline and compared against with scripts/benchmark_compare.py.
+
+#include <ArborX_DBSCAN.hpp>
+#include <ArborX_HDBSCAN.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_MinimumSpanningTree.hpp>
+#include <ArborX_Ray.hpp>
+#include <ArborX_Version.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+
+#include <benchmark/benchmark.h>
+#include <point_clouds.hpp>
+
+struct Spec
+{
+  std::string backends;
+  int n_values;
+  int n_queries;
+  int n_neighbors;
+  PointCloudType source_point_cloud_type;
+  PointCloudType target_point_cloud_type;
+};
+
+// Bytes allocated through Kokkos, tracked with the allocation callbacks of
+// the profiling interface
+struct MemoryTracker
+{
+  static inline std::uint64_t current = 0;
+  static inline std::uint64_t peak = 0;
+
+  static void allocate(Kokkos::Profiling::SpaceHandle, char const *,
+                       void const *, std::uint64_t size)
+  {
+    current += size;
+    peak = std::max(peak, current);
+  }
+  static void deallocate(Kokkos::Profiling::SpaceHandle, char const *,
+                         void const *, std::uint64_t size)
+  {
+    // Allocations made before the callbacks were set are not tracked
+    current -= std::min(current, size);
+  }
+};
+
+template <typename DeviceType>
+Kokkos::View<ArborX::Point *, DeviceType>
+makePoints(int n, double length, PointCloudType point_cloud_type)
+{
+  Kokkos::View<ArborX::Point *, DeviceType> points(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "Benchmark::points"), n);
+  generatePointCloud(typename DeviceType::execution_space{}, point_cloud_type,
+                     length, points);
+  return points;
+}
+
+// Radius of the ball expected to contain n_neighbors of the source points,
+// which are spread over a [-a, a]^3 box with a = cbrt(n_values)
+inline float neighborhoodRadius(int n_neighbors)
+{
+  return std::cbrt(n_neighbors * 6. / Kokkos::numbers::pi_v<double>);
+}
+
+template <typename ExecutionSpace, typename Points>
+auto makeSpatialQueries(ExecutionSpace const &space, Points const &centers,
+                        float r)
+{
+  int const n = centers.size();
+  Kokkos::View<decltype(ArborX::intersects(ArborX::Sphere{})) *,
+               typename Points::memory_space>
+      queries(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                 "Benchmark::queries"),
+              n);
+  Kokkos::parallel_for(
+      "Benchmark::make_spatial_queries",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        queries(i) = ArborX::intersects(ArborX::Sphere{centers(i), r});
+      });
+  return queries;
+}
+
+template <typename ExecutionSpace, typename Points>
+auto makeNearestQueries(ExecutionSpace const &space, Points const &centers,
+                        int k)
+{
+  int const n = centers.size();
+  Kokkos::View<ArborX::Nearest<ArborX::Point> *, typename Points::memory_space>
+      queries(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                 "Benchmark::queries"),
+              n);
+  Kokkos::parallel_for(
+      "Benchmark::make_nearest_queries",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) { queries(i) = ArborX::nearest(centers(i), k); });
+  return queries;
+}
+
+struct AllHits
+{
+  KOKKOS_FUNCTION auto operator()(ArborX::Experimental::Ray const &ray) const
+  {
+    return ArborX::intersects(ray);
+  }
+};
+
+struct ClosestHit
+{
+  KOKKOS_FUNCTION auto operator()(ArborX::Experimental::Ray const &ray) const
+  {
+    return ArborX::Experimental::ordered_intersects(ray, 1);
+  }
+};
+
+// Rays from the given points towards the origin
+template <typename ExecutionSpace, typename Points, typename MakePredicate>
+auto makeRayQueries(ExecutionSpace const &space, Points const &origins,
+                    MakePredicate const &make_predicate)
+{
+  using Predicate = decltype(make_predicate(ArborX::Experimental::Ray{}));
+  int const n = origins.size();
+  Kokkos::View<Predicate *, typename Points::memory_space> queries(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Benchmark::queries"),
+      n);
+  Kokkos::parallel_for(
+      "Benchmark::make_ray_queries",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        auto const &o = origins(i);
+        queries(i) = make_predicate(ArborX::Experimental::Ray{
+            o, ArborX::Experimental::Vector{-o[0], -o[1], -o[2] + 1e-3f}});
+      });
+  return queries;
+}
+
+// Boxes of unit size around the points
+template <typename ExecutionSpace, typename Points>
+auto makeBoxes(ExecutionSpace const &space, Points const &points)
+{
+  int const n = points.size();
+  Kokkos::View<ArborX::Box *, typename Points::memory_space> boxes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Benchmark::boxes"),
+      n);
+  Kokkos::parallel_for(
+      "Benchmark::make_boxes", Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        auto const &p = points(i);
+        boxes(i) = {{p[0] - .5f, p[1] - .5f, p[2] - .5f},
+                    {p[0] + .5f, p[1] + .5f, p[2] + .5f}};
+      });
+  return boxes;
+}
+
+// The query into CRS storage, reallocated by every run
+template <typename ExecutionSpace, typename Tree, typename Queries>
+auto makeQueryRun(ExecutionSpace const &space, Tree const &tree,
+                  Queries const &queries)
+{
+  return [space, tree, queries]() {
+    using MemorySpace = typename Tree::memory_space;
+    Kokkos::View<int *, MemorySpace> indices("Benchmark::indices", 0);
+    Kokkos::View<int *, MemorySpace> offsets("Benchmark::offsets", 0);
+    ArborX::query(tree, space, queries, indices, offsets);
+  };
+}
+
+// Time make_workload(space)() over the iterations. The setup done by
+// make_workload is neither timed nor accounted for in the peak memory.
+template <typename ExecutionSpace, typename MakeWorkload>
+void registerWorkload(std::string const &workload, std::string const &backend,
+                      Spec const &spec, int num_items,
+                      MakeWorkload const &make_workload)
+{
+  std::string label = "BM_" + workload + "<" + backend + ">";
+  for (int var :
+       {spec.n_values, spec.n_queries, spec.n_neighbors,
+        static_cast<int>(spec.source_point_cloud_type),
+        static_cast<int>(spec.target_point_cloud_type)})
+    label += "/" + std::to_string(var);
+
+  benchmark::RegisterBenchmark(
+      label.c_str(),
+      [=](benchmark::State &state) {
+        ExecutionSpace space;
+        auto const run = make_workload(space);
+
+        space.fence();
+        auto const baseline = MemoryTracker::current;
+        MemoryTracker::peak = baseline;
+        for (auto _ : state)
+        {
+          space.fence();
+          auto const start = std::chrono::high_resolution_clock::now();
+
+          run();
+
+          space.fence();
+          auto const end = std::chrono::high_resolution_clock::now();
+          std::chrono::duration<double> elapsed_seconds = end - start;
+          state.SetIterationTime(elapsed_seconds.count());
+        }
+        state.counters["rate"] = benchmark::Counter(
+            num_items, benchmark::Counter::kIsIterationInvariantRate);
+        state.counters["peak_memory"] = benchmark::Counter(
+            MemoryTracker::peak - baseline, benchmark::Counter::kDefaults,
+            benchmark::Counter::OneK::kIs1024);
+      })
+      ->UseManualTime()
+      ->Unit(benchmark::kMicrosecond);
+}
+
+template <typename ExecutionSpace>
+void registerBenchmarks(Spec const &spec, std::string const &backend)
+{
+  using MemorySpace = typename ExecutionSpace::memory_space;
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  double const a = std::cbrt(spec.n_values);
+  float const r = neighborhoodRadius(spec.n_neighbors);
+  int const core_min_size = std::max(spec.n_neighbors, 2);
+  auto const sources = [spec, a]() {
+    return makePoints<DeviceType>(spec.n_values, a,
+                                  spec.source_point_cloud_type);
+  };
+  auto const targets = [spec, a]() {
+    return makePoints<DeviceType>(spec.n_queries, a,
+                                  spec.target_point_cloud_type);
+  };
+
+  registerWorkload<ExecutionSpace>(
+      "construction", backend, spec, spec.n_values,
+      [=](ExecutionSpace const &space) {
+        auto const points = sources();
+        return [space, points]() { Tree const tree(space, points); };
+      });
+
+  registerWorkload<ExecutionSpace>(
+      "radius_search", backend, spec, spec.n_queries,
+      [=](ExecutionSpace const &space) {
+        return makeQueryRun(space, Tree(space, sources()),
+                            makeSpatialQueries(space, targets(), r));
+      });
+
+  registerWorkload<ExecutionSpace>(
+      "knn_search", backend, spec, spec.n_queries,
+      [=](ExecutionSpace const &space) {
+        return makeQueryRun(
+            space, Tree(space, sources()),
+            makeNearestQueries(space, targets(), spec.n_neighbors));
+      });
+
+  // All hits and closest hit of rays against boxes around the source points
+  registerWorkload<ExecutionSpace>(
+      "ray_search", backend, spec, spec.n_queries,
+      [=](ExecutionSpace const &space) {
+        return makeQueryRun(space, Tree(space, makeBoxes(space, sources())),
+                            makeRayQueries(space, targets(), AllHits{}));
+      });
+  registerWorkload<ExecutionSpace>(
+      "ordered_search", backend, spec, spec.n_queries,
+      [=](ExecutionSpace const &space) {
+        return makeQueryRun(space, Tree(space, makeBoxes(space, sources())),
+                            makeRayQueries(space, targets(), ClosestHit{}));
+      });
+
+  registerWorkload<ExecutionSpace>(
+      "dbscan", backend, spec, spec.n_values,
+      [=](ExecutionSpace const &space) {
+        auto const points = sources();
+        return [space, points, r, core_min_size]() {
+          ArborX::dbscan(space, points, r, core_min_size);
+        };
+      });
+
+  registerWorkload<ExecutionSpace>(
+      "hdbscan", backend, spec, spec.n_values,
+      [=](ExecutionSpace const &space) {
+        auto const points = sources();
+        return [space, points, core_min_size]() {
+          ArborX::Experimental::hdbscan(space, points, core_min_size);
+        };
+      });
+
+  registerWorkload<ExecutionSpace>(
+      "mst", backend, spec, spec.n_values, [=](ExecutionSpace const &space) {
+        auto const points = sources();
+        return [space, points]() {
+          ArborX::Details::MinimumSpanningTree<MemorySpace> const mst(space,
+                                                                      points);
+        };
+      });
+}
+
+void registerAllBackends(Spec const &spec)
+{
+  bool found = false;
+  auto const selected = [&spec, &found](std::string const &backend) {
+    bool const is_selected =
+        (spec.backends == "all" || spec.backends == backend);
+    found |= is_selected;
+    return is_selected;
+  };
+#ifdef KOKKOS_ENABLE_SERIAL
+  if (selected("serial"))
+    registerBenchmarks<Kokkos::Serial>(spec, "Serial");
+#endif
+#ifdef KOKKOS_ENABLE_OPENMP
+  if (selected("openmp"))
+    registerBenchmarks<Kokkos::OpenMP>(spec, "OpenMP");
+#endif
+#ifdef KOKKOS_ENABLE_THREADS
+  if (selected("threads"))
+    registerBenchmarks<Kokkos::Threads>(spec, "Threads");
+#endif
+#ifdef KOKKOS_ENABLE_CUDA
+  if (selected("cuda"))
+    registerBenchmarks<Kokkos::Cuda>(spec, "Cuda");
+#endif
+#ifdef KOKKOS_ENABLE_HIP
+  if (selected("hip"))
+    registerBenchmarks<Kokkos::HIP>(spec, "HIP");
+#endif
+#ifdef KOKKOS_ENABLE_SYCL
+  if (selected("sycl"))
+    registerBenchmarks<Kokkos::Experimental::SYCL>(spec, "SYCL");
+#endif
+#ifdef KOKKOS_ENABLE_OPENMPTARGET
+  if (selected("openmptarget"))
+    registerBenchmarks<Kokkos::Experimental::OpenMPTarget>(spec,
+                                                           "OpenMPTarget");
+#endif
+  if (!found)
+    throw std::runtime_error("Backend " + spec.backends + " not available!");
+}
+
+int main(int argc, char *argv[])
+{
+  Kokkos::ScopeGuard guard(argc, argv);
+
+  Kokkos::Profiling::Experimental::set_allocate_data_callback(
+      MemoryTracker::allocate);
+  Kokkos::Profiling::Experimental::set_deallocate_data_callback(
+      MemoryTracker::deallocate);
+
+  std::cout << "ArborX version: " << ArborX::version() << std::endl;
+  std::cout << "ArborX hash   : " << ArborX::gitCommitHash() << std::endl;
+  std::cout << "Kokkos version: " << KokkosExt::version() << std::endl;
+
+  namespace bpo = boost::program_options;
+  bpo::options_description desc("Allowed options");
+  Spec spec;
+  std::string source_pt_cloud;
+  std::string target_pt_cloud;
+  // clang-format off
+  desc.add_options()
+      ( "help", "produce help message" )
+      ( "backends", bpo::value<std::string>(&spec.backends)->default_value("all"), "backend to run on (all, serial, openmp, threads, cuda, hip, sycl, openmptarget)" )
+      ( "values", bpo::value<int>(&spec.n_values)->default_value(50000), "number of indexable values (source)" )
+      ( "queries", bpo::value<int>(&spec.n_queries)->default_value(20000), "number of queries (target)" )
+      ( "neighbors", bpo::value<int>(&spec.n_neighbors)->default_value(10), "desired number of results per query, and minimum cluster size" )
+      ( "source-point-cloud-type", bpo::value<std::string>(&source_pt_cloud)->default_value("filled_box"), "shape of the source point cloud"  )
+      ( "target-point-cloud-type", bpo::value<std::string>(&target_pt_cloud)->default_value("filled_box"), "shape of the target point cloud"  )
+  ;
+  // clang-format on
+  bpo::variables_map vm;
+  bpo::store(bpo::command_line_parser(argc, argv)
+                 .options(desc)
+                 .allow_unregistered()
+                 .run(),
+             vm);
+  bpo::notify(vm);
+
+  if (vm.count("help") > 0)
+  {
+    std::cout << desc << "\n";
+    return EXIT_SUCCESS;
+  }
+
+  // Google Benchmark removes its own arguments, all the remaining ones must
+  // have been recognized above
+  benchmark::Initialize(&argc, argv);
+  std::ignore = bpo::command_line_parser(argc, argv).options(desc).run();
+
+  spec.source_point_cloud_type = to_point_cloud_enum(source_pt_cloud);
+  spec.target_point_cloud_type = to_point_cloud_enum(target_pt_cloud);
+
+  registerAllBackends(spec);
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_BENCHMARK_POINT_CLOUD_FILE_HPP
+#define ARBORX_BENCHMARK_POINT_CLOUD_FILE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary columnar point cloud files. A 32-byte header
+//   magic "ARBORXPC", version, dimension, number of points, data type
+// is followed by the coordinates of the points, one column per dimension.
+// Columns let a contiguous range of points, e.g. the part of an MPI rank, be
+// read without touching the rest of the file.
+namespace ArborXBenchmark
+{
+
+enum class PointCloudDataType : std::uint32_t
+{
+  Float32 = 0,
+  Float64 = 1
+};
+
+struct PointCloudHeader
+{
+  char magic[8] = {'A', 'R', 'B', 'O', 'R', 'X', 'P', 'C'};
+  std::uint32_t version = 1;
+  std::uint32_t dim = 0;
+  std::uint64_t count = 0;
+  PointCloudDataType dtype = PointCloudDataType::Float32;
+  std::uint32_t reserved = 0;
+
+  std::size_t coordinateSize() const
+  {
+    return dtype == PointCloudDataType::Float32 ? sizeof(float)
+                                                : sizeof(double);
+  }
+};
+static_assert(sizeof(PointCloudHeader) == 32);
+
+inline bool hasPointCloudMagic(PointCloudHeader const &header)
+{
+  return std::memcmp(header.magic, PointCloudHeader{}.magic,
+                     sizeof(header.magic)) == 0;
+}
+
+// Whether the file is a columnar point cloud, rather than in the legacy
+// binary format of the DBSCAN benchmark
+inline bool isPointCloudFile(std::string const &filename)
+{
+  std::ifstream input(filename, std::ifstream::binary);
+  PointCloudHeader header;
+  input.read(reinterpret_cast<char *>(&header), sizeof(header));
+  return input.good() && hasPointCloudMagic(header);
+}
+
+inline void checkPointCloudHeader(PointCloudHeader const &header,
+                                  std::size_t file_size)
+{
+  if (!hasPointCloudMagic(header))
+    throw std::runtime_error("Not a point cloud file");
+  if (header.version != 1)
+    throw std::runtime_error("Unsupported point cloud file version " +
+                             std::to_string(header.version));
+  if (header.dtype != PointCloudDataType::Float32 &&
+      header.dtype != PointCloudDataType::Float64)
+    throw std::runtime_error("Unsupported point cloud data type");
+  if (file_size <
+      sizeof(header) + header.dim * header.count * header.coordinateSize())
+    throw std::runtime_error("Truncated point cloud file");
+}
+
+// Read-only mapping of a whole file in memory. The file is read into a
+// buffer where memory mapping is not available.
+class MappedFile
+{
+public:
+  explicit MappedFile(std::string const &filename)
+  {
+#ifndef _WIN32
+    int const fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("Cannot open \"" + filename + "\"");
+    struct stat status;
+    if (::fstat(fd, &status) != 0)
+    {
+      ::close(fd);
+      throw std::runtime_error("Cannot stat \"" + filename + "\"");
+    }
+    _size = status.st_size;
+    if (_size > 0)
+    {
+      void *data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED)
+      {
+        ::close(fd);
+        throw std::runtime_error("Cannot map \"" + filename + "\"");
+      }
+      // The coordinates are read once, front to back within each column
+      ::madvise(data, _size, MADV_SEQUENTIAL);
+      _data = static_cast<char const *>(data);
+    }
+    ::close(fd);
+#else
+    std::ifstream input(filename, std::ifstream::binary | std::ifstream::ate);
+    if (!input.good())
+      throw std::runtime_error("Cannot open \"" + filename + "\"");
+    _size = input.tellg();
+    _buffer.resize(_size);
+    input.seekg(0);
+    input.read(_buffer.data(), _size);
+    _data = _buffer.data();
+#endif
+  }
+
+  ~MappedFile()
+  {
+#ifndef _WIN32
+    if (_data)
+      ::munmap(const_cast<char *>(_data), _size);
+#endif
+  }
+
+  MappedFile(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+
+  char const *data() const { return _data; }
+  std::size_t size() const { return _size; }
+
+  PointCloudHeader header() const
+  {
+    PointCloudHeader header;
+    if (_size < sizeof(header))
+      throw std::runtime_error("Truncated point cloud file");
+    std::memcpy(&header, _data, sizeof(header));
+    checkPointCloudHeader(header, _size);
+    return header;
+  }
+
+  // Coordinates of the points along dimension d
+  char const *column(PointCloudHeader const &header, int d) const
+  {
+    return _data + sizeof(header) + d * header.count * header.coordinateSize();
+  }
+
+private:
+  char const *_data = nullptr;
+  std::size_t _size = 0;
+#ifdef _WIN32
+  std::vector<char> _buffer;
+#endif
+};
+
+// Write a point cloud given its coordinates for each dimension
+template <typename Coordinate>
+void writePointCloud(std::string const &filename,
+                     std::vector<std::vector<Coordinate>> const &columns)
+{
+  static_assert(std::is_same_v<Coordinate, float> ||
+                std::is_same_v<Coordinate, double>);
+
+  PointCloudHeader header;
+  header.dim = columns.size();
+  header.count = (columns.empty() ? 0 : columns[0].size());
+  header.dtype = std::is_same_v<Coordinate, float>
+                     ? PointCloudDataType::Float32
+                     : PointCloudDataType::Float64;
+
+  std::ofstream output(filename, std::ofstream::binary);
+  if (!output.good())
+    throw std::runtime_error("Cannot open \"" + filename + "\"");
+  output.write(reinterpret_cast<char const *>(&header), sizeof(header));
+  for (auto const &column : columns)
+  {
+    if (column.size() != header.count)
+      throw std::runtime_error("Columns of different lengths");
+    output.write(reinterpret_cast<char const *>(column.data()),
+                 column.size() * sizeof(Coordinate));
+  }
+  if (!output.good())
+    throw std::runtime_error("Error writing \"" + filename + "\"");
+}
+
+} // namespace ArborXBenchmark
+
+#endif
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_BENCHMARK_POINT_CLOUD_LOADER_HPP
+#define ARBORX_BENCHMARK_POINT_CLOUD_LOADER_HPP
+
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_HyperPoint.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "point_cloud_file.hpp"
+
+namespace ArborXBenchmark
+{
+
+namespace Details
+{
+// Transpose the columns of the points [begin, begin + n) of a mapped file
+// into points. The host threads each take their share of the points, so that
+// the pages of the file are faulted in in parallel.
+template <int DIM, typename Coordinate, typename Points>
+void readColumns(MappedFile const &file, PointCloudHeader const &header,
+                 std::int64_t begin, Points const &points)
+{
+  Coordinate const *columns[DIM];
+  for (int d = 0; d < DIM; ++d)
+    columns[d] =
+        reinterpret_cast<Coordinate const *>(file.column(header, d)) + begin;
+
+  using HostExecutionSpace = Kokkos::DefaultHostExecutionSpace;
+  Kokkos::parallel_for(
+      "Benchmark::read_point_cloud",
+      Kokkos::RangePolicy<HostExecutionSpace, Kokkos::IndexType<std::int64_t>>(
+          HostExecutionSpace{}, 0, points.extent(0)),
+      [&](std::int64_t i) {
+        for (int d = 0; d < DIM; ++d)
+          points(i)[d] = columns[d][i];
+      });
+  HostExecutionSpace{}.fence();
+}
+} // namespace Details
+
+// Load the points [begin, begin + count) of a columnar point cloud file, or
+// up to its end if count is negative. The file is memory mapped and read in
+// parallel on the host. For memory spaces that are not accessible from the
+// host, the points are staged in pinned host memory, when available, so that
+// the upload to the device does not go through another copy.
+template <int DIM, typename MemorySpace, typename ExecutionSpace>
+Kokkos::View<ArborX::ExperimentalHyperGeometry::Point<DIM> *, MemorySpace>
+loadPointCloud(ExecutionSpace const &space, std::string const &filename,
+               std::int64_t begin = 0, std::int64_t count = -1)
+{
+  using Point = ArborX::ExperimentalHyperGeometry::Point<DIM>;
+
+  MappedFile const file(filename);
+  auto const header = file.header();
+  ARBORX_ASSERT((int)header.dim == DIM);
+  ARBORX_ASSERT(begin >= 0);
+
+  std::int64_t const num_points = header.count;
+  begin = std::min(begin, num_points);
+  if (count < 0 || begin + count > num_points)
+    count = num_points - begin;
+
+  Kokkos::View<Point *, MemorySpace> points(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Benchmark::point_cloud"),
+      count);
+
+  auto read = [&](auto const &host_points) {
+    if (header.dtype == PointCloudDataType::Float32)
+      Details::readColumns<DIM, float>(file, header, begin, host_points);
+    else
+      Details::readColumns<DIM, double>(file, header, begin, host_points);
+  };
+  if constexpr (KokkosExt::is_accessible_from_host<
+                    Kokkos::View<Point *, MemorySpace>>::value)
+  {
+    read(points);
+  }
+  else
+  {
+#ifdef KOKKOS_HAS_SHARED_HOST_PINNED_SPACE
+    using StagingSpace = Kokkos::SharedHostPinnedSpace;
+#else
+    using StagingSpace = Kokkos::HostSpace;
+#endif
+    Kokkos::View<Point *, StagingSpace> staging(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                           "Benchmark::point_cloud_staging"),
+        count);
+    read(staging);
+    Kokkos::deep_copy(space, points, staging);
+    space.fence();
+  }
+  return points;
+}
+
+} // namespace ArborXBenchmark
+
+#endif
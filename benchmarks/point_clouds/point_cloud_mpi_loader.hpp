@@ -0,0 +1,124 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_BENCHMARK_POINT_CLOUD_MPI_LOADER_HPP
+#define ARBORX_BENCHMARK_POINT_CLOUD_MPI_LOADER_HPP
+
+#include <ArborX_Exception.hpp>
+#include <ArborX_HyperPoint.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+
+#include "point_cloud_file.hpp"
+
+namespace ArborXBenchmark
+{
+
+namespace Details
+{
+inline void checkMPI(int error, std::string const &what)
+{
+  if (error != MPI_SUCCESS)
+  {
+    char message[MPI_MAX_ERROR_STRING];
+    int length;
+    MPI_Error_string(error, message, &length);
+    throw std::runtime_error(what + ": " + std::string(message, length));
+  }
+}
+
+// Read the coordinates [begin, begin + count) of each column with collective
+// MPI-IO calls, so that the MPI library can aggregate the requests of all the
+// processes for the parallel file system.
+template <int DIM, typename Coordinate, typename Points>
+void readColumnsMPI(MPI_File file, PointCloudHeader const &header,
+                    std::int64_t begin, Points const &points)
+{
+  MPI_Datatype const type =
+      (std::is_same_v<Coordinate, float> ? MPI_FLOAT : MPI_DOUBLE);
+  int const count = points.extent(0);
+  std::vector<Coordinate> column(count);
+  for (int d = 0; d < DIM; ++d)
+  {
+    MPI_Offset const offset =
+        sizeof(header) + (d * header.count + begin) * sizeof(Coordinate);
+    checkMPI(MPI_File_read_at_all(file, offset, column.data(), count, type,
+                                  MPI_STATUS_IGNORE),
+             "Cannot read point cloud file");
+    for (int i = 0; i < count; ++i)
+      points(i)[d] = column[i];
+  }
+}
+} // namespace Details
+
+// Load a columnar point cloud file split evenly among the processes of the
+// communicator, each process reading its own contiguous range of points.
+// Must be called by all the processes of the communicator.
+template <int DIM, typename MemorySpace, typename ExecutionSpace>
+Kokkos::View<ArborX::ExperimentalHyperGeometry::Point<DIM> *, MemorySpace>
+loadPointCloud(MPI_Comm comm, ExecutionSpace const &space,
+               std::string const &filename)
+{
+  using Point = ArborX::ExperimentalHyperGeometry::Point<DIM>;
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  MPI_File file;
+  Details::checkMPI(MPI_File_open(comm, filename.c_str(), MPI_MODE_RDONLY,
+                                  MPI_INFO_NULL, &file),
+                    "Cannot open \"" + filename + "\"");
+
+  PointCloudHeader header;
+  MPI_Offset file_size;
+  Details::checkMPI(MPI_File_get_size(file, &file_size),
+                    "Cannot stat \"" + filename + "\"");
+  // All the processes read the header, so that they all fail alike
+  Details::checkMPI(MPI_File_read_at_all(file, 0, &header, sizeof(header),
+                                         MPI_BYTE, MPI_STATUS_IGNORE),
+                    "Cannot read point cloud header");
+  checkPointCloudHeader(header, file_size);
+  ARBORX_ASSERT((int)header.dim == DIM);
+
+  std::int64_t const num_points = header.count;
+  std::int64_t const begin = num_points * comm_rank / comm_size;
+  std::int64_t const end = num_points * (comm_rank + 1) / comm_size;
+
+  Kokkos::View<Point *, MemorySpace> points(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Benchmark::point_cloud"),
+      end - begin);
+  auto points_host = Kokkos::create_mirror_view(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing), points);
+  if (header.dtype == PointCloudDataType::Float32)
+    Details::readColumnsMPI<DIM, float>(file, header, begin, points_host);
+  else
+    Details::readColumnsMPI<DIM, double>(file, header, begin, points_host);
+  MPI_File_close(&file);
+
+  Kokkos::deep_copy(space, points, points_host);
+  space.fence();
+  return points;
+}
+
+} // namespace ArborXBenchmark
+
+#endif
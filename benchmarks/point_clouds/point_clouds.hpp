@@ -17,7 +17,9 @@
 #include <ArborX_GeometryTraits.hpp>
 
 #include <Kokkos_Core.hpp>
+#include <Kokkos_Random.hpp>
 
+#include <cstdint>
 #include <fstream>
 #include <random>
 
@@ -26,7 +28,9 @@ enum class PointCloudType
   filled_box,
   hollow_box,
   filled_sphere,
-  hollow_sphere
+  hollow_sphere,
+  clustered,
+  heavy_tailed
 };
 
 inline PointCloudType to_point_cloud_enum(std::string const &str)
@@ -39,6 +43,10 @@ inline PointCloudType to_point_cloud_enum(std::string const &str)
     return PointCloudType::filled_sphere;
   if (str == "hollow_sphere")
     return PointCloudType::hollow_sphere;
+  if (str == "clustered")
+    return PointCloudType::clustered;
+  if (str == "heavy_tailed")
+    return PointCloudType::heavy_tailed;
   throw std::runtime_error(str +
                            " doesn't correspond to any known PointCloudType!");
 }
@@ -163,6 +171,140 @@ void hollowSphereCloud(double const radius,
   }
 }
 
+// Seed of the random number generator of the i-th point, so that the clouds
+// generated on the device do not depend on the scheduling of the threads
+KOKKOS_INLINE_FUNCTION std::uint64_t pointCloudSeed(std::uint64_t seed,
+                                                    std::uint64_t i)
+{
+  // splitmix64 finalizer
+  std::uint64_t z = seed + (i + 1) * 0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  z ^= z >> 31;
+  return z != 0 ? z : 1;
+}
+
+// Unit vector of uniformly distributed direction
+template <int DIM, class Generator>
+KOKKOS_INLINE_FUNCTION void randomDirection(Generator &generator, double *v)
+{
+  double norm;
+  do
+  {
+    norm = 0.;
+    for (int d = 0; d < DIM; ++d)
+    {
+      v[d] = generator.normal();
+      norm += v[d] * v[d];
+    }
+  } while (norm == 0.);
+  norm = Kokkos::sqrt(norm);
+  for (int d = 0; d < DIM; ++d)
+    v[d] /= norm;
+}
+
+// Same clouds as above, generated in parallel on the device with one random
+// number generator per point seeded from seed and the index of the point, and
+// in addition
+//  - clustered: a mixture of Gaussian clusters with centers uniformly
+//    distributed in the box of the given half edge, and standard deviations
+//    between 1% and 10% of the half edge,
+//  - heavy_tailed: a cloud of density decreasing with the distance from the
+//    origin as a power law, half of the points lying within a tenth of the
+//    given length.
+template <class ExecutionSpace, class Point, typename... ViewProperties>
+void generatePointCloud(ExecutionSpace const &space,
+                        PointCloudType const point_cloud_type,
+                        double const length,
+                        Kokkos::View<Point *, ViewProperties...> random_points,
+                        std::uint64_t const seed = 0)
+{
+  using namespace ArborX::GeometryTraits;
+  check_valid_geometry_traits(Point{});
+  static_assert(is_point<Point>{}, "ArborX: View must contain point values");
+  static_assert(KokkosExt::is_accessible_from<
+                typename decltype(random_points)::memory_space,
+                ExecutionSpace>::value);
+
+  using Generator = Kokkos::Random_XorShift64<ExecutionSpace>;
+  constexpr int DIM = dimension_v<Point>;
+  constexpr int num_clusters = 64;
+
+  int const n = random_points.extent(0);
+  Kokkos::parallel_for(
+      "Benchmark::generate_point_cloud",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        Generator generator(pointCloudSeed(seed, i));
+        auto &point = random_points(i);
+        switch (point_cloud_type)
+        {
+        case PointCloudType::filled_box:
+          for (int d = 0; d < DIM; ++d)
+            point[d] = generator.drand(-length, length);
+          break;
+        case PointCloudType::hollow_box:
+        {
+          // Points are cyclically placed on the faces of a box
+          int const face = i % (2 * DIM);
+          for (int d = 0; d < DIM; ++d)
+            point[d] = generator.drand(-length, length);
+          point[face / 2] = (face % 2 == 0 ? -length : length);
+          break;
+        }
+        case PointCloudType::filled_sphere:
+        {
+          double v[DIM];
+          double norm;
+          do
+          {
+            norm = 0.;
+            for (int d = 0; d < DIM; ++d)
+            {
+              v[d] = generator.drand(-length, length);
+              norm += v[d] * v[d];
+            }
+          } while (norm > length * length);
+          for (int d = 0; d < DIM; ++d)
+            point[d] = v[d];
+          break;
+        }
+        case PointCloudType::hollow_sphere:
+        {
+          double v[DIM];
+          randomDirection<DIM>(generator, v);
+          for (int d = 0; d < DIM; ++d)
+            point[d] = length * v[d];
+          break;
+        }
+        case PointCloudType::clustered:
+        {
+          // The clusters are drawn from their own seeds, shared by all the
+          // points
+          int const cluster = generator.urand(num_clusters);
+          Generator cluster_generator(pointCloudSeed(~seed, cluster));
+          double const sigma = cluster_generator.drand(0.01, 0.1) * length;
+          for (int d = 0; d < DIM; ++d)
+            point[d] = cluster_generator.drand(-length, length) +
+                       generator.normal(0., sigma);
+          break;
+        }
+        case PointCloudType::heavy_tailed:
+        {
+          // Pareto distributed distances of index 2, shifted to start at the
+          // origin, with median scale * (sqrt(2) - 1)
+          double const scale = 0.1 * length / (Kokkos::sqrt(2.) - 1.);
+          double const u = 1. - generator.drand();
+          double const r = scale * (1. / Kokkos::sqrt(u) - 1.);
+          double v[DIM];
+          randomDirection<DIM>(generator, v);
+          for (int d = 0; d < DIM; ++d)
+            point[d] = r * v[d];
+          break;
+        }
+        }
+      });
+}
+
 template <class Point, typename DeviceType>
 void generatePointCloud(PointCloudType const point_cloud_type,
                         double const length,
@@ -187,6 +329,12 @@ void generatePointCloud(PointCloudType const point_cloud_type,
   case PointCloudType::hollow_sphere:
     hollowSphereCloud(length, random_points_host);
     break;
+  case PointCloudType::clustered:
+  case PointCloudType::heavy_tailed:
+    // Only generated on the device
+    generatePointCloud(typename DeviceType::execution_space{},
+                       point_cloud_type, length, random_points);
+    return;
   default:
     throw ArborX::SearchException("not implemented");
   }
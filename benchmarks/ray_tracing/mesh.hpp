@@ -0,0 +1,183 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef MESH_HPP
+#define MESH_HPP
+
+#include <ArborX_Exception.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_HyperTriangle.hpp>
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ArborXBenchmark
+{
+
+using Point = ArborX::ExperimentalHyperGeometry::Point<3>;
+using Triangle = ArborX::ExperimentalHyperGeometry::Triangle<3>;
+
+// Polygons are split into fans of triangles around their first vertex
+inline void addPolygon(std::vector<Point> const &vertices,
+                       std::vector<long> const &polygon,
+                       std::vector<Triangle> &triangles)
+{
+  for (auto index : polygon)
+    if (index < 0 || index >= (long)vertices.size())
+      throw std::runtime_error("Mesh face refers to vertex " +
+                               std::to_string(index) + " out of " +
+                               std::to_string(vertices.size()));
+  for (int i = 1; i + 1 < (int)polygon.size(); ++i)
+    triangles.push_back({vertices[polygon[0]], vertices[polygon[i]],
+                         vertices[polygon[i + 1]]});
+}
+
+// Only the vertices ("v") and faces ("f") of Wavefront OBJ files are read.
+// Face vertices may carry texture and normal indices ("f 1/2/3 ..."), and
+// negative indices count from the last vertex.
+inline std::vector<Triangle> loadOBJ(std::istream &input)
+{
+  std::vector<Point> vertices;
+  std::vector<Triangle> triangles;
+  std::string line;
+  while (std::getline(input, line))
+  {
+    std::istringstream ss(line);
+    std::string keyword;
+    ss >> keyword;
+    if (keyword == "v")
+    {
+      Point p;
+      ss >> p[0] >> p[1] >> p[2];
+      vertices.push_back(p);
+    }
+    else if (keyword == "f")
+    {
+      std::vector<long> polygon;
+      std::string token;
+      while (ss >> token)
+      {
+        long const index = std::stol(token.substr(0, token.find('/')));
+        polygon.push_back(index < 0 ? (long)vertices.size() + index
+                                    : index - 1);
+      }
+      addPolygon(vertices, polygon, triangles);
+    }
+  }
+  return triangles;
+}
+
+// Only ASCII PLY files are read, the first three properties of the vertices
+// being their coordinates
+inline std::vector<Triangle> loadPLY(std::istream &input)
+{
+  std::string line;
+  std::getline(input, line);
+  if (line.rfind("ply", 0) != 0)
+    throw std::runtime_error("Not a PLY file");
+
+  long num_vertices = 0;
+  long num_faces = 0;
+  int num_vertex_properties = 0;
+  std::string current_element;
+  while (std::getline(input, line) && line.rfind("end_header", 0) != 0)
+  {
+    std::istringstream ss(line);
+    std::string keyword;
+    ss >> keyword;
+    if (keyword == "format")
+    {
+      std::string format;
+      ss >> format;
+      if (format != "ascii")
+        throw std::runtime_error("Only ASCII PLY files are supported");
+    }
+    else if (keyword == "element")
+    {
+      ss >> current_element;
+      if (current_element == "vertex")
+        ss >> num_vertices;
+      else if (current_element == "face")
+        ss >> num_faces;
+    }
+    else if (keyword == "property" && current_element == "vertex")
+      ++num_vertex_properties;
+  }
+  if (num_vertex_properties < 3)
+    throw std::runtime_error("PLY vertices must have coordinates");
+
+  std::vector<Point> vertices(num_vertices);
+  for (auto &p : vertices)
+  {
+    std::getline(input, line);
+    std::istringstream ss(line);
+    ss >> p[0] >> p[1] >> p[2];
+  }
+  std::vector<Triangle> triangles;
+  for (long f = 0; f < num_faces; ++f)
+  {
+    int n;
+    input >> n;
+    std::vector<long> polygon(n);
+    for (auto &index : polygon)
+      input >> index;
+    addPolygon(vertices, polygon, triangles);
+  }
+  if (!input)
+    throw std::runtime_error("Truncated PLY file");
+  return triangles;
+}
+
+inline std::vector<Triangle> loadMesh(std::string const &filename)
+{
+  std::ifstream input(filename);
+  if (!input)
+    throw std::runtime_error("Cannot open \"" + filename + "\"");
+  auto const extension = filename.substr(filename.find_last_of('.') + 1);
+  if (extension == "obj")
+    return loadOBJ(input);
+  if (extension == "ply")
+    return loadPLY(input);
+  throw std::runtime_error("Unknown mesh format \"" + extension + "\"");
+}
+
+// Unit sphere made of 2 * n * (n - 1) triangles, for when no mesh is given
+inline std::vector<Triangle> makeSphere(int n)
+{
+  ARBORX_ASSERT(n >= 3);
+  float const pi = std::acos(-1.f);
+  auto vertex = [&](int i, int j) {
+    float const theta = pi * i / n;
+    float const phi = 2 * pi * j / n;
+    return Point{std::sin(theta) * std::cos(phi),
+                 std::sin(theta) * std::sin(phi), std::cos(theta)};
+  };
+  std::vector<Triangle> triangles;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+    {
+      // The first and last rows of quads are triangles at the poles
+      if (i > 0)
+        triangles.push_back(
+            {vertex(i, j), vertex(i, j + 1), vertex(i + 1, j + 1)});
+      if (i < n - 1)
+        triangles.push_back(
+            {vertex(i, j), vertex(i + 1, j + 1), vertex(i + 1, j)});
+    }
+  return triangles;
+}
+
+} // namespace ArborXBenchmark
+
+#endif
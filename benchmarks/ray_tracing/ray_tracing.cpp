@@ -0,0 +1,403 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+// Ray throughput against a triangle mesh, read from an OBJ or ASCII PLY file
+// or a tessellated sphere otherwise. Three kinds of rays are cast:
+// - primary rays, from a pinhole camera looking at the mesh,
+// - shadow rays, from points on the surface to a point light,
+// - diffuse rays, from points on the surface uniformly over the hemisphere
+//   around the normal.
+// Each kind is traced for all hits (intersects), all hits in order
+// (ordered_intersects), the closest hit (ordered_intersects with k = 1) and
+// the nearest hit (nearest with k = 1). The "rate" counter is in rays per
+// second.
+
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_Ray.hpp>
+#include <ArborX_Version.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "mesh.hpp"
+#include <benchmark/benchmark.h>
+
+using ArborX::Experimental::Ray;
+using ArborX::Experimental::Vector;
+using ArborXBenchmark::Point;
+using ArborXBenchmark::Triangle;
+
+enum class RayKind
+{
+  primary,
+  shadow,
+  diffuse
+};
+
+struct Scene
+{
+  Point center;
+  float radius;
+};
+
+Scene boundingSphere(std::vector<Triangle> const &triangles)
+{
+  Point min_corner{std::numeric_limits<float>::max(),
+                   std::numeric_limits<float>::max(),
+                   std::numeric_limits<float>::max()};
+  Point max_corner{std::numeric_limits<float>::lowest(),
+                   std::numeric_limits<float>::lowest(),
+                   std::numeric_limits<float>::lowest()};
+  for (auto const &triangle : triangles)
+    for (auto const &p : {triangle.a, triangle.b, triangle.c})
+      for (int d = 0; d < 3; ++d)
+      {
+        min_corner[d] = std::min(min_corner[d], p[d]);
+        max_corner[d] = std::max(max_corner[d], p[d]);
+      }
+  Scene scene;
+  float diagonal = 0;
+  for (int d = 0; d < 3; ++d)
+  {
+    scene.center[d] = (min_corner[d] + max_corner[d]) / 2;
+    float const extent = max_corner[d] - min_corner[d];
+    diagonal += extent * extent;
+  }
+  scene.radius = std::sqrt(diagonal) / 2;
+  return scene;
+}
+
+// The rays are generated on the host, with a fixed seed
+std::vector<Ray> makeRays(RayKind kind, std::vector<Triangle> const &triangles,
+                          int n_rays)
+{
+  auto const scene = boundingSphere(triangles);
+  auto const &c = scene.center;
+  float const r = scene.radius;
+
+  std::default_random_engine generator(0);
+  std::uniform_real_distribution<float> uniform(0, 1);
+  std::normal_distribution<float> normal;
+
+  std::vector<Ray> rays;
+  rays.reserve(n_rays);
+  if (kind == RayKind::primary)
+  {
+    // Square image on the plane through the center of the scene, seen from a
+    // camera in front of it
+    int const width = std::max((int)std::sqrt(n_rays), 1);
+    ArborX::Point const eye{c[0], c[1], c[2] + 3 * r};
+    for (int i = 0; i < n_rays; ++i)
+    {
+      float const u = ((i % width) + .5f) / width - .5f;
+      float const v = ((i / width % width) + .5f) / width - .5f;
+      rays.emplace_back(eye, Vector{2 * r * u, 2 * r * v, -3 * r});
+    }
+    return rays;
+  }
+
+  ArborX::Point const light{c[0] + r, c[1] + 2 * r, c[2] + 3 * r};
+  std::uniform_int_distribution<int> pick(0, triangles.size() - 1);
+  for (int i = 0; i < n_rays; ++i)
+  {
+    // Uniformly distributed point on a random triangle, slightly off the
+    // surface to avoid hitting that triangle
+    auto const &t = triangles[pick(generator)];
+    float s = uniform(generator);
+    float q = uniform(generator);
+    if (s + q > 1)
+    {
+      s = 1 - s;
+      q = 1 - q;
+    }
+    Vector const e1 = ArborX::Experimental::makeVector(t.a, t.b);
+    Vector const e2 = ArborX::Experimental::makeVector(t.a, t.c);
+    auto n = ArborX::Experimental::crossProduct(e1, e2);
+    float const norm = std::sqrt(ArborX::Experimental::dotProduct(n, n));
+    if (norm > 0)
+      for (int d = 0; d < 3; ++d)
+        n[d] /= norm;
+    ArborX::Point origin;
+    for (int d = 0; d < 3; ++d)
+      origin[d] = t.a[d] + s * e1[d] + q * e2[d] + 1e-4f * r * n[d];
+
+    if (kind == RayKind::shadow)
+    {
+      rays.emplace_back(origin,
+                        ArborX::Experimental::makeVector(origin, light));
+      continue;
+    }
+    Vector direction{normal(generator), normal(generator), normal(generator)};
+    if (ArborX::Experimental::dotProduct(direction, n) < 0)
+      for (int d = 0; d < 3; ++d)
+        direction[d] = -direction[d];
+    rays.emplace_back(origin, direction);
+  }
+  return rays;
+}
+
+struct AllHits
+{
+  KOKKOS_FUNCTION auto operator()(Ray const &ray) const
+  {
+    return ArborX::intersects(ray);
+  }
+};
+
+struct OrderedHits
+{
+  KOKKOS_FUNCTION auto operator()(Ray const &ray) const
+  {
+    return ArborX::Experimental::ordered_intersects(ray);
+  }
+};
+
+struct ClosestHit
+{
+  KOKKOS_FUNCTION auto operator()(Ray const &ray) const
+  {
+    return ArborX::Experimental::ordered_intersects(ray, 1);
+  }
+};
+
+struct NearestHit
+{
+  KOKKOS_FUNCTION auto operator()(Ray const &ray) const
+  {
+    return ArborX::nearest(ray, 1);
+  }
+};
+
+template <typename MemorySpace>
+struct CountHits
+{
+  Kokkos::View<int *, MemorySpace> _hits;
+
+  template <typename Predicate, typename Value>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate,
+                                  Value const &) const
+  {
+    Kokkos::atomic_increment(&_hits(ArborX::getData(predicate)));
+  }
+};
+
+template <typename ExecutionSpace, typename MakePredicate>
+void BM_ray_tracing(benchmark::State &state,
+                    std::vector<Triangle> const &triangles,
+                    std::vector<Ray> const &rays,
+                    MakePredicate const &make_predicate)
+{
+  using MemorySpace = typename ExecutionSpace::memory_space;
+  using Tree =
+      ArborX::BasicBoundingVolumeHierarchy<MemorySpace,
+                                           ArborX::Details::PairIndexVolume<
+                                               Triangle>>;
+
+  ExecutionSpace space;
+
+  Kokkos::View<Triangle *, MemorySpace> mesh(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Benchmark::mesh"),
+      triangles.size());
+  Kokkos::deep_copy(space, mesh,
+                    Kokkos::View<Triangle const *, Kokkos::HostSpace,
+                                 Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+                        triangles.data(), triangles.size()));
+  Tree const tree(space, mesh);
+
+  int const n = rays.size();
+  Kokkos::View<Ray *, MemorySpace> rays_view(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Benchmark::rays"),
+      n);
+  Kokkos::deep_copy(space, rays_view,
+                    Kokkos::View<Ray const *, Kokkos::HostSpace,
+                                 Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+                        rays.data(), n));
+  using Predicate =
+      decltype(ArborX::attach(make_predicate(Ray{}), std::declval<int>()));
+  Kokkos::View<Predicate *, MemorySpace> predicates(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Benchmark::predicates"),
+      n);
+  Kokkos::parallel_for(
+      "Benchmark::make_predicates",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        predicates(i) = ArborX::attach(make_predicate(rays_view(i)), i);
+      });
+
+  Kokkos::View<int *, MemorySpace> hits("Benchmark::hits", n);
+  for (auto _ : state)
+  {
+    Kokkos::deep_copy(space, hits, 0);
+
+    space.fence();
+    auto const start = std::chrono::high_resolution_clock::now();
+
+    tree.query(space, predicates, CountHits<MemorySpace>{hits});
+
+    space.fence();
+    auto const end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+  state.counters["rate"] =
+      benchmark::Counter(n, benchmark::Counter::kIsIterationInvariantRate);
+
+  long long total_hits = 0;
+  Kokkos::parallel_reduce(
+      "Benchmark::count_hits", Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, long long &update) { update += hits(i); },
+      total_hits);
+  state.counters["hits_per_ray"] = (double)total_hits / std::max(n, 1);
+}
+
+template <typename ExecutionSpace>
+void registerBenchmarks(
+    std::string const &backend,
+    std::shared_ptr<std::vector<Triangle> const> const &triangles, int n_rays)
+{
+  for (auto const &kind_and_name :
+       {std::make_pair(RayKind::primary, "primary"),
+        std::make_pair(RayKind::shadow, "shadow"),
+        std::make_pair(RayKind::diffuse, "diffuse")})
+  {
+    std::string const kind_name = kind_and_name.second;
+    std::shared_ptr<std::vector<Ray> const> const rays =
+        std::make_shared<std::vector<Ray>>(
+            makeRays(kind_and_name.first, *triangles, n_rays));
+    auto const register_mode = [&](std::string const &mode,
+                                   auto make_predicate) {
+      std::string const label =
+          "BM_" + mode + "_" + kind_name + "_rays<" + backend + ">/" +
+          std::to_string(triangles->size()) + "/" + std::to_string(n_rays);
+      benchmark::RegisterBenchmark(
+          label.c_str(),
+          [triangles, rays, make_predicate](benchmark::State &state) {
+            BM_ray_tracing<ExecutionSpace>(state, *triangles, *rays,
+                                           make_predicate);
+          })
+          ->UseManualTime()
+          ->Unit(benchmark::kMillisecond);
+    };
+    register_mode("all_hits", AllHits{});
+    register_mode("ordered_hits", OrderedHits{});
+    register_mode("closest_hit", ClosestHit{});
+    register_mode("nearest_hit", NearestHit{});
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Kokkos::ScopeGuard guard(argc, argv);
+
+  std::cout << "ArborX version: " << ArborX::version() << std::endl;
+  std::cout << "ArborX hash   : " << ArborX::gitCommitHash() << std::endl;
+  std::cout << "Kokkos version: " << KokkosExt::version() << std::endl;
+
+  namespace bpo = boost::program_options;
+  bpo::options_description desc("Allowed options");
+  std::string backends;
+  std::string filename;
+  int n_rays;
+  int sphere_resolution;
+  // clang-format off
+  desc.add_options()
+      ( "help", "produce help message" )
+      ( "backends", bpo::value<std::string>(&backends)->default_value("all"), "backend to run on (all, serial, openmp, threads, cuda, hip, sycl, openmptarget)" )
+      ( "mesh", bpo::value<std::string>(&filename), "triangle mesh (.obj or ASCII .ply)" )
+      ( "sphere-resolution", bpo::value<int>(&sphere_resolution)->default_value(256), "number of parallels and meridians of the sphere used without a mesh" )
+      ( "rays", bpo::value<int>(&n_rays)->default_value(1 << 20), "number of rays of each kind" )
+  ;
+  // clang-format on
+  bpo::variables_map vm;
+  bpo::store(bpo::command_line_parser(argc, argv)
+                 .options(desc)
+                 .allow_unregistered()
+                 .run(),
+             vm);
+  bpo::notify(vm);
+
+  if (vm.count("help") > 0)
+  {
+    std::cout << desc << "\n";
+    return EXIT_SUCCESS;
+  }
+
+  // Google Benchmark removes its own arguments, all the remaining ones must
+  // have been recognized above
+  benchmark::Initialize(&argc, argv);
+  std::ignore = bpo::command_line_parser(argc, argv).options(desc).run();
+
+  std::shared_ptr<std::vector<Triangle> const> const triangles =
+      std::make_shared<std::vector<Triangle>>(
+          vm.count("mesh") > 0
+              ? ArborXBenchmark::loadMesh(filename)
+              : ArborXBenchmark::makeSphere(sphere_resolution));
+  if (triangles->empty())
+    throw std::runtime_error("The mesh has no triangles");
+  std::cout << "Triangles     : " << triangles->size() << std::endl;
+
+  bool found = false;
+  auto const selected = [&backends, &found](std::string const &backend) {
+    bool const is_selected = (backends == "all" || backends == backend);
+    found |= is_selected;
+    return is_selected;
+  };
+#ifdef KOKKOS_ENABLE_SERIAL
+  if (selected("serial"))
+    registerBenchmarks<Kokkos::Serial>("Serial", triangles, n_rays);
+#endif
+#ifdef KOKKOS_ENABLE_OPENMP
+  if (selected("openmp"))
+    registerBenchmarks<Kokkos::OpenMP>("OpenMP", triangles, n_rays);
+#endif
+#ifdef KOKKOS_ENABLE_THREADS
+  if (selected("threads"))
+    registerBenchmarks<Kokkos::Threads>("Threads", triangles, n_rays);
+#endif
+#ifdef KOKKOS_ENABLE_CUDA
+  if (selected("cuda"))
+    registerBenchmarks<Kokkos::Cuda>("Cuda", triangles, n_rays);
+#endif
+#ifdef KOKKOS_ENABLE_HIP
+  if (selected("hip"))
+    registerBenchmarks<Kokkos::HIP>("HIP", triangles, n_rays);
+#endif
+#ifdef KOKKOS_ENABLE_SYCL
+  if (selected("sycl"))
+    registerBenchmarks<Kokkos::Experimental::SYCL>("SYCL", triangles, n_rays);
+#endif
+#ifdef KOKKOS_ENABLE_OPENMPTARGET
+  if (selected("openmptarget"))
+    registerBenchmarks<Kokkos::Experimental::OpenMPTarget>("OpenMPTarget",
+                                                           triangles, n_rays);
+#endif
+  if (!found)
+    throw std::runtime_error("Backend " + backends + " not available!");
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  return EXIT_SUCCESS;
+}
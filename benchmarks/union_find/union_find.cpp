@@ -32,6 +32,8 @@ struct AllowLoops
 {};
 struct DisallowLoops
 {};
+struct DBSCANLike
+{};
 
 template <typename ExecutionSpace>
 Kokkos::View<UnweightedEdge *, typename ExecutionSpace::memory_space>
@@ -97,7 +99,31 @@ buildEdges(DisallowLoops, ExecutionSpace const &exec_space, int num_edges)
   return edges;
 }
 
+// Edges between each point of a dense chain and its next neighbors, in the
+// order of the points, as in a DBSCAN with a large eps relative to the point
+// spacing. The concurrent merges build long paths across the single cluster.
 template <typename ExecutionSpace>
+Kokkos::View<UnweightedEdge *, typename ExecutionSpace::memory_space>
+buildEdges(DBSCANLike, ExecutionSpace const &exec_space, int num_edges)
+{
+  using MemorySpace = typename ExecutionSpace::memory_space;
+
+  constexpr unsigned num_neighbors = 8;
+  Kokkos::View<UnweightedEdge *, MemorySpace> edges(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "Benchmark::edges"),
+      num_edges);
+  Kokkos::parallel_for(
+      "Benchmark::init_edges",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+      KOKKOS_LAMBDA(unsigned e) {
+        unsigned const i = e / num_neighbors;
+        edges(e) = {i, i + 1 + e % num_neighbors};
+      });
+  return edges;
+}
+
+template <ArborX::Details::UnionFindVariant Variant, typename ExecutionSpace>
 auto buildUnionFind(ExecutionSpace const &exec_space, int n)
 {
   using MemorySpace = typename ExecutionSpace::memory_space;
@@ -107,13 +133,15 @@ auto buildUnionFind(ExecutionSpace const &exec_space, int n)
   ArborX::iota(exec_space, labels);
 #ifdef KOKKOS_ENABLE_SERIAL
   if constexpr (std::is_same_v<ExecutionSpace, Kokkos::Serial>)
-    return ArborX::Details::UnionFind<MemorySpace, /*DoSerial*/ true>(labels);
+    return ArborX::Details::UnionFind<MemorySpace, /*DoSerial*/ true, Variant>(
+        labels);
   else
 #endif
-    return ArborX::Details::UnionFind<MemorySpace, /*DoSerial*/ false>(labels);
+    return ArborX::Details::UnionFind<MemorySpace, /*DoSerial*/ false,
+                                      Variant>(labels);
 }
 
-template <typename Tag>
+template <typename Tag, ArborX::Details::UnionFindVariant Variant>
 void BM_union_find(benchmark::State &state)
 {
   using ExecutionSpace = Kokkos::DefaultExecutionSpace;
@@ -124,7 +152,7 @@ void BM_union_find(benchmark::State &state)
   auto const n = num_edges + 1;
 
   auto edges = buildEdges(Tag{}, exec_space, num_edges);
-  auto union_find = buildUnionFind(exec_space, n);
+  auto union_find = buildUnionFind<Variant>(exec_space, n);
 
   for (auto _ : state)
   {
@@ -160,16 +188,24 @@ int main(int argc, char *argv[])
 
   benchmark::Initialize(&argc, argv);
 
-  BENCHMARK_TEMPLATE1(BM_union_find, AllowLoops)
-      ->RangeMultiplier(10)
-      ->Range(10000, 100000)
-      ->UseManualTime()
-      ->Unit(benchmark::kMicrosecond);
-  BENCHMARK_TEMPLATE1(BM_union_find, DisallowLoops)
-      ->RangeMultiplier(10)
-      ->Range(10000, 100000)
-      ->UseManualTime()
-      ->Unit(benchmark::kMicrosecond);
+  using ArborX::Details::UnionFindVariant;
+#define REGISTER_BENCHMARK(Tag, Variant)                                       \
+  BENCHMARK_TEMPLATE2(BM_union_find, Tag, UnionFindVariant::Variant)           \
+      ->RangeMultiplier(10)                                                    \
+      ->Range(10000, 100000)                                                   \
+      ->UseManualTime()                                                        \
+      ->Unit(benchmark::kMicrosecond)
+
+  REGISTER_BENCHMARK(AllowLoops, ECL);
+  REGISTER_BENCHMARK(AllowLoops, PATH_HALVING);
+  REGISTER_BENCHMARK(AllowLoops, UNION_BY_INDEX);
+  REGISTER_BENCHMARK(DisallowLoops, ECL);
+  REGISTER_BENCHMARK(DisallowLoops, PATH_HALVING);
+  REGISTER_BENCHMARK(DisallowLoops, UNION_BY_INDEX);
+  REGISTER_BENCHMARK(DBSCANLike, ECL);
+  REGISTER_BENCHMARK(DBSCANLike, PATH_HALVING);
+  REGISTER_BENCHMARK(DBSCANLike, UNION_BY_INDEX);
+#undef REGISTER_BENCHMARK
 
   benchmark::RunSpecifiedBenchmarks();
 
@@ -24,6 +24,7 @@
 
 #include <ArborX.hpp>
 #include <ArborX_Ray.hpp>
+#include <ArborX_SortResultsPerPredicate.hpp>
 
 #include <Kokkos_Core.hpp>
 #include <Kokkos_Random.hpp>
@@ -31,7 +32,6 @@
 #include <boost/program_options.hpp>
 
 #include <iostream>
-#include <numeric>
 
 // The total energy that is distributed across all rays.
 float const total_energy = 4000.f;
@@ -119,34 +119,25 @@ struct Rays
 /*
  * IntersectedCell is a storage container for all intersections between rays and
  * boxes that are detected when calling the AccumulateRaySphereIntersections
- * struct. The member variables that are relevant for sorting the intersection
- * according to box and ray are contained in the base class
- * IntersectedCellForSorting as performance improvement.
+ * struct. The intersections of each ray are sorted by entry length after the
+ * query.
  */
-struct IntersectedCellForSorting
+struct IntersectedCell
 {
-  float entrylength;
-  int ray_id;
-  friend KOKKOS_FUNCTION bool operator<(IntersectedCellForSorting const &l,
-                                        IntersectedCellForSorting const &r)
-  {
-    if (l.ray_id == r.ray_id)
-      return l.entrylength < r.entrylength;
-    return l.ray_id < r.ray_id;
-  }
+  float entrylength;         // distance along the ray to the box
+  float optical_path_length; // optical distance through box
+  int cell_id;               // box ID
 };
 
-struct IntersectedCell : public IntersectedCellForSorting
+/*
+ * Key for sorting the intersections of each ray.
+ */
+struct EntryLength
 {
-  float optical_path_length; // optical distance through box
-  int cell_id;               // box ID
-  KOKKOS_FUNCTION IntersectedCell() = default;
-  KOKKOS_FUNCTION IntersectedCell(float entry_length, float path_length,
-                                  int primitive_index, int predicate_index)
-      : IntersectedCellForSorting{entry_length, predicate_index}
-      , optical_path_length(path_length)
-      , cell_id(primitive_index)
-  {}
+  KOKKOS_FUNCTION float operator()(IntersectedCell const &cell) const
+  {
+    return cell.entrylength;
+  }
 };
 
 /*
@@ -166,13 +157,11 @@ struct AccumulateRaySphereIntersections
     float entrylength;
     auto const &ray = ArborX::getGeometry(predicate);
     auto const &box = _boxes(primitive_index);
-    int const predicate_index = ArborX::getData(predicate);
     float const kappa = 1.;
     overlapDistance(ray, box, length, entrylength);
     out(IntersectedCell{/*entrylength*/ entrylength,
                         /*optical_path_length*/ kappa * length,
-                        /*cell_id*/ primitive_index,
-                        /*ray_id*/ predicate_index});
+                        /*cell_id*/ primitive_index});
   }
 };
 } // namespace IntersectsBased
@@ -340,36 +329,9 @@ int main(int argc, char *argv[])
         IntersectsBased::AccumulateRaySphereIntersections<MemorySpace>{boxes},
         values, offsets);
 
-    Kokkos::View<IntersectsBased::IntersectedCellForSorting *, MemorySpace>
-        sort_array(Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
-                                      "Example::sort_array"),
-                   values.size());
-    Kokkos::parallel_for(
-        "Example::copy sort_array",
-        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, values.size()),
-        KOKKOS_LAMBDA(int i) { sort_array(i) = values(i); });
-    Kokkos::Profiling::pushRegion("Example::sorting by key");
-    // FIXME Users should not need to reach into the Details namespace.
-#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP) ||               \
-    defined(KOKKOS_ENABLE_SYCL)
-    auto permutation = ArborX::Details::sortObjects(exec_space, sort_array);
-#else
-    auto sort_array_host =
-        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, sort_array);
-    Kokkos::View<int *, Kokkos::HostSpace> permutation_host(
-        Kokkos::view_alloc("Example::permutation", Kokkos::WithoutInitializing),
-        sort_array_host.size());
-    std::iota(permutation_host.data(),
-              permutation_host.data() + sort_array_host.size(), 0);
-    std::sort(permutation_host.data(),
-              permutation_host.data() + sort_array_host.size(),
-              [&](int const &a, int const &b) {
-                return (sort_array_host(a) < sort_array_host(b));
-              });
-    auto permutation =
-        Kokkos::create_mirror_view_and_copy(MemorySpace{}, permutation_host);
-#endif
-    Kokkos::Profiling::popRegion();
+    // Sort the intersections of each ray by distance along it
+    ArborX::Experimental::sortResultsPerPredicate(
+        exec_space, offsets, values, IntersectsBased::EntryLength{});
 
     energy_intersects = Kokkos::View<float *, MemorySpace>(
         "Example::energy_intersects", num_boxes);
@@ -381,7 +343,7 @@ int main(int argc, char *argv[])
           float ray_energy = (total_energy * dx * dy * dz) / rays_per_box;
           for (int j = offsets(i); j < offsets(i + 1); ++j)
           {
-            const auto &v = values(permutation(j));
+            const auto &v = values(j);
             float const energy_deposited =
                 lost_energy(ray_energy, v.optical_path_length);
             ray_energy += energy_deposited;
@@ -128,6 +128,19 @@ void viz(std::string const &prefix, std::string const &infile, int n_neighbors)
   TreeVisualization::visitAllIterative(bvh, GraphvizVisitor{fout});
   fout.close();
 
+  // Print the bounding volumes of the nodes visited by the nearest queries,
+  // with their numbers of visits
+  ArborX::Experimental::TraversalStatistics statistics;
+  statistics.enableNodeVisits();
+  Kokkos::View<int *, DeviceType> indices("Example::indices", 0);
+  Kokkos::View<int *, DeviceType> offsets("Example::offsets", 0);
+  bvh.query(ExecutionSpace{}, queries, indices, offsets,
+            ArborX::Experimental::TraversalPolicy().setStatistics(statistics));
+  fout.open(prefix + "node_visits.vtk", std::fstream::out);
+  TreeVisualization::writeNodeVisitsVTK(fout, ExecutionSpace{}, bvh,
+                                        statistics);
+  fout.close();
+
   std::string const suffix = "_nearest_traversal.dot.m4";
   performQueries(prefix + "untouched_", suffix);
 
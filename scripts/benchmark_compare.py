@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""benchmark_compare.py
+
+Compare the results of a benchmark run against a stored baseline. Both are
+Google Benchmark outputs in JSON format, for instance from
+ArborX_Benchmark_Harness.exe --benchmark_out=FILE --benchmark_out_format=json
+
+A benchmark regresses when its rate drops, or its peak memory grows, by more
+than the tolerance. The exit status is 1 if any benchmark regressed.
+
+Usage:
+  benchmark_compare.py -b BASELINE -i INPUT [-t TOLERANCE]
+  benchmark_compare.py (-h | --help)
+
+Options:
+  -h --help                           Show this screen.
+  -b FILE --baseline=FILE             Baseline results in JSON format
+  -i FILE --input-file=FILE           Results to compare in JSON format
+  -t TOLERANCE --tolerance=TOLERANCE  Relative tolerance [default: 0.1]
+"""
+import json
+import sys
+from docopt import docopt
+
+def load_results(filename):
+    with open(filename) as f:
+        benchmarks = json.load(f)['benchmarks']
+
+    results = {}
+    for benchmark in benchmarks:
+        # With repetitions, only compare the medians
+        if benchmark.get('run_type') == 'aggregate':
+            if benchmark.get('aggregate_name') != 'median':
+                continue
+            name = benchmark['run_name']
+        else:
+            name = benchmark['name']
+        results[name] = {key: benchmark[key] for key in ['rate', 'peak_memory'] if key in benchmark}
+    return results
+
+def relative_change(baseline, value):
+    if baseline == 0:
+        return 0. if value == 0 else float('inf')
+    return (value - baseline) / baseline
+
+if __name__ == '__main__':
+    options = docopt(__doc__)
+
+    baseline = load_results(options['--baseline'])
+    results = load_results(options['--input-file'])
+    tolerance = float(options['--tolerance'])
+
+    regressions = 0
+    print('%-70s %10s %10s' % ('Benchmark', 'rate', 'memory'))
+    for name in sorted(results):
+        if name not in baseline:
+            print('%-70s %10s %10s' % (name, 'new', 'new'))
+            continue
+
+        changes = []
+        regressed = False
+        for key, sign in [('rate', -1), ('peak_memory', 1)]:
+            if key not in results[name] or key not in baseline[name]:
+                changes.append('-')
+                continue
+            change = relative_change(baseline[name][key], results[name][key])
+            changes.append('%+.1f%%' % (100 * change))
+            regressed |= (sign * change > tolerance)
+        regressions += regressed
+        print('%-70s %10s %10s%s' % (name, changes[0], changes[1], ' REGRESSION' if regressed else ''))
+
+    for name in sorted(set(baseline) - set(results)):
+        print('%-70s %10s %10s' % (name, 'missing', 'missing'))
+
+    print('%d regression(s) with a tolerance of %g%%' % (regressions, 100 * tolerance))
+    sys.exit(1 if regressions > 0 else 0)
@@ -0,0 +1,270 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_ADAPTIVE_INDEX_HPP
+#define ARBORX_ADAPTIVE_INDEX_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsBruteForceImpl.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_Predicates.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+
+namespace ArborX
+{
+namespace Details
+{
+// Counts the results so that the tests timed by the calibration cannot be
+// optimized away
+template <typename MemorySpace>
+struct CountResultsCallback
+{
+  Kokkos::View<int, MemorySpace> _count;
+
+  template <typename Predicate>
+  KOKKOS_FUNCTION void operator()(Predicate const &, int) const
+  {
+    Kokkos::atomic_increment(&_count());
+  }
+};
+} // namespace Details
+
+namespace Experimental
+{
+
+// Index answering each batch of predicates either by brute force or with a
+// bounding volume hierarchy, whichever is estimated to be the fastest. The
+// bounding volumes of the primitives are computed on construction, but the
+// hierarchy is only built by the first batch large enough to pay for it.
+//
+// With P primitives and Q predicates, the brute force costs P * Q tests and
+// the hierarchy r * (P + Q * log2(P)), the construction accounting for r * P
+// of them. The cost ratio r between the operations of the hierarchy and the
+// tests of the brute force depends on the backend. It can be measured by
+// calibrate(). Callbacks are given the indices of the primitives.
+template <typename MemorySpace, typename BoundingVolume = Box>
+class AdaptiveIndex
+{
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using size_type = typename MemorySpace::size_type;
+  using bounding_volume_type = BoundingVolume;
+
+  AdaptiveIndex() = default;
+
+  template <typename ExecutionSpace, typename Primitives>
+  AdaptiveIndex(ExecutionSpace const &space, Primitives const &primitives);
+
+  KOKKOS_FUNCTION
+  size_type size() const noexcept { return _size; }
+
+  KOKKOS_FUNCTION
+  bool empty() const noexcept { return size() == 0; }
+
+  KOKKOS_FUNCTION
+  bounding_volume_type bounds() const noexcept { return _bounds; }
+
+  float costRatio() const noexcept { return _cost_ratio; }
+
+  void setCostRatio(float cost_ratio) noexcept { _cost_ratio = cost_ratio; }
+
+  // Measure the cost ratio by timing both methods on a sample of the
+  // bounding volumes queried against each other
+  template <typename ExecutionSpace>
+  void calibrate(ExecutionSpace const &space);
+
+  // Whether a batch of that many spatial or nearest predicates would be
+  // answered by brute force. Ordered spatial predicates always use the
+  // hierarchy.
+  bool usesBruteForce(int n_predicates) const;
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback,
+             TraversalPolicy const &policy = TraversalPolicy()) const;
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+
+private:
+  using tree_type =
+      BasicBoundingVolumeHierarchy<MemorySpace,
+                                   Details::PairIndexVolume<BoundingVolume>,
+                                   Details::DefaultIndexableGetter,
+                                   BoundingVolume>;
+
+  template <typename ExecutionSpace>
+  void buildTree(ExecutionSpace const &space) const;
+
+  size_type _size{0};
+  bounding_volume_type _bounds;
+  Kokkos::View<bounding_volume_type *, memory_space> _bounding_volumes;
+  float _cost_ratio = 32.f;
+  // Built lazily by the queries
+  mutable tree_type _tree;
+  mutable bool _tree_is_built = false;
+};
+
+template <typename MemorySpace, typename BoundingVolume>
+template <typename ExecutionSpace, typename Primitives>
+AdaptiveIndex<MemorySpace, BoundingVolume>::AdaptiveIndex(
+    ExecutionSpace const &space, Primitives const &primitives)
+    : _size(AccessTraits<Primitives, PrimitivesTag>::size(primitives))
+    , _bounding_volumes(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                             "ArborX::AdaptiveIndex::bounding_volumes"),
+          _size)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::AdaptiveIndex::AdaptiveIndex");
+
+  Details::BruteForceImpl::initializeBoundingVolumesAndReduceBoundsOfTheScene(
+      space, primitives, _bounding_volumes, _bounds);
+}
+
+template <typename MemorySpace, typename BoundingVolume>
+template <typename ExecutionSpace>
+void AdaptiveIndex<MemorySpace, BoundingVolume>::buildTree(
+    ExecutionSpace const &space) const
+{
+  if (_tree_is_built)
+    return;
+  _tree = tree_type(space, _bounding_volumes);
+  _tree_is_built = true;
+}
+
+template <typename MemorySpace, typename BoundingVolume>
+bool AdaptiveIndex<MemorySpace, BoundingVolume>::usesBruteForce(
+    int n_predicates) const
+{
+  float const n = size();
+  float const m = n_predicates;
+  float const brute_force_cost = n * m;
+  float const tree_cost =
+      _cost_ratio * ((_tree_is_built ? 0.f : n) +
+                     m * std::log2(KokkosExt::max(n, 2.f)));
+  return brute_force_cost <= tree_cost;
+}
+
+template <typename MemorySpace, typename BoundingVolume>
+template <typename ExecutionSpace>
+void AdaptiveIndex<MemorySpace, BoundingVolume>::calibrate(
+    ExecutionSpace const &space)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::AdaptiveIndex::calibrate");
+
+  int const n = KokkosExt::min((int)size(), 1024);
+  if (n < 2)
+    return;
+
+  auto const samples =
+      Kokkos::subview(_bounding_volumes, Kokkos::make_pair(0, n));
+  Kokkos::View<Intersects<bounding_volume_type> *, MemorySpace> predicates(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::AdaptiveIndex::calibrate::predicates"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::AdaptiveIndex::calibrate::make_predicates",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) { predicates(i) = ArborX::intersects(samples(i)); });
+
+  Details::CountResultsCallback<MemorySpace> const callback{
+      Kokkos::View<int, MemorySpace>(
+          "ArborX::AdaptiveIndex::calibrate::count")};
+
+  space.fence();
+  Kokkos::Timer timer;
+  Details::BruteForceImpl::query(Details::SpatialPredicateTag{}, space,
+                                 samples, predicates, callback);
+  space.fence();
+  double const brute_force_time = timer.seconds();
+
+  timer.reset();
+  tree_type const tree(space, samples);
+  tree.query(space, predicates,
+             Details::LegacyCallbackWrapper<
+                 Details::CountResultsCallback<MemorySpace>,
+                 typename tree_type::value_type>{callback});
+  space.fence();
+  double const tree_time = timer.seconds();
+
+  if (brute_force_time > 0 && tree_time > 0)
+    _cost_ratio = (tree_time / (n + n * std::log2(n))) /
+                  (brute_force_time / ((double)n * n));
+}
+
+template <typename MemorySpace, typename BoundingVolume>
+template <typename ExecutionSpace, typename Predicates, typename Callback>
+void AdaptiveIndex<MemorySpace, BoundingVolume>::query(
+    ExecutionSpace const &space, Predicates const &predicates,
+    Callback const &callback, TraversalPolicy const &policy) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  using Value = int;
+  Details::check_valid_callback<Value>(callback, predicates);
+
+  if constexpr (!std::is_same_v<Tag, OrderedSpatialPredicateTag>)
+  {
+    if (usesBruteForce(Access::size(predicates)))
+    {
+      KokkosExt::ScopedProfileRegion guard(
+          "ArborX::AdaptiveIndex::query::brute_force");
+      Details::BruteForceImpl::query(Tag{}, space, _bounding_volumes,
+                                     predicates, callback);
+      return;
+    }
+  }
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::AdaptiveIndex::query::tree");
+  buildTree(space);
+  _tree.query(space, predicates,
+              Details::LegacyCallbackWrapper<
+                  Callback, typename tree_type::value_type>{callback},
+              policy);
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
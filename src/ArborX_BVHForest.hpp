@@ -0,0 +1,244 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_BVH_FOREST_HPP
+#define ARBORX_BVH_FOREST_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsForestTraversal.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace ArborX::Experimental
+{
+
+// Container for many hierarchies that are searched together in a single
+// kernel launch. Each predicate is directed to one of the trees by attaching
+// the tree index to it (see inTree()). The nodes of all the trees are stored
+// contiguously and each tree keeps its own node indexing. Only spatial
+// queries are supported.
+template <typename Tree>
+class BoundingVolumeHierarchyForest
+{
+  using leaf_nodes_type = std::decay_t<decltype(
+      Details::HappyTreeFriends::getLeafNodes(std::declval<Tree const &>()))>;
+  using internal_nodes_type =
+      std::decay_t<decltype(Details::HappyTreeFriends::getInternalNodes(
+          std::declval<Tree const &>()))>;
+  using indexable_getter_type =
+      std::decay_t<decltype(Details::HappyTreeFriends::getIndexableGetter(
+          std::declval<Tree const &>()))>;
+
+public:
+  using memory_space = typename Tree::memory_space;
+  using size_type = typename Tree::size_type;
+  using bounding_volume_type = typename Tree::bounding_volume_type;
+  using value_type = typename Tree::value_type;
+
+  BoundingVolumeHierarchyForest() = default; // build an empty forest
+
+  template <typename ExecutionSpace>
+  BoundingVolumeHierarchyForest(ExecutionSpace const &space,
+                                std::vector<Tree> const &trees);
+
+  // Number of trees in the forest
+  KOKKOS_FUNCTION
+  size_type size() const noexcept { return _forest.size(); }
+
+  KOKKOS_FUNCTION
+  bool empty() const noexcept { return size() == 0; }
+
+  // Union of the bounds of all the trees
+  KOKKOS_FUNCTION
+  bounding_volume_type bounds() const noexcept { return _bounds; }
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback,
+             Experimental::TraversalPolicy const &policy =
+                 Experimental::TraversalPolicy()) const;
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+
+private:
+  bounding_volume_type _bounds;
+  Details::Forest<leaf_nodes_type, internal_nodes_type, bounding_volume_type,
+                  indexable_getter_type>
+      _forest;
+};
+
+// Legacy trees pass the index of the value to the callbacks
+template <typename MemorySpace>
+class BoundingVolumeHierarchyForest<BoundingVolumeHierarchy<MemorySpace>>
+    : public BoundingVolumeHierarchyForest<BasicBoundingVolumeHierarchy<
+          MemorySpace, Details::PairIndexVolume<Box>,
+          Details::DefaultIndexableGetter, Box>>
+{
+  using tree_base_type =
+      BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>,
+                                   Details::DefaultIndexableGetter, Box>;
+  using base_type = BoundingVolumeHierarchyForest<tree_base_type>;
+
+public:
+  using legacy_tree = void;
+
+  BoundingVolumeHierarchyForest() = default; // build an empty forest
+
+  template <typename ExecutionSpace>
+  BoundingVolumeHierarchyForest(
+      ExecutionSpace const &space,
+      std::vector<BoundingVolumeHierarchy<MemorySpace>> const &trees)
+      : base_type(space,
+                  std::vector<tree_base_type>(trees.begin(), trees.end()))
+  {}
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback,
+             Experimental::TraversalPolicy const &policy =
+                 Experimental::TraversalPolicy()) const
+  {
+    base_type::query(space, predicates,
+                     Details::LegacyCallbackWrapper<
+                         Callback, typename base_type::value_type>{callback},
+                     policy);
+  }
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+};
+
+template <typename Tree>
+template <typename ExecutionSpace>
+BoundingVolumeHierarchyForest<Tree>::BoundingVolumeHierarchyForest(
+    ExecutionSpace const &space, std::vector<Tree> const &trees)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<memory_space, ExecutionSpace>::value);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::BVHForest::BVHForest");
+
+  int const num_trees = trees.size();
+
+  Kokkos::View<Details::ForestTreeOffsets *, Kokkos::HostSpace> offsets_host(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "ArborX::BVHForest::offsets"),
+      num_trees + 1);
+  Kokkos::View<bounding_volume_type *, Kokkos::HostSpace> bounds_host(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "ArborX::BVHForest::bounds"),
+      num_trees);
+  offsets_host(0) = {0, 0};
+  for (int t = 0; t < num_trees; ++t)
+  {
+    auto const &tree = trees[t];
+    offsets_host(t + 1).leaf_nodes =
+        offsets_host(t).leaf_nodes +
+        Details::HappyTreeFriends::getLeafNodes(tree).extent_int(0);
+    offsets_host(t + 1).internal_nodes =
+        offsets_host(t).internal_nodes +
+        Details::HappyTreeFriends::getInternalNodes(tree).extent_int(0);
+    bounds_host(t) = tree.bounds();
+    Details::expand(_bounds, bounds_host(t));
+  }
+
+  _forest._offsets =
+      Kokkos::create_mirror_view_and_copy(memory_space{}, offsets_host);
+  _forest._bounds =
+      Kokkos::create_mirror_view_and_copy(memory_space{}, bounds_host);
+  _forest._leaf_nodes = leaf_nodes_type(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVHForest::leaf_nodes"),
+      offsets_host(num_trees).leaf_nodes);
+  _forest._internal_nodes = internal_nodes_type(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVHForest::internal_nodes"),
+      offsets_host(num_trees).internal_nodes);
+  if (num_trees > 0)
+    _forest._indexable_getter =
+        Details::HappyTreeFriends::getIndexableGetter(trees[0]);
+
+  // Node indices are relative to each tree so that the nodes can be copied
+  // as they are
+  for (int t = 0; t < num_trees; ++t)
+  {
+    auto const &tree = trees[t];
+    Kokkos::deep_copy(
+        space,
+        Kokkos::subview(_forest._leaf_nodes,
+                        Kokkos::make_pair(offsets_host(t).leaf_nodes,
+                                          offsets_host(t + 1).leaf_nodes)),
+        Details::HappyTreeFriends::getLeafNodes(tree));
+    Kokkos::deep_copy(
+        space,
+        Kokkos::subview(_forest._internal_nodes,
+                        Kokkos::make_pair(offsets_host(t).internal_nodes,
+                                          offsets_host(t + 1).internal_nodes)),
+        Details::HappyTreeFriends::getInternalNodes(tree));
+  }
+}
+
+template <typename Tree>
+template <typename ExecutionSpace, typename Predicates, typename Callback>
+void BoundingVolumeHierarchyForest<Tree>::query(
+    ExecutionSpace const &space, Predicates const &predicates,
+    Callback const &callback, Experimental::TraversalPolicy const &) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<memory_space, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{},
+                "nearest query not implemented yet");
+  Details::check_valid_callback<value_type>(callback, predicates);
+
+  Kokkos::Profiling::pushRegion("ArborX::BVHForest::query::spatial");
+
+  Details::traverseForest(space, _forest, predicates, callback);
+
+  Kokkos::Profiling::popRegion();
+}
+
+} // namespace ArborX::Experimental
+
+#endif
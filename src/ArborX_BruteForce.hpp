@@ -109,14 +109,19 @@ void BruteForce<MemorySpace, BoundingVolume>::query(
                                               ExecutionSpace>::value,
                 "Predicates must be accessible from the execution space");
   using Tag = typename Details::AccessTraitsHelper<Access>::tag;
-  static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{},
-                "nearest query not implemented yet");
+  constexpr bool is_nearest =
+      std::is_same<Tag, Details::NearestPredicateTag>{};
+  static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{} ||
+                    is_nearest,
+                "ordered spatial query not implemented yet");
   using Value = int;
   Details::check_valid_callback<Value>(callback, predicates);
 
-  Kokkos::Profiling::pushRegion("ArborX::BruteForce::query::spatial");
+  Kokkos::Profiling::pushRegion(is_nearest
+                                    ? "ArborX::BruteForce::query::nearest"
+                                    : "ArborX::BruteForce::query::spatial");
 
-  Details::BruteForceImpl::query(space, _bounding_volumes, predicates,
+  Details::BruteForceImpl::query(Tag{}, space, _bounding_volumes, predicates,
                                  callback);
 
   Kokkos::Profiling::popRegion();
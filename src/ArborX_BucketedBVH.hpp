@@ -0,0 +1,185 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_BUCKETED_BVH_HPP
+#define ARBORX_BUCKETED_BVH_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsBucketedBVHImpl.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsUtils.hpp> // iota
+#include <ArborX_Exception.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+namespace ArborX::Experimental
+{
+
+// Bounding volume hierarchy whose leaves hold buckets of up to
+// policy._bucket_size (at most 16) consecutive primitives along the
+// space-filling curve. The indexables are copied contiguously in curve order
+// and the indexables of a bucket are checked together during the traversal,
+// which is favorable to vectorization. The hierarchy over the buckets has
+// bucket_size times fewer nodes than the binary one over the primitives.
+// Store the indexables as points (Indexable = Point) for point data to halve
+// their memory. Only spatial queries are supported.
+template <typename MemorySpace, typename BoundingVolume = Box,
+          typename Indexable = BoundingVolume>
+class BucketedBoundingVolumeHierarchy
+{
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using size_type = typename MemorySpace::size_type;
+  using bounding_volume_type = BoundingVolume;
+  static_assert(GeometryTraits::is_box<BoundingVolume>{});
+
+  BucketedBoundingVolumeHierarchy() = default; // build an empty tree
+
+  template <typename ExecutionSpace, typename Primitives,
+            typename SpaceFillingCurve = Experimental::Morton64>
+  BucketedBoundingVolumeHierarchy(
+      ExecutionSpace const &space, Primitives const &primitives,
+      SpaceFillingCurve const &curve = SpaceFillingCurve(),
+      ConstructionPolicy const &policy = ConstructionPolicy());
+
+  KOKKOS_FUNCTION
+  size_type size() const noexcept { return _size; }
+
+  KOKKOS_FUNCTION
+  bool empty() const noexcept { return size() == 0; }
+
+  KOKKOS_FUNCTION
+  bounding_volume_type bounds() const noexcept { return _buckets.bounds(); }
+
+  int bucketSize() const noexcept { return _bucket_size; }
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback,
+            typename Ignore = int>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback, Ignore = Ignore()) const;
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+
+private:
+  using buckets_type =
+      BasicBoundingVolumeHierarchy<MemorySpace,
+                                   Details::PairIndexVolume<BoundingVolume>,
+                                   Details::DefaultIndexableGetter,
+                                   BoundingVolume>;
+
+  size_type _size{0};
+  int _bucket_size = 1;
+  buckets_type _buckets;
+  // Indexables in curve order, and the index of the corresponding primitives
+  Kokkos::View<Indexable *, MemorySpace> _indexables;
+  Kokkos::View<unsigned int *, MemorySpace> _indices;
+};
+
+template <typename MemorySpace, typename BoundingVolume, typename Indexable>
+template <typename ExecutionSpace, typename Primitives,
+          typename SpaceFillingCurve>
+BucketedBoundingVolumeHierarchy<MemorySpace, BoundingVolume, Indexable>::
+    BucketedBoundingVolumeHierarchy(ExecutionSpace const &space,
+                                    Primitives const &primitives,
+                                    SpaceFillingCurve const &curve,
+                                    ConstructionPolicy const &policy)
+    : _size(AccessTraits<Primitives, PrimitivesTag>::size(primitives))
+    , _bucket_size(policy._bucket_size)
+    , _indexables(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                     "ArborX::BucketedBVH::indexables"),
+                  _size)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+  ARBORX_ASSERT(_bucket_size >= 1 &&
+                _bucket_size <= Details::BucketedBVHImpl::max_bucket_size);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::BucketedBVH::BucketedBVH");
+
+  Kokkos::Profiling::pushRegion("ArborX::BucketedBVH::BucketedBVH::sort");
+  if (policy._primitives_sorted)
+  {
+    _indices = Kokkos::View<unsigned int *, MemorySpace>(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::BucketedBVH::indices"),
+        _size);
+    iota(space, _indices);
+  }
+  else
+    _indices = computeSpaceFillingCurvePermutation(space, primitives, curve);
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::Profiling::pushRegion(
+      "ArborX::BucketedBVH::BucketedBVH::fill_buckets");
+  Kokkos::View<BoundingVolume *, MemorySpace> bucket_volumes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BucketedBVH::bucket_volumes"),
+      (_size + _bucket_size - 1) / _bucket_size);
+  Details::BucketedBVHImpl::fillBuckets(space, primitives, _indices,
+                                        _bucket_size, _indexables,
+                                        bucket_volumes);
+  Kokkos::Profiling::popRegion();
+
+  // The buckets follow the curve already
+  _buckets = buckets_type(space, bucket_volumes, curve,
+                          ConstructionPolicy(policy).setPrimitivesSorted(true));
+}
+
+template <typename MemorySpace, typename BoundingVolume, typename Indexable>
+template <typename ExecutionSpace, typename Predicates, typename Callback,
+          typename Ignore>
+void BucketedBoundingVolumeHierarchy<MemorySpace, BoundingVolume, Indexable>::
+    query(ExecutionSpace const &space, Predicates const &predicates,
+          Callback const &callback, Ignore) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{},
+                "nearest query not implemented yet");
+  using Value = int;
+  Details::check_valid_callback<Value>(callback, predicates);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::BucketedBVH::query::spatial");
+
+  _buckets.query(space, predicates,
+                 Details::BucketCallback<Callback, decltype(_indexables),
+                                         decltype(_indices)>{
+                     callback, _indexables, _indices, _bucket_size});
+}
+
+} // namespace ArborX::Experimental
+
+#endif
@@ -0,0 +1,313 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_CACHED_TREE_HPP
+#define ARBORX_CACHED_TREE_HPP
+
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp> // lastElement
+#include <ArborX_DetailsUtils.hpp>                // exclusivePrefixSum
+#include <ArborX_Exception.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ArborX
+{
+namespace Details
+{
+// FNV-1a hash of the bytes of the object
+template <typename T>
+KOKKOS_FUNCTION std::uint64_t hashBytes(T const &x)
+{
+  auto const *bytes = reinterpret_cast<unsigned char const *>(&x);
+  std::uint64_t hash = 14695981039346656037ull;
+  for (int i = 0; i < (int)sizeof(T); ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+template <typename T>
+KOKKOS_FUNCTION bool equalBytes(T const &x, T const &y)
+{
+  auto const *x_bytes = reinterpret_cast<unsigned char const *>(&x);
+  auto const *y_bytes = reinterpret_cast<unsigned char const *>(&y);
+  for (int i = 0; i < (int)sizeof(T); ++i)
+    if (x_bytes[i] != y_bytes[i])
+      return false;
+  return true;
+}
+} // namespace Details
+
+namespace Experimental
+{
+
+/** \brief Tree with a cache of the results of the predicates queried before
+ *
+ *  The results of the predicates are kept in a cache in the memory space of
+ *  the tree and looked up on the device before the traversal, which only
+ *  searches the predicates that missed. The cache is split into sets of
+ *  \c associativity entries, a predicate being cached in the set given by
+ *  the hash of its bytes and replacing the least recently used entry of the
+ *  set. Predicates are compared byte by byte, so that they must not hold
+ *  padding, and equal predicates get the same results as their traversal.
+ *  Only the predicates with at most \c max_results_per_entry results are
+ *  cached. The cache is cleared when the tree is replaced or refitted.
+ */
+template <typename Tree, typename Predicate, typename Value = int>
+class CachedTree
+{
+public:
+  using memory_space = typename Tree::memory_space;
+  using size_type = typename Tree::size_type;
+  using bounding_volume_type = typename Tree::bounding_volume_type;
+
+  static constexpr int associativity = 4;
+
+  CachedTree() = default;
+
+  template <typename ExecutionSpace>
+  CachedTree(ExecutionSpace const &space, Tree const &tree, int capacity,
+             int max_results_per_entry);
+
+  Tree const &tree() const noexcept { return _tree; }
+
+  size_type size() const noexcept { return _tree.size(); }
+
+  bool empty() const noexcept { return _tree.empty(); }
+
+  bounding_volume_type bounds() const noexcept { return _tree.bounds(); }
+
+  // Number of predicates found in the cache by the last query
+  int numHits() const noexcept { return _num_hits; }
+
+  // Replace the tree, e.g. rebuilt over new primitives
+  template <typename ExecutionSpace>
+  void update(ExecutionSpace const &space, Tree const &tree)
+  {
+    _tree = tree;
+    clear(space);
+  }
+
+  template <typename ExecutionSpace, typename Primitives>
+  auto refit(ExecutionSpace const &space, Primitives const &primitives)
+  {
+    clear(space);
+    return _tree.refit(space, primitives);
+  }
+
+  template <typename ExecutionSpace>
+  void clear(ExecutionSpace const &space)
+  {
+    Kokkos::deep_copy(space, _counts, -1);
+    Kokkos::deep_copy(space, _stamps, 0);
+    _clock = 0;
+  }
+
+  // Values found by each predicate, in CRS format
+  template <typename ExecutionSpace, typename Predicates, typename Values,
+            typename Offsets>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Values &values, Offsets &offsets);
+
+private:
+  Tree _tree;
+  int _max_results_per_entry = 0;
+  Kokkos::View<Predicate *, memory_space> _predicates;
+  // Number of results of each entry, negative if empty
+  Kokkos::View<int *, memory_space> _counts;
+  // Last query that used each entry
+  Kokkos::View<unsigned int *, memory_space> _stamps;
+  Kokkos::View<Value *, memory_space> _results;
+  unsigned int _clock = 0;
+  int _num_hits = 0;
+};
+
+template <typename Tree, typename Predicate, typename Value>
+template <typename ExecutionSpace>
+CachedTree<Tree, Predicate, Value>::CachedTree(ExecutionSpace const &space,
+                                               Tree const &tree, int capacity,
+                                               int max_results_per_entry)
+    : _tree(tree)
+    , _max_results_per_entry(max_results_per_entry)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<memory_space, ExecutionSpace>::value);
+  static_assert(std::is_trivially_copyable_v<Predicate>);
+  ARBORX_ASSERT(capacity > 0 && max_results_per_entry >= 0);
+
+  // Whole sets only
+  int const num_entries =
+      (capacity + associativity - 1) / associativity * associativity;
+  _predicates = Kokkos::View<Predicate *, memory_space>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CachedTree::predicates"),
+      num_entries);
+  _counts = Kokkos::View<int *, memory_space>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CachedTree::counts"),
+      num_entries);
+  _stamps = Kokkos::View<unsigned int *, memory_space>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CachedTree::stamps"),
+      num_entries);
+  _results = Kokkos::View<Value *, memory_space>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CachedTree::results"),
+      (std::size_t)num_entries * max_results_per_entry);
+  clear(space);
+}
+
+template <typename Tree, typename Predicate, typename Value>
+template <typename ExecutionSpace, typename Predicates, typename Values,
+          typename Offsets>
+void CachedTree<Tree, Predicate, Value>::query(ExecutionSpace const &space,
+                                               Predicates const &predicates,
+                                               Values &values,
+                                               Offsets &offsets)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<memory_space, ExecutionSpace>::value);
+  static_assert(Kokkos::is_view_v<Predicates> && Predicates::rank == 1);
+  static_assert(
+      std::is_same_v<typename Predicates::non_const_value_type, Predicate>,
+      "The predicates must be those of the cache");
+  static_assert(std::is_same_v<typename Values::non_const_value_type, Value>,
+                "The values must be those of the cache");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::CachedTree::query");
+
+  int const n = predicates.extent(0);
+  int const num_sets = _counts.extent(0) / associativity;
+  unsigned int const clock = ++_clock;
+  auto const &cached_predicates = _predicates;
+  auto const &counts = _counts;
+  auto const &stamps = _stamps;
+  auto const &results = _results;
+  int const max_results = _max_results_per_entry;
+
+  // Entry of each predicate, or its position among the predicates that
+  // missed, counted from -1 down
+  Kokkos::View<int *, memory_space> entries(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CachedTree::entries"),
+      n);
+  int num_misses = 0;
+  Kokkos::parallel_scan(
+      "ArborX::CachedTree::look_up",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, int &update, bool final) {
+        auto const &predicate = predicates(i);
+        int const set = Details::hashBytes(predicate) % num_sets;
+        int entry = -1;
+        for (int e = set * associativity; e < (set + 1) * associativity; ++e)
+          if (counts(e) >= 0 &&
+              Details::equalBytes(cached_predicates(e), predicate))
+            entry = e;
+        if (entry < 0)
+        {
+          if (final)
+            entries(i) = -1 - update;
+          ++update;
+        }
+        else if (final)
+        {
+          entries(i) = entry;
+          stamps(entry) = clock;
+        }
+      },
+      num_misses);
+  _num_hits = n - num_misses;
+
+  Kokkos::View<Predicate *, memory_space> missed_predicates(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CachedTree::missed_predicates"),
+      num_misses);
+  Kokkos::parallel_for(
+      "ArborX::CachedTree::gather_missed_predicates",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        if (entries(i) < 0)
+          missed_predicates(-1 - entries(i)) = predicates(i);
+      });
+  Kokkos::View<Value *, memory_space> missed_values(
+      "ArborX::CachedTree::missed_values", 0);
+  Kokkos::View<int *, memory_space> missed_offsets(
+      "ArborX::CachedTree::missed_offsets", 0);
+  ArborX::query(_tree, space, missed_predicates, missed_values,
+                missed_offsets);
+
+  KokkosExt::reallocWithoutInitializing(space, offsets, n + 1);
+  Kokkos::parallel_for(
+      "ArborX::CachedTree::count_results",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        int const entry = entries(i);
+        offsets(i) = (entry >= 0 ? counts(entry)
+                                 : missed_offsets(-entry) -
+                                       missed_offsets(-1 - entry));
+      });
+  exclusivePrefixSum(space, offsets);
+  KokkosExt::reallocWithoutInitializing(
+      space, values, KokkosExt::lastElement(space, offsets));
+  Kokkos::parallel_for(
+      "ArborX::CachedTree::copy_results",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        int const entry = entries(i);
+        int const begin = offsets(i);
+        int const count = offsets(i + 1) - begin;
+        if (entry >= 0)
+          for (int j = 0; j < count; ++j)
+            values(begin + j) = results(entry * max_results + j);
+        else
+          for (int j = 0; j < count; ++j)
+            values(begin + j) = missed_values(missed_offsets(-1 - entry) + j);
+      });
+
+  // Each missed predicate replaces the least recently used entry of its set,
+  // unless used by this query. The entries are claimed through their stamps,
+  // so that the predicates of the same set do not replace the same entry.
+  Kokkos::parallel_for(
+      "ArborX::CachedTree::insert",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_misses),
+      KOKKOS_LAMBDA(int m) {
+        int const count = missed_offsets(m + 1) - missed_offsets(m);
+        if (count > max_results)
+          return;
+        auto const &predicate = missed_predicates(m);
+        int const set = Details::hashBytes(predicate) % num_sets;
+        int victim = set * associativity;
+        for (int e = victim + 1; e < (set + 1) * associativity; ++e)
+          if (stamps(e) < stamps(victim))
+            victim = e;
+        unsigned int const stamp = stamps(victim);
+        if (stamp == clock ||
+            Kokkos::atomic_compare_exchange(&stamps(victim), stamp, clock) !=
+                stamp)
+          return;
+        cached_predicates(victim) = predicate;
+        for (int j = 0; j < count; ++j)
+          results(victim * max_results + j) =
+              missed_values(missed_offsets(m) + j);
+        counts(victim) = count;
+      });
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
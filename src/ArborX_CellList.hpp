@@ -0,0 +1,262 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_CELL_LIST_HPP
+#define ARBORX_CELL_LIST_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // expand
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsSortUtils.hpp> // sortObjects
+#include <ArborX_DetailsUtils.hpp>     // exclusivePrefixSum
+#include <ArborX_Exception.hpp>
+#include <ArborX_Point.hpp>
+#include <ArborX_Predicates.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace ArborX::Experimental
+{
+
+// Index of points binned in the cells of a uniform grid, for fixed-radius
+// searches over nearly uniform densities, e.g. with the cell size set to the
+// search radius. The points are sorted by cell and each spatial predicate
+// only checks the points of the cells overlapping the bounding box of its
+// geometry, typically intersects(Sphere). All the cells covering the bounds
+// of the points are stored, so that sparse or clustered points are better
+// served by a bounding volume hierarchy. Callbacks are given the indices of
+// the points. Only spatial queries are supported.
+template <typename MemorySpace>
+class CellList
+{
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using size_type = typename MemorySpace::size_type;
+  using bounding_volume_type = Box;
+
+  CellList() = default; // build an empty index
+
+  template <typename ExecutionSpace, typename Points>
+  CellList(ExecutionSpace const &space, Points const &points, float cell_size);
+
+  KOKKOS_FUNCTION
+  size_type size() const noexcept { return _points.extent(0); }
+
+  KOKKOS_FUNCTION
+  bool empty() const noexcept { return size() == 0; }
+
+  KOKKOS_FUNCTION
+  bounding_volume_type bounds() const noexcept { return _bounds; }
+
+  float cellSize() const noexcept { return _cell_size; }
+
+  // Number of cells along dimension d
+  int extent(int d) const noexcept { return _extents[d]; }
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback,
+             TraversalPolicy const &policy = TraversalPolicy()) const;
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+
+private:
+  // Coordinate along dimension d of the cell containing x, clamped to the
+  // grid
+  KOKKOS_FUNCTION static int cellCoordinate(float x, float min_corner,
+                                            float cell_size, int extent)
+  {
+    float const coordinate = Kokkos::floor((x - min_corner) / cell_size);
+    return KokkosExt::min(KokkosExt::max(coordinate, 0.f), extent - 1.f);
+  }
+
+  float _cell_size = 1;
+  Box _bounds;
+  Kokkos::Array<int, 3> _extents = {0, 0, 0};
+  // Points sorted by cell, and their original indices
+  Kokkos::View<Point *, MemorySpace> _points;
+  Kokkos::View<unsigned *, MemorySpace> _permutation;
+  // Offsets of the points of each cell, including the empty ones
+  Kokkos::View<int *, MemorySpace> _cell_offsets;
+};
+
+template <typename MemorySpace>
+template <typename ExecutionSpace, typename Points>
+CellList<MemorySpace>::CellList(ExecutionSpace const &space,
+                                Points const &points, float cell_size)
+    : _cell_size(cell_size)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, points);
+  using Access = AccessTraits<Points, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Points must be accessible from the execution space");
+  static_assert(
+      std::is_same_v<typename Details::AccessTraitsHelper<Access>::type,
+                     Point>,
+      "Cell lists are built for points");
+  ARBORX_ASSERT(cell_size > 0);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::CellList::CellList");
+
+  int const n = Access::size(points);
+  if (n == 0)
+    return;
+
+  Kokkos::parallel_reduce(
+      "ArborX::CellList::CellList::calculate_bounds",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, Box &update) { update += Access::get(points, i); },
+      Kokkos::Sum<Box>{_bounds});
+
+  long long num_cells = 1;
+  for (int d = 0; d < 3; ++d)
+  {
+    auto const delta = _bounds.maxCorner()[d] - _bounds.minCorner()[d];
+    _extents[d] = KokkosExt::max((int)std::ceil(delta / cell_size), 1);
+    num_cells *= _extents[d];
+  }
+  // The offsets of the cells must be addressable
+  ARBORX_ASSERT(num_cells < std::numeric_limits<int>::max());
+
+  Kokkos::Profiling::pushRegion("ArborX::CellList::CellList::sort");
+
+  auto const min_corner = _bounds.minCorner();
+  auto const extents = _extents;
+  Kokkos::View<int *, MemorySpace> cell_indices(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CellList::cell_indices"),
+      n);
+  _cell_offsets = Kokkos::View<int *, MemorySpace>(
+      Kokkos::view_alloc(space, "ArborX::CellList::cell_offsets"),
+      num_cells + 1);
+  auto const &cell_offsets = _cell_offsets;
+  Kokkos::parallel_for(
+      "ArborX::CellList::CellList::compute_cell_indices",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        auto const &point = Access::get(points, i);
+        int cell = 0;
+        for (int d = 2; d >= 0; --d)
+          cell = cell * extents[d] + cellCoordinate(point[d], min_corner[d],
+                                                    cell_size, extents[d]);
+        cell_indices(i) = cell;
+        Kokkos::atomic_increment(&cell_offsets(cell));
+      });
+  exclusivePrefixSum(space, cell_offsets);
+
+  _permutation = Details::sortObjects(space, cell_indices);
+  _points = Kokkos::View<Point *, MemorySpace>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CellList::points"),
+      n);
+  auto const &sorted_points = _points;
+  auto const &permutation = _permutation;
+  Kokkos::parallel_for(
+      "ArborX::CellList::CellList::permute_points",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        sorted_points(i) = Access::get(points, permutation(i));
+      });
+
+  Kokkos::Profiling::popRegion();
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace, typename Predicates, typename Callback>
+void CellList<MemorySpace>::query(ExecutionSpace const &space,
+                                  Predicates const &predicates,
+                                  Callback const &callback,
+                                  TraversalPolicy const &) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{},
+                "nearest query not implemented yet");
+  using Value = int;
+  Details::check_valid_callback<Value>(callback, predicates);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::CellList::query::spatial");
+
+  if (empty())
+    return;
+
+  auto const bounds = _bounds;
+  auto const cell_size = _cell_size;
+  auto const extents = _extents;
+  auto const &points = _points;
+  auto const &permutation = _permutation;
+  auto const &cell_offsets = _cell_offsets;
+  Kokkos::parallel_for(
+      "ArborX::CellList::query::spatial",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, Access::size(predicates)),
+      KOKKOS_LAMBDA(int q) {
+        using Details::expand;
+        using Details::intersects;
+        auto const &predicate = Access::get(predicates, q);
+        Box box{};
+        expand(box, getGeometry(predicate));
+        if (!intersects(box, bounds))
+          return;
+
+        auto const &min_corner = bounds.minCorner();
+        int first[3];
+        int last[3];
+        for (int d = 0; d < 3; ++d)
+        {
+          first[d] = cellCoordinate(box.minCorner()[d], min_corner[d],
+                                    cell_size, extents[d]);
+          last[d] = cellCoordinate(box.maxCorner()[d], min_corner[d],
+                                   cell_size, extents[d]);
+        }
+        for (int k = first[2]; k <= last[2]; ++k)
+          for (int j = first[1]; j <= last[1]; ++j)
+          {
+            // The cells along the first dimension are contiguous
+            int const row = (k * extents[1] + j) * extents[0];
+            for (int i = cell_offsets(row + first[0]);
+                 i < cell_offsets(row + last[0] + 1); ++i)
+              if (predicate(points(i)) &&
+                  Details::invoke_callback_and_check_early_exit(
+                      callback, predicate, (int)permutation(i)))
+                return;
+          }
+      });
+}
+
+} // namespace ArborX::Experimental
+
+#endif
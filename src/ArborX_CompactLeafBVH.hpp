@@ -0,0 +1,210 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_COMPACT_LEAF_BVH_HPP
+#define ARBORX_COMPACT_LEAF_BVH_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsNode.hpp> // PairIndexVolume
+#include <ArborX_IndexableGetter.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_SpaceFillingCurves.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace ArborX
+{
+namespace Details
+{
+// Indexables of the values, from which the leaves pair each one with the
+// index of its value
+template <typename Values, typename IndexableGetter>
+struct ValueIndexables
+{
+  Values _values;
+  IndexableGetter _indexable_getter;
+};
+
+// Calls the user callback with the value of the leaf found, read from the
+// values stored in the order of the leaves
+template <typename Callback, typename Values>
+struct CompactLeafCallbackWrapper
+{
+  Callback _callback;
+  Values _values;
+
+  template <typename Predicate, typename Leaf>
+  KOKKOS_FUNCTION auto operator()(Predicate const &predicate,
+                                  Leaf const &leaf) const
+  {
+    return _callback(predicate, _values(leaf.index));
+  }
+};
+} // namespace Details
+
+template <typename Values, typename IndexableGetter>
+struct AccessTraits<Details::ValueIndexables<Values, IndexableGetter>,
+                    PrimitivesTag>
+{
+  using Self = Details::ValueIndexables<Values, IndexableGetter>;
+
+  using memory_space = typename Values::memory_space;
+  static KOKKOS_FUNCTION auto size(Self const &x) { return x._values.size(); }
+  static KOKKOS_FUNCTION decltype(auto) get(Self const &x, int i)
+  {
+    return x._indexable_getter(x._values(i));
+  }
+};
+
+namespace Experimental
+{
+
+/** \brief Bounding volume hierarchy whose leaves only hold the indexables of
+ *  large values
+ *
+ *  Same as BasicBoundingVolumeHierarchy, but each leaf stores the indexable
+ *  of its value, computed once at construction, next to the position of the
+ *  value in a separate array. The leaf tests read the indexables only, and
+ *  the values, stored in the order of the leaves, are read when the callback
+ *  is called. This shrinks the leaves of values much larger than their
+ *  indexables, e.g. particles carrying many fields, at the cost of storing
+ *  the indexables twice.
+ */
+template <typename MemorySpace, typename Value,
+          typename IndexableGetter = Details::DefaultIndexableGetter>
+class CompactLeafBVH
+{
+  using indexable_type = std::decay_t<decltype(std::declval<IndexableGetter>()(
+      std::declval<Value>()))>;
+  using tree_type =
+      BasicBoundingVolumeHierarchy<MemorySpace,
+                                   Details::PairIndexVolume<indexable_type>>;
+
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using size_type = typename tree_type::size_type;
+  using bounding_volume_type = typename tree_type::bounding_volume_type;
+  using value_type = Value;
+
+  CompactLeafBVH() = default; // build an empty tree
+
+  template <typename ExecutionSpace, typename Values,
+            typename SpaceFillingCurve = Morton64>
+  CompactLeafBVH(ExecutionSpace const &space, Values const &values,
+                 IndexableGetter const &indexable_getter = IndexableGetter(),
+                 SpaceFillingCurve const &curve = SpaceFillingCurve(),
+                 ConstructionPolicy const &policy = ConstructionPolicy());
+
+  KOKKOS_FUNCTION
+  size_type size() const noexcept { return _tree.size(); }
+
+  KOKKOS_FUNCTION
+  bool empty() const noexcept { return _tree.empty(); }
+
+  KOKKOS_FUNCTION
+  bounding_volume_type bounds() const noexcept { return _tree.bounds(); }
+
+  // Values in the order of the leaves
+  Kokkos::View<Value *, MemorySpace> const &values() const noexcept
+  {
+    return _values;
+  }
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback,
+             TraversalPolicy const &policy = TraversalPolicy()) const
+  {
+    static_assert(!Details::is_tagged_team_callback<Callback>{},
+                  "Team callbacks are not supported");
+    Details::check_valid_callback<Value>(callback, predicates);
+
+    KokkosExt::ScopedProfileRegion guard("ArborX::CompactLeafBVH::query");
+
+    _tree.query(space, predicates,
+                Details::CompactLeafCallbackWrapper<Callback,
+                                                    decltype(_values)>{
+                    callback, _values},
+                policy);
+  }
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+
+private:
+  tree_type _tree;
+  Kokkos::View<Value *, MemorySpace> _values;
+};
+
+template <typename MemorySpace, typename Value, typename IndexableGetter>
+template <typename ExecutionSpace, typename Values, typename SpaceFillingCurve>
+CompactLeafBVH<MemorySpace, Value, IndexableGetter>::CompactLeafBVH(
+    ExecutionSpace const &space, Values const &values,
+    IndexableGetter const &indexable_getter, SpaceFillingCurve const &curve,
+    ConstructionPolicy const &policy)
+    : _tree(space,
+            Details::ValueIndexables<Values, IndexableGetter>{
+                values, indexable_getter},
+            curve, policy)
+    , _values(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                 "ArborX::CompactLeafBVH::values"),
+              values.size())
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  static_assert(Kokkos::is_view_v<Values> && Values::rank == 1);
+  static_assert(
+      std::is_same_v<typename Values::non_const_value_type, value_type>,
+      "The values must be those of the hierarchy");
+  static_assert(KokkosExt::is_accessible_from<typename Values::memory_space,
+                                              ExecutionSpace>::value,
+                "Values must be accessible from the execution space");
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::CompactLeafBVH::CompactLeafBVH");
+
+  // The leaves were paired with the indices of the values. Store the values
+  // in the order of the leaves, which then refer to their own positions, so
+  // that neighboring leaves read neighboring values.
+  auto const &leaf_nodes = Details::HappyTreeFriends::getLeafNodes(_tree);
+  auto const &permuted_values = _values;
+  Kokkos::parallel_for(
+      "ArborX::CompactLeafBVH::CompactLeafBVH::permute_values",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, size()),
+      KOKKOS_LAMBDA(int i) {
+        auto &leaf = leaf_nodes(i).value;
+        permuted_values(i) = values(leaf.index);
+        leaf.index = i;
+      });
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
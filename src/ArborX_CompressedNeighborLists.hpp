@@ -0,0 +1,391 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_COMPRESSED_NEIGHBOR_LISTS_HPP
+#define ARBORX_COMPRESSED_NEIGHBOR_LISTS_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp> // lastElement
+#include <ArborX_DetailsSortUtils.hpp>            // sortObjects
+#include <ArborX_DetailsUtils.hpp>                // exclusivePrefixSum
+#include <ArborX_Exception.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm> // min
+#include <cstddef>   // size_t
+#include <cstdint>
+#include <vector>
+
+namespace ArborX
+{
+namespace Details
+{
+// Variable-byte encoding, 7 bits per byte starting from the lowest ones, with
+// the highest bit set on all the bytes but the last
+KOKKOS_INLINE_FUNCTION int varintSize(unsigned x)
+{
+  int n = 1;
+  for (; x >= 0x80; x >>= 7)
+    ++n;
+  return n;
+}
+
+KOKKOS_INLINE_FUNCTION unsigned char *writeVarint(unsigned char *p, unsigned x)
+{
+  for (; x >= 0x80; x >>= 7)
+    *p++ = (unsigned char)(x | 0x80);
+  *p++ = (unsigned char)x;
+  return p;
+}
+
+// Predicates first to first + size of other predicates
+template <typename Predicates>
+struct PredicatesChunk
+{
+  Predicates _predicates;
+  int _first;
+  int _size;
+};
+} // namespace Details
+
+template <typename Predicates>
+struct AccessTraits<Details::PredicatesChunk<Predicates>, PredicatesTag>
+{
+  using Self = Details::PredicatesChunk<Predicates>;
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+
+  using memory_space = typename Access::memory_space;
+  static KOKKOS_FUNCTION int size(Self const &x) { return x._size; }
+  static KOKKOS_FUNCTION decltype(auto) get(Self const &x, int i)
+  {
+    return Access::get(x._predicates, x._first + i);
+  }
+};
+
+namespace Experimental
+{
+
+// Decodes the neighbors of a query, in increasing order
+//
+// \code
+// auto neighbors = lists.neighbors(i);
+// for (int j; neighbors.next(j);)
+//   ...
+// \endcode
+class CompressedNeighbors
+{
+public:
+  KOKKOS_FUNCTION
+  CompressedNeighbors(unsigned char const *first, unsigned char const *last)
+      : _current(first)
+      , _last(last)
+  {}
+
+  // Gives the next neighbor, unless all of them have been given
+  KOKKOS_FUNCTION bool next(int &index)
+  {
+    if (_current == _last)
+      return false;
+    unsigned delta = 0;
+    int shift = 0;
+    unsigned char byte;
+    do
+    {
+      byte = *_current++;
+      delta |= (unsigned)(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    _previous += delta;
+    index = _previous;
+    return true;
+  }
+
+private:
+  unsigned char const *_current;
+  unsigned char const *_last;
+  unsigned _previous = 0;
+};
+
+/** \brief Neighbor lists of queries stored compressed
+ *
+ *  The indices found for each query are sorted and stored as the
+ *  variable-byte encodings of their differences, the first one being the
+ *  difference to 0. Indices found close to each other, e.g. the neighbors
+ *  of a radius search in a hierarchy whose values are sorted along a
+ *  space-filling curve, take a byte each instead of four. The lists are
+ *  decoded on the device with neighbors(), or back to the CRS format with
+ *  decompress().
+ */
+template <typename MemorySpace>
+class CompressedNeighborLists
+{
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+
+  CompressedNeighborLists() = default;
+
+  // Compress the neighbor lists given in the CRS format, as returned by
+  // query(). The indices need not be sorted within each list.
+  template <typename ExecutionSpace, typename Offsets, typename Indices>
+  CompressedNeighborLists(ExecutionSpace const &space, Offsets const &offsets,
+                          Indices const &indices);
+
+  // Concatenate the lists of consecutive chunks of queries
+  template <typename ExecutionSpace>
+  static CompressedNeighborLists
+  concatenate(ExecutionSpace const &space,
+              std::vector<CompressedNeighborLists> const &chunks);
+
+  // Number of queries
+  KOKKOS_FUNCTION int size() const
+  {
+    return _offsets.size() > 0 ? (int)_offsets.size() - 1 : 0;
+  }
+
+  // Bytes taken by the lists
+  std::size_t memoryFootprint() const
+  {
+    return _bytes.size() + _offsets.size() * sizeof(std::size_t);
+  }
+
+  KOKKOS_FUNCTION CompressedNeighbors neighbors(int i) const
+  {
+    return {_bytes.data() + _offsets(i), _bytes.data() + _offsets(i + 1)};
+  }
+
+  // Decode the lists into the CRS format, sorted within each list
+  template <typename ExecutionSpace>
+  void decompress(ExecutionSpace const &space,
+                  Kokkos::View<int *, MemorySpace> &offsets,
+                  Kokkos::View<int *, MemorySpace> &indices) const;
+
+private:
+  Kokkos::View<std::size_t *, MemorySpace> _offsets;
+  Kokkos::View<unsigned char *, MemorySpace> _bytes;
+};
+
+template <typename MemorySpace>
+template <typename ExecutionSpace, typename Offsets, typename Indices>
+CompressedNeighborLists<MemorySpace>::CompressedNeighborLists(
+    ExecutionSpace const &space, Offsets const &offsets,
+    Indices const &indices)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  static_assert(Kokkos::is_view_v<Offsets> && Kokkos::is_view_v<Indices>);
+  static_assert(KokkosExt::is_accessible_from<typename Offsets::memory_space,
+                                              ExecutionSpace>::value &&
+                    KokkosExt::is_accessible_from<
+                        typename Indices::memory_space, ExecutionSpace>::value,
+                "The lists must be accessible from the execution space");
+  ARBORX_ASSERT(offsets.size() > 0);
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::CompressedNeighborLists::CompressedNeighborLists");
+
+  int const n = offsets.size() - 1;
+  int const n_indices = indices.size();
+
+  // Sort the indices of each list at once, keyed by the list first
+  Kokkos::View<std::uint64_t *, MemorySpace> keys(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CompressedNeighborLists::keys"),
+      n_indices);
+  Kokkos::parallel_for(
+      "ArborX::CompressedNeighborLists::make_keys",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        for (int j = offsets(i); j < offsets(i + 1); ++j)
+          keys(j) = ((std::uint64_t)i << 32) | (unsigned)indices(j);
+      });
+  Details::sortObjects(space, keys);
+
+  _offsets = Kokkos::View<std::size_t *, MemorySpace>(
+      Kokkos::view_alloc(space, "ArborX::CompressedNeighborLists::offsets"),
+      n + 1);
+  auto const &byte_offsets = _offsets;
+  Kokkos::parallel_for(
+      "ArborX::CompressedNeighborLists::count_bytes",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        unsigned previous = 0;
+        std::size_t count = 0;
+        for (int j = offsets(i); j < offsets(i + 1); ++j)
+        {
+          auto const index = (unsigned)keys(j);
+          count += Details::varintSize(index - previous);
+          previous = index;
+        }
+        byte_offsets(i) = count;
+      });
+  exclusivePrefixSum(space, _offsets);
+
+  _bytes = Kokkos::View<unsigned char *, MemorySpace>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CompressedNeighborLists::bytes"),
+      KokkosExt::lastElement(space, _offsets));
+  auto const &bytes = _bytes;
+  Kokkos::parallel_for(
+      "ArborX::CompressedNeighborLists::encode",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        unsigned previous = 0;
+        unsigned char *p = bytes.data() + byte_offsets(i);
+        for (int j = offsets(i); j < offsets(i + 1); ++j)
+        {
+          auto const index = (unsigned)keys(j);
+          p = Details::writeVarint(p, index - previous);
+          previous = index;
+        }
+      });
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+CompressedNeighborLists<MemorySpace>
+CompressedNeighborLists<MemorySpace>::concatenate(
+    ExecutionSpace const &space,
+    std::vector<CompressedNeighborLists> const &chunks)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::CompressedNeighborLists::concatenate");
+
+  int n = 0;
+  std::size_t n_bytes = 0;
+  for (auto const &chunk : chunks)
+  {
+    n += chunk.size();
+    n_bytes += chunk._bytes.size();
+  }
+
+  CompressedNeighborLists lists;
+  lists._offsets = Kokkos::View<std::size_t *, MemorySpace>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CompressedNeighborLists::offsets"),
+      n + 1);
+  lists._bytes = Kokkos::View<unsigned char *, MemorySpace>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::CompressedNeighborLists::bytes"),
+      n_bytes);
+  auto const &offsets = lists._offsets;
+  int first = 0;
+  std::size_t shift = 0;
+  for (auto const &chunk : chunks)
+  {
+    int const m = chunk.size();
+    if (m == 0)
+      continue;
+    Kokkos::deep_copy(
+        space,
+        Kokkos::subview(lists._bytes,
+                        Kokkos::make_pair(shift, shift + chunk._bytes.size())),
+        chunk._bytes);
+    auto const &chunk_offsets = chunk._offsets;
+    Kokkos::parallel_for(
+        "ArborX::CompressedNeighborLists::concatenate::shift_offsets",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, m), KOKKOS_LAMBDA(int i) {
+          offsets(first + i) = shift + chunk_offsets(i);
+        });
+    first += m;
+    shift += chunk._bytes.size();
+  }
+  Kokkos::deep_copy(space, Kokkos::subview(offsets, n), n_bytes);
+  return lists;
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+void CompressedNeighborLists<MemorySpace>::decompress(
+    ExecutionSpace const &space, Kokkos::View<int *, MemorySpace> &offsets,
+    Kokkos::View<int *, MemorySpace> &indices) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::CompressedNeighborLists::decompress");
+
+  int const n = size();
+  KokkosExt::reallocWithoutInitializing(space, offsets, n + 1);
+  Kokkos::deep_copy(space, offsets, 0);
+  auto const &bytes = _bytes;
+  auto const &byte_offsets = _offsets;
+  // Each index ends with the only one of its bytes whose highest bit is unset
+  Kokkos::parallel_for(
+      "ArborX::CompressedNeighborLists::decompress::count",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        int count = 0;
+        for (auto k = byte_offsets(i); k < byte_offsets(i + 1); ++k)
+          count += (bytes(k) & 0x80) ? 0 : 1;
+        offsets(i) = count;
+      });
+  exclusivePrefixSum(space, offsets);
+
+  KokkosExt::reallocWithoutInitializing(space, indices,
+                                        KokkosExt::lastElement(space, offsets));
+  auto const &lists = *this;
+  Kokkos::parallel_for(
+      "ArborX::CompressedNeighborLists::decompress::decode",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        auto neighbors = lists.neighbors(i);
+        int k = offsets(i);
+        for (int j; neighbors.next(j);)
+          indices(k++) = j;
+      });
+}
+
+/** Find the indices satisfying the predicates and store them compressed. The
+ * predicates are queried chunk by chunk, of at most chunk_size predicates,
+ * so that the results of one chunk only are stored uncompressed at any
+ * time.
+ */
+template <typename ExecutionSpace, typename Tree, typename Predicates>
+CompressedNeighborLists<typename Tree::memory_space>
+queryCompressed(ExecutionSpace const &space, Tree const &tree,
+                Predicates const &predicates, int chunk_size,
+                TraversalPolicy const &policy = TraversalPolicy())
+{
+  using MemorySpace = typename Tree::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  ARBORX_ASSERT(chunk_size > 0);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::Experimental::queryCompressed");
+
+  int const n = Access::size(predicates);
+  Kokkos::View<int *, MemorySpace> indices(
+      "ArborX::queryCompressed::indices", 0);
+  Kokkos::View<int *, MemorySpace> offsets(
+      "ArborX::queryCompressed::offsets", 0);
+  std::vector<CompressedNeighborLists<MemorySpace>> chunks;
+  for (int first = 0; first < n; first += chunk_size)
+  {
+    Details::PredicatesChunk<Predicates> chunk{
+        predicates, first, std::min(chunk_size, n - first)};
+    tree.query(space, chunk, indices, offsets, policy);
+    chunks.emplace_back(space, offsets, indices);
+  }
+  if (chunks.size() == 1)
+    return chunks.front();
+  return CompressedNeighborLists<MemorySpace>::concatenate(space, chunks);
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
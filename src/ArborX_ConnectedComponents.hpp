@@ -0,0 +1,147 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_CONNECTED_COMPONENTS_HPP
+#define ARBORX_CONNECTED_COMPONENTS_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsUnionFind.hpp>
+#include <ArborX_DetailsUtils.hpp> // iota
+#include <ArborX_Exception.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_Predicates.hpp>
+
+#include <Kokkos_Core.hpp>
+
+namespace ArborX
+{
+
+namespace Details
+{
+
+// Predicate i is searched for the neighbors of vertex i
+template <typename Predicates>
+struct PredicatesWithVertexIndices
+{
+  Predicates _predicates;
+};
+
+// Merge each vertex with the neighbors found by its predicate
+template <typename UnionFind>
+struct ConnectedComponentsCallback
+{
+  UnionFind _union_find;
+
+  template <typename Predicate, typename Value>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate,
+                                  Value const &value) const
+  {
+    _union_find.merge(getData(predicate), (int)value.index);
+  }
+};
+
+} // namespace Details
+
+template <typename Predicates>
+struct AccessTraits<Details::PredicatesWithVertexIndices<Predicates>,
+                    PredicatesTag>
+{
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using memory_space = typename Access::memory_space;
+  using size_type = typename memory_space::size_type;
+
+  static KOKKOS_FUNCTION size_type
+  size(Details::PredicatesWithVertexIndices<Predicates> const &x)
+  {
+    return Access::size(x._predicates);
+  }
+  static KOKKOS_FUNCTION auto
+  get(Details::PredicatesWithVertexIndices<Predicates> const &x, size_type i)
+  {
+    return attach(Access::get(x._predicates, i), (int)i);
+  }
+};
+
+namespace Experimental
+{
+
+// Connected components of the graph over the primitives in which primitive i
+// is connected to all the primitives satisfying predicate i (e.g., those
+// within a radius of it). The edges are merged into a union-find directly in
+// the traversal callback, so that the graph is never stored, unlike when
+// querying into indices and offsets first. Each component is labeled with
+// the smallest index of its primitives.
+template <typename ExecutionSpace, typename Primitives, typename Predicates>
+Kokkos::View<int *,
+             typename AccessTraits<Primitives, PrimitivesTag>::memory_space>
+connectedComponents(ExecutionSpace const &exec_space,
+                    Primitives const &primitives, Predicates const &predicates)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::ConnectedComponents");
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value,
+      "Primitives must be accessible from the execution space");
+
+  int const n = Access::size(primitives);
+  ARBORX_ASSERT((int)AccessTraits<Predicates, PredicatesTag>::size(
+                    predicates) == n);
+
+#ifdef KOKKOS_ENABLE_SERIAL
+  using UnionFind = Details::UnionFind<
+      MemorySpace,
+      /*DoSerial=*/std::is_same_v<ExecutionSpace, Kokkos::Serial>>;
+#else
+  using UnionFind = Details::UnionFind<MemorySpace>;
+#endif
+
+  constexpr int dim = GeometryTraits::dimension_v<
+      typename Details::AccessTraitsHelper<Access>::type>;
+  using Box = ExperimentalHyperGeometry::Box<dim>;
+
+  Kokkos::View<int *, MemorySpace> labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::ConnectedComponents::labels"),
+      n);
+  iota(exec_space, labels);
+
+  Kokkos::Profiling::pushRegion(
+      "ArborX::ConnectedComponents::tree_construction");
+  BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>> bvh(
+      exec_space, primitives);
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::Profiling::pushRegion("ArborX::ConnectedComponents::query");
+  bvh.query(exec_space,
+            Details::PredicatesWithVertexIndices<Predicates>{predicates},
+            Details::ConnectedComponentsCallback<UnionFind>{labels});
+  Kokkos::Profiling::popRegion();
+
+  UnionFind union_find(labels);
+  Kokkos::parallel_for(
+      "ArborX::ConnectedComponents::finalize_labels",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) { labels(i) = union_find.representative(i); });
+
+  return labels;
+}
+
+} // namespace Experimental
+
+} // namespace ArborX
+
+#endif
@@ -14,15 +14,30 @@
 
 #include <ArborX_AccessTraits.hpp>
 #include <ArborX_DetailsCartesianGrid.hpp>
+#include <ArborX_DetailsExplicitInstantiation.hpp>
 #include <ArborX_DetailsFDBSCAN.hpp>
+#include <ArborX_DetailsFDBSCANCellStencil.hpp>
 #include <ArborX_DetailsFDBSCANDenseBox.hpp>
 #include <ArborX_DetailsHalfTraversal.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
 #include <ArborX_DetailsSortUtils.hpp>
+#include <ArborX_DetailsSparseCartesianGrid.hpp>
+#include <ArborX_DimensionDispatch.hpp>
+#include <ArborX_Exception.hpp>
 #include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
 #include <ArborX_HyperSphere.hpp>
 #include <ArborX_LinearBVH.hpp>
+#include <ArborX_NeighborList.hpp>
+#include <ArborX_PhaseTimings.hpp>
 #include <ArborX_Sphere.hpp>
 
+#include <algorithm> // max
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
 namespace ArborX
 {
 
@@ -49,6 +64,93 @@ struct DBSCANCorePoints
   }
 };
 
+// Only for marking noise in the minpts = 2 case, where the isolated points
+// are the noise points.
+struct CCSNoCorePoints
+{
+  KOKKOS_FUNCTION bool operator()(int) const { return false; }
+};
+
+// Call callback(i, j) for all the pairs of points within eps of each other
+// stored in the half neighbor list given by (offsets, indices)
+template <typename ExecutionSpace, typename Primitives, typename Offsets,
+          typename Indices, typename Callback>
+void forEachPairWithinRadius(ExecutionSpace const &exec_space,
+                             Primitives const &primitives,
+                             Offsets const &offsets, Indices const &indices,
+                             float eps, Callback const &callback)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::for_each_pair_within_radius",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0,
+                                          Access::size(primitives)),
+      KOKKOS_LAMBDA(int i) {
+        auto const &point_i = Access::get(primitives, i);
+        for (int k = offsets(i); k < offsets(i + 1); ++k)
+        {
+          int const j = indices(k);
+          if (distance(point_i, Access::get(primitives, j)) <= eps)
+            callback(i, j);
+        }
+      });
+}
+
+struct NoClusterAccumulation
+{
+  KOKKOS_FUNCTION void operator()(int, int) const {}
+};
+
+// Make all labels point directly to the representative of their cluster, and
+// mark as noise (-1) the points that are alone in their cluster and are not
+// core points. The accumulator is called with each point and the
+// representative of its cluster, before the noise is marked. Returns the size
+// of the cluster of each representative.
+template <typename ExecutionSpace, typename Labels, typename CorePoints,
+          typename Accumulator = NoClusterAccumulation>
+auto finalizeLabels(ExecutionSpace const &exec_space, Labels const &labels,
+                    CorePoints const &is_core,
+                    Accumulator const &accumulate = Accumulator{})
+{
+  using MemorySpace = typename Labels::memory_space;
+  int const n = labels.size();
+
+  // Per [1]:
+  //
+  // ```
+  // The finalization kernel will, ultimately, make all parents
+  // point directly to the representative.
+  // ```
+  Kokkos::View<int *, MemorySpace> cluster_sizes(
+      Kokkos::view_alloc(exec_space, "ArborX::DBSCAN::cluster_sizes"), n);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::finalize_labels",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int const i) {
+        // ##### ECL license (see LICENSE.ECL) #####
+        int next;
+        int vstat = labels(i);
+        int const old = vstat;
+        while (vstat > (next = labels(vstat)))
+        {
+          vstat = next;
+        }
+        if (vstat != old)
+          labels(i) = vstat;
+
+        Kokkos::atomic_increment(&cluster_sizes(labels(i)));
+        accumulate(i, labels(i));
+      });
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::mark_noise",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int const i) {
+        if (cluster_sizes(labels(i)) == 1 && !is_core(i))
+          labels(i) = -1;
+      });
+  return cluster_sizes;
+}
+
 template <typename Primitives>
 struct PrimitivesWithRadius
 {
@@ -84,18 +186,20 @@ struct PrimitivesWithRadiusReorderedAndFiltered
 
 // Mixed primitives consist of a set of boxes corresponding to dense cells,
 // followed by boxes corresponding to points in non-dense cells.
-template <typename PointPrimitives, typename DenseCellOffsets,
+template <typename PointPrimitives, typename Grid, typename DenseCellOffsets,
           typename CellIndices, typename Permutation>
 struct MixedBoxPrimitives
 {
   PointPrimitives _point_primitives;
-  CartesianGrid<GeometryTraits::dimension_v<typename AccessTraitsHelper<
-      AccessTraits<PointPrimitives, PrimitivesTag>>::type>>
-      _grid;
+  Grid _grid;
   DenseCellOffsets _dense_cell_offsets;
   int _num_points_in_dense_cells; // to avoid lastElement() in AccessTraits
   CellIndices _sorted_cell_indices;
   Permutation _permute;
+  // Grid of the dense cells with indices starting at
+  // _shifted_cell_indices_offset
+  Grid _shifted_grid;
+  size_t _shifted_cell_indices_offset;
 };
 
 } // namespace Details
@@ -159,14 +263,16 @@ struct AccessTraits<Details::PrimitivesWithRadiusReorderedAndFiltered<
   }
 };
 
-template <typename PointPrimitives, typename MixedOffsets, typename CellIndices,
-          typename Permutation>
-struct AccessTraits<Details::MixedBoxPrimitives<PointPrimitives, MixedOffsets,
-                                                CellIndices, Permutation>,
+template <typename PointPrimitives, typename Grid, typename MixedOffsets,
+          typename CellIndices, typename Permutation>
+struct AccessTraits<Details::MixedBoxPrimitives<PointPrimitives, Grid,
+                                                MixedOffsets, CellIndices,
+                                                Permutation>,
                     ArborX::PrimitivesTag>
 {
-  using Primitives = Details::MixedBoxPrimitives<PointPrimitives, MixedOffsets,
-                                                 CellIndices, Permutation>;
+  using Primitives =
+      Details::MixedBoxPrimitives<PointPrimitives, Grid, MixedOffsets,
+                                  CellIndices, Permutation>;
   static KOKKOS_FUNCTION std::size_t size(Primitives const &w)
   {
     auto const &dco = w._dense_cell_offsets;
@@ -188,6 +294,9 @@ struct AccessTraits<Details::MixedBoxPrimitives<PointPrimitives, MixedOffsets,
       // It may not be tight around the points inside, but is cheap to
       // compute.
       auto cell_index = w._sorted_cell_indices(dco(i));
+      if (cell_index >= w._shifted_cell_indices_offset)
+        return w._shifted_grid.cellBox(cell_index -
+                                       w._shifted_cell_indices_offset);
       return w._grid.cellBox(cell_index);
     }
 
@@ -210,43 +319,396 @@ struct AccessTraits<Details::MixedBoxPrimitives<PointPrimitives, MixedOffsets,
   using memory_space = typename MixedOffsets::memory_space;
 };
 
+namespace Details
+{
+
+// Number of cells of a Cartesian grid with cell length h covering the bounds,
+// computed in floating point to detect an overflow of the cell indices
+template <typename Box>
+double numCells(Box const &bounds, float h)
+{
+  double num_cells = 1;
+  for (int d = 0; d < GeometryTraits::dimension_v<Box>; ++d)
+    num_cells *= std::max(
+        std::ceil((bounds.maxCorner()[d] - bounds.minCorner()[d]) / h), 1.f);
+  return num_cells;
+}
+
+// Find the dense cells of the grid (and, optionally, of a grid shifted by half
+// a cell), merge the points within each dense cell, and build the hierarchy
+// over the mixed primitives. Returns the number of points in dense cells.
+template <typename ExecutionSpace, typename Primitives, typename Grid,
+          typename ShiftedGridFactory, typename UnionFind, typename BVH,
+          typename MemorySpace>
+int buildDenseBoxHierarchy(
+    ExecutionSpace const &exec_space, Primitives const &primitives,
+    int core_min_size, Grid const &grid, float h,
+    ExperimentalHyperGeometry::Box<Grid::dim> const &bounds,
+    ShiftedGridFactory const &make_shifted_grid, bool shifted_dense_cells,
+    bool verbose, Experimental::PhaseTimings *timings,
+    UnionFind const &union_find, BVH &bvh,
+    Kokkos::View<int *, MemorySpace> &dense_cell_offsets,
+    Kokkos::View<unsigned int *, MemorySpace> &permute)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  constexpr int dim = Grid::dim;
+
+  int const n = Access::size(primitives);
+
+  auto cell_indices = computeCellIndices(exec_space, primitives, grid);
+
+  permute = sortObjects(exec_space, cell_indices);
+  auto &sorted_cell_indices = cell_indices; // alias
+
+  int num_nonempty_cells;
+  int num_points_in_dense_cells;
+  {
+    // Reorder indices and permutation so that the dense cells go first
+    Kokkos::View<int *, MemorySpace> cell_offsets(
+        "ArborX::DBSCAN::cell_offsets", 0);
+    computeOffsetsInOrderedView(exec_space, sorted_cell_indices, cell_offsets);
+    num_nonempty_cells = cell_offsets.size() - 1;
+
+    num_points_in_dense_cells = reorderDenseAndSparseCells(
+        exec_space, cell_offsets, core_min_size, sorted_cell_indices, permute);
+  }
+  // The cells of the shifted grid, if any, have indices starting at
+  // shifted_cell_indices_offset
+  auto shifted_grid = grid;
+  size_t shifted_cell_indices_offset = std::numeric_limits<size_t>::max();
+  int num_points_in_shifted_dense_cells = 0;
+  if (shifted_dense_cells && num_points_in_dense_cells < n)
+  {
+    // The shifted grid covers the scene with half a cell of margin on each
+    // side. Its cell indices come after those of the first grid.
+    auto shifted_bounds = bounds;
+    for (int d = 0; d < dim; ++d)
+    {
+      shifted_bounds.minCorner()[d] -= h / 2;
+      shifted_bounds.maxCorner()[d] += h / 2;
+    }
+    shifted_grid = make_shifted_grid(shifted_bounds);
+
+    ARBORX_ASSERT(shifted_grid.size() <
+                  std::numeric_limits<size_t>::max() - grid.size());
+    shifted_cell_indices_offset = grid.size();
+
+    num_points_in_shifted_dense_cells = reorderShiftedDenseCells(
+        exec_space, primitives, shifted_grid, shifted_cell_indices_offset,
+        core_min_size, num_points_in_dense_cells, sorted_cell_indices,
+        permute);
+    num_points_in_dense_cells += num_points_in_shifted_dense_cells;
+  }
+  int num_points_in_sparse_cells = n - num_points_in_dense_cells;
+
+  auto dense_sorted_cell_indices = Kokkos::subview(
+      sorted_cell_indices, Kokkos::make_pair(0, num_points_in_dense_cells));
+
+  computeOffsetsInOrderedView(exec_space, dense_sorted_cell_indices,
+                              dense_cell_offsets);
+  int num_dense_cells = dense_cell_offsets.size() - 1;
+  if (verbose)
+  {
+    printf("#nonempty cells     : %10d\n", num_nonempty_cells);
+    printf("#dense cells        : %10d [%.2f%%]\n", num_dense_cells,
+           (100.f * num_dense_cells) / num_nonempty_cells);
+    printf("#dense cell points  : %10d [%.2f%%]\n", num_points_in_dense_cells,
+           (100.f * num_points_in_dense_cells) / n);
+    if (shifted_dense_cells)
+      printf("#shifted cell points: %10d [%.2f%%]\n",
+             num_points_in_shifted_dense_cells,
+             (100.f * num_points_in_shifted_dense_cells) / n);
+    printf("#sparse cell points : %10d [%.2f%%]\n", num_points_in_sparse_cells,
+           (100.f * num_points_in_sparse_cells) / n);
+    printf("#mixed primitives   : %10d\n",
+           num_dense_cells + num_points_in_sparse_cells);
+  }
+
+  unionFindWithinEachDenseCell(exec_space, dense_sorted_cell_indices, permute,
+                               union_find);
+
+  popPhase(exec_space, timings);
+
+  // Build the tree. The bounds of the points are known already, so that the
+  // construction does not need to compute those of the mixed primitives.
+  pushPhase(exec_space, timings, "ArborX::DBSCAN::tree_construction");
+  bvh = BVH(exec_space,
+            MixedBoxPrimitives<Primitives, Grid,
+                               std::decay_t<decltype(dense_cell_offsets)>,
+                               decltype(cell_indices),
+                               std::decay_t<decltype(permute)>>{
+                primitives, grid, dense_cell_offsets, num_points_in_dense_cells,
+                sorted_cell_indices, permute, shifted_grid,
+                shifted_cell_indices_offset},
+            Experimental::ConstructionPolicy().setSceneBounds(bounds));
+  popPhase(exec_space, timings);
+
+  return num_points_in_dense_cells;
+}
+
+} // namespace Details
+
 namespace DBSCAN
 {
 
 enum class Implementation
 {
   FDBSCAN,
-  FDBSCAN_DenseBox
+  FDBSCAN_DenseBox,
+  // Neighbors searched through a fixed stencil of cells of the DenseBox grid
+  // instead of a bounding volume hierarchy (2D and 3D only)
+  FDBSCAN_CellStencil
 };
 
 struct Parameters
 {
   // Print timers to standard output
   bool _verbose = false;
-  // Algorithm implementation (FDBSCAN or FDBSCAN-DenseBox)
+  // Record the time of each phase, if given
+  Experimental::PhaseTimings *_timings = nullptr;
+  // Algorithm implementation (FDBSCAN, FDBSCAN-DenseBox or FDBSCAN with a
+  // cell stencil)
   Implementation _implementation = Implementation::FDBSCAN_DenseBox;
+  // Look for additional dense cells among the points in sparse cells, using a
+  // second grid shifted by half a cell (FDBSCAN-DenseBox only)
+  bool _shifted_dense_cells = false;
+  // Only assign core points to clusters (DBSCAN*), marking border points as
+  // noise. This skips the merging of border points.
+  bool _core_points_only = false;
+  // Flatten the union-find labels into cluster representatives and mark the
+  // noise points. Without it, the label of a point is its parent in the
+  // union-find forest, a cluster being identified by its root r with
+  // labels(r) == r, and noise points are the roots of singleton trees.
+  bool _finalize_labels = true;
 
   Parameters &setVerbosity(bool verbose)
   {
     _verbose = verbose;
     return *this;
   }
+  Parameters &setTimings(Experimental::PhaseTimings *timings)
+  {
+    _timings = timings;
+    return *this;
+  }
   Parameters &setImplementation(Implementation impl)
   {
     _implementation = impl;
     return *this;
   }
+  Parameters &setShiftedDenseCells(bool shifted_dense_cells)
+  {
+    _shifted_dense_cells = shifted_dense_cells;
+    return *this;
+  }
+  Parameters &setCorePointsOnly(bool core_points_only)
+  {
+    _core_points_only = core_points_only;
+    return *this;
+  }
+  Parameters &setFinalizeLabels(bool finalize_labels)
+  {
+    _finalize_labels = finalize_labels;
+    return *this;
+  }
+};
+// Per-cluster statistics, gathered while finalizing the labels. Cluster k
+// has the label representatives(k).
+template <typename MemorySpace, int DIM = 3>
+struct ClusterStatistics
+{
+  Kokkos::View<int *, MemorySpace> representatives;
+  Kokkos::View<int *, MemorySpace> sizes;
+  Kokkos::View<ExperimentalHyperGeometry::Point<DIM> *, MemorySpace> centroids;
+  Kokkos::View<ExperimentalHyperGeometry::Box<DIM> *, MemorySpace> bounds;
+};
+
+// Distances from a sample of the points to their core_min_size-th nearest
+// neighbor, themselves included, sorted in increasing order. A point is a
+// core point for any eps at least its distance, so that the curve of
+// distances is the k-distance graph from which eps is chosen.
+struct KDistances
+{
+  std::vector<float> distances;
+
+  // Distance below which the given fraction of the sampled points lie, i.e.,
+  // the eps at which about that fraction of the points would be core points
+  float quantile(float fraction) const
+  {
+    ARBORX_ASSERT(!distances.empty());
+    ARBORX_ASSERT(0 <= fraction && fraction <= 1);
+    int const n = distances.size();
+    int const i = (int)std::ceil(fraction * n) - 1;
+    return distances[std::clamp(i, 0, n - 1)];
+  }
+
+  // Distance at the knee of the curve, where it is the farthest below the
+  // line joining its ends once both axes are scaled to [0, 1]. The distances
+  // past the knee rise steeply and are those of the noise points.
+  float knee() const
+  {
+    ARBORX_ASSERT(!distances.empty());
+    int const n = distances.size();
+    float const range = distances.back() - distances.front();
+    if (n < 3 || !(range > 0))
+      return distances.back();
+    int knee = 0;
+    float max_gap = 0;
+    for (int i = 0; i < n; ++i)
+    {
+      float const gap =
+          (float)i / (n - 1) - (distances[i] - distances.front()) / range;
+      if (gap > max_gap)
+      {
+        max_gap = gap;
+        knee = i;
+      }
+    }
+    return distances[knee];
+  }
 };
+
 } // namespace DBSCAN
 
+namespace Details
+{
+
+struct NoClusterStatistics
+{};
+
+// Sums of the coordinates and bounds of the points of each cluster, indexed
+// by the representative of the cluster
+template <typename Primitives, typename MemorySpace, int DIM>
+struct ClusterStatisticsAccumulator
+{
+  Primitives _primitives;
+  Kokkos::View<double * [DIM], MemorySpace> _sums;
+  Kokkos::View<ExperimentalHyperGeometry::Box<DIM> *, MemorySpace> _bounds;
+
+  KOKKOS_FUNCTION void operator()(int i, int label) const
+  {
+    using Access = AccessTraits<Primitives, PrimitivesTag>;
+    auto const &point = Access::get(_primitives, i);
+    auto &box = _bounds(label);
+    for (int d = 0; d < DIM; ++d)
+    {
+      Kokkos::atomic_add(&_sums(label, d), (double)point[d]);
+      Kokkos::atomic_min(&box.minCorner()[d], point[d]);
+      Kokkos::atomic_max(&box.maxCorner()[d], point[d]);
+    }
+  }
+};
+
 template <typename ExecutionSpace, typename Primitives>
+auto makeClusterAccumulator(ExecutionSpace const &, Primitives const &,
+                            NoClusterStatistics const &)
+{
+  return NoClusterAccumulation{};
+}
+
+template <typename ExecutionSpace, typename Primitives, typename MemorySpace,
+          int DIM>
+auto makeClusterAccumulator(
+    ExecutionSpace const &exec_space, Primitives const &primitives,
+    DBSCAN::ClusterStatistics<MemorySpace, DIM> const &)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  int const n = Access::size(primitives);
+  return ClusterStatisticsAccumulator<Primitives, MemorySpace, DIM>{
+      primitives,
+      Kokkos::View<double * [DIM], MemorySpace>(
+          Kokkos::view_alloc(exec_space, "ArborX::DBSCAN::cluster_sums"), n),
+      Kokkos::View<ExperimentalHyperGeometry::Box<DIM> *, MemorySpace>(
+          Kokkos::view_alloc(exec_space, "ArborX::DBSCAN::cluster_bounds"),
+          n)};
+}
+
+template <typename ExecutionSpace, typename Labels, typename ClusterSizes>
+void computeClusterStatistics(ExecutionSpace const &, Labels const &,
+                              ClusterSizes const &,
+                              NoClusterAccumulation const &,
+                              NoClusterStatistics &)
+{}
+
+// Gather the statistics of the clusters, whose representatives are the points
+// i with labels(i) == i once the labels are finalized
+template <typename ExecutionSpace, typename Labels, typename ClusterSizes,
+          typename Primitives, typename MemorySpace, int DIM>
+void computeClusterStatistics(
+    ExecutionSpace const &exec_space, Labels const &labels,
+    ClusterSizes const &cluster_sizes,
+    ClusterStatisticsAccumulator<Primitives, MemorySpace, DIM> const
+        &accumulator,
+    DBSCAN::ClusterStatistics<MemorySpace, DIM> &statistics)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DBSCAN::cluster_statistics");
+
+  int const n = labels.size();
+
+  int num_clusters;
+  Kokkos::parallel_reduce(
+      "ArborX::DBSCAN::count_clusters",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i, int &update) {
+        if (labels(i) == i)
+          ++update;
+      },
+      num_clusters);
+
+  statistics.representatives = Kokkos::View<int *, MemorySpace>(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::cluster_representatives"),
+      num_clusters);
+  statistics.sizes = Kokkos::View<int *, MemorySpace>(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::cluster_sizes"),
+      num_clusters);
+  statistics.centroids =
+      Kokkos::View<ExperimentalHyperGeometry::Point<DIM> *, MemorySpace>(
+          Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                             "ArborX::DBSCAN::cluster_centroids"),
+          num_clusters);
+  statistics.bounds =
+      Kokkos::View<ExperimentalHyperGeometry::Box<DIM> *, MemorySpace>(
+          Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                             "ArborX::DBSCAN::cluster_bounds"),
+          num_clusters);
+
+  auto const &representatives = statistics.representatives;
+  auto const &sizes = statistics.sizes;
+  auto const &centroids = statistics.centroids;
+  auto const &bounds = statistics.bounds;
+  auto const &sums = accumulator._sums;
+  auto const &cluster_bounds = accumulator._bounds;
+  Kokkos::parallel_scan(
+      "ArborX::DBSCAN::compute_cluster_statistics",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i, int &update, bool final_pass) {
+        if (labels(i) != i)
+          return;
+        if (final_pass)
+        {
+          int const size = cluster_sizes(i);
+          representatives(update) = i;
+          sizes(update) = size;
+          for (int d = 0; d < DIM; ++d)
+            centroids(update)[d] = sums(i, d) / size;
+          bounds(update) = cluster_bounds(i);
+        }
+        ++update;
+      });
+}
+
+template <typename ExecutionSpace, typename Primitives,
+          typename ClusterStatistics>
 Kokkos::View<int *,
              typename AccessTraits<Primitives, PrimitivesTag>::memory_space>
-dbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
-       float eps, int core_min_size,
-       DBSCAN::Parameters const &parameters = DBSCAN::Parameters())
+dbscanImpl(ExecutionSpace const &exec_space, Primitives const &primitives,
+           float eps, int core_min_size, DBSCAN::Parameters const &parameters,
+           ClusterStatistics &statistics)
 {
-  Kokkos::Profiling::pushRegion("ArborX::DBSCAN");
+  auto *const timings = parameters._timings;
+  pushPhase(exec_space, timings, "ArborX::DBSCAN");
 
   using Access = AccessTraits<Primitives, PrimitivesTag>;
   using MemorySpace = typename Access::memory_space;
@@ -288,13 +750,13 @@ dbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
   if (parameters._implementation == DBSCAN::Implementation::FDBSCAN)
   {
     // Build the tree
-    Kokkos::Profiling::pushRegion("ArborX::DBSCAN::tree_construction");
+    pushPhase(exec_space, timings, "ArborX::DBSCAN::tree_construction");
     ArborX::BasicBoundingVolumeHierarchy<MemorySpace,
                                          Details::PairIndexVolume<Box>>
         bvh(exec_space, primitives);
-    Kokkos::Profiling::popRegion();
+    popPhase(exec_space, timings);
 
-    Kokkos::Profiling::pushRegion("ArborX::DBSCAN::clusters");
+    pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters");
     if (is_special_case)
     {
       // Perform the queries and build clusters through callback
@@ -307,12 +769,12 @@ dbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
 #else
       using Details::HalfTraversal;
 #endif
-      Kokkos::Profiling::pushRegion("ArborX::DBSCAN::clusters::query");
+      pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::query");
       HalfTraversal(
           exec_space, bvh,
           Details::FDBSCANCallback<UnionFind, CorePoints>{labels, CorePoints{}},
           Details::WithinRadiusGetter{eps});
-      Kokkos::Profiling::popRegion();
+      popPhase(exec_space, timings);
     }
     else
     {
@@ -320,11 +782,11 @@ dbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
           Details::PrimitivesWithRadius<Primitives>{primitives, eps};
 
       // Determine core points
-      Kokkos::Profiling::pushRegion("ArborX::DBSCAN::clusters::num_neigh");
+      pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::num_neigh");
       Kokkos::resize(Kokkos::view_alloc(exec_space), num_neigh, n);
       bvh.query(exec_space, predicates,
                 Details::CountUpToN<MemorySpace>{num_neigh, core_min_size});
-      Kokkos::Profiling::popRegion();
+      popPhase(exec_space, timings);
 
       using CorePoints = Details::DBSCANCorePoints<MemorySpace>;
 #if defined(KOKKOS_COMPILER_NVCC) && (KOKKOS_COMPILER_NVCC < 1140)
@@ -337,19 +799,20 @@ dbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
 #endif
 
       // Perform the queries and build clusters through callback
-      Kokkos::Profiling::pushRegion("ArborX::DBSCAN::clusters::query");
+      pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::query");
       HalfTraversal(exec_space, bvh,
                     Details::FDBSCANCallback<UnionFind, CorePoints>{
-                        labels, CorePoints{num_neigh, core_min_size}},
+                        labels, CorePoints{num_neigh, core_min_size},
+                        parameters._core_points_only},
                     Details::WithinRadiusGetter{eps});
-      Kokkos::Profiling::popRegion();
+      popPhase(exec_space, timings);
     }
   }
   else if (parameters._implementation ==
            DBSCAN::Implementation::FDBSCAN_DenseBox)
   {
     // Find dense boxes
-    Kokkos::Profiling::pushRegion("ArborX::DBSCAN::dense_cells");
+    pushPhase(exec_space, timings, "ArborX::DBSCAN::dense_cells");
     Box bounds;
     Details::TreeConstruction::calculateBoundingBoxOfTheScene(
         exec_space, Details::Indexables<Primitives>{primitives}, bounds);
@@ -357,93 +820,93 @@ dbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
     // The cell length is chosen to be eps/sqrt(dimension), so that any two
     // points within the same cell are within eps distance of each other.
     float const h = eps / std::sqrt(dim);
-    Details::CartesianGrid<dim> const grid(bounds, h);
-
-    auto cell_indices =
-        Details::computeCellIndices(exec_space, primitives, grid);
-
-    auto permute = Details::sortObjects(exec_space, cell_indices);
-    auto &sorted_cell_indices = cell_indices; // alias
 
-    int num_nonempty_cells;
+    ArborX::BasicBoundingVolumeHierarchy<MemorySpace,
+                                         Details::PairIndexVolume<Box>>
+        bvh;
+    Kokkos::View<int *, MemorySpace> dense_cell_offsets(
+        "ArborX::DBSCAN::dense_cell_offsets", 0);
+    Kokkos::View<unsigned int *, MemorySpace> permute(
+        "ArborX::DBSCAN::permute", 0);
     int num_points_in_dense_cells;
+    // Only number the occupied cells when the cell indices of the full grid
+    // would need more than 32 bits (or overflow)
+    if (Details::numCells(bounds, h) >
+        (double)std::numeric_limits<unsigned int>::max())
     {
-      // Reorder indices and permutation so that the dense cells go first
-      Kokkos::View<int *, MemorySpace> cell_offsets(
-          "ArborX::DBSCAN::cell_offsets", 0);
-      Details::computeOffsetsInOrderedView(exec_space, sorted_cell_indices,
-                                           cell_offsets);
-      num_nonempty_cells = cell_offsets.size() - 1;
-
-      num_points_in_dense_cells = Details::reorderDenseAndSparseCells(
-          exec_space, cell_offsets, core_min_size, sorted_cell_indices,
-          permute);
+      using Grid = Details::SparseCartesianGrid<dim, MemorySpace>;
+      if (verbose)
+        printf("h = %e, sparse grid\n", h);
+      num_points_in_dense_cells = Details::buildDenseBoxHierarchy(
+          exec_space, primitives, core_min_size,
+          Grid(exec_space, primitives, bounds, h), h, bounds,
+          [&](Box const &shifted_bounds) {
+            return Grid(exec_space, primitives, shifted_bounds, h);
+          },
+          parameters._shifted_dense_cells, verbose, timings, UnionFind{labels},
+          bvh, dense_cell_offsets, permute);
     }
-    int num_points_in_sparse_cells = n - num_points_in_dense_cells;
-
-    auto dense_sorted_cell_indices = Kokkos::subview(
-        sorted_cell_indices, Kokkos::make_pair(0, num_points_in_dense_cells));
-
-    Kokkos::View<int *, MemorySpace> dense_cell_offsets(
-        "ArborX::DBSCAN::dense_cell_offsets", 0);
-    Details::computeOffsetsInOrderedView(exec_space, dense_sorted_cell_indices,
-                                         dense_cell_offsets);
-    int num_dense_cells = dense_cell_offsets.size() - 1;
-    if (verbose)
+    else
     {
-      printf("h = %e, n = [%zu", h, grid.extent(0));
-      for (int d = 1; d < decltype(grid)::dim; ++d)
-        printf(", %zu", grid.extent(d));
-      printf("]\n");
-      printf("#nonempty cells     : %10d\n", num_nonempty_cells);
-      printf("#dense cells        : %10d [%.2f%%]\n", num_dense_cells,
-             (100.f * num_dense_cells) / num_nonempty_cells);
-      printf("#dense cell points  : %10d [%.2f%%]\n", num_points_in_dense_cells,
-             (100.f * num_points_in_dense_cells) / n);
-      printf("#mixed primitives   : %10d\n",
-             num_dense_cells + num_points_in_sparse_cells);
+      using Grid = Details::CartesianGrid<dim>;
+      Grid const grid(bounds, h);
+      if (verbose)
+      {
+        printf("h = %e, n = [%zu", h, grid.extent(0));
+        for (int d = 1; d < dim; ++d)
+          printf(", %zu", grid.extent(d));
+        printf("]\n");
+      }
+      num_points_in_dense_cells = Details::buildDenseBoxHierarchy(
+          exec_space, primitives, core_min_size, grid, h, bounds,
+          [&](Box const &shifted_bounds) { return Grid(shifted_bounds, h); },
+          parameters._shifted_dense_cells, verbose, timings, UnionFind{labels},
+          bvh, dense_cell_offsets, permute);
     }
 
-    Details::unionFindWithinEachDenseCell(exec_space, dense_sorted_cell_indices,
-                                          permute, UnionFind{labels});
-
-    Kokkos::Profiling::popRegion();
-
-    // Build the tree
-    Kokkos::Profiling::pushRegion("ArborX::DBSCAN::tree_construction");
-    ArborX::BasicBoundingVolumeHierarchy<MemorySpace,
-                                         Details::PairIndexVolume<Box>>
-        bvh(exec_space,
-            Details::MixedBoxPrimitives<
-                Primitives, decltype(dense_cell_offsets),
-                decltype(cell_indices), decltype(permute)>{
-                primitives, grid, dense_cell_offsets, num_points_in_dense_cells,
-                sorted_cell_indices, permute});
-
-    Kokkos::Profiling::popRegion();
-
-    Kokkos::Profiling::pushRegion("ArborX::DBSCAN::clusters");
+    pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters");
+
+    // Points in dense cells are all core points. Merge the neighboring dense
+    // cells once per pair of cells, so that the main query only needs to look
+    // at the dense cells for the points in sparse cells.
+    pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::dense_cells");
+    Details::mergeNeighboringDenseCells(exec_space, UnionFind{labels},
+                                        primitives, bvh, dense_cell_offsets,
+                                        permute, eps);
+    popPhase(exec_space, timings);
+
+    auto const dense_permute = Kokkos::subview(
+        permute, Kokkos::make_pair(0, num_points_in_dense_cells));
+    auto const sparse_permute = Kokkos::subview(
+        permute, Kokkos::make_pair(num_points_in_dense_cells, n));
+    using DensePredicates =
+        Details::PrimitivesWithRadiusReorderedAndFiltered<
+            Primitives, std::decay_t<decltype(dense_permute)>>;
+    using SparsePredicates =
+        Details::PrimitivesWithRadiusReorderedAndFiltered<
+            Primitives, std::decay_t<decltype(sparse_permute)>>;
 
     if (is_special_case)
     {
       // Perform the queries and build clusters through callback
       using CorePoints = Details::CCSCorePoints;
-      Kokkos::Profiling::pushRegion("ArborX::DBSCAN::clusters::query");
-      auto const predicates =
-          Details::PrimitivesWithRadius<Primitives>{primitives, eps};
-      bvh.query(
-          exec_space, predicates,
-          Details::FDBSCANDenseBoxCallback<UnionFind, CorePoints, Primitives,
-                                           decltype(dense_cell_offsets),
-                                           decltype(permute)>{
-              labels, CorePoints{}, primitives, dense_cell_offsets, exec_space,
-              permute, eps});
-      Kokkos::Profiling::popRegion();
+      pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::query");
+      Details::FDBSCANDenseBoxCallback<UnionFind, CorePoints, Primitives,
+                                       decltype(dense_cell_offsets),
+                                       decltype(permute)>
+          callback{labels,     CorePoints{}, primitives, dense_cell_offsets,
+                   exec_space, permute,      eps};
+      bvh.query(exec_space,
+                SparsePredicates{primitives, eps, sparse_permute}, callback);
+      callback._dense_cells_merged = true;
+      bvh.query(exec_space, DensePredicates{primitives, eps, dense_permute},
+                callback);
+      popPhase(exec_space, timings);
     }
     else
     {
       // Determine core points
-      Kokkos::Profiling::pushRegion("ArborX::DBSCAN::clusters::num_neigh");
+      pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::num_neigh");
       Kokkos::resize(Kokkos::view_alloc(exec_space), num_neigh, n);
       // Set num neighbors for points in dense cells to max, so that they are
       // automatically core points
@@ -453,97 +916,841 @@ dbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
                                               num_points_in_dense_cells),
           KOKKOS_LAMBDA(int i) { num_neigh(permute(i)) = INT_MAX; });
       // Count neighbors for points in sparse cells
-      auto sparse_permute = Kokkos::subview(
-          permute, Kokkos::make_pair(num_points_in_dense_cells, n));
-
-      auto const sparse_predicates =
-          Details::PrimitivesWithRadiusReorderedAndFiltered<
-              Primitives, decltype(sparse_permute)>{primitives, eps,
-                                                    sparse_permute};
-      bvh.query(exec_space, sparse_predicates,
+      bvh.query(exec_space, SparsePredicates{primitives, eps, sparse_permute},
                 Details::CountUpToN_DenseBox<MemorySpace, Primitives,
                                              decltype(dense_cell_offsets),
                                              decltype(permute)>(
                     num_neigh, primitives, dense_cell_offsets, permute,
                     core_min_size, eps, core_min_size));
-      Kokkos::Profiling::popRegion();
+      popPhase(exec_space, timings);
 
       using CorePoints = Details::DBSCANCorePoints<MemorySpace>;
 
       // Perform the queries and build clusters through callback
-      Kokkos::Profiling::pushRegion("ArborX::DBSCAN::clusters::query");
-      auto const predicates =
-          Details::PrimitivesWithRadius<Primitives>{primitives, eps};
-      bvh.query(
-          exec_space, predicates,
-          Details::FDBSCANDenseBoxCallback<UnionFind, CorePoints, Primitives,
-                                           decltype(dense_cell_offsets),
-                                           decltype(permute)>{
-              labels, CorePoints{num_neigh, core_min_size}, primitives,
-              dense_cell_offsets, exec_space, permute, eps});
-      Kokkos::Profiling::popRegion();
+      pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::query");
+      Details::FDBSCANDenseBoxCallback<UnionFind, CorePoints, Primitives,
+                                       decltype(dense_cell_offsets),
+                                       decltype(permute)>
+          callback{labels,
+                   CorePoints{num_neigh, core_min_size},
+                   primitives,
+                   dense_cell_offsets,
+                   exec_space,
+                   permute,
+                   eps,
+                   parameters._core_points_only};
+      bvh.query(exec_space,
+                SparsePredicates{primitives, eps, sparse_permute}, callback);
+      callback._dense_cells_merged = true;
+      bvh.query(exec_space, DensePredicates{primitives, eps, dense_permute},
+                callback);
+      popPhase(exec_space, timings);
     }
   }
+  else if (parameters._implementation ==
+           DBSCAN::Implementation::FDBSCAN_CellStencil)
+  {
+    ARBORX_ASSERT(dim == 2 || dim == 3);
 
-  // Per [1]:
-  //
-  // ```
-  // The finalization kernel will, ultimately, make all parents
-  // point directly to the representative.
-  // ```
-  Kokkos::View<int *, MemorySpace> cluster_sizes(
-      Kokkos::view_alloc(exec_space, "ArborX::DBSCAN::cluster_sizes"), n);
+    // Sort the points by cell
+    pushPhase(exec_space, timings, "ArborX::DBSCAN::cells");
+    Box bounds;
+    Details::TreeConstruction::calculateBoundingBoxOfTheScene(
+        exec_space, Details::Indexables<Primitives>{primitives}, bounds);
+    auto const stencil = Details::makeCellStencil(exec_space, primitives,
+                                                  bounds, eps, core_min_size);
+    if (verbose)
+      printf("h = %e, %d nonempty cells\n", eps / std::sqrt(dim),
+             stencil._cells.extent_int(0));
+    popPhase(exec_space, timings);
+
+    pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters");
+    if (is_special_case)
+    {
+      using CorePoints = Details::CCSCorePoints;
+      pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::query");
+      Details::forEachPairWithinEps(
+          exec_space, stencil,
+          Details::FDBSCANCallback<UnionFind, CorePoints>{labels,
+                                                          CorePoints{}});
+      popPhase(exec_space, timings);
+    }
+    else
+    {
+      // Determine core points
+      pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::num_neigh");
+      Kokkos::resize(Kokkos::view_alloc(exec_space), num_neigh, n);
+      Details::countNeighborsUpToN(exec_space, stencil, num_neigh);
+      popPhase(exec_space, timings);
+
+      using CorePoints = Details::DBSCANCorePoints<MemorySpace>;
+
+      // Perform the queries and build clusters through callback
+      pushPhase(exec_space, timings, "ArborX::DBSCAN::clusters::query");
+      Details::forEachPairWithinEps(
+          exec_space, stencil,
+          Details::FDBSCANCallback<UnionFind, CorePoints>{
+              labels, CorePoints{num_neigh, core_min_size},
+              parameters._core_points_only});
+      popPhase(exec_space, timings);
+    }
+  }
+
+  if (!parameters._finalize_labels)
+  {
+    // Leave the union-find labels as they are
+  }
+  else
+  {
+    // Accumulate the cluster statistics, if requested, while going over the
+    // points to finalize the labels
+    auto const accumulator =
+        makeClusterAccumulator(exec_space, primitives, statistics);
+    Kokkos::View<int *, MemorySpace> cluster_sizes;
+    if (is_special_case)
+    {
+      // Ideally, this would have had the exactly same form as in the else()
+      // clause. But there's no available valid is_core() for use here:
+      // - CCSCorePoints cannot be used as it always returns true, which is OK
+      //   inside the callback, but not here
+      // - DBSCANCorePoints cannot be used either as num_neigh is not
+      //   initialized in the special case.
+      // Isolated points are the only noise points in this case.
+      cluster_sizes = Details::finalizeLabels(
+          exec_space, labels, Details::CCSNoCorePoints{}, accumulator);
+    }
+    else
+    {
+      cluster_sizes = Details::finalizeLabels(
+          exec_space, labels,
+          Details::DBSCANCorePoints<MemorySpace>{num_neigh, core_min_size},
+          accumulator);
+    }
+    computeClusterStatistics(exec_space, labels, cluster_sizes, accumulator,
+                             statistics);
+  }
+  popPhase(exec_space, timings);
+
+  popPhase(exec_space, timings);
+
+  return labels;
+}
+
+} // namespace Details
+
+template <typename ExecutionSpace, typename Primitives>
+Kokkos::View<int *,
+             typename AccessTraits<Primitives, PrimitivesTag>::memory_space>
+dbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
+       float eps, int core_min_size,
+       DBSCAN::Parameters const &parameters = DBSCAN::Parameters())
+{
+  Details::NoClusterStatistics statistics;
+  return Details::dbscanImpl(exec_space, primitives, eps, core_min_size,
+                             parameters, statistics);
+}
+
+// Same as above, additionally computing the size, centroid and bounds of each
+// cluster while finalizing the labels
+template <typename ExecutionSpace, typename Primitives, typename MemorySpace,
+          int DIM>
+Kokkos::View<int *,
+             typename AccessTraits<Primitives, PrimitivesTag>::memory_space>
+dbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
+       float eps, int core_min_size, DBSCAN::Parameters const &parameters,
+       DBSCAN::ClusterStatistics<MemorySpace, DIM> &statistics)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(std::is_same_v<typename Access::memory_space, MemorySpace>);
+  static_assert(
+      GeometryTraits::dimension_v<
+          typename Details::AccessTraitsHelper<Access>::type> == DIM);
+  // The statistics are gathered while finalizing the labels
+  ARBORX_ASSERT(parameters._finalize_labels);
+
+  return Details::dbscanImpl(exec_space, primitives, eps, core_min_size,
+                             parameters, statistics);
+}
+
+// Cluster independent sets of points at once, e.g., many small point clouds,
+// in a single sequence of kernel launches. The points of set s are the
+// primitives offsets(s) to offsets(s + 1) - 1, clustered with eps(s) and
+// core_min_sizes(s) as by dbscan() on them alone. The label of a point is
+// relative to the first point of its set, or -1 for noise. The neighbors are
+// searched through a stencil of cells of a grid per set (see
+// DBSCAN::Implementation::FDBSCAN_CellStencil), which never reaches another
+// set. Of the parameters, only the choice of DBSCAN* applies.
+template <typename ExecutionSpace, typename Primitives, typename Offsets,
+          typename Eps, typename CoreMinSizes>
+Kokkos::View<int *,
+             typename AccessTraits<Primitives, PrimitivesTag>::memory_space>
+dbscanBatched(ExecutionSpace const &exec_space, Primitives const &primitives,
+              Offsets const &offsets, Eps const &eps,
+              CoreMinSizes const &core_min_sizes,
+              DBSCAN::Parameters const &parameters = DBSCAN::Parameters())
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DBSCAN::batched");
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value,
+      "Primitives must be accessible from the execution space");
+  static_assert(Kokkos::is_view_v<Offsets> && Offsets::rank == 1);
+  static_assert(Kokkos::is_view_v<Eps> && Eps::rank == 1);
+  static_assert(Kokkos::is_view_v<CoreMinSizes> && CoreMinSizes::rank == 1);
+
+  int const n = Access::size(primitives);
+  ARBORX_ASSERT(offsets.extent(0) >= 1);
+  int const num_sets = offsets.extent(0) - 1;
+  ARBORX_ASSERT((int)eps.extent(0) == num_sets);
+  ARBORX_ASSERT((int)core_min_sizes.extent(0) == num_sets);
+  ARBORX_ASSERT(KokkosExt::lastElement(exec_space, offsets) == n);
+
+  Kokkos::View<int *, MemorySpace> labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::labels"),
+      n);
+  if (n == 0)
+    return labels;
+  ArborX::iota(exec_space, labels);
+
+  auto const stencil = Details::makeBatchedCellStencil(
+      exec_space, primitives, offsets, eps, core_min_sizes);
+
+  // The core points have INT_MAX neighbors whatever the core_min_size of
+  // their set
+  Kokkos::View<int *, MemorySpace> num_neigh(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::num_neighbors"),
+      n);
+  Details::countNeighborsUpToN(exec_space, stencil, num_neigh);
+  using CorePoints = Details::DBSCANCorePoints<MemorySpace>;
+  CorePoints const is_core{num_neigh, INT_MAX};
+
+  using UnionFind = Details::UnionFind<MemorySpace>;
+  Details::forEachPairWithinEps(
+      exec_space, stencil,
+      Details::FDBSCANCallback<UnionFind, CorePoints>{
+          labels, is_core, parameters._core_points_only});
+
+  Details::finalizeLabels(exec_space, labels, is_core);
+
+  auto const &sets = stencil._sets;
   Kokkos::parallel_for(
-      "ArborX::DBSCAN::finalize_labels",
+      "ArborX::DBSCAN::batched::relabel",
       Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
-      KOKKOS_LAMBDA(int const i) {
-        // ##### ECL license (see LICENSE.ECL) #####
-        int next;
-        int vstat = labels(i);
-        int const old = vstat;
-        while (vstat > (next = labels(vstat)))
-        {
-          vstat = next;
-        }
-        if (vstat != old)
-          labels(i) = vstat;
+      KOKKOS_LAMBDA(int i) {
+        if (labels(i) >= 0)
+          labels(i) -= offsets(sets(i));
+      });
 
-        Kokkos::atomic_increment(&cluster_sizes(labels(i)));
+  return labels;
+}
+
+namespace Details
+{
+template <typename Primitives, typename Distances>
+struct KDistanceCallback
+{
+  Primitives _primitives;
+  Distances _distances;
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+
+  template <typename Predicate, typename Value>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate,
+                                  Value const &value) const
+  {
+    int const j = getData(predicate);
+    using KokkosExt::max;
+    // Each nearest traversal being performed by a single thread, the update
+    // does not need to be atomic
+    _distances(j) = max(_distances(j),
+                        distance(getGeometry(predicate),
+                                 Access::get(_primitives, value.index)));
+  }
+};
+} // namespace Details
+
+// Compute the k-distance graph of a sample of the points, for
+// k = core_min_size, to choose eps. The points i * n / num_samples are
+// sampled, so that the sample is the same across runs and platforms. Their
+// nearest neighbors are searched for among all the points, on the device,
+// and only the sorted distances of the sample are copied to the host.
+template <typename ExecutionSpace, typename Primitives>
+DBSCAN::KDistances sampleKDistances(ExecutionSpace const &exec_space,
+                                    Primitives const &primitives,
+                                    int core_min_size, int num_samples)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DBSCAN::sampleKDistances");
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value,
+      "Primitives must be accessible from the execution space");
+
+  ARBORX_ASSERT(core_min_size >= 1);
+  ARBORX_ASSERT(num_samples > 0);
+
+  int const n = Access::size(primitives);
+  ARBORX_ASSERT(n >= core_min_size);
+  num_samples = std::min(num_samples, n);
+
+  constexpr int dim = GeometryTraits::dimension_v<
+      typename Details::AccessTraitsHelper<Access>::type>;
+  using Box = ExperimentalHyperGeometry::Box<dim>;
+  ArborX::BasicBoundingVolumeHierarchy<MemorySpace,
+                                       Details::PairIndexVolume<Box>>
+      bvh(exec_space, primitives);
+
+  using Point = std::decay_t<decltype(Access::get(primitives, 0))>;
+  using Predicate = decltype(attach(nearest(std::declval<Point>(), 1), 0));
+  Kokkos::View<Predicate *, MemorySpace> predicates(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::k_distances::predicates"),
+      num_samples);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::k_distances::sample",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_samples),
+      KOKKOS_LAMBDA(int i) {
+        auto const index = (int)((long long)i * n / num_samples);
+        predicates(i) =
+            attach(nearest(Access::get(primitives, index), core_min_size), i);
       });
-  if (is_special_case)
-  {
-    // Ideally, this kernel would have had the exactly same form as in the
-    // else() clause. But there's no available valid is_core() for use here:
-    // - CCSCorePoints cannot be used as it always returns true, which is OK
-    //   inside the callback, but not here
-    // - DBSCANCorePoints cannot be used either as num_neigh is not initialized
-    //   in the special case.
-    Kokkos::parallel_for(
-        "ArborX::DBSCAN::mark_noise",
-        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
-        KOKKOS_LAMBDA(int const i) {
-          if (cluster_sizes(labels(i)) == 1)
-            labels(i) = -1;
-        });
+
+  Kokkos::View<float *, MemorySpace> distances(
+      "ArborX::DBSCAN::k_distances::distances", num_samples);
+  bvh.query(exec_space, predicates,
+            Details::KDistanceCallback<Primitives, decltype(distances)>{
+                primitives, distances});
+  Details::sortObjects(exec_space, distances);
+
+  DBSCAN::KDistances k_distances;
+  k_distances.distances.resize(num_samples);
+  Kokkos::deep_copy(exec_space,
+                    Kokkos::View<float *, Kokkos::HostSpace,
+                                 Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+                        k_distances.distances.data(), num_samples),
+                    distances);
+  exec_space.fence();
+  return k_distances;
+}
+
+namespace Experimental
+{
+
+// Search structure to run DBSCAN repeatedly on the same points, e.g., for
+// parameter sweeps. The pairs of points within eps_max of each other are
+// found once at construction, and each clustering with eps <= eps_max only
+// filters them, without any tree construction or traversal. The memory
+// footprint grows with the number of pairs within eps_max.
+template <typename Primitives>
+class DBSCANIndex
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+
+public:
+  using memory_space = typename Access::memory_space;
+
+  template <typename ExecutionSpace>
+  DBSCANIndex(ExecutionSpace const &exec_space, Primitives const &primitives,
+              float eps_max)
+      : _primitives(primitives)
+      , _eps_max(eps_max)
+      , _offsets("ArborX::DBSCANIndex::offsets", 0)
+      , _indices("ArborX::DBSCANIndex::indices", 0)
+  {
+    KokkosExt::ScopedProfileRegion guard("ArborX::DBSCANIndex::DBSCANIndex");
+
+    static_assert(
+        KokkosExt::is_accessible_from<memory_space, ExecutionSpace>::value,
+        "Primitives must be accessible from the execution space");
+    ARBORX_ASSERT(eps_max > 0);
+
+    constexpr int dim = GeometryTraits::dimension_v<
+        typename Details::AccessTraitsHelper<Access>::type>;
+    using Box = ExperimentalHyperGeometry::Box<dim>;
+
+    BasicBoundingVolumeHierarchy<memory_space, Details::PairIndexVolume<Box>>
+        bvh(exec_space, primitives);
+    selfJoin(bvh, exec_space, Details::WithinRadiusGetter{eps_max}, _offsets,
+             _indices, SelfJoinOutput::Half);
   }
-  else
+
+  float epsMax() const { return _eps_max; }
+
+  template <typename ExecutionSpace>
+  Kokkos::View<int *, memory_space> cluster(ExecutionSpace const &exec_space,
+                                            float eps, int core_min_size) const
   {
-    Details::DBSCANCorePoints<MemorySpace> is_core{num_neigh, core_min_size};
+    KokkosExt::ScopedProfileRegion guard("ArborX::DBSCANIndex::cluster");
+
+    ARBORX_ASSERT(eps > 0 && eps <= _eps_max);
+    ARBORX_ASSERT(core_min_size >= 2);
+
+#ifdef KOKKOS_ENABLE_SERIAL
+    using UnionFind = Details::UnionFind<
+        memory_space,
+        /*DoSerial=*/std::is_same_v<ExecutionSpace, Kokkos::Serial>>;
+#else
+    using UnionFind = Details::UnionFind<memory_space>;
+#endif
+
+    int const n = Access::size(_primitives);
+
+    Kokkos::View<int *, memory_space> labels(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::DBSCANIndex::labels"),
+        n);
+    ArborX::iota(exec_space, labels);
+
+    if (core_min_size == 2)
+    {
+      using CorePoints = Details::CCSCorePoints;
+      Details::forEachPairWithinRadius(
+          exec_space, _primitives, _offsets, _indices, eps,
+          Details::FDBSCANCallback<UnionFind, CorePoints>{labels,
+                                                          CorePoints{}});
+      Details::finalizeLabels(exec_space, labels, Details::CCSNoCorePoints{});
+    }
+    else
+    {
+      // Each point is its own neighbor
+      Kokkos::View<int *, memory_space> num_neigh(
+          Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                             "ArborX::DBSCANIndex::num_neighbors"),
+          n);
+      Kokkos::deep_copy(exec_space, num_neigh, 1);
+      Details::forEachPairWithinRadius(
+          exec_space, _primitives, _offsets, _indices, eps,
+          KOKKOS_LAMBDA(int i, int j) {
+            Kokkos::atomic_increment(&num_neigh(i));
+            Kokkos::atomic_increment(&num_neigh(j));
+          });
+
+      using CorePoints = Details::DBSCANCorePoints<memory_space>;
+      CorePoints const is_core{num_neigh, core_min_size};
+      Details::forEachPairWithinRadius(
+          exec_space, _primitives, _offsets, _indices, eps,
+          Details::FDBSCANCallback<UnionFind, CorePoints>{labels, is_core});
+      Details::finalizeLabels(exec_space, labels, is_core);
+    }
+
+    return labels;
+  }
+
+private:
+  Primitives _primitives;
+  float _eps_max;
+  Kokkos::View<int *, memory_space> _offsets;
+  Kokkos::View<int *, memory_space> _indices;
+};
+
+// DBSCAN clustering of an append-only set of points. The points are
+// clustered as they are inserted: only the new points, and the existing
+// points they turn into core points, are queried for neighbors, and the
+// clusters are merged through the union-find.
+//
+// The points are indexed by a logarithmic set of hierarchies, each over a
+// contiguous range of insertions. A batch of points gets its own hierarchy,
+// which is merged with the last ones while they are not larger than the
+// points inserted since. Each point is thus part of O(log n) hierarchy
+// constructions over its lifetime, and queries search O(log n) hierarchies.
+template <typename MemorySpace, typename Point>
+class IncrementalDBSCAN
+{
+  using Box =
+      ExperimentalHyperGeometry::Box<GeometryTraits::dimension_v<Point>>;
+  using Tree =
+      BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>>;
+  using Points = Kokkos::View<Point *, MemorySpace>;
+
+public:
+  using memory_space = MemorySpace;
+
+  IncrementalDBSCAN(float eps, int core_min_size)
+      : _eps(eps)
+      , _core_min_size(core_min_size)
+      , _points("ArborX::IncrementalDBSCAN::points", 0)
+      , _labels("ArborX::IncrementalDBSCAN::labels", 0)
+      , _num_neigh("ArborX::IncrementalDBSCAN::num_neighbors", 0)
+  {
+    ARBORX_ASSERT(eps > 0);
+    ARBORX_ASSERT(core_min_size >= 2);
+  }
+
+  // Number of points inserted so far
+  int size() const { return _size; }
+
+  template <typename ExecutionSpace, typename Primitives>
+  void insert(ExecutionSpace const &exec_space, Primitives const &primitives);
+
+  // Cluster labels of all the points inserted so far, in insertion order,
+  // with the same conventions as dbscan()
+  template <typename ExecutionSpace>
+  Kokkos::View<int *, MemorySpace>
+  labels(ExecutionSpace const &exec_space) const
+  {
+    auto labels = KokkosExt::clone(
+        exec_space, Kokkos::subview(_labels, Kokkos::make_pair(0, _size)),
+        "ArborX::IncrementalDBSCAN::finalized_labels");
+    Details::finalizeLabels(exec_space, labels, isCore());
+    return labels;
+  }
+
+private:
+  Details::DBSCANCorePoints<MemorySpace> isCore() const
+  {
+    return {_num_neigh, _core_min_size};
+  }
+
+  auto pointsRange(int first, int last) const
+  {
+    return Kokkos::subview(_points, Kokkos::make_pair(first, last));
+  }
+
+  // Find in CRS format the neighbors within eps of the points in
+  // query_points, among the points indexed by the hierarchies
+  template <typename ExecutionSpace, typename QueryPoints>
+  void findNeighbors(ExecutionSpace const &exec_space,
+                     QueryPoints const &query_points,
+                     Kokkos::View<int *, MemorySpace> &offsets,
+                     Kokkos::View<int *, MemorySpace> &neighbors) const;
+
+  float _eps;
+  int _core_min_size;
+  int _size = 0;
+  Points _points;
+  // Union-find parents, not finalized
+  Kokkos::View<int *, MemorySpace> _labels;
+  Kokkos::View<int *, MemorySpace> _num_neigh;
+  // Hierarchies with the index of the first point they cover, in increasing
+  // order
+  std::vector<std::pair<int, Tree>> _trees;
+};
+
+namespace Details
+{
+struct IncrementalDBSCANNeighborCallback
+{
+  int _first;
+
+  template <typename Predicate, typename Value, typename OutputFunctor>
+  KOKKOS_FUNCTION void operator()(Predicate const &, Value const &value,
+                                  OutputFunctor const &out) const
+  {
+    out(_first + (int)value.index);
+  }
+};
+} // namespace Details
+
+template <typename MemorySpace, typename Point>
+template <typename ExecutionSpace, typename QueryPoints>
+void IncrementalDBSCAN<MemorySpace, Point>::findNeighbors(
+    ExecutionSpace const &exec_space, QueryPoints const &query_points,
+    Kokkos::View<int *, MemorySpace> &offsets,
+    Kokkos::View<int *, MemorySpace> &neighbors) const
+{
+  int const m = query_points.size();
+  auto const predicates =
+      Details::PrimitivesWithRadius<QueryPoints>{query_points, _eps};
+
+  KokkosExt::reallocWithoutInitializing(exec_space, offsets, m + 1);
+  Kokkos::deep_copy(exec_space, offsets, 0);
+  KokkosExt::reallocWithoutInitializing(exec_space, neighbors, 0);
+
+  // Merge the results from each hierarchy
+  for (auto const &[first, tree] : _trees)
+  {
+    Kokkos::View<int *, MemorySpace> tree_offsets(
+        "ArborX::IncrementalDBSCAN::tree_offsets", 0);
+    Kokkos::View<int *, MemorySpace> tree_neighbors(
+        "ArborX::IncrementalDBSCAN::tree_neighbors", 0);
+    tree.query(exec_space, predicates,
+               Details::IncrementalDBSCANNeighborCallback{first},
+               tree_neighbors, tree_offsets);
+
+    Kokkos::View<int *, MemorySpace> merged_offsets(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::IncrementalDBSCAN::offsets"),
+        m + 1);
+    Kokkos::parallel_for(
+        "ArborX::IncrementalDBSCAN::merge_offsets",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, m + 1),
+        KOKKOS_LAMBDA(int i) {
+          merged_offsets(i) = offsets(i) + tree_offsets(i);
+        });
+    Kokkos::View<int *, MemorySpace> merged_neighbors(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::IncrementalDBSCAN::neighbors"),
+        neighbors.size() + tree_neighbors.size());
     Kokkos::parallel_for(
-        "ArborX::DBSCAN::mark_noise",
-        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
-        KOKKOS_LAMBDA(int const i) {
-          if (cluster_sizes(labels(i)) == 1 && !is_core(i))
-            labels(i) = -1;
+        "ArborX::IncrementalDBSCAN::merge_neighbors",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, m),
+        KOKKOS_LAMBDA(int i) {
+          int k = merged_offsets(i);
+          for (int j = offsets(i); j < offsets(i + 1); ++j)
+            merged_neighbors(k++) = neighbors(j);
+          for (int j = tree_offsets(i); j < tree_offsets(i + 1); ++j)
+            merged_neighbors(k++) = tree_neighbors(j);
         });
+    offsets = merged_offsets;
+    neighbors = merged_neighbors;
+  }
+}
+
+template <typename MemorySpace, typename Point>
+template <typename ExecutionSpace, typename Primitives>
+void IncrementalDBSCAN<MemorySpace, Point>::insert(
+    ExecutionSpace const &exec_space, Primitives const &primitives)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::IncrementalDBSCAN::insert");
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(
+      KokkosExt::is_accessible_from<typename Access::memory_space,
+                                    ExecutionSpace>::value,
+      "Primitives must be accessible from the execution space");
+  static_assert(
+      std::is_same_v<typename Details::AccessTraitsHelper<Access>::type,
+                     Point>,
+      "Primitives must be of the point type of the clustering");
+
+  int const n = _size;
+  int const m = Access::size(primitives);
+  if (m == 0)
+    return;
+
+  // Append the new points, growing the storage geometrically
+  if (n + m > _points.extent_int(0))
+  {
+    int const capacity = std::max(n + m, 2 * _points.extent_int(0));
+    Kokkos::resize(Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing),
+                   _points, capacity);
+    Kokkos::resize(Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing),
+                   _labels, capacity);
+    Kokkos::resize(Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing),
+                   _num_neigh, capacity);
+  }
+  _size = n + m;
+  auto const points = _points;
+  auto const labels = _labels;
+  auto const num_neigh = _num_neigh;
+  Kokkos::parallel_for(
+      "ArborX::IncrementalDBSCAN::append_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, m),
+      KOKKOS_LAMBDA(int i) {
+        points(n + i) = Access::get(primitives, i);
+        labels(n + i) = n + i;
+        num_neigh(n + i) = 0;
+      });
+
+  // Index the new points, merging the hierarchies that are not larger than
+  // the points inserted since they were built
+  int first = n;
+  while (!_trees.empty() &&
+         (int)_trees.back().second.size() <= _size - first)
+  {
+    first = _trees.back().first;
+    _trees.pop_back();
   }
-  Kokkos::Profiling::popRegion();
+  _trees.emplace_back(first, Tree(exec_space, pointsRange(first, _size)));
+
+  // Neighbors of the new points among all the points (themselves included)
+  Kokkos::View<int *, MemorySpace> offsets(
+      "ArborX::IncrementalDBSCAN::offsets", 0);
+  Kokkos::View<int *, MemorySpace> neighbors(
+      "ArborX::IncrementalDBSCAN::neighbors", 0);
+  findNeighbors(exec_space, pointsRange(n, _size), offsets, neighbors);
+
+  // Update the number of neighbors, counting each pair between two new points
+  // once for each of them and each other pair once for the existing point
+  Kokkos::View<int *, MemorySpace> was_core(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::IncrementalDBSCAN::was_core"),
+      n);
+  auto const is_core = isCore();
+  Kokkos::parallel_for(
+      "ArborX::IncrementalDBSCAN::save_core_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) { was_core(i) = is_core(i); });
+  Kokkos::parallel_for(
+      "ArborX::IncrementalDBSCAN::count_neighbors",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, m),
+      KOKKOS_LAMBDA(int i) {
+        num_neigh(n + i) = offsets(i + 1) - offsets(i);
+        for (int k = offsets(i); k < offsets(i + 1); ++k)
+          if (neighbors(k) < n)
+            Kokkos::atomic_increment(&num_neigh(neighbors(k)));
+      });
+
+  // Existing points that just became core points connect their whole
+  // neighborhood
+  Kokkos::View<int *, MemorySpace> new_core_points(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::IncrementalDBSCAN::new_core_points"),
+      n);
+  int num_new_core_points;
+  Kokkos::parallel_scan(
+      "ArborX::IncrementalDBSCAN::find_new_core_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i, int &update, bool final_pass) {
+        if (!was_core(i) && is_core(i))
+        {
+          if (final_pass)
+            new_core_points(update) = i;
+          ++update;
+        }
+      },
+      num_new_core_points);
+  Kokkos::resize(Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing),
+                 new_core_points, num_new_core_points);
+
+  Kokkos::View<Point *, MemorySpace> new_core_points_coordinates(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::IncrementalDBSCAN::new_core_points"),
+      num_new_core_points);
+  Kokkos::parallel_for(
+      "ArborX::IncrementalDBSCAN::gather_new_core_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_new_core_points),
+      KOKKOS_LAMBDA(int i) {
+        new_core_points_coordinates(i) = points(new_core_points(i));
+      });
+  Kokkos::View<int *, MemorySpace> core_offsets(
+      "ArborX::IncrementalDBSCAN::core_offsets", 0);
+  Kokkos::View<int *, MemorySpace> core_neighbors(
+      "ArborX::IncrementalDBSCAN::core_neighbors", 0);
+  findNeighbors(exec_space, new_core_points_coordinates, core_offsets,
+                core_neighbors);
+
+  // Merge the clusters through the new pairs and the neighborhoods of the new
+  // core points
+#ifdef KOKKOS_ENABLE_SERIAL
+  using UnionFind = Details::UnionFind<
+      MemorySpace,
+      /*DoSerial=*/std::is_same_v<ExecutionSpace, Kokkos::Serial>>;
+#else
+  using UnionFind = Details::UnionFind<MemorySpace>;
+#endif
+  Details::FDBSCANCallback<UnionFind, Details::DBSCANCorePoints<MemorySpace>>
+      merge{labels, is_core};
+  Kokkos::parallel_for(
+      "ArborX::IncrementalDBSCAN::merge_new_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, m),
+      KOKKOS_LAMBDA(int i) {
+        for (int k = offsets(i); k < offsets(i + 1); ++k)
+          if (neighbors(k) != n + i)
+            merge(n + i, neighbors(k));
+      });
+  Kokkos::parallel_for(
+      "ArborX::IncrementalDBSCAN::merge_new_core_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_new_core_points),
+      KOKKOS_LAMBDA(int i) {
+        int const p = new_core_points(i);
+        for (int k = core_offsets(i); k < core_offsets(i + 1); ++k)
+          if (core_neighbors(k) != p)
+            merge(p, core_neighbors(k));
+      });
+}
+
+} // namespace Experimental
+
+namespace Details
+{
+
+// Copy the rows of coordinates to points of the given dimension
+template <int DIM, typename ExecutionSpace, typename MemorySpace>
+Kokkos::View<ExperimentalHyperGeometry::Point<DIM> *, MemorySpace>
+makePointsFromCoordinates(
+    ExecutionSpace const &exec_space,
+    Kokkos::View<float **, MemorySpace> const &coordinates)
+{
+  ARBORX_ASSERT((int)coordinates.extent(1) == DIM);
+  int const n = coordinates.extent(0);
+  Kokkos::View<ExperimentalHyperGeometry::Point<DIM> *, MemorySpace> points(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::points"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::copy_coordinates",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        for (int d = 0; d < DIM; ++d)
+          points(i)[d] = coordinates(i, d);
+      });
+  return points;
+}
+
+} // namespace Details
 
-  Kokkos::Profiling::popRegion();
+namespace Experimental
+{
 
+/** DBSCAN of points whose dimension is only known at runtime, given as the
+ * rows of a view of coordinates. The points are copied to a view of
+ * ExperimentalHyperGeometry::Point<DIM>, where DIM is the number of columns,
+ * and clustered by dbscan() for that dimension. With
+ * ARBORX_ENABLE_EXPLICIT_INSTANTIATION, it is compiled once in the library
+ * for each DIM from 1 to 10. Other dimensions throw.
+ */
+template <typename ExecutionSpace, typename MemorySpace>
+Kokkos::View<int *, MemorySpace>
+dbscan(ExecutionSpace const &exec_space,
+       Kokkos::View<float **, MemorySpace> const &coordinates, float eps,
+       int core_min_size,
+       DBSCAN::Parameters const &parameters = DBSCAN::Parameters())
+{
+  Kokkos::View<int *, MemorySpace> labels;
+  bool const supported = dispatchDimension<1, 2, 3, 4, 5, 6, 7, 8, 9, 10>(
+      coordinates.extent_int(1), [&](auto dim_c) {
+        constexpr int DIM = decltype(dim_c)::value;
+        labels = ArborX::dbscan(
+            exec_space,
+            Details::makePointsFromCoordinates<DIM>(exec_space, coordinates),
+            eps, core_min_size, parameters);
+      });
+  ARBORX_ASSERT(supported);
   return labels;
 }
 
+} // namespace Experimental
+
 } // namespace ArborX
 
+#define ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR(EXTERN, ExecutionSpace, Point)      \
+  EXTERN template Kokkos::View<int *, ExecutionSpace::memory_space>            \
+  ArborX::dbscan(ExecutionSpace const &,                                       \
+                 Kokkos::View<Point *, ExecutionSpace::memory_space> const &,  \
+                 float, int, ArborX::DBSCAN::Parameters const &);
+
+#define ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace,   \
+                                                     DIM)                      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR(                                          \
+      EXTERN, ExecutionSpace, ArborX::ExperimentalHyperGeometry::Point<DIM>)
+
+// The runtime dimension entry point and the dimensions it dispatches to
+#define ARBORX_IMPL_INSTANTIATE_DBSCAN(EXTERN, ExecutionSpace)                 \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR(EXTERN, ExecutionSpace, ArborX::Point)    \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 1)      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 2)      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 3)      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 4)      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 5)      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 6)      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 7)      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 8)      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 9)      \
+  ARBORX_IMPL_INSTANTIATE_DBSCAN_FOR_DIMENSION(EXTERN, ExecutionSpace, 10)     \
+  EXTERN template Kokkos::View<int *, ExecutionSpace::memory_space>            \
+  ArborX::Experimental::dbscan(                                                \
+      ExecutionSpace const &,                                                  \
+      Kokkos::View<float **, ExecutionSpace::memory_space> const &, float,     \
+      int, ArborX::DBSCAN::Parameters const &);
+
+#ifdef ARBORX_ENABLE_EXPLICIT_INSTANTIATION
+ARBORX_IMPL_FOR_EACH_EXECUTION_SPACE(ARBORX_IMPL_INSTANTIATE_DBSCAN, extern)
+#endif
+
 #endif
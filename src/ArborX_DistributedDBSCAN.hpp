@@ -0,0 +1,348 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DISTRIBUTED_DBSCAN_HPP
+#define ARBORX_DISTRIBUTED_DBSCAN_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DBSCAN.hpp>
+#include <ArborX_DetailsDistributedTreeImpl.hpp> // sendAcrossNetwork
+#include <ArborX_DetailsDistributor.hpp>
+#include <ArborX_DetailsFDBSCAN.hpp>
+#include <ArborX_DetailsHalfTraversal.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp>
+#include <ArborX_DetailsTreeConstruction.hpp>
+#include <ArborX_DetailsUnionFind.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <climits> // LLONG_MAX
+
+#include <mpi.h>
+
+namespace ArborX
+{
+namespace Details
+{
+
+// Outputs the ranks (other than the current one) whose domain is within eps
+// of a point
+struct DistributedDBSCANHaloCallback
+{
+  int _comm_rank;
+
+  template <typename Predicate, typename Value, typename OutputFunctor>
+  KOKKOS_FUNCTION void operator()(Predicate const &, Value const &value,
+                                  OutputFunctor const &out) const
+  {
+    int const rank = value.index;
+    if (rank != _comm_rank)
+      out(rank);
+  }
+};
+
+} // namespace Details
+
+// Distributed DBSCAN. Each rank provides its share of the points, and gets
+// back the labels of its points. The labels are the global indices of the
+// cluster representatives (or -1 for the noise points), where the points are
+// globally numbered by rank first. As with the DistributedTree, the quality of
+// the spatial partitioning of the points is left to the caller: the closer
+// the partitioning is to a spatial decomposition, the fewer points need to be
+// exchanged.
+//
+// The points within eps of the domain of another rank are sent to that rank
+// as ghosts. Each rank then determines the core points among its own points,
+// exchanges their status with the ghosts, and clusters its own and ghost
+// points locally. Finally, the clusters are merged across ranks by
+// propagating the minimum global index of the core points of each cluster
+// through the ghosts until no label changes.
+template <typename ExecutionSpace, typename Primitives>
+Kokkos::View<long long *,
+             typename AccessTraits<Primitives, PrimitivesTag>::memory_space>
+dbscan(MPI_Comm comm, ExecutionSpace const &exec_space,
+       Primitives const &primitives, float eps, int core_min_size)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DistributedDBSCAN");
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value,
+      "Primitives must be accessible from the execution space");
+
+  using Point = typename Details::AccessTraitsHelper<Access>::type;
+  static_assert(GeometryTraits::is_point<Point>{},
+                "DBSCAN requires primitives to be points");
+  constexpr int dim = GeometryTraits::dimension_v<Point>;
+  using Box = ExperimentalHyperGeometry::Box<dim>;
+
+  ARBORX_ASSERT(eps > 0);
+  ARBORX_ASSERT(core_min_size >= 2);
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = Access::size(primitives);
+
+  // Points are numbered globally by rank first
+  long long global_offset = 0;
+  {
+    long long local_size = n;
+    MPI_Exscan(&local_size, &global_offset, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    if (comm_rank == 0)
+      global_offset = 0;
+  }
+
+  // Find the ranks whose domain is within eps of each point
+  Kokkos::Profiling::pushRegion("ArborX::DistributedDBSCAN::halo");
+  Kokkos::View<int *, MemorySpace> export_ranks(
+      "ArborX::DistributedDBSCAN::export_ranks", 0);
+  Kokkos::View<int *, MemorySpace> export_offsets(
+      "ArborX::DistributedDBSCAN::export_offsets", 0);
+  {
+    Box local_bounds;
+    Details::TreeConstruction::calculateBoundingBoxOfTheScene(
+        exec_space, Details::Indexables<Primitives>{primitives}, local_bounds);
+
+    Kokkos::View<Box *, MemorySpace> rank_bounds(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedDBSCAN::rank_bounding_boxes"),
+        comm_size);
+    auto rank_bounds_host = Kokkos::create_mirror_view(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing), rank_bounds);
+    rank_bounds_host(comm_rank) = local_bounds;
+    MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                  static_cast<void *>(rank_bounds_host.data()), sizeof(Box),
+                  MPI_BYTE, comm);
+    Kokkos::deep_copy(exec_space, rank_bounds, rank_bounds_host);
+
+    BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>>
+        top_tree(exec_space, rank_bounds);
+    top_tree.query(exec_space,
+                   Details::PrimitivesWithRadius<Primitives>{primitives, eps},
+                   Details::DistributedDBSCANHaloCallback{comm_rank},
+                   export_ranks, export_offsets);
+  }
+  int const num_exports = export_ranks.size();
+  Kokkos::View<int *, MemorySpace> export_indices(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedDBSCAN::export_indices"),
+      num_exports);
+  Kokkos::parallel_for(
+      "ArborX::DistributedDBSCAN::fill_export_indices",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        for (int k = export_offsets(i); k < export_offsets(i + 1); ++k)
+          export_indices(k) = i;
+      });
+
+  Details::Distributor<DeviceType> distributor(comm);
+  int const num_ghosts = distributor.createFromSends(exec_space, export_ranks);
+
+  // Gather the local points followed by the ghost points
+  Kokkos::View<Point *, MemorySpace> points(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedDBSCAN::points"),
+      n + num_ghosts);
+  Kokkos::View<long long *, MemorySpace> global_labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedDBSCAN::labels"),
+      n + num_ghosts);
+  Kokkos::parallel_for(
+      "ArborX::DistributedDBSCAN::copy_local_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        points(i) = Access::get(primitives, i);
+        global_labels(i) = global_offset + i;
+      });
+  {
+    Kokkos::View<Point *, MemorySpace> export_points(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedDBSCAN::export_points"),
+        num_exports);
+    Kokkos::View<long long *, MemorySpace> export_global_indices(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedDBSCAN::export_global_indices"),
+        num_exports);
+    Kokkos::parallel_for(
+        "ArborX::DistributedDBSCAN::fill_export_points",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_exports),
+        KOKKOS_LAMBDA(int k) {
+          export_points(k) = Access::get(primitives, export_indices(k));
+          export_global_indices(k) = global_offset + export_indices(k);
+        });
+
+    Kokkos::View<Point *, MemorySpace> ghost_points(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedDBSCAN::ghost_points"),
+        num_ghosts);
+    Kokkos::View<long long *, MemorySpace> ghost_global_indices(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedDBSCAN::ghost_global_indices"),
+        num_ghosts);
+    Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+        exec_space, distributor, export_points, ghost_points);
+    Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+        exec_space, distributor, export_global_indices, ghost_global_indices);
+    Kokkos::deep_copy(
+        exec_space,
+        Kokkos::subview(points, Kokkos::make_pair(n, n + num_ghosts)),
+        ghost_points);
+    Kokkos::deep_copy(
+        exec_space,
+        Kokkos::subview(global_labels, Kokkos::make_pair(n, n + num_ghosts)),
+        ghost_global_indices);
+  }
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::Profiling::pushRegion("ArborX::DistributedDBSCAN::tree_construction");
+  BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>> bvh(
+      exec_space, points);
+  Kokkos::Profiling::popRegion();
+
+  // Determine the local core points, whose neighbors are all either local or
+  // ghost points, and get the status of the ghost points from their owners
+  Kokkos::Profiling::pushRegion("ArborX::DistributedDBSCAN::num_neigh");
+  Kokkos::View<int *, MemorySpace> num_neigh(
+      "ArborX::DistributedDBSCAN::num_neighbors", n + num_ghosts);
+  bvh.query(exec_space,
+            Details::PrimitivesWithRadius<Primitives>{primitives, eps},
+            Details::CountUpToN<MemorySpace>{num_neigh, core_min_size});
+  {
+    Kokkos::View<int *, MemorySpace> export_num_neigh(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedDBSCAN::export_num_neighbors"),
+        num_exports);
+    Kokkos::parallel_for(
+        "ArborX::DistributedDBSCAN::fill_export_num_neighbors",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_exports),
+        KOKKOS_LAMBDA(int k) {
+          export_num_neigh(k) = num_neigh(export_indices(k));
+        });
+    Kokkos::View<int *, MemorySpace> ghost_num_neigh(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedDBSCAN::ghost_num_neighbors"),
+        num_ghosts);
+    Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+        exec_space, distributor, export_num_neigh, ghost_num_neigh);
+    Kokkos::deep_copy(
+        exec_space,
+        Kokkos::subview(num_neigh, Kokkos::make_pair(n, n + num_ghosts)),
+        ghost_num_neigh);
+  }
+  Kokkos::Profiling::popRegion();
+
+  // Cluster the local and ghost points
+  Kokkos::Profiling::pushRegion("ArborX::DistributedDBSCAN::local_clusters");
+#ifdef KOKKOS_ENABLE_SERIAL
+  using UnionFind = Details::UnionFind<
+      MemorySpace,
+      /*DoSerial=*/std::is_same_v<ExecutionSpace, Kokkos::Serial>>;
+#else
+  using UnionFind = Details::UnionFind<MemorySpace>;
+#endif
+  using CorePoints = Details::DBSCANCorePoints<MemorySpace>;
+  CorePoints const is_core{num_neigh, core_min_size};
+
+  Kokkos::View<int *, MemorySpace> local_labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedDBSCAN::local_labels"),
+      n + num_ghosts);
+  ArborX::iota(exec_space, local_labels);
+#if defined(KOKKOS_COMPILER_NVCC) && (KOKKOS_COMPILER_NVCC < 1140)
+  // Workaround a compiler bug
+  using HalfTraversal = Details::HalfTraversal<
+      decltype(bvh), Details::FDBSCANCallback<UnionFind, CorePoints>,
+      Details::WithinRadiusGetter>;
+#else
+  using Details::HalfTraversal;
+#endif
+  HalfTraversal(exec_space, bvh,
+                Details::FDBSCANCallback<UnionFind, CorePoints>{local_labels,
+                                                                is_core},
+                Details::WithinRadiusGetter{eps});
+  Details::finalizeLabels(exec_space, local_labels, is_core);
+  Kokkos::Profiling::popRegion();
+
+  // Merge the clusters across ranks
+  Kokkos::Profiling::pushRegion("ArborX::DistributedDBSCAN::merge_clusters");
+  Kokkos::View<long long *, MemorySpace> cluster_labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedDBSCAN::cluster_labels"),
+      n + num_ghosts);
+  Kokkos::View<long long *, MemorySpace> export_labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedDBSCAN::export_labels"),
+      num_exports);
+  Kokkos::View<long long *, MemorySpace> ghost_labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedDBSCAN::ghost_labels"),
+      num_ghosts);
+  while (true)
+  {
+    // The label of a local cluster is the smallest label of its core points
+    Kokkos::deep_copy(exec_space, cluster_labels, LLONG_MAX);
+    Kokkos::parallel_for(
+        "ArborX::DistributedDBSCAN::reduce_cluster_labels",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n + num_ghosts),
+        KOKKOS_LAMBDA(int i) {
+          if (is_core(i))
+            Kokkos::atomic_min(&cluster_labels(local_labels(i)),
+                               global_labels(i));
+        });
+    int num_changed;
+    Kokkos::parallel_reduce(
+        "ArborX::DistributedDBSCAN::update_labels",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+        KOKKOS_LAMBDA(int i, int &update) {
+          long long const label =
+              (local_labels(i) == -1 ? -1 : cluster_labels(local_labels(i)));
+          if (label != global_labels(i))
+          {
+            global_labels(i) = label;
+            ++update;
+          }
+        },
+        num_changed);
+    MPI_Allreduce(MPI_IN_PLACE, &num_changed, 1, MPI_INT, MPI_SUM, comm);
+    if (num_changed == 0)
+      break;
+
+    Kokkos::parallel_for(
+        "ArborX::DistributedDBSCAN::fill_export_labels",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_exports),
+        KOKKOS_LAMBDA(int k) {
+          export_labels(k) = global_labels(export_indices(k));
+        });
+    Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+        exec_space, distributor, export_labels, ghost_labels);
+    Kokkos::deep_copy(
+        exec_space,
+        Kokkos::subview(global_labels, Kokkos::make_pair(n, n + num_ghosts)),
+        ghost_labels);
+  }
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::resize(Kokkos::view_alloc(exec_space), global_labels, n);
+  return global_labels;
+}
+
+} // namespace ArborX
+
+#endif
@@ -0,0 +1,1167 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DISTRIBUTED_HDBSCAN_HPP
+#define ARBORX_DISTRIBUTED_HDBSCAN_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Dendrogram.hpp>
+#include <ArborX_DetailsDendrogram.hpp>
+#include <ArborX_DetailsDistributedTreeImpl.hpp> // forwardQueries
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtSort.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp>
+#include <ArborX_DetailsSortUtils.hpp>
+#include <ArborX_DetailsTreeNodeLabeling.hpp>
+#include <ArborX_DetailsUnionFind.hpp>
+#include <ArborX_DetailsUtils.hpp> // iota
+#include <ArborX_DetailsWeightedEdge.hpp>
+#include <ArborX_DistributedDBSCAN.hpp> // DistributedDBSCANHaloCallback
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_HyperSphere.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_MinimumSpanningTree.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <climits> // INT_MAX
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+namespace ArborX::Details
+{
+
+// Query sent to the other ranks for the shortest edge from a point to the
+// points of the other components, no longer than the radius
+template <int DIM>
+struct DistributedMSTQuery
+{
+  ExperimentalHyperGeometry::Point<DIM> point;
+  float core_distance;
+  float radius;
+  int index; // global index of the point
+  int label; // label of the component of the point
+};
+
+template <class Queries>
+struct DistributedMSTSearchSpheres
+{
+  Queries _queries;
+};
+
+// Shortest known edge leaving a component, along with the label of the
+// component it leads to
+struct ComponentOutEdge
+{
+  DirectedEdge edge;
+  int source_label = -1;
+  int target_label = -1;
+};
+
+} // namespace ArborX::Details
+
+namespace ArborX
+{
+
+template <class Queries>
+struct AccessTraits<Details::DistributedMSTSearchSpheres<Queries>,
+                    PredicatesTag>
+{
+  using memory_space = typename Queries::memory_space;
+  using Predicates = Details::DistributedMSTSearchSpheres<Queries>;
+
+  static KOKKOS_FUNCTION size_t size(Predicates const &w)
+  {
+    return w._queries.size();
+  }
+  static KOKKOS_FUNCTION auto get(Predicates const &w, size_t i)
+  {
+    auto const &query = w._queries(i);
+    constexpr int dim =
+        GeometryTraits::dimension_v<std::decay_t<decltype(query.point)>>;
+    return intersects(
+        ExperimentalHyperGeometry::Sphere<dim>{query.point, query.radius});
+  }
+};
+
+} // namespace ArborX
+
+namespace ArborX::Details
+{
+
+// Distance from each point to the nearest domain of another rank
+template <class Primitives, class Distances>
+struct DistanceToOtherRanks
+{
+  Primitives _primitives;
+  Distances _distances;
+  int _comm_rank;
+
+  template <class Predicate, class Value>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate,
+                                  Value const &value) const
+  {
+    if ((int)value.index == _comm_rank)
+      return;
+
+    using Access = AccessTraits<Primitives, PrimitivesTag>;
+    using KokkosExt::min;
+    int const i = getData(predicate);
+    // NOTE using knowledge that each nearest predicate traversal is performed
+    // by a single thread.
+    _distances(i) = min(_distances(i), distance(Access::get(_primitives, i),
+                                                value.bounding_volume));
+  }
+};
+
+// Outputs the distances to the found neighbors
+struct NeighborDistanceCallback
+{
+  template <class Predicate, class Value, class OutputFunctor>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate,
+                                  Value const &value,
+                                  OutputFunctor const &out) const
+  {
+    out(distance(getGeometry(predicate), value.bounding_volume));
+  }
+};
+
+// For each query received from another rank, find the shortest edge between
+// the query point and the local points of the other components, no longer
+// than the query radius. The internal nodes of the hierarchy are labeled with
+// the common label of their leaves (if any), so that the subtrees of the
+// query component are skipped altogether.
+template <class BVH, class Labels, class CoreDistances, class Queries,
+          class OutEdges>
+struct FindRemoteComponentNearestNeighbors
+{
+  BVH _bvh;
+  Labels _labels;
+  CoreDistances _core_distances;
+  int _global_offset;
+  Queries _queries;
+  OutEdges _out_edges;
+
+  KOKKOS_FUNCTION void operator()(int q) const
+  {
+    auto const &query = _queries(q);
+
+    ComponentOutEdge best{DirectedEdge{}, query.label, -1};
+    float radius = query.radius;
+
+    auto const visit_leaf = [&](int leaf, float distance_leaf) {
+      using KokkosExt::max;
+      int const j = HappyTreeFriends::getValue(_bvh, leaf).index;
+      float weight = distance_leaf;
+      if (_core_distances.size() > 0)
+        weight = max(weight, max(query.core_distance, _core_distances(j)));
+      DirectedEdge const candidate{query.index, _global_offset + j, weight};
+      if (weight <= radius && candidate < best.edge)
+      {
+        best.edge = candidate;
+        best.target_label = _labels(leaf);
+        radius = weight;
+      }
+    };
+
+    int const n = _bvh.size();
+    if (n == 1)
+    {
+      if (_labels(0) != query.label)
+        visit_leaf(
+            0, distance(query.point, HappyTreeFriends::getIndexable(_bvh, 0)));
+    }
+    else if (n > 1)
+    {
+      // Note it is <= instead of < when comparing with the radius, so that
+      // equidistant points are resolved uniquely, as in Boruvka
+      int stack[64];
+      auto *stack_ptr = stack;
+      *stack_ptr++ = HappyTreeFriends::getRoot(_bvh);
+      while (stack_ptr != stack)
+      {
+        int const node = *--stack_ptr;
+        if (_labels(node) == query.label)
+          continue;
+
+        if (HappyTreeFriends::isLeaf(_bvh, node))
+        {
+          float const distance_leaf = distance(
+              query.point, HappyTreeFriends::getIndexable(_bvh, node));
+          if (distance_leaf <= radius)
+            visit_leaf(node, distance_leaf);
+        }
+        else if (distance(query.point,
+                          HappyTreeFriends::getInternalBoundingVolume(
+                              _bvh, node)) <= radius)
+        {
+          *stack_ptr++ = HappyTreeFriends::getRightChild(_bvh, node);
+          *stack_ptr++ = HappyTreeFriends::getLeftChild(_bvh, node);
+        }
+      }
+    }
+
+    _out_edges(q) = best;
+  }
+};
+
+// Position of the label in the sorted labels of the components
+template <class ComponentLabels>
+KOKKOS_FUNCTION int findComponent(ComponentLabels const &component_labels,
+                                  int label)
+{
+  int first = 0;
+  int last = component_labels.size();
+  while (first < last)
+  {
+    int const middle = first + (last - first) / 2;
+    if (component_labels(middle) < label)
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  return first;
+}
+
+// Distances of the local points to their k-th nearest neighbors among the
+// points of all ranks, themselves included. A point is only sent to the ranks
+// whose domain is closer than its k-th nearest local neighbor, which then
+// return the distances to their k nearest points.
+template <class ExecutionSpace, class BVH, class TopTree, class Primitives>
+Kokkos::View<float *, typename BVH::memory_space>
+computeDistributedCoreDistances(MPI_Comm comm, ExecutionSpace const &space,
+                                BVH const &bvh, TopTree const &top_tree,
+                                Primitives const &primitives, int k)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedMST::compute_core_distances");
+
+  using MemorySpace = typename BVH::memory_space;
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  constexpr int dim = GeometryTraits::dimension_v<
+      typename Details::AccessTraitsHelper<Access>::type>;
+  constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+
+  int const n = bvh.size();
+
+  // Sorted distances to the k nearest local points, the missing ones being
+  // infinitely far
+  Kokkos::View<float **, MemorySpace> neighbor_distances(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::neighbor_distances"),
+      n, k);
+  KthNearestNeighborDistances(space, bvh, k, neighbor_distances);
+
+  Kokkos::View<DistributedMSTQuery<dim> *, MemorySpace> queries(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::core_distances_queries"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::DistributedMST::fill_core_distances_queries",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        for (int j = n; j < k; ++j)
+          neighbor_distances(i, j) = inf;
+        // FIXME reinterpret_cast is dangerous here if access traits return
+        // user point structure (e.g., struct MyPoint { float y; float x; })
+        auto const &point = Access::get(primitives, i);
+        queries(i) = {
+            reinterpret_cast<ExperimentalHyperGeometry::Point<dim> const &>(
+                point),
+            0.f, neighbor_distances(i, k - 1), 0, 0};
+      });
+
+  Kokkos::View<int *, DeviceType> ranks(
+      "ArborX::DistributedMST::core_distances_ranks", 0);
+  Kokkos::View<int *, DeviceType> offsets(
+      "ArborX::DistributedMST::core_distances_offsets", 0);
+  top_tree.query(space, DistributedMSTSearchSpheres<decltype(queries)>{queries},
+                 DistributedDBSCANHaloCallback{comm_rank}, ranks, offsets);
+
+  using Predicates = NearestK<Primitives>;
+  using Query = typename AccessTraitsHelper<
+      AccessTraits<Predicates, PredicatesTag>>::type;
+  Kokkos::View<Query *, DeviceType> fwd_queries(
+      "ArborX::DistributedMST::core_distances_fwd_queries", 0);
+  Kokkos::View<int *, DeviceType> ids(
+      "ArborX::DistributedMST::core_distances_query_ids", 0);
+  Kokkos::View<int *, DeviceType> fwd_ranks(
+      "ArborX::DistributedMST::core_distances_fwd_ranks", 0);
+  DistributedTreeImpl<DeviceType>::forwardQueries(
+      comm, space, Predicates{primitives, k}, ranks, offsets, fwd_queries, ids,
+      fwd_ranks);
+
+  Kokkos::View<float *, DeviceType> distances(
+      "ArborX::DistributedMST::remote_neighbor_distances", 0);
+  bvh.query(space, fwd_queries, NeighborDistanceCallback{}, distances, offsets);
+
+  DistributedTreeImpl<DeviceType>::communicateResultsBack(
+      comm, space, distances, offsets, fwd_ranks, ids);
+  DistributedTreeImpl<DeviceType>::countResults(space, n, ids, offsets);
+  DistributedTreeImpl<DeviceType>::sortResults(space, ids, distances);
+
+  // Insert the remote distances into the sorted local ones
+  Kokkos::View<float *, MemorySpace> core_distances(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::core_distances"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::DistributedMST::merge_neighbor_distances",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        for (int r = offsets(i); r < offsets(i + 1); ++r)
+        {
+          float const d = distances(r);
+          int j = k - 1;
+          if (!(d < neighbor_distances(i, j)))
+            continue;
+          for (; j > 0 && neighbor_distances(i, j - 1) > d; --j)
+            neighbor_distances(i, j) = neighbor_distances(i, j - 1);
+          neighbor_distances(i, j) = d;
+        }
+        core_distances(i) = neighbor_distances(i, k - 1);
+      });
+
+  return core_distances;
+}
+
+// Lower bounds of the weights of the edges between each local point and the
+// points of the other ranks: the distance to the nearest domain of another
+// rank, or the core distance if larger
+template <class ExecutionSpace, class TopTree, class Primitives,
+          class CoreDistances>
+Kokkos::View<float *, typename CoreDistances::memory_space>
+computeRemoteLowerBounds(int comm_rank, ExecutionSpace const &space,
+                         TopTree const &top_tree, Primitives const &primitives,
+                         CoreDistances const &core_distances)
+{
+  using MemorySpace = typename CoreDistances::memory_space;
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
+
+  int const n = Access::size(primitives);
+
+  Kokkos::View<float *, MemorySpace> remote_bounds(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::remote_lower_bounds"),
+      n);
+  Kokkos::deep_copy(space, remote_bounds, inf);
+  // The own domain of the rank contains the point, so that the other nearest
+  // one is the nearest domain of another rank
+  top_tree.query(
+      space, NearestK<Primitives>{primitives, 2},
+      DistanceToOtherRanks<Primitives, decltype(remote_bounds)>{
+          primitives, remote_bounds, comm_rank});
+  if (core_distances.size() > 0)
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::bound_remote_weights",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+        KOKKOS_LAMBDA(int i) {
+          using KokkosExt::max;
+          remote_bounds(i) = max(remote_bounds(i), core_distances(i));
+        });
+
+  return remote_bounds;
+}
+
+// Find the edges of the local minimum spanning tree that are part of the
+// global one. In the dendrogram of the local tree, an edge is the shortest
+// local edge leaving each of the two subtrees it joins. If it is also shorter
+// than the lower bound of the weights of the edges between one of the
+// subtrees and the other ranks, it is the shortest edge leaving that subtree
+// altogether. The certified edges are stored into edges with global indices,
+// and the local points are labeled with the smallest global index of their
+// component in the forest the certified edges form. Returns the number of
+// certified edges.
+template <class ExecutionSpace, class LocalEdges, class RemoteLowerBounds,
+          class Edges, class Labels>
+int certifyLocalEdges(ExecutionSpace const &space,
+                      LocalEdges const &local_edges,
+                      RemoteLowerBounds const &remote_bounds, int global_offset,
+                      Edges const &edges, Labels const &labels)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedMST::certify_local_edges");
+
+  using MemorySpace = typename Labels::memory_space;
+
+  int const n = labels.size();
+  int const num_edges = local_edges.size();
+
+  Kokkos::View<int *, MemorySpace> union_find_labels(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::union_find_labels"),
+      n);
+  iota(space, union_find_labels);
+  UnionFind<MemorySpace> union_find(union_find_labels);
+
+  Kokkos::View<int, MemorySpace> num_certified_edges(
+      Kokkos::view_alloc(space, "ArborX::DistributedMST::num_certified_edges"));
+  if (num_edges > 0)
+  {
+    Kokkos::View<float *, MemorySpace> weights(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::weights"),
+        num_edges);
+    Kokkos::View<UnweightedEdge *, MemorySpace> sorted_edges(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::sorted_edges"),
+        num_edges);
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::split_edges",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_edges),
+        KOKKOS_LAMBDA(int e) {
+          weights(e) = local_edges(e).weight;
+          sorted_edges(e) = {local_edges(e).source, local_edges(e).target};
+        });
+    KokkosExt::sortByKey(space, weights, sorted_edges);
+
+    Kokkos::View<int *, MemorySpace> parents(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::dendrogram_parents"),
+        num_edges + n);
+    dendrogramParallelUnionFind(
+        space, Kokkos::View<UnweightedEdge const *, MemorySpace>(sorted_edges),
+        parents);
+
+    // The first thread to reach an edge leaves the bound of its subtree for
+    // the second one, which processes the edge
+    constexpr float UNDEFINED = -1;
+    Kokkos::View<float *, MemorySpace> child_bounds(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::child_bounds"),
+        num_edges);
+    Kokkos::deep_copy(space, child_bounds, UNDEFINED);
+    Kokkos::View<bool *, MemorySpace> certified(
+        Kokkos::view_alloc(space, "ArborX::DistributedMST::certified"),
+        num_edges);
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::bound_subtrees",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          using KokkosExt::max;
+          using KokkosExt::min;
+          int node = num_edges + i;
+          float bound = remote_bounds(i);
+          while (true)
+          {
+            int const e = parents(node);
+            if (e == -1)
+              break;
+
+            float const other_bound =
+                Kokkos::atomic_exchange(&child_bounds(e), bound);
+            if (other_bound == UNDEFINED)
+              break;
+
+            certified(e) = (weights(e) < max(bound, other_bound));
+            bound = min(bound, other_bound);
+            node = e;
+          }
+        });
+
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::merge_certified_edges",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_edges),
+        KOKKOS_LAMBDA(int e) {
+          if (!certified(e))
+            return;
+          auto const &edge = sorted_edges(e);
+          union_find.merge(edge.source, edge.target);
+          edges(Kokkos::atomic_fetch_inc(&num_certified_edges())) = {
+              global_offset + edge.source, global_offset + edge.target,
+              weights(e)};
+        });
+  }
+
+  // The representatives are the smallest indices of the sets
+  Kokkos::parallel_for(
+      "ArborX::DistributedMST::initialize_labels",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        labels(i) = global_offset + union_find.representative(i);
+      });
+
+  int num_certified_edges_host;
+  Kokkos::deep_copy(space, num_certified_edges_host, num_certified_edges);
+  space.fence();
+  return num_certified_edges_host;
+}
+
+// Send the queries to the other ranks whose domain is within their radius,
+// and receive the shortest edges they found
+template <class ExecutionSpace, class BVH, class TopTree, class NodeLabels,
+          class CoreDistances, class Queries>
+Kokkos::View<ComponentOutEdge *, typename BVH::memory_space>
+findRemoteComponentOutEdges(MPI_Comm comm, ExecutionSpace const &space,
+                            BVH const &bvh, TopTree const &top_tree,
+                            NodeLabels const &node_labels,
+                            CoreDistances const &core_distances,
+                            int global_offset, Queries const &queries)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedMST::find_remote_component_out_edges");
+
+  using MemorySpace = typename BVH::memory_space;
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+  using Query = typename Queries::non_const_value_type;
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+
+  Kokkos::View<int *, DeviceType> ranks("ArborX::DistributedMST::query_ranks",
+                                        0);
+  Kokkos::View<int *, DeviceType> offsets(
+      "ArborX::DistributedMST::query_offsets", 0);
+  top_tree.query(space, DistributedMSTSearchSpheres<Queries>{queries},
+                 DistributedDBSCANHaloCallback{comm_rank}, ranks, offsets);
+
+  Kokkos::View<Query *, DeviceType> fwd_queries(
+      "ArborX::DistributedMST::fwd_queries", 0);
+  Kokkos::View<int *, DeviceType> ids("ArborX::DistributedMST::query_ids", 0);
+  Kokkos::View<int *, DeviceType> fwd_ranks("ArborX::DistributedMST::fwd_ranks",
+                                            0);
+  DistributedTreeImpl<DeviceType>::forwardQueries(
+      comm, space, queries, ranks, offsets, fwd_queries, ids, fwd_ranks);
+
+  int const num_fwd_queries = fwd_queries.size();
+  Kokkos::View<ComponentOutEdge *, DeviceType> out_edges(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::remote_out_edges"),
+      num_fwd_queries);
+  Kokkos::parallel_for(
+      "ArborX::DistributedMST::find_remote_component_nearest_neighbors",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_fwd_queries),
+      FindRemoteComponentNearestNeighbors<BVH, NodeLabels, CoreDistances,
+                                          decltype(fwd_queries),
+                                          decltype(out_edges)>{
+          bvh, node_labels, core_distances, global_offset, fwd_queries,
+          out_edges});
+
+  // Every forwarded query is answered with a single edge
+  KokkosExt::reallocWithoutInitializing(space, offsets, num_fwd_queries + 1);
+  iota(space, offsets);
+  DistributedTreeImpl<DeviceType>::communicateResultsBack(
+      comm, space, out_edges, offsets, fwd_ranks, ids);
+
+  return out_edges;
+}
+
+template <class ExecutionSpace, class ComponentLabels, class Candidates,
+          class Weights>
+void reduceComponentOutWeights(ExecutionSpace const &space,
+                               ComponentLabels const &component_labels,
+                               Candidates const &candidates,
+                               Weights const &weights)
+{
+  constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
+  Kokkos::parallel_for(
+      "ArborX::DistributedMST::reduce_component_out_weights",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, candidates.size()),
+      KOKKOS_LAMBDA(int k) {
+        auto const &candidate = candidates(k);
+        if (candidate.edge.weight == inf)
+          return;
+        int const c = findComponent(component_labels, candidate.source_label);
+        Kokkos::atomic_min(&weights(c), candidate.edge.weight);
+      });
+}
+
+// For every local component, select the shortest of the candidate edges
+// leaving it, ties being broken as in DirectedEdge. The weights must already
+// be reduced over all the candidates.
+template <class ExecutionSpace, class ComponentLabels, class Weights,
+          class Candidates>
+auto selectComponentOutEdges(ExecutionSpace const &space,
+                             ComponentLabels const &component_labels,
+                             Weights const &weights,
+                             std::vector<Candidates> const &all_candidates)
+{
+  using MemorySpace = typename ComponentLabels::memory_space;
+
+  int const num_components = component_labels.size();
+
+  Kokkos::View<unsigned long long *, MemorySpace> keys(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::component_out_keys"),
+      num_components);
+  Kokkos::deep_copy(space, keys, ULLONG_MAX);
+  for (auto const &candidates : all_candidates)
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::reduce_component_out_keys",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, candidates.size()),
+        KOKKOS_LAMBDA(int k) {
+          auto const &candidate = candidates(k);
+          if (candidate.source_label == -1)
+            return;
+          int const c = findComponent(component_labels, candidate.source_label);
+          if (candidate.edge.weight == weights(c))
+            Kokkos::atomic_min(&keys(c), candidate.edge.directed_edge);
+        });
+
+  Kokkos::View<ComponentOutEdge *, MemorySpace> out_edges(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::component_out_edges"),
+      num_components);
+  Kokkos::parallel_for(
+      "ArborX::DistributedMST::initialize_component_out_edges",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_components),
+      KOKKOS_LAMBDA(int c) {
+        out_edges(c) = {DirectedEdge{}, component_labels(c), -1};
+      });
+  for (auto const &candidates : all_candidates)
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::assign_component_out_edges",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, candidates.size()),
+        KOKKOS_LAMBDA(int k) {
+          auto const &candidate = candidates(k);
+          if (candidate.source_label == -1)
+            return;
+          int const c = findComponent(component_labels, candidate.source_label);
+          if (candidate.edge.weight == weights(c) &&
+              candidate.edge.directed_edge == keys(c))
+            out_edges(c) = candidate;
+        });
+
+  return out_edges;
+}
+
+// Boruvka iterations over the components spanning several ranks. The
+// shortest edge leaving a component is either a local edge, in which case it
+// is also the shortest edge between the local points of the component and
+// the other local points, and thus an edge of the local tree, or an edge with
+// a point of another rank. The latter is searched for from the local points
+// whose lower bound on such edges does not exceed the shortest local edge. A
+// first search from the point of each component with the smallest lower bound
+// tightens the radius of the second one over all the points. The shortest
+// edges of the local components of all the ranks are then gathered, so that
+// every rank merges the components the same way. Returns the edges added to
+// the tree, which are known to all ranks.
+template <class ExecutionSpace, class BVH, class TopTree, class Primitives,
+          class CoreDistances, class LocalEdges, class RemoteLowerBounds,
+          class Labels>
+std::vector<WeightedEdge>
+distributedBoruvka(MPI_Comm comm, ExecutionSpace const &space, BVH const &bvh,
+                   TopTree const &top_tree, Primitives const &primitives,
+                   CoreDistances const &core_distances,
+                   LocalEdges const &local_edges,
+                   RemoteLowerBounds const &remote_bounds, int global_offset,
+                   Labels const &labels)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DistributedMST::boruvka");
+
+  using MemorySpace = typename BVH::memory_space;
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  constexpr int dim = GeometryTraits::dimension_v<
+      typename Details::AccessTraitsHelper<Access>::type>;
+  using Query = DistributedMSTQuery<dim>;
+  using Candidates = Kokkos::View<ComponentOutEdge *, MemorySpace>;
+  constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
+
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = bvh.size();
+  int const num_local_edges = local_edges.size();
+
+  Kokkos::View<int *, MemorySpace> tree_parents(
+      "ArborX::DistributedMST::tree_parents", 0);
+  if (n > 1)
+  {
+    KokkosExt::reallocWithoutInitializing(space, tree_parents, 2 * n - 1);
+    findParents(space, bvh, tree_parents);
+  }
+  Kokkos::View<int *, MemorySpace> node_labels(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::node_labels"),
+      (n > 0 ? 2 * n - 1 : 0));
+  Kokkos::View<int *, MemorySpace> components(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedMST::components"),
+      n);
+
+  auto const make_query = KOKKOS_LAMBDA(int i, float radius)
+  {
+    // FIXME reinterpret_cast is dangerous here if access traits return user
+    // point structure (e.g., struct MyPoint { float y; float x; })
+    auto const &point = Access::get(primitives, i);
+    return Query{
+        reinterpret_cast<ExperimentalHyperGeometry::Point<dim> const &>(point),
+        (core_distances.size() > 0 ? core_distances(i) : 0.f), radius,
+        global_offset + i, labels(i)};
+  };
+
+  std::vector<WeightedEdge> edges;
+  int iterations = 0;
+  while (true)
+  {
+    Kokkos::Profiling::pushRegion("ArborX::DistributedMST::Boruvka_" +
+                                  std::to_string(++iterations));
+
+    // Number the components of the local points in the order of their labels
+    auto sorted_labels = KokkosExt::clone(space, labels);
+    sortObjects(space, sorted_labels);
+    Kokkos::View<int *, MemorySpace> component_labels(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::component_labels"),
+        n);
+    int num_components;
+    Kokkos::parallel_scan(
+        "ArborX::DistributedMST::number_components",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+        KOKKOS_LAMBDA(int i, int &update, bool final_pass) {
+          if (i > 0 && sorted_labels(i) == sorted_labels(i - 1))
+            return;
+          if (final_pass)
+            component_labels(update) = sorted_labels(i);
+          ++update;
+        },
+        num_components);
+    Kokkos::resize(Kokkos::view_alloc(space), component_labels,
+                   num_components);
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::find_components",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          components(i) = findComponent(component_labels, labels(i));
+        });
+
+    if (n > 0)
+    {
+      Kokkos::parallel_for(
+          "ArborX::DistributedMST::initialize_node_labels",
+          Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+          KOKKOS_LAMBDA(int j) {
+            node_labels(j) = labels(HappyTreeFriends::getValue(bvh, j).index);
+          });
+      if (n > 1)
+        reduceLabels(space, tree_parents, node_labels);
+    }
+
+    // Edges of the local tree between different components, in both
+    // directions
+    Candidates local_candidates(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::local_candidates"),
+        2 * num_local_edges);
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::find_local_candidates",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_local_edges),
+        KOKKOS_LAMBDA(int e) {
+          auto const &edge = local_edges(e);
+          int const source_label = labels(edge.source);
+          int const target_label = labels(edge.target);
+          if (source_label == target_label)
+          {
+            local_candidates(2 * e) = {};
+            local_candidates(2 * e + 1) = {};
+            return;
+          }
+          int const source = global_offset + edge.source;
+          int const target = global_offset + edge.target;
+          local_candidates(2 * e) = {DirectedEdge{source, target, edge.weight},
+                                     source_label, target_label};
+          local_candidates(2 * e + 1) = {
+              DirectedEdge{target, source, edge.weight}, target_label,
+              source_label};
+        });
+
+    Kokkos::View<float *, MemorySpace> weights(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::weights"),
+        num_components);
+    Kokkos::deep_copy(space, weights, inf);
+    reduceComponentOutWeights(space, component_labels, local_candidates,
+                              weights);
+
+    // Search from the point of each component with the smallest lower bound
+    Kokkos::View<float *, MemorySpace> min_bounds(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::min_remote_lower_bounds"),
+        num_components);
+    Kokkos::deep_copy(space, min_bounds, inf);
+    Kokkos::View<int *, MemorySpace> representatives(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::representatives"),
+        num_components);
+    Kokkos::deep_copy(space, representatives, INT_MAX);
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::reduce_remote_lower_bounds",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          int const c = components(i);
+          if (remote_bounds(i) < inf && remote_bounds(i) <= weights(c))
+            Kokkos::atomic_min(&min_bounds(c), remote_bounds(i));
+        });
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::find_representatives",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          int const c = components(i);
+          if (remote_bounds(i) < inf && remote_bounds(i) == min_bounds(c))
+            Kokkos::atomic_min(&representatives(c), i);
+        });
+
+    Kokkos::View<Query *, MemorySpace> queries(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::queries"),
+        num_components);
+    int num_queries;
+    Kokkos::parallel_scan(
+        "ArborX::DistributedMST::fill_representative_queries",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_components),
+        KOKKOS_LAMBDA(int c, int &update, bool final_pass) {
+          if (representatives(c) == INT_MAX)
+            return;
+          if (final_pass)
+            queries(update) = make_query(representatives(c), weights(c));
+          ++update;
+        },
+        num_queries);
+    Kokkos::resize(Kokkos::view_alloc(space), queries, num_queries);
+    Candidates representative_candidates = findRemoteComponentOutEdges(
+        comm, space, bvh, top_tree, node_labels, core_distances, global_offset,
+        queries);
+    reduceComponentOutWeights(space, component_labels,
+                              representative_candidates, weights);
+
+    // Search from all the other points that may still be closer
+    KokkosExt::reallocWithoutInitializing(space, queries, n);
+    Kokkos::parallel_scan(
+        "ArborX::DistributedMST::fill_queries",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+        KOKKOS_LAMBDA(int i, int &update, bool final_pass) {
+          int const c = components(i);
+          if (i == representatives(c) || !(remote_bounds(i) < inf) ||
+              !(remote_bounds(i) <= weights(c)))
+            return;
+          if (final_pass)
+            queries(update) = make_query(i, weights(c));
+          ++update;
+        },
+        num_queries);
+    Kokkos::resize(Kokkos::view_alloc(space), queries, num_queries);
+    Candidates remote_candidates = findRemoteComponentOutEdges(
+        comm, space, bvh, top_tree, node_labels, core_distances, global_offset,
+        queries);
+    reduceComponentOutWeights(space, component_labels, remote_candidates,
+                              weights);
+
+    auto const out_edges = selectComponentOutEdges(
+        space, component_labels, weights,
+        std::vector<Candidates>{local_candidates, representative_candidates,
+                                remote_candidates});
+
+    // Gather the shortest edges of the local components of all ranks
+    auto const out_edges_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, out_edges);
+    std::vector<int> counts(comm_size);
+    int const num_bytes = num_components * sizeof(ComponentOutEdge);
+    MPI_Allgather(&num_bytes, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    std::vector<int> displs(comm_size + 1, 0);
+    std::partial_sum(counts.begin(), counts.end(), displs.begin() + 1);
+    std::vector<ComponentOutEdge> all_out_edges(displs[comm_size] /
+                                                sizeof(ComponentOutEdge));
+    MPI_Allgatherv(out_edges_host.data(), num_bytes, MPI_BYTE,
+                   all_out_edges.data(), counts.data(), displs.data(),
+                   MPI_BYTE, comm);
+
+    // Keep the shortest edge of each component
+    std::sort(all_out_edges.begin(), all_out_edges.end(),
+              [](ComponentOutEdge const &a, ComponentOutEdge const &b) {
+                return (a.source_label != b.source_label
+                            ? a.source_label < b.source_label
+                            : a.edge < b.edge);
+              });
+    std::vector<ComponentOutEdge> shortest_edges;
+    for (auto const &out_edge : all_out_edges)
+      if (shortest_edges.empty() ||
+          shortest_edges.back().source_label != out_edge.source_label)
+        shortest_edges.push_back(out_edge);
+
+    int const num_global_components = shortest_edges.size();
+    if (num_global_components <= 1)
+    {
+      Kokkos::Profiling::popRegion();
+      break;
+    }
+
+    // Merge the components, skipping the edges selected by both of their
+    // components. The set representatives are the components with the
+    // smallest labels.
+    auto const find_component = [&shortest_edges](int label) {
+      return std::lower_bound(shortest_edges.begin(), shortest_edges.end(),
+                              label,
+                              [](ComponentOutEdge const &out_edge, int l) {
+                                return out_edge.source_label < l;
+                              }) -
+             shortest_edges.begin();
+    };
+    std::vector<int> sets(num_global_components);
+    std::iota(sets.begin(), sets.end(), 0);
+    auto const representative = [&sets](int c) {
+      while (sets[c] != c)
+        c = sets[c] = sets[sets[c]];
+      return c;
+    };
+    int const num_edges_before = edges.size();
+    for (int c = 0; c < num_global_components; ++c)
+    {
+      auto out_edge = shortest_edges[c];
+      if (!(out_edge.edge.weight < inf))
+        continue;
+      int const i = representative(c);
+      int const j = representative(find_component(out_edge.target_label));
+      if (i == j)
+        continue;
+      sets[std::max(i, j)] = std::min(i, j);
+      edges.push_back(static_cast<WeightedEdge>(out_edge.edge));
+    }
+    ARBORX_ASSERT((int)edges.size() > num_edges_before);
+
+    // Relabel the local points with the smallest labels of their components
+    auto const component_labels_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, component_labels);
+    Kokkos::View<int *, Kokkos::HostSpace> new_labels_host(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::new_labels"),
+        num_components);
+    for (int c = 0; c < num_components; ++c)
+      new_labels_host(c) =
+          shortest_edges[representative(find_component(
+                             component_labels_host(c)))]
+              .source_label;
+    auto const new_labels = Kokkos::create_mirror_view_and_copy(
+        Kokkos::view_alloc(space, MemorySpace{}), new_labels_host);
+    Kokkos::parallel_for(
+        "ArborX::DistributedMST::update_labels",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          labels(i) = new_labels(components(i));
+        });
+
+    Kokkos::Profiling::popRegion();
+  }
+
+  return edges;
+}
+
+// Euclidean minimum spanning tree, or minimum spanning tree over the mutual
+// reachability distances for k > 1, of the points of all ranks. Each rank
+// provides its share of the points, which are numbered globally by rank
+// first.
+//
+// Each rank first builds the tree of its local points. Its edges that are
+// certainly part of the global tree, as they are shorter than any edge to the
+// points of the other ranks from one of the subtrees they join, are kept.
+// This usually leaves few components, typically along the boundaries of the
+// domains of the ranks, that are then merged through distributed Boruvka
+// iterations. As with the DistributedTree, the closer the partitioning of the
+// points is to a spatial decomposition, the fewer points need to be
+// exchanged.
+template <class MemorySpace>
+struct DistributedMinimumSpanningTree
+{
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+
+  // Edges over the global indices of the points. Each rank holds a share of
+  // them, the first rank holding the ones from the Boruvka iterations.
+  Kokkos::View<WeightedEdge *, MemorySpace> edges;
+  // Distances of the local points to their k-th nearest neighbors (only
+  // computed when k > 1)
+  Kokkos::View<float *, MemorySpace> core_distances;
+
+  template <class ExecutionSpace, class Primitives>
+  DistributedMinimumSpanningTree(MPI_Comm comm, ExecutionSpace const &space,
+                                 Primitives const &primitives, int k = 1)
+      : edges("ArborX::DistributedMST::edges", 0)
+      , core_distances("ArborX::DistributedMST::core_distances", 0)
+  {
+    KokkosExt::ScopedProfileRegion guard("ArborX::DistributedMST");
+
+    static_assert(
+        KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value,
+        "Primitives must be accessible from the execution space");
+
+    using Access = AccessTraits<Primitives, PrimitivesTag>;
+    constexpr int dim = GeometryTraits::dimension_v<
+        typename Details::AccessTraitsHelper<Access>::type>;
+    using Box = ExperimentalHyperGeometry::Box<dim>;
+
+    ARBORX_ASSERT(k >= 1);
+
+    int comm_rank;
+    MPI_Comm_rank(comm, &comm_rank);
+    int comm_size;
+    MPI_Comm_size(comm, &comm_size);
+
+    int const n = Access::size(primitives);
+
+    long long global_offset = 0;
+    long long total_size;
+    {
+      long long local_size = n;
+      MPI_Exscan(&local_size, &global_offset, 1, MPI_LONG_LONG, MPI_SUM, comm);
+      if (comm_rank == 0)
+        global_offset = 0;
+      MPI_Allreduce(&local_size, &total_size, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    }
+    // The vertices of DirectedEdge are stored over 31 bits
+    ARBORX_ASSERT(total_size <= INT_MAX);
+    if (total_size <= 1)
+      return;
+    // As for a single rank, with fewer points than k, the core distance is
+    // the distance to the farthest point
+    if (k > total_size)
+      k = total_size;
+
+    Kokkos::Profiling::pushRegion("ArborX::DistributedMST::tree_construction");
+    BasicBoundingVolumeHierarchy<MemorySpace, PairIndexVolume<Box>> bvh(
+        space, primitives);
+
+    Kokkos::View<Box *, MemorySpace> rank_bounds(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::rank_bounding_boxes"),
+        comm_size);
+    auto rank_bounds_host = Kokkos::create_mirror_view(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing), rank_bounds);
+    rank_bounds_host(comm_rank) = bvh.bounds();
+    MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                  static_cast<void *>(rank_bounds_host.data()), sizeof(Box),
+                  MPI_BYTE, comm);
+    Kokkos::deep_copy(space, rank_bounds, rank_bounds_host);
+    BasicBoundingVolumeHierarchy<MemorySpace, PairIndexVolume<Box>> top_tree(
+        space, rank_bounds);
+    Kokkos::Profiling::popRegion();
+
+    if (k > 1)
+      core_distances = computeDistributedCoreDistances(comm, space, bvh,
+                                                       top_tree, primitives, k);
+
+    auto const remote_bounds = computeRemoteLowerBounds(
+        comm_rank, space, top_tree, primitives, core_distances);
+
+    Kokkos::View<WeightedEdge *, MemorySpace> local_edges(
+        "ArborX::DistributedMST::local_edges", 0);
+    if (n > 1)
+    {
+      Kokkos::Profiling::pushRegion("ArborX::DistributedMST::local_mst");
+      MinimumSpanningTree<MemorySpace> local_mst(space, bvh, core_distances);
+      local_edges = local_mst.edges;
+      Kokkos::Profiling::popRegion();
+    }
+
+    KokkosExt::reallocWithoutInitializing(space, edges, local_edges.size());
+    Kokkos::View<int *, MemorySpace> labels(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedMST::labels"),
+        n);
+    int const num_certified_edges = certifyLocalEdges(
+        space, local_edges, remote_bounds, global_offset, edges, labels);
+
+    auto const boruvka_edges = distributedBoruvka(
+        comm, space, bvh, top_tree, primitives, core_distances, local_edges,
+        remote_bounds, global_offset, labels);
+
+    int const num_boruvka_edges =
+        (comm_rank == 0 ? (int)boruvka_edges.size() : 0);
+    Kokkos::resize(Kokkos::view_alloc(space), edges,
+                   num_certified_edges + num_boruvka_edges);
+    Kokkos::deep_copy(
+        space,
+        Kokkos::subview(edges,
+                        Kokkos::make_pair(num_certified_edges,
+                                          num_certified_edges +
+                                              num_boruvka_edges)),
+        Kokkos::View<WeightedEdge const *, Kokkos::HostSpace,
+                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+            boruvka_edges.data(), num_boruvka_edges));
+    space.fence();
+  }
+};
+
+} // namespace ArborX::Details
+
+namespace ArborX::Experimental
+{
+
+// Distributed HDBSCAN*. Each rank provides its share of the points, which are
+// numbered globally by rank first. The minimum spanning tree over the mutual
+// reachability distances is built across the ranks, and its edges are then
+// gathered on the first rank to build the dendrogram. The dendrogram returned
+// on the other ranks is empty.
+template <typename ExecutionSpace, typename Primitives>
+auto hdbscan(MPI_Comm comm, ExecutionSpace const &exec_space,
+             Primitives const &primitives, int core_min_size,
+             DendrogramImplementation dendrogram_impl =
+                 DendrogramImplementation::UNION_FIND)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DistributedHDBSCAN");
+
+  using MemorySpace =
+      typename AccessTraits<Primitives, PrimitivesTag>::memory_space;
+
+  // The hybrid Boruvka dendrogram requires all the Boruvka iterations to take
+  // place on a single rank
+  ARBORX_ASSERT(dendrogram_impl != DendrogramImplementation::BORUVKA);
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  Kokkos::Profiling::pushRegion("ArborX::DistributedHDBSCAN::mst");
+  Details::DistributedMinimumSpanningTree<MemorySpace> mst(
+      comm, exec_space, primitives, core_min_size);
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::Profiling::pushRegion("ArborX::DistributedHDBSCAN::gather_edges");
+  auto const local_edges_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, mst.edges);
+  int const num_bytes = local_edges_host.size() * sizeof(Details::WeightedEdge);
+  std::vector<int> counts(comm_size);
+  MPI_Gather(&num_bytes, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm);
+  std::vector<int> displs(comm_size + 1, 0);
+  std::partial_sum(counts.begin(), counts.end(), displs.begin() + 1);
+  Kokkos::View<Details::WeightedEdge *, Kokkos::HostSpace> edges_host(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "ArborX::DistributedHDBSCAN::edges"),
+      (comm_rank == 0 ? displs[comm_size] / sizeof(Details::WeightedEdge) : 0));
+  MPI_Gatherv(local_edges_host.data(), num_bytes, MPI_BYTE, edges_host.data(),
+              counts.data(), displs.data(), MPI_BYTE, 0, comm);
+  Kokkos::Profiling::popRegion();
+
+  if (comm_rank != 0)
+    return Dendrogram<MemorySpace>{
+        Kokkos::View<int *, MemorySpace>("ArborX::Dendrogram::parents", 0),
+        Kokkos::View<float *, MemorySpace>("ArborX::Dendrogram::parent_heights",
+                                           0)};
+
+  Kokkos::Profiling::pushRegion("ArborX::DistributedHDBSCAN::dendrogram");
+  Dendrogram<MemorySpace> dendrogram(
+      exec_space,
+      Kokkos::create_mirror_view_and_copy(
+          Kokkos::view_alloc(exec_space, MemorySpace{}), edges_host),
+      dendrogram_impl);
+  Kokkos::Profiling::popRegion();
+
+  return dendrogram;
+}
+
+} // namespace ArborX::Experimental
+
+#endif
@@ -0,0 +1,532 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DISTRIBUTED_NEIGHBOR_LIST_HPP
+#define ARBORX_DISTRIBUTED_NEIGHBOR_LIST_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DBSCAN.hpp>                     // PrimitivesWithRadius
+#include <ArborX_DetailsDistributedTreeImpl.hpp> // sendAcrossNetwork
+#include <ArborX_DetailsDistributor.hpp>
+#include <ArborX_DetailsHalfTraversal.hpp>
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp>
+#include <ArborX_DetailsMutualReachabilityDistance.hpp> // NearestK
+#include <ArborX_DetailsTreeConstruction.hpp>
+#include <ArborX_DetailsUtils.hpp>      // exclusivePrefixSum
+#include <ArborX_DistributedDBSCAN.hpp> // DistributedDBSCANHaloCallback
+#include <ArborX_Exception.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_HyperSphere.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_PairIndexRank.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+
+#include <mpi.h>
+
+namespace ArborX::Details
+{
+
+// Counts the pairs of the rows of the local points. The pairs of two ghosts
+// belong to other ranks and are skipped.
+template <class MemorySpace>
+struct DistributedNeighborListCountCallback
+{
+  Kokkos::View<int *, MemorySpace> _counts;
+  int _num_local;
+
+  KOKKOS_FUNCTION void operator()(int i, int j) const
+  {
+    if (i < _num_local)
+      Kokkos::atomic_increment(&_counts(i));
+    if (j < _num_local)
+      Kokkos::atomic_increment(&_counts(j));
+  }
+};
+
+template <class MemorySpace>
+struct DistributedNeighborListFillCallback
+{
+  Kokkos::View<int *, MemorySpace> _cursors;
+  Kokkos::View<PairIndexRank *, MemorySpace> _origins;
+  Kokkos::View<PairIndexRank *, MemorySpace> _indices;
+  int _num_local;
+
+  KOKKOS_FUNCTION void operator()(int i, int j) const
+  {
+    if (i < _num_local)
+      _indices(Kokkos::atomic_fetch_inc(&_cursors(i))) = _origins(j);
+    if (j < _num_local)
+      _indices(Kokkos::atomic_fetch_inc(&_cursors(j))) = _origins(i);
+  }
+};
+
+// Spheres around the points, with a radius for each point
+template <class Primitives, class Radii>
+struct PrimitivesWithRadii
+{
+  Primitives _primitives;
+  Radii _radii;
+};
+
+// Outputs the neighbors found among the local points along with their
+// distances, skipping the query point itself for the local queries
+struct DistributedKNNGraphCallback
+{
+  int _comm_rank;
+  bool _skip_self;
+
+  template <class Predicate, class Value, class OutputFunctor>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate,
+                                  Value const &value,
+                                  OutputFunctor const &out) const
+  {
+    if (_skip_self && (int)value.index == getData(predicate))
+      return;
+    out(PairIndexRankAndDistance{
+        {(int)value.index, _comm_rank},
+        distance(getGeometry(predicate), value.bounding_volume)});
+  }
+};
+
+} // namespace ArborX::Details
+
+namespace ArborX
+{
+
+template <class Primitives, class Radii>
+struct AccessTraits<Details::PrimitivesWithRadii<Primitives, Radii>,
+                    PredicatesTag>
+{
+  using PrimitivesAccess = AccessTraits<Primitives, PrimitivesTag>;
+
+  using memory_space = typename PrimitivesAccess::memory_space;
+  using Predicates = Details::PrimitivesWithRadii<Primitives, Radii>;
+
+  static KOKKOS_FUNCTION size_t size(Predicates const &w)
+  {
+    return PrimitivesAccess::size(w._primitives);
+  }
+  static KOKKOS_FUNCTION auto get(Predicates const &w, size_t i)
+  {
+    auto const &point = PrimitivesAccess::get(w._primitives, i);
+    constexpr int dim =
+        GeometryTraits::dimension_v<std::decay_t<decltype(point)>>;
+    // FIXME reinterpret_cast is dangerous here if access traits return user
+    // point structure (e.g., struct MyPoint { float y; float x; })
+    auto const &hyper_point =
+        reinterpret_cast<ExperimentalHyperGeometry::Point<dim> const &>(point);
+    return intersects(
+        ExperimentalHyperGeometry::Sphere<dim>{hyper_point, w._radii(i)});
+  }
+};
+
+} // namespace ArborX
+
+namespace ArborX::Experimental
+{
+
+// Distributed full neighbor list. Each rank provides its share of the points,
+// and gets back, in compressed row format, the index and the rank of all the
+// points within radius of each of its points, on any rank.
+//
+// Instead of forwarding the queries of every point to the ranks they may
+// intersect, the points within radius of the domain of another rank are sent
+// to that rank as ghosts in a single exchange. The pairs are then found by a
+// local self-join of the local and ghost points, skipping the pairs of ghosts.
+// As with the DistributedDBSCAN, the fewer the points close to the domains of
+// other ranks, the fewer the points exchanged.
+template <class ExecutionSpace, class Primitives, class Offsets, class Indices>
+void findDistributedNeighborList(MPI_Comm comm, ExecutionSpace const &space,
+                                 Primitives const &primitives, float radius,
+                                 Offsets &offsets, Indices &indices)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::Experimental::DistributedNeighborList");
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value,
+      "Primitives must be accessible from the execution space");
+  static_assert(
+      std::is_same_v<typename Indices::non_const_value_type, PairIndexRank>,
+      "Indices must store PairIndexRank");
+
+  using Point = typename Details::AccessTraitsHelper<Access>::type;
+  static_assert(GeometryTraits::is_point<Point>{},
+                "Distributed neighbor lists require primitives to be points");
+  constexpr int dim = GeometryTraits::dimension_v<Point>;
+  using Box = ExperimentalHyperGeometry::Box<dim>;
+
+  ARBORX_ASSERT(radius >= 0);
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = Access::size(primitives);
+
+  // Find the ranks whose domain is within radius of each point
+  Kokkos::Profiling::pushRegion(
+      "ArborX::Experimental::DistributedNeighborList::halo");
+  Kokkos::View<int *, MemorySpace> export_ranks(
+      "ArborX::Experimental::DistributedNeighborList::export_ranks", 0);
+  Kokkos::View<int *, MemorySpace> export_offsets(
+      "ArborX::Experimental::DistributedNeighborList::export_offsets", 0);
+  {
+    Box local_bounds;
+    Details::TreeConstruction::calculateBoundingBoxOfTheScene(
+        space, Details::Indexables<Primitives>{primitives}, local_bounds);
+
+    Kokkos::View<Box *, MemorySpace> rank_bounds(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::Experimental::DistributedNeighborList::rank_bounds"),
+        comm_size);
+    auto rank_bounds_host = Kokkos::create_mirror_view(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing), rank_bounds);
+    rank_bounds_host(comm_rank) = local_bounds;
+    MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                  static_cast<void *>(rank_bounds_host.data()), sizeof(Box),
+                  MPI_BYTE, comm);
+    Kokkos::deep_copy(space, rank_bounds, rank_bounds_host);
+
+    BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>>
+        top_tree(space, rank_bounds);
+    top_tree.query(
+        space, Details::PrimitivesWithRadius<Primitives>{primitives, radius},
+        Details::DistributedDBSCANHaloCallback{comm_rank}, export_ranks,
+        export_offsets);
+  }
+  int const num_exports = export_ranks.size();
+
+  Details::Distributor<DeviceType> distributor(comm);
+  int const num_ghosts = distributor.createFromSends(space, export_ranks);
+
+  // Gather the local points followed by the ghost points, along with where
+  // they come from
+  Kokkos::View<Point *, MemorySpace> points(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::Experimental::DistributedNeighborList::points"),
+      n + num_ghosts);
+  Kokkos::View<PairIndexRank *, MemorySpace> origins(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::Experimental::DistributedNeighborList::origins"),
+      n + num_ghosts);
+  Kokkos::parallel_for(
+      "ArborX::Experimental::DistributedNeighborList::copy_local_points",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        points(i) = Access::get(primitives, i);
+        origins(i) = {i, comm_rank};
+      });
+  {
+    Kokkos::View<Point *, MemorySpace> export_points(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::Experimental::DistributedNeighborList::export_points"),
+        num_exports);
+    Kokkos::View<PairIndexRank *, MemorySpace> export_origins(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::Experimental::DistributedNeighborList::export_origins"),
+        num_exports);
+    Kokkos::parallel_for(
+        "ArborX::Experimental::DistributedNeighborList::fill_exports",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          for (int k = export_offsets(i); k < export_offsets(i + 1); ++k)
+          {
+            export_points(k) = Access::get(primitives, i);
+            export_origins(k) = {i, comm_rank};
+          }
+        });
+
+    Kokkos::View<Point *, MemorySpace> ghost_points(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::Experimental::DistributedNeighborList::ghost_points"),
+        num_ghosts);
+    Kokkos::View<PairIndexRank *, MemorySpace> ghost_origins(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::Experimental::DistributedNeighborList::ghost_origins"),
+        num_ghosts);
+    Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+        space, distributor, export_points, ghost_points);
+    Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+        space, distributor, export_origins, ghost_origins);
+    Kokkos::deep_copy(
+        space, Kokkos::subview(points, Kokkos::make_pair(n, n + num_ghosts)),
+        ghost_points);
+    Kokkos::deep_copy(
+        space, Kokkos::subview(origins, Kokkos::make_pair(n, n + num_ghosts)),
+        ghost_origins);
+  }
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::Profiling::pushRegion(
+      "ArborX::Experimental::DistributedNeighborList::tree_construction");
+  BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>> bvh(
+      space, points);
+  Kokkos::Profiling::popRegion();
+
+  // The template arguments are explicit to workaround a compiler bug in older
+  // NVCC versions
+  using CountCallback =
+      Details::DistributedNeighborListCountCallback<MemorySpace>;
+  using FillCallback =
+      Details::DistributedNeighborListFillCallback<MemorySpace>;
+  using CountTraversal = Details::HalfTraversal<decltype(bvh), CountCallback,
+                                                Details::WithinRadiusGetter>;
+  using FillTraversal = Details::HalfTraversal<decltype(bvh), FillCallback,
+                                               Details::WithinRadiusGetter>;
+
+  Kokkos::Profiling::pushRegion(
+      "ArborX::Experimental::DistributedNeighborList::count");
+  KokkosExt::reallocWithoutInitializing(space, offsets, n + 1);
+  Kokkos::deep_copy(space, offsets, 0);
+  CountTraversal(space, bvh, CountCallback{offsets, n},
+                 Details::WithinRadiusGetter{radius});
+  exclusivePrefixSum(space, offsets);
+  KokkosExt::reallocWithoutInitializing(space, indices,
+                                        KokkosExt::lastElement(space, offsets));
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::Profiling::pushRegion(
+      "ArborX::Experimental::DistributedNeighborList::fill");
+  auto cursors = KokkosExt::clone(
+      space, Kokkos::subview(offsets, std::make_pair(0, n)),
+      "ArborX::Experimental::DistributedNeighborList::cursors");
+  FillTraversal(space, bvh, FillCallback{cursors, origins, indices, n},
+                Details::WithinRadiusGetter{radius});
+  Kokkos::Profiling::popRegion();
+}
+
+// Distributed k-nearest neighbors graph. Each rank provides its share of the
+// points, and gets back, in compressed row format, the index and the rank of
+// the k nearest points of each of its points, themselves excluded, on any
+// rank, in increasing order of distance. The distances are returned too.
+//
+// The k nearest neighbors are first found among the local points. A point is
+// then only sent to the ranks whose domain is closer than its k-th nearest
+// local neighbor, which return their k nearest points to it. The queries of
+// the points far from the domains of other ranks never leave their rank.
+template <class ExecutionSpace, class Primitives, class Offsets, class Indices,
+          class Distances>
+void findDistributedKNNGraph(MPI_Comm comm, ExecutionSpace const &space,
+                             Primitives const &primitives, int k,
+                             Offsets &offsets, Indices &indices,
+                             Distances &distances)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::Experimental::DistributedKNNGraph");
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+  using Impl = Details::DistributedTreeImpl<DeviceType>;
+
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value,
+      "Primitives must be accessible from the execution space");
+  static_assert(
+      std::is_same_v<typename Indices::non_const_value_type, PairIndexRank>,
+      "Indices must store PairIndexRank");
+
+  using Point = typename Details::AccessTraitsHelper<Access>::type;
+  static_assert(GeometryTraits::is_point<Point>{},
+                "Distributed kNN graphs require primitives to be points");
+  constexpr int dim = GeometryTraits::dimension_v<Point>;
+  using Box = ExperimentalHyperGeometry::Box<dim>;
+  constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
+
+  ARBORX_ASSERT(k >= 1);
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = Access::size(primitives);
+
+  // Find the k nearest local neighbors, sorted by distance. The nearest k + 1
+  // points are searched as they include the point itself.
+  Kokkos::Profiling::pushRegion(
+      "ArborX::Experimental::DistributedKNNGraph::local");
+  BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>> bvh(
+      space, primitives);
+  Kokkos::View<Details::PairIndexRankAndDistance *, MemorySpace>
+      local_neighbors(
+          "ArborX::Experimental::DistributedKNNGraph::local_neighbors", 0);
+  Kokkos::View<int *, MemorySpace> local_offsets(
+      "ArborX::Experimental::DistributedKNNGraph::local_offsets", 0);
+  bvh.query(space, Details::NearestK<Primitives>{primitives, k + 1},
+            Details::DistributedKNNGraphCallback{comm_rank, true},
+            local_neighbors, local_offsets);
+
+  // The other ranks may only hold closer neighbors within the distance to
+  // the k-th nearest local neighbor, if any
+  Kokkos::View<float *, MemorySpace> radii(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::Experimental::DistributedKNNGraph::radii"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::Experimental::DistributedKNNGraph::sort_local_neighbors",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        int const first = local_offsets(i);
+        int const last = local_offsets(i + 1);
+        for (int m = first + 1; m < last; ++m)
+        {
+          auto const neighbor = local_neighbors(m);
+          int l = m;
+          for (; l > first && local_neighbors(l - 1).second > neighbor.second;
+               --l)
+            local_neighbors(l) = local_neighbors(l - 1);
+          local_neighbors(l) = neighbor;
+        }
+        radii(i) = (last - first >= k ? local_neighbors(first + k - 1).second
+                                      : inf);
+      });
+  Kokkos::Profiling::popRegion();
+
+  // Search the ranks whose domain is within the radius of each point
+  Kokkos::Profiling::pushRegion(
+      "ArborX::Experimental::DistributedKNNGraph::remote");
+  Kokkos::View<int *, DeviceType> ranks(
+      "ArborX::Experimental::DistributedKNNGraph::ranks", 0);
+  Kokkos::View<int *, DeviceType> remote_offsets(
+      "ArborX::Experimental::DistributedKNNGraph::remote_offsets", 0);
+  {
+    Kokkos::View<Box *, MemorySpace> rank_bounds(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::Experimental::DistributedKNNGraph::rank_bounds"),
+        comm_size);
+    auto rank_bounds_host = Kokkos::create_mirror_view(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing), rank_bounds);
+    rank_bounds_host(comm_rank) = bvh.bounds();
+    MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                  static_cast<void *>(rank_bounds_host.data()), sizeof(Box),
+                  MPI_BYTE, comm);
+    Kokkos::deep_copy(space, rank_bounds, rank_bounds_host);
+
+    BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>>
+        top_tree(space, rank_bounds);
+    top_tree.query(
+        space,
+        Details::PrimitivesWithRadii<Primitives, decltype(radii)>{primitives,
+                                                                  radii},
+        Details::DistributedDBSCANHaloCallback{comm_rank}, ranks,
+        remote_offsets);
+  }
+
+  using Predicates = Details::NearestK<Primitives>;
+  using Query = typename Details::AccessTraitsHelper<
+      AccessTraits<Predicates, PredicatesTag>>::type;
+  Kokkos::View<Query *, DeviceType> fwd_queries(
+      "ArborX::Experimental::DistributedKNNGraph::fwd_queries", 0);
+  Kokkos::View<int *, DeviceType> ids(
+      "ArborX::Experimental::DistributedKNNGraph::query_ids", 0);
+  Kokkos::View<int *, DeviceType> fwd_ranks(
+      "ArborX::Experimental::DistributedKNNGraph::fwd_ranks", 0);
+  Impl::forwardQueries(comm, space, Predicates{primitives, k}, ranks,
+                       remote_offsets, fwd_queries, ids, fwd_ranks);
+
+  Kokkos::View<Details::PairIndexRankAndDistance *, DeviceType>
+      remote_neighbors(
+          "ArborX::Experimental::DistributedKNNGraph::remote_neighbors", 0);
+  bvh.query(space, fwd_queries,
+            Details::DistributedKNNGraphCallback{comm_rank, false},
+            remote_neighbors, remote_offsets);
+
+  Impl::communicateResultsBack(comm, space, remote_neighbors, remote_offsets,
+                               fwd_ranks, ids);
+  Impl::countResults(space, n, ids, remote_offsets);
+  Impl::sortResults(space, ids, remote_neighbors);
+  Kokkos::Profiling::popRegion();
+
+  // Insert the remote neighbors into the sorted local ones
+  Kokkos::Profiling::pushRegion(
+      "ArborX::Experimental::DistributedKNNGraph::merge");
+  KokkosExt::reallocWithoutInitializing(space, offsets, n + 1);
+  Kokkos::parallel_for(
+      "ArborX::Experimental::DistributedKNNGraph::count",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n + 1),
+      KOKKOS_LAMBDA(int i) {
+        using KokkosExt::min;
+        offsets(i) =
+            (i < n ? min(k, (local_offsets(i + 1) - local_offsets(i)) +
+                                (remote_offsets(i + 1) - remote_offsets(i)))
+                   : 0);
+      });
+  exclusivePrefixSum(space, offsets);
+  int const num_edges = KokkosExt::lastElement(space, offsets);
+  KokkosExt::reallocWithoutInitializing(space, indices, num_edges);
+  KokkosExt::reallocWithoutInitializing(space, distances, num_edges);
+  Kokkos::parallel_for(
+      "ArborX::Experimental::DistributedKNNGraph::merge_neighbors",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        int const first = offsets(i);
+        int const capacity = offsets(i + 1) - first;
+        int count = 0;
+        for (int m = local_offsets(i);
+             m < local_offsets(i + 1) && count < capacity; ++m, ++count)
+        {
+          indices(first + count) = local_neighbors(m).first;
+          distances(first + count) = local_neighbors(m).second;
+        }
+        for (int m = remote_offsets(i); m < remote_offsets(i + 1); ++m)
+        {
+          auto const neighbor = remote_neighbors(m);
+          int l;
+          if (count < capacity)
+            l = count++;
+          else if (neighbor.second < distances(first + capacity - 1))
+            l = capacity - 1;
+          else
+            continue;
+          for (; l > 0 && distances(first + l - 1) > neighbor.second; --l)
+          {
+            indices(first + l) = indices(first + l - 1);
+            distances(first + l) = distances(first + l - 1);
+          }
+          indices(first + l) = neighbor.first;
+          distances(first + l) = neighbor.second;
+        }
+      });
+  Kokkos::Profiling::popRegion();
+}
+
+template <class ExecutionSpace, class Primitives, class Offsets, class Indices>
+void findDistributedKNNGraph(MPI_Comm comm, ExecutionSpace const &space,
+                             Primitives const &primitives, int k,
+                             Offsets &offsets, Indices &indices)
+{
+  Kokkos::View<float *, typename Offsets::memory_space> distances(
+      "ArborX::Experimental::DistributedKNNGraph::distances", 0);
+  findDistributedKNNGraph(comm, space, primitives, k, offsets, indices,
+                          distances);
+}
+
+} // namespace ArborX::Experimental
+
+#endif
@@ -0,0 +1,250 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DISTRIBUTED_REPARTITION_HPP
+#define ARBORX_DISTRIBUTED_REPARTITION_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsDistributedTreeImpl.hpp> // sendAcrossNetwork
+#include <ArborX_DetailsDistributor.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp>
+#include <ArborX_DetailsSortUtils.hpp>
+#include <ArborX_DetailsTreeConstruction.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_IndexableGetter.hpp>
+#include <ArborX_PairIndexRank.hpp>
+#include <ArborX_SpaceFillingCurves.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm> // min, sort
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+namespace ArborX::Experimental
+{
+
+// Primitives owned by a process after a repartitioning
+template <typename Value, typename MemorySpace>
+struct Repartitioning
+{
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+
+  Kokkos::View<Value *, MemorySpace> _primitives;
+  // Rank and index of each primitive before the repartitioning
+  Kokkos::View<PairIndexRank *, MemorySpace> _origins;
+};
+
+// Redistribute the primitives so that each process owns a compact region of
+// space, as expected by the DistributedTree. The primitives are ordered along
+// a space-filling curve over their global bounding box, and the curve is cut
+// into as many pieces of about the same number of primitives as there are
+// processes, rank r getting the r-th piece. The cuts are chosen from a sample
+// of the codes of each process, weighted by its number of primitives, so
+// that the balance is within a fraction of the number of primitives per
+// process over the number of samples.
+template <typename ExecutionSpace, typename Primitives,
+          typename SpaceFillingCurve = Morton64>
+auto repartition(MPI_Comm comm, ExecutionSpace const &space,
+                 Primitives const &primitives,
+                 SpaceFillingCurve const &curve = SpaceFillingCurve())
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::Repartition");
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value,
+      "Primitives must be accessible from the execution space");
+
+  using Value =
+      std::decay_t<typename Details::AccessTraitsHelper<Access>::type>;
+  constexpr int dim = GeometryTraits::dimension_v<Value>;
+  using Box = ExperimentalHyperGeometry::Box<dim>;
+
+  Details::check_valid_space_filling_curve<dim>(curve);
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = Access::size(primitives);
+  Details::Indexables<Primitives> indexables{primitives};
+
+  Box bounds;
+  Details::TreeConstruction::calculateBoundingBoxOfTheScene(space, indexables,
+                                                            bounds);
+  {
+    float min_corner[dim];
+    float max_corner[dim];
+    for (int d = 0; d < dim; ++d)
+    {
+      min_corner[d] = bounds.minCorner()[d];
+      max_corner[d] = bounds.maxCorner()[d];
+    }
+    MPI_Allreduce(MPI_IN_PLACE, min_corner, dim, MPI_FLOAT, MPI_MIN, comm);
+    MPI_Allreduce(MPI_IN_PLACE, max_corner, dim, MPI_FLOAT, MPI_MAX, comm);
+    for (int d = 0; d < dim; ++d)
+    {
+      bounds.minCorner()[d] = min_corner[d];
+      bounds.maxCorner()[d] = max_corner[d];
+    }
+  }
+
+  using Code = decltype(curve(bounds, indexables(0)));
+  Kokkos::View<Code *, MemorySpace> codes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::Repartition::codes"),
+      n);
+  Details::TreeConstruction::projectOntoSpaceFillingCurve(
+      space, indexables, curve, bounds, codes);
+
+  // Sample the codes evenly in the local order along the curve
+  Kokkos::Profiling::pushRegion("ArborX::Repartition::find_cuts");
+  constexpr int max_num_samples = 64;
+  int const num_samples = std::min(n, max_num_samples);
+  std::vector<Code> local_samples(num_samples);
+  {
+    auto sorted_codes = KokkosExt::clone(space, codes);
+    Details::sortObjects(space, sorted_codes);
+    Kokkos::View<Code *, MemorySpace> samples(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::Repartition::samples"),
+        num_samples);
+    Kokkos::parallel_for(
+        "ArborX::Repartition::sample_codes",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_samples),
+        KOKKOS_LAMBDA(int k) {
+          samples(k) =
+              sorted_codes((2 * k + 1) * (long long)n / (2 * num_samples));
+        });
+    Kokkos::deep_copy(space,
+                      Kokkos::View<Code *, Kokkos::HostSpace,
+                                   Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+                          local_samples.data(), num_samples),
+                      samples);
+    space.fence("ArborX::Repartition (copy samples to host)");
+  }
+
+  std::vector<int> sizes(comm_size);
+  std::vector<int> sample_counts(comm_size);
+  MPI_Allgather(&n, 1, MPI_INT, sizes.data(), 1, MPI_INT, comm);
+  MPI_Allgather(&num_samples, 1, MPI_INT, sample_counts.data(), 1, MPI_INT,
+                comm);
+  std::vector<int> sample_displs(comm_size + 1, 0);
+  for (int r = 0; r < comm_size; ++r)
+    sample_displs[r + 1] = sample_displs[r] + sample_counts[r];
+  std::vector<Code> samples(sample_displs[comm_size]);
+  MPI_Datatype const code_type =
+      (std::is_same_v<Code, unsigned int> ? MPI_UNSIGNED
+                                          : MPI_UNSIGNED_LONG_LONG);
+  MPI_Allgatherv(local_samples.data(), num_samples, code_type, samples.data(),
+                 sample_counts.data(), sample_displs.data(), code_type, comm);
+
+  // Each sample stands for the same share of the primitives of its process
+  std::vector<std::pair<Code, double>> weighted_samples;
+  weighted_samples.reserve(samples.size());
+  double total = 0;
+  for (int r = 0; r < comm_size; ++r)
+  {
+    total += sizes[r];
+    for (int k = sample_displs[r]; k < sample_displs[r + 1]; ++k)
+      weighted_samples.emplace_back(samples[k],
+                                    (double)sizes[r] / sample_counts[r]);
+  }
+  std::sort(weighted_samples.begin(), weighted_samples.end());
+
+  // Rank r gets the codes in [cuts[r - 1], cuts[r])
+  Kokkos::View<Code *, MemorySpace> cuts(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::Repartition::cuts"),
+      comm_size - 1);
+  auto cuts_host = Kokkos::create_mirror_view(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing), cuts);
+  {
+    double accumulated = 0;
+    int k = 0;
+    int const num_weighted_samples = weighted_samples.size();
+    for (int r = 1; r < comm_size; ++r)
+    {
+      while (k < num_weighted_samples && accumulated < r * total / comm_size)
+        accumulated += weighted_samples[k++].second;
+      cuts_host(r - 1) = (k < num_weighted_samples ? weighted_samples[k].first
+                                                   : ~Code(0));
+    }
+  }
+  Kokkos::deep_copy(space, cuts, cuts_host);
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::View<int *, MemorySpace> destinations(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::Repartition::destinations"),
+      n);
+  Kokkos::View<Value *, MemorySpace> export_primitives(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::Repartition::export_primitives"),
+      n);
+  Kokkos::View<PairIndexRank *, MemorySpace> export_origins(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::Repartition::export_origins"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::Repartition::find_destinations",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        // Number of cuts not greater than the code
+        int first = 0;
+        int last = cuts.size();
+        while (first < last)
+        {
+          int const middle = (first + last) / 2;
+          if (cuts(middle) <= codes(i))
+            first = middle + 1;
+          else
+            last = middle;
+        }
+        destinations(i) = first;
+        export_primitives(i) = Access::get(primitives, i);
+        export_origins(i) = {i, comm_rank};
+      });
+
+  Kokkos::Profiling::pushRegion("ArborX::Repartition::redistribute");
+  Details::Distributor<DeviceType> distributor(comm);
+  int const num_imports = distributor.createFromSends(space, destinations);
+  Repartitioning<Value, MemorySpace> repartitioning{
+      Kokkos::View<Value *, MemorySpace>(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                             "ArborX::Repartition::primitives"),
+          num_imports),
+      Kokkos::View<PairIndexRank *, MemorySpace>(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                             "ArborX::Repartition::origins"),
+          num_imports)};
+  Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+      space, distributor, export_primitives, repartitioning._primitives);
+  Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+      space, distributor, export_origins, repartitioning._origins);
+  Kokkos::Profiling::popRegion();
+
+  return repartitioning;
+}
+
+} // namespace ArborX::Experimental
+
+#endif
@@ -13,19 +13,49 @@
 #define ARBORX_DISTRIBUTED_TREE_HPP
 
 #include <ArborX_Box.hpp>
+#include <ArborX_DetailsDistributedQueryRequest.hpp>
 #include <ArborX_DetailsDistributedTreeImpl.hpp>
-#include <ArborX_DetailsUtils.hpp> // accumulate
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp> // lastElement
+#include <ArborX_DetailsUtils.hpp> // accumulate, exclusivePrefixSum
 #include <ArborX_LinearBVH.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <algorithm> // stable_sort
+#include <cmath>
 #include <memory>
+#include <numeric> // accumulate, iota
+#include <type_traits>
+#include <vector>
 
 #include <mpi.h>
 
 namespace ArborX
 {
 
+namespace Details
+{
+struct TreeSerialization;
+
+// Counts the hits of the bounding boxes of the ranks by those of the other
+// ranks
+template <typename MemorySpace>
+struct CountOverlapsCallback
+{
+  Kokkos::View<int, MemorySpace> _count;
+
+  template <typename Predicate, typename Value>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate,
+                                  Value const &value) const
+  {
+    if ((int)value.index != getData(predicate))
+      Kokkos::atomic_increment(&_count());
+  }
+};
+} // namespace Details
+
 /** \brief Distributed search tree
  *
  *  \note query() must be called as collective over all processes in the
@@ -57,6 +87,91 @@ public:
    */
   bool empty() const noexcept { return size() == 0; }
 
+  /** \brief Rebuilds the local tree from new primitives and refreshes the
+   *  top tree with the bounds of the ranks that changed
+   *
+   *  \note update() and refit() must be called as collective over all
+   *  processes in the communicator. Ranks whose primitives are unchanged call
+   *  the overload without primitives. Only the bounds and sizes of the ranks
+   *  that changed are exchanged, and the top tree is refitted rather than
+   *  rebuilt unless its quality degrades too much.
+   */
+  template <typename ExecutionSpace, typename Primitives>
+  void update(ExecutionSpace const &space, Primitives const &primitives);
+
+  /** Refreshes the top tree without changing the local tree.
+   */
+  template <typename ExecutionSpace>
+  void update(ExecutionSpace const &space);
+
+  /** Refits the local tree to primitives that have moved, given in the same
+   *  order and number as at construction, and refreshes the top tree.
+   *  Returns the quality ratio of the local refit (see BVH::refit).
+   */
+  template <typename ExecutionSpace, typename Primitives>
+  float refit(ExecutionSpace const &space, Primitives const &primitives);
+
+  /** Returns the average number of other processes whose bounding box
+   *  intersects the one of a process. This measures how well the objects are
+   *  partitioned, as a query inside such an intersection is forwarded to all
+   *  the processes involved (0 for disjoint boxes).
+   */
+  template <typename ExecutionSpace>
+  float overlap(ExecutionSpace const &space) const;
+
+  /** Returns, on all processes, the number of times the local tree of each
+   *  process was hit by spatial queries since construction or the last call
+   *  to balance().
+   *
+   *  \note Must be called as collective over all processes.
+   */
+  std::vector<long long> queryCounts() const;
+
+  /** \brief Replicates the local trees that are hit by too many queries
+   *
+   *  The local trees of the processes hit by more than \c imbalance_threshold
+   *  times the average number of spatial queries (see queryCounts()) are
+   *  replicated onto processes hit by fewer than average, so that the
+   *  subsequent spatial queries hitting them are spread over the replicas.
+   *  Each process holds at most one replica, and the replicas are dropped
+   *  when the tree is updated or refitted. Only the queries for indices and
+   *  ranks are spread, as callbacks are meant to be called on the process
+   *  owning the objects.
+   *
+   *  \note Must be called as collective over all processes.
+   */
+  template <typename ExecutionSpace>
+  void balance(ExecutionSpace const &space, float imbalance_threshold = 2.f);
+
+  /** \brief Aggregates the messages of the queries per node
+   *
+   *  When enabled, the data sent by a process to the processes of another
+   *  shared-memory node goes in a single message to one of them, which
+   *  forwards it within the node. This trades a second, intra-node, hop for
+   *  fewer and larger messages between nodes. It is worth it with several
+   *  processes per node, e.g. one per GPU.
+   *
+   *  \note Must be called as collective over all processes.
+   */
+  void setNodeAwareRouting(bool node_aware);
+
+  /** \brief Bounds each process by several boxes to forward fewer queries
+   *
+   *  A spatial query is forwarded to the processes whose bounding box it
+   *  satisfies, which for partitions that are not box-shaped, e.g. along a
+   *  space-filling curve, covers much more space than their objects. When
+   *  \c max_boxes_per_process is greater than 1, each process is also bounded
+   *  by the boxes of up to that many topmost nodes of its local tree, and
+   *  spatial queries are only forwarded to the processes for which they
+   *  satisfy one of these boxes. The boxes are kept up to date by update()
+   *  and refit(). Nearest queries are not affected.
+   *
+   *  \note Must be called as collective over all processes.
+   */
+  template <typename ExecutionSpace>
+  void setBoundsRefinement(ExecutionSpace const &space,
+                           int max_boxes_per_process);
+
   /** \brief Finds object satisfying the passed predicates (e.g. nearest to
    *  some point or intersecting with some box)
    *
@@ -77,14 +192,21 @@ public:
    *  reference because \c Kokkos::realloc() calls the assignment operator.
    *
    *  \param[in] predicates Collection of predicates of the same type.  These
-   *  may be spatial predicates or nearest predicates.
+   *  may be spatial predicates, nearest predicates, or ordered spatial
+   *  predicates.  Results of the latter come in the order along the ray.
    *  \param[out] args
+   *     - \c callback Optional callback called with the predicate and the
+   *       object local index on the process that owns the object. Only its
+   *       output, given in place of the indices and ranks, is communicated
+   *       back.
    *     - \c indices Object local indices that satisfy the predicates.
    *     - \c offset Array of predicate offsets for one-dimensional
    *       storage.
    *     - \c ranks Process ranks that own objects.
    *     - \c distances Computed distances (optional and only for nearest
    *       predicates).
+   *     - \c strategy Experimental::DistributedNearestStrategy used to
+   *       forward the queries (optional and only for nearest predicates).
    */
   template <typename ExecutionSpace, typename Predicates, typename... Args>
   void query(ExecutionSpace const &space, Predicates const &predicates,
@@ -98,15 +220,102 @@ public:
         Tag{}, *this, space, predicates, std::forward<Args>(args)...);
   }
 
+  /** \brief Starts spatial queries without waiting for their communication
+   *
+   *  Same as query() with spatial predicates for the indices and ranks of the
+   *  objects, but returns a request as soon as the predicates have been sent
+   *  to the processes whose bounding box they intersect. The rest of the
+   *  exchange, performing the predicates received from the other processes
+   *  and sending their results back, only advances when the request is
+   *  tested, so that the caller may compute in between calls to test(). The
+   *  results are given by values() and offsets() of the request once test()
+   *  returned true or wait() returned.
+   *
+   *  \note Must be called as collective over all processes, and each process
+   *  must eventually complete its request, since the other processes wait for
+   *  it to perform their predicates. The replicas made by balance() are not
+   *  used.
+   */
+  template <typename ExecutionSpace, typename Predicates>
+  auto queryAsync(ExecutionSpace const &space,
+                  Predicates const &predicates) const
+  {
+    static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+    using Access = AccessTraits<Predicates, PredicatesTag>;
+    using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+    static_assert(std::is_same_v<Tag, Details::SpatialPredicateTag>,
+                  "Asynchronous queries only support spatial predicates");
+    using Query = typename Details::AccessTraitsHelper<Access>::type;
+    using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+
+    KokkosExt::ScopedProfileRegion guard("ArborX::DistributedTree::queryAsync");
+
+    Kokkos::View<int *, DeviceType> ranks(
+        "ArborX::DistributedTree::queryAsync::ranks", 0);
+    Kokkos::View<int *, DeviceType> offset(
+        "ArborX::DistributedTree::queryAsync::offset", 0);
+    _top_tree.query(space, predicates, ranks, offset);
+    refineTopTreeHits(space, predicates, ranks, offset);
+
+    auto const &query_counts = _query_counts;
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::queryAsync::count_hits",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, ranks.extent(0)),
+        KOKKOS_LAMBDA(int i) {
+          Kokkos::atomic_increment(&query_counts(ranks(i)));
+        });
+
+    return Experimental::DistributedQueryRequest<ExecutionSpace, MemorySpace,
+                                                 Query>(
+        getComm(), space, _bottom_tree, predicates, ranks, offset);
+  }
+
 private:
   template <typename DeviceType>
   friend struct Details::DistributedTreeImpl;
+  friend struct Details::TreeSerialization;
+
+  // Assemble the distributed tree from existing local trees
+  template <typename ExecutionSpace>
+  DistributedTree(MPI_Comm comm, ExecutionSpace const &space,
+                  BVH<MemorySpace> const &bottom_tree);
+
+  void duplicateCommunicator(MPI_Comm comm);
+  template <typename ExecutionSpace>
+  void buildTopTree(ExecutionSpace const &space);
+  template <typename ExecutionSpace>
+  void refreshTopTree(ExecutionSpace const &space, bool changed);
+  template <typename ExecutionSpace>
+  void dropReplicas(ExecutionSpace const &space);
+  template <typename ExecutionSpace>
+  void gatherRankPieces(ExecutionSpace const &space);
+  template <typename ExecutionSpace, typename Predicates, typename Ranks,
+            typename Offset>
+  void refineTopTreeHits(ExecutionSpace const &space,
+                         Predicates const &predicates, Ranks &ranks,
+                         Offset &offset) const;
+
   MPI_Comm getComm() const { return *_comm_ptr; }
   std::shared_ptr<MPI_Comm> _comm_ptr;
   BVH<MemorySpace> _top_tree;    // replicated
   BVH<MemorySpace> _bottom_tree; // local
   size_type _top_tree_size;
   Kokkos::View<size_type *, MemorySpace> _bottom_tree_sizes;
+  Kokkos::View<Box *, MemorySpace> _rank_bounds; // top tree leaves
+  // Number of spatial query hits of each tree by the local queries
+  Kokkos::View<long long *, MemorySpace> _query_counts;
+  // The replicas of the local tree of rank r are held by the processes
+  // _replica_holders(_replica_offsets(r) .. _replica_offsets(r + 1))
+  Kokkos::View<int *, MemorySpace> _replica_offsets;
+  Kokkos::View<int *, MemorySpace> _replica_holders;
+  BVH<MemorySpace> _replica_tree;
+  int _replica_rank = -1; // rank that owns _replica_tree
+  // The local tree of rank r is bounded by the boxes
+  // _rank_pieces(_rank_piece_offsets(r) .. _rank_piece_offsets(r + 1)), if
+  // any, within its bounds
+  int _max_pieces_per_rank = 1;
+  Kokkos::View<int *, MemorySpace> _rank_piece_offsets;
+  Kokkos::View<Box *, MemorySpace> _rank_pieces;
 };
 
 template <typename MemorySpace>
@@ -119,6 +328,40 @@ DistributedTree<MemorySpace>::DistributedTree(MPI_Comm comm,
 
   static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
 
+  duplicateCommunicator(comm);
+
+  Kokkos::Profiling::pushRegion("ArborX::DistributedTree::DistributedTree::"
+                                "bottom_tree_construction");
+
+  _bottom_tree = BVH<MemorySpace>(space, primitives);
+
+  Kokkos::Profiling::popRegion();
+
+  buildTopTree(space);
+
+  Kokkos::Profiling::popRegion();
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+DistributedTree<MemorySpace>::DistributedTree(
+    MPI_Comm comm, ExecutionSpace const &space,
+    BVH<MemorySpace> const &bottom_tree)
+    : _bottom_tree(bottom_tree)
+{
+  Kokkos::Profiling::pushRegion("ArborX::DistributedTree::DistributedTree");
+
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+
+  duplicateCommunicator(comm);
+  buildTopTree(space);
+
+  Kokkos::Profiling::popRegion();
+}
+
+template <typename MemorySpace>
+void DistributedTree<MemorySpace>::duplicateCommunicator(MPI_Comm comm)
+{
   // Create new context for the library to isolate library's communication from
   // user's
   _comm_ptr.reset(
@@ -134,13 +377,12 @@ DistributedTree<MemorySpace>::DistributedTree(MPI_Comm comm,
         MPI_Comm_free(p);
         delete p;
       });
+}
 
-  Kokkos::Profiling::pushRegion("ArborX::DistributedTree::DistributedTree::"
-                                "bottom_tree_construction");
-
-  _bottom_tree = BVH<MemorySpace>(space, primitives);
-
-  Kokkos::Profiling::popRegion();
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+void DistributedTree<MemorySpace>::buildTopTree(ExecutionSpace const &space)
+{
   Kokkos::Profiling::pushRegion("ArborX::DistributedTree::DistributedTree::"
                                 "top_tree_construction");
 
@@ -179,6 +421,7 @@ DistributedTree<MemorySpace>::DistributedTree(MPI_Comm comm,
 #endif
 
   _top_tree = BVH<MemorySpace>{space, boxes};
+  _rank_bounds = boxes;
 
   Kokkos::Profiling::popRegion();
   Kokkos::Profiling::pushRegion("ArborX::DistributedTree::DistributedTree::"
@@ -202,7 +445,511 @@ DistributedTree<MemorySpace>::DistributedTree(MPI_Comm comm,
   _top_tree_size = accumulate(space, _bottom_tree_sizes, 0);
 
   Kokkos::Profiling::popRegion();
-  Kokkos::Profiling::popRegion();
+
+  _query_counts = Kokkos::View<long long *, MemorySpace>(
+      Kokkos::view_alloc(space, "ArborX::DistributedTree::query_counts"),
+      comm_size);
+  dropReplicas(space);
+  gatherRankPieces(space);
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+void DistributedTree<MemorySpace>::dropReplicas(ExecutionSpace const &space)
+{
+  int comm_size;
+  MPI_Comm_size(getComm(), &comm_size);
+  _replica_offsets = Kokkos::View<int *, MemorySpace>(
+      Kokkos::view_alloc(space, "ArborX::DistributedTree::replica_offsets"),
+      comm_size + 1);
+  _replica_holders = Kokkos::View<int *, MemorySpace>(
+      "ArborX::DistributedTree::replica_holders", 0);
+  _replica_tree = BVH<MemorySpace>{};
+  _replica_rank = -1;
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+float DistributedTree<MemorySpace>::overlap(ExecutionSpace const &space) const
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DistributedTree::overlap");
+
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+
+  int const comm_size = _rank_bounds.size();
+  auto const &rank_bounds = _rank_bounds;
+  using Predicate = decltype(attach(intersects(Box{}), int{}));
+  Kokkos::View<Predicate *, MemorySpace> predicates(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::overlap::predicates"),
+      comm_size);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::overlap::fill_predicates",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, comm_size),
+      KOKKOS_LAMBDA(int r) {
+        predicates(r) = attach(intersects(rank_bounds(r)), r);
+      });
+
+  Kokkos::View<int, MemorySpace> count(
+      Kokkos::view_alloc(space, "ArborX::DistributedTree::overlap::count"));
+  _top_tree.query(space, predicates,
+                  Details::CountOverlapsCallback<MemorySpace>{count});
+  auto const count_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, count);
+  return (float)count_host() / comm_size;
+}
+
+template <typename MemorySpace>
+void DistributedTree<MemorySpace>::setNodeAwareRouting(bool node_aware)
+{
+  if (!node_aware)
+  {
+    Details::setNodeAwareRouting(getComm(), MPI_COMM_NULL);
+    return;
+  }
+
+  int comm_rank;
+  MPI_Comm_rank(getComm(), &comm_rank);
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(getComm(), MPI_COMM_TYPE_SHARED, comm_rank,
+                      MPI_INFO_NULL, &node_comm);
+  Details::setNodeAwareRouting(getComm(), node_comm);
+  MPI_Comm_free(&node_comm);
+}
+
+template <typename MemorySpace>
+std::vector<long long> DistributedTree<MemorySpace>::queryCounts() const
+{
+  auto const query_counts_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, _query_counts);
+  std::vector<long long> query_counts(
+      query_counts_host.data(),
+      query_counts_host.data() + query_counts_host.size());
+  MPI_Allreduce(MPI_IN_PLACE, query_counts.data(), query_counts.size(),
+                MPI_LONG_LONG, MPI_SUM, getComm());
+  return query_counts;
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+void DistributedTree<MemorySpace>::balance(ExecutionSpace const &space,
+                                           float imbalance_threshold)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DistributedTree::balance");
+
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+
+  ARBORX_ASSERT(imbalance_threshold >= 1);
+
+  int comm_rank;
+  MPI_Comm_rank(getComm(), &comm_rank);
+  int comm_size;
+  MPI_Comm_size(getComm(), &comm_size);
+
+  auto const loads = queryCounts();
+  Kokkos::deep_copy(space, _query_counts, 0);
+  dropReplicas(space);
+
+  // All the processes take the same decisions. Going from the most loaded
+  // process, each one above the threshold gets enough helpers, taken from the
+  // least loaded ones, to bring the load per copy of its tree to the average.
+  double const average =
+      std::accumulate(loads.begin(), loads.end(), 0.) / comm_size;
+  std::vector<int> order(comm_size);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&loads](int i, int j) { return loads[i] > loads[j]; });
+  std::vector<std::vector<int>> holders(comm_size);
+  int last = comm_size - 1;
+  for (int k = 0; k < last && average > 0; ++k)
+  {
+    int const hot = order[k];
+    if (loads[hot] <= imbalance_threshold * average)
+      break;
+    int num_helpers = std::ceil(loads[hot] / average) - 1;
+    for (; num_helpers > 0 && last > k && loads[order[last]] < average;
+         --num_helpers)
+      holders[hot].push_back(order[last--]);
+  }
+
+  auto replica_offsets_host = Kokkos::create_mirror_view(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing), _replica_offsets);
+  std::vector<int> replica_holders;
+  replica_offsets_host(0) = 0;
+  for (int r = 0; r < comm_size; ++r)
+  {
+    for (int holder : holders[r])
+    {
+      replica_holders.push_back(holder);
+      if (holder == comm_rank)
+        _replica_rank = r;
+    }
+    replica_offsets_host(r + 1) = replica_holders.size();
+  }
+  if (replica_holders.empty())
+    return;
+  Kokkos::deep_copy(space, _replica_offsets, replica_offsets_host);
+  KokkosExt::reallocWithoutInitializing(space, _replica_holders,
+                                        replica_holders.size());
+  Kokkos::deep_copy(
+      space, _replica_holders,
+      Kokkos::View<int *, Kokkos::HostSpace,
+                   Kokkos::MemoryTraits<Kokkos::Unmanaged>>(
+          replica_holders.data(), replica_holders.size()));
+
+  // The replicas are built from the bounding boxes of the objects, in the
+  // order of their indices, so that the indices match those of the owner
+  MPI_Datatype box_type;
+  MPI_Type_contiguous(sizeof(Box), MPI_BYTE, &box_type);
+  MPI_Type_commit(&box_type);
+
+  auto const bottom_tree_sizes_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{}, _bottom_tree_sizes);
+  int const n = _bottom_tree.size();
+  Kokkos::View<Box *, Kokkos::HostSpace> boxes_host(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::balance::boxes"),
+      holders[comm_rank].empty() ? 0 : n);
+  std::vector<MPI_Request> requests;
+  if (!holders[comm_rank].empty())
+  {
+    Kokkos::View<Box *, MemorySpace> boxes(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedTree::balance::boxes"),
+        n);
+    auto const bottom_tree = _bottom_tree;
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::balance::extract_boxes",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          auto const &value =
+              Details::HappyTreeFriends::getValue(bottom_tree, i);
+          boxes(value.index) = value.bounding_volume;
+        });
+    Kokkos::deep_copy(space, boxes_host, boxes);
+    space.fence("ArborX::DistributedTree::balance"
+                " (copy done before sending the boxes)");
+    for (int holder : holders[comm_rank])
+    {
+      requests.emplace_back();
+      MPI_Isend(boxes_host.data(), n, box_type, holder, 0, getComm(),
+                &requests.back());
+    }
+  }
+  if (_replica_rank != -1)
+  {
+    int const replica_size = bottom_tree_sizes_host(_replica_rank);
+    Kokkos::View<Box *, Kokkos::HostSpace> replica_boxes_host(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                           "ArborX::DistributedTree::balance::replica_boxes"),
+        replica_size);
+    MPI_Recv(replica_boxes_host.data(), replica_size, box_type, _replica_rank,
+             0, getComm(), MPI_STATUS_IGNORE);
+    auto const replica_boxes = Kokkos::create_mirror_view_and_copy(
+        MemorySpace{}, replica_boxes_host);
+    _replica_tree = BVH<MemorySpace>{space, replica_boxes};
+  }
+  MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+  MPI_Type_free(&box_type);
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace, typename Primitives>
+void DistributedTree<MemorySpace>::update(ExecutionSpace const &space,
+                                          Primitives const &primitives)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DistributedTree::update");
+
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+
+  _bottom_tree = BVH<MemorySpace>(space, primitives);
+  refreshTopTree(space, true);
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+void DistributedTree<MemorySpace>::update(ExecutionSpace const &space)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DistributedTree::update");
+
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+
+  refreshTopTree(space, false);
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace, typename Primitives>
+float DistributedTree<MemorySpace>::refit(ExecutionSpace const &space,
+                                          Primitives const &primitives)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DistributedTree::refit");
+
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+
+  auto const ratio = _bottom_tree.refit(space, primitives);
+  refreshTopTree(space, true);
+  return ratio;
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+void DistributedTree<MemorySpace>::refreshTopTree(ExecutionSpace const &space,
+                                                  bool changed)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::top_tree_refresh");
+
+  int comm_rank;
+  MPI_Comm_rank(getComm(), &comm_rank);
+  int comm_size;
+  MPI_Comm_size(getComm(), &comm_size);
+
+  std::vector<int> changed_ranks(comm_size);
+  changed_ranks[comm_rank] = changed;
+  MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, changed_ranks.data(), 1,
+                MPI_INT, getComm());
+
+  // Only the ranks that changed contribute their bounds and sizes
+  struct RankUpdate
+  {
+    Box bounds;
+    size_type size;
+  };
+  std::vector<int> counts(comm_size);
+  std::vector<int> displs(comm_size + 1, 0);
+  for (int r = 0; r < comm_size; ++r)
+  {
+    counts[r] = (changed_ranks[r] ? sizeof(RankUpdate) : 0);
+    displs[r + 1] = displs[r] + counts[r];
+  }
+  int const num_changed = displs[comm_size] / sizeof(RankUpdate);
+  if (num_changed == 0)
+    return;
+
+  dropReplicas(space);
+
+  RankUpdate const local_update{_bottom_tree.bounds(), _bottom_tree.size()};
+  std::vector<RankUpdate> updates(num_changed);
+  MPI_Allgatherv(&local_update, counts[comm_rank], MPI_BYTE, updates.data(),
+                 counts.data(), displs.data(), MPI_BYTE, getComm());
+
+  auto rank_bounds_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, _rank_bounds);
+  auto bottom_tree_sizes_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{}, _bottom_tree_sizes);
+  for (int r = 0; r < comm_size; ++r)
+  {
+    if (!changed_ranks[r])
+      continue;
+    auto const &rank_update = updates[displs[r] / sizeof(RankUpdate)];
+    rank_bounds_host(r) = rank_update.bounds;
+    bottom_tree_sizes_host(r) = rank_update.size;
+  }
+  Kokkos::deep_copy(space, _rank_bounds, rank_bounds_host);
+  Kokkos::deep_copy(space, _bottom_tree_sizes, bottom_tree_sizes_host);
+
+  // The top tree is small, so rebuilding it is cheap, but refitting keeps its
+  // topology when the ranks only moved a little
+  constexpr float max_quality_ratio = 2.f;
+  if (_top_tree.refit(space, _rank_bounds) > max_quality_ratio)
+    _top_tree = BVH<MemorySpace>{space, _rank_bounds};
+
+  _top_tree_size = accumulate(space, _bottom_tree_sizes, 0);
+
+  gatherRankPieces(space);
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+void DistributedTree<MemorySpace>::setBoundsRefinement(
+    ExecutionSpace const &space, int max_boxes_per_process)
+{
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+
+  ARBORX_ASSERT(max_boxes_per_process >= 1);
+
+  _max_pieces_per_rank = max_boxes_per_process;
+  gatherRankPieces(space);
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace>
+void DistributedTree<MemorySpace>::gatherRankPieces(
+    ExecutionSpace const &space)
+{
+  if (_max_pieces_per_rank <= 1)
+  {
+    _rank_piece_offsets = Kokkos::View<int *, MemorySpace>(
+        "ArborX::DistributedTree::rank_piece_offsets", 0);
+    _rank_pieces = Kokkos::View<Box *, MemorySpace>(
+        "ArborX::DistributedTree::rank_pieces", 0);
+    return;
+  }
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::gather_rank_pieces");
+
+  int comm_rank;
+  MPI_Comm_rank(getComm(), &comm_rank);
+  int comm_size;
+  MPI_Comm_size(getComm(), &comm_size);
+
+  // Starting from the root, the node with the largest box, measured by the sum
+  // of its extents so that flat boxes are split too, is replaced by its
+  // children until there are enough nodes or only leaves are left
+  int const max_pieces = _max_pieces_per_rank;
+  Kokkos::View<int *, MemorySpace> nodes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::rank_pieces::nodes"),
+      max_pieces);
+  Kokkos::View<Box *, MemorySpace> pieces(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::rank_pieces::local"),
+      max_pieces);
+  Kokkos::View<int, MemorySpace> num_pieces(Kokkos::view_alloc(
+      space, "ArborX::DistributedTree::rank_pieces::num_pieces"));
+  auto const bottom_tree = _bottom_tree;
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::rank_pieces::split_local_bounds",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0,
+                                          bottom_tree.empty() ? 0 : 1),
+      KOKKOS_LAMBDA(int) {
+        using Details::HappyTreeFriends;
+        if (bottom_tree.size() == 1)
+        {
+          pieces(0) = bottom_tree.bounds();
+          num_pieces() = 1;
+          return;
+        }
+        auto const bounds = [&](int node) {
+          if (HappyTreeFriends::isLeaf(bottom_tree, node))
+            return Box(HappyTreeFriends::getIndexable(bottom_tree, node));
+          return Box(
+              HappyTreeFriends::getInternalBoundingVolume(bottom_tree, node));
+        };
+        auto const size = [](Box const &box) {
+          float s = 0;
+          for (int d = 0; d < 3; ++d)
+            s += box.maxCorner()[d] - box.minCorner()[d];
+          return s;
+        };
+        int n = 1;
+        nodes(0) = HappyTreeFriends::getRoot(bottom_tree);
+        while (n < max_pieces)
+        {
+          int largest = -1;
+          float largest_size = -1;
+          for (int i = 0; i < n; ++i)
+          {
+            if (HappyTreeFriends::isLeaf(bottom_tree, nodes(i)))
+              continue;
+            float const s = size(bounds(nodes(i)));
+            if (s > largest_size)
+            {
+              largest = i;
+              largest_size = s;
+            }
+          }
+          if (largest == -1)
+            break;
+          int const node = nodes(largest);
+          nodes(largest) = HappyTreeFriends::getLeftChild(bottom_tree, node);
+          nodes(n++) = HappyTreeFriends::getRightChild(bottom_tree, node);
+        }
+        for (int i = 0; i < n; ++i)
+          pieces(i) = bounds(nodes(i));
+        num_pieces() = n;
+      });
+
+  int const local_num_pieces =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, num_pieces)();
+  auto const local_pieces_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{},
+      Kokkos::subview(pieces, Kokkos::make_pair(0, local_num_pieces)));
+
+  std::vector<int> counts(comm_size);
+  counts[comm_rank] = local_num_pieces * sizeof(Box);
+  MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, counts.data(), 1, MPI_INT,
+                getComm());
+  std::vector<int> displs(comm_size + 1, 0);
+  for (int r = 0; r < comm_size; ++r)
+    displs[r + 1] = displs[r] + counts[r];
+
+  Kokkos::View<int *, Kokkos::HostSpace> offsets_host(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::rank_piece_offsets"),
+      comm_size + 1);
+  for (int r = 0; r <= comm_size; ++r)
+    offsets_host(r) = displs[r] / sizeof(Box);
+  Kokkos::View<Box *, Kokkos::HostSpace> pieces_host(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::rank_pieces"),
+      offsets_host(comm_size));
+  MPI_Allgatherv(local_pieces_host.data(), counts[comm_rank], MPI_BYTE,
+                 pieces_host.data(), counts.data(), displs.data(), MPI_BYTE,
+                 getComm());
+
+  _rank_piece_offsets =
+      Kokkos::create_mirror_view_and_copy(space, MemorySpace{}, offsets_host);
+  _rank_pieces =
+      Kokkos::create_mirror_view_and_copy(space, MemorySpace{}, pieces_host);
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace, typename Predicates, typename Ranks,
+          typename Offset>
+void DistributedTree<MemorySpace>::refineTopTreeHits(
+    ExecutionSpace const &space, Predicates const &predicates, Ranks &ranks,
+    Offset &offset) const
+{
+  if (_rank_pieces.size() == 0)
+    return;
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::refine_top_tree_hits");
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  int const n_queries = Access::size(predicates);
+
+  // A rank is kept if the predicate satisfies one of its boxes
+  auto const &piece_offsets = _rank_piece_offsets;
+  auto const &pieces = _rank_pieces;
+  auto const satisfies = KOKKOS_LAMBDA(int q, int rank)
+  {
+    auto const &predicate = Access::get(predicates, q);
+    for (int p = piece_offsets(rank); p < piece_offsets(rank + 1); ++p)
+      if (predicate(pieces(p)))
+        return true;
+    return false;
+  };
+
+  Kokkos::View<int *, MemorySpace> new_offset(
+      Kokkos::view_alloc(space, offset.label()), n_queries + 1);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::refine_top_tree_hits::count",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        for (int j = offset(q); j < offset(q + 1); ++j)
+          if (satisfies(q, ranks(j)))
+            ++new_offset(q);
+      });
+
+  exclusivePrefixSum(space, new_offset);
+
+  Kokkos::View<int *, MemorySpace> new_ranks(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing, ranks.label()),
+      KokkosExt::lastElement(space, new_offset));
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::refine_top_tree_hits::fill",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        int k = new_offset(q);
+        for (int j = offset(q); j < offset(q + 1); ++j)
+          if (satisfies(q, ranks(j)))
+            new_ranks(k++) = ranks(j);
+      });
+
+  offset = new_offset;
+  ranks = new_ranks;
 }
 
 } // namespace ArborX
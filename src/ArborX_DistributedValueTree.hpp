@@ -0,0 +1,245 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DISTRIBUTED_VALUE_TREE_HPP
+#define ARBORX_DISTRIBUTED_VALUE_TREE_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // expand
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DistributedTree.hpp>
+#include <ArborX_IndexableGetter.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+#include <utility>
+
+#include <mpi.h>
+
+namespace ArborX
+{
+namespace Details
+{
+// Outputs the projection of the value found, on the process that owns it
+template <typename Values, typename Projection>
+struct ProjectValueCallback
+{
+  Values _values;
+  Projection _projection;
+
+  template <typename Predicate, typename OutputFunctor>
+  KOKKOS_FUNCTION void operator()(Predicate const &, int index,
+                                  OutputFunctor const &out) const
+  {
+    out(_projection(_values(index)));
+  }
+};
+
+struct IdentityProjection
+{
+  template <typename Value>
+  KOKKOS_FUNCTION Value const &operator()(Value const &value) const
+  {
+    return value;
+  }
+};
+
+// Bounding boxes of the indexables of the values, to build the local trees
+template <typename Values, typename IndexableGetter>
+struct IndexableBoxes
+{
+  Values _values;
+  IndexableGetter _indexable_getter;
+};
+} // namespace Details
+
+template <typename Values, typename IndexableGetter>
+struct AccessTraits<Details::IndexableBoxes<Values, IndexableGetter>,
+                    PrimitivesTag>
+{
+  using Self = Details::IndexableBoxes<Values, IndexableGetter>;
+
+  using memory_space = typename Values::memory_space;
+  static KOKKOS_FUNCTION auto size(Self const &x) { return x._values.size(); }
+  static KOKKOS_FUNCTION Box get(Self const &x, int i)
+  {
+    Box box;
+    Details::expand(box, x._indexable_getter(x._values(i)));
+    return box;
+  }
+};
+
+namespace Experimental
+{
+
+/** \brief Distributed search tree over user values
+ *
+ *  Same as DistributedTree, but the local trees are built over values whose
+ *  indexables are returned by the indexable getter, and queries send back
+ *  the values found, or a projection of them, instead of the indices and
+ *  ranks of the objects. The values or projections must be trivially
+ *  copyable, as they are communicated as bytes.
+ *
+ *  \code
+ *  struct Particle { ArborX::Point position; float mass; };
+ *  struct GetPosition {
+ *    KOKKOS_FUNCTION auto const &operator()(Particle const &p) const
+ *    { return p.position; }
+ *  };
+ *  struct GetMass {
+ *    KOKKOS_FUNCTION float operator()(Particle const &p) const
+ *    { return p.mass; }
+ *  };
+ *  ArborX::Experimental::DistributedValueTree<MemorySpace, Particle,
+ *                                             GetPosition>
+ *      tree(comm, space, particles);
+ *  Kokkos::View<float *, MemorySpace> masses("masses", 0);
+ *  Kokkos::View<int *, MemorySpace> offset("offset", 0);
+ *  tree.query(space, predicates, GetMass{}, masses, offset);
+ *  \endcode
+ *
+ *  \note query() must be called as collective over all processes in the
+ *  communicator passed to the constructor.
+ */
+template <typename MemorySpace, typename Value,
+          typename IndexableGetter = Details::DefaultIndexableGetter>
+class DistributedValueTree
+{
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using value_type = Value;
+  static_assert(std::is_trivially_copyable_v<Value>);
+  using size_type = typename DistributedTree<MemorySpace>::size_type;
+  using bounding_volume_type =
+      typename DistributedTree<MemorySpace>::bounding_volume_type;
+
+  template <typename ExecutionSpace, typename Values>
+  DistributedValueTree(MPI_Comm comm, ExecutionSpace const &space,
+                       Values const &values,
+                       IndexableGetter const &indexable_getter = {});
+
+  bounding_volume_type bounds() const noexcept { return _tree.bounds(); }
+
+  size_type size() const noexcept { return _tree.size(); }
+
+  bool empty() const noexcept { return _tree.empty(); }
+
+  /** Returns the tree over the indexables of the values, whose indices are
+   *  those of the local values.
+   */
+  DistributedTree<MemorySpace> const &tree() const noexcept { return _tree; }
+
+  /** \brief Finds the values satisfying the passed spatial or nearest
+   *  predicates and sends them back
+   *
+   *  \c values(o) for <code>offset(q) <= o < offset(q+1)</code> satisfy
+   *  \c predicates(q). Optional arguments, e.g. the strategy of the nearest
+   *  queries, are the ones of DistributedTree::query().
+   */
+  template <typename ExecutionSpace, typename Predicates, typename Values,
+            typename Offset, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<Values> && Kokkos::is_view_v<Offset>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        Values &values, Offset &offset, Args &&...args) const
+  {
+    query(space, predicates, Details::IdentityProjection{}, values, offset,
+          std::forward<Args>(args)...);
+  }
+
+  /** \brief Finds the values satisfying the passed spatial or nearest
+   *  predicates and sends back their projections
+   *
+   *  The projection is called with each value found on the process that owns
+   *  it, so that only its output is communicated back.
+   */
+  template <typename ExecutionSpace, typename Predicates, typename Projection,
+            typename Outputs, typename Offset, typename... Args>
+  std::enable_if_t<!Kokkos::is_view_v<Projection> &&
+                   Kokkos::is_view_v<Outputs> && Kokkos::is_view_v<Offset>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        Projection const &projection, Outputs &outputs, Offset &offset,
+        Args &&...args) const
+  {
+    static_assert(
+        KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+    using Access = AccessTraits<Predicates, PredicatesTag>;
+    using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+    static_assert(std::is_same_v<Tag, Details::SpatialPredicateTag> ||
+                      std::is_same_v<Tag, Details::NearestPredicateTag>,
+                  "Only spatial and nearest predicates are supported");
+
+    KokkosExt::ScopedProfileRegion guard(
+        "ArborX::DistributedValueTree::query");
+
+    _tree.query(space, predicates,
+                Details::ProjectValueCallback<decltype(_values), Projection>{
+                    _values, projection},
+                outputs, offset, std::forward<Args>(args)...);
+  }
+
+private:
+  template <typename ExecutionSpace, typename Values>
+  static Kokkos::View<Value *, MemorySpace>
+  copyValues(ExecutionSpace const &space, Values const &values);
+
+  Kokkos::View<Value *, MemorySpace> _values; // local
+  DistributedTree<MemorySpace> _tree;
+};
+
+template <typename MemorySpace, typename Value, typename IndexableGetter>
+template <typename ExecutionSpace, typename Values>
+DistributedValueTree<MemorySpace, Value, IndexableGetter>::DistributedValueTree(
+    MPI_Comm comm, ExecutionSpace const &space, Values const &values,
+    IndexableGetter const &indexable_getter)
+    : _values(copyValues(space, values))
+    , _tree(comm, space,
+            Details::IndexableBoxes<decltype(_values), IndexableGetter>{
+                _values, indexable_getter})
+{}
+
+template <typename MemorySpace, typename Value, typename IndexableGetter>
+template <typename ExecutionSpace, typename Values>
+Kokkos::View<Value *, MemorySpace>
+DistributedValueTree<MemorySpace, Value, IndexableGetter>::copyValues(
+    ExecutionSpace const &space, Values const &values)
+{
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, values);
+  using Access = AccessTraits<Values, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Values must be accessible from the execution space");
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedValueTree::copy_values");
+
+  int const n = Access::size(values);
+  Kokkos::View<Value *, MemorySpace> local_values(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedValueTree::values"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::DistributedValueTree::copy_values",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) { local_values(i) = Access::get(values, i); });
+  return local_values;
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
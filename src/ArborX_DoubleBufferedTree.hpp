@@ -0,0 +1,106 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DOUBLE_BUFFERED_TREE_HPP
+#define ARBORX_DOUBLE_BUFFERED_TREE_HPP
+
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_Exception.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <utility>
+
+namespace ArborX
+{
+namespace Experimental
+{
+
+/** \brief Pair of trees, one searched while the other is built, e.g. over
+ *  consecutive frames of streaming data
+ *
+ *  The queries go to the front tree, and build() replaces the back tree with
+ *  a tree constructed on the given instance, typically another one than that
+ *  of the queries, e.g. obtained from
+ *  Kokkos::Experimental::partition_space(). The construction of the next
+ *  frame then overlaps the queries of the current one, as long as they are
+ *  launched before it. swap() hands the back tree over to the queries: it
+ *  waits for its construction, and for the queries of the front tree, which
+ *  becomes the back tree to be rebuilt.
+ *
+ *  \note The construction may still synchronize the host with the instance
+ *  it runs on, but not with that of the queries.
+ */
+template <typename Tree>
+class DoubleBufferedTree
+{
+public:
+  using memory_space = typename Tree::memory_space;
+  using size_type = typename Tree::size_type;
+  using bounding_volume_type = typename Tree::bounding_volume_type;
+
+  DoubleBufferedTree() = default; // two empty trees
+
+  // Tree searched by the queries
+  Tree const &front() const noexcept { return _trees[_front]; }
+
+  size_type size() const noexcept { return front().size(); }
+
+  bool empty() const noexcept { return front().empty(); }
+
+  bounding_volume_type bounds() const noexcept { return front().bounds(); }
+
+  // Whether a tree was built since the last swap
+  bool backReady() const noexcept { return _back_ready; }
+
+  // Construct the back tree on the instance, from the same arguments as the
+  // constructors of the tree. The back tree must not be searched anymore,
+  // which swap() guarantees.
+  template <typename ExecutionSpace, typename... Args>
+  void build(ExecutionSpace const &space, Args &&...args)
+  {
+    KokkosExt::ScopedProfileRegion guard("ArborX::DoubleBufferedTree::build");
+    _trees[1 - _front] = Tree(space, std::forward<Args>(args)...);
+    _back_ready = true;
+  }
+
+  // Make the tree constructed on the build instance the front tree, once the
+  // construction and the queries launched on the query instance completed
+  template <typename BuildExecutionSpace, typename QueryExecutionSpace>
+  void swap(BuildExecutionSpace const &build_space,
+            QueryExecutionSpace const &query_space)
+  {
+    ARBORX_ASSERT(_back_ready);
+    KokkosExt::ScopedProfileRegion guard("ArborX::DoubleBufferedTree::swap");
+    build_space.fence("ArborX::DoubleBufferedTree::swap (wait for the "
+                      "construction of the back tree)");
+    query_space.fence("ArborX::DoubleBufferedTree::swap (wait for the "
+                      "queries of the front tree)");
+    _front = 1 - _front;
+    _back_ready = false;
+  }
+
+  template <typename ExecutionSpace, typename... Args>
+  void query(ExecutionSpace const &space, Args &&...args) const
+  {
+    front().query(space, std::forward<Args>(args)...);
+  }
+
+private:
+  Tree _trees[2];
+  int _front = 0;
+  bool _back_ready = false;
+};
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
@@ -0,0 +1,363 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DYNAMIC_BVH_HPP
+#define ARBORX_DYNAMIC_BVH_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsDynamicBVHImpl.hpp>
+#include <ArborX_DetailsForestTraversal.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace ArborX::Experimental
+{
+
+// Bounding volume hierarchy supporting the insertion and the removal of
+// primitives. The primitives are spread over trees of decreasing sizes, as in
+// a log-structured merge tree. A batch of inserted primitives is merged into a
+// new tree with the smallest trees, until the preceding one is more than
+// twice as large, so that there are O(log n) trees and the cost of the
+// insertions is amortized to O(log n) per primitive.
+// Removed primitives are marked and skipped by the queries until the tree
+// holding them is merged, everything being rebuilt once they outnumber the
+// live ones. The nodes of all the trees are stored contiguously, the largest
+// trees first, and each query searches all of them in a single kernel
+// launch. Callbacks are given the identifiers of the primitives, which are
+// attributed consecutively by insert(). Only spatial queries are supported.
+template <typename MemorySpace, typename BoundingVolume = Box>
+class DynamicBoundingVolumeHierarchy
+{
+  using tree_type =
+      BasicBoundingVolumeHierarchy<MemorySpace,
+                                   Details::PairIndexVolume<BoundingVolume>,
+                                   Details::DefaultIndexableGetter,
+                                   BoundingVolume>;
+  using leaf_nodes_type = std::decay_t<decltype(
+      Details::HappyTreeFriends::getLeafNodes(std::declval<tree_type>()))>;
+  using internal_nodes_type =
+      std::decay_t<decltype(Details::HappyTreeFriends::getInternalNodes(
+          std::declval<tree_type>()))>;
+
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using size_type = typename MemorySpace::size_type;
+  using bounding_volume_type = BoundingVolume;
+
+  DynamicBoundingVolumeHierarchy() = default; // build an empty tree
+
+  template <typename ExecutionSpace, typename Primitives>
+  DynamicBoundingVolumeHierarchy(ExecutionSpace const &space,
+                                 Primitives const &primitives)
+  {
+    insert(space, primitives);
+  }
+
+  // Number of primitives that were inserted and not removed
+  KOKKOS_FUNCTION
+  size_type size() const noexcept { return _size; }
+
+  KOKKOS_FUNCTION
+  bool empty() const noexcept { return size() == 0; }
+
+  // Union of the bounds of the trees, which may still account for removed
+  // primitives
+  KOKKOS_FUNCTION
+  bounding_volume_type bounds() const noexcept { return _bounds; }
+
+  int numberOfTrees() const noexcept { return (int)_tree_offsets.size() - 1; }
+
+  // Insert the primitives and return the identifier of the first one, the
+  // others following consecutively
+  template <typename ExecutionSpace, typename Primitives>
+  size_type insert(ExecutionSpace const &space, Primitives const &primitives);
+
+  // Remove the primitives with the given identifiers, which must have been
+  // returned by insert(). Those already removed are ignored.
+  template <typename ExecutionSpace, typename Ids>
+  void remove(ExecutionSpace const &space, Ids const &ids);
+
+  // Rebuild a single tree without the removed primitives
+  template <typename ExecutionSpace>
+  void compact(ExecutionSpace const &space);
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback,
+             TraversalPolicy const &policy = TraversalPolicy()) const;
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+
+private:
+  // Replace the trees from first_tree on by a single one holding the n
+  // primitives already in bounding_volumes and ids, and the live primitives
+  // of the replaced trees
+  template <typename ExecutionSpace>
+  void mergeTrees(ExecutionSpace const &space, int first_tree,
+                  Kokkos::View<bounding_volume_type *, MemorySpace> const
+                      &bounding_volumes,
+                  Kokkos::View<unsigned *, MemorySpace> const &ids, int n);
+
+  size_type _size{0};
+  size_type _next_id{0};
+  bounding_volume_type _bounds;
+  // Copies on the host of the offsets and the bounds of the trees
+  std::vector<Details::ForestTreeOffsets> _tree_offsets{
+      Details::ForestTreeOffsets{0, 0}};
+  std::vector<bounding_volume_type> _tree_bounds;
+  Kokkos::View<int *, MemorySpace> _removed;
+  Details::Forest<leaf_nodes_type, internal_nodes_type, bounding_volume_type,
+                  Details::DefaultIndexableGetter>
+      _forest;
+};
+
+template <typename MemorySpace, typename BoundingVolume>
+template <typename ExecutionSpace, typename Primitives>
+typename MemorySpace::size_type
+DynamicBoundingVolumeHierarchy<MemorySpace, BoundingVolume>::insert(
+    ExecutionSpace const &space, Primitives const &primitives)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::DynamicBVH::insert");
+
+  size_type const first_id = _next_id;
+  int const n = Access::size(primitives);
+  if (n == 0)
+    return first_id;
+  _next_id += n;
+  _size += n;
+
+  // New primitives are not removed
+  if (_removed.extent(0) < _next_id)
+  {
+    if (_removed.data() == nullptr)
+      _removed = Kokkos::View<int *, MemorySpace>(
+          Kokkos::view_alloc(space, "ArborX::DynamicBVH::removed"), _next_id);
+    else
+      Kokkos::resize(Kokkos::view_alloc(space), _removed,
+                     KokkosExt::max((size_t)_next_id, 2 * _removed.extent(0)));
+  }
+
+  // Merge the smallest trees as long as they are not more than twice as large
+  // as the primitives to merge them with
+  int first_tree = numberOfTrees();
+  int merged_size = n;
+  while (first_tree > 0)
+  {
+    int const tree_size = _tree_offsets[first_tree].leaf_nodes -
+                          _tree_offsets[first_tree - 1].leaf_nodes;
+    if (tree_size > 2 * merged_size)
+      break;
+    merged_size += tree_size;
+    --first_tree;
+  }
+
+  Kokkos::View<bounding_volume_type *, MemorySpace> bounding_volumes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DynamicBVH::bounding_volumes"),
+      merged_size);
+  Kokkos::View<unsigned *, MemorySpace> ids(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DynamicBVH::ids"),
+      merged_size);
+  Kokkos::parallel_for(
+      "ArborX::DynamicBVH::insert::initialize_values",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        using Details::expand;
+        bounding_volume_type bounding_volume{};
+        expand(bounding_volume, Access::get(primitives, i));
+        bounding_volumes(i) = bounding_volume;
+        ids(i) = first_id + i;
+      });
+
+  mergeTrees(space, first_tree, bounding_volumes, ids, n);
+
+  return first_id;
+}
+
+template <typename MemorySpace, typename BoundingVolume>
+template <typename ExecutionSpace, typename Ids>
+void DynamicBoundingVolumeHierarchy<MemorySpace, BoundingVolume>::remove(
+    ExecutionSpace const &space, Ids const &ids)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  static_assert(Kokkos::is_view_v<Ids> && Ids::rank == 1);
+  static_assert(KokkosExt::is_accessible_from<typename Ids::memory_space,
+                                              ExecutionSpace>::value,
+                "Identifiers must be accessible from the execution space");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::DynamicBVH::remove");
+
+  auto const &removed = _removed;
+  int count = 0;
+  Kokkos::parallel_reduce(
+      "ArborX::DynamicBVH::remove::mark_removed",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, ids.extent(0)),
+      KOKKOS_LAMBDA(int i, int &update) {
+        if (Kokkos::atomic_exchange(&removed(ids(i)), 1) == 0)
+          ++update;
+      },
+      count);
+  _size -= count;
+
+  if (_tree_offsets.back().leaf_nodes > 2 * (int)_size)
+    compact(space);
+}
+
+template <typename MemorySpace, typename BoundingVolume>
+template <typename ExecutionSpace>
+void DynamicBoundingVolumeHierarchy<MemorySpace, BoundingVolume>::compact(
+    ExecutionSpace const &space)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DynamicBVH::compact");
+
+  int const n = _tree_offsets.back().leaf_nodes;
+  mergeTrees(space, 0,
+             Kokkos::View<bounding_volume_type *, MemorySpace>(
+                 Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                    "ArborX::DynamicBVH::bounding_volumes"),
+                 n),
+             Kokkos::View<unsigned *, MemorySpace>(
+                 Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                    "ArborX::DynamicBVH::ids"),
+                 n),
+             0);
+}
+
+template <typename MemorySpace, typename BoundingVolume>
+template <typename ExecutionSpace>
+void DynamicBoundingVolumeHierarchy<MemorySpace, BoundingVolume>::mergeTrees(
+    ExecutionSpace const &space, int first_tree,
+    Kokkos::View<bounding_volume_type *, MemorySpace> const &bounding_volumes,
+    Kokkos::View<unsigned *, MemorySpace> const &ids, int n)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::DynamicBVH::merge_trees");
+
+  using Details::DynamicBVHImpl;
+
+  for (int t = first_tree; t < numberOfTrees(); ++t)
+    n += DynamicBVHImpl::gatherLiveValues(
+        space,
+        Kokkos::subview(_forest._leaf_nodes,
+                        Kokkos::make_pair(_tree_offsets[t].leaf_nodes,
+                                          _tree_offsets[t + 1].leaf_nodes)),
+        _removed, bounding_volumes, ids, n);
+  _tree_offsets.resize(first_tree + 1);
+  _tree_bounds.resize(first_tree);
+
+  if (n > 0)
+  {
+    tree_type const tree(
+        space, Kokkos::subview(bounding_volumes, Kokkos::make_pair(0, n)));
+
+    auto const begin = _tree_offsets.back();
+    Details::ForestTreeOffsets const end{
+        begin.leaf_nodes + n, begin.internal_nodes + (n > 1 ? n - 1 : 0)};
+    DynamicBVHImpl::reserve(space, _forest._leaf_nodes, end.leaf_nodes,
+                            "ArborX::DynamicBVH::leaf_nodes");
+    DynamicBVHImpl::reserve(space, _forest._internal_nodes,
+                            end.internal_nodes,
+                            "ArborX::DynamicBVH::internal_nodes");
+    DynamicBVHImpl::copyNodes(
+        space, tree, ids,
+        Kokkos::subview(_forest._leaf_nodes,
+                        Kokkos::make_pair(begin.leaf_nodes, end.leaf_nodes)),
+        Kokkos::subview(_forest._internal_nodes,
+                        Kokkos::make_pair(begin.internal_nodes,
+                                          end.internal_nodes)));
+    _tree_offsets.push_back(end);
+    _tree_bounds.push_back(tree.bounds());
+  }
+
+  _bounds = {};
+  for (auto const &tree_bounds : _tree_bounds)
+    Details::expand(_bounds, tree_bounds);
+
+  int const num_trees = numberOfTrees();
+  _forest._offsets = decltype(_forest._offsets)(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DynamicBVH::offsets"),
+      num_trees + 1);
+  Kokkos::deep_copy(
+      _forest._offsets,
+      Kokkos::View<Details::ForestTreeOffsets const *, Kokkos::HostSpace,
+                   Kokkos::MemoryUnmanaged>(_tree_offsets.data(),
+                                            num_trees + 1));
+  _forest._bounds = decltype(_forest._bounds)(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DynamicBVH::bounds"),
+      num_trees);
+  Kokkos::deep_copy(
+      _forest._bounds,
+      Kokkos::View<bounding_volume_type const *, Kokkos::HostSpace,
+                   Kokkos::MemoryUnmanaged>(_tree_bounds.data(), num_trees));
+}
+
+template <typename MemorySpace, typename BoundingVolume>
+template <typename ExecutionSpace, typename Predicates, typename Callback>
+void DynamicBoundingVolumeHierarchy<MemorySpace, BoundingVolume>::query(
+    ExecutionSpace const &space, Predicates const &predicates,
+    Callback const &callback, TraversalPolicy const &) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{},
+                "nearest query not implemented yet");
+  using Value = int;
+  Details::check_valid_callback<Value>(callback, predicates);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::DynamicBVH::query::spatial");
+
+  Details::traverseAllTreesOfForest(
+      space, _forest, predicates,
+      Details::DynamicBVHCallback<Callback, decltype(_removed)>{callback,
+                                                                _removed});
+}
+
+} // namespace ArborX::Experimental
+
+#endif
@@ -12,8 +12,16 @@
 #define ARBORX_HDBSCAN_HPP
 
 #include <ArborX_Dendrogram.hpp>
+#include <ArborX_DetailsCondensedTree.hpp>
+#include <ArborX_DetailsAllNearestNeighbors.hpp>
 #include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_LinearBVH.hpp>
 #include <ArborX_MinimumSpanningTree.hpp>
+#include <ArborX_PhaseTimings.hpp>
+
+#include <Kokkos_Core.hpp>
 
 namespace ArborX::Experimental
 {
@@ -22,9 +30,10 @@ template <typename ExecutionSpace, typename Primitives>
 auto hdbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
              int core_min_size,
              DendrogramImplementation dendrogram_impl =
-                 DendrogramImplementation::BORUVKA)
+                 DendrogramImplementation::BORUVKA,
+             PhaseTimings *timings = nullptr)
 {
-  KokkosExt::ScopedProfileRegion guard("ArborX::HDBSCAN");
+  Details::ScopedPhase guard(exec_space, timings, "ArborX::HDBSCAN");
 
   using namespace ArborX::Details;
 
@@ -34,22 +43,139 @@ auto hdbscan(ExecutionSpace const &exec_space, Primitives const &primitives,
   {
     // Hybrid Boruvka+dendrogram
     MinimumSpanningTree<MemorySpace, BoruvkaMode::HDBSCAN> mst(
-        exec_space, primitives, core_min_size);
+        exec_space, primitives, core_min_size, 0, nullptr, timings);
     return Dendrogram<MemorySpace>{mst.dendrogram_parents,
                                    mst.dendrogram_parent_heights};
   }
 
-  Kokkos::Profiling::pushRegion("ArborX::HDBSCAN::mst");
-  MinimumSpanningTree<MemorySpace> mst(exec_space, primitives, core_min_size);
-  Kokkos::Profiling::popRegion();
+  Details::pushPhase(exec_space, timings, "ArborX::HDBSCAN::mst");
+  MinimumSpanningTree<MemorySpace> mst(exec_space, primitives, core_min_size,
+                                       0, nullptr, timings);
+  Details::popPhase(exec_space, timings);
 
-  Kokkos::Profiling::pushRegion("ArborX::HDBSCAN::dendrogram");
-  Dendrogram<MemorySpace> dendrogram(exec_space, mst.edges);
-  Kokkos::Profiling::popRegion();
+  Details::pushPhase(exec_space, timings, "ArborX::HDBSCAN::dendrogram");
+  Dendrogram<MemorySpace> dendrogram(exec_space, mst.edges, dendrogram_impl);
+  Details::popPhase(exec_space, timings);
 
   return dendrogram;
 }
 
+// Reusable state for running HDBSCAN several times over the same points with
+// different core_min_size, e.g., for a sweep. The hierarchy and the distances
+// of each point to its nearest neighbors, up to max_core_min_size of them,
+// are computed once. Each dendrogram then only requires the Boruvka
+// iterations over the corresponding mutual reachability distances.
+template <typename MemorySpace, int DIM = 3>
+class HDBSCANEngine
+{
+  using Box = ExperimentalHyperGeometry::Box<DIM>;
+  using BVH = BasicBoundingVolumeHierarchy<MemorySpace,
+                                           Details::PairIndexVolume<Box>>;
+
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+
+  template <typename ExecutionSpace, typename Primitives>
+  HDBSCANEngine(ExecutionSpace const &exec_space, Primitives const &primitives,
+                int max_core_min_size, PhaseTimings *timings = nullptr)
+      : _max_core_min_size(max_core_min_size)
+  {
+    Details::ScopedPhase guard(exec_space, timings, "ArborX::HDBSCANEngine");
+
+    using Access = AccessTraits<Primitives, PrimitivesTag>;
+    static_assert(
+        GeometryTraits::dimension_v<
+            typename Details::AccessTraitsHelper<Access>::type> == DIM,
+        "Primitives must be of the same dimension as the engine");
+
+    ARBORX_ASSERT(max_core_min_size >= 1);
+
+    Details::pushPhase(exec_space, timings,
+                       "ArborX::HDBSCANEngine::construction");
+    _bvh = BVH(exec_space, primitives);
+    Details::popPhase(exec_space, timings);
+
+    if (max_core_min_size > 1)
+    {
+      Details::pushPhase(exec_space, timings,
+                         "ArborX::HDBSCANEngine::compute_neighbor_distances");
+      _neighbor_distances = Kokkos::View<float **, MemorySpace>(
+          Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                             "ArborX::HDBSCANEngine::neighbor_distances"),
+          _bvh.size(), max_core_min_size);
+      Details::KthNearestNeighborDistances(exec_space, _bvh, max_core_min_size,
+                                           _neighbor_distances);
+      Details::popPhase(exec_space, timings);
+    }
+  }
+
+  template <typename ExecutionSpace>
+  Dendrogram<MemorySpace>
+  dendrogram(ExecutionSpace const &exec_space, int core_min_size,
+             DendrogramImplementation dendrogram_impl =
+                 DendrogramImplementation::BORUVKA,
+             PhaseTimings *timings = nullptr) const
+  {
+    Details::ScopedPhase guard(exec_space, timings,
+                               "ArborX::HDBSCANEngine::dendrogram");
+
+    ARBORX_ASSERT(core_min_size >= 1 && core_min_size <= _max_core_min_size);
+
+    Kokkos::View<float *, MemorySpace> core_distances(
+        "ArborX::HDBSCANEngine::core_distances", 0);
+    if (core_min_size > 1)
+    {
+      KokkosExt::reallocWithoutInitializing(exec_space, core_distances,
+                                            _bvh.size());
+      Kokkos::deep_copy(exec_space, core_distances,
+                        Kokkos::subview(_neighbor_distances, Kokkos::ALL,
+                                        core_min_size - 1));
+    }
+
+    if (dendrogram_impl == DendrogramImplementation::BORUVKA)
+    {
+      Details::MinimumSpanningTree<MemorySpace, Details::BoruvkaMode::HDBSCAN>
+          mst(exec_space, _bvh, core_distances, nullptr, timings);
+      return Dendrogram<MemorySpace>{mst.dendrogram_parents,
+                                     mst.dendrogram_parent_heights};
+    }
+
+    Details::pushPhase(exec_space, timings, "ArborX::HDBSCANEngine::mst");
+    Details::MinimumSpanningTree<MemorySpace> mst(exec_space, _bvh,
+                                                  core_distances, nullptr,
+                                                  timings);
+    Details::popPhase(exec_space, timings);
+
+    Details::pushPhase(exec_space, timings,
+                       "ArborX::HDBSCANEngine::dendrogram");
+    Dendrogram<MemorySpace> dendrogram(exec_space, mst.edges, dendrogram_impl);
+    Details::popPhase(exec_space, timings);
+
+    return dendrogram;
+  }
+
+private:
+  BVH _bvh;
+  int _max_core_min_size;
+  // Distance of each point to its nearest neighbors, itself included,
+  // indexed by the points
+  Kokkos::View<float **, MemorySpace> _neighbor_distances;
+};
+
+// Select the flat HDBSCAN clusters from the condensed tree of the dendrogram
+// by excess of mass. Points are labeled with consecutive cluster indices
+// starting from 0, and noise points with -1.
+template <typename ExecutionSpace, typename MemorySpace>
+Kokkos::View<int *, MemorySpace>
+extractClusters(ExecutionSpace const &exec_space,
+                Dendrogram<MemorySpace> const &dendrogram, int min_cluster_size)
+{
+  return Details::condensedTreeLabels(exec_space, dendrogram._parents,
+                                      dendrogram._parent_heights,
+                                      min_cluster_size);
+}
+
 } // namespace ArborX::Experimental
 
 #endif
@@ -0,0 +1,366 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_INSTANCE_PARTITIONED_BVH_HPP
+#define ARBORX_INSTANCE_PARTITIONED_BVH_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_Callbacks.hpp>         // DefaultCallback
+#include <ArborX_DetailsAlgorithms.hpp> // expand
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp> // lastElement
+#include <ArborX_DetailsSortUtils.hpp>            // sortObjects
+#include <ArborX_DetailsTwoPassCallbacks.hpp>
+#include <ArborX_DetailsUtils.hpp> // exclusivePrefixSum
+#include <ArborX_Exception.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_Predicates.hpp>
+#include <ArborX_SpaceFillingCurves.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace ArborX
+{
+namespace Experimental
+{
+
+/** \brief Hierarchy split into parts that are built and searched on their
+ *  own execution space instances of a single device
+ *
+ *  The primitives are cut along the Morton curve into as many parts of about
+ *  the same size as there are instances, and each part gets a hierarchy
+ *  built on its instance. The parts are bounded by a top tree, so that a
+ *  predicate is only searched in the parts whose bounds it satisfies. The
+ *  searches of the parts are launched one after the other without waiting,
+ *  and so overlap on the instances, e.g. obtained from
+ *  Kokkos::Experimental::partition_space(). Only spatial predicates are
+ *  supported. The results of a predicate come in no particular order.
+ *
+ *  \note All the parts reside in \c MemorySpace, which must be accessible
+ *  from all the instances. The instances are not meant to run on different
+ *  devices, e.g. several GPUs, as nothing is copied between them; use
+ *  DistributedTree with a rank per device instead.
+ */
+template <typename MemorySpace>
+class InstancePartitionedBVH
+{
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using size_type = typename BVH<MemorySpace>::size_type;
+  using bounding_volume_type = Box;
+
+  InstancePartitionedBVH() = default; // build an empty hierarchy
+
+  template <typename ExecutionSpace, typename Primitives>
+  InstancePartitionedBVH(std::vector<ExecutionSpace> const &instances,
+                         Primitives const &primitives);
+
+  size_type size() const noexcept { return _size; }
+
+  bool empty() const noexcept { return size() == 0; }
+
+  bounding_volume_type bounds() const noexcept { return _top_tree.bounds(); }
+
+  // Number of parts, one per instance
+  int numberOfParts() const noexcept { return _trees.size(); }
+
+  /** Finds the primitives satisfying the spatial predicates, given by their
+   *  indices in \c indices, in compressed row storage format. The parts are
+   *  searched on the instances they were built on, given in the same order
+   *  as at construction, and the top tree on the first one.
+   */
+  template <typename ExecutionSpace, typename Predicates, typename Indices,
+            typename Offset>
+  std::enable_if_t<Kokkos::is_view_v<Indices> && Kokkos::is_view_v<Offset>>
+  query(std::vector<ExecutionSpace> const &instances,
+        Predicates const &predicates, Indices &indices, Offset &offset) const
+  {
+    query(instances, predicates, Details::DefaultCallback{}, indices, offset);
+  }
+
+  /** Same as above, but the output of the callback, called as
+   *  callback(predicate, index, out) on the instance of the part of the
+   *  primitive, is stored in place of the index. The callback is called twice
+   *  for each pair, once to count and once to store its output.
+   */
+  template <typename ExecutionSpace, typename Predicates, typename Callback,
+            typename Out, typename Offset>
+  std::enable_if_t<!Kokkos::is_view_v<Callback> && Kokkos::is_view_v<Out> &&
+                   Kokkos::is_view_v<Offset>>
+  query(std::vector<ExecutionSpace> const &instances,
+        Predicates const &predicates, Callback const &callback, Out &out,
+        Offset &offset) const;
+
+private:
+  // The primitive of the leaf i of part p is primitives(_indices[p](i))
+  std::vector<BVH<MemorySpace>> _trees;
+  std::vector<Kokkos::View<unsigned *, MemorySpace>> _indices;
+  BVH<MemorySpace> _top_tree;
+  size_type _size = 0;
+};
+
+template <typename MemorySpace>
+template <typename ExecutionSpace, typename Primitives>
+InstancePartitionedBVH<MemorySpace>::InstancePartitionedBVH(
+    std::vector<ExecutionSpace> const &instances, Primitives const &primitives)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+
+  ARBORX_ASSERT(!instances.empty());
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::InstancePartitionedBVH::InstancePartitionedBVH");
+
+  auto const &space = instances[0];
+  int const num_parts = instances.size();
+  int const n = Access::size(primitives);
+  _size = n;
+
+  // Cut the primitives along the Morton curve
+  Kokkos::Profiling::pushRegion(
+      "ArborX::InstancePartitionedBVH::InstancePartitionedBVH::cut");
+
+  Kokkos::View<Box *, MemorySpace> boxes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::InstancePartitionedBVH::boxes"),
+      n);
+  Box scene_bounding_box;
+  Kokkos::parallel_reduce(
+      "ArborX::InstancePartitionedBVH::InstancePartitionedBVH::"
+      "calculate_bounds",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, Box &update) {
+        using Details::expand;
+        Box box;
+        expand(box, Access::get(primitives, i));
+        boxes(i) = box;
+        update += box;
+      },
+      Kokkos::Sum<Box>{scene_bounding_box});
+
+  Kokkos::View<unsigned long long *, MemorySpace> codes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::InstancePartitionedBVH::codes"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::InstancePartitionedBVH::InstancePartitionedBVH::"
+      "project_onto_curve",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        codes(i) = Morton64{}(scene_bounding_box, boxes(i));
+      });
+  auto const permutation = Details::sortObjects(space, codes);
+  space.fence("ArborX::InstancePartitionedBVH::InstancePartitionedBVH"
+              " (cut done before building the parts)");
+
+  Kokkos::Profiling::popRegion();
+
+  // Each part is built on its instance
+  Kokkos::Profiling::pushRegion(
+      "ArborX::InstancePartitionedBVH::InstancePartitionedBVH::build_parts");
+
+  _trees.resize(num_parts);
+  _indices.resize(num_parts);
+  for (int p = 0; p < num_parts; ++p)
+  {
+    auto const &instance = instances[p];
+    int const begin = (long long)p * n / num_parts;
+    int const end = (long long)(p + 1) * n / num_parts;
+
+    Kokkos::View<unsigned *, MemorySpace> indices(
+        Kokkos::view_alloc(instance, Kokkos::WithoutInitializing,
+                           "ArborX::InstancePartitionedBVH::indices"),
+        end - begin);
+    Kokkos::View<Box *, MemorySpace> part_boxes(
+        Kokkos::view_alloc(instance, Kokkos::WithoutInitializing,
+                           "ArborX::InstancePartitionedBVH::part_boxes"),
+        end - begin);
+    Kokkos::parallel_for(
+        "ArborX::InstancePartitionedBVH::InstancePartitionedBVH::gather_part",
+        Kokkos::RangePolicy<ExecutionSpace>(instance, 0, end - begin),
+        KOKKOS_LAMBDA(int i) {
+          indices(i) = permutation(begin + i);
+          part_boxes(i) = boxes(indices(i));
+        });
+    _trees[p] = BVH<MemorySpace>(instance, part_boxes);
+    _indices[p] = indices;
+  }
+
+  Kokkos::View<Box *, MemorySpace> part_bounds(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "ArborX::InstancePartitionedBVH::part_bounds"),
+      num_parts);
+  auto part_bounds_host = Kokkos::create_mirror_view(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing), part_bounds);
+  for (int p = 0; p < num_parts; ++p)
+  {
+    instances[p].fence("ArborX::InstancePartitionedBVH::InstancePartitionedBVH"
+                       " (part built before the top tree)");
+    part_bounds_host(p) = _trees[p].bounds();
+  }
+  Kokkos::deep_copy(space, part_bounds, part_bounds_host);
+  _top_tree = BVH<MemorySpace>(space, part_bounds);
+
+  Kokkos::Profiling::popRegion();
+}
+
+template <typename MemorySpace>
+template <typename ExecutionSpace, typename Predicates, typename Callback,
+          typename Out, typename Offset>
+std::enable_if_t<!Kokkos::is_view_v<Callback> && Kokkos::is_view_v<Out> &&
+                 Kokkos::is_view_v<Offset>>
+InstancePartitionedBVH<MemorySpace>::query(
+    std::vector<ExecutionSpace> const &instances, Predicates const &predicates,
+    Callback const &callback, Out &out, Offset &offset) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{},
+                "nearest query not implemented yet");
+
+  ARBORX_ASSERT(!instances.empty());
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::InstancePartitionedBVH::query");
+
+  auto const &space = instances[0];
+  int const num_parts = numberOfParts();
+  int const n_queries = Access::size(predicates);
+
+  if (num_parts == 0)
+  {
+    KokkosExt::reallocWithoutInitializing(space, out, 0);
+    offset = Kokkos::View<int *, MemorySpace>(
+        Kokkos::view_alloc(space, offset.label()), n_queries + 1);
+    return;
+  }
+  ARBORX_ASSERT((int)instances.size() == num_parts);
+
+  // Split the predicates by the parts they hit in the top tree
+  Kokkos::Profiling::pushRegion("ArborX::InstancePartitionedBVH::query::split");
+
+  Kokkos::View<int *, MemorySpace> hits(
+      "ArborX::InstancePartitionedBVH::query::hits", 0);
+  Kokkos::View<int *, MemorySpace> hit_offset(
+      "ArborX::InstancePartitionedBVH::query::hit_offset", 0);
+  ArborX::query(_top_tree, space, predicates, hits, hit_offset);
+
+  Kokkos::View<int *, MemorySpace> part_offset(
+      Kokkos::view_alloc(space,
+                         "ArborX::InstancePartitionedBVH::query::part_offset"),
+      num_parts + 1);
+  Kokkos::parallel_for(
+      "ArborX::InstancePartitionedBVH::query::count_part_predicates",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, hits.extent(0)),
+      KOKKOS_LAMBDA(int j) {
+        Kokkos::atomic_increment(&part_offset(hits(j)));
+      });
+  exclusivePrefixSum(space, part_offset);
+
+  using Predicate = std::decay_t<decltype(Access::get(
+      std::declval<Predicates const &>(), 0))>;
+  using PartPredicate = decltype(attach(std::declval<Predicate const &>(), 0));
+  Kokkos::View<PartPredicate *, MemorySpace> part_predicates(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::InstancePartitionedBVH::query::part_predicates"),
+      hits.extent(0));
+  Kokkos::View<int *, MemorySpace> part_cursors(
+      Kokkos::view_alloc(space,
+                         "ArborX::InstancePartitionedBVH::query::part_cursors"),
+      num_parts);
+  Kokkos::parallel_for(
+      "ArborX::InstancePartitionedBVH::query::fill_part_predicates",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        for (int j = hit_offset(q); j < hit_offset(q + 1); ++j)
+        {
+          int const p = hits(j);
+          part_predicates(part_offset(p) +
+                          Kokkos::atomic_fetch_inc(&part_cursors(p))) =
+              attach(Access::get(predicates, q), q);
+        }
+      });
+  auto const part_offset_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, part_offset);
+
+  Kokkos::Profiling::popRegion();
+
+  // The parts are searched concurrently, once to count the results of each
+  // predicate and once to store them
+  auto const search_parts = [&](auto const &make_callback) {
+    for (int p = 0; p < num_parts; ++p)
+    {
+      auto const range =
+          Kokkos::make_pair(part_offset_host(p), part_offset_host(p + 1));
+      if (range.first == range.second)
+        continue;
+      _trees[p].query(instances[p],
+                      Kokkos::subview(part_predicates, range),
+                      make_callback(_indices[p]));
+    }
+    for (int p = 0; p < num_parts; ++p)
+      instances[p].fence("ArborX::InstancePartitionedBVH::query"
+                         " (wait for the search of the part)");
+  };
+
+  Kokkos::Profiling::pushRegion("ArborX::InstancePartitionedBVH::query::count");
+
+  Kokkos::View<int *, MemorySpace> new_offset(
+      Kokkos::view_alloc(space, offset.label()), n_queries + 1);
+  space.fence("ArborX::InstancePartitionedBVH::query (counts zeroed)");
+  search_parts([&](auto const &indices) {
+    return Details::TwoPassCountCallback<
+        Callback, std::decay_t<decltype(indices)>, decltype(new_offset)>{
+        callback, indices, new_offset};
+  });
+  exclusivePrefixSum(space, new_offset);
+
+  Kokkos::Profiling::popRegion();
+  Kokkos::Profiling::pushRegion("ArborX::InstancePartitionedBVH::query::fill");
+
+  KokkosExt::reallocWithoutInitializing(
+      space, out, KokkosExt::lastElement(space, new_offset));
+  Kokkos::View<int *, MemorySpace> cursors(
+      Kokkos::view_alloc(space,
+                         "ArborX::InstancePartitionedBVH::query::cursors"),
+      n_queries);
+  space.fence("ArborX::InstancePartitionedBVH::query (offsets computed)");
+  search_parts([&](auto const &indices) {
+    return Details::TwoPassFillCallback<
+        Callback, std::decay_t<decltype(indices)>, decltype(new_offset),
+        decltype(cursors), Out>{callback, indices, new_offset, cursors, out};
+  });
+  offset = new_offset;
+
+  Kokkos::Profiling::popRegion();
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
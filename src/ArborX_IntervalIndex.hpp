@@ -0,0 +1,287 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_INTERVAL_INDEX_HPP
+#define ARBORX_INTERVAL_INDEX_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // expand
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsSortUtils.hpp> // sortObjects
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_Predicates.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+
+namespace ArborX
+{
+namespace Details
+{
+// Largest upper bound of the intervals up to each one, in the order of their
+// lower bounds
+template <typename Intervals, typename MaxUpper>
+struct RunningMaxUpperBound
+{
+  Intervals _intervals;
+  MaxUpper _max_upper;
+
+  using value_type = typename MaxUpper::non_const_value_type;
+
+  KOKKOS_FUNCTION void init(value_type &x) const
+  {
+    x = KokkosExt::ArithmeticTraits::finite_min<value_type>::value;
+  }
+
+  KOKKOS_FUNCTION void join(value_type &x, value_type const &y) const
+  {
+    x = KokkosExt::max(x, y);
+  }
+
+  KOKKOS_FUNCTION void operator()(int i, value_type &update, bool final) const
+  {
+    update = KokkosExt::max(update, _intervals(i).maxCorner()[0]);
+    if (final)
+      _max_upper(i) = update;
+  }
+};
+} // namespace Details
+
+namespace Experimental
+{
+
+// Index of one-dimensional primitives, e.g. time stamps or time windows given
+// as HyperPoint<1> or HyperBox<1>, stored as intervals sorted by their lower
+// bounds next to the running maximum of their upper bounds. Both are sorted,
+// so that each spatial predicate finds the range of intervals that may
+// intersect the bounding interval of its geometry with two binary searches,
+// without building a hierarchy nor computing Morton codes. Only the intervals
+// of that range are tested, which are exactly the ones satisfying the
+// predicate for points and non-nested intervals. Long intervals overlapping
+// many others widen the ranges of the predicates that follow them. Callbacks
+// are given the indices of the primitives. Only spatial queries are
+// supported.
+template <typename MemorySpace, typename Coordinate = float>
+class IntervalIndex
+{
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using size_type = typename MemorySpace::size_type;
+  using bounding_volume_type = ExperimentalHyperGeometry::Box<1, Coordinate>;
+
+  IntervalIndex() = default; // build an empty index
+
+  template <typename ExecutionSpace, typename Primitives>
+  IntervalIndex(ExecutionSpace const &space, Primitives const &primitives);
+
+  KOKKOS_FUNCTION
+  size_type size() const noexcept { return _intervals.extent(0); }
+
+  KOKKOS_FUNCTION
+  bool empty() const noexcept { return size() == 0; }
+
+  KOKKOS_FUNCTION
+  bounding_volume_type bounds() const noexcept { return _bounds; }
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback,
+             TraversalPolicy const &policy = TraversalPolicy()) const;
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+
+private:
+  // Position of the first interval whose running maximum upper bound is
+  // greater than or equal to x
+  KOKKOS_FUNCTION static int
+  firstReaching(Kokkos::View<Coordinate *, MemorySpace> const &max_upper,
+                Coordinate x)
+  {
+    int first = 0;
+    int last = max_upper.extent(0);
+    while (first < last)
+    {
+      int const middle = first + (last - first) / 2;
+      if (max_upper(middle) < x)
+        first = middle + 1;
+      else
+        last = middle;
+    }
+    return first;
+  }
+
+  // Position of the first interval whose lower bound is greater than x
+  KOKKOS_FUNCTION static int firstBeyond(
+      Kokkos::View<bounding_volume_type *, MemorySpace> const &intervals,
+      Coordinate x)
+  {
+    int first = 0;
+    int last = intervals.extent(0);
+    while (first < last)
+    {
+      int const middle = first + (last - first) / 2;
+      if (intervals(middle).minCorner()[0] <= x)
+        first = middle + 1;
+      else
+        last = middle;
+    }
+    return first;
+  }
+
+  bounding_volume_type _bounds;
+  // Intervals sorted by lower bound, their original indices, and the largest
+  // upper bound up to each of them
+  Kokkos::View<bounding_volume_type *, MemorySpace> _intervals;
+  Kokkos::View<unsigned *, MemorySpace> _permutation;
+  Kokkos::View<Coordinate *, MemorySpace> _max_upper;
+};
+
+template <typename MemorySpace, typename Coordinate>
+template <typename ExecutionSpace, typename Primitives>
+IntervalIndex<MemorySpace, Coordinate>::IntervalIndex(
+    ExecutionSpace const &space, Primitives const &primitives)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+  static_assert(
+      GeometryTraits::dimension_v<
+          typename Details::AccessTraitsHelper<Access>::type> == 1,
+      "Interval indices are built for one-dimensional primitives");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::IntervalIndex::IntervalIndex");
+
+  int const n = Access::size(primitives);
+  if (n == 0)
+    return;
+
+  Kokkos::View<Coordinate *, MemorySpace> lower_bounds(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::IntervalIndex::lower_bounds"),
+      n);
+  Kokkos::parallel_reduce(
+      "ArborX::IntervalIndex::IntervalIndex::calculate_bounds",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, bounding_volume_type &update) {
+        using Details::expand;
+        bounding_volume_type interval;
+        expand(interval, Access::get(primitives, i));
+        lower_bounds(i) = interval.minCorner()[0];
+        update += interval;
+      },
+      Kokkos::Sum<bounding_volume_type>{_bounds});
+
+  Kokkos::Profiling::pushRegion("ArborX::IntervalIndex::IntervalIndex::sort");
+
+  _permutation = Details::sortObjects(space, lower_bounds);
+  _intervals = Kokkos::View<bounding_volume_type *, MemorySpace>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::IntervalIndex::intervals"),
+      n);
+  auto const &intervals = _intervals;
+  auto const &permutation = _permutation;
+  Kokkos::parallel_for(
+      "ArborX::IntervalIndex::IntervalIndex::permute_intervals",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        using Details::expand;
+        bounding_volume_type interval;
+        expand(interval, Access::get(primitives, permutation(i)));
+        intervals(i) = interval;
+      });
+
+  Kokkos::Profiling::popRegion();
+
+  _max_upper = Kokkos::View<Coordinate *, MemorySpace>(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::IntervalIndex::max_upper_bounds"),
+      n);
+  Kokkos::parallel_scan(
+      "ArborX::IntervalIndex::IntervalIndex::compute_max_upper_bounds",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      Details::RunningMaxUpperBound<decltype(_intervals), decltype(_max_upper)>{
+          _intervals, _max_upper});
+}
+
+template <typename MemorySpace, typename Coordinate>
+template <typename ExecutionSpace, typename Predicates, typename Callback>
+void IntervalIndex<MemorySpace, Coordinate>::query(
+    ExecutionSpace const &space, Predicates const &predicates,
+    Callback const &callback, TraversalPolicy const &) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{},
+                "nearest query not implemented yet");
+  using Value = int;
+  Details::check_valid_callback<Value>(callback, predicates);
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::IntervalIndex::query::spatial");
+
+  if (empty())
+    return;
+
+  auto const &intervals = _intervals;
+  auto const &permutation = _permutation;
+  auto const &max_upper = _max_upper;
+  Kokkos::parallel_for(
+      "ArborX::IntervalIndex::query::spatial",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, Access::size(predicates)),
+      KOKKOS_LAMBDA(int q) {
+        using Details::expand;
+        auto const &predicate = Access::get(predicates, q);
+        bounding_volume_type box;
+        expand(box, getGeometry(predicate));
+
+        // The intervals before first end before the geometry and the ones
+        // from last on start after it
+        int const first = firstReaching(max_upper, box.minCorner()[0]);
+        int const last = firstBeyond(intervals, box.maxCorner()[0]);
+        for (int i = first; i < last; ++i)
+          if (predicate(intervals(i)) &&
+              Details::invoke_callback_and_check_early_exit(
+                  callback, predicate, (int)permutation(i)))
+            return;
+      });
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
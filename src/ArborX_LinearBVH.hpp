@@ -15,30 +15,51 @@
 #include <ArborX_AccessTraits.hpp>
 #include <ArborX_Box.hpp>
 #include <ArborX_Callbacks.hpp>
+#include <ArborX_ConstructionPolicy.hpp>
 #include <ArborX_CrsGraphWrapper.hpp>
 #include <ArborX_DetailsBatchedQueries.hpp>
+#include <ArborX_DetailsChunkedPrimitives.hpp>
+#include <ArborX_DetailsCountingTraversal.hpp>
+#include <ArborX_DetailsDualTreeTraversal.hpp>
+#include <ArborX_DetailsExplicitInstantiation.hpp>
+#include <ArborX_DetailsHalfTraversal.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
 #include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
 #include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp>
 #include <ArborX_DetailsNode.hpp>
+#include <ArborX_DetailsNodeAggregates.hpp>
 #include <ArborX_DetailsPermutedData.hpp>
+#include <ArborX_DetailsQuantizedNode.hpp>
 #include <ArborX_DetailsSortUtils.hpp>
 #include <ArborX_DetailsTreeConstruction.hpp>
+#include <ArborX_DetailsTreeConstructionPLOC.hpp>
+#include <ArborX_DetailsTreeNodeLabeling.hpp>
 #include <ArborX_DetailsTreeTraversal.hpp>
 #include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_HyperSphere.hpp>
 #include <ArborX_IndexableGetter.hpp>
 #include <ArborX_SpaceFillingCurves.hpp>
 #include <ArborX_TraversalPolicy.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <vector>
+
 namespace ArborX
 {
 
 namespace Details
 {
 struct HappyTreeFriends;
+struct TreeSerialization;
 } // namespace Details
 
+// The bounding volumes may use a narrower coordinate type than the indexables,
+// e.g. single precision boxes over double precision points, for a faster
+// traversal. They are then rounded outwards, and the indexables are tested in
+// their own precision at the leaves.
 template <
     typename MemorySpace, typename Value,
     typename IndexableGetter = Details::DefaultIndexableGetter,
@@ -54,7 +75,8 @@ public:
   using memory_space = MemorySpace;
   static_assert(Kokkos::is_memory_space<MemorySpace>::value);
   using size_type = typename MemorySpace::size_type;
-  using bounding_volume_type = BoundingVolume;
+  using bounding_volume_type = typename Details::InternalNodeTraits<
+      BoundingVolume>::bounding_volume_type;
   using value_type = Value;
 
   BasicBoundingVolumeHierarchy() = default; // build an empty tree
@@ -63,7 +85,47 @@ public:
             typename SpaceFillingCurve = Experimental::Morton64>
   BasicBoundingVolumeHierarchy(
       ExecutionSpace const &space, Primitives const &primitives,
-      SpaceFillingCurve const &curve = SpaceFillingCurve());
+      SpaceFillingCurve const &curve = SpaceFillingCurve(),
+      Experimental::ConstructionPolicy const &policy =
+          Experimental::ConstructionPolicy());
+
+  template <typename ExecutionSpace, typename Primitives>
+  BasicBoundingVolumeHierarchy(
+      ExecutionSpace const &space, Primitives const &primitives,
+      Experimental::ConstructionPolicy const &policy)
+      : BasicBoundingVolumeHierarchy(space, primitives,
+                                     Experimental::Morton64(), policy)
+  {}
+
+  // Construct the hierarchy over values given in a view, whose indexables are
+  // returned by the indexable getter, e.g. the indexed triangles of a mesh
+  // assembled from a vertex buffer shared by the triangles (see
+  // ArborX_IndexedTriangles.hpp). The getter is kept for the queries.
+  template <typename ExecutionSpace, typename Values,
+            typename SpaceFillingCurve = Experimental::Morton64>
+  BasicBoundingVolumeHierarchy(
+      ExecutionSpace const &space, Values const &values,
+      IndexableGetter const &indexable_getter,
+      SpaceFillingCurve const &curve = SpaceFillingCurve(),
+      Experimental::ConstructionPolicy const &policy =
+          Experimental::ConstructionPolicy());
+
+  // Construct the hierarchy from the codes of the primitives along a
+  // space-filling curve, sorted in increasing order, and the permutation
+  // that sorts the primitives accordingly, i.e. the i-th code is that of
+  // primitives[permutation(i)]. An empty permutation stands for primitives
+  // given in sorted order already. The bounds of the scene, the projection
+  // and the sort are skipped, which leaves the curve up to the caller.
+  template <typename ExecutionSpace, typename Primitives,
+            typename LinearOrderingValueType,
+            typename... LinearOrderingViewProperties>
+  BasicBoundingVolumeHierarchy(
+      ExecutionSpace const &space, Primitives const &primitives,
+      Kokkos::View<LinearOrderingValueType *,
+                   LinearOrderingViewProperties...> const &sorted_codes,
+      Kokkos::View<unsigned int *, MemorySpace> const &permutation,
+      Experimental::ConstructionPolicy const &policy =
+          Experimental::ConstructionPolicy());
 
   KOKKOS_FUNCTION
   size_type size() const noexcept { return _size; }
@@ -74,6 +136,17 @@ public:
   KOKKOS_FUNCTION
   bounding_volume_type bounds() const noexcept { return _bounds; }
 
+  // Update the bounding volumes for primitives that have moved while keeping
+  // the topology of the hierarchy. Primitives must be given in the same order
+  // and number as at construction. Returns the ratio of the surface area
+  // heuristic cost of the refitted hierarchy to that of the hierarchy as
+  // originally constructed. The larger the ratio, the more a full rebuild
+  // would pay off. Only hierarchies of the index and bounding volume pairs
+  // built from primitives can be refitted, as the leaves find their new
+  // primitive through its index.
+  template <typename ExecutionSpace, typename Primitives>
+  float refit(ExecutionSpace const &space, Primitives const &primitives);
+
   template <typename ExecutionSpace, typename Predicates, typename Callback>
   void query(ExecutionSpace const &space, Predicates const &predicates,
              Callback const &callback,
@@ -91,19 +164,98 @@ public:
                   std::forward<View>(view), std::forward<Args>(args)...);
   }
 
+  // Count the values satisfying each spatial predicate without storing them.
+  // The traversal for a predicate stops as soon as n values have been found,
+  // so that counts(i) is the lesser of n and the number of values satisfying
+  // the i-th predicate. With n = 1, it tells whether any value does.
+  template <typename ExecutionSpace, typename Predicates>
+  void countUpTo(ExecutionSpace const &space, Predicates const &predicates,
+                 int n, Kokkos::View<int *, MemorySpace> &counts,
+                 Experimental::TraversalPolicy const &policy =
+                     Experimental::TraversalPolicy()) const;
+
+  // Count the values satisfying each spatial predicate without storing them.
+  // The subtrees contained in the geometry of a predicate, e.g. a sphere
+  // containing a box, are counted at once from their number of leaves. With a
+  // positive relative_tolerance, the counts are approximate: the subtrees that
+  // only intersect the geometry may be counted as half of their leaves, as
+  // long as counts(i) stays within relative_tolerance of the exact count.
+  template <typename ExecutionSpace, typename Predicates>
+  void count(ExecutionSpace const &space, Predicates const &predicates,
+             Kokkos::View<int *, MemorySpace> &counts,
+             float relative_tolerance = 0,
+             Experimental::TraversalPolicy const &policy =
+                 Experimental::TraversalPolicy()) const;
+
+  // Join the values of the hierarchy with themselves. The callback is called
+  // as callback(value_i, value_j) exactly once for each pair of distinct
+  // values such that get_predicate(indexable_i) is satisfied by indexable_j.
+  // The predicates must be symmetric, e.g. a value is within some distance
+  // of another, so that only half of the pairs need to be tested.
+  template <typename ExecutionSpace, typename PredicateGetter,
+            typename Callback>
+  void selfJoin(ExecutionSpace const &space,
+                PredicateGetter const &get_predicate,
+                Callback const &callback,
+                Experimental::TraversalPolicy const &policy =
+                    Experimental::TraversalPolicy()) const
+  {
+    KokkosExt::ScopedProfileRegion guard("ArborX::BVH::selfJoin");
+    Details::HalfTraversal(space, *this, callback, get_predicate, policy);
+  }
+
+  // Join the values of the hierarchy with those of another hierarchy by
+  // walking them together. The callback is called as
+  // callback(predicate, other_value) exactly once for each pair of values
+  // with intersecting bounding volumes. The predicate is
+  // attach(intersects(bounding_volume), value) for the value of this
+  // hierarchy.
+  template <typename ExecutionSpace, typename OtherTree, typename Callback>
+  void join(ExecutionSpace const &space, OtherTree const &other,
+            Callback const &callback) const
+  {
+    KokkosExt::ScopedProfileRegion guard("ArborX::BVH::join");
+    Details::DualTreeTraversal(space, *this, other, callback);
+  }
+
+protected:
+  // Construct the hierarchy without waiting for its bounds to be copied to
+  // the host, which copyBoundsToHost() must then do before it is used
+  template <typename ExecutionSpace, typename Primitives,
+            typename SpaceFillingCurve>
+  BasicBoundingVolumeHierarchy(Details::DeferredBoundsTag,
+                               ExecutionSpace const &space,
+                               Primitives const &primitives,
+                               SpaceFillingCurve const &curve,
+                               Experimental::ConstructionPolicy const &policy);
+
+  template <typename ExecutionSpace>
+  void copyBoundsToHost(ExecutionSpace const &space,
+                        Experimental::ConstructionPolicy const &policy);
+
 private:
   friend struct Details::HappyTreeFriends;
+  friend struct Details::TreeSerialization;
 
   using indexable_type = std::decay_t<decltype(std::declval<IndexableGetter>()(
       std::declval<Value>()))>;
   using leaf_node_type = Details::LeafNode<value_type>;
-  using internal_node_type = Details::InternalNode<bounding_volume_type>;
+  using internal_node_type =
+      typename Details::InternalNodeTraits<BoundingVolume>::type;
 
   size_type _size{0};
-  bounding_volume_type _bounds;
+  bounding_volume_type _bounds =
+      Details::makeEmptyBoundingVolume<bounding_volume_type>();
   Kokkos::View<leaf_node_type *, MemorySpace> _leaf_nodes;
   Kokkos::View<internal_node_type *, MemorySpace> _internal_nodes;
   IndexableGetter _indexable_getter;
+  // Whether the leaves below each internal node are consecutive, as in the
+  // hierarchies built by Karras' algorithm
+  bool _contiguous_subtrees = false;
+  // Surface area heuristic cost of the hierarchy before the first refit,
+  // computed lazily (from the quantized bounding volumes if the internal
+  // nodes are quantized)
+  float _construction_cost{-1.f};
 };
 
 template <typename MemorySpace>
@@ -125,8 +277,30 @@ public:
             typename SpaceFillingCurve = Experimental::Morton64>
   BoundingVolumeHierarchy(ExecutionSpace const &space,
                           Primitives const &primitives,
-                          SpaceFillingCurve const &curve = SpaceFillingCurve())
-      : base_type(space, primitives, curve)
+                          SpaceFillingCurve const &curve = SpaceFillingCurve(),
+                          Experimental::ConstructionPolicy const &policy =
+                              Experimental::ConstructionPolicy())
+      : base_type(space, primitives, curve, policy)
+  {}
+
+  template <typename ExecutionSpace, typename Primitives>
+  BoundingVolumeHierarchy(ExecutionSpace const &space,
+                          Primitives const &primitives,
+                          Experimental::ConstructionPolicy const &policy)
+      : base_type(space, primitives, policy)
+  {}
+
+  template <typename ExecutionSpace, typename Primitives,
+            typename LinearOrderingValueType,
+            typename... LinearOrderingViewProperties>
+  BoundingVolumeHierarchy(
+      ExecutionSpace const &space, Primitives const &primitives,
+      Kokkos::View<LinearOrderingValueType *,
+                   LinearOrderingViewProperties...> const &sorted_codes,
+      Kokkos::View<unsigned int *, MemorySpace> const &permutation,
+      Experimental::ConstructionPolicy const &policy =
+          Experimental::ConstructionPolicy())
+      : base_type(space, primitives, sorted_codes, permutation, policy)
   {}
 
   template <typename ExecutionSpace, typename Predicates, typename Callback>
@@ -135,10 +309,15 @@ public:
              Experimental::TraversalPolicy const &policy =
                  Experimental::TraversalPolicy()) const
   {
-    base_type::query(space, predicates,
-                     Details::LegacyCallbackWrapper<
-                         Callback, typename base_type::value_type>{callback},
-                     policy);
+    if constexpr (Details::is_tagged_team_callback<Callback>{})
+      base_type::query(space, predicates,
+                       Details::LegacyTeamCallbackWrapper<Callback>{callback},
+                       policy);
+    else
+      base_type::query(space, predicates,
+                       Details::LegacyCallbackWrapper<
+                           Callback, typename base_type::value_type>{callback},
+                       policy);
   }
 
   template <typename ExecutionSpace, typename Predicates,
@@ -151,20 +330,207 @@ public:
                   std::forward<CallbackOrView>(callback_or_view),
                   std::forward<View>(view), std::forward<Args>(args)...);
   }
+
+  template <typename ExecutionSpace, typename PredicateGetter,
+            typename Callback>
+  void selfJoin(ExecutionSpace const &space,
+                PredicateGetter const &get_predicate,
+                Callback const &callback,
+                Experimental::TraversalPolicy const &policy =
+                    Experimental::TraversalPolicy()) const
+  {
+    KokkosExt::ScopedProfileRegion guard("ArborX::BVH::selfJoin");
+    // The callback is passed the indices of the values
+    Details::HalfTraversal(space, *this, callback, get_predicate, policy);
+  }
+
+  template <typename ExecutionSpace, typename OtherTree, typename Callback>
+  void join(ExecutionSpace const &space, OtherTree const &other,
+            Callback const &callback) const
+  {
+    KokkosExt::ScopedProfileRegion guard("ArborX::BVH::join");
+    // The attached data is the index of the value
+    Details::DualTreeTraversal(space, *this, other, callback);
+  }
+
+private:
+  friend struct Details::HappyTreeFriends;
+
+  template <typename ExecutionSpace, typename Primitives,
+            typename SpaceFillingCurve>
+  BoundingVolumeHierarchy(Details::DeferredBoundsTag tag,
+                          ExecutionSpace const &space,
+                          Primitives const &primitives,
+                          SpaceFillingCurve const &curve,
+                          Experimental::ConstructionPolicy const &policy)
+      : base_type(tag, space, primitives, curve, policy)
+  {}
 };
 
 template <typename MemorySpace>
 using BVH = BoundingVolumeHierarchy<MemorySpace>;
 
+namespace Experimental
+{
+// Permutation sorting the primitives along the space-filling curve, in the
+// order in which a hierarchy built with the same curve stores them in its
+// leaves. Once the caller has permuted its data accordingly, the hierarchy
+// can be built with ConstructionPolicy::setPrimitivesSorted() so that the
+// callbacks read that data contiguously rather than through the indices.
+template <typename ExecutionSpace, typename Primitives,
+          typename SpaceFillingCurve = Morton64>
+auto computeSpaceFillingCurvePermutation(
+    ExecutionSpace const &space, Primitives const &primitives,
+    SpaceFillingCurve const &curve = SpaceFillingCurve())
+{
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+  using MemorySpace = typename Access::memory_space;
+  using Indexable = std::decay_t<decltype(Access::get(primitives, 0))>;
+  constexpr int DIM = GeometryTraits::dimension_v<Indexable>;
+
+  Details::check_valid_space_filling_curve<DIM>(curve);
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::computeSpaceFillingCurvePermutation");
+
+  ExperimentalHyperGeometry::Box<
+      DIM, typename GeometryTraits::coordinate_type<Indexable>::type>
+      bbox{};
+  Details::TreeConstruction::calculateBoundingBoxOfTheScene(
+      space, Details::Indexables<Primitives>{primitives}, bbox);
+
+  using LinearOrderingValueType = Kokkos::detected_t<
+      Details::SpaceFillingCurveProjectionArchetypeExpression,
+      SpaceFillingCurve, decltype(bbox), Indexable>;
+  Kokkos::View<LinearOrderingValueType *, MemorySpace> linear_ordering_indices(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::computeSpaceFillingCurvePermutation::"
+                         "linear_ordering"),
+      Access::size(primitives));
+  Details::TreeConstruction::projectOntoSpaceFillingCurve(
+      space, Details::Indexables<Primitives>{primitives}, curve, bbox,
+      linear_ordering_indices);
+
+  return Details::sortObjects(space, linear_ordering_indices);
+}
+
+// Construct one hierarchy for each set of primitives, the i-th one on the
+// execution space instance spaces[i % spaces.size()]. All the constructions
+// are launched before the bounds of any hierarchy are copied back to the
+// host, so that the hierarchies on different instances are built
+// concurrently. The linear hierarchy of full precision internal nodes is
+// built without waiting on the host, unless the primitives are streamed from
+// inaccessible memory, or duplicate codes are refined.
+template <typename Tree, typename ExecutionSpace, typename Primitives,
+          typename SpaceFillingCurve = Morton64>
+std::vector<Tree>
+constructHierarchies(std::vector<ExecutionSpace> const &spaces,
+                     std::vector<Primitives> const &primitives,
+                     SpaceFillingCurve const &curve = SpaceFillingCurve(),
+                     ConstructionPolicy const &policy = ConstructionPolicy())
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::constructHierarchies");
+
+  int const num_trees = primitives.size();
+  int const num_spaces = spaces.size();
+  ARBORX_ASSERT(num_trees == 0 || num_spaces > 0);
+
+  std::vector<Tree> trees;
+  trees.reserve(num_trees);
+  for (int i = 0; i < num_trees; ++i)
+  {
+    using Details::HappyTreeFriends;
+    trees.push_back(HappyTreeFriends::constructWithDeferredBounds<Tree>(
+        spaces[i % num_spaces], primitives[i], curve, policy));
+  }
+  for (int i = 0; i < num_trees; ++i)
+    Details::HappyTreeFriends::copyBoundsToHost(trees[i],
+                                                spaces[i % num_spaces], policy);
+  return trees;
+}
+} // namespace Experimental
+
 template <typename MemorySpace, typename Value, typename IndexableGetter,
           typename BoundingVolume>
 template <typename ExecutionSpace, typename Primitives,
           typename SpaceFillingCurve>
 BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
                              BoundingVolume>::
-    BasicBoundingVolumeHierarchy(ExecutionSpace const &space,
-                                 Primitives const &primitives,
-                                 SpaceFillingCurve const &curve)
+    BasicBoundingVolumeHierarchy(
+        ExecutionSpace const &space, Primitives const &primitives,
+        SpaceFillingCurve const &curve,
+        Experimental::ConstructionPolicy const &policy)
+    : BasicBoundingVolumeHierarchy(Details::DeferredBoundsTag{}, space,
+                                   primitives, curve, policy)
+{
+  copyBoundsToHost(space, policy);
+}
+
+template <typename MemorySpace, typename Value, typename IndexableGetter,
+          typename BoundingVolume>
+template <typename ExecutionSpace, typename Values, typename SpaceFillingCurve>
+BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
+                             BoundingVolume>::
+    BasicBoundingVolumeHierarchy(
+        ExecutionSpace const &space, Values const &values,
+        IndexableGetter const &indexable_getter,
+        SpaceFillingCurve const &curve,
+        Experimental::ConstructionPolicy const &policy)
+    : BasicBoundingVolumeHierarchy(
+          Details::DeferredBoundsTag{}, space,
+          Details::IndexableValues<Values, IndexableGetter>{values,
+                                                            indexable_getter},
+          curve, policy)
+{
+  static_assert(Kokkos::is_view_v<Values> && Values::rank == 1);
+  static_assert(
+      std::is_same_v<typename Values::non_const_value_type, value_type>,
+      "The values must be those of the hierarchy");
+  copyBoundsToHost(space, policy);
+}
+
+template <typename MemorySpace, typename Value, typename IndexableGetter,
+          typename BoundingVolume>
+template <typename ExecutionSpace>
+void BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
+                                  BoundingVolume>::
+    copyBoundsToHost(ExecutionSpace const &space,
+                     Experimental::ConstructionPolicy const &policy)
+{
+  // Only the generation of a linear hierarchy of full precision internal
+  // nodes leaves the bounds, i.e. those of the root, on the device
+  if constexpr (!Details::is_quantized_internal_node<
+                    internal_node_type>::value)
+  {
+    using Hierarchy = Experimental::ConstructionPolicy::Hierarchy;
+    if (size() > 1 && policy._hierarchy == Hierarchy::Linear)
+    {
+      Kokkos::deep_copy(
+          space,
+          Kokkos::View<bounding_volume_type, Kokkos::HostSpace,
+                       Kokkos::MemoryUnmanaged>(&_bounds),
+          Kokkos::View<bounding_volume_type const, MemorySpace,
+                       Kokkos::MemoryUnmanaged>(
+              &_internal_nodes.data()->bounding_volume));
+      space.fence("ArborX::BVH::BVH (copy bounds to host)");
+    }
+  }
+}
+
+template <typename MemorySpace, typename Value, typename IndexableGetter,
+          typename BoundingVolume>
+template <typename ExecutionSpace, typename Primitives,
+          typename SpaceFillingCurve>
+BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
+                             BoundingVolume>::
+    BasicBoundingVolumeHierarchy(
+        Details::DeferredBoundsTag, ExecutionSpace const &space,
+        Primitives const &primitives, SpaceFillingCurve const &curve,
+        Experimental::ConstructionPolicy const &policy)
     : _size(AccessTraits<Primitives, PrimitivesTag>::size(primitives))
     , _leaf_nodes(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
                                      "ArborX::BVH::leaf_nodes"),
@@ -177,37 +543,100 @@ BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
       KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
   Details::check_valid_access_traits(PrimitivesTag{}, primitives);
   using Access = AccessTraits<Primitives, PrimitivesTag>;
-  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
-                                              ExecutionSpace>::value,
-                "Primitives must be accessible from the execution space");
-  constexpr int DIM = GeometryTraits::dimension_v<BoundingVolume>;
+  constexpr int DIM = GeometryTraits::dimension_v<bounding_volume_type>;
 
   Details::check_valid_space_filling_curve<DIM>(curve);
 
   KokkosExt::ScopedProfileRegion guard("ArborX::BVH::BVH");
 
+  // Values given with their indexable getter are stored as they are, rather
+  // than paired with the index of the primitive
+  constexpr bool given_values =
+      Details::is_indexable_values<Primitives>::value;
+  if constexpr (given_values)
+    _indexable_getter = primitives._indexable_getter;
+
   if (empty())
   {
     return;
   }
 
+  // Primitives that do not reside in memory accessible from the execution
+  // space are streamed from the host. Everything else the construction needs
+  // is allocated for all the primitives.
+  Details::ChunkedPrimitives<MemorySpace, ExecutionSpace, Primitives> chunks(
+      primitives, policy._primitives_chunk_size);
+  if constexpr (given_values)
+    ARBORX_ASSERT(!chunks.streaming());
+
   if (size() == 1)
   {
-    Details::TreeConstruction::initializeSingleLeafTree(
-        space, Details::LegacyValues<Primitives, indexable_type>{primitives},
-        _indexable_getter, _leaf_nodes, _bounds);
+    if constexpr (given_values)
+      Details::TreeConstruction::initializeSingleLeafTree(
+          space, primitives, _indexable_getter, _leaf_nodes, _bounds);
+    else
+      chunks.forEach(space, [&](int, auto const &chunk) {
+        Details::TreeConstruction::initializeSingleLeafTree(
+            space,
+            Details::LegacyValues<std::decay_t<decltype(chunk)>,
+                                  indexable_type>{chunk},
+            _indexable_getter, _leaf_nodes, _bounds);
+      });
     return;
   }
 
+  if (policy._numa_first_touch)
+    Details::TreeConstruction::firstTouchNodes(space, _leaf_nodes,
+                                               _internal_nodes);
+
   Kokkos::Profiling::pushRegion(
       "ArborX::BVH::BVH::calculate_scene_bounding_box");
 
-  // determine the bounding box of the scene
-  ExperimentalHyperGeometry::Box<
-      DIM, typename GeometryTraits::coordinate_type<BoundingVolume>::type>
-      bbox{};
-  Details::TreeConstruction::calculateBoundingBoxOfTheScene(
-      space, Details::Indexables<Primitives>{primitives}, bbox);
+  // determine the bounding box of the scene. Unless the primitives are
+  // streamed, it is reduced on the device and read from there by the
+  // projection, so that the host does not wait for it. Bounds given by the
+  // caller, or estimated from a sample, spare a pass over the primitives.
+  using SceneBoundingBox = ExperimentalHyperGeometry::Box<
+      DIM,
+      typename GeometryTraits::coordinate_type<bounding_volume_type>::type>;
+  constexpr bool is_quantized =
+      Details::is_quantized_internal_node<internal_node_type>::value;
+  SceneBoundingBox bbox{};
+  Kokkos::View<SceneBoundingBox, MemorySpace> scene_bounding_box(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVH::BVH::scene_bounding_box"));
+  if (!is_quantized && !policy._scene_bounds.empty())
+  {
+    ARBORX_ASSERT((int)policy._scene_bounds.size() == 2 * DIM);
+    for (int d = 0; d < DIM; ++d)
+    {
+      bbox.minCorner()[d] = policy._scene_bounds[d];
+      bbox.maxCorner()[d] = policy._scene_bounds[DIM + d];
+    }
+    Kokkos::deep_copy(space, scene_bounding_box, bbox);
+  }
+  else if (!chunks.streaming())
+  {
+    if (!is_quantized && policy._scene_bounds_sample_size > 0)
+      Details::TreeConstruction::calculateBoundingBoxOfTheSceneFromSample(
+          space, Details::Indexables<Primitives>{primitives},
+          policy._scene_bounds_sample_size, scene_bounding_box);
+    else
+      Details::TreeConstruction::calculateBoundingBoxOfTheScene(
+          space, Details::Indexables<Primitives>{primitives},
+          scene_bounding_box);
+  }
+  else
+  {
+    chunks.forEach(space, [&](int, auto const &chunk) {
+      SceneBoundingBox chunk_bbox{};
+      Details::TreeConstruction::calculateBoundingBoxOfTheScene(
+          space, Details::Indexables<std::decay_t<decltype(chunk)>>{chunk},
+          chunk_bbox);
+      Details::expand(bbox, chunk_bbox);
+    });
+    Kokkos::deep_copy(space, scene_bounding_box, bbox);
+  }
 
   Kokkos::Profiling::popRegion();
   Kokkos::Profiling::pushRegion("ArborX::BVH::BVH::compute_linear_ordering");
@@ -217,33 +646,324 @@ BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
       Details::SpaceFillingCurveProjectionArchetypeExpression,
       SpaceFillingCurve, decltype(bbox),
       std::decay_t<decltype(Access::get(primitives, 0))>>;
-  Kokkos::View<LinearOrderingValueType *, MemorySpace> linear_ordering_indices(
-      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
-                         "ArborX::BVH::BVH::linear_ordering"),
-      size());
-  Details::TreeConstruction::projectOntoSpaceFillingCurve(
-      space, Details::Indexables<Primitives>{primitives}, curve, bbox,
-      linear_ordering_indices);
+  auto linear_ordering_indices = Details::temporaryView<
+      Kokkos::View<LinearOrderingValueType *, MemorySpace>>(
+      space, policy._workspace, "ArborX::BVH::BVH::linear_ordering", size());
+  chunks.forEach(space, [&](int offset, auto const &chunk) {
+    using Chunk = std::decay_t<decltype(chunk)>;
+    Details::TreeConstruction::projectOntoSpaceFillingCurve(
+        space, Details::Indexables<Chunk>{chunk}, curve, scene_bounding_box,
+        Kokkos::subview(
+            linear_ordering_indices,
+            Kokkos::make_pair(
+                offset, offset + (int)AccessTraits<Chunk, PrimitivesTag>::size(
+                                     chunk))));
+  });
 
   Kokkos::Profiling::popRegion();
   Kokkos::Profiling::pushRegion("ArborX::BVH::BVH::sort_linearized_order");
 
-  // Compute the ordering of the indexables along the space-filling curve
-  auto permutation_indices =
-      Details::sortObjects(space, linear_ordering_indices);
+  // Compute the ordering of the indexables along the space-filling curve,
+  // unless they are given in that order already
+  Kokkos::View<unsigned int *, MemorySpace> permutation_indices;
+  if (policy._primitives_sorted)
+  {
+    permutation_indices =
+        Details::temporaryView<Kokkos::View<unsigned int *, MemorySpace>>(
+            space, policy._workspace, "ArborX::BVH::BVH::permute", size());
+    iota(space, permutation_indices);
+  }
+  else if (policy._primitives_nearly_sorted)
+    permutation_indices = Details::sortNearlySortedObjects(
+        space, linear_ordering_indices, policy._workspace);
+  else
+    permutation_indices =
+        Details::sortObjects(space, linear_ordering_indices, policy._workspace);
+
+  Kokkos::View<unsigned int *, MemorySpace> duplicate_codes;
+  if (policy._refine_duplicate_codes && !policy._primitives_sorted &&
+      !chunks.streaming())
+    duplicate_codes = Details::TreeConstruction::refineDuplicateCodes(
+        space, Details::Indexables<Primitives>{primitives},
+        linear_ordering_indices, permutation_indices);
 
   Kokkos::Profiling::popRegion();
   Kokkos::Profiling::pushRegion("ArborX::BVH::BVH::generate_hierarchy");
 
-  // Generate bounding volume hierarchy
-  Details::TreeConstruction::generateHierarchy(
-      space, Details::LegacyValues<Primitives, indexable_type>{primitives},
-      _indexable_getter, permutation_indices, linear_ordering_indices,
-      _leaf_nodes, _internal_nodes, _bounds);
+  // Generate bounding volume hierarchy. Quantized internal nodes are
+  // generated in place on the grid spanned by the bounds of the scene, so
+  // that full precision ones are only allocated for PLOC.
+  if constexpr (is_quantized)
+  {
+    Kokkos::deep_copy(space, bbox, scene_bounding_box);
+    space.fence("ArborX::BVH::BVH (copy scene bounding box to host)");
+    for (int d = 0; d < DIM; ++d)
+    {
+      _bounds.minCorner()[d] = bbox.minCorner()[d];
+      _bounds.maxCorner()[d] = bbox.maxCorner()[d];
+    }
+  }
+  auto generate_hierarchy = [&](auto const &values) {
+    switch (policy._hierarchy)
+    {
+    case Experimental::ConstructionPolicy::Hierarchy::Linear:
+      // The bounds are left on the device for copyBoundsToHost()
+      Details::TreeConstruction::generateHierarchy(
+          space, values, _indexable_getter, permutation_indices,
+          linear_ordering_indices, _leaf_nodes, _internal_nodes, _bounds,
+          duplicate_codes, false);
+      _contiguous_subtrees = true;
+      break;
+    case Experimental::ConstructionPolicy::Hierarchy::PLOC:
+    {
+      auto internal_nodes =
+          Details::makeUnquantizedInternalNodes(space, _internal_nodes);
+      Details::TreeConstruction::generateHierarchyPLOC(
+          space, values, _indexable_getter, permutation_indices,
+          policy._search_radius, _leaf_nodes, internal_nodes, _bounds);
+      Details::quantizeInternalNodes(space, internal_nodes, _bounds,
+                                     _internal_nodes);
+      break;
+    }
+    }
+  };
+  if constexpr (given_values)
+  {
+    generate_hierarchy(primitives);
+  }
+  else if (!chunks.streaming())
+  {
+    generate_hierarchy(
+        Details::LegacyValues<Primitives, indexable_type>{primitives});
+  }
+  else
+  {
+    // Fill the leaf nodes in sorted order and let the hierarchy generation
+    // read them back through the identity permutation
+    auto const permutation_indices_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, permutation_indices);
+    auto const leaf_nodes = _leaf_nodes;
+    chunks.forEachPermuted(
+        space, permutation_indices_host, [&](int offset, auto const &chunk) {
+          Details::LegacyValues<std::decay_t<decltype(chunk)>, indexable_type>
+              values{chunk};
+          Kokkos::parallel_for(
+              "ArborX::BVH::BVH::initialize_streamed_leaves",
+              Kokkos::RangePolicy<ExecutionSpace>(space, 0, values.size()),
+              KOKKOS_LAMBDA(int i) {
+                auto value = values(i);
+                value.index = permutation_indices(offset + i);
+                leaf_nodes(offset + i) = Details::makeLeafNode(value);
+              });
+        });
+    iota(space, permutation_indices);
+    generate_hierarchy(Details::LeafNodesValues<decltype(leaf_nodes)>{
+        leaf_nodes});
+  }
+
+  if (policy._depth_first_layout)
+    Details::TreeConstruction::reorderInternalNodesDepthFirst(
+        space, _leaf_nodes, _internal_nodes);
 
   Kokkos::Profiling::popRegion();
 }
 
+template <typename MemorySpace, typename Value, typename IndexableGetter,
+          typename BoundingVolume>
+template <typename ExecutionSpace, typename Primitives,
+          typename LinearOrderingValueType,
+          typename... LinearOrderingViewProperties>
+BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
+                             BoundingVolume>::
+    BasicBoundingVolumeHierarchy(
+        ExecutionSpace const &space, Primitives const &primitives,
+        Kokkos::View<LinearOrderingValueType *,
+                     LinearOrderingViewProperties...> const &sorted_codes,
+        Kokkos::View<unsigned int *, MemorySpace> const &permutation,
+        Experimental::ConstructionPolicy const &policy)
+    : _size(AccessTraits<Primitives, PrimitivesTag>::size(primitives))
+    , _leaf_nodes(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                     "ArborX::BVH::leaf_nodes"),
+                  _size)
+    , _internal_nodes(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                         "ArborX::BVH::internal_nodes"),
+                      _size > 1 ? _size - 1 : 0)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+  static_assert(
+      KokkosExt::is_accessible_from<
+          typename Kokkos::View<LinearOrderingValueType *,
+                                LinearOrderingViewProperties...>::memory_space,
+          ExecutionSpace>::value,
+      "Codes must be accessible from the execution space");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::BVH::BVH");
+
+  ARBORX_ASSERT(sorted_codes.extent(0) == size());
+  ARBORX_ASSERT(permutation.size() == 0 || permutation.extent(0) == size());
+
+  if (empty())
+  {
+    return;
+  }
+
+  Details::LegacyValues<Primitives, indexable_type> values{primitives};
+
+  if (size() == 1)
+  {
+    Details::TreeConstruction::initializeSingleLeafTree(
+        space, values, _indexable_getter, _leaf_nodes, _bounds);
+    return;
+  }
+
+  if (policy._numa_first_touch)
+    Details::TreeConstruction::firstTouchNodes(space, _leaf_nodes,
+                                               _internal_nodes);
+
+  auto permutation_indices = permutation;
+  if (permutation.size() == 0)
+  {
+    permutation_indices = Kokkos::View<unsigned int *, MemorySpace>(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::BVH::BVH::permute"),
+        size());
+    iota(space, permutation_indices);
+  }
+
+  Kokkos::Profiling::pushRegion("ArborX::BVH::BVH::generate_hierarchy");
+
+  // Quantized internal nodes still need the exact bounds of the scene
+  if constexpr (Details::is_quantized_internal_node<internal_node_type>::value)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<bounding_volume_type>;
+    ExperimentalHyperGeometry::Box<
+        DIM,
+        typename GeometryTraits::coordinate_type<bounding_volume_type>::type>
+        bbox{};
+    Details::TreeConstruction::calculateBoundingBoxOfTheScene(
+        space, Details::Indexables<Primitives>{primitives}, bbox);
+    for (int d = 0; d < DIM; ++d)
+    {
+      _bounds.minCorner()[d] = bbox.minCorner()[d];
+      _bounds.maxCorner()[d] = bbox.maxCorner()[d];
+    }
+  }
+  switch (policy._hierarchy)
+  {
+  case Experimental::ConstructionPolicy::Hierarchy::Linear:
+    Details::TreeConstruction::generateHierarchy(
+        space, values, _indexable_getter, permutation_indices, sorted_codes,
+        _leaf_nodes, _internal_nodes, _bounds);
+    _contiguous_subtrees = true;
+    break;
+  case Experimental::ConstructionPolicy::Hierarchy::PLOC:
+  {
+    auto internal_nodes =
+        Details::makeUnquantizedInternalNodes(space, _internal_nodes);
+    Details::TreeConstruction::generateHierarchyPLOC(
+        space, values, _indexable_getter, permutation_indices,
+        policy._search_radius, _leaf_nodes, internal_nodes, _bounds);
+    Details::quantizeInternalNodes(space, internal_nodes, _bounds,
+                                   _internal_nodes);
+    break;
+  }
+  }
+
+  if (policy._depth_first_layout)
+    Details::TreeConstruction::reorderInternalNodesDepthFirst(
+        space, _leaf_nodes, _internal_nodes);
+
+  Kokkos::Profiling::popRegion();
+}
+
+template <typename MemorySpace, typename Value, typename IndexableGetter,
+          typename BoundingVolume>
+template <typename ExecutionSpace, typename Primitives>
+float BasicBoundingVolumeHierarchy<
+    MemorySpace, Value, IndexableGetter,
+    BoundingVolume>::refit(ExecutionSpace const &space,
+                           Primitives const &primitives)
+{
+  static_assert(
+      std::is_same_v<value_type, Details::PairIndexVolume<indexable_type>>,
+      "Only hierarchies of index and bounding volume pairs can be refitted");
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+
+  ARBORX_ASSERT(Access::size(primitives) == size());
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::BVH::refit");
+
+  if (empty())
+  {
+    return 1.f;
+  }
+
+  Details::LegacyValues<Primitives, indexable_type> values{primitives};
+
+  if (size() == 1)
+  {
+    Details::TreeConstruction::initializeSingleLeafTree(
+        space, values, _indexable_getter, _leaf_nodes, _bounds);
+    return 1.f;
+  }
+
+  if (_construction_cost < 0)
+    _construction_cost =
+        Details::TreeConstruction::computeSurfaceAreaHeuristicCost(
+            space, _internal_nodes, _bounds);
+
+  // Quantized internal nodes are refitted in place on the grid spanned by the
+  // new bounds of the scene
+  if constexpr (Details::is_quantized_internal_node<internal_node_type>::value)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<bounding_volume_type>;
+    ExperimentalHyperGeometry::Box<
+        DIM,
+        typename GeometryTraits::coordinate_type<bounding_volume_type>::type>
+        bbox{};
+    Details::TreeConstruction::calculateBoundingBoxOfTheScene(
+        space, Details::Indexables<Primitives>{primitives}, bbox);
+    for (int d = 0; d < DIM; ++d)
+    {
+      _bounds.minCorner()[d] = bbox.minCorner()[d];
+      _bounds.maxCorner()[d] = bbox.maxCorner()[d];
+    }
+  }
+
+  Kokkos::Profiling::pushRegion("ArborX::BVH::refit::find_parents");
+
+  Kokkos::View<int *, MemorySpace> parents(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVH::refit::parents"),
+      2 * size() - 1);
+  Details::findParents(space, *this, parents);
+
+  Kokkos::Profiling::popRegion();
+  Kokkos::Profiling::pushRegion("ArborX::BVH::refit::refit_hierarchy");
+
+  Details::TreeConstruction::refitHierarchy(space, values, _indexable_getter,
+                                            parents, _leaf_nodes,
+                                            _internal_nodes, _bounds);
+
+  Kokkos::Profiling::popRegion();
+
+  auto const cost = Details::TreeConstruction::computeSurfaceAreaHeuristicCost(
+      space, _internal_nodes, _bounds);
+  return (_construction_cost > 0 ? cost / _construction_cost : 1.f);
+}
+
 template <typename MemorySpace, typename Value, typename IndexableGetter,
           typename BoundingVolume>
 template <typename ExecutionSpace, typename Predicates, typename Callback>
@@ -261,7 +981,10 @@ void BasicBoundingVolumeHierarchy<
   static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
                                               ExecutionSpace>::value,
                 "Predicates must be accessible from the execution space");
-  Details::check_valid_callback<value_type>(callback, predicates);
+  if constexpr (Details::is_tagged_team_callback<Callback>{})
+    Details::check_valid_team_callback(callback, predicates);
+  else
+    Details::check_valid_callback<value_type>(callback, predicates);
 
   using Tag = typename Details::AccessTraitsHelper<Access>::tag;
   std::string profiling_prefix = "ArborX::BVH::query::";
@@ -278,6 +1001,10 @@ void BasicBoundingVolumeHierarchy<
   {
     profiling_prefix += "ordered_spatial";
   }
+  else if constexpr (std::is_same_v<Tag, Experimental::VariantPredicateTag>)
+  {
+    profiling_prefix += "variant";
+  }
   else
   {
     static_assert(std::is_void_v<Tag>, "ArborX implementation bug");
@@ -285,34 +1012,191 @@ void BasicBoundingVolumeHierarchy<
 
   Kokkos::Profiling::pushRegion(profiling_prefix);
 
-  if (policy._sort_predicates)
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+  ExperimentalHyperGeometry::Box<
+      GeometryTraits::dimension_v<bounding_volume_type>,
+      typename GeometryTraits::coordinate_type<bounding_volume_type>::type>
+      scene_bounding_box{};
+  using namespace Details;
+  expand(scene_bounding_box, bounds());
+
+  if (Details::BatchedQueries<DeviceType>::sortsPredicates(
+          space, policy, scene_bounding_box, predicates, profiling_prefix))
   {
     Kokkos::Profiling::pushRegion(profiling_prefix + "::compute_permutation");
-    using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
-    ExperimentalHyperGeometry::Box<
-        GeometryTraits::dimension_v<bounding_volume_type>,
-        typename GeometryTraits::coordinate_type<bounding_volume_type>::type>
-        scene_bounding_box{};
-    using namespace Details;
-    expand(scene_bounding_box, bounds());
-    auto permute = Details::BatchedQueries<DeviceType>::
-        sortPredicatesAlongSpaceFillingCurve(space, Experimental::Morton32(),
-                                             scene_bounding_box, predicates);
+    auto permute = Details::BatchedQueries<DeviceType>::sortPredicates(
+        space, policy, scene_bounding_box, predicates);
     Kokkos::Profiling::popRegion();
 
     using PermutedPredicates =
         Details::PermutedData<Predicates, decltype(permute)>;
     Details::traverse(space, *this, PermutedPredicates{predicates, permute},
-                      callback);
+                      callback, policy);
   }
   else
   {
-    Details::traverse(space, *this, predicates, callback);
+    Details::traverse(space, *this, predicates, callback, policy);
   }
 
   Kokkos::Profiling::popRegion();
 }
 
+template <typename MemorySpace, typename Value, typename IndexableGetter,
+          typename BoundingVolume>
+template <typename ExecutionSpace, typename Predicates>
+void BasicBoundingVolumeHierarchy<
+    MemorySpace, Value, IndexableGetter,
+    BoundingVolume>::countUpTo(ExecutionSpace const &space,
+                               Predicates const &predicates, int n,
+                               Kokkos::View<int *, MemorySpace> &counts,
+                               Experimental::TraversalPolicy const &policy)
+    const
+{
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(
+      std::is_same_v<typename Details::AccessTraitsHelper<Access>::tag,
+                     Details::SpatialPredicateTag>,
+      "Counting is only supported for spatial predicates");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::BVH::countUpTo");
+
+  KokkosExt::reallocWithoutInitializing(space, counts,
+                                        Access::size(predicates));
+  Kokkos::deep_copy(space, counts, 0);
+  if (n <= 0)
+    return;
+
+  // The callback finds the counter of a predicate from its attached index
+  using IndexedPredicates =
+      Details::PermutedData<Predicates, Details::CrsGraphWrapperImpl::Iota,
+                            true /*AttachIndices*/>;
+  query(space, IndexedPredicates{predicates, {}},
+        Details::CountUpToN<MemorySpace>{counts, n}, policy);
+}
+
+template <typename MemorySpace, typename Value, typename IndexableGetter,
+          typename BoundingVolume>
+template <typename ExecutionSpace, typename Predicates>
+void BasicBoundingVolumeHierarchy<
+    MemorySpace, Value, IndexableGetter,
+    BoundingVolume>::count(ExecutionSpace const &space,
+                           Predicates const &predicates,
+                           Kokkos::View<int *, MemorySpace> &counts,
+                           float relative_tolerance,
+                           Experimental::TraversalPolicy const &policy) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  static_assert(
+      std::is_same_v<typename Details::AccessTraitsHelper<Access>::tag,
+                     Details::SpatialPredicateTag>,
+      "Counting is only supported for spatial predicates");
+  ARBORX_ASSERT(relative_tolerance >= 0);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::BVH::count");
+
+  KokkosExt::reallocWithoutInitializing(space, counts,
+                                        Access::size(predicates));
+  if (empty())
+  {
+    Kokkos::deep_copy(space, counts, 0);
+    return;
+  }
+
+  auto const sizes = Experimental::computeNodeAggregates(
+      space, *this, Details::CountLeaves{}, Details::CountLeaves{});
+  Details::CountingTraversal(space, *this, predicates, sizes, counts,
+                             relative_tolerance, policy);
+}
+
 } // namespace ArborX
 
+// Construction of the hierarchies of 3D and 2D boxes from points or boxes, and
+// spatial and nearest queries of spheres, boxes and points into compressed
+// row storage
+#define ARBORX_IMPL_INSTANTIATE_BVH_CONSTRUCTION(EXTERN, ExecutionSpace,       \
+                                                 BoundingVolume, Primitive)    \
+  EXTERN template ArborX::BasicBoundingVolumeHierarchy<                        \
+      ExecutionSpace::memory_space,                                            \
+      ArborX::Details::PairIndexVolume<BoundingVolume>,                        \
+      ArborX::Details::DefaultIndexableGetter, BoundingVolume>::               \
+      BasicBoundingVolumeHierarchy(                                            \
+          ExecutionSpace const &,                                              \
+          Kokkos::View<Primitive *, ExecutionSpace::memory_space> const &,     \
+          ArborX::Experimental::Morton64 const &,                              \
+          ArborX::Experimental::ConstructionPolicy const &);
+
+#define ARBORX_IMPL_INSTANTIATE_BVH_QUERY(EXTERN, ExecutionSpace, Tag,         \
+                                          Predicate)                           \
+  EXTERN template void ArborX::Details::CrsGraphWrapperImpl::queryDispatch(    \
+      ArborX::Details::Tag,                                                    \
+      ArborX::BoundingVolumeHierarchy<ExecutionSpace::memory_space> const &,   \
+      ExecutionSpace const &,                                                  \
+      Kokkos::View<Predicate *, ExecutionSpace::memory_space> const &,         \
+      ArborX::Details::DefaultCallback const &,                                \
+      Kokkos::View<int *, ExecutionSpace::memory_space> &,                     \
+      Kokkos::View<int *, ExecutionSpace::memory_space> &,                     \
+      ArborX::Experimental::TraversalPolicy const &);
+
+// The values of the hierarchies that are not legacy are output as they are
+#define ARBORX_IMPL_INSTANTIATE_BASIC_BVH_QUERY(EXTERN, ExecutionSpace,        \
+                                                BoundingVolume, Tag,           \
+                                                Predicate)                     \
+  EXTERN template void ArborX::Details::CrsGraphWrapperImpl::queryDispatch(    \
+      ArborX::Details::Tag,                                                    \
+      ArborX::BasicBoundingVolumeHierarchy<                                    \
+          ExecutionSpace::memory_space,                                        \
+          ArborX::Details::PairIndexVolume<BoundingVolume>,                    \
+          ArborX::Details::DefaultIndexableGetter, BoundingVolume> const &,    \
+      ExecutionSpace const &,                                                  \
+      Kokkos::View<Predicate *, ExecutionSpace::memory_space> const &,         \
+      ArborX::Details::DefaultCallback const &,                                \
+      Kokkos::View<ArborX::Details::PairIndexVolume<BoundingVolume> *,         \
+                   ExecutionSpace::memory_space> &,                            \
+      Kokkos::View<int *, ExecutionSpace::memory_space> &,                     \
+      ArborX::Experimental::TraversalPolicy const &);
+
+#define ARBORX_IMPL_INSTANTIATE_BVH(EXTERN, ExecutionSpace)                    \
+  ARBORX_IMPL_INSTANTIATE_BVH_CONSTRUCTION(EXTERN, ExecutionSpace,             \
+                                           ArborX::Box, ArborX::Point)         \
+  ARBORX_IMPL_INSTANTIATE_BVH_CONSTRUCTION(EXTERN, ExecutionSpace,             \
+                                           ArborX::Box, ArborX::Box)           \
+  ARBORX_IMPL_INSTANTIATE_BVH_QUERY(EXTERN, ExecutionSpace,                    \
+                                    SpatialPredicateTag,                       \
+                                    ArborX::Intersects<ArborX::Sphere>)        \
+  ARBORX_IMPL_INSTANTIATE_BVH_QUERY(EXTERN, ExecutionSpace,                    \
+                                    SpatialPredicateTag,                       \
+                                    ArborX::Intersects<ArborX::Box>)           \
+  ARBORX_IMPL_INSTANTIATE_BVH_QUERY(EXTERN, ExecutionSpace,                    \
+                                    NearestPredicateTag,                       \
+                                    ArborX::Nearest<ArborX::Point>)            \
+  ARBORX_IMPL_INSTANTIATE_BVH_CONSTRUCTION(                                    \
+      EXTERN, ExecutionSpace, ArborX::ExperimentalHyperGeometry::Box<2>,       \
+      ArborX::ExperimentalHyperGeometry::Point<2>)                             \
+  ARBORX_IMPL_INSTANTIATE_BVH_CONSTRUCTION(                                    \
+      EXTERN, ExecutionSpace, ArborX::ExperimentalHyperGeometry::Box<2>,       \
+      ArborX::ExperimentalHyperGeometry::Box<2>)                               \
+  ARBORX_IMPL_INSTANTIATE_BASIC_BVH_QUERY(                                     \
+      EXTERN, ExecutionSpace, ArborX::ExperimentalHyperGeometry::Box<2>,       \
+      SpatialPredicateTag,                                                     \
+      ArborX::Intersects<ArborX::ExperimentalHyperGeometry::Sphere<2>>)        \
+  ARBORX_IMPL_INSTANTIATE_BASIC_BVH_QUERY(                                     \
+      EXTERN, ExecutionSpace, ArborX::ExperimentalHyperGeometry::Box<2>,       \
+      SpatialPredicateTag,                                                     \
+      ArborX::Intersects<ArborX::ExperimentalHyperGeometry::Box<2>>)           \
+  ARBORX_IMPL_INSTANTIATE_BASIC_BVH_QUERY(                                     \
+      EXTERN, ExecutionSpace, ArborX::ExperimentalHyperGeometry::Box<2>,       \
+      NearestPredicateTag,                                                     \
+      ArborX::Nearest<ArborX::ExperimentalHyperGeometry::Point<2>>)
+
+#ifdef ARBORX_ENABLE_EXPLICIT_INSTANTIATION
+ARBORX_IMPL_FOR_EACH_EXECUTION_SPACE(ARBORX_IMPL_INSTANTIATE_BVH, extern)
+#endif
+
 #endif
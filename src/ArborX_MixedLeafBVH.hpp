@@ -0,0 +1,243 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_MIXED_LEAF_BVH_HPP
+#define ARBORX_MIXED_LEAF_BVH_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // equals, expand
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsNode.hpp> // PairIndexVolume
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_Point.hpp>
+#include <ArborX_Predicates.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace ArborX
+{
+namespace Experimental
+{
+
+/** \brief Bounding volume hierarchy over boxes, some of which are points
+ *
+ *  The boxes are split by kind at construction: the degenerate ones, whose
+ *  corners are equal, go to a hierarchy whose leaves hold points, and the
+ *  others to a hierarchy whose leaves hold boxes. The leaves of the points
+ *  are smaller and tested against the predicates as points, so that mostly
+ *  point data with a few extended objects is searched nearly as fast as
+ *  points alone. Both hierarchies are searched for each predicate, the leaves
+ *  referring to the indices of the boxes given at construction. Only spatial
+ *  predicates are supported. The results of a predicate come in no
+ *  particular order.
+ */
+template <typename MemorySpace>
+class MixedLeafBVH
+{
+  using point_tree_type =
+      BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Point>,
+                                   Details::DefaultIndexableGetter, Box>;
+  using box_tree_type =
+      BasicBoundingVolumeHierarchy<MemorySpace, Details::PairIndexVolume<Box>,
+                                   Details::DefaultIndexableGetter, Box>;
+
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using size_type = typename box_tree_type::size_type;
+  using bounding_volume_type = Box;
+
+  MixedLeafBVH() = default; // build an empty tree
+
+  template <typename ExecutionSpace, typename Primitives>
+  MixedLeafBVH(ExecutionSpace const &space, Primitives const &primitives);
+
+  KOKKOS_FUNCTION
+  size_type size() const noexcept
+  {
+    return _point_tree.size() + _box_tree.size();
+  }
+
+  KOKKOS_FUNCTION
+  bool empty() const noexcept { return size() == 0; }
+
+  KOKKOS_FUNCTION
+  bounding_volume_type bounds() const noexcept { return _bounds; }
+
+  // Number of boxes stored as points
+  KOKKOS_FUNCTION
+  size_type numberOfPoints() const noexcept { return _point_tree.size(); }
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback,
+             TraversalPolicy const &policy = TraversalPolicy()) const
+  {
+    static_assert(!Details::is_tagged_team_callback<Callback>{},
+                  "Team callbacks are not supported");
+    using Tag = typename Details::AccessTraitsHelper<
+        AccessTraits<Predicates, PredicatesTag>>::tag;
+    static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{},
+                  "nearest query not implemented yet");
+    Details::check_valid_callback<int>(callback, predicates);
+
+    KokkosExt::ScopedProfileRegion guard("ArborX::MixedLeafBVH::query");
+
+    _point_tree.query(space, predicates,
+                      Details::LegacyCallbackWrapper<
+                          Callback, Details::PairIndexVolume<Point>>{callback},
+                      policy);
+    _box_tree.query(space, predicates,
+                    Details::LegacyCallbackWrapper<
+                        Callback, Details::PairIndexVolume<Box>>{callback},
+                    policy);
+  }
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+
+private:
+  point_tree_type _point_tree;
+  box_tree_type _box_tree;
+  Box _bounds;
+};
+
+template <typename MemorySpace>
+template <typename ExecutionSpace, typename Primitives>
+MixedLeafBVH<MemorySpace>::MixedLeafBVH(ExecutionSpace const &space,
+                                        Primitives const &primitives)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+  static_assert(
+      std::is_same_v<std::decay_t<decltype(Access::get(
+                         std::declval<Primitives const &>(), 0))>,
+                     Box>,
+      "The primitives must be boxes");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::MixedLeafBVH::MixedLeafBVH");
+
+  int const n = Access::size(primitives);
+
+  // Split the boxes by kind, keeping their indices
+  Kokkos::Profiling::pushRegion("ArborX::MixedLeafBVH::MixedLeafBVH::split");
+  Kokkos::View<int *, MemorySpace> ranks(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MixedLeafBVH::ranks"),
+      n);
+  int num_points = 0;
+  Kokkos::parallel_scan(
+      "ArborX::MixedLeafBVH::MixedLeafBVH::rank_points",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, int &update, bool final) {
+        auto const &box = Access::get(primitives, i);
+        bool const is_point =
+            Details::equals(box.minCorner(), box.maxCorner());
+        // Points count up from 0, and boxes down from -1
+        if (final)
+          ranks(i) = (is_point ? update : -1 - (i - update));
+        if (is_point)
+          ++update;
+      },
+      num_points);
+  int const num_boxes = n - num_points;
+
+  Kokkos::View<Point *, MemorySpace> points(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MixedLeafBVH::points"),
+      num_points);
+  Kokkos::View<unsigned *, MemorySpace> point_indices(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MixedLeafBVH::point_indices"),
+      num_points);
+  Kokkos::View<Box *, MemorySpace> boxes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MixedLeafBVH::boxes"),
+      num_boxes);
+  Kokkos::View<unsigned *, MemorySpace> box_indices(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MixedLeafBVH::box_indices"),
+      num_boxes);
+  Kokkos::parallel_for(
+      "ArborX::MixedLeafBVH::MixedLeafBVH::gather",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        auto const &box = Access::get(primitives, i);
+        int const rank = ranks(i);
+        if (rank >= 0)
+        {
+          points(rank) = box.minCorner();
+          point_indices(rank) = i;
+        }
+        else
+        {
+          boxes(-1 - rank) = box;
+          box_indices(-1 - rank) = i;
+        }
+      });
+  Kokkos::Profiling::popRegion();
+
+  _point_tree = point_tree_type(space, points);
+  _box_tree = box_tree_type(space, boxes);
+
+  // The leaves were paired with the positions of the boxes in their kind,
+  // replaced by the indices of the boxes
+  Kokkos::Profiling::pushRegion(
+      "ArborX::MixedLeafBVH::MixedLeafBVH::restore_indices");
+  auto const &point_leaves =
+      Details::HappyTreeFriends::getLeafNodes(_point_tree);
+  Kokkos::parallel_for(
+      "ArborX::MixedLeafBVH::MixedLeafBVH::restore_point_indices",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_points),
+      KOKKOS_LAMBDA(int i) {
+        auto &leaf = point_leaves(i).value;
+        leaf.index = point_indices(leaf.index);
+      });
+  auto const &box_leaves = Details::HappyTreeFriends::getLeafNodes(_box_tree);
+  Kokkos::parallel_for(
+      "ArborX::MixedLeafBVH::MixedLeafBVH::restore_box_indices",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_boxes),
+      KOKKOS_LAMBDA(int i) {
+        auto &leaf = box_leaves(i).value;
+        leaf.index = box_indices(leaf.index);
+      });
+  Kokkos::Profiling::popRegion();
+
+  _bounds = _point_tree.bounds();
+  Details::expand(_bounds, _box_tree.bounds());
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
@@ -0,0 +1,238 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_OPTICS_HPP
+#define ARBORX_OPTICS_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Dendrogram.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_MinimumSpanningTree.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ArborX::Details
+{
+
+// Order the leaves of the dendrogram depth-first. The reachability distance
+// of a leaf is the height of its lowest common ancestor with the previous
+// leaf.
+template <typename Parents, typename ParentHeights>
+void orderDendrogramLeavesHost(Parents const &parents_host,
+                               ParentHeights const &parent_heights_host,
+                               Kokkos::View<int *, Kokkos::HostSpace> ordering,
+                               Kokkos::View<float *, Kokkos::HostSpace> reach)
+{
+  int const num_vertices = ordering.size();
+  int const num_edges = num_vertices - 1;
+  int const num_nodes = num_edges + num_vertices;
+
+  constexpr int UNDEFINED = -1;
+  Kokkos::View<int * [2], Kokkos::HostSpace> children(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "ArborX::OPTICS::children"),
+      num_edges);
+  Kokkos::deep_copy(children, UNDEFINED);
+  for (int node = 0; node < num_nodes; ++node)
+  {
+    int const parent = parents_host(node);
+    if (parent == UNDEFINED)
+      continue;
+    children(parent, children(parent, 0) == UNDEFINED ? 0 : 1) = node;
+  }
+
+  std::vector<std::pair<int, float>> stack;
+  stack.emplace_back(num_edges - 1, std::numeric_limits<float>::infinity());
+  int k = 0;
+  while (!stack.empty())
+  {
+    auto const [node, distance] = stack.back();
+    stack.pop_back();
+    if (node >= num_edges)
+    {
+      ordering(k) = node - num_edges;
+      reach(k) = distance;
+      ++k;
+      continue;
+    }
+    // The first leaf of the second child is the first one to be reached
+    // through this edge
+    stack.emplace_back(children(node, 1), parent_heights_host(node));
+    stack.emplace_back(children(node, 0), distance);
+  }
+}
+
+} // namespace ArborX::Details
+
+namespace ArborX::Experimental
+{
+
+// Ordering of the points such that, for any eps, the DBSCAN* clusters are
+// contiguous. The reachability distance of the point at position k in the
+// ordering is the smallest mutual reachability distance eps at which it is
+// in the same cluster as the point at position k - 1 (infinity for the first
+// point).
+template <typename MemorySpace>
+struct ReachabilityOrdering
+{
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+
+  Kokkos::View<int *, MemorySpace> _ordering;
+  Kokkos::View<float *, MemorySpace> _reachability_distances;
+  // Indexed by the points, not by their positions in the ordering
+  Kokkos::View<float *, MemorySpace> _core_distances;
+};
+
+// Compute the reachability ordering of the points over the mutual
+// reachability distances with the given core_min_size. The clusters for any
+// eps can then be extracted with dbscanFromReachability in linear time.
+template <typename ExecutionSpace, typename Primitives>
+auto optics(ExecutionSpace const &exec_space, Primitives const &primitives,
+            int core_min_size)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::OPTICS");
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value,
+      "Primitives must be accessible from the execution space");
+
+  ARBORX_ASSERT(core_min_size >= 2);
+
+  int const n = Access::size(primitives);
+
+  ReachabilityOrdering<MemorySpace> reachability{
+      Kokkos::View<int *, MemorySpace>(
+          Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                             "ArborX::OPTICS::ordering"),
+          n),
+      Kokkos::View<float *, MemorySpace>(
+          Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                             "ArborX::OPTICS::reachability_distances"),
+          n),
+      Kokkos::View<float *, MemorySpace>("ArborX::OPTICS::core_distances", n)};
+  if (n == 0)
+    return reachability;
+  if (n == 1)
+  {
+    Kokkos::deep_copy(exec_space, reachability._ordering, 0);
+    Kokkos::deep_copy(exec_space, reachability._reachability_distances,
+                      std::numeric_limits<float>::infinity());
+    Kokkos::deep_copy(exec_space, reachability._core_distances,
+                      std::numeric_limits<float>::infinity());
+    return reachability;
+  }
+
+  Kokkos::Profiling::pushRegion("ArborX::OPTICS::mst");
+  Details::MinimumSpanningTree<MemorySpace> mst(exec_space, primitives,
+                                                core_min_size);
+  reachability._core_distances = mst.core_distances;
+  // With fewer points than core_min_size, there are no core points
+  if (n < core_min_size)
+    Kokkos::deep_copy(exec_space, reachability._core_distances,
+                      std::numeric_limits<float>::infinity());
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::Profiling::pushRegion("ArborX::OPTICS::dendrogram");
+  Dendrogram<MemorySpace> dendrogram(exec_space, mst.edges);
+  Kokkos::Profiling::popRegion();
+
+  Kokkos::Profiling::pushRegion("ArborX::OPTICS::ordering");
+  auto parents_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{}, dendrogram._parents);
+  auto parent_heights_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{}, dendrogram._parent_heights);
+  auto ordering_host = Kokkos::create_mirror_view(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing), reachability._ordering);
+  auto reachability_distances_host = Kokkos::create_mirror_view(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing),
+      reachability._reachability_distances);
+  Details::orderDendrogramLeavesHost(parents_host, parent_heights_host,
+                                     ordering_host,
+                                     reachability_distances_host);
+  Kokkos::deep_copy(exec_space, reachability._ordering, ordering_host);
+  Kokkos::deep_copy(exec_space, reachability._reachability_distances,
+                    reachability_distances_host);
+  Kokkos::Profiling::popRegion();
+
+  return reachability;
+}
+
+// Extract the DBSCAN* clusters for a given eps from the reachability
+// ordering. Only core points are assigned to clusters, the border points
+// being marked as noise (-1) along with the other non-core points. Each
+// cluster is labeled with the index of one of its points.
+template <typename ExecutionSpace, typename MemorySpace>
+Kokkos::View<int *, MemorySpace>
+dbscanFromReachability(ExecutionSpace const &exec_space,
+                       ReachabilityOrdering<MemorySpace> const &reachability,
+                       float eps)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::OPTICS::extract_dbscan");
+
+  auto const &ordering = reachability._ordering;
+  auto const &reachability_distances = reachability._reachability_distances;
+  auto const &core_distances = reachability._core_distances;
+  int const n = ordering.size();
+
+  Kokkos::View<int *, MemorySpace> labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::OPTICS::labels"),
+      n);
+  // First point of each cluster in the ordering
+  Kokkos::View<int *, MemorySpace> representatives(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::OPTICS::representatives"),
+      n);
+
+  // The clusters are contiguous in the ordering. A core point too far from
+  // the previous points starts a new cluster, and the other core points are in
+  // the current one. The non-core points are noise.
+  Kokkos::parallel_scan(
+      "ArborX::OPTICS::number_clusters",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int k, int &update, bool final_pass) {
+        int const i = ordering(k);
+        bool const is_noise = !(core_distances(i) <= eps);
+        bool const starts_cluster =
+            !is_noise && !(reachability_distances(k) <= eps);
+        if (starts_cluster)
+          ++update;
+        if (final_pass)
+        {
+          labels(i) = (is_noise ? -1 : update - 1);
+          if (starts_cluster)
+            representatives(update - 1) = i;
+        }
+      });
+  Kokkos::parallel_for(
+      "ArborX::OPTICS::label_clusters",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        if (labels(i) != -1)
+          labels(i) = representatives(labels(i));
+      });
+
+  return labels;
+}
+
+} // namespace ArborX::Experimental
+
+#endif
@@ -0,0 +1,397 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_TREE_SERIALIZATION_HPP
+#define ARBORX_TREE_SERIALIZATION_HPP
+
+#include <ArborX_Config.hpp>
+
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_LinearBVH.hpp>
+#ifdef ARBORX_ENABLE_MPI
+#include <ArborX_DistributedTree.hpp>
+#endif
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+#include <cstring> // memcpy, memcmp
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+namespace ArborX
+{
+namespace Details
+{
+
+// Trees are stored in a flat binary format. A fixed-size header is followed
+// by the bounds of the scene, the leaf nodes, and the internal nodes, each
+// section starting at an offset aligned to 64 bytes. The nodes are stored as
+// they are in memory, so that they can be used in place from a memory-mapped
+// file.
+struct TreeSerialization
+{
+  static constexpr std::uint32_t version = 1;
+  static constexpr std::uint32_t byte_order_mark = 0x01020304;
+  static constexpr std::uint64_t alignment = 64;
+
+  struct Header
+  {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order_mark;
+    std::uint64_t size;
+    std::uint64_t bounds_bytes;
+    std::uint64_t leaf_node_bytes;
+    std::uint64_t internal_node_bytes;
+    std::uint64_t bounds_offset;
+    std::uint64_t leaf_nodes_offset;
+    std::uint64_t internal_nodes_offset;
+    std::uint64_t total_bytes;
+    float construction_cost;
+    std::uint32_t contiguous_subtrees;
+  };
+
+  static constexpr char const magic[8] = {'A', 'R', 'B', 'O', 'R', 'X',
+                                          'B', 'V'};
+
+  static constexpr std::uint64_t align(std::uint64_t offset)
+  {
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+
+  template <typename Tree>
+  static Header makeHeader(Tree const &tree)
+  {
+    using LeafNode = typename decltype(tree._leaf_nodes)::value_type;
+    using InternalNode = typename decltype(tree._internal_nodes)::value_type;
+    static_assert(std::is_trivially_copyable_v<LeafNode>);
+    static_assert(std::is_trivially_copyable_v<InternalNode>);
+
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.byte_order_mark = byte_order_mark;
+    header.size = tree._size;
+    header.bounds_bytes = sizeof(tree._bounds);
+    header.leaf_node_bytes = sizeof(LeafNode);
+    header.internal_node_bytes = sizeof(InternalNode);
+    header.bounds_offset = align(sizeof(Header));
+    header.leaf_nodes_offset =
+        align(header.bounds_offset + header.bounds_bytes);
+    header.internal_nodes_offset =
+        align(header.leaf_nodes_offset +
+              tree._leaf_nodes.extent(0) * header.leaf_node_bytes);
+    header.total_bytes =
+        header.internal_nodes_offset +
+        tree._internal_nodes.extent(0) * header.internal_node_bytes;
+    header.construction_cost = tree._construction_cost;
+    header.contiguous_subtrees = tree._contiguous_subtrees;
+    return header;
+  }
+
+  // Check that the header describes a tree of the same type, and was written
+  // on a platform with the same byte order
+  template <typename Tree>
+  static void checkHeader(Header const &header, Tree const &tree)
+  {
+    using LeafNode = typename decltype(tree._leaf_nodes)::value_type;
+    using InternalNode = typename decltype(tree._internal_nodes)::value_type;
+
+    ARBORX_ASSERT(std::memcmp(header.magic, magic, sizeof(magic)) == 0);
+    ARBORX_ASSERT(header.version == version);
+    ARBORX_ASSERT(header.byte_order_mark == byte_order_mark);
+    ARBORX_ASSERT(header.bounds_bytes == sizeof(tree._bounds));
+    ARBORX_ASSERT(header.leaf_node_bytes == sizeof(LeafNode));
+    ARBORX_ASSERT(header.internal_node_bytes == sizeof(InternalNode));
+  }
+
+  static std::uint64_t numInternalNodes(std::uint64_t size)
+  {
+    return size > 1 ? size - 1 : 0;
+  }
+
+  template <typename ExecutionSpace, typename Tree>
+  static void allocateNodes(ExecutionSpace const &space, std::uint64_t size,
+                            Tree &tree)
+  {
+    using LeafNodes = decltype(tree._leaf_nodes);
+    using InternalNodes = decltype(tree._internal_nodes);
+    tree._leaf_nodes =
+        LeafNodes(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                     "ArborX::BVH::leaf_nodes"),
+                  size);
+    tree._internal_nodes =
+        InternalNodes(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                         "ArborX::BVH::internal_nodes"),
+                      numInternalNodes(size));
+  }
+
+  static void writePadding(std::ostream &os, std::uint64_t &offset,
+                           std::uint64_t next_offset)
+  {
+    char const zeros[alignment] = {};
+    os.write(zeros, next_offset - offset);
+    offset = next_offset;
+  }
+
+  template <typename ExecutionSpace, typename Tree>
+  static void save(ExecutionSpace const &space, Tree const &tree,
+                   std::ostream &os)
+  {
+    auto const header = makeHeader(tree);
+
+    space.fence("ArborX::TreeSerialization::save (tree is ready)");
+    auto const leaf_nodes_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, tree._leaf_nodes);
+    auto const internal_nodes_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, tree._internal_nodes);
+
+    std::uint64_t offset = 0;
+    os.write(reinterpret_cast<char const *>(&header), sizeof(Header));
+    offset += sizeof(Header);
+    writePadding(os, offset, header.bounds_offset);
+    os.write(reinterpret_cast<char const *>(&tree._bounds),
+             header.bounds_bytes);
+    offset += header.bounds_bytes;
+    writePadding(os, offset, header.leaf_nodes_offset);
+    os.write(reinterpret_cast<char const *>(leaf_nodes_host.data()),
+             leaf_nodes_host.extent(0) * header.leaf_node_bytes);
+    offset += leaf_nodes_host.extent(0) * header.leaf_node_bytes;
+    writePadding(os, offset, header.internal_nodes_offset);
+    os.write(reinterpret_cast<char const *>(internal_nodes_host.data()),
+             internal_nodes_host.extent(0) * header.internal_node_bytes);
+
+    ARBORX_ASSERT(os.good());
+  }
+
+  template <typename ExecutionSpace, typename Tree>
+  static void load(ExecutionSpace const &space, std::istream &is, Tree &tree)
+  {
+    Header header;
+    is.read(reinterpret_cast<char *>(&header), sizeof(Header));
+    ARBORX_ASSERT(is.good());
+    checkHeader(header, tree);
+
+    tree._size = header.size;
+    tree._construction_cost = header.construction_cost;
+    tree._contiguous_subtrees = (header.contiguous_subtrees != 0);
+    allocateNodes(space, header.size, tree);
+    auto leaf_nodes_host = Kokkos::create_mirror_view(
+        Kokkos::view_alloc(Kokkos::HostSpace{}, Kokkos::WithoutInitializing),
+        tree._leaf_nodes);
+    auto internal_nodes_host = Kokkos::create_mirror_view(
+        Kokkos::view_alloc(Kokkos::HostSpace{}, Kokkos::WithoutInitializing),
+        tree._internal_nodes);
+
+    std::uint64_t offset = sizeof(Header);
+    auto read = [&is, &offset](void *data, std::uint64_t data_offset,
+                               std::uint64_t bytes) {
+      is.ignore(data_offset - offset);
+      is.read(static_cast<char *>(data), bytes);
+      ARBORX_ASSERT(is.good());
+      offset = data_offset + bytes;
+    };
+    read(&tree._bounds, header.bounds_offset, header.bounds_bytes);
+    read(leaf_nodes_host.data(), header.leaf_nodes_offset,
+         leaf_nodes_host.extent(0) * header.leaf_node_bytes);
+    read(internal_nodes_host.data(), header.internal_nodes_offset,
+         internal_nodes_host.extent(0) * header.internal_node_bytes);
+
+    Kokkos::deep_copy(space, tree._leaf_nodes, leaf_nodes_host);
+    Kokkos::deep_copy(space, tree._internal_nodes, internal_nodes_host);
+  }
+
+  template <typename ExecutionSpace, typename Tree>
+  static void load(ExecutionSpace const &space, void *buffer,
+                   std::size_t buffer_size, Tree &tree)
+  {
+    using MemorySpace = typename Tree::memory_space;
+    using LeafNodes = decltype(tree._leaf_nodes);
+    using InternalNodes = decltype(tree._internal_nodes);
+
+    ARBORX_ASSERT(buffer_size >= sizeof(Header));
+    Header header;
+    std::memcpy(&header, buffer, sizeof(Header));
+    checkHeader(header, tree);
+    ARBORX_ASSERT(buffer_size >= header.total_bytes);
+
+    auto *data = static_cast<char *>(buffer);
+    auto *leaf_nodes_data = reinterpret_cast<typename LeafNodes::value_type *>(
+        data + header.leaf_nodes_offset);
+    auto *internal_nodes_data =
+        reinterpret_cast<typename InternalNodes::value_type *>(
+            data + header.internal_nodes_offset);
+    ARBORX_ASSERT(reinterpret_cast<std::uintptr_t>(data) % alignment == 0);
+
+    tree._size = header.size;
+    tree._construction_cost = header.construction_cost;
+    tree._contiguous_subtrees = (header.contiguous_subtrees != 0);
+    std::memcpy(&tree._bounds, data + header.bounds_offset,
+                header.bounds_bytes);
+
+    if constexpr (Kokkos::SpaceAccessibility<Kokkos::HostSpace,
+                                             MemorySpace>::accessible)
+    {
+      // Use the nodes in place
+      (void)space;
+      tree._leaf_nodes = LeafNodes(leaf_nodes_data, header.size);
+      tree._internal_nodes =
+          InternalNodes(internal_nodes_data, numInternalNodes(header.size));
+    }
+    else
+    {
+      allocateNodes(space, header.size, tree);
+      Kokkos::deep_copy(
+          space, tree._leaf_nodes,
+          Kokkos::View<typename LeafNodes::value_type *, Kokkos::HostSpace,
+                       Kokkos::MemoryUnmanaged>(leaf_nodes_data, header.size));
+      Kokkos::deep_copy(
+          space, tree._internal_nodes,
+          Kokkos::View<typename InternalNodes::value_type *, Kokkos::HostSpace,
+                       Kokkos::MemoryUnmanaged>(internal_nodes_data,
+                                                numInternalNodes(header.size)));
+      space.fence("ArborX::TreeSerialization::load (copy from buffer)");
+    }
+  }
+
+  // Same nodes in another memory space, e.g. to search a device tree from
+  // the host
+  template <typename ExecutionSpace, typename Tree, typename OtherTree>
+  static void copy(ExecutionSpace const &space, Tree const &tree,
+                   OtherTree &other)
+  {
+    static_assert(
+        std::is_same_v<typename decltype(tree._leaf_nodes)::value_type,
+                       typename decltype(other._leaf_nodes)::value_type>);
+    static_assert(
+        std::is_same_v<typename decltype(tree._internal_nodes)::value_type,
+                       typename decltype(other._internal_nodes)::value_type>);
+
+    other._size = tree._size;
+    other._construction_cost = tree._construction_cost;
+    other._contiguous_subtrees = tree._contiguous_subtrees;
+    other._bounds = tree._bounds;
+    other._indexable_getter = tree._indexable_getter;
+    other._leaf_nodes = Kokkos::create_mirror_view_and_copy(
+        typename OtherTree::memory_space{}, tree._leaf_nodes);
+    other._internal_nodes = Kokkos::create_mirror_view_and_copy(
+        typename OtherTree::memory_space{}, tree._internal_nodes);
+    space.fence("ArborX::TreeSerialization::copy (nodes copied)");
+  }
+
+#ifdef ARBORX_ENABLE_MPI
+  template <typename ExecutionSpace, typename MemorySpace>
+  static void save(ExecutionSpace const &space,
+                   DistributedTree<MemorySpace> const &tree, std::ostream &os)
+  {
+    save(space, tree._bottom_tree, os);
+  }
+
+  template <typename MemorySpace, typename ExecutionSpace, typename... Args>
+  static DistributedTree<MemorySpace>
+  loadDistributed(MPI_Comm comm, ExecutionSpace const &space, Args &&...args)
+  {
+    BVH<MemorySpace> bottom_tree;
+    load(space, std::forward<Args>(args)..., bottom_tree);
+    return DistributedTree<MemorySpace>(comm, space, bottom_tree);
+  }
+#endif
+};
+
+} // namespace Details
+
+namespace Experimental
+{
+
+/** \brief Write a tree to a stream
+ *
+ *  The tree can be read back with loadTree() by a process running on a
+ *  platform with the same byte order, for the same tree type. For a
+ *  distributed tree, each process writes its local tree.
+ */
+template <typename ExecutionSpace, typename Tree>
+void saveTree(ExecutionSpace const &space, Tree const &tree, std::ostream &os)
+{
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+  KokkosExt::ScopedProfileRegion guard("ArborX::Experimental::saveTree");
+  Details::TreeSerialization::save(space, tree, os);
+}
+
+/** \brief Read a tree previously written by saveTree() from a stream
+ */
+template <typename Tree, typename ExecutionSpace>
+Tree loadTree(ExecutionSpace const &space, std::istream &is)
+{
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+  KokkosExt::ScopedProfileRegion guard("ArborX::Experimental::loadTree");
+  Tree tree;
+  Details::TreeSerialization::load(space, is, tree);
+  return tree;
+}
+
+/** \brief Load a tree from a buffer containing the data written by saveTree()
+ *
+ *  This is meant to be used with a memory-mapped file. The buffer must be
+ *  aligned to 64 bytes (mmap returns page-aligned addresses). If the memory
+ *  space of the tree is accessible from the host, the tree uses the buffer in
+ *  place and the buffer must outlive the tree (and be writable for refit()).
+ *  Otherwise, the nodes are copied into the tree memory space.
+ */
+template <typename Tree, typename ExecutionSpace>
+Tree loadTree(ExecutionSpace const &space, void *buffer,
+              std::size_t buffer_size)
+{
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+  KokkosExt::ScopedProfileRegion guard("ArborX::Experimental::loadTree");
+  Tree tree;
+  Details::TreeSerialization::load(space, buffer, buffer_size, tree);
+  return tree;
+}
+
+/** \brief Copy a tree into a tree of the same kind in another memory space
+ *
+ *  The nodes are copied as they are, without reconstruction, e.g. into
+ *  BVH<Kokkos::HostSpace> to search a device tree on the host as well.
+ */
+template <typename Tree, typename ExecutionSpace, typename OtherTree>
+Tree copyTree(ExecutionSpace const &space, OtherTree const &other)
+{
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+  KokkosExt::ScopedProfileRegion guard("ArborX::Experimental::copyTree");
+  Tree tree;
+  Details::TreeSerialization::copy(space, other, tree);
+  return tree;
+}
+
+#ifdef ARBORX_ENABLE_MPI
+/** \brief Read the local trees previously written by saveTree() on each
+ *  process and assemble the distributed tree
+ *
+ *  \note Must be called as collective over all processes in the
+ *  communicator.
+ */
+template <typename Tree, typename ExecutionSpace, typename... Args>
+Tree loadTree(MPI_Comm comm, ExecutionSpace const &space, Args &&...args)
+{
+  static_assert(Kokkos::is_execution_space<ExecutionSpace>::value);
+  KokkosExt::ScopedProfileRegion guard("ArborX::Experimental::loadTree");
+  return Details::TreeSerialization::loadDistributed<
+      typename Tree::memory_space>(comm, space, std::forward<Args>(args)...);
+}
+#endif
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
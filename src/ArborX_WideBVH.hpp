@@ -0,0 +1,162 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_WIDE_BVH_HPP
+#define ARBORX_WIDE_BVH_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsWideBVHImpl.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <utility> // move
+
+namespace ArborX::Experimental
+{
+
+// Bounding volume hierarchy with Width (4 or 8) children per node, obtained
+// by collapsing the binary hierarchy. The bounding volumes of the children of
+// a node are stored contiguously and are checked together during the
+// traversal, which is favorable to vectorization on CPUs. Hierarchies too
+// deep for the fixed-size traversal stack, as may happen with clustered data,
+// keep the binary hierarchy and are searched through its ropes instead. Only
+// spatial queries are supported.
+template <typename MemorySpace, int Width = 4, typename BoundingVolume = Box>
+class WideBoundingVolumeHierarchy
+{
+  using binary_tree_type =
+      BasicBoundingVolumeHierarchy<MemorySpace,
+                                   Details::PairIndexVolume<BoundingVolume>,
+                                   Details::DefaultIndexableGetter,
+                                   BoundingVolume>;
+
+public:
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+  using size_type = typename MemorySpace::size_type;
+  using bounding_volume_type = BoundingVolume;
+  static_assert(Width == 4 || Width == 8);
+  static_assert(GeometryTraits::is_box<BoundingVolume>{});
+
+  WideBoundingVolumeHierarchy() = default; // build an empty tree
+
+  template <typename ExecutionSpace, typename Primitives,
+            typename SpaceFillingCurve = Experimental::Morton64>
+  WideBoundingVolumeHierarchy(
+      ExecutionSpace const &space, Primitives const &primitives,
+      SpaceFillingCurve const &curve = SpaceFillingCurve(),
+      ConstructionPolicy const &policy = ConstructionPolicy());
+
+  KOKKOS_FUNCTION
+  size_type size() const noexcept { return _size; }
+
+  KOKKOS_FUNCTION
+  bool empty() const noexcept { return size() == 0; }
+
+  KOKKOS_FUNCTION
+  bounding_volume_type bounds() const noexcept { return _bounds; }
+
+  template <typename ExecutionSpace, typename Predicates, typename Callback,
+            typename Ignore = int>
+  void query(ExecutionSpace const &space, Predicates const &predicates,
+             Callback const &callback, Ignore = Ignore()) const;
+
+  template <typename ExecutionSpace, typename Predicates,
+            typename CallbackOrView, typename View, typename... Args>
+  std::enable_if_t<Kokkos::is_view_v<std::decay_t<View>>>
+  query(ExecutionSpace const &space, Predicates const &predicates,
+        CallbackOrView &&callback_or_view, View &&view, Args &&...args) const
+  {
+    ArborX::query(*this, space, predicates,
+                  std::forward<CallbackOrView>(callback_or_view),
+                  std::forward<View>(view), std::forward<Args>(args)...);
+  }
+
+private:
+  size_type _size{0};
+  bounding_volume_type _bounds;
+  Kokkos::View<Details::WideNode<bounding_volume_type, Width> *, MemorySpace>
+      _nodes;
+  // Only built when the wide nodes cannot be traversed
+  binary_tree_type _binary_tree;
+};
+
+template <typename MemorySpace, int Width, typename BoundingVolume>
+template <typename ExecutionSpace, typename Primitives,
+          typename SpaceFillingCurve>
+WideBoundingVolumeHierarchy<MemorySpace, Width, BoundingVolume>::
+    WideBoundingVolumeHierarchy(ExecutionSpace const &space,
+                                Primitives const &primitives,
+                                SpaceFillingCurve const &curve,
+                                ConstructionPolicy const &policy)
+    : _size(AccessTraits<Primitives, PrimitivesTag>::size(primitives))
+    , _nodes("ArborX::WideBVH::nodes", 0)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::WideBVH::WideBVH");
+
+  binary_tree_type bvh(space, primitives, curve, policy);
+  _bounds = bvh.bounds();
+
+  Kokkos::Profiling::pushRegion("ArborX::WideBVH::WideBVH::collapse");
+  int const max_deferred = Details::WideBVHImpl::collapse(space, bvh, _nodes);
+  Kokkos::Profiling::popRegion();
+
+  if (max_deferred > Details::WideBVHImpl::stack_capacity)
+  {
+    Kokkos::resize(_nodes, 0);
+    _binary_tree = std::move(bvh);
+  }
+}
+
+template <typename MemorySpace, int Width, typename BoundingVolume>
+template <typename ExecutionSpace, typename Predicates, typename Callback,
+          typename Ignore>
+void WideBoundingVolumeHierarchy<MemorySpace, Width, BoundingVolume>::query(
+    ExecutionSpace const &space, Predicates const &predicates,
+    Callback const &callback, Ignore) const
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  static_assert(std::is_same<Tag, Details::SpatialPredicateTag>{},
+                "nearest query not implemented yet");
+  using Value = int;
+  Details::check_valid_callback<Value>(callback, predicates);
+
+  Kokkos::Profiling::pushRegion("ArborX::WideBVH::query::spatial");
+
+  if (!_binary_tree.empty())
+    _binary_tree.query(
+        space, predicates,
+        Details::LegacyCallbackWrapper<
+            Callback, Details::PairIndexVolume<BoundingVolume>>{callback});
+  else
+    Details::WideBVHImpl::query(space, _nodes, predicates, callback);
+
+  Kokkos::Profiling::popRegion();
+}
+
+} // namespace ArborX::Experimental
+
+#endif
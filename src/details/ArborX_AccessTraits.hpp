@@ -12,6 +12,7 @@
 #ifndef ARBORX_ACCESS_TRAITS_HPP
 #define ARBORX_ACCESS_TRAITS_HPP
 
+#include <ArborX_Exception.hpp>
 #include <ArborX_GeometryTraits.hpp>
 #include <ArborX_HyperPoint.hpp>
 #include <ArborX_Point.hpp>
@@ -82,6 +83,63 @@ struct AccessTraits<
   using memory_space = typename View::memory_space;
 };
 
+namespace Experimental
+{
+
+// Points with their coordinates stored in one view per dimension, e.g. x, y
+// and z, rather than in a view of points. The points are assembled on access
+// so that the coordinates do not need to be copied, and consecutive indices
+// still read consecutive memory.
+template <typename View, int DIM>
+struct StructureOfArrays
+{
+  static_assert(Kokkos::is_view<View>{} && View::rank == 1);
+
+  Kokkos::Array<View, DIM> _coordinates;
+};
+
+template <typename View, typename... Views>
+StructureOfArrays<View, 1 + sizeof...(Views)>
+makeStructureOfArrays(View const &coordinates,
+                      Views const &...other_coordinates)
+{
+  static_assert((std::is_same_v<View, Views> && ...),
+                "The coordinates must all be stored in views of the same type");
+  ARBORX_ASSERT(((coordinates.extent(0) == other_coordinates.extent(0)) &&
+                 ...));
+  return {{{coordinates, other_coordinates...}}};
+}
+
+} // namespace Experimental
+
+template <typename View, int DIM>
+struct AccessTraits<Experimental::StructureOfArrays<View, DIM>, PrimitivesTag>
+{
+  using Primitives = Experimental::StructureOfArrays<View, DIM>;
+  using Coordinate = typename View::non_const_value_type;
+  // The legacy point works with all of the bounding volumes
+  using Point = std::conditional_t<
+      DIM == 3 && std::is_same_v<Coordinate, float>, ArborX::Point,
+      ExperimentalHyperGeometry::Point<DIM, Coordinate>>;
+
+  // Returns by value
+  KOKKOS_FUNCTION static Point get(Primitives const &soa, int i)
+  {
+    Point point;
+    for (int d = 0; d < DIM; ++d)
+      point[d] = soa._coordinates[d](i);
+    return point;
+  }
+
+  KOKKOS_FUNCTION
+  static typename View::size_type size(Primitives const &soa)
+  {
+    return soa._coordinates[0].extent(0);
+  }
+
+  using memory_space = typename View::memory_space;
+};
+
 namespace Details
 {
 
@@ -14,6 +14,7 @@
 #include <ArborX_AccessTraits.hpp>
 #include <ArborX_Predicates.hpp> // is_valid_predicate_tag
 
+#include <Kokkos_Core.hpp>
 #include <Kokkos_DetectionIdiom.hpp>
 #include <Kokkos_Macros.hpp>
 
@@ -28,6 +29,15 @@ enum class CallbackTreeTraversalControl
   normal_continuation
 };
 
+namespace Experimental
+{
+// Tag of the callbacks invoked by a whole team with the values found for a
+// predicate in batches, as callback(team, predicate, values), where values(i)
+// is the i-th value of the batch for i < values.size()
+struct TeamCallbackTag
+{};
+} // namespace Experimental
+
 namespace Details
 {
 
@@ -70,6 +80,12 @@ struct is_tagged_post_callback
                    PostCallbackTag>::type
 {};
 
+template <typename Callback>
+struct is_tagged_team_callback
+    : std::is_same<Kokkos::detected_t<CallbackTagArchetypeAlias, Callback>,
+                   Experimental::TeamCallbackTag>::type
+{};
+
 // output functor to pass to the callback during detection
 template <typename T>
 struct Sink
@@ -208,6 +224,49 @@ void check_valid_callback(Callback const &callback, Predicates const &)
       "Callback 'operator()' return type must be void");
 }
 
+template <typename Callback, typename Predicates>
+void check_valid_team_callback(Callback const &callback, Predicates const &)
+{
+  check_generic_lambda_support(callback);
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using PredicateTag = typename AccessTraitsHelper<Access>::tag;
+
+  static_assert(std::is_same<PredicateTag, SpatialPredicateTag>{},
+                "Team callbacks are only supported for spatial predicates");
+}
+
+// Counts the values found for the predicates, whose indices are attached to
+// them, and exits the traversal of a predicate once n have been found
+template <typename MemorySpace>
+struct CountUpToN
+{
+  Kokkos::View<int *, MemorySpace> _counts;
+  int _n;
+
+  template <typename Query, typename Value>
+  KOKKOS_FUNCTION auto operator()(Query const &query, Value const &) const
+  {
+    auto i = getData(query);
+    Kokkos::atomic_increment(&_counts(i));
+
+    if (_counts(i) < _n)
+      return ArborX::CallbackTreeTraversalControl::normal_continuation;
+
+    // Once count reaches threshold, terminate the traversal.
+    return ArborX::CallbackTreeTraversalControl::early_exit;
+  }
+};
+
+// archetypal alias for legacy trees whose callbacks are passed indices
+template <typename Tree>
+using LegacyTreeArchetypeExpression = typename Tree::legacy_tree;
+
+// archetypal alias for the callbacks that legacy trees pass the values to,
+// rather than their indices
+template <typename Callback>
+using LegacyValuesCallbackArchetypeAlias = typename Callback::legacy_values;
+
 template <typename Callback, typename Value>
 struct LegacyCallbackWrapper
 {
@@ -217,11 +276,151 @@ struct LegacyCallbackWrapper
   KOKKOS_FUNCTION auto operator()(Predicate const &predicate,
                                   Value const &value) const
   {
-    return _callback(predicate, value.index);
+    if constexpr (Kokkos::is_detected_v<LegacyValuesCallbackArchetypeAlias,
+                                        Callback>)
+      return _callback(predicate, value);
+    else
+      return _callback(predicate, value.index);
+  }
+
+  template <typename Predicate, typename Traverse>
+  KOKKOS_FUNCTION void scope(Predicate const &predicate,
+                             Traverse const &traverse) const
+  {
+    _callback.scope(predicate, [&](auto const &callback) {
+      traverse(LegacyCallbackWrapper<std::decay_t<decltype(callback)>, Value>{
+          callback});
+    });
+  }
+};
+
+// archetypal alias for the callbacks holding some state for the whole
+// traversal of a predicate. They are given the chance to set it up as
+// callback.scope(predicate, traverse), in which they call traverse(scoped)
+// with the callback to invoke on the values found for the predicate.
+template <typename Callback>
+using ScopedCallbackArchetypeAlias = typename Callback::scoped_callback;
+
+template <typename Callback>
+struct is_scoped_callback
+    : Kokkos::is_detected<ScopedCallbackArchetypeAlias, Callback>::type
+{};
+
+template <typename Callback, typename Value>
+struct is_scoped_callback<LegacyCallbackWrapper<Callback, Value>>
+    : is_scoped_callback<Callback>::type
+{};
+
+// Batch of values given to the team callbacks of legacy trees as indices
+template <typename Values>
+struct LegacyTeamValues
+{
+  Values _values;
+
+  KOKKOS_FUNCTION auto size() const { return _values.size(); }
+
+  KOKKOS_FUNCTION int operator()(int i) const { return _values(i).index; }
+};
+
+template <typename Callback>
+struct LegacyTeamCallbackWrapper
+{
+  using tag = Experimental::TeamCallbackTag;
+
+  Callback _callback;
+
+  template <typename TeamMember, typename Predicate, typename Values>
+  KOKKOS_FUNCTION void operator()(TeamMember const &team,
+                                  Predicate const &predicate,
+                                  Values const &values) const
+  {
+    _callback(team, predicate, LegacyTeamValues<Values>{values});
   }
 };
 
 } // namespace Details
+
+namespace Experimental
+{
+
+// Callback of the queries with storage that outputs, for each value found, its
+// index and its distance to the predicate as a Kokkos::pair<int, float>. The
+// distance is computed from the indexable that the traversal has just tested,
+// rather than gathered again once the indices are known. Spatial predicates
+// measure it from the centroid of their geometry, e.g. the center of the
+// sphere of a radius search. With sorting, the results of each predicate are
+// ordered by increasing distance, and by index between equidistant values.
+struct WithDistances
+{
+  bool _sort_by_distance = false;
+};
+
+// Output of a callback staged in a small buffer local to the thread, so that
+// the values are handed to global memory in bulk, e.g. with a single atomic
+// reservation, rather than one at a time. The flush is called as
+// flush(values, n) when the buffer is full and on destruction. The buffer is
+// only worth it if it outlives many insertions, e.g. when set up for the
+// whole traversal of a predicate by a scoped callback.
+template <typename Value, int N, typename Flush>
+class StagingBuffer
+{
+  static_assert(N > 0);
+
+public:
+  KOKKOS_FUNCTION explicit StagingBuffer(Flush const &flush)
+      : _flush(flush)
+  {}
+
+  StagingBuffer(StagingBuffer const &) = delete;
+  StagingBuffer &operator=(StagingBuffer const &) = delete;
+
+  KOKKOS_FUNCTION ~StagingBuffer() { flush(); }
+
+  // Const so that it behaves as the output functors given to callbacks
+  KOKKOS_FUNCTION void operator()(Value const &value) const
+  {
+    if (_size == N)
+      flush();
+    _values[_size++] = value;
+  }
+
+  KOKKOS_FUNCTION void flush() const
+  {
+    if (_size > 0)
+      _flush(static_cast<Value const *>(_values), _size);
+    _size = 0;
+  }
+
+private:
+  Flush _flush;
+  mutable Value _values[N];
+  mutable int _size = 0;
+};
+
+// Flush appending the staged values to a view, the number of values appended
+// so far by all the threads being kept in a counter. The values past the end
+// of the view are counted but not written.
+template <typename OutputView, typename CounterView>
+struct AppendToView
+{
+  static_assert(Kokkos::is_view<OutputView>{} && OutputView::rank == 1);
+  static_assert(Kokkos::is_view<CounterView>{} && CounterView::rank == 0);
+
+  OutputView _out;
+  CounterView _counter;
+
+  KOKKOS_FUNCTION void
+  operator()(typename OutputView::value_type const *values, int n) const
+  {
+    int const first = Kokkos::atomic_fetch_add(&_counter(), n);
+    int const last = first + n;
+    int const size = _out.extent_int(0);
+    for (int i = first; i < last && i < size; ++i)
+      _out(i) = values[i - first];
+  }
+};
+
+} // namespace Experimental
 } // namespace ArborX
 
 #endif
@@ -0,0 +1,237 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_CO_PROCESSED_QUERY_HPP
+#define ARBORX_CO_PROCESSED_QUERY_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp> // DefaultCallback
+#include <ArborX_CrsGraphWrapper.hpp> // query
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp> // lastElement
+#include <ArborX_DetailsTwoPassCallbacks.hpp>
+#include <ArborX_DetailsUtils.hpp> // exclusivePrefixSum
+#include <ArborX_Exception.hpp>
+#include <ArborX_Predicates.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_Timer.hpp>
+
+#include <algorithm> // clamp
+#include <cmath>     // lround
+#include <type_traits>
+#include <utility>
+
+namespace ArborX::Experimental
+{
+
+/** Query a batch of predicates with the device and the host at once. The
+ * last \c host_fraction of the predicates are searched on the host, in
+ * host_tree, a copy of tree in host memory (see copyTree()), while the others
+ * are searched on the device. The results are merged into values and offset
+ * in compressed row storage format, as returned by query(), with the callback
+ * called as callback(predicate, index, out) on both sides. Spatial and
+ * nearest predicates are supported, for trees passing the indices of the
+ * values to their callbacks, e.g. BVH.
+ *
+ * The device searches in two passes, to count and then to store the results,
+ * and the host searches half of its share during each of them. Returns the
+ * host fraction that would have made both sides finish together, given the
+ * throughputs measured on this batch, to be passed for the next one. The time
+ * taken by the device is only known when it finishes last; otherwise the
+ * host share is reduced by a tenth.
+ *
+ * \code
+ * auto host_tree = ArborX::Experimental::copyTree<
+ *     ArborX::BVH<Kokkos::HostSpace>>(space, tree);
+ * float host_fraction = 0.1f;
+ * for (auto const &predicates : batches)
+ *   host_fraction = ArborX::Experimental::queryCoProcessed(
+ *       space, tree, host_tree, predicates, indices, offset, host_fraction);
+ * \endcode
+ */
+template <typename ExecutionSpace, typename Tree, typename HostTree,
+          typename Predicates, typename Callback, typename Values,
+          typename Offset>
+std::enable_if_t<!Kokkos::is_view_v<Callback> && Kokkos::is_view_v<Values> &&
+                     Kokkos::is_view_v<Offset>,
+                 float>
+queryCoProcessed(ExecutionSpace const &space, Tree const &tree,
+                 HostTree const &host_tree, Predicates const &predicates,
+                 Callback const &callback, Values &values, Offset &offset,
+                 float host_fraction)
+{
+  using MemorySpace = typename Tree::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  using HostExecutionSpace = Kokkos::DefaultHostExecutionSpace;
+  static_assert(KokkosExt::is_accessible_from<typename HostTree::memory_space,
+                                              HostExecutionSpace>::value,
+                "The host tree must be accessible from the host");
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+
+  ARBORX_ASSERT(host_fraction >= 0 && host_fraction <= 1);
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::Experimental::queryCoProcessed");
+
+  using Value = typename Values::value_type;
+  using Predicate = std::decay_t<decltype(Access::get(
+      std::declval<Predicates const &>(), 0))>;
+  using DevicePredicate =
+      decltype(attach(std::declval<Predicate const &>(), 0));
+
+  int const n = Access::size(predicates);
+  int const n_host = std::lround(host_fraction * n);
+  int const n_device = n - n_host;
+
+  // Split the predicates, the host getting the last ones
+  Kokkos::View<DevicePredicate *, MemorySpace> device_predicates(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::queryCoProcessed::device_predicates"),
+      n_device);
+  Kokkos::View<Predicate *, MemorySpace> host_share(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::queryCoProcessed::host_share"),
+      n_host);
+  Kokkos::parallel_for(
+      "ArborX::queryCoProcessed::split_predicates",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int q) {
+        if (q < n_device)
+          device_predicates(q) = attach(Access::get(predicates, q), q);
+        else
+          host_share(q - n_device) = Access::get(predicates, q);
+      });
+  auto const host_predicates =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, host_share);
+
+  // Each half of the host share is searched while the device runs a pass
+  HostExecutionSpace host_space;
+  Kokkos::View<Value *, Kokkos::HostSpace> host_values[2];
+  Kokkos::View<int *, Kokkos::HostSpace> host_offsets[2];
+  double host_time = 0;
+  auto const search_on_host = [&](int half) {
+    Kokkos::Timer timer;
+    auto const range =
+        Kokkos::make_pair(half * (n_host / 2), half ? n_host : n_host / 2);
+    host_values[half] = Kokkos::View<Value *, Kokkos::HostSpace>(
+        "ArborX::queryCoProcessed::host_values", 0);
+    host_offsets[half] = Kokkos::View<int *, Kokkos::HostSpace>(
+        "ArborX::queryCoProcessed::host_offsets", 0);
+    ArborX::query(host_tree, host_space,
+                  Kokkos::subview(host_predicates, range), callback,
+                  host_values[half], host_offsets[half]);
+    host_time += timer.seconds();
+  };
+
+  Kokkos::Timer timer;
+
+  Kokkos::View<int *, MemorySpace> device_offset(
+      Kokkos::view_alloc(space, "ArborX::queryCoProcessed::device_offset"),
+      n_device + 1);
+  tree.query(space, device_predicates,
+             Details::TwoPassCountCallback<Callback, Details::IdentityIndices,
+                                           decltype(device_offset)>{
+                 callback, {}, device_offset});
+  search_on_host(0);
+
+  exclusivePrefixSum(space, device_offset);
+  int const n_device_values = KokkosExt::lastElement(space, device_offset);
+  Kokkos::View<Value *, MemorySpace> device_values(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::queryCoProcessed::device_values"),
+      n_device_values);
+  Kokkos::View<int *, MemorySpace> cursors(
+      Kokkos::view_alloc(space, "ArborX::queryCoProcessed::cursors"),
+      n_device);
+  tree.query(space, device_predicates,
+             Details::TwoPassFillCallback<
+                 Callback, Details::IdentityIndices, decltype(device_offset),
+                 decltype(cursors), decltype(device_values)>{
+                 callback, {}, device_offset, cursors, device_values});
+  search_on_host(1);
+
+  double const host_done = timer.seconds();
+  space.fence("ArborX::queryCoProcessed (wait for the device)");
+  double const device_time = timer.seconds();
+
+  // Merge the results, those of the host coming last
+  Kokkos::Profiling::pushRegion("ArborX::queryCoProcessed::merge");
+
+  int const n_values = n_device_values + host_values[0].size() +
+                       host_values[1].size();
+  KokkosExt::reallocWithoutInitializing(space, values, n_values);
+  KokkosExt::reallocWithoutInitializing(space, offset, n + 1);
+  Kokkos::deep_copy(
+      space, Kokkos::subview(values, Kokkos::make_pair(0, n_device_values)),
+      device_values);
+  Kokkos::deep_copy(
+      space, Kokkos::subview(offset, Kokkos::make_pair(0, n_device + 1)),
+      device_offset);
+  int shift = n_device_values;
+  int first = n_device;
+  for (int half = 0; half < 2; ++half)
+  {
+    int const m = host_offsets[half].size() - 1;
+    if (m <= 0)
+      continue;
+    auto const half_values = Kokkos::create_mirror_view_and_copy(
+        MemorySpace{}, host_values[half]);
+    auto const half_offset = Kokkos::create_mirror_view_and_copy(
+        MemorySpace{}, host_offsets[half]);
+    int const n_half = half_values.size();
+    Kokkos::deep_copy(
+        space,
+        Kokkos::subview(values, Kokkos::make_pair(shift, shift + n_half)),
+        half_values);
+    Kokkos::parallel_for(
+        "ArborX::queryCoProcessed::shift_host_offsets",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 1, m + 1),
+        KOKKOS_LAMBDA(int i) {
+          offset(first + i) = shift + half_offset(i);
+        });
+    space.fence("ArborX::queryCoProcessed (merge of the host results)");
+    shift += n_half;
+    first += m;
+  }
+
+  Kokkos::Profiling::popRegion();
+
+  // Balance the throughputs for the next batch
+  if (n_host == 0 || n_device == 0 || host_time <= 0)
+    return host_fraction;
+  if (device_time - host_done <= 0.01 * device_time)
+    return 0.9f * host_fraction;
+  double const host_rate = n_host / host_time;
+  double const device_rate = n_device / device_time;
+  return std::clamp((float)(host_rate / (host_rate + device_rate)), 0.f, 1.f);
+}
+
+template <typename ExecutionSpace, typename Tree, typename HostTree,
+          typename Predicates, typename Values, typename Offset>
+std::enable_if_t<Kokkos::is_view_v<Values> && Kokkos::is_view_v<Offset>, float>
+queryCoProcessed(ExecutionSpace const &space, Tree const &tree,
+                 HostTree const &host_tree, Predicates const &predicates,
+                 Values &values, Offset &offset, float host_fraction)
+{
+  return queryCoProcessed(space, tree, host_tree, predicates,
+                          Details::DefaultCallback{}, values, offset,
+                          host_fraction);
+}
+
+} // namespace ArborX::Experimental
+
+#endif
@@ -0,0 +1,203 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_CONSTRUCTION_POLICY_HPP
+#define ARBORX_CONSTRUCTION_POLICY_HPP
+
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_Workspace.hpp>
+
+#include <optional>
+#include <vector>
+
+namespace ArborX
+{
+namespace Experimental
+{
+struct ConstructionPolicy
+{
+  enum class Hierarchy
+  {
+    // Linear BVH (Karras/Apetrei), the hierarchy is implied by the ordering
+    // of the primitives along the space-filling curve. Fastest to build.
+    Linear,
+    // Parallel locally-ordered clustering (Meister and Bittner) on top of the
+    // space-filling curve ordering. Slower to build but the resulting
+    // hierarchy has tighter bounding volumes and queries visit fewer nodes.
+    PLOC
+  };
+
+  Hierarchy _hierarchy = Hierarchy::Linear;
+
+  // Number of neighbors along the space-filling curve on each side that a
+  // cluster considers for merging in PLOC. Larger values improve the quality
+  // of the hierarchy at the expense of construction time.
+  int _search_radius = 16;
+
+  // Number of primitives copied at once to the memory space of the hierarchy
+  // when they are streamed from the host. Primitives that are not accessible
+  // from the execution space are always streamed (by chunks of 2^20 if not
+  // set). A positive value also forces primitives accessible from both the
+  // host and the execution space to be streamed. Only the copy of the
+  // primitives is bounded: the space-filling curve codes, the permutation and
+  // the nodes of the whole hierarchy still reside in its memory space at
+  // once, so the tree cannot be larger than that memory.
+  int _primitives_chunk_size = 0;
+
+  // Whether to refine the ordering of the primitives that share the same code
+  // along the space-filling curve using their own bounding box. This keeps
+  // the hierarchy spatially coherent on heavily clustered data at the expense
+  // of an additional sort. Primitives that are streamed are not refined.
+  bool _refine_duplicate_codes = false;
+
+  // Whether the primitives are already sorted along the space-filling curve,
+  // e.g. permuted by the caller with computeSpaceFillingCurvePermutation().
+  // The leaves then keep the order of the primitives, so that the values
+  // visited by neighboring leaves are neighbors in the data of the caller.
+  bool _primitives_sorted = false;
+
+  // Whether the primitives are nearly sorted along the space-filling curve,
+  // e.g. kept by the caller in the order of the previous construction, from
+  // computeSpaceFillingCurvePermutation() or the leaves of the hierarchy, as
+  // they move between time steps. The codes are then sorted by blocks first,
+  // and fully only if the blocks are still out of order.
+  bool _primitives_nearly_sorted = false;
+
+  // Bounds of the scene onto which the primitives are projected along the
+  // space-filling curve, as the minimum corner followed by the maximum corner.
+  // When the caller knows them already, the primitives are read once before
+  // the hierarchy is generated instead of twice. They need not be tight, and
+  // primitives outside of them are clamped to their boundary, which only
+  // degrades the quality of the hierarchy. Ignored for quantized internal
+  // nodes, whose grid must span the exact bounds of the scene.
+  std::vector<double> _scene_bounds;
+
+  // Number of primitives, evenly spaced in the input, over which the bounds
+  // of the scene are estimated when they are not given. Zero or negative
+  // means all the primitives. A sample of a few thousand primitives is
+  // usually enough for the space-filling curve and reads a negligible part
+  // of the input.
+  int _scene_bounds_sample_size = 0;
+
+  // Whether to store the internal nodes in depth-first order once the
+  // hierarchy is generated, so that the nodes along a root-to-leaf path, and
+  // those visited in sequence along the ropes, are close in memory. This
+  // helps the caches of CPUs on large hierarchies at the expense of an
+  // additional pass and a copy of the internal nodes during construction.
+  bool _depth_first_layout = false;
+
+  // Number of consecutive primitives along the space-filling curve held by
+  // each leaf of Experimental::BucketedBoundingVolumeHierarchy, at most 16.
+  // Larger buckets shrink the hierarchy but more primitives are checked
+  // individually. Not used by the other hierarchies.
+  int _bucket_size = 8;
+
+  // Whether to first touch the nodes of the hierarchy from the threads of a
+  // static schedule over their position along the space-filling curve before
+  // they are generated, on host backends. On multi-socket systems, the
+  // memory pages of the nodes are then placed on the socket of the threads
+  // that traverse them the most when the predicates are sorted along the
+  // curve, as they are by default, and split among the threads with the
+  // default static schedule. The depth-first layout places the internal
+  // nodes again, by whichever threads copy them.
+  bool _numa_first_touch = false;
+
+  // Workspace lets the temporaries of the construction (the codes of the
+  // primitives along the space-filling curve and their ordering) be taken
+  // from storage kept across constructions rather than allocated for each of
+  // them. Without it, the default workspace is used if set.
+  std::optional<Workspace> _workspace;
+
+  ConstructionPolicy &setHierarchy(Hierarchy hierarchy)
+  {
+    _hierarchy = hierarchy;
+    return *this;
+  }
+
+  ConstructionPolicy &setSearchRadius(int search_radius)
+  {
+    _search_radius = search_radius;
+    return *this;
+  }
+
+  ConstructionPolicy &setPrimitivesChunkSize(int chunk_size)
+  {
+    _primitives_chunk_size = chunk_size;
+    return *this;
+  }
+
+  ConstructionPolicy &setRefineDuplicateCodes(bool refine_duplicate_codes)
+  {
+    _refine_duplicate_codes = refine_duplicate_codes;
+    return *this;
+  }
+
+  ConstructionPolicy &setPrimitivesSorted(bool primitives_sorted)
+  {
+    _primitives_sorted = primitives_sorted;
+    return *this;
+  }
+
+  ConstructionPolicy &setPrimitivesNearlySorted(bool primitives_nearly_sorted)
+  {
+    _primitives_nearly_sorted = primitives_nearly_sorted;
+    return *this;
+  }
+
+  template <typename Box>
+  ConstructionPolicy &setSceneBounds(Box const &scene_bounds)
+  {
+    static_assert(GeometryTraits::is_box<Box>{});
+    constexpr int DIM = GeometryTraits::dimension_v<Box>;
+    _scene_bounds.resize(2 * DIM);
+    for (int d = 0; d < DIM; ++d)
+    {
+      _scene_bounds[d] = scene_bounds.minCorner()[d];
+      _scene_bounds[DIM + d] = scene_bounds.maxCorner()[d];
+    }
+    return *this;
+  }
+
+  ConstructionPolicy &setSceneBoundsSampleSize(int sample_size)
+  {
+    _scene_bounds_sample_size = sample_size;
+    return *this;
+  }
+
+  ConstructionPolicy &setDepthFirstLayout(bool depth_first_layout)
+  {
+    _depth_first_layout = depth_first_layout;
+    return *this;
+  }
+
+  ConstructionPolicy &setBucketSize(int bucket_size)
+  {
+    _bucket_size = bucket_size;
+    return *this;
+  }
+
+  ConstructionPolicy &setNumaFirstTouch(bool numa_first_touch)
+  {
+    _numa_first_touch = numa_first_touch;
+    return *this;
+  }
+
+  ConstructionPolicy &setWorkspace(Workspace const &workspace)
+  {
+    _workspace = workspace;
+    return *this;
+  }
+};
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
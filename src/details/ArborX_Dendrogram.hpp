@@ -12,18 +12,28 @@
 #define ARBORX_DENDROGRAM_HPP
 
 #include <ArborX_DetailsDendrogram.hpp>
+#include <ArborX_DetailsKokkosExtBitManipulation.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
 #include <ArborX_DetailsKokkosExtSort.hpp>
+#include <ArborX_DetailsUnionFind.hpp>
+#include <ArborX_DetailsUtils.hpp> // iota
 #include <ArborX_DetailsWeightedEdge.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
 namespace ArborX::Experimental
 {
 
 enum class DendrogramImplementation
 {
   BORUVKA,
-  UNION_FIND
+  UNION_FIND,
+  PARALLEL_UNION_FIND
 };
 
 template <typename MemorySpace>
@@ -43,7 +53,9 @@ struct Dendrogram
 
   template <typename ExecutionSpace>
   Dendrogram(ExecutionSpace const &exec_space,
-             Kokkos::View<Details::WeightedEdge *, MemorySpace> edges)
+             Kokkos::View<Details::WeightedEdge *, MemorySpace> edges,
+             DendrogramImplementation dendrogram_impl =
+                 DendrogramImplementation::UNION_FIND)
       : _parents("ArborX::Dendrogram::parents", 0)
       , _parent_heights("ArborX::Dendrogram::parent_heights", 0)
   {
@@ -61,37 +73,223 @@ struct Dendrogram
         Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
                            "ArborX::Dendrogram::unweighted_edges"),
         num_edges);
-    splitEdges(exec_space, edges, unweighted_edges, _parent_heights);
-
-    Kokkos::Profiling::pushRegion("ArborX::Dendrogram::sort_edges");
-    KokkosExt::sortByKey(exec_space, _parent_heights, unweighted_edges);
-    Kokkos::Profiling::popRegion();
+    sortEdges(exec_space, edges, unweighted_edges, _parent_heights);
 
     using ConstEdges =
         Kokkos::View<Details::UnweightedEdge const *, MemorySpace>;
-    Details::dendrogramUnionFind(exec_space, ConstEdges(unweighted_edges),
-                                 _parents);
+    if (dendrogram_impl == DendrogramImplementation::PARALLEL_UNION_FIND)
+      Details::dendrogramParallelUnionFind(
+          exec_space, ConstEdges(unweighted_edges), _parents);
+    else
+      Details::dendrogramUnionFind(exec_space, ConstEdges(unweighted_edges),
+                                   _parents);
 
     Kokkos::Profiling::popRegion();
   }
 
+  // Sort the edges by weight, ties being broken by edge index, in a single
+  // sort of 64-bit keys. The upper half of a key holds the bits of the weight
+  // in an order that matches the order of floats, and the lower half holds
+  // the index of the edge.
   template <typename ExecutionSpace>
-  void splitEdges(
+  void sortEdges(
       ExecutionSpace const &exec_space,
       Kokkos::View<Details::WeightedEdge *, MemorySpace> edges,
-      Kokkos::View<Details::UnweightedEdge *, MemorySpace> unweighted_edges,
-      Kokkos::View<float *, MemorySpace> weights)
+      Kokkos::View<Details::UnweightedEdge *, MemorySpace> sorted_edges,
+      Kokkos::View<float *, MemorySpace> sorted_weights)
   {
+    KokkosExt::ScopedProfileRegion guard("ArborX::Dendrogram::sort_edges");
+
+    static_assert(sizeof(float) == sizeof(std::uint32_t));
+    constexpr int shift = 32;
+
+    auto const num_edges = edges.size();
+    Kokkos::View<std::uint64_t *, MemorySpace> keys(
+        Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                           "ArborX::Dendrogram::sort_edges::keys"),
+        num_edges);
     Kokkos::parallel_for(
-        "ArborX::Dendrogram::copy_weights_and_edges",
-        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, edges.size()),
+        "ArborX::Dendrogram::pack_edge_keys",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
         KOKKOS_LAMBDA(int const e) {
-          weights(e) = edges(e).weight;
-          unweighted_edges(e) = {edges(e).source, edges(e).target};
+          auto bits = KokkosExt::bit_cast<std::uint32_t>(edges(e).weight);
+          // Flip all bits of negative numbers, and only the sign bit of
+          // positive ones
+          bits ^= (bits & 0x80000000u) ? 0xffffffffu : 0x80000000u;
+          keys(e) = ((std::uint64_t)bits << shift) + (std::uint32_t)e;
+        });
+
+    KokkosExt::sort(exec_space, keys);
+
+    Kokkos::parallel_for(
+        "ArborX::Dendrogram::unpack_edge_keys",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+        KOKKOS_LAMBDA(int const i) {
+          auto const key = keys(i);
+          auto const &edge = edges((std::uint32_t)key);
+          auto bits = (std::uint32_t)(key >> shift);
+          bits ^= (bits & 0x80000000u) ? 0x80000000u : 0xffffffffu;
+          sorted_weights(i) = KokkosExt::bit_cast<float>(bits);
+          sorted_edges(i) = {edge.source, edge.target};
         });
   }
 };
 
+// Flat single-linkage clusters at a distance cutoff, computed directly from
+// the edges of a spanning tree over num_edges + 1 vertices (typically
+// MinimumSpanningTree::edges). The vertices joined by edges no longer than
+// the cutoff are merged in parallel, without sorting the edges nor building
+// the dendrogram. Each cluster is labeled with its smallest vertex index.
+template <typename ExecutionSpace, typename Edges>
+Kokkos::View<int *, typename Edges::memory_space>
+singleLinkageClusters(ExecutionSpace const &exec_space, Edges const &edges,
+                      float cutoff)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::SingleLinkage");
+
+  using MemorySpace = typename Edges::memory_space;
+
+  int const num_edges = edges.size();
+  int const num_vertices = num_edges + 1;
+
+  Kokkos::View<int *, MemorySpace> labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::SingleLinkage::labels"),
+      num_vertices);
+  Details::iota(exec_space, labels);
+  Details::UnionFind<MemorySpace> union_find(labels);
+
+  Kokkos::parallel_for(
+      "ArborX::SingleLinkage::merge",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+      KOKKOS_LAMBDA(int e) {
+        auto const &edge = edges(e);
+        if (edge.weight <= cutoff)
+          union_find.merge(edge.source, edge.target);
+      });
+  Kokkos::parallel_for(
+      "ArborX::SingleLinkage::finalize_labels",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_vertices),
+      KOKKOS_LAMBDA(int i) { labels(i) = union_find.representative(i); });
+
+  return labels;
+}
+
+// Flat single-linkage clusters of the vertices of a dendrogram at several
+// distance cutoffs, in a single sweep over its edges by increasing height.
+// The edges between two consecutive cutoffs are merged in parallel on top of
+// the lower ones, and the labels at a cutoff are read once its edges have
+// been merged. Column j of the result holds the labels at cutoffs[j], each
+// cluster being labeled with its smallest vertex index.
+template <typename ExecutionSpace, typename MemorySpace>
+Kokkos::View<int **, Kokkos::LayoutLeft, MemorySpace>
+singleLinkageClusters(ExecutionSpace const &exec_space,
+                      Dendrogram<MemorySpace> const &dendrogram,
+                      std::vector<float> const &cutoffs)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::SingleLinkage::multiple");
+
+  int const num_edges = dendrogram._parent_heights.size();
+  int const num_vertices = num_edges + 1;
+  int const num_cutoffs = cutoffs.size();
+
+  Kokkos::View<int **, Kokkos::LayoutLeft, MemorySpace> labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::SingleLinkage::labels"),
+      num_vertices, num_cutoffs);
+  if (num_cutoffs == 0)
+    return labels;
+
+  // Cutoffs in increasing order, and the number of edges below each of them
+  std::vector<int> order(num_cutoffs);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](int i, int j) { return cutoffs[i] < cutoffs[j]; });
+  Kokkos::View<float *, MemorySpace> sorted_cutoffs(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::SingleLinkage::sorted_cutoffs"),
+      num_cutoffs);
+  auto sorted_cutoffs_host = Kokkos::create_mirror_view(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing), sorted_cutoffs);
+  for (int j = 0; j < num_cutoffs; ++j)
+    sorted_cutoffs_host(j) = cutoffs[order[j]];
+  Kokkos::deep_copy(exec_space, sorted_cutoffs, sorted_cutoffs_host);
+  Kokkos::View<int *, MemorySpace> ends(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::SingleLinkage::ends"),
+      num_cutoffs);
+  auto const &heights = dendrogram._parent_heights;
+  Kokkos::parallel_for(
+      "ArborX::SingleLinkage::find_ends",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_cutoffs),
+      KOKKOS_LAMBDA(int j) {
+        int first = 0;
+        int last = num_edges;
+        while (first < last)
+        {
+          int const middle = (first + last) / 2;
+          if (heights(middle) <= sorted_cutoffs(j))
+            first = middle + 1;
+          else
+            last = middle;
+        }
+        ends(j) = first;
+      });
+  auto const ends_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, ends);
+
+  // The two children of each edge, numbering the vertices before the edges
+  // so that the smallest index of each set is a vertex
+  Kokkos::View<int *, MemorySpace> num_children(
+      "ArborX::SingleLinkage::num_children", num_edges);
+  Kokkos::View<int *, MemorySpace> children(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::SingleLinkage::children"),
+      2 * num_edges);
+  auto const &parents = dendrogram._parents;
+  Kokkos::parallel_for(
+      "ArborX::SingleLinkage::find_children",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0,
+                                          num_edges + num_vertices),
+      KOKKOS_LAMBDA(int i) {
+        int const parent = parents(i);
+        if (parent < 0)
+          return;
+        int const child = (i < num_edges ? num_vertices + i : i - num_edges);
+        children(2 * parent +
+                 Kokkos::atomic_fetch_add(&num_children(parent), 1)) = child;
+      });
+
+  Kokkos::View<int *, MemorySpace> sets(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::SingleLinkage::sets"),
+      num_vertices + num_edges);
+  Details::iota(exec_space, sets);
+  Details::UnionFind<MemorySpace> union_find(sets);
+
+  int begin = 0;
+  for (int k = 0; k < num_cutoffs; ++k)
+  {
+    int const end = ends_host(k);
+    Kokkos::parallel_for(
+        "ArborX::SingleLinkage::merge",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, begin, end),
+        KOKKOS_LAMBDA(int e) {
+          union_find.merge(children(2 * e), num_vertices + e);
+          union_find.merge(children(2 * e + 1), num_vertices + e);
+        });
+    begin = end;
+
+    int const j = order[k];
+    Kokkos::parallel_for(
+        "ArborX::SingleLinkage::finalize_labels",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_vertices),
+        KOKKOS_LAMBDA(int i) { labels(i, j) = union_find.representative(i); });
+  }
+
+  return labels;
+}
+
 } // namespace ArborX::Experimental
 
 #endif
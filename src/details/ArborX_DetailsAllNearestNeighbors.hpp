@@ -0,0 +1,145 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_ALL_NEAREST_NEIGHBORS_HPP
+#define ARBORX_DETAILS_ALL_NEAREST_NEIGHBORS_HPP
+
+#include <ArborX_DetailsAlgorithms.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsHeap.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsNode.hpp> // ROPE_SENTINEL
+#include <ArborX_DetailsOperatorFunctionObjects.hpp> // Less
+
+#include <Kokkos_Core.hpp>
+
+namespace ArborX::Details
+{
+
+// Compute for each value of the hierarchy the distance to its k-th nearest
+// neighbor among the values of the hierarchy, itself included. The queries
+// are the leaves, so the k leaves surrounding each leaf along the
+// space-filling curve give an upper bound on that distance before the
+// traversal even starts, which prunes most of the hierarchy. The distances
+// are stored at the index of the values, or at the index of the leaves if
+// requested (e.g., for the mutual reachability distances in the Boruvka
+// iterations, which are indexed by leaves). If the distances are a rank-2 view,
+// the distances to all the nearest neighbors are stored in increasing order
+// instead, the j-th column holding the distance to the (j+1)-th neighbor.
+template <class BVH, class Distances>
+struct KthNearestNeighborDistances
+{
+  using MemorySpace = typename BVH::memory_space;
+
+  BVH _bvh;
+  int _k;
+  Distances _distances;
+  bool _in_leaf_order;
+  Kokkos::View<float *, MemorySpace> _buffer;
+
+  template <class ExecutionSpace>
+  KthNearestNeighborDistances(ExecutionSpace const &space, BVH const &bvh,
+                              int k, Distances const &distances,
+                              bool in_leaf_order = false)
+      : _bvh{bvh}
+      , _k{KokkosExt::min(k, (int)bvh.size())}
+      , _distances{distances}
+      , _in_leaf_order{in_leaf_order}
+  {
+    int const n = _bvh.size();
+    if (n == 0)
+    {
+      // do nothing
+    }
+    else if (n == 1)
+    {
+      Kokkos::deep_copy(space, _distances, 0);
+    }
+    else
+    {
+      // Buffer over which to perform heap operations to store the distances
+      // to the nearest leaf nodes found so far
+      _buffer = Kokkos::View<float *, MemorySpace>(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                             "ArborX::KthNearestNeighborDistances::buffer"),
+          n * _k);
+      Kokkos::parallel_for(
+          "ArborX::KthNearestNeighborDistances",
+          Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), *this);
+    }
+  }
+
+  KOKKOS_FUNCTION void operator()(int i) const
+  {
+    int const n = _bvh.size();
+    auto const point = returnCentroid(HappyTreeFriends::getIndexable(_bvh, i));
+
+    // Seed the heap with the leaves closest to i along the curve
+    int const first = KokkosExt::min(KokkosExt::max(i - _k / 2, 0), n - _k);
+    int const last = first + _k;
+
+    float *heap = _buffer.data() + i * _k;
+    Less<float> compare;
+    for (int j = first; j < last; ++j)
+    {
+      heap[j - first] =
+          distance(point, HappyTreeFriends::getIndexable(_bvh, j));
+      pushHeap(heap, heap + (j - first) + 1, compare);
+    }
+    float radius = heap[0];
+
+    int node = HappyTreeFriends::getRoot(_bvh);
+    while (node != ROPE_SENTINEL)
+    {
+      if (HappyTreeFriends::isLeaf(_bvh, node))
+      {
+        float const distance_to_leaf =
+            distance(point, HappyTreeFriends::getIndexable(_bvh, node));
+        if ((node < first || node >= last) && distance_to_leaf < radius)
+        {
+          popHeap(heap, heap + _k, compare);
+          heap[_k - 1] = distance_to_leaf;
+          pushHeap(heap, heap + _k, compare);
+          radius = heap[0];
+        }
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+      else if (distance(point, HappyTreeFriends::getInternalBoundingVolume(
+                                   _bvh, node)) < radius)
+      {
+        node = HappyTreeFriends::getLeftChild(_bvh, node);
+      }
+      else
+      {
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+    }
+
+    auto const index =
+        _in_leaf_order ? i : HappyTreeFriends::getValue(_bvh, i).index;
+    if constexpr (Distances::rank == 2)
+    {
+      // Columns beyond the number of values get the largest distance
+      sortHeap(heap, heap + _k, compare);
+      int const num_columns = _distances.extent_int(1);
+      for (int j = 0; j < num_columns; ++j)
+        _distances(index, j) = heap[KokkosExt::min(j, _k - 1)];
+    }
+    else
+    {
+      _distances(index) = radius;
+    }
+  }
+};
+
+} // namespace ArborX::Details
+
+#endif
@@ -15,18 +15,52 @@
 #include <ArborX_AccessTraits.hpp>
 #include <ArborX_Box.hpp>
 #include <ArborX_DetailsAlgorithms.hpp> // returnCentroid, translateAndScale
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
 #include <ArborX_DetailsKokkosExtViewHelpers.hpp>
-#include <ArborX_DetailsSortUtils.hpp> // sortObjects
-#include <ArborX_DetailsUtils.hpp>     // exclusivePrefixSum, lastElement
+#include <ArborX_DetailsMortonCode.hpp> // morton64
+#include <ArborX_DetailsSortUtils.hpp>  // sortObjects
+#include <ArborX_DetailsUtils.hpp>      // exclusivePrefixSum, lastElement
 #include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_Ray.hpp>
 #include <ArborX_SpaceFillingCurves.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+#include <ArborX_Workspace.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <optional>
+#include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility> // declval
 
 namespace ArborX::Details
 {
+
+// Projection of rays onto the Morton curve in 6D of their origin, in the
+// scene, and of their direction. Rays sharing an origin but going in
+// different directions, e.g. secondary rays, would otherwise be ordered next
+// to each other while traversing different parts of the hierarchy.
+struct RayMorton64
+{
+  template <typename Box>
+  KOKKOS_FUNCTION auto operator()(Box const &scene_bounding_box,
+                                  Experimental::Ray const &ray) const
+  {
+    auto origin = ray.origin();
+    translateAndScale(origin, origin, scene_bounding_box);
+    auto const &direction = ray.direction();
+    ExperimentalHyperGeometry::Point<6> p;
+    for (int d = 0; d < 3; ++d)
+    {
+      p[d] = origin[d];
+      p[3 + d] = (direction[d] + 1) / 2; // the direction is normalized
+    }
+    return morton64(p);
+  }
+};
+
 template <typename DeviceType>
 struct BatchedQueries
 {
@@ -45,38 +79,164 @@ public:
   // indirection when recording results rather than using that function at
   // the end.  We decided to keep reversePermutation around for now.
 
+  // The codes along the curve are temporaries, and so is the permutation if
+  // a workspace is given (possibly empty, for the default one), see
+  // temporaryView()
   template <typename ExecutionSpace, typename Predicates, typename Box,
             typename SpaceFillingCurve>
   static Kokkos::View<unsigned int *, DeviceType>
-  sortPredicatesAlongSpaceFillingCurve(ExecutionSpace const &space,
-                                       SpaceFillingCurve const &curve,
-                                       Box const &scene_bounding_box,
-                                       Predicates const &predicates)
+  sortPredicatesAlongSpaceFillingCurve(
+      ExecutionSpace const &space, SpaceFillingCurve const &curve,
+      Box const &scene_bounding_box, Predicates const &predicates,
+      std::optional<Experimental::Workspace> const *workspace = nullptr)
   {
     using Access = AccessTraits<Predicates, PredicatesTag>;
     auto const n_queries = Access::size(predicates);
 
-    using Point = std::decay_t<decltype(returnCentroid(
-        getGeometry(Access::get(predicates, 0))))>;
+    using Geometry =
+        std::decay_t<decltype(getGeometry(Access::get(predicates, 0)))>;
     using LinearOrderingValueType =
         Kokkos::detected_t<SpaceFillingCurveProjectionArchetypeExpression,
-                           SpaceFillingCurve, Box, Point>;
-    Kokkos::View<LinearOrderingValueType *, DeviceType> linear_ordering_indices(
-        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
-                           "ArborX::BVH::query::linear_ordering"),
-        n_queries);
+                           SpaceFillingCurve, Box, Geometry>;
+    auto linear_ordering_indices =
+        temporaryView<Kokkos::View<LinearOrderingValueType *, DeviceType>>(
+            space, workspace ? *workspace : std::nullopt,
+            "ArborX::BVH::query::linear_ordering", n_queries);
     Kokkos::parallel_for(
         "ArborX::BatchedQueries::project_predicates_onto_space_filling_curve",
         Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
         KOKKOS_LAMBDA(int i) {
-          linear_ordering_indices(i) =
-              curve(scene_bounding_box,
-                    returnCentroid(getGeometry(Access::get(predicates, i))));
+          linear_ordering_indices(i) = curve(
+              scene_bounding_box, getGeometry(Access::get(predicates, i)));
         });
 
+    if (workspace)
+      return sortObjects(space, linear_ordering_indices, *workspace);
     return sortObjects(space, linear_ordering_indices);
   }
 
+  // Sort along the Hilbert curve if requested and available in the dimension
+  // of the scene, and along the Morton curve otherwise. Rays are sorted by
+  // their origin and direction, see RayMorton64.
+  template <typename ExecutionSpace, typename Predicates, typename Box>
+  static Kokkos::View<unsigned int *, DeviceType>
+  sortPredicates(ExecutionSpace const &space, bool hilbert,
+                 Box const &scene_bounding_box, Predicates const &predicates,
+                 std::optional<Experimental::Workspace> const *workspace =
+                     nullptr)
+  {
+    using Access = AccessTraits<Predicates, PredicatesTag>;
+    using Geometry = std::decay_t<decltype(getGeometry(
+        Access::get(std::declval<Predicates const &>(), 0)))>;
+    constexpr int DIM = GeometryTraits::dimension_v<Box>;
+    if constexpr (std::is_same_v<Geometry, Experimental::Ray>)
+      return sortPredicatesAlongSpaceFillingCurve(
+          space, RayMorton64(), scene_bounding_box, predicates, workspace);
+    else if constexpr (DIM == 2 || DIM == 3)
+    {
+      if (hilbert)
+        return sortPredicatesAlongSpaceFillingCurve(
+            space, Experimental::Hilbert32(), scene_bounding_box, predicates,
+            workspace);
+    }
+    return sortPredicatesAlongSpaceFillingCurve(
+        space, Experimental::Morton32(), scene_bounding_box, predicates,
+        workspace);
+  }
+
+  // Sort as requested by the policy, reusing the permutation it holds if any
+  // and storing the permutation computed in it otherwise. Only a permutation
+  // that is not stored is taken from the workspace.
+  template <typename ExecutionSpace, typename Predicates, typename Box>
+  static Kokkos::View<unsigned int *, DeviceType>
+  sortPredicates(ExecutionSpace const &space,
+                 Experimental::TraversalPolicy const &policy,
+                 Box const &scene_bounding_box, Predicates const &predicates)
+  {
+    auto sort = [&]() {
+      return sortPredicates(space, policy._hilbert_predicate_sorting,
+                            scene_bounding_box, predicates);
+    };
+    if (!policy._predicate_permutation)
+      return sortPredicates(space, policy._hilbert_predicate_sorting,
+                            scene_bounding_box, predicates,
+                            &policy._workspace);
+    using Access = AccessTraits<Predicates, PredicatesTag>;
+    return policy._predicate_permutation
+        ->template get<typename DeviceType::memory_space>(
+            Access::size(predicates), sort);
+  }
+
+  // Whether most of the consecutive predicates are in order along the Morton
+  // curve, estimated from a sample of pairs of them evenly spread over the
+  // batch
+  template <typename ExecutionSpace, typename Predicates, typename Box>
+  static bool arePredicatesCoherent(ExecutionSpace const &space,
+                                    Box const &scene_bounding_box,
+                                    Predicates const &predicates)
+  {
+    using Access = AccessTraits<Predicates, PredicatesTag>;
+    int const n = Access::size(predicates);
+    if (n < 2)
+      return true;
+
+    int const max_sample_size = 1024;
+    int const sample_size = KokkosExt::min(max_sample_size, n - 1);
+    int const stride = (n - 1) / sample_size;
+    int n_inversions = 0;
+    Kokkos::parallel_reduce(
+        "ArborX::BatchedQueries::count_inversions_in_sample",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, sample_size),
+        KOKKOS_LAMBDA(int i, int &update) {
+          Experimental::Morton32 const curve;
+          int const j = i * stride;
+          auto const code = curve(scene_bounding_box,
+                                  returnCentroid(getGeometry(
+                                      Access::get(predicates, j))));
+          auto const next_code = curve(scene_bounding_box,
+                                       returnCentroid(getGeometry(
+                                           Access::get(predicates, j + 1))));
+          if (next_code < code)
+            ++update;
+        },
+        n_inversions);
+
+    // Shuffled predicates are out of order half of the time
+    return n_inversions * 8 <= sample_size;
+  }
+
+  // Whether the query is to sort its predicates, as requested by the policy
+  template <typename ExecutionSpace, typename Predicates, typename Box>
+  static bool sortsPredicates(ExecutionSpace const &space,
+                              Experimental::TraversalPolicy const &policy,
+                              Box const &scene_bounding_box,
+                              Predicates const &predicates,
+                              std::string const &profiling_prefix)
+  {
+    if (!policy._sort_predicates)
+      return false;
+    if (!policy._adaptive_predicate_sorting || policy._predicate_permutation)
+      return true;
+
+    // Sorting only pays off once there are enough predicates for their
+    // order to matter
+    using Access = AccessTraits<Predicates, PredicatesTag>;
+    int const min_batch_size = 128;
+    bool sort = false;
+    if ((int)Access::size(predicates) >= min_batch_size)
+    {
+      Kokkos::Profiling::pushRegion(profiling_prefix +
+                                    "::estimate_predicates_coherence");
+      sort = !arePredicatesCoherent(space, scene_bounding_box, predicates);
+      Kokkos::Profiling::popRegion();
+    }
+    Kokkos::Profiling::pushRegion(
+        profiling_prefix + (sort ? "::adaptive_predicate_sorting::sorted"
+                                 : "::adaptive_predicate_sorting::unsorted"));
+    Kokkos::Profiling::popRegion();
+    return sort;
+  }
+
   // NOTE  trailing return type seems required :(
   // error: The enclosing parent function ("applyPermutation") for an extended
   // __host__ __device__ lambda must not have deduced return type
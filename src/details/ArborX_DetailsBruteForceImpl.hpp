@@ -14,14 +14,54 @@
 
 #include <ArborX_AccessTraits.hpp>
 #include <ArborX_DetailsAlgorithms.hpp> // expand
+#include <ArborX_DetailsHeap.hpp>
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp> // lastElement
+#include <ArborX_DetailsUtils.hpp>                // exclusivePrefixSum
 #include <ArborX_Exception.hpp>
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_Predicates.hpp>
 
 #include <Kokkos_Core.hpp>
+#include <Kokkos_DetectionIdiom.hpp>
+
+#include <type_traits>
 
 namespace ArborX
 {
 namespace Details
 {
+// Only declared, to deduce the geometry of the predicates deriving from
+// Intersects
+template <typename Geometry>
+Geometry intersectedGeometry(Intersects<Geometry> const *);
+
+template <typename Predicate>
+using IntersectedGeometryArchetypeAlias =
+    decltype(intersectedGeometry(std::declval<Predicate const *>()));
+
+// Whether the distances between the spheres of the predicates and the boxes
+// of the primitives are better filtered by blocks, as in a matrix product.
+// It only pays off in high dimensions.
+template <typename Predicate, typename Primitive>
+constexpr bool usesBlockedDistances()
+{
+  if constexpr (Kokkos::is_detected<IntersectedGeometryArchetypeAlias,
+                                    Predicate>{})
+  {
+    using Geometry = IntersectedGeometryArchetypeAlias<Predicate>;
+    if constexpr (GeometryTraits::is_sphere<Geometry>{} &&
+                  GeometryTraits::is_box<Primitive>{})
+      return GeometryTraits::dimension_v<Geometry> ==
+                 GeometryTraits::dimension_v<Primitive> &&
+             GeometryTraits::dimension_v<Primitive> >= 16;
+    else
+      return false;
+  }
+  else
+    return false;
+}
+
 struct BruteForceImpl
 {
   template <class ExecutionSpace, class Primitives, class BoundingVolumes,
@@ -50,8 +90,9 @@ struct BruteForceImpl
 
   template <class ExecutionSpace, class Primitives, class Predicates,
             class Callback>
-  static void query(ExecutionSpace const &space, Primitives const &primitives,
-                    Predicates const &predicates, Callback const &callback)
+  static void query(SpatialPredicateTag, ExecutionSpace const &space,
+                    Primitives const &primitives, Predicates const &predicates,
+                    Callback const &callback)
   {
     using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace>;
     using AccessPrimitives = AccessTraits<Primitives, PrimitivesTag>;
@@ -59,6 +100,12 @@ struct BruteForceImpl
     using PredicateType = typename AccessTraitsHelper<AccessPredicates>::type;
     using PrimitiveType = typename AccessTraitsHelper<AccessPrimitives>::type;
 
+    if constexpr (usesBlockedDistances<PredicateType, PrimitiveType>())
+    {
+      queryBlockedDistances(space, primitives, predicates, callback);
+      return;
+    }
+
     int const n_primitives = AccessPrimitives::size(primitives);
     int const n_predicates = AccessPredicates::size(predicates);
     int max_scratch_size = TeamPolicy::scratch_size_max(0);
@@ -141,6 +188,359 @@ struct BruteForceImpl
               });
         });
   }
+
+  // The squared distances between the centers of the spheres a and of the
+  // boxes b are expanded as |a|^2 + |b|^2 - 2 a.b, the dot products of a
+  // block of predicates with a block of primitives being accumulated in
+  // scratch memory one slice of coordinates at a time, as in a matrix
+  // product. The pairs that the half diagonals of the boxes and the rounding
+  // errors of the expansion cannot bring within the radii are discarded, the
+  // others are checked exactly.
+  template <class ExecutionSpace, class Primitives, class Predicates,
+            class Callback>
+  static void queryBlockedDistances(ExecutionSpace const &space,
+                                    Primitives const &primitives,
+                                    Predicates const &predicates,
+                                    Callback const &callback)
+  {
+    using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace>;
+    using AccessPrimitives = AccessTraits<Primitives, PrimitivesTag>;
+    using AccessPredicates = AccessTraits<Predicates, PredicatesTag>;
+    using PrimitiveType = typename AccessTraitsHelper<AccessPrimitives>::type;
+    using Coordinate =
+        typename GeometryTraits::coordinate_type<PrimitiveType>::type;
+    constexpr int DIM = GeometryTraits::dimension_v<PrimitiveType>;
+
+    // predicates and primitives per block, per block of a thread, and
+    // coordinates per slice
+    constexpr int block_size = (sizeof(Coordinate) > 4 ? 32 : 64);
+    constexpr int micro_block_size = 4;
+    constexpr int micro_blocks = block_size / micro_block_size;
+    constexpr int slice_size = 16;
+
+    int const n_primitives = AccessPrimitives::size(primitives);
+    int const n_predicates = AccessPredicates::size(predicates);
+    int const n_primitive_blocks =
+        (n_primitives + block_size - 1) / block_size;
+    int const n_predicate_blocks =
+        (n_predicates + block_size - 1) / block_size;
+    int const n_teams = n_primitive_blocks * n_predicate_blocks;
+
+    using ScratchCoordinates =
+        Kokkos::View<Coordinate *,
+                     typename ExecutionSpace::scratch_memory_space,
+                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+    // products, two slices, and the squared norms, radii and squared half
+    // diagonals
+    int const scratch_size =
+        ScratchCoordinates::shmem_size(block_size * block_size) +
+        2 * ScratchCoordinates::shmem_size(slice_size * block_size) +
+        4 * ScratchCoordinates::shmem_size(block_size);
+    ARBORX_ASSERT(scratch_size <= TeamPolicy::scratch_size_max(0));
+
+    // bounds the relative errors of the expansion and of the exact distances
+    constexpr Coordinate tolerance =
+        4 * (DIM + 2) * KokkosExt::ArithmeticTraits::epsilon<Coordinate>::value;
+
+    Kokkos::parallel_for(
+        "ArborX::BruteForce::query::spatial::"
+        "check_all_predicates_against_all_primitives_by_blocks",
+        TeamPolicy(space, n_teams, Kokkos::AUTO, 1)
+            .set_scratch_size(0, Kokkos::PerTeam(scratch_size)),
+        KOKKOS_LAMBDA(typename TeamPolicy::member_type const &teamMember) {
+          int const predicate_start =
+              block_size * (teamMember.league_rank() / n_primitive_blocks);
+          int const primitive_start =
+              block_size * (teamMember.league_rank() % n_primitive_blocks);
+          int const predicates_in_this_team =
+              KokkosExt::min(block_size, n_predicates - predicate_start);
+          int const primitives_in_this_team =
+              KokkosExt::min(block_size, n_primitives - primitive_start);
+
+          auto const &scratch = teamMember.team_scratch(0);
+          ScratchCoordinates products(scratch, block_size * block_size);
+          ScratchCoordinates predicate_slice(scratch, slice_size * block_size);
+          ScratchCoordinates primitive_slice(scratch, slice_size * block_size);
+          ScratchCoordinates predicate_norms(scratch, block_size);
+          ScratchCoordinates primitive_norms(scratch, block_size);
+          ScratchCoordinates radii(scratch, block_size);
+          ScratchCoordinates half_diagonals(scratch, block_size);
+
+          Kokkos::parallel_for(
+              Kokkos::TeamVectorRange(teamMember, block_size * block_size),
+              [&](int ij) { products(ij) = 0; });
+          Kokkos::parallel_for(
+              Kokkos::TeamVectorRange(teamMember, block_size), [&](int i) {
+                predicate_norms(i) = 0;
+                primitive_norms(i) = 0;
+                half_diagonals(i) = 0;
+                radii(i) = (i < predicates_in_this_team
+                                ? getGeometry(AccessPredicates::get(
+                                                  predicates,
+                                                  predicate_start + i))
+                                      .radius()
+                                : 0);
+              });
+
+          for (int slice_start = 0; slice_start < DIM;
+               slice_start += slice_size)
+          {
+            int const coordinates_in_this_slice =
+                KokkosExt::min(slice_size, DIM - slice_start);
+
+            // wait until the previous slice is not needed anymore
+            teamMember.team_barrier();
+            // the members of the blocks missing at the end are zeroed
+            Kokkos::parallel_for(
+                Kokkos::TeamVectorRange(teamMember, slice_size * block_size),
+                [&](int ki) {
+                  int const k = ki / block_size;
+                  int const i = ki % block_size;
+                  int const d = slice_start + k;
+                  predicate_slice(ki) = 0;
+                  primitive_slice(ki) = 0;
+                  if (k >= coordinates_in_this_slice)
+                    return;
+                  if (i < predicates_in_this_team)
+                    predicate_slice(ki) =
+                        getGeometry(AccessPredicates::get(
+                                        predicates, predicate_start + i))
+                            .centroid()[d];
+                  if (i < primitives_in_this_team)
+                  {
+                    auto const &box =
+                        AccessPrimitives::get(primitives, primitive_start + i);
+                    primitive_slice(ki) =
+                        (box.minCorner()[d] + box.maxCorner()[d]) / 2;
+                  }
+                });
+            teamMember.team_barrier();
+
+            Kokkos::parallel_for(
+                Kokkos::TeamVectorRange(teamMember, block_size), [&](int i) {
+                  Coordinate extent = 0;
+                  if (i < primitives_in_this_team)
+                  {
+                    auto const &box =
+                        AccessPrimitives::get(primitives, primitive_start + i);
+                    for (int k = 0; k < coordinates_in_this_slice; ++k)
+                    {
+                      int const d = slice_start + k;
+                      Coordinate const half_length =
+                          (box.maxCorner()[d] - box.minCorner()[d]) / 2;
+                      extent += half_length * half_length;
+                    }
+                  }
+                  for (int k = 0; k < slice_size; ++k)
+                  {
+                    Coordinate const a = predicate_slice(k * block_size + i);
+                    Coordinate const b = primitive_slice(k * block_size + i);
+                    predicate_norms(i) += a * a;
+                    primitive_norms(i) += b * b;
+                  }
+                  half_diagonals(i) += extent;
+                });
+
+            // each thread accumulates a micro-block of the products
+            Kokkos::parallel_for(
+                Kokkos::TeamThreadRange(teamMember,
+                                        micro_blocks * micro_blocks),
+                [&](int micro_block) {
+                  int const i0 =
+                      micro_block_size * (micro_block / micro_blocks);
+                  int const j0 =
+                      micro_block_size * (micro_block % micro_blocks);
+                  Coordinate sums[micro_block_size][micro_block_size] = {};
+                  for (int k = 0; k < slice_size; ++k)
+                  {
+                    Coordinate a[micro_block_size];
+                    Coordinate b[micro_block_size];
+                    for (int u = 0; u < micro_block_size; ++u)
+                    {
+                      a[u] = predicate_slice(k * block_size + i0 + u);
+                      b[u] = primitive_slice(k * block_size + j0 + u);
+                    }
+                    for (int u = 0; u < micro_block_size; ++u)
+                      for (int v = 0; v < micro_block_size; ++v)
+                        sums[u][v] += a[u] * b[v];
+                  }
+                  for (int u = 0; u < micro_block_size; ++u)
+                    for (int v = 0; v < micro_block_size; ++v)
+                      products((i0 + u) * block_size + j0 + v) += sums[u][v];
+                });
+          }
+          teamMember.team_barrier();
+
+          Kokkos::parallel_for(
+              Kokkos::TeamThreadRange(teamMember, primitives_in_this_team),
+              [&](int j) {
+                Coordinate const half_diagonal =
+                    Kokkos::sqrt(half_diagonals(j));
+                Kokkos::parallel_for(
+                    Kokkos::ThreadVectorRange(teamMember,
+                                              predicates_in_this_team),
+                    [&](int i) {
+                      Coordinate const norms =
+                          predicate_norms(i) + primitive_norms(j);
+                      Coordinate const squared_distance =
+                          norms - 2 * products(i * block_size + j);
+                      Coordinate const reach =
+                          (radii(i) + half_diagonal) * (1 + tolerance);
+                      if (squared_distance - tolerance * norms > reach * reach)
+                        return;
+                      auto const &predicate = AccessPredicates::get(
+                          predicates, predicate_start + i);
+                      if (predicate(AccessPrimitives::get(
+                              primitives, primitive_start + j)))
+                        callback(predicate, primitive_start + j);
+                    });
+              });
+        });
+  }
+
+  using PairIndexDistance = Kokkos::pair<int, float>;
+
+  struct CompareDistance
+  {
+    KOKKOS_INLINE_FUNCTION bool operator()(PairIndexDistance const &lhs,
+                                           PairIndexDistance const &rhs) const
+    {
+      return lhs.second < rhs.second;
+    }
+  };
+
+  // Every predicate keeps a heap of the k nearest primitives it has found so
+  // far, the farthest on top. The teams handle tiles of predicates and go
+  // through all the primitives, one tile in scratch memory at a time.
+  template <class ExecutionSpace, class Primitives, class Predicates,
+            class Callback>
+  static void query(NearestPredicateTag, ExecutionSpace const &space,
+                    Primitives const &primitives, Predicates const &predicates,
+                    Callback const &callback)
+  {
+    using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace>;
+    using AccessPrimitives = AccessTraits<Primitives, PrimitivesTag>;
+    using AccessPredicates = AccessTraits<Predicates, PredicatesTag>;
+    using PrimitiveType = typename AccessTraitsHelper<AccessPrimitives>::type;
+    using MemorySpace = typename AccessPrimitives::memory_space;
+
+    int const n_primitives = AccessPrimitives::size(primitives);
+    int const n_predicates = AccessPredicates::size(predicates);
+
+    Kokkos::View<int *, MemorySpace> offset(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::BruteForce::query::nearest::offset"),
+        n_predicates + 1);
+    Kokkos::parallel_for(
+        "ArborX::BruteForce::query::nearest::"
+        "scan_queries_for_numbers_of_neighbors",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_predicates),
+        KOKKOS_LAMBDA(int i) {
+          offset(i) =
+              KokkosExt::max(getK(AccessPredicates::get(predicates, i)), 0);
+        });
+    exclusivePrefixSum(space, offset);
+    Kokkos::View<PairIndexDistance *, MemorySpace> heaps(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::BruteForce::query::nearest::heaps"),
+        KokkosExt::lastElement(space, offset));
+
+    // all of the scratch memory is used by primitives
+    int const primitives_per_team =
+        TeamPolicy::scratch_size_max(0) / sizeof(PrimitiveType);
+    ARBORX_ASSERT(primitives_per_team > 0);
+    // enough predicates to keep the threads of a team busy
+    int const predicates_per_team = 256;
+    int const n_teams =
+        (n_predicates + predicates_per_team - 1) / predicates_per_team;
+
+    using ScratchPrimitiveType =
+        Kokkos::View<PrimitiveType *,
+                     typename ExecutionSpace::scratch_memory_space,
+                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+    int scratch_size = ScratchPrimitiveType::shmem_size(primitives_per_team);
+
+    Kokkos::parallel_for(
+        "ArborX::BruteForce::query::nearest::"
+        "check_all_predicates_against_all_primitives",
+        TeamPolicy(space, n_teams, Kokkos::AUTO, 1)
+            .set_scratch_size(0, Kokkos::PerTeam(scratch_size)),
+        KOKKOS_LAMBDA(typename TeamPolicy::member_type const &teamMember) {
+          int const predicate_start =
+              predicates_per_team * teamMember.league_rank();
+          int const predicates_in_this_team = KokkosExt::min(
+              predicates_per_team, n_predicates - predicate_start);
+
+          // The heaps start full of invalid primitives at the largest
+          // distance allowed, so that only the primitives closer than all of
+          // them ever need to be pushed
+          Kokkos::parallel_for(
+              Kokkos::TeamThreadRange(teamMember, predicates_in_this_team),
+              [&](int q) {
+                int const i = predicate_start + q;
+                float const radius = Kokkos::nextafter(
+                    getMaxDistance(AccessPredicates::get(predicates, i)),
+                    KokkosExt::ArithmeticTraits::infinity<float>::value);
+                for (int j = offset(i); j < offset(i + 1); ++j)
+                  heaps(j) = {-1, radius};
+              });
+
+          ScratchPrimitiveType scratch_primitives(teamMember.team_scratch(0),
+                                                  primitives_per_team);
+          for (int primitive_start = 0; primitive_start < n_primitives;
+               primitive_start += primitives_per_team)
+          {
+            int const primitives_in_this_tile = KokkosExt::min(
+                primitives_per_team, n_primitives - primitive_start);
+
+            // wait until the previous tile is not needed anymore
+            teamMember.team_barrier();
+            Kokkos::parallel_for(
+                Kokkos::TeamVectorRange(teamMember, primitives_in_this_tile),
+                [&](const int j) {
+                  scratch_primitives(j) =
+                      AccessPrimitives::get(primitives, primitive_start + j);
+                });
+            teamMember.team_barrier();
+
+            Kokkos::parallel_for(
+                Kokkos::TeamThreadRange(teamMember, predicates_in_this_team),
+                [&](int q) {
+                  int const i = predicate_start + q;
+                  auto const &predicate = AccessPredicates::get(predicates, i);
+                  auto *const first = heaps.data() + offset(i);
+                  auto *const last = heaps.data() + offset(i + 1);
+                  if (first == last)
+                    return;
+                  for (int j = 0; j < primitives_in_this_tile; ++j)
+                  {
+                    float const distance =
+                        predicate.distance(scratch_primitives(j));
+                    if (distance < first->second)
+                    {
+                      popHeap(first, last, CompareDistance{});
+                      *(last - 1) = {primitive_start + j, distance};
+                      pushHeap(first, last, CompareDistance{});
+                    }
+                  }
+                });
+          }
+
+          // Report the neighbors found from the closest, the invalid
+          // primitives left being sorted last
+          Kokkos::parallel_for(
+              Kokkos::TeamThreadRange(teamMember, predicates_in_this_team),
+              [&](int q) {
+                int const i = predicate_start + q;
+                auto const &predicate = AccessPredicates::get(predicates, i);
+                auto *const first = heaps.data() + offset(i);
+                auto *const last = heaps.data() + offset(i + 1);
+                sortHeap(first, last, CompareDistance{});
+                for (auto *it = first; it != last && it->first != -1; ++it)
+                  callback(predicate, it->first);
+              });
+        });
+  }
 };
 } // namespace Details
 } // namespace ArborX
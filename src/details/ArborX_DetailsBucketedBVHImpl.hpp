@@ -0,0 +1,116 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_BUCKETED_BVH_IMPL_HPP
+#define ARBORX_DETAILS_BUCKETED_BVH_IMPL_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // expand
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+
+namespace ArborX::Details
+{
+
+struct BucketedBVHImpl
+{
+  // Largest number of indexables in a bucket, so that the predicate can be
+  // checked against all of them in a fixed-size loop
+  static constexpr int max_bucket_size = 16;
+
+  // Indexables stored as boxes may be built from other geometries, e.g. the
+  // points of a hierarchy meant to also hold boxes
+  template <typename Indexable, typename Geometry>
+  static KOKKOS_FUNCTION Indexable makeIndexable(Geometry const &geometry)
+  {
+    if constexpr (std::is_same_v<Geometry, Indexable>)
+      return geometry;
+    else
+    {
+      Indexable indexable{};
+      expand(indexable, geometry);
+      return indexable;
+    }
+  }
+
+  // Copy the indexables in the order of the permutation, so that each bucket
+  // of bucket_size consecutive ones is contiguous, and compute the bounding
+  // volume of each bucket
+  template <typename ExecutionSpace, typename Primitives,
+            typename Permutation, typename Indexables, typename BucketVolumes>
+  static void fillBuckets(ExecutionSpace const &space,
+                          Primitives const &primitives,
+                          Permutation const &permutation, int bucket_size,
+                          Indexables const &indexables,
+                          BucketVolumes const &bucket_volumes)
+  {
+    using Access = AccessTraits<Primitives, PrimitivesTag>;
+    using Indexable = typename Indexables::value_type;
+    using BoundingVolume = typename BucketVolumes::value_type;
+    int const n = indexables.extent(0);
+
+    Kokkos::parallel_for(
+        "ArborX::BucketedBVH::fill_buckets",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, bucket_volumes.extent(0)),
+        KOKKOS_LAMBDA(int bucket) {
+          int const begin = bucket * bucket_size;
+          int const end = KokkosExt::min(begin + bucket_size, n);
+          BoundingVolume bounding_volume{};
+          for (int j = begin; j < end; ++j)
+          {
+            indexables(j) = makeIndexable<Indexable>(
+                Access::get(primitives, permutation(j)));
+            expand(bounding_volume, indexables(j));
+          }
+          bucket_volumes(bucket) = bounding_volume;
+        });
+  }
+};
+
+// Callback invoked for each bucket whose bounding volume satisfies the
+// predicate. The indexables of the bucket are checked all at once before the
+// user callback is invoked with the index of those that satisfy it.
+template <typename Callback, typename Indexables, typename Indices>
+struct BucketCallback
+{
+  Callback _callback;
+  Indexables _indexables;
+  Indices _indices;
+  int _bucket_size;
+
+  template <typename Predicate, typename Value>
+  KOKKOS_FUNCTION CallbackTreeTraversalControl
+  operator()(Predicate const &predicate, Value const &value) const
+  {
+    constexpr int max_bucket_size = BucketedBVHImpl::max_bucket_size;
+    int const begin = value.index * _bucket_size;
+    int const count =
+        KokkosExt::min(_bucket_size, (int)_indexables.extent(0) - begin);
+
+    bool hits[max_bucket_size];
+    for (int k = 0; k < max_bucket_size; ++k)
+      hits[k] = (k < count && predicate(_indexables(begin + k)));
+
+    for (int k = 0; k < count; ++k)
+      if (hits[k] && invoke_callback_and_check_early_exit(
+                         _callback, predicate, (int)_indices(begin + k)))
+        return CallbackTreeTraversalControl::early_exit;
+    return CallbackTreeTraversalControl::normal_continuation;
+  }
+};
+
+} // namespace ArborX::Details
+
+#endif
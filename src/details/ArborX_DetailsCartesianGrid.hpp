@@ -20,10 +20,34 @@
 #include <Kokkos_MathematicalFunctions.hpp> // floor
 
 #include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 namespace ArborX::Details
 {
 
+// Catch a potential loss of precision that may happen when computing the
+// cell boxes from the cell coordinates, and can lead to wrong results.
+//
+// The machine precision by itself is not sufficient. In some experiments
+// run with a full NGSIM datasets, values below 3 could still produce wrong
+// results. This may still not be conservative enough, but all runs passed
+// verification when this warning was not triggered.
+template <int DIM, typename Point>
+void checkCellBoxPrecision(Point const &min_corner, float const (&h)[DIM])
+{
+  constexpr auto eps = 5 * std::numeric_limits<float>::epsilon();
+  for (int d = 0; d < DIM; ++d)
+  {
+    if (std::abs(h[d] / min_corner[d]) < eps)
+      throw std::runtime_error(
+          "ArborX exception: FDBSCAN-DenseBox algorithm will experience loss "
+          "of precision, undetectably producing wrong results. Please switch "
+          "to using FDBSCAN.");
+  }
+}
+
 template <int DIM>
 struct CartesianGrid
 {
@@ -94,6 +118,16 @@ public:
     return _n[d];
   }
 
+  // Total number of cells
+  KOKKOS_FUNCTION
+  size_t size() const
+  {
+    size_t n = 1;
+    for (int d = 0; d < DIM; ++d)
+      n *= _n[d];
+    return n;
+  }
+
 private:
   void buildGrid()
   {
@@ -124,22 +158,7 @@ private:
       ARBORX_ASSERT(_n[d] < m);
     }
 
-    // Catch a potential loss of precision that may happen in cellBox() and can
-    // lead to wrong results.
-    //
-    // The machine precision by itself is not sufficient. In some experiments
-    // run with a full NGSIM datasets, values below 3 could still produce wrong
-    // results. This may still not be conservative enough, but all runs passed
-    // verification when this warning was not triggered.
-    constexpr auto eps = 5 * std::numeric_limits<float>::epsilon();
-    for (int d = 0; d < DIM; ++d)
-    {
-      if (std::abs(_h[d] / min_corner[d]) < eps)
-        throw std::runtime_error(
-            "ArborX exception: FDBSCAN-DenseBox algorithm will experience loss "
-            "of precision, undetectably producing wrong results. Please switch "
-            "to using FDBSCAN.");
-    }
+    checkCellBoxPrecision(min_corner, _h);
   }
 
   Box _bounds;
@@ -0,0 +1,164 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_CHUNKED_PRIMITIVES_HPP
+#define ARBORX_DETAILS_CHUNKED_PRIMITIVES_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_Exception.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm> // min
+#include <type_traits>
+
+namespace ArborX::Details
+{
+
+// Give access to the primitives from MemorySpace one chunk at a time.
+// Primitives accessible from the execution space are used in place as a
+// single chunk, unless a positive chunk size is requested. Otherwise, they are
+// read on the host and copied to MemorySpace at most chunk_size at a time, so
+// that they never have to reside there all at once. This only bounds the
+// memory taken by the primitives, not by what is computed from them.
+template <typename MemorySpace, typename ExecutionSpace, typename Primitives>
+class ChunkedPrimitives
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using PrimitiveType = std::decay_t<decltype(Access::get(
+      std::declval<Primitives const &>(), 0))>;
+
+  static constexpr bool is_accessible =
+      KokkosExt::is_accessible_from<typename Access::memory_space,
+                                    ExecutionSpace>::value;
+  static constexpr bool is_host_accessible =
+      KokkosExt::is_accessible_from<typename Access::memory_space,
+                                    Kokkos::DefaultHostExecutionSpace>::value;
+  static_assert(is_accessible || is_host_accessible,
+                "Primitives must be accessible from the execution space or "
+                "from the host");
+
+  struct Identity
+  {
+    KOKKOS_FUNCTION int operator()(int i) const { return i; }
+  };
+
+public:
+  // Number of primitives per chunk used when none is requested but the
+  // primitives are not accessible from the execution space
+  static constexpr int default_chunk_size = 1 << 20;
+
+  ChunkedPrimitives(Primitives const &primitives, int chunk_size)
+      : _primitives(primitives)
+      , _size(Access::size(primitives))
+      , _chunk_size(chunk_size > 0 ? chunk_size : default_chunk_size)
+      , _streaming(!is_accessible || (is_host_accessible && chunk_size > 0))
+  {}
+
+  bool streaming() const { return _streaming; }
+
+  // Call f(offset, chunk) for each chunk, chunk being accessible from the
+  // execution space and holding primitives [offset, offset + chunk size)
+  template <typename F>
+  void forEach(ExecutionSpace const &space, F const &f) const
+  {
+    forEachImpl(space, Identity{}, f);
+  }
+
+  // Same as above but chunk holds the primitives permutation(offset), ...,
+  // permutation(offset + chunk size - 1). Only valid when streaming.
+  template <typename Permutation, typename F>
+  void forEachPermuted(ExecutionSpace const &space,
+                       Permutation const &permutation, F const &f) const
+  {
+    static_assert(KokkosExt::is_accessible_from_host<Permutation>::value);
+    ARBORX_ASSERT(_streaming);
+    ARBORX_ASSERT((int)permutation.extent(0) == _size);
+    forEachImpl(space, permutation, f);
+  }
+
+private:
+  template <typename Permutation, typename F>
+  void forEachImpl(ExecutionSpace const &space, Permutation const &permutation,
+                   F const &f) const
+  {
+    if constexpr (is_accessible)
+    {
+      if (!_streaming)
+      {
+        f(0, _primitives);
+        return;
+      }
+    }
+    if constexpr (is_host_accessible)
+    {
+      using HostExecutionSpace = Kokkos::DefaultHostExecutionSpace;
+
+      int const chunk_size = std::min(_chunk_size, _size);
+      Kokkos::View<PrimitiveType *, Kokkos::HostSpace> host_chunk(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                             "ArborX::ChunkedPrimitives::host_chunk"),
+          chunk_size);
+      auto chunk = Kokkos::create_mirror_view(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, MemorySpace{}),
+          host_chunk);
+
+      for (int offset = 0; offset < _size; offset += chunk_size)
+      {
+        int const n = std::min(chunk_size, _size - offset);
+        auto const range = Kokkos::make_pair(0, n);
+
+        // The previous chunk must be done with before it gets overwritten
+        space.fence();
+        auto const &primitives = _primitives;
+        Kokkos::parallel_for(
+            "ArborX::ChunkedPrimitives::gather",
+            Kokkos::RangePolicy<HostExecutionSpace>(HostExecutionSpace{}, 0,
+                                                    n),
+            KOKKOS_LAMBDA(int i) {
+              host_chunk(i) = Access::get(primitives, permutation(offset + i));
+            });
+        HostExecutionSpace{}.fence();
+        Kokkos::deep_copy(space, Kokkos::subview(chunk, range),
+                          Kokkos::subview(host_chunk, range));
+
+        f(offset, Kokkos::subview(chunk, range));
+      }
+      space.fence();
+    }
+  }
+
+  Primitives _primitives;
+  int _size;
+  int _chunk_size;
+  bool _streaming;
+};
+
+// Values of the leaf nodes themselves, to regenerate the hierarchy from leaf
+// nodes that are already sorted along the space-filling curve
+template <typename LeafNodes>
+struct LeafNodesValues
+{
+  LeafNodes _leaf_nodes;
+  using memory_space = typename LeafNodes::memory_space;
+
+  KOKKOS_FUNCTION auto operator()(int i) const
+  {
+    return _leaf_nodes(i).value;
+  }
+
+  KOKKOS_FUNCTION auto size() const { return _leaf_nodes.size(); }
+};
+
+} // namespace ArborX::Details
+
+#endif
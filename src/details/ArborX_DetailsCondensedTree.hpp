@@ -0,0 +1,275 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_CONDENSED_TREE_HPP
+#define ARBORX_DETAILS_CONDENSED_TREE_HPP
+
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp>
+#include <ArborX_Exception.hpp>
+
+#include <Kokkos_Core.hpp>
+
+namespace ArborX::Details
+{
+
+// Density level at which an edge of the dendrogram splits a cluster
+KOKKOS_INLINE_FUNCTION double lambdaOfHeight(float height)
+{
+  return (height > 0 ? 1. / height
+                     : KokkosExt::ArithmeticTraits::finite_max<double>::value);
+}
+
+// Flat clustering of the condensed tree of a dendrogram by excess of mass, as
+// in HDBSCAN [1].
+//
+// The dendrogram nodes are the edges [0, n - 1) followed by the n vertices.
+// A cluster of the condensed tree is a maximal chain of dendrogram edges of
+// at least min_cluster_size vertices, each having at most one child of that
+// size. It is identified by the bottom edge of the chain, where it either
+// splits into two clusters or vanishes. The other children along the chain
+// fall out of the cluster. The stability of a cluster C born at the density
+// level lambda_birth (the inverse of the height of the parent of its top
+// edge) is the sum over its points p of lambda_p - lambda_birth, where
+// lambda_p is the density level at which p leaves C. Summed along the chain,
+// this is the sum of size(c) * lambda_e over the children c falling out at
+// the edges e, plus size(bottom) * lambda_bottom, minus size(top) *
+// lambda_birth. All of it is accumulated bottom-up in a single pass, in which
+// the last thread to reach an edge processes it, as in the hierarchy refit.
+//
+// The root cluster is never selected. Points are labeled with the index,
+// among [0, number of selected clusters), of the selected cluster they
+// belong to, and -1 if they are noise.
+//
+// [1] Campello, R. J. G. B., Moulavi, D., & Sander, J. (2013). Density-based
+// clustering based on hierarchical density estimates. PAKDD 2013.
+template <typename ExecutionSpace, typename Parents, typename ParentHeights>
+Kokkos::View<int *, typename Parents::memory_space>
+condensedTreeLabels(ExecutionSpace const &exec_space, Parents const &parents,
+                    ParentHeights const &parent_heights, int min_cluster_size)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::CondensedTree");
+
+  using MemorySpace = typename Parents::memory_space;
+
+  ARBORX_ASSERT(min_cluster_size >= 2);
+
+  int const num_edges = parent_heights.size();
+  int const n = (num_edges == 0 && parents.size() == 0 ? 0 : num_edges + 1);
+  ARBORX_ASSERT((int)parents.size() == num_edges + n);
+
+  Kokkos::View<int *, MemorySpace> labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::CondensedTree::labels"),
+      n);
+  if (n < min_cluster_size || num_edges == 0)
+  {
+    Kokkos::deep_copy(exec_space, labels, -1);
+    return labels;
+  }
+
+  constexpr int UNDEFINED = -1;
+
+  Kokkos::View<int *[2], MemorySpace> children(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::CondensedTree::children"),
+      num_edges);
+  Kokkos::View<int *, MemorySpace> num_children(
+      Kokkos::view_alloc(exec_space, "ArborX::CondensedTree::num_children"),
+      num_edges);
+  Kokkos::parallel_for(
+      "ArborX::CondensedTree::find_children",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges + n),
+      KOKKOS_LAMBDA(int node) {
+        int const parent = parents(node);
+        if (parent != UNDEFINED)
+          children(parent, Kokkos::atomic_fetch_add(&num_children(parent),
+                                                    1)) = node;
+      });
+
+  // Per edge: the number of vertices below it, the bottom edge of the chain
+  // it belongs to (i.e., the cluster), and the partial stability sum of the
+  // chain below it. Per cluster: the sum of the best stabilities of its
+  // children, whether it is selected, and its parent cluster.
+  Kokkos::View<int *, MemorySpace> sizes(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::CondensedTree::sizes"),
+      num_edges);
+  Kokkos::View<int *, MemorySpace> clusters(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::CondensedTree::clusters"),
+      num_edges);
+  Kokkos::View<double *, MemorySpace> accumulated(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::CondensedTree::accumulated_stabilities"),
+      num_edges);
+  Kokkos::View<double *, MemorySpace> children_stabilities(
+      Kokkos::view_alloc(exec_space,
+                         "ArborX::CondensedTree::children_stabilities"),
+      num_edges);
+  Kokkos::View<bool *, MemorySpace> selected(
+      Kokkos::view_alloc(exec_space, "ArborX::CondensedTree::selected"),
+      num_edges);
+  Kokkos::View<int *, MemorySpace> cluster_parents(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::CondensedTree::cluster_parents"),
+      num_edges);
+  Kokkos::deep_copy(exec_space, cluster_parents, UNDEFINED);
+
+  Kokkos::View<int *, MemorySpace> visits(
+      Kokkos::view_alloc(exec_space, "ArborX::CondensedTree::visits"),
+      num_edges);
+  Kokkos::parallel_for(
+      "ArborX::CondensedTree::compute_stabilities",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        int node = num_edges + i;
+        while (true)
+        {
+          int const e = parents(node);
+          if (e == UNDEFINED)
+            break;
+
+          // Make sure the writes for the subtree rooted at node are visible
+          // to the thread processing the sibling before signaling arrival.
+          Kokkos::memory_fence();
+
+          // Terminate the first thread that reaches an edge and let the
+          // second one through, so that every edge is processed once and
+          // only after both of its children.
+          if (Kokkos::atomic_fetch_add(&visits(e), 1) == 0)
+            break;
+
+          Kokkos::load_fence();
+
+          int c[2] = {children(e, 0), children(e, 1)};
+          int s[2];
+          for (int k = 0; k < 2; ++k)
+            s[k] = (c[k] < num_edges ? sizes(c[k]) : 1);
+          sizes(e) = s[0] + s[1];
+
+          double const lambda = lambdaOfHeight(parent_heights(e));
+          bool const is_big[2] = {s[0] >= min_cluster_size,
+                                  s[1] >= min_cluster_size};
+          if (is_big[0] && is_big[1])
+          {
+            // Two clusters are born. Complete their stabilities, and select
+            // them if they are more stable than their selected descendants.
+            for (int k = 0; k < 2; ++k)
+            {
+              int const cluster = clusters(c[k]);
+              double const stability = accumulated(c[k]) - s[k] * lambda;
+              double const descendants_stability =
+                  children_stabilities(cluster);
+              selected(cluster) = (stability >= descendants_stability);
+              children_stabilities(e) +=
+                  (selected(cluster) ? stability : descendants_stability);
+              cluster_parents(cluster) = e;
+            }
+            clusters(e) = e;
+            accumulated(e) = sizes(e) * lambda;
+          }
+          else if (is_big[0] || is_big[1])
+          {
+            // The cluster goes on, and the small child falls out
+            int const k = (is_big[0] ? 0 : 1);
+            clusters(e) = clusters(c[k]);
+            accumulated(e) = accumulated(c[k]) + s[1 - k] * lambda;
+          }
+          else
+          {
+            // A cluster vanishes, all of its points falling out at once
+            clusters(e) = e;
+            accumulated(e) = sizes(e) * lambda;
+          }
+
+          node = e;
+        }
+      });
+
+  // The root cluster, not being born from a split, is never selected. Find
+  // the topmost selected cluster above each cluster by pointer jumping, each
+  // step combining the path to the current ancestor with the path above it.
+  Kokkos::View<int *, MemorySpace> ancestors(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::CondensedTree::ancestors"),
+      num_edges);
+  Kokkos::View<int *, MemorySpace> topmost(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::CondensedTree::topmost_selected"),
+      num_edges);
+  Kokkos::parallel_for(
+      "ArborX::CondensedTree::initialize_topmost_selected",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+      KOKKOS_LAMBDA(int e) {
+        ancestors(e) = cluster_parents(e);
+        topmost(e) = (selected(e) ? e : UNDEFINED);
+      });
+  auto next_ancestors = KokkosExt::clone(exec_space, ancestors);
+  auto next_topmost = KokkosExt::clone(exec_space, topmost);
+  int num_unfinished;
+  do
+  {
+    Kokkos::parallel_reduce(
+        "ArborX::CondensedTree::jump_to_ancestors",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+        KOKKOS_LAMBDA(int e, int &update) {
+          int const ancestor = ancestors(e);
+          if (ancestor == UNDEFINED)
+            return;
+          next_topmost(e) =
+              (topmost(ancestor) != UNDEFINED ? topmost(ancestor) : topmost(e));
+          next_ancestors(e) = ancestors(ancestor);
+          if (next_ancestors(e) != UNDEFINED)
+            ++update;
+        },
+        num_unfinished);
+    Kokkos::deep_copy(exec_space, ancestors, next_ancestors);
+    Kokkos::deep_copy(exec_space, topmost, next_topmost);
+  } while (num_unfinished > 0);
+
+  // Number the selected clusters
+  Kokkos::View<int *, MemorySpace> cluster_labels(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::CondensedTree::cluster_labels"),
+      num_edges);
+  Kokkos::parallel_scan(
+      "ArborX::CondensedTree::number_selected_clusters",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+      KOKKOS_LAMBDA(int e, int &update, bool final_pass) {
+        bool const is_selected = (topmost(e) == e);
+        if (final_pass)
+          cluster_labels(e) = update;
+        if (is_selected)
+          ++update;
+      });
+
+  // A vertex belongs to the cluster it falls out of, which is the one of its
+  // lowest ancestor of at least min_cluster_size vertices. Small subtrees
+  // have fewer than min_cluster_size levels, so the walk is short.
+  Kokkos::parallel_for(
+      "ArborX::CondensedTree::label_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        int e = parents(num_edges + i);
+        while (sizes(e) < min_cluster_size)
+          e = parents(e);
+        int const cluster = topmost(clusters(e));
+        labels(i) = (cluster != UNDEFINED ? cluster_labels(cluster) : -1);
+      });
+
+  return labels;
+}
+
+} // namespace ArborX::Details
+
+#endif
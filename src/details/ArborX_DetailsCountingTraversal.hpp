@@ -0,0 +1,137 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_COUNTING_TRAVERSAL_HPP
+#define ARBORX_DETAILS_COUNTING_TRAVERSAL_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsNode.hpp>          // ROPE_SENTINEL
+#include <ArborX_DetailsTreeTraversal.hpp> // containsBoundingVolume
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+namespace ArborX::Details
+{
+
+// Node aggregates counting the leaves of each subtree
+struct CountLeaves
+{
+  template <typename Value>
+  KOKKOS_FUNCTION int operator()(Value const &) const
+  {
+    return 1;
+  }
+  KOKKOS_FUNCTION int operator()(int left, int right) const
+  {
+    return left + right;
+  }
+};
+
+// Count the values satisfying each spatial predicate. The subtrees contained
+// in the geometry of the predicate are counted at once from their sizes. The
+// subtrees that only intersect it may be counted as half of their leaves, as
+// long as the count stays within the relative tolerance of the exact one.
+//
+// The exact count lies between the count of the leaves found so far and that
+// plus the sizes of the subtrees skipped, so that reporting the midpoint is
+// off by at most half the sizes skipped. Along the traversal, a subtree is
+// only skipped if half the sizes skipped, rounded up, stays below the
+// relative tolerance of the current count, which can only grow.
+template <typename BVH, typename Predicates, typename Sizes, typename Counts>
+struct CountingTraversal
+{
+  BVH _bvh;
+  Predicates _predicates;
+  Sizes _sizes;
+  Counts _counts;
+  float _relative_tolerance;
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+
+  template <typename ExecutionSpace>
+  CountingTraversal(ExecutionSpace const &space, BVH const &bvh,
+                    Predicates const &predicates, Sizes const &sizes,
+                    Counts const &counts, float relative_tolerance,
+                    Experimental::TraversalPolicy const &policy)
+      : _bvh{bvh}
+      , _predicates{predicates}
+      , _sizes{sizes}
+      , _counts{counts}
+      , _relative_tolerance{relative_tolerance}
+  {
+    if (_bvh.empty())
+    {
+      // do nothing
+    }
+    else
+    {
+      launchTraversal("ArborX::TreeTraversal::spatial::count", space,
+                      Access::size(predicates), policy, *this);
+    }
+  }
+
+  KOKKOS_FUNCTION void operator()(int queryIndex) const
+  {
+    auto const &predicate = Access::get(_predicates, queryIndex);
+    auto const &traversal_predicate = makeTraversalPredicate(predicate);
+
+    if (_bvh.size() == 1)
+    {
+      _counts(queryIndex) =
+          traversal_predicate(HappyTreeFriends::getIndexable(_bvh, 0)) ? 1 : 0;
+      return;
+    }
+
+    int count = 0;
+    int skipped = 0;
+    int node = HappyTreeFriends::getRoot(_bvh); // start with root
+    do
+    {
+      if (HappyTreeFriends::isLeaf(_bvh, node))
+      {
+        if (traversal_predicate(HappyTreeFriends::getIndexable(_bvh, node)))
+          ++count;
+        node = HappyTreeFriends::getRope(_bvh, node);
+        continue;
+      }
+
+      auto const &bounding_volume =
+          HappyTreeFriends::getInternalBoundingVolume(_bvh, node);
+      if (!traversal_predicate(bounding_volume))
+      {
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+      else if (containsBoundingVolume(&traversal_predicate, &bounding_volume))
+      {
+        count += _sizes(node);
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+      else if (skipped + _sizes(node) + 1 <=
+               2 * _relative_tolerance * count)
+      {
+        skipped += _sizes(node);
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+      else
+      {
+        node = HappyTreeFriends::getLeftChild(_bvh, node);
+      }
+    } while (node != ROPE_SENTINEL);
+
+    _counts(queryIndex) = count + skipped / 2;
+  }
+};
+
+} // namespace ArborX::Details
+
+#endif
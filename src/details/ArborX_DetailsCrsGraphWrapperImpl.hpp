@@ -15,13 +15,23 @@
 #include <ArborX_AccessTraits.hpp>
 #include <ArborX_Box.hpp>
 #include <ArborX_Callbacks.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // distance
 #include <ArborX_DetailsBatchedQueries.hpp>
+#include <ArborX_DetailsHeap.hpp>
+#include <ArborX_DetailsKokkosExtProfileEvent.hpp>
 #include <ArborX_DetailsKokkosExtViewHelpers.hpp>
 #include <ArborX_DetailsPermutedData.hpp>
 #include <ArborX_HyperBox.hpp>
+#include <ArborX_IndexableGetter.hpp>
+#include <ArborX_MemoryUsage.hpp>
 #include <ArborX_Predicates.hpp>
 #include <ArborX_TraversalPolicy.hpp>
 
+#include <algorithm> // max
+#include <functional>
+#include <utility>
+#include <vector>
+
 namespace ArborX
 {
 namespace Details
@@ -49,35 +59,172 @@ struct FirstPassNoBufferOptimizationTag
 {};
 struct SecondPassTag
 {};
+struct SinglePassTag
+{};
+struct CappedPassTag
+{};
+
+// Results of all the queries appended to a global pool of fixed-size chunks.
+// The chunks of a query form a linked list. Each predicate is traversed by a
+// single thread so that only the allocation of chunks needs to be atomic.
+template <typename OutputView, typename CountView>
+struct ResultsPool
+{
+  static constexpr int chunk_size = 16;
+
+  using MemorySpace = typename CountView::memory_space;
+
+  // Chunks one after the other, and the chunk that follows each of them
+  OutputView _values;
+  Kokkos::View<int *, MemorySpace> _next;
+  // Number of chunks handed out, which may exceed the capacity
+  Kokkos::View<int, MemorySpace> _num_chunks;
+  // First and last chunks of each query
+  CountView _heads;
+  CountView _tails;
+
+  KOKKOS_FUNCTION int capacity() const { return _next.extent_int(0); }
+
+  KOKKOS_FUNCTION void insert(int query, int count,
+                              typename OutputView::value_type const &value)
+      const
+  {
+    int const slot = count % chunk_size;
+    int tail = (count > 0 ? _tails(query) : 0);
+    // Once the pool is exhausted, the following results of the query are
+    // only counted
+    if (tail < 0)
+      return;
+    if (slot == 0)
+    {
+      int const chunk = Kokkos::atomic_fetch_add(&_num_chunks(), 1);
+      if (chunk >= capacity())
+      {
+        _tails(query) = -1;
+        return;
+      }
+      if (count == 0)
+        _heads(query) = chunk;
+      else
+        _next(tail) = chunk;
+      _next(chunk) = -1;
+      _tails(query) = tail = chunk;
+    }
+    _values(tail * chunk_size + slot) = value;
+  }
+};
 
 template <typename PassTag, typename Predicates, typename Callback,
-          typename OutputView, typename CountView, typename PermutedOffset,
-          bool Legacy>
+          typename OutputView, typename CountView, typename PermutedOffset>
 struct InsertGenerator
 {
   Callback _callback;
   OutputView _out;
   CountView _counts;
   PermutedOffset _permuted_offset;
+  ResultsPool<OutputView, CountView> _pool; // only used in single pass
 
   using ValueType = typename OutputView::value_type;
   using Access = AccessTraits<Predicates, PredicatesTag>;
   using PredicateType = typename AccessTraitsHelper<Access>::type;
 
-  // Legacy callback wrapper
-  template <typename Value, bool B = Legacy,
-            typename Enable = std::enable_if_t<!B>>
+  // Number of values of a predicate staged before they are written out
+  static constexpr int staging_size = 8;
+
+  using StagingOutput =
+      decltype(Kokkos::subview(std::declval<OutputView const &>(),
+                               std::declval<Kokkos::pair<int, int>>()));
+  using StagingCounter =
+      Kokkos::View<typename CountView::value_type,
+                   typename CountView::memory_space, Kokkos::MemoryUnmanaged>;
+  using StagingBuffer = Experimental::StagingBuffer<
+      ValueType, staging_size,
+      Experimental::AppendToView<StagingOutput, StagingCounter>>;
+
+  // Staged output of the predicate being traversed, if any
+  StagingBuffer const *_staging = nullptr;
+
+  // The values found for a predicate in the first and second passes are
+  // staged for its whole traversal, so that their slots are reserved with a
+  // single atomic per flush rather than per value
+  using scoped_callback = void;
+
+  template <typename Traverse>
+  KOKKOS_FUNCTION void scope(PredicateType const &predicate,
+                             Traverse const &traverse) const
+  {
+    if constexpr (std::is_same_v<PassTag, FirstPassTag> ||
+                  std::is_same_v<PassTag, SecondPassTag>)
+    {
+      auto const predicate_index = getData(predicate);
+      auto &count = _counts(predicate_index);
+
+      int begin = 0;
+      int end = _out.extent_int(0);
+      if constexpr (std::is_same_v<PassTag, FirstPassTag>)
+      {
+        // The values are counted from the start of the buffer of the
+        // predicate, see insert()
+        auto const &offset = _permuted_offset(predicate_index);
+        begin = offset;
+        end = *(&offset + 1);
+      }
+      StagingBuffer staging(
+          {Kokkos::subview(_out, Kokkos::make_pair(begin, end)),
+           StagingCounter(&count)});
+
+      auto generator = *this;
+      generator._staging = &staging;
+      traverse(generator);
+    }
+    else
+    {
+      traverse(*this);
+    }
+  }
+
+  // Legacy trees pass the values too, so that the distances can be computed
+  // from their indexables
+  using legacy_values = void;
+
+  template <typename Value>
   KOKKOS_FUNCTION auto operator()(PredicateType const &predicate,
                                   Value const &value) const
   {
-    return (*this)(predicate, (int)value.index);
+    if constexpr (std::is_same_v<Callback, Experimental::WithDistances>)
+    {
+      // Spatial predicates measure the distances from the centroid of their
+      // geometry, e.g. from the center of the sphere of a radius search
+      auto const &geometry = getGeometry(getPredicate(predicate));
+      auto const &indexable = DefaultIndexableGetter{}(value);
+      float distance_to_value;
+      if constexpr (std::is_same_v<typename AccessTraitsHelper<Access>::tag,
+                                   SpatialPredicateTag>)
+        distance_to_value = distance(returnCentroid(geometry), indexable);
+      else
+        distance_to_value = distance(geometry, indexable);
+      return insert(predicate, [&](auto const &out) {
+        out({(int)value.index, distance_to_value});
+      });
+    }
+    else
+      return (*this)(predicate, (int)value.index);
   }
 
   KOKKOS_FUNCTION auto operator()(PredicateType const &predicate,
                                   int primitive_index) const
+  {
+    return insert(predicate, [&](auto const &out) {
+      return _callback(getOriginalPredicate(predicate), primitive_index, out);
+    });
+  }
+
+  // Invoke the callback, as invoke(out), with the output functor of the pass
+  template <typename Invoke>
+  KOKKOS_FUNCTION auto insert(PredicateType const &predicate,
+                              Invoke const &invoke) const
   {
     auto const predicate_index = getData(predicate);
-    auto const &raw_predicate = getPredicate(predicate);
     auto &count = _counts(predicate_index);
 
     if constexpr (std::is_same_v<PassTag, FirstPassTag>)
@@ -89,43 +236,373 @@ struct InsertGenerator
       auto const &offset = _permuted_offset(predicate_index);
       auto const buffer_size = *(&offset + 1) - offset;
 
-      return _callback(raw_predicate, primitive_index,
-                       [&](ValueType const &value) {
-                         int count_old = Kokkos::atomic_fetch_add(&count, 1);
-                         if (count_old < buffer_size)
-                           _out(offset + count_old) = value;
-                       });
+      if (_staging)
+        return invoke(*_staging);
+      return invoke([&](ValueType const &value) {
+        int count_old = Kokkos::atomic_fetch_add(&count, 1);
+        if (count_old < buffer_size)
+          _out(offset + count_old) = value;
+      });
     }
     else if constexpr (std::is_same_v<PassTag,
                                       FirstPassNoBufferOptimizationTag>)
     {
-      return _callback(raw_predicate, primitive_index, [&](ValueType const &) {
-        Kokkos::atomic_increment(&count);
+      return invoke(
+          [&](ValueType const &) { Kokkos::atomic_increment(&count); });
+    }
+    else if constexpr (std::is_same_v<PassTag, SinglePassTag>)
+    {
+      return invoke([&](ValueType const &value) {
+        _pool.insert(predicate_index, count++, value);
       });
     }
+    else if constexpr (std::is_same_v<PassTag, CappedPassTag>)
+    {
+      // The results past the buffer of the predicate are dropped, and its
+      // traversal exits once the buffer is full
+      auto const &offset = _permuted_offset(predicate_index);
+      auto const buffer_size = *(&offset + 1) - offset;
+      auto const out = [&](ValueType const &value) {
+        if (count < buffer_size)
+          _out(offset + count++) = value;
+      };
+      if constexpr (std::is_same_v<decltype(invoke(out)),
+                                   CallbackTreeTraversalControl>)
+      {
+        if (invoke(out) == CallbackTreeTraversalControl::early_exit)
+          return CallbackTreeTraversalControl::early_exit;
+      }
+      else
+        invoke(out);
+      return count < buffer_size
+                 ? CallbackTreeTraversalControl::normal_continuation
+                 : CallbackTreeTraversalControl::early_exit;
+    }
     else
     {
       static_assert(std::is_same_v<PassTag, SecondPassTag>);
       // we store offsets in counts, and offset(permute(i)) = counts(i)
       auto &offset = count;
 
-      // TODO: there is a tradeoff here between skipping computation offset +
-      // count, and atomic increment of count. I think atomically incrementing
-      // offset is problematic for OpenMP as you potentially constantly steal
-      // cache lines.
-      return _callback(raw_predicate, primitive_index,
-                       [&](ValueType const &value) {
-                         _out(Kokkos::atomic_fetch_add(&offset, 1)) = value;
-                       });
+      // Staging the values amortizes the atomic increments of the offset,
+      // which keep stealing the cache line from the other threads on OpenMP
+      if (_staging)
+        return invoke(*_staging);
+      return invoke([&](ValueType const &value) {
+        _out(Kokkos::atomic_fetch_add(&offset, 1)) = value;
+      });
     }
   }
 };
 
+struct QueryFutureAccess
+{
+  static void setWait(Experimental::QueryFuture const &future,
+                      std::function<void()> wait)
+  {
+    future._state->wait = std::move(wait);
+  }
+};
+
 namespace CrsGraphWrapperImpl
 {
 
-template <typename Callback>
-using LegacyTreeArchetypeExpression = typename Callback::legacy_tree;
+// Single pass that stores the results of each query in its own preallocated
+// buffer, and then compacts them in place. Nothing is copied back to the
+// host: the results exceeding their buffer are dropped and reported when
+// waiting on the future.
+template <typename ExecutionSpace, typename Tree, typename Predicates,
+          typename Callback, typename OutputView, typename OffsetView,
+          typename PermuteType>
+void queryImplAsync(ExecutionSpace const &space, Tree const &tree,
+                    Predicates const &predicates, Callback const &callback,
+                    OutputView &out, OffsetView &offset, PermuteType permute,
+                    Experimental::TraversalPolicy const &policy)
+{
+  // pre-condition: offset and out are preallocated and offset is
+  // pre-initialized
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  auto const n_queries = Access::size(predicates);
+
+  Kokkos::Profiling::pushRegion("ArborX::CrsGraphWrapper::async");
+
+  // The temporary storage is kept in the plan of replayed queries
+  auto const &plan = policy._query_plan;
+
+  using CountView = OffsetView;
+  CountView counts;
+  if (plan)
+  {
+    counts = plan->view<CountView>(
+        space, "ArborX::CrsGraphWrapper::counts", n_queries);
+    Kokkos::deep_copy(space, counts, 0);
+  }
+  else
+    counts = CountView(
+        Kokkos::view_alloc(space, "ArborX::CrsGraphWrapper::counts"),
+        n_queries);
+
+  using PermutedPredicates =
+      PermutedData<Predicates, PermuteType, true /*AttachIndices*/>;
+  PermutedPredicates permuted_predicates = {predicates, permute};
+
+  using PermutedOffset = PermutedData<OffsetView, PermuteType>;
+  PermutedOffset permuted_offset = {offset, permute};
+
+  tree.query(space, permuted_predicates,
+             InsertGenerator<FirstPassTag, PermutedPredicates, Callback,
+                             OutputView, CountView, PermutedOffset>{
+                 callback, out, counts, permuted_offset},
+             Experimental::TraversalPolicy(policy).setPredicateSorting(false));
+
+  using OverflowView = Kokkos::View<int, typename OffsetView::memory_space>;
+  OverflowView overflow;
+  if (plan)
+  {
+    overflow = plan->view<OverflowView>(
+        space, "ArborX::CrsGraphWrapper::overflow");
+    Kokkos::deep_copy(space, overflow, 0);
+  }
+  else
+    overflow = OverflowView(
+        Kokkos::view_alloc(space, "ArborX::CrsGraphWrapper::overflow"));
+  Kokkos::parallel_for(
+      "ArborX::CrsGraphWrapper::truncate_counts",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int i) {
+        auto const *const offset_ptr = &permuted_offset(i);
+        int const buffer_size = *(offset_ptr + 1) - *offset_ptr;
+        if (counts(i) > buffer_size)
+        {
+          counts(i) = buffer_size;
+          overflow() = 1;
+        }
+      });
+
+  typename OffsetView::non_const_type preallocated_offset;
+  if (plan)
+  {
+    preallocated_offset = plan->view<typename OffsetView::non_const_type>(
+        space, "ArborX::CrsGraphWrapper::preallocated_offset",
+        offset.extent(0));
+    Kokkos::deep_copy(space, preallocated_offset, offset);
+  }
+  else
+    preallocated_offset = KokkosExt::clone(space, offset);
+  Kokkos::parallel_for(
+      "ArborX::CrsGraphWrapper::copy_counts_to_offsets",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int const i) { permuted_offset(i) = counts(i); });
+  exclusivePrefixSum(space, offset);
+
+  // The compacted results cannot be written in place without a host
+  // synchronization, so they are copied to storage of the same size. Replayed
+  // queries alternate between the output and the storage kept in the plan.
+  OutputView tmp_out;
+  if (plan)
+    tmp_out = plan->view<OutputView>(
+        space, "ArborX::CrsGraphWrapper::compacted_out", out.extent(0));
+  else
+    tmp_out = OutputView(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing, out.label()),
+        out.extent(0));
+  Kokkos::parallel_for(
+      "ArborX::CrsGraphWrapper::copy_valid_values",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int i) {
+        int count = offset(i + 1) - offset(i);
+        for (int j = 0; j < count; ++j)
+        {
+          tmp_out(offset(i) + j) = out(preallocated_offset(i) + j);
+        }
+      });
+  if (plan)
+    plan->keep("ArborX::CrsGraphWrapper::compacted_out", out);
+  out = tmp_out;
+
+  QueryFutureAccess::setWait(*policy._future, [space, overflow]() {
+    space.fence("ArborX::QueryFuture::wait");
+    auto const overflow_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, overflow);
+    // Some results did not fit in the buffer and were dropped
+    ARBORX_ASSERT(overflow_host() == 0);
+  });
+
+  Kokkos::Profiling::popRegion();
+}
+
+// Single pass that stores at most the maximum number of results of each
+// query in its own preallocated buffer, and then compacts them
+template <typename ExecutionSpace, typename Tree, typename Predicates,
+          typename Callback, typename OutputView, typename OffsetView,
+          typename PermuteType>
+void queryImplCapped(ExecutionSpace const &space, Tree const &tree,
+                     Predicates const &predicates, Callback const &callback,
+                     OutputView &out, OffsetView &offset, PermuteType permute,
+                     Experimental::TraversalPolicy const &policy)
+{
+  // pre-condition: offset and out are preallocated and offset is
+  // pre-initialized
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  auto const n_queries = Access::size(predicates);
+
+  Kokkos::Profiling::pushRegion("ArborX::CrsGraphWrapper::capped");
+
+  using CountView = OffsetView;
+  auto counts = temporaryView<CountView>(
+      space, policy._workspace, "ArborX::CrsGraphWrapper::counts", n_queries);
+  Kokkos::deep_copy(space, counts, 0);
+
+  using PermutedPredicates =
+      PermutedData<Predicates, PermuteType, true /*AttachIndices*/>;
+  PermutedPredicates permuted_predicates = {predicates, permute};
+
+  using PermutedOffset = PermutedData<OffsetView, PermuteType>;
+  PermutedOffset permuted_offset = {offset, permute};
+
+  tree.query(space, permuted_predicates,
+             InsertGenerator<CappedPassTag, PermutedPredicates, Callback,
+                             OutputView, CountView, PermutedOffset>{
+                 callback, out, counts, permuted_offset},
+             Experimental::TraversalPolicy(policy).setPredicateSorting(false));
+
+  auto const preallocated_offset = KokkosExt::clone(space, offset);
+  Kokkos::parallel_for(
+      "ArborX::CrsGraphWrapper::copy_counts_to_offsets",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int const i) { permuted_offset(i) = counts(i); });
+  exclusivePrefixSum(space, offset);
+
+  int const n_results = KokkosExt::lastElement(space, offset);
+  if (n_results < out.extent_int(0))
+  {
+    OutputView tmp_out(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing, out.label()),
+        n_results);
+    Kokkos::parallel_for(
+        "ArborX::CrsGraphWrapper::copy_valid_values",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+        KOKKOS_LAMBDA(int i) {
+          int count = offset(i + 1) - offset(i);
+          for (int j = 0; j < count; ++j)
+          {
+            tmp_out(offset(i) + j) = out(preallocated_offset(i) + j);
+          }
+        });
+    out = tmp_out;
+  }
+
+  Kokkos::Profiling::popRegion();
+}
+
+// Single pass that appends the results to a pool of chunks and then gathers
+// them in CRS format. The traversal is only repeated when the pool, sized
+// from the buffer size estimate, is too small.
+template <typename ExecutionSpace, typename Tree, typename Predicates,
+          typename Callback, typename OutputView, typename OffsetView,
+          typename PermuteType>
+void queryImplSinglePass(ExecutionSpace const &space, Tree const &tree,
+                         Predicates const &predicates,
+                         Callback const &callback, OutputView &out,
+                         OffsetView &offset, PermuteType permute,
+                         BufferStatus buffer_status,
+                         Experimental::TraversalPolicy const &policy)
+{
+  // pre-condition: offset is preallocated
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  auto const n_queries = Access::size(predicates);
+
+  Kokkos::Profiling::pushRegion("ArborX::CrsGraphWrapper::single_pass");
+
+  using CountView = OffsetView;
+  auto counts = temporaryView<CountView>(
+      space, policy._workspace, "ArborX::CrsGraphWrapper::counts", n_queries);
+  Kokkos::deep_copy(space, counts, 0);
+
+  using PermutedPredicates =
+      PermutedData<Predicates, PermuteType, true /*AttachIndices*/>;
+  PermutedPredicates permuted_predicates = {predicates, permute};
+
+  using PermutedOffset = PermutedData<OffsetView, PermuteType>;
+  PermutedOffset permuted_offset = {offset, permute};
+
+  using Pool = ResultsPool<OutputView, CountView>;
+  constexpr int chunk_size = Pool::chunk_size;
+  Pool pool;
+  pool._num_chunks = decltype(pool._num_chunks)(Kokkos::view_alloc(
+      space, "ArborX::CrsGraphWrapper::single_pass::num_chunks"));
+  pool._heads = temporaryView<CountView>(
+      space, policy._workspace, "ArborX::CrsGraphWrapper::single_pass::heads",
+      n_queries);
+  pool._tails = temporaryView<CountView>(
+      space, policy._workspace, "ArborX::CrsGraphWrapper::single_pass::tails",
+      n_queries);
+
+  int num_chunks =
+      n_queries *
+      ((std::max(std::abs(policy._buffer_size), 1) + chunk_size - 1) /
+       chunk_size);
+  while (true)
+  {
+    KokkosExt::reallocWithoutInitializing(space, pool._values,
+                                          num_chunks * chunk_size);
+    KokkosExt::reallocWithoutInitializing(space, pool._next, num_chunks);
+
+    tree.query(
+        space, permuted_predicates,
+        InsertGenerator<SinglePassTag, PermutedPredicates, Callback,
+                        OutputView, CountView, PermutedOffset>{
+            callback, out, counts, permuted_offset, pool},
+        Experimental::TraversalPolicy(policy).setPredicateSorting(false));
+
+    int num_chunks_needed = 0;
+    Kokkos::parallel_reduce(
+        "ArborX::CrsGraphWrapper::single_pass::count_chunks",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+        KOKKOS_LAMBDA(int i, int &update) {
+          update += (counts(i) + chunk_size - 1) / chunk_size;
+        },
+        num_chunks_needed);
+    if (num_chunks_needed <= num_chunks)
+      break;
+
+    // If it was hard preallocation, we simply throw
+    ARBORX_ASSERT(buffer_status != BufferStatus::PreallocationHard);
+
+    // Otherwise, traverse again with a pool that is large enough
+    num_chunks = num_chunks_needed;
+    Kokkos::deep_copy(space, counts, 0);
+    Kokkos::deep_copy(space, pool._num_chunks, 0);
+  }
+
+  Kokkos::parallel_for(
+      "ArborX::CrsGraphWrapper::copy_counts_to_offsets",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int const i) { permuted_offset(i) = counts(i); });
+  exclusivePrefixSum(space, offset);
+
+  int const n_results = KokkosExt::lastElement(space, offset);
+  KokkosExt::reallocWithoutInitializing(space, out, n_results);
+
+  Kokkos::parallel_for(
+      "ArborX::CrsGraphWrapper::single_pass::gather_values",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int i) {
+        int const offset_i = permuted_offset(i);
+        int chunk = pool._heads(i);
+        for (int j = 0; j < counts(i); ++j)
+        {
+          if (j > 0 && j % chunk_size == 0)
+            chunk = pool._next(chunk);
+          out(offset_i + j) = pool._values(chunk * chunk_size + j % chunk_size);
+        }
+      });
+
+  Kokkos::Profiling::popRegion();
+}
 
 template <typename ExecutionSpace, typename Tree, typename Predicates,
           typename Callback, typename OutputView, typename OffsetView,
@@ -133,21 +610,53 @@ template <typename ExecutionSpace, typename Tree, typename Predicates,
 void queryImpl(ExecutionSpace const &space, Tree const &tree,
                Predicates const &predicates, Callback const &callback,
                OutputView &out, OffsetView &offset, PermuteType permute,
-               BufferStatus buffer_status)
+               BufferStatus buffer_status,
+               Experimental::TraversalPolicy const &policy =
+                   Experimental::TraversalPolicy())
 {
   // pre-condition: offset and out are preallocated. If buffer_size > 0, offset
   // is pre-initialized
 
   static_assert(Kokkos::is_execution_space<ExecutionSpace>{});
 
+  if (policy._future)
+  {
+    queryImplAsync(space, tree, predicates, callback, out, offset, permute,
+                   policy);
+    return;
+  }
+  if (policy._max_results_per_predicate > 0)
+  {
+    queryImplCapped(space, tree, predicates, callback, out, offset, permute,
+                    policy);
+    return;
+  }
+  if (policy._single_pass)
+  {
+    queryImplSinglePass(space, tree, predicates, callback, out, offset,
+                        permute, buffer_status, policy);
+    return;
+  }
+
   using Access = AccessTraits<Predicates, PredicatesTag>;
   auto const n_queries = Access::size(predicates);
 
+  // Predicates are already sorted
+  auto const traversal_policy =
+      Experimental::TraversalPolicy(policy).setPredicateSorting(false);
+
   Kokkos::Profiling::pushRegion("ArborX::CrsGraphWrapper::two_pass");
 
+  // Storage preallocated for the first pass, to be compared with the number
+  // of results
+  KokkosExt::markProfileEvent(
+      "ArborX::CrsGraphWrapper::two_pass::buffer_capacity",
+      buffer_status != BufferStatus::PreallocationNone ? out.extent(0) : 0);
+
   using CountView = OffsetView;
-  CountView counts(Kokkos::view_alloc(space, "ArborX::CrsGraphWrapper::counts"),
-                   n_queries);
+  auto counts = temporaryView<CountView>(
+      space, policy._workspace, "ArborX::CrsGraphWrapper::counts", n_queries);
+  Kokkos::deep_copy(space, counts, 0);
 
   using PermutedPredicates =
       PermutedData<Predicates, PermuteType, true /*AttachIndices*/>;
@@ -156,9 +665,6 @@ void queryImpl(ExecutionSpace const &space, Tree const &tree,
   using PermutedOffset = PermutedData<OffsetView, PermuteType>;
   PermutedOffset permuted_offset = {offset, permute};
 
-  constexpr bool Legacy =
-      Kokkos::is_detected_v<LegacyTreeArchetypeExpression, Tree>;
-
   Kokkos::Profiling::pushRegion(
       "ArborX::CrsGraphWrapper::two_pass::first_pass");
   bool underflow = false;
@@ -168,9 +674,9 @@ void queryImpl(ExecutionSpace const &space, Tree const &tree,
     tree.query(
         space, permuted_predicates,
         InsertGenerator<FirstPassTag, PermutedPredicates, Callback, OutputView,
-                        CountView, PermutedOffset, Legacy>{
+                        CountView, PermutedOffset>{
             callback, out, counts, permuted_offset},
-        ArborX::Experimental::TraversalPolicy().setPredicateSorting(false));
+        traversal_policy);
 
     // Detecting overflow is a local operation that needs to be done for every
     // index. We allow individual buffer sizes to differ, so it's not as easy
@@ -203,9 +709,9 @@ void queryImpl(ExecutionSpace const &space, Tree const &tree,
     tree.query(
         space, permuted_predicates,
         InsertGenerator<FirstPassNoBufferOptimizationTag, PermutedPredicates,
-                        Callback, OutputView, CountView, PermutedOffset,
-                        Legacy>{callback, out, counts, permuted_offset},
-        ArborX::Experimental::TraversalPolicy().setPredicateSorting(false));
+                        Callback, OutputView, CountView, PermutedOffset>{
+            callback, out, counts, permuted_offset},
+        traversal_policy);
     // This may not be true, but it does not matter. As long as we have
     // (n_results == 0) check before second pass, this value is not used.
     // Otherwise, we know it's overflowed as there is no allocation.
@@ -233,6 +739,11 @@ void queryImpl(ExecutionSpace const &space, Tree const &tree,
 
   Kokkos::Profiling::popRegion();
 
+  KokkosExt::markProfileEvent(
+      "ArborX::CrsGraphWrapper::two_pass::second_pass",
+      n_results > 0 &&
+          (overflow || buffer_status == BufferStatus::PreallocationNone));
+
   if (n_results == 0)
   {
     // Exit early if either no results were found for any of the queries, or
@@ -265,9 +776,9 @@ void queryImpl(ExecutionSpace const &space, Tree const &tree,
     tree.query(
         space, permuted_predicates,
         InsertGenerator<SecondPassTag, PermutedPredicates, Callback, OutputView,
-                        CountView, PermutedOffset, Legacy>{
+                        CountView, PermutedOffset>{
             callback, out, counts, permuted_offset},
-        ArborX::Experimental::TraversalPolicy().setPredicateSorting(false));
+        traversal_policy);
 
     Kokkos::Profiling::popRegion();
   }
@@ -313,14 +824,22 @@ std::enable_if_t<std::is_same_v<Tag, SpatialPredicateTag> ||
                  std::is_same_v<Tag, Experimental::OrderedSpatialPredicateTag>>
 allocateAndInitializeStorage(Tag, ExecutionSpace const &space,
                              Predicates const &predicates, OffsetView &offset,
-                             OutView &out, int buffer_size)
+                             OutView &out,
+                             Experimental::TraversalPolicy const &policy)
 {
   using Access = AccessTraits<Predicates, PredicatesTag>;
 
   auto const n_queries = Access::size(predicates);
   KokkosExt::reallocWithoutInitializing(space, offset, n_queries + 1);
 
-  buffer_size = std::abs(buffer_size);
+  // The storage for the results is allocated once they are all found
+  if (policy._single_pass)
+    return;
+
+  // The results of a predicate are written to a buffer of the maximum size
+  int const buffer_size = (policy._max_results_per_predicate > 0
+                               ? policy._max_results_per_predicate
+                               : std::abs(policy._buffer_size));
 
   Kokkos::deep_copy(space, offset, buffer_size);
 
@@ -339,7 +858,8 @@ template <typename Tag, typename ExecutionSpace, typename Predicates,
 std::enable_if_t<std::is_same_v<Tag, NearestPredicateTag>>
 allocateAndInitializeStorage(Tag, ExecutionSpace const &space,
                              Predicates const &predicates, OffsetView &offset,
-                             OutView &out, int /*buffer_size*/)
+                             OutView &out,
+                             Experimental::TraversalPolicy const &policy)
 {
   using Access = AccessTraits<Predicates, PredicatesTag>;
 
@@ -353,8 +873,180 @@ allocateAndInitializeStorage(Tag, ExecutionSpace const &space,
       KOKKOS_LAMBDA(int i) { offset(i) = getK(Access::get(predicates, i)); });
   exclusivePrefixSum(space, offset);
 
-  KokkosExt::reallocWithoutInitializing(space, out,
-                                        KokkosExt::lastElement(space, offset));
+  // Use the number of neighbors when it is known to avoid copying the last
+  // offset to the host
+  constexpr int fixed_k = fixed_number_of_neighbors_v<
+      std::decay_t<decltype(Access::get(predicates, 0))>>;
+  int const k = fixed_k > 0 ? fixed_k : policy._number_of_neighbors;
+  KokkosExt::reallocWithoutInitializing(
+      space, out,
+      k > 0 ? n_queries * k : KokkosExt::lastElement(space, offset));
+}
+
+// Number of predicates per batch, either given by the policy or chosen to
+// fit the temporary storage of the traversal of a batch in its limit. Zero
+// means that the predicates are not batched.
+template <typename Tag, typename ExecutionSpace, typename Predicates>
+int batchSize(Tag, ExecutionSpace const &space, Predicates const &predicates,
+              Experimental::TraversalPolicy const &policy)
+{
+  if (policy._batch_size > 0 || policy._temporary_memory_limit == 0)
+    return policy._batch_size;
+
+  // Ordering of the predicates, and the storage to sort it
+  std::size_t bytes_per_predicate = 0;
+  if (policy._sort_predicates)
+    bytes_per_predicate +=
+        sizeof(unsigned int) + sortObjectsMemory<unsigned int>(1);
+  if constexpr (std::is_same_v<Tag, NearestPredicateTag>)
+  {
+    // Heaps of the nearest neighbors found so far, and their offsets
+    int k = policy._number_of_neighbors;
+    if (k <= 0)
+    {
+      using Access = AccessTraits<Predicates, PredicatesTag>;
+      Kokkos::parallel_reduce(
+          "ArborX::CrsGraphWrapper::batched::find_max_number_of_neighbors",
+          Kokkos::RangePolicy<ExecutionSpace>(space, 0,
+                                              Access::size(predicates)),
+          KOKKOS_LAMBDA(int i, int &update) {
+            update = KokkosExt::max(update, getK(Access::get(predicates, i)));
+          },
+          Kokkos::Max<int>(k));
+      bytes_per_predicate += sizeof(int);
+    }
+    if (!policy._nearest_scratch_memory)
+      bytes_per_predicate += k * sizeof(Kokkos::pair<int, float>);
+  }
+  if (bytes_per_predicate == 0)
+    return 0;
+  return std::max<std::size_t>(
+      1, policy._temporary_memory_limit / bytes_per_predicate);
+}
+
+// Traverse the predicates in batches, twice. The results are counted batch
+// by batch first, and are then written batch by batch at their final
+// location in the output. Only the ordering of the predicates, and not the
+// storage to compute it, is kept for all the batches between the two.
+template <typename ExecutionSpace, typename Tree, typename Predicates,
+          typename Callback, typename OutputView, typename OffsetView>
+void queryBatched(ExecutionSpace const &space, Tree const &tree,
+                  Predicates const &predicates, Callback const &callback,
+                  OutputView &out, OffsetView &offset, int batch_size,
+                  Experimental::TraversalPolicy const &policy)
+{
+  using MemorySpace = typename Tree::memory_space;
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  int const n_queries = Access::size(predicates);
+
+  Kokkos::Profiling::pushRegion("ArborX::CrsGraphWrapper::batched");
+
+  Kokkos::Profiling::pushRegion(
+      "ArborX::CrsGraphWrapper::batched::compute_permutations");
+
+  using bounding_volume_type = std::decay_t<decltype(tree.bounds())>;
+  ExperimentalHyperGeometry::Box<
+      GeometryTraits::dimension_v<bounding_volume_type>,
+      typename GeometryTraits::coordinate_type<bounding_volume_type>::type>
+      scene_bounding_box{};
+  expand(scene_bounding_box, tree.bounds());
+
+  std::vector<BatchIndices<DeviceType>> batches;
+  for (int begin = 0; begin < n_queries; begin += batch_size)
+  {
+    int const size = std::min(batch_size, n_queries - begin);
+    BatchIndices<DeviceType> indices{begin, {}};
+    if (policy._sort_predicates)
+      indices._permute = BatchedQueries<DeviceType>::sortPredicates(
+          space, policy._hilbert_predicate_sorting, scene_bounding_box,
+          PredicatesBatch<Predicates, DeviceType>{predicates, indices, size});
+    batches.push_back(indices);
+  }
+
+  Kokkos::Profiling::popRegion();
+
+  using BatchPredicates = PredicatesBatch<Predicates, DeviceType, true>;
+  using CountView = OffsetView;
+  using PermutedOffset = PermutedData<OffsetView, BatchIndices<DeviceType>>;
+
+  // Predicates are already sorted within each batch
+  auto const traversal_policy = Experimental::TraversalPolicy(policy)
+                                    .setPredicateSorting(false)
+                                    .setBatchSize(0)
+                                    .setTemporaryMemoryLimit(0);
+
+  // Counts of the results of the predicates of a batch, in the order they
+  // are traversed
+  CountView counts(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                      "ArborX::CrsGraphWrapper::counts"),
+                   batch_size);
+
+  Kokkos::Profiling::pushRegion("ArborX::CrsGraphWrapper::batched::count");
+
+  KokkosExt::reallocWithoutInitializing(space, offset, n_queries + 1);
+  for (auto const &indices : batches)
+  {
+    int const size = std::min(batch_size, n_queries - indices._begin);
+    Kokkos::deep_copy(space, counts, 0);
+    tree.query(space, BatchPredicates{predicates, indices, size},
+               InsertGenerator<FirstPassNoBufferOptimizationTag,
+                               BatchPredicates, Callback, OutputView,
+                               CountView, PermutedOffset>{
+                   callback, out, counts, PermutedOffset{offset, indices}},
+               traversal_policy);
+    Kokkos::parallel_for(
+        "ArborX::CrsGraphWrapper::copy_counts_to_offsets",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, size),
+        KOKKOS_LAMBDA(int const i) { offset(indices(i)) = counts(i); });
+  }
+  exclusivePrefixSum(space, offset);
+  int const n_results = KokkosExt::lastElement(space, offset);
+
+  Kokkos::Profiling::popRegion();
+  Kokkos::Profiling::pushRegion("ArborX::CrsGraphWrapper::batched::fill");
+
+  KokkosExt::reallocWithoutInitializing(space, out, n_results);
+  for (auto const &indices : batches)
+  {
+    int const size = std::min(batch_size, n_queries - indices._begin);
+    // The offsets of the predicates are advanced as their results are
+    // written
+    Kokkos::parallel_for(
+        "ArborX::CrsGraphWrapper::copy_offsets_to_counts",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, size),
+        KOKKOS_LAMBDA(int const i) { counts(i) = offset(indices(i)); });
+    tree.query(space, BatchPredicates{predicates, indices, size},
+               InsertGenerator<SecondPassTag, BatchPredicates, Callback,
+                               OutputView, CountView, PermutedOffset>{
+                   callback, out, counts, PermutedOffset{offset, indices}},
+               traversal_policy);
+  }
+
+  Kokkos::Profiling::popRegion();
+  Kokkos::Profiling::popRegion();
+}
+
+// Sort the results of each predicate by increasing distance in place, see
+// Experimental::WithDistances
+template <typename ExecutionSpace, typename OutputView, typename OffsetView>
+void sortResultsByDistance(ExecutionSpace const &space, int n_queries,
+                           OutputView const &out, OffsetView const &offset)
+{
+  Kokkos::parallel_for(
+      "ArborX::CrsGraphWrapper::sort_results_by_distance",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int i) {
+        using Value = typename OutputView::value_type;
+        auto const compare = [](Value const &a, Value const &b) {
+          return a.second < b.second ||
+                 (a.second == b.second && a.first < b.first);
+        };
+        auto *const first = out.data() + offset(i);
+        auto *const last = out.data() + offset(i + 1);
+        makeHeap(first, last, compare);
+        sortHeap(first, last, compare);
+      });
 }
 
 // Views are passed by reference here because internally Kokkos::realloc()
@@ -373,7 +1065,17 @@ queryDispatch(Tag, Tree const &tree, ExecutionSpace const &space,
   using MemorySpace = typename Tree::memory_space;
   using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
 
-  check_valid_callback(callback, predicates, out);
+  constexpr bool with_distances =
+      std::is_same_v<Callback, Experimental::WithDistances>;
+  if constexpr (with_distances)
+    static_assert(std::is_same_v<typename OutputView::value_type,
+                                 Kokkos::pair<int, float>>,
+                  "The output of the distances must hold pairs of an index "
+                  "and a distance");
+  else
+    check_valid_callback(callback, predicates, out);
+  auto const n_queries =
+      AccessTraits<Predicates, PredicatesTag>::size(predicates);
 
   std::string profiling_prefix = "ArborX::CrsGraphWrapper::query::";
   if constexpr (std::is_same_v<Tag, SpatialPredicateTag>)
@@ -395,11 +1097,60 @@ queryDispatch(Tag, Tree const &tree, ExecutionSpace const &space,
   }
 
   Kokkos::Profiling::pushRegion(profiling_prefix);
+  KokkosExt::markProfileEvent(profiling_prefix + "::predicates", n_queries);
+
+  // Only spatial predicates cap their numbers of results
+  bool const capped = (std::is_same_v<Tag, SpatialPredicateTag> &&
+                       policy._max_results_per_predicate > 0);
+  if (capped)
+  {
+    // The results are compacted once found, which synchronizes with the host
+    ARBORX_ASSERT(!policy._future);
+  }
+
+  int const batch_size = batchSize(Tag{}, space, predicates, policy);
+  if (!capped && batch_size > 0 && batch_size < (int)n_queries)
+  {
+    // The sizes of the outputs of the batches cannot be known in advance
+    ARBORX_ASSERT(!policy._future);
+    queryBatched(space, tree, predicates, callback, out, offset, batch_size,
+                 policy);
+    if constexpr (with_distances)
+      if (callback._sort_by_distance)
+        sortResultsByDistance(space, n_queries, out, offset);
+    KokkosExt::markProfileEvent(profiling_prefix + "::results", out.extent(0));
+    Kokkos::Profiling::popRegion();
+    return;
+  }
 
   Kokkos::Profiling::pushRegion(profiling_prefix + "::init_and_alloc");
 
+  if (policy._future)
+  {
+    // Every size must be known in advance to avoid waiting for the device
+    if constexpr (std::is_same_v<Tag, NearestPredicateTag>)
+    {
+      using Predicate = std::decay_t<decltype(
+          AccessTraits<Predicates, PredicatesTag>::get(predicates, 0))>;
+      ARBORX_ASSERT(policy._number_of_neighbors > 0 ||
+                    fixed_number_of_neighbors_v<Predicate> > 0);
+    }
+    else
+    {
+      ARBORX_ASSERT(policy._buffer_size != 0);
+    }
+  }
+
+  // Nearest predicates already gather their results in a single pass
+  auto const impl_policy =
+      Experimental::TraversalPolicy(policy)
+          .setSinglePass(policy._single_pass && !policy._future &&
+                         !std::is_same_v<Tag, NearestPredicateTag> && !capped)
+          .setMaxResultsPerPredicate(
+              capped ? policy._max_results_per_predicate : 0);
+
   allocateAndInitializeStorage(Tag{}, space, predicates, offset, out,
-                               policy._buffer_size);
+                               impl_policy);
 
   Kokkos::Profiling::popRegion();
 
@@ -407,31 +1158,46 @@ queryDispatch(Tag, Tree const &tree, ExecutionSpace const &space,
                             ? toBufferStatus(policy._buffer_size)
                             : BufferStatus::PreallocationSoft);
 
-  if (policy._sort_predicates)
+  using bounding_volume_type = std::decay_t<decltype(tree.bounds())>;
+  ExperimentalHyperGeometry::Box<
+      GeometryTraits::dimension_v<bounding_volume_type>,
+      typename GeometryTraits::coordinate_type<bounding_volume_type>::type>
+      scene_bounding_box{};
+  expand(scene_bounding_box, tree.bounds());
+
+  // Sorting may need to synchronize with the host, which replayed queries
+  // only do on their first call as the permutation is kept in the plan
+  bool const sort_predicates =
+      (!policy._future || policy._query_plan) &&
+      BatchedQueries<DeviceType>::sortsPredicates(
+          space, policy, scene_bounding_box, predicates, profiling_prefix);
+  KokkosExt::markProfileEvent(profiling_prefix + "::sorted_predicates",
+                              sort_predicates);
+  if (sort_predicates)
   {
     Kokkos::Profiling::pushRegion(profiling_prefix + "::compute_permutation");
-    using bounding_volume_type = std::decay_t<decltype(tree.bounds())>;
-    ExperimentalHyperGeometry::Box<
-        GeometryTraits::dimension_v<bounding_volume_type>,
-        typename GeometryTraits::coordinate_type<bounding_volume_type>::type>
-        scene_bounding_box{};
-    using namespace Details;
-    expand(scene_bounding_box, tree.bounds());
-    auto permute = Details::BatchedQueries<DeviceType>::
-        sortPredicatesAlongSpaceFillingCurve(space, Experimental::Morton32(),
-                                             scene_bounding_box, predicates);
+    auto permute = Details::BatchedQueries<DeviceType>::sortPredicates(
+        space, policy, scene_bounding_box, predicates);
     Kokkos::Profiling::popRegion();
 
     queryImpl(space, tree, predicates, callback, out, offset, permute,
-              buffer_status);
+              buffer_status, impl_policy);
   }
   else
   {
     Iota permute;
     queryImpl(space, tree, predicates, callback, out, offset, permute,
-              buffer_status);
+              buffer_status, impl_policy);
   }
 
+  if constexpr (with_distances)
+    if (callback._sort_by_distance)
+      sortResultsByDistance(space, n_queries, out, offset);
+
+  // Asynchronous queries only know their numbers of results once waited for
+  if (!policy._future)
+    KokkosExt::markProfileEvent(profiling_prefix + "::results", out.extent(0));
+
   Kokkos::Profiling::popRegion();
 }
 
@@ -484,6 +1250,14 @@ check_valid_callback_if_first_argument_is_not_a_view(Callback const &,
   // TODO
 }
 
+template <typename Predicates, typename OutputView>
+void check_valid_callback_if_first_argument_is_not_a_view(
+    Experimental::WithDistances const &, Predicates const &,
+    OutputView const &)
+{
+  // checked when dispatching
+}
+
 template <typename View, typename Predicates, typename OutputView>
 std::enable_if_t<Kokkos::is_view_v<View>>
 check_valid_callback_if_first_argument_is_not_a_view(View const &,
@@ -12,6 +12,7 @@
 #ifndef ARBORX_DETAILS_DENDROGRAM_HPP
 #define ARBORX_DETAILS_DENDROGRAM_HPP
 
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
 #include <ArborX_DetailsKokkosExtViewHelpers.hpp>
 #include <ArborX_DetailsUnionFind.hpp>
 #include <ArborX_DetailsUtils.hpp> // iota
@@ -117,6 +118,131 @@ void dendrogramUnionFind(
   Kokkos::Profiling::popRegion();
 }
 
+// Parallel counterpart of dendrogramUnionFind. The children of an edge e are
+// the top nodes (the largest edge, or the vertex itself if alone) of the
+// components of its endpoints in the forest of the edges preceding e. They
+// are found by divide and conquer over chunks of consecutive edges. Each
+// chunk is split into two halves, and the endpoints of the edges of the upper
+// half are relabeled with the top nodes of their components in the lower
+// half, computed by a union-find. The halves are then processed recursively,
+// level by level, until all chunks are single edges, at which point the
+// labels are the children.
+//
+// Using the top nodes as labels makes the components of the lower halves of
+// the different chunks of a level disjoint, so that a single union-find can
+// process all of them at once. This takes log(n) levels of O(n) work each.
+template <typename ExecutionSpace, typename MemorySpace>
+void dendrogramParallelUnionFind(
+    ExecutionSpace const &exec_space,
+    Kokkos::View<UnweightedEdge const *, MemorySpace> sorted_edges,
+    Kokkos::View<int *, MemorySpace> &parents)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::Dendrogram::dendrogram_parallel_union_find");
+
+  int const num_edges = sorted_edges.size();
+  int const num_vertices = num_edges + 1;
+  int const num_nodes = num_edges + num_vertices;
+  auto const vertices_offset = num_edges;
+
+  constexpr int UNDEFINED = -1;
+  if (num_edges == 0)
+  {
+    Kokkos::deep_copy(exec_space, parents, UNDEFINED);
+    return;
+  }
+
+  Kokkos::View<int *[2], MemorySpace> children(
+      Kokkos::view_alloc(
+          exec_space, Kokkos::WithoutInitializing,
+          "ArborX::Dendrogram::dendrogram_parallel_union_find::children"),
+      num_edges);
+  Kokkos::parallel_for(
+      "ArborX::Dendrogram::dendrogram_parallel_union_find::init_children",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+      KOKKOS_LAMBDA(int e) {
+        children(e, 0) = vertices_offset + sorted_edges(e).source;
+        children(e, 1) = vertices_offset + sorted_edges(e).target;
+      });
+
+  Kokkos::View<int *, MemorySpace> labels(
+      Kokkos::view_alloc(
+          exec_space, Kokkos::WithoutInitializing,
+          "ArborX::Dendrogram::dendrogram_parallel_union_find::labels"),
+      num_nodes);
+  iota(exec_space, labels);
+  UnionFind<MemorySpace> union_find(labels);
+
+  // Largest edge of each component, indexed by its representative
+  Kokkos::View<int *, MemorySpace> tops(
+      Kokkos::view_alloc(
+          exec_space, Kokkos::WithoutInitializing,
+          "ArborX::Dendrogram::dendrogram_parallel_union_find::tops"),
+      num_nodes);
+  Kokkos::deep_copy(exec_space, tops, UNDEFINED);
+
+  int chunk_size = 1;
+  while (chunk_size < num_edges)
+    chunk_size *= 2;
+  for (; chunk_size > 1; chunk_size /= 2)
+  {
+    int const half = chunk_size / 2;
+
+    Kokkos::parallel_for(
+        "ArborX::Dendrogram::dendrogram_parallel_union_find::merge",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+        KOKKOS_LAMBDA(int e) {
+          if (e % chunk_size < half)
+            union_find.merge(children(e, 0), children(e, 1));
+        });
+    Kokkos::parallel_for(
+        "ArborX::Dendrogram::dendrogram_parallel_union_find::find_tops",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+        KOKKOS_LAMBDA(int e) {
+          if (e % chunk_size < half)
+            Kokkos::atomic_max(
+                &tops(union_find.representative(children(e, 0))), e);
+        });
+    Kokkos::parallel_for(
+        "ArborX::Dendrogram::dendrogram_parallel_union_find::relabel",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+        KOKKOS_LAMBDA(int e) {
+          if (e % chunk_size < half)
+            return;
+          for (int k = 0; k < 2; ++k)
+          {
+            int const top = tops(union_find.representative(children(e, k)));
+            if (top != UNDEFINED)
+              children(e, k) = top;
+          }
+        });
+    // Only the labels of the lower halves were touched
+    Kokkos::parallel_for(
+        "ArborX::Dendrogram::dendrogram_parallel_union_find::reset",
+        Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+        KOKKOS_LAMBDA(int e) {
+          if (e % chunk_size >= half)
+            return;
+          for (int k = 0; k < 2; ++k)
+          {
+            int const node = children(e, k);
+            labels(node) = node;
+            tops(node) = UNDEFINED;
+          }
+        });
+  }
+
+  Kokkos::parallel_for(
+      "ArborX::Dendrogram::dendrogram_parallel_union_find::set_parents",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_edges),
+      KOKKOS_LAMBDA(int e) {
+        parents(children(e, 0)) = e;
+        parents(children(e, 1)) = e;
+        if (e == num_edges - 1)
+          parents(e) = UNDEFINED; // root
+      });
+}
+
 } // namespace ArborX::Details
 
 #endif
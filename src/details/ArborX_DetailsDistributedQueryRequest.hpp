@@ -0,0 +1,323 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_DISTRIBUTED_QUERY_REQUEST_HPP
+#define ARBORX_DETAILS_DISTRIBUTED_QUERY_REQUEST_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsDistributedTreeImpl.hpp> // countResults, sortResults
+#include <ArborX_DetailsDistributor.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp>
+#include <ArborX_DetailsUtils.hpp> // exclusivePrefixSum
+#include <ArborX_Exception.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_PairIndexRank.hpp>
+#include <ArborX_Predicates.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+namespace ArborX::Experimental
+{
+
+// Spatial queries of a DistributedTree in flight, as started by
+// DistributedTree::queryAsync(). The queries have been sent to the processes
+// they intersect. Each call to test() advances the remaining stages for which
+// the messages have arrived, without blocking:
+// 1. perform the queries received from the other processes, and send back the
+//    numbers of results of each,
+// 2. send back the results, whose sizes are then known on both sides,
+// 3. order the results received by query.
+// The patterns of the last two stages are the reverse of the one of the
+// queries, so that the processes need not discover each other again.
+template <typename ExecutionSpace, typename MemorySpace, typename Query>
+class DistributedQueryRequest
+{
+  using DeviceType = Kokkos::Device<ExecutionSpace, MemorySpace>;
+  using ForwardedQuery = decltype(attach(std::declval<Query const &>(), 0));
+
+public:
+  template <typename Predicates>
+  DistributedQueryRequest(MPI_Comm comm, ExecutionSpace const &space,
+                          BVH<MemorySpace> const &bottom_tree,
+                          Predicates const &queries,
+                          Kokkos::View<int *, DeviceType> const &ranks,
+                          Kokkos::View<int *, DeviceType> const &offset);
+
+  // Returns whether the queries are complete, without blocking
+  bool test()
+  {
+    while (_stage != Stage::DONE)
+    {
+      if (!_request.test())
+        return false;
+      advance();
+    }
+    return true;
+  }
+
+  void wait()
+  {
+    while (_stage != Stage::DONE)
+    {
+      _request.wait();
+      advance();
+    }
+  }
+
+  // Results of the queries in compressed row format, once complete
+  Kokkos::View<PairIndexRank *, DeviceType> const &values() const
+  {
+    ARBORX_ASSERT(_stage == Stage::DONE);
+    return _values;
+  }
+  Kokkos::View<int *, DeviceType> const &offsets() const
+  {
+    ARBORX_ASSERT(_stage == Stage::DONE);
+    return _offsets;
+  }
+
+#ifndef KOKKOS_COMPILER_NVCC
+private:
+#endif
+  enum class Stage
+  {
+    FORWARDING_QUERIES,
+    RETURNING_COUNTS,
+    RETURNING_RESULTS,
+    DONE
+  };
+
+  void advance()
+  {
+    switch (_stage)
+    {
+    case Stage::FORWARDING_QUERIES:
+      performForwardedQueries();
+      _stage = Stage::RETURNING_COUNTS;
+      break;
+    case Stage::RETURNING_COUNTS:
+      returnResults();
+      _stage = Stage::RETURNING_RESULTS;
+      break;
+    case Stage::RETURNING_RESULTS:
+      sortReturnedResults();
+      _stage = Stage::DONE;
+      break;
+    case Stage::DONE:
+      break;
+    }
+  }
+
+  void performForwardedQueries();
+  void returnResults();
+  void sortReturnedResults();
+
+  MPI_Comm _comm;
+  // Tag of all the messages of the request, whose stages follow each other
+  int _tag;
+  ExecutionSpace _space;
+  BVH<MemorySpace> _bottom_tree;
+  int _n_queries;
+  Stage _stage = Stage::FORWARDING_QUERIES;
+  Details::Distributor<DeviceType> _forward_distributor;
+  Details::Distributor<DeviceType> _reverse_distributor;
+  Details::DistributorRequest _request;
+  Kokkos::View<ForwardedQuery *, DeviceType> _fwd_queries;
+  // Ids of the queries and their numbers of results, in the order of the
+  // queries sent
+  Kokkos::View<Kokkos::pair<int, int> *, DeviceType> _ids_and_counts;
+  // Numbers of results sent back to the sources of the queries
+  std::vector<int> _result_counts;
+  // Results of the queries received, then of the queries sent
+  Kokkos::View<PairIndexRank *, DeviceType> _values;
+  Kokkos::View<int *, DeviceType> _offsets;
+};
+
+template <typename ExecutionSpace, typename MemorySpace, typename Query>
+template <typename Predicates>
+DistributedQueryRequest<ExecutionSpace, MemorySpace, Query>::
+    DistributedQueryRequest(MPI_Comm comm, ExecutionSpace const &space,
+                            BVH<MemorySpace> const &bottom_tree,
+                            Predicates const &queries,
+                            Kokkos::View<int *, DeviceType> const &ranks,
+                            Kokkos::View<int *, DeviceType> const &offset)
+    : _comm(comm)
+    , _tag(Details::nextAsyncTag(comm))
+    , _space(space)
+    , _bottom_tree(bottom_tree)
+    , _n_queries(AccessTraits<Predicates, PredicatesTag>::size(queries))
+    , _forward_distributor(comm)
+    , _reverse_distributor(comm)
+    , _fwd_queries("ArborX::DistributedTree::queryAsync::fwd_queries", 0)
+    , _ids_and_counts("ArborX::DistributedTree::queryAsync::ids_and_counts",
+                      0)
+    , _values("ArborX::DistributedTree::queryAsync::values", 0)
+    , _offsets("ArborX::DistributedTree::queryAsync::offsets", 0)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::queryAsync::forward_queries");
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(std::is_same_v<
+                Query, typename Details::AccessTraitsHelper<Access>::type>);
+
+  int const n_queries = _n_queries;
+  int const n_exports = KokkosExt::lastElement(space, offset);
+  int const n_imports = _forward_distributor.createFromSends(space, ranks);
+
+  // The queries are sent along with their ids
+  Kokkos::View<ForwardedQuery *, DeviceType> exports(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::queryAsync::exports"),
+      n_exports);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::queryAsync::fill_exports",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        for (int i = offset(q); i < offset(q + 1); ++i)
+          exports(i) = attach(Access::get(queries, q), q);
+      });
+  KokkosExt::reallocWithoutInitializing(space, _fwd_queries, n_imports);
+  _request =
+      _forward_distributor.doPosts(space, exports, 1, _fwd_queries, _tag);
+}
+
+template <typename ExecutionSpace, typename MemorySpace, typename Query>
+void DistributedQueryRequest<ExecutionSpace, MemorySpace,
+                             Query>::performForwardedQueries()
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::queryAsync::perform_queries");
+
+  auto const &space = _space;
+  int comm_rank;
+  MPI_Comm_rank(_comm, &comm_rank);
+
+  Kokkos::View<int *, DeviceType> fwd_offset(
+      "ArborX::DistributedTree::queryAsync::fwd_offset", 0);
+  _bottom_tree.query(space, _fwd_queries,
+                     Details::DefaultCallbackWithRank{comm_rank}, _values,
+                     fwd_offset);
+
+  int const n_fwd_queries = _fwd_queries.extent(0);
+  Kokkos::View<Kokkos::pair<int, int> *, DeviceType> ids_and_counts(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         _ids_and_counts.label()),
+      n_fwd_queries);
+  auto const &fwd_queries = _fwd_queries;
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::queryAsync::fill_ids_and_counts",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_fwd_queries),
+      KOKKOS_LAMBDA(int q) {
+        ids_and_counts(q) = {getData(fwd_queries(q)),
+                             fwd_offset(q + 1) - fwd_offset(q)};
+      });
+
+  // The queries received from a source are contiguous, and so are their
+  // results
+  auto const fwd_offset_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, fwd_offset);
+  auto const &src_offsets = _forward_distributor.getSourceOffsets();
+  _result_counts.resize(_forward_distributor.getSources().size());
+  for (int i = 0; i < (int)_result_counts.size(); ++i)
+    _result_counts[i] = fwd_offset_host(src_offsets[i + 1]) -
+                        fwd_offset_host(src_offsets[i]);
+
+  _reverse_distributor.createReverse(_forward_distributor);
+  KokkosExt::reallocWithoutInitializing(
+      space, _ids_and_counts, _forward_distributor.getTotalSendLength());
+  _request = _reverse_distributor.doPosts(space, ids_and_counts, 1,
+                                         _ids_and_counts, _tag);
+  _fwd_queries = {};
+}
+
+template <typename ExecutionSpace, typename MemorySpace, typename Query>
+void DistributedQueryRequest<ExecutionSpace, MemorySpace,
+                             Query>::returnResults()
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::queryAsync::return_results");
+
+  auto const &space = _space;
+
+  // The numbers of results received from each destination of the queries
+  auto const ids_and_counts_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, _ids_and_counts);
+  auto const &dest_offsets = _forward_distributor.getDestinationOffsets();
+  std::vector<int> received_counts(
+      _forward_distributor.getDestinations().size(), 0);
+  for (int i = 0; i < (int)received_counts.size(); ++i)
+    for (int j = dest_offsets[i]; j < dest_offsets[i + 1]; ++j)
+      received_counts[i] += ids_and_counts_host(j).second;
+
+  int const n_imports = _reverse_distributor.createReverse(
+      _forward_distributor, std::move(_result_counts),
+      std::move(received_counts));
+  Kokkos::View<PairIndexRank *, DeviceType> imports(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing, _values.label()),
+      n_imports);
+  _request = _reverse_distributor.doPosts(space, _values, 1, imports, _tag);
+  _values = imports;
+}
+
+template <typename ExecutionSpace, typename MemorySpace, typename Query>
+void DistributedQueryRequest<ExecutionSpace, MemorySpace,
+                             Query>::sortReturnedResults()
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::queryAsync::sort_results");
+
+  auto const &space = _space;
+
+  // The results come in the same order as the numbers of results per query
+  auto const &ids_and_counts = _ids_and_counts;
+  int const n_returned_queries = ids_and_counts.extent(0);
+  Kokkos::View<int *, DeviceType> returned_offset(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::DistributedTree::queryAsync::returned_offset"),
+      n_returned_queries + 1);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::queryAsync::copy_counts",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_returned_queries),
+      KOKKOS_LAMBDA(int q) {
+        returned_offset(q) = ids_and_counts(q).second;
+      });
+  exclusivePrefixSum(space, returned_offset);
+
+  Kokkos::View<int *, DeviceType> ids(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::queryAsync::query_ids"),
+      _values.extent(0));
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::queryAsync::expand_ids",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_returned_queries),
+      KOKKOS_LAMBDA(int q) {
+        for (int i = returned_offset(q); i < returned_offset(q + 1); ++i)
+          ids(i) = ids_and_counts(q).first;
+      });
+
+  using Impl = Details::DistributedTreeImpl<DeviceType>;
+  Impl::countResults(space, _n_queries, ids, _offsets);
+  Impl::sortResults(space, ids, _values);
+  _ids_and_counts = {};
+}
+
+} // namespace ArborX::Experimental
+
+#endif
@@ -29,10 +29,28 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <vector>
+
 #include <mpi.h>
 
 namespace ArborX
 {
+namespace Experimental
+{
+// How distributed nearest queries are forwarded to the ranks that may hold
+// some of the neighbors
+enum class DistributedNearestStrategy
+{
+  // Forward to the ranks with the k nearest top tree leaves, then again to
+  // all the ranks within the farthest neighbor found. Always two exchanges.
+  TWO_ROUNDS,
+  // Forward once to the ranks within the distance to the k-th nearest local
+  // neighbor. Only the queries with fewer than k local neighbors need a
+  // second exchange.
+  SINGLE_ROUND
+};
+} // namespace Experimental
+
 namespace Details
 {
 using PairIndexRankAndDistance = Kokkos::pair<PairIndexRank, float>;
@@ -148,6 +166,16 @@ struct DistributedTreeImpl
                 ExecutionSpace const &space, Predicates const &queries,
                 Callback const &callback, OutputView &out, OffsetView &offset);
 
+  // ordered spatial queries, e.g. to trace rays
+  template <typename DistributedTree, typename ExecutionSpace,
+            typename Predicates, typename IndicesAndRanks, typename Offset>
+  static std::enable_if_t<Kokkos::is_view<IndicesAndRanks>{} &&
+                          Kokkos::is_view<Offset>{}>
+  queryDispatch(Experimental::OrderedSpatialPredicateTag,
+                DistributedTree const &tree, ExecutionSpace const &space,
+                Predicates const &queries, IndicesAndRanks &values,
+                Offset &offset);
+
   // nearest neighbors queries
   template <typename DistributedTree, typename ExecutionSpace,
             typename Predicates, typename Indices, typename Offset,
@@ -159,7 +187,9 @@ struct DistributedTreeImpl
   queryDispatchImpl(NearestPredicateTag, DistributedTree const &tree,
                     ExecutionSpace const &space, Predicates const &queries,
                     Indices &indices, Offset &offset, Ranks &ranks,
-                    Distances *distances_ptr = nullptr);
+                    Distances *distances_ptr = nullptr,
+                    Experimental::DistributedNearestStrategy strategy =
+                        Experimental::DistributedNearestStrategy::TWO_ROUNDS);
 
   template <typename DistributedTree, typename ExecutionSpace,
             typename Predicates, typename IndicesAndRanks, typename Offset>
@@ -167,14 +197,18 @@ struct DistributedTreeImpl
                           Kokkos::is_view<Offset>{}>
   queryDispatch(NearestPredicateTag tag, DistributedTree const &tree,
                 ExecutionSpace const &space, Predicates const &queries,
-                IndicesAndRanks &values, Offset &offset)
+                IndicesAndRanks &values, Offset &offset,
+                Experimental::DistributedNearestStrategy strategy =
+                    Experimental::DistributedNearestStrategy::TWO_ROUNDS)
   {
     // FIXME avoid zipping when distributed nearest callbacks become available
     Kokkos::View<int *, ExecutionSpace> indices(
         "ArborX::DistributedTree::query::nearest::indices", 0);
     Kokkos::View<int *, ExecutionSpace> ranks(
         "ArborX::DistributedTree::query::nearest::ranks", 0);
-    queryDispatchImpl(tag, tree, space, queries, indices, offset, ranks);
+    Kokkos::View<float *, DeviceType> *no_distances = nullptr;
+    queryDispatchImpl(tag, tree, space, queries, indices, offset, ranks,
+                      no_distances, strategy);
     auto const n = indices.extent(0);
     KokkosExt::reallocWithoutInitializing(space, values, n);
     Kokkos::parallel_for(
@@ -184,6 +218,19 @@ struct DistributedTreeImpl
         });
   }
 
+  // nearest neighbors queries with a callback applied on the ranks owning
+  // the neighbors, so that only its output is communicated back
+  template <typename DistributedTree, typename ExecutionSpace,
+            typename Predicates, typename Callback, typename OutputView,
+            typename OffsetView>
+  static std::enable_if_t<Kokkos::is_view<OutputView>{} &&
+                          Kokkos::is_view<OffsetView>{}>
+  queryDispatch(NearestPredicateTag tag, DistributedTree const &tree,
+                ExecutionSpace const &space, Predicates const &queries,
+                Callback const &callback, OutputView &out, OffsetView &offset,
+                Experimental::DistributedNearestStrategy strategy =
+                    Experimental::DistributedNearestStrategy::TWO_ROUNDS);
+
   template <typename DistributedTree, typename ExecutionSpace,
             typename Predicates, typename Indices, typename Offset,
             typename Distances>
@@ -200,6 +247,48 @@ struct DistributedTreeImpl
                                DistributedTree const &tree, Indices &indices,
                                Offset &offset, Distances &distances);
 
+  template <typename DistributedTree, typename ExecutionSpace,
+            typename Predicates, typename Callback, typename Indices,
+            typename Offset, typename Ranks, typename Distances>
+  static void singleRoundStrategy(ExecutionSpace const &space,
+                                  Predicates const &queries,
+                                  DistributedTree const &tree,
+                                  Callback const &callback_with_distance,
+                                  Indices &indices, Offset &offset,
+                                  Ranks &ranks, Distances &distances);
+
+  template <typename DistributedTree, typename ExecutionSpace,
+            typename Predicates, typename Callback, typename Indices,
+            typename Offset, typename Ranks, typename Distances>
+  static void exchangeNearestQueries(ExecutionSpace const &space,
+                                     Predicates const &queries,
+                                     DistributedTree const &tree,
+                                     Callback const &callback_with_distance,
+                                     Indices &indices, Offset &offset,
+                                     Ranks &ranks, Distances &distances);
+
+  template <typename ExecutionSpace, typename Offset, typename OtherOffset>
+  static Kokkos::View<int *, DeviceType>
+  mergeOffsets(ExecutionSpace const &space,
+               Kokkos::View<int *, DeviceType> positions, Offset const &offset,
+               OtherOffset const &other_offset);
+
+  template <typename ExecutionSpace, typename Offset, typename OtherOffset,
+            typename Values, typename OtherValues>
+  static void mergeValues(ExecutionSpace const &space,
+                          Kokkos::View<int *, DeviceType> positions,
+                          Offset const &offset, OtherOffset const &other_offset,
+                          Kokkos::View<int *, DeviceType> new_offset,
+                          Values &values, OtherValues const &other_values);
+
+  template <typename DistributedTree, typename ExecutionSpace,
+            typename Predicates, typename OutputView, typename OffsetView>
+  static void queryWithReplicas(DistributedTree const &tree,
+                                ExecutionSpace const &space,
+                                Predicates const &queries,
+                                Kokkos::View<int *, DeviceType> indices,
+                                OutputView &out, OffsetView &offset);
+
   template <typename ExecutionSpace, typename Predicates, typename Ranks,
             typename Query>
   static void forwardQueries(MPI_Comm comm, ExecutionSpace const &space,
@@ -219,27 +308,42 @@ struct DistributedTreeImpl
                                      Kokkos::View<int *, DeviceType> &ids,
                                      Distances *distances_ptr = nullptr);
 
-  template <typename ExecutionSpace, typename Predicates, typename Indices,
-            typename Offset, typename Ranks>
+  template <typename ExecutionSpace, typename Predicates, typename Distances,
+            typename Indices, typename Offset, typename Ranks>
   static void filterResults(ExecutionSpace const &space,
-                            Predicates const &queries,
-                            Kokkos::View<float *, DeviceType> distances,
+                            Predicates const &queries, Distances &distances,
                             Indices &indices, Offset &offset, Ranks &ranks);
 
   template <typename ExecutionSpace, typename View, typename... OtherViews>
   static void sortResults(ExecutionSpace const &space, View keys,
-                          OtherViews... other_views);
+                          OtherViews &...other_views);
 
   template <typename ExecutionSpace, typename OffsetView>
   static void countResults(ExecutionSpace const &space, int n_queries,
                            Kokkos::View<int *, DeviceType> query_ids,
                            OffsetView &offset);
 
+  template <typename ExecutionSpace, typename BottomTree, typename Predicates,
+            typename Callback, typename OutputView, typename OffsetView,
+            typename Ranks>
+  static void forwardAndPerformQueries(
+      MPI_Comm comm, ExecutionSpace const &space, BottomTree const &bottom_tree,
+      Predicates const &queries, Kokkos::View<int *, DeviceType> indices,
+      Kokkos::View<int *, DeviceType> offset, Callback const &callback,
+      OutputView &out, OffsetView &fwd_offset,
+      Kokkos::View<int *, DeviceType> &fwd_ids, Ranks &fwd_ranks);
+
   template <typename ExecutionSpace, typename View>
   static typename std::enable_if<Kokkos::is_view<View>::value>::type
   sendAcrossNetwork(ExecutionSpace const &space,
                     Distributor<DeviceType> const &distributor, View exports,
                     typename View::non_const_type imports);
+
+  template <typename ExecutionSpace, typename View, typename Process>
+  static void sendAcrossNetworkAndProcess(
+      ExecutionSpace const &space, Distributor<DeviceType> const &distributor,
+      View exports, typename View::non_const_type imports,
+      Process const &process);
 };
 
 template <typename DeviceType>
@@ -311,6 +415,193 @@ DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
   }
 }
 
+// Same as sendAcrossNetwork for one-dimensional views, but process(begin,
+// end) is called on each range of imports as soon as it is received
+template <typename DeviceType>
+template <typename ExecutionSpace, typename View, typename Process>
+void DistributedTreeImpl<DeviceType>::sendAcrossNetworkAndProcess(
+    ExecutionSpace const &space, Distributor<DeviceType> const &distributor,
+    View exports, typename View::non_const_type imports,
+    Process const &process)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::sendAcrossNetworkAndProcess (" +
+      exports.label() + ")");
+
+  static_assert(View::rank == 1);
+  ARBORX_ASSERT((exports.extent(0) == distributor.getTotalSendLength()) &&
+                (imports.extent(0) == distributor.getTotalReceiveLength()));
+
+  using NonConstValueType = typename View::non_const_value_type;
+
+#ifndef ARBORX_ENABLE_GPU_AWARE_MPI
+  using MirrorSpace = typename View::host_mirror_space;
+  typename MirrorSpace::execution_space const execution_space;
+#else
+  using MirrorSpace = typename View::device_type::memory_space;
+  auto const &execution_space = space;
+#endif
+
+  auto imports_layout_right = create_layout_right_mirror_view_no_init(
+      execution_space, MirrorSpace{}, imports);
+
+#ifndef ARBORX_ENABLE_GPU_AWARE_MPI
+  execution_space.fence();
+#endif
+
+  Kokkos::View<NonConstValueType *, MirrorSpace,
+               Kokkos::MemoryTraits<Kokkos::Unmanaged>>
+      import_buffer(imports_layout_right.data(), imports_layout_right.size());
+
+  distributor.doPostsAndProcess(
+      space, exports, 1, import_buffer, [&](int begin, int end) {
+        auto const range = Kokkos::make_pair(begin, end);
+        Kokkos::deep_copy(space, Kokkos::subview(imports, range),
+                          Kokkos::subview(imports_layout_right, range));
+        process(begin, end);
+      });
+}
+
+// Forward the queries, and perform them on the bottom tree in batches as
+// they are received, starting with the local ones, so that the traversal
+// overlaps the communication.
+template <typename DeviceType>
+template <typename ExecutionSpace, typename BottomTree, typename Predicates,
+          typename Callback, typename OutputView, typename OffsetView,
+          typename Ranks>
+void DistributedTreeImpl<DeviceType>::forwardAndPerformQueries(
+    MPI_Comm comm, ExecutionSpace const &space, BottomTree const &bottom_tree,
+    Predicates const &queries, Kokkos::View<int *, DeviceType> indices,
+    Kokkos::View<int *, DeviceType> offset, Callback const &callback,
+    OutputView &out, OffsetView &fwd_offset,
+    Kokkos::View<int *, DeviceType> &fwd_ids, Ranks &fwd_ranks)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::forwardAndPerformQueries");
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+
+  Distributor<DeviceType> distributor(comm);
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using Query = typename AccessTraitsHelper<Access>::type;
+  int const n_queries = Access::size(queries);
+  int const n_exports = KokkosExt::lastElement(space, offset);
+  int const n_imports = distributor.createFromSends(space, indices);
+
+  // The ranks and ids are small, and are sent ahead of the queries
+  {
+    Kokkos::View<int *, DeviceType> export_ranks(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::DistributedTree::query::forwardQueries::export_ranks"),
+        n_exports);
+    Kokkos::deep_copy(space, export_ranks, comm_rank);
+
+    Kokkos::View<int *, DeviceType> import_ranks(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::DistributedTree::query::forwardQueries::import_ranks"),
+        n_imports);
+
+    sendAcrossNetwork(space, distributor, export_ranks, import_ranks);
+    fwd_ranks = import_ranks;
+  }
+
+  {
+    Kokkos::View<int *, DeviceType> export_ids(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::DistributedTree::query::forwardQueries::export_ids"),
+        n_exports);
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::forward_queries_fill_ids",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+        KOKKOS_LAMBDA(int q) {
+          for (int i = offset(q); i < offset(q + 1); ++i)
+          {
+            export_ids(i) = q;
+          }
+        });
+    Kokkos::View<int *, DeviceType> import_ids(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::DistributedTree::query::forwardQueries::import_ids"),
+        n_imports);
+
+    sendAcrossNetwork(space, distributor, export_ids, import_ids);
+    fwd_ids = import_ids;
+  }
+
+  Kokkos::View<Query *, DeviceType> exports(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::DistributedTree::query::forwardQueries::exports"),
+      n_exports);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::forward_queries_fill_buffer",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        for (int i = offset(q); i < offset(q + 1); ++i)
+        {
+          exports(i) = Access::get(queries, q);
+        }
+      });
+  Kokkos::View<Query *, DeviceType> imports(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::DistributedTree::query::forwardQueries::imports"),
+      n_imports);
+
+  struct Batch
+  {
+    int begin;
+    OutputView out;
+    Kokkos::View<int *, DeviceType> offset;
+  };
+  std::vector<Batch> batches;
+  sendAcrossNetworkAndProcess(
+      space, distributor, exports, imports, [&](int begin, int end) {
+        Batch batch{
+            begin,
+            OutputView(Kokkos::view_alloc(space, out.label()), 0),
+            Kokkos::View<int *, DeviceType>(
+                "ArborX::DistributedTree::query::batch_offset", 0)};
+        query(bottom_tree, space,
+              Kokkos::subview(imports, Kokkos::make_pair(begin, end)),
+              callback, batch.out, batch.offset);
+        batches.push_back(batch);
+      });
+
+  // Assemble the results of the batches in the order of the imports
+  Kokkos::realloc(Kokkos::view_alloc(space), fwd_offset, n_imports + 1);
+  for (auto const &batch : batches)
+  {
+    int const begin = batch.begin;
+    auto const batch_offset = batch.offset;
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::count_batch_results",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0,
+                                            batch_offset.extent(0) - 1),
+        KOKKOS_LAMBDA(int i) {
+          fwd_offset(begin + i) = batch_offset(i + 1) - batch_offset(i);
+        });
+  }
+  exclusivePrefixSum(space, fwd_offset);
+  KokkosExt::reallocWithoutInitializing(
+      space, out, KokkosExt::lastElement(space, fwd_offset));
+  for (auto const &batch : batches)
+  {
+    int const begin = batch.begin;
+    auto const batch_out = batch.out;
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::copy_batch_results",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, batch_out.extent(0)),
+        KOKKOS_LAMBDA(int i) { out(fwd_offset(begin) + i) = batch_out(i); });
+  }
+}
+
 template <typename DeviceType>
 template <typename DistributedTree, typename ExecutionSpace,
           typename Predicates, typename Indices, typename Offset,
@@ -485,99 +776,452 @@ std::enable_if_t<Kokkos::is_view<Indices>{} && Kokkos::is_view<Offset>{} &&
 DistributedTreeImpl<DeviceType>::queryDispatchImpl(
     NearestPredicateTag, DistributedTree const &tree,
     ExecutionSpace const &space, Predicates const &queries, Indices &indices,
-    Offset &offset, Ranks &ranks, Distances *distances_ptr)
+    Offset &offset, Ranks &ranks, Distances *distances_ptr,
+    Experimental::DistributedNearestStrategy strategy)
 {
   KokkosExt::ScopedProfileRegion guard(
       "ArborX::DistributedTree::query::nearest");
 
   auto const &bottom_tree = tree._bottom_tree;
-  auto comm = tree.getComm();
 
   Distances distances("ArborX::DistributedTree::query::nearest::distances", 0);
   if (distances_ptr)
     distances = *distances_ptr;
 
-  // "Strategy" is used to determine what ranks to forward queries to.  In
-  // the 1st pass, the queries are sent to as many ranks as necessary to
-  // guarantee that all k neighbors queried for are found.  In the 2nd pass,
-  // queries are sent again to all ranks that may have a neighbor closer to
-  // the farthest neighbor identified in the 1st pass.
-  //
-  // The current implementation discards the results after the 1st pass and
-  // recompute everything instead of just searching for potential better
-  // neighbors and updating the list.
-
   // Right now, distance calculations only work with BVH due to using functions
   // in DistributedTreeNearestUtils. So, there's no point in replacing this
   // with decltype.
   CallbackWithDistance<BVH<typename DeviceType::memory_space>>
       callback_with_distance(space, bottom_tree);
 
-  // NOTE: compiler would not deduce __range for the braced-init-list, but I
-  // got it to work with the static_cast to function pointers.
-  using Strategy =
-      void (*)(ExecutionSpace const &, Predicates const &,
-               DistributedTree const &, Indices &, Offset &, Distances &);
-  for (auto implementStrategy :
-       {static_cast<Strategy>(DistributedTreeImpl<DeviceType>::deviseStrategy),
-        static_cast<Strategy>(
-            DistributedTreeImpl<DeviceType>::reassessStrategy)})
+  if (strategy == Experimental::DistributedNearestStrategy::SINGLE_ROUND)
   {
-    implementStrategy(space, queries, tree, indices, offset, distances);
-
+    singleRoundStrategy(space, queries, tree, callback_with_distance, indices,
+                        offset, ranks, distances);
+  }
+  else
+  {
+    // "Strategy" is used to determine what ranks to forward queries to.  In
+    // the 1st pass, the queries are sent to as many ranks as necessary to
+    // guarantee that all k neighbors queried for are found.  In the 2nd pass,
+    // queries are sent again to all ranks that may have a neighbor closer to
+    // the farthest neighbor identified in the 1st pass.
+    //
+    // The current implementation discards the results after the 1st pass and
+    // recompute everything instead of just searching for potential better
+    // neighbors and updating the list.
+
+    // NOTE: compiler would not deduce __range for the braced-init-list, but I
+    // got it to work with the static_cast to function pointers.
+    using Strategy =
+        void (*)(ExecutionSpace const &, Predicates const &,
+                 DistributedTree const &, Indices &, Offset &, Distances &);
+    for (auto implementStrategy :
+         {static_cast<Strategy>(
+              DistributedTreeImpl<DeviceType>::deviseStrategy),
+          static_cast<Strategy>(
+              DistributedTreeImpl<DeviceType>::reassessStrategy)})
     {
-      // NOTE_COMM_NEAREST: The communication pattern here for the nearest
-      // search is identical to that of the spatial search (see
-      // NOTE_COMM_SPATIAL). The code differences are:
-      // - no callbacks
-      // - explicit distances
-      // - results filtering
-
-      // Forward queries
-      using Access = AccessTraits<Predicates, PredicatesTag>;
-      using Query = typename AccessTraitsHelper<Access>::type;
-      Kokkos::View<int *, DeviceType> ids(
-          "ArborX::DistributedTree::query::nearest::query_ids", 0);
-      Kokkos::View<Query *, DeviceType> fwd_queries(
-          "ArborX::DistributedTree::query::nearest::fwd_queries", 0);
-      forwardQueries(comm, space, queries, indices, offset, fwd_queries, ids,
-                     ranks);
-
-      // Perform queries that have been received
-      Kokkos::View<PairIndexDistance *, DeviceType> out(
-          "ArborX::DistributedTree::query::pairs_index_distance", 0);
-      query(bottom_tree, space, fwd_queries, callback_with_distance, out,
-            offset);
-
-      // Unzip
-      auto const n = out.extent(0);
-      KokkosExt::reallocWithoutInitializing(space, indices, n);
-      KokkosExt::reallocWithoutInitializing(space, distances, n);
-      Kokkos::parallel_for(
-          "ArborX::DistributedTree::query::nearest::split_"
-          "index_distance_pairs",
-          Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
-          KOKKOS_LAMBDA(int i) {
-            indices(i) = out(i).index;
-            distances(i) = out(i).distance;
-          });
+      implementStrategy(space, queries, tree, indices, offset, distances);
+      exchangeNearestQueries(space, queries, tree, callback_with_distance,
+                             indices, offset, ranks, distances);
+    }
+  }
+
+  if (distances_ptr)
+    *distances_ptr = distances;
+}
+
+template <typename DeviceType>
+template <typename DistributedTree, typename ExecutionSpace,
+          typename Predicates, typename Callback, typename OutputView,
+          typename OffsetView>
+std::enable_if_t<Kokkos::is_view<OutputView>{} && Kokkos::is_view<OffsetView>{}>
+DistributedTreeImpl<DeviceType>::queryDispatch(
+    NearestPredicateTag tag, DistributedTree const &tree,
+    ExecutionSpace const &space, Predicates const &queries,
+    Callback const &callback, OutputView &out, OffsetView &offset,
+    Experimental::DistributedNearestStrategy strategy)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::query::nearest_with_callback");
 
-      // Communicate results back
-      communicateResultsBack(comm, space, indices, offset, ranks, ids,
-                             &distances);
+  auto comm = tree.getComm();
 
-      // Merge results
-      Kokkos::Profiling::pushRegion(
-          "ArborX::DistributedTree::nearest::postprocess_results");
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using Query = typename AccessTraitsHelper<Access>::type;
+  int const n_queries = Access::size(queries);
 
-      int const n_queries = Access::size(queries);
-      countResults(space, n_queries, ids, offset);
-      sortResults(space, ids, indices, ranks, distances);
-      filterResults(space, queries, distances, indices, offset, ranks);
+  // Find the neighbors first, without their distances
+  Kokkos::View<int *, DeviceType> indices(
+      "ArborX::DistributedTree::query::nearest::indices", 0);
+  Kokkos::View<int *, DeviceType> nearest_offset(
+      "ArborX::DistributedTree::query::nearest::offset", 0);
+  Kokkos::View<int *, DeviceType> ranks(
+      "ArborX::DistributedTree::query::nearest::ranks", 0);
+  Kokkos::View<float *, DeviceType> *no_distances = nullptr;
+  queryDispatchImpl(tag, tree, space, queries, indices, nearest_offset, ranks,
+                    no_distances, strategy);
+
+  // Send every neighbor to its owner along with its query, one predicate per
+  // neighbor
+  int const n_neighbors = KokkosExt::lastElement(space, nearest_offset);
+  using NeighborQuery = decltype(attach(std::declval<Query const &>(), 0));
+  Kokkos::View<NeighborQuery *, DeviceType> neighbor_queries(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::DistributedTree::query::nearest::neighbor_queries"),
+      n_neighbors);
+  Kokkos::View<int *, DeviceType> neighbor_query_ids(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::DistributedTree::query::nearest::neighbor_query_ids"),
+      n_neighbors);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::nearest::attach_neighbors",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        for (int j = nearest_offset(q); j < nearest_offset(q + 1); ++j)
+        {
+          neighbor_queries(j) = attach(Access::get(queries, q), indices(j));
+          neighbor_query_ids(j) = q;
+        }
+      });
+  Kokkos::View<int *, DeviceType> neighbor_offset(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::DistributedTree::query::nearest::neighbor_offset"),
+      n_neighbors + 1);
+  iota(space, neighbor_offset);
+
+  Kokkos::View<int *, DeviceType> ids(
+      "ArborX::DistributedTree::query::nearest::query_ids", 0);
+  Kokkos::View<NeighborQuery *, DeviceType> fwd_queries(
+      "ArborX::DistributedTree::query::nearest::fwd_queries", 0);
+  Kokkos::View<int *, DeviceType> fwd_ranks(
+      "ArborX::DistributedTree::query::nearest::fwd_ranks", 0);
+  forwardQueries(comm, space, neighbor_queries, ranks, neighbor_offset,
+                 fwd_queries, ids, fwd_ranks);
+
+  // Apply the callback to the received neighbors, counting its output first
+  using ValueType = typename OutputView::value_type;
+  int const n_fwd_queries = fwd_queries.extent(0);
+  Kokkos::View<int *, DeviceType> fwd_offset(
+      Kokkos::view_alloc(
+          space, "ArborX::DistributedTree::query::nearest::fwd_offset"),
+      n_fwd_queries + 1);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::nearest::count_callback_output",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_fwd_queries),
+      KOKKOS_LAMBDA(int f) {
+        auto const &fwd_query = fwd_queries(f);
+        int count = 0;
+        callback(getPredicate(fwd_query), getData(fwd_query),
+                 [&](ValueType const &) { ++count; });
+        fwd_offset(f) = count;
+      });
+  exclusivePrefixSum(space, fwd_offset);
+  KokkosExt::reallocWithoutInitializing(
+      space, out, KokkosExt::lastElement(space, fwd_offset));
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::nearest::apply_callback",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_fwd_queries),
+      KOKKOS_LAMBDA(int f) {
+        auto const &fwd_query = fwd_queries(f);
+        int position = fwd_offset(f);
+        callback(getPredicate(fwd_query), getData(fwd_query),
+                 [&](ValueType const &value) { out(position++) = value; });
+      });
 
-      Kokkos::Profiling::popRegion();
-    }
+  // Communicate the output back
+  communicateResultsBack(comm, space, out, fwd_offset, fwd_ranks, ids);
+
+  Kokkos::Profiling::pushRegion(
+      "ArborX::DistributedTree::nearest::postprocess_results");
+
+  // The ids are those of the neighbors, translate them into the queries'
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::nearest::neighbor_to_query_ids",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, ids.extent(0)),
+      KOKKOS_LAMBDA(int i) { ids(i) = neighbor_query_ids(ids(i)); });
+  countResults(space, n_queries, ids, offset);
+  sortResults(space, ids, out);
+
+  Kokkos::Profiling::popRegion();
+}
+
+template <typename DeviceType>
+template <typename DistributedTree, typename ExecutionSpace,
+          typename Predicates, typename Callback, typename Indices,
+          typename Offset, typename Ranks, typename Distances>
+void DistributedTreeImpl<DeviceType>::exchangeNearestQueries(
+    ExecutionSpace const &space, Predicates const &queries,
+    DistributedTree const &tree, Callback const &callback_with_distance,
+    Indices &indices, Offset &offset, Ranks &ranks, Distances &distances)
+{
+  // NOTE_COMM_NEAREST: The communication pattern here for the nearest
+  // search is identical to that of the spatial search (see
+  // NOTE_COMM_SPATIAL). The code differences are:
+  // - no callbacks
+  // - explicit distances
+  // - results filtering
+
+  auto const &bottom_tree = tree._bottom_tree;
+  auto comm = tree.getComm();
+
+  // Forward queries and perform them as they are received
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  Kokkos::View<int *, DeviceType> ids(
+      "ArborX::DistributedTree::query::nearest::query_ids", 0);
+  Kokkos::View<PairIndexDistance *, DeviceType> out(
+      "ArborX::DistributedTree::query::pairs_index_distance", 0);
+  forwardAndPerformQueries(comm, space, bottom_tree, queries, indices, offset,
+                           callback_with_distance, out, offset, ids, ranks);
+
+  // Unzip
+  auto const n = out.extent(0);
+  KokkosExt::reallocWithoutInitializing(space, indices, n);
+  KokkosExt::reallocWithoutInitializing(space, distances, n);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::nearest::split_"
+      "index_distance_pairs",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        indices(i) = out(i).index;
+        distances(i) = out(i).distance;
+      });
+
+  // Communicate results back
+  communicateResultsBack(comm, space, indices, offset, ranks, ids,
+                         &distances);
+
+  // Merge results
+  Kokkos::Profiling::pushRegion(
+      "ArborX::DistributedTree::nearest::postprocess_results");
+
+  int const n_queries = Access::size(queries);
+  countResults(space, n_queries, ids, offset);
+  sortResults(space, ids, indices, ranks, distances);
+  filterResults(space, queries, distances, indices, offset, ranks);
+
+  Kokkos::Profiling::popRegion();
+}
+
+template <typename DeviceType>
+template <typename DistributedTree, typename ExecutionSpace,
+          typename Predicates, typename Callback, typename Indices,
+          typename Offset, typename Ranks, typename Distances>
+void DistributedTreeImpl<DeviceType>::singleRoundStrategy(
+    ExecutionSpace const &space, Predicates const &queries,
+    DistributedTree const &tree, Callback const &callback_with_distance,
+    Indices &indices, Offset &offset, Ranks &ranks, Distances &distances)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::singleRoundStrategy");
+
+  auto const &top_tree = tree._top_tree;
+  auto const &bottom_tree = tree._bottom_tree;
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using Query = typename AccessTraitsHelper<Access>::type;
+  int const n_queries = Access::size(queries);
+
+  // Any k local neighbors bound the distance to the k-th nearest neighbor
+  // overall, so that only the ranks within the distance to the k-th nearest
+  // local neighbor may hold some of the neighbors. The search is local and
+  // needs no communication. Queries with fewer than k local neighbors have
+  // no such bound and are marked with a negative radius.
+  Kokkos::View<PairIndexDistance *, DeviceType> local_out(
+      "ArborX::DistributedTree::query::nearest::local_pairs_index_distance",
+      0);
+  Kokkos::View<int *, DeviceType> local_offset(
+      "ArborX::DistributedTree::query::nearest::local_offset", 0);
+  query(bottom_tree, space, queries, callback_with_distance, local_out,
+        local_offset);
+
+  Kokkos::View<float *, DeviceType> radii(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::query::nearest::radii"),
+      n_queries);
+  int n_unbounded = 0;
+  Kokkos::parallel_reduce(
+      "ArborX::DistributedTree::query::nearest::local_radii",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int i, int &update) {
+        using KokkosExt::max;
+        float radius = 0.;
+        for (int j = local_offset(i); j < local_offset(i + 1); ++j)
+          radius = max(radius, local_out(j).distance);
+        bool const is_bounded = (local_offset(i + 1) - local_offset(i) >=
+                                 getK(Access::get(queries, i)));
+        radii(i) = (is_bounded ? radius : -1.f);
+        if (!is_bounded)
+          ++update;
+      },
+      n_unbounded);
+
+  // The unbounded queries are forwarded as in the first round of the
+  // two-round strategy, and the bounded ones to the ranks within their radii
+  deviseStrategy(space, queries, tree, indices, offset, distances);
+  {
+    Kokkos::View<int *, DeviceType> bounded_indices(
+        "ArborX::DistributedTree::query::nearest::bounded_indices", 0);
+    Kokkos::View<int *, DeviceType> bounded_offset(
+        "ArborX::DistributedTree::query::nearest::bounded_offset", 0);
+    query(top_tree, space,
+          WithinDistanceFromPredicates<Predicates, decltype(radii)>{queries,
+                                                                    radii},
+          bounded_indices, bounded_offset);
+
+    Kokkos::View<int *, DeviceType> positions(
+        Kokkos::view_alloc(
+            space, Kokkos::WithoutInitializing,
+            "ArborX::DistributedTree::query::nearest::bounded_positions"),
+        n_queries);
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::nearest::find_bounded",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+        KOKKOS_LAMBDA(int i) { positions(i) = (radii(i) < 0 ? -1 : i); });
+    auto new_offset = mergeOffsets(space, positions, offset, bounded_offset);
+    mergeValues(space, positions, offset, bounded_offset, new_offset, indices,
+                bounded_indices);
+    offset = new_offset;
   }
+
+  exchangeNearestQueries(space, queries, tree, callback_with_distance,
+                         indices, offset, ranks, distances);
+
+  // The ranks without unbounded queries still take part in the second
+  // exchange if any other rank has some
+  int n_unbounded_global;
+  MPI_Allreduce(&n_unbounded, &n_unbounded_global, 1, MPI_INT, MPI_SUM,
+                tree.getComm());
+  if (n_unbounded_global == 0)
+    return;
+
+  Kokkos::View<int *, DeviceType> positions(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::DistributedTree::query::nearest::unbounded_positions"),
+      n_queries);
+  Kokkos::View<Query *, DeviceType> unbounded_queries(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::DistributedTree::query::nearest::unbounded_queries"),
+      n_unbounded);
+  Kokkos::parallel_scan(
+      "ArborX::DistributedTree::query::nearest::gather_unbounded_queries",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int i, int &update, bool final_pass) {
+        bool const is_unbounded = (radii(i) < 0);
+        if (final_pass)
+        {
+          positions(i) = (is_unbounded ? update : -1);
+          if (is_unbounded)
+            unbounded_queries(update) = Access::get(queries, i);
+        }
+        if (is_unbounded)
+          ++update;
+      });
+
+  // Second round for the unbounded queries only, starting from the
+  // distances to the neighbors they found in the first one
+  Kokkos::View<int *, DeviceType> unbounded_offset(
+      Kokkos::view_alloc(
+          space, "ArborX::DistributedTree::query::nearest::unbounded_offset"),
+      n_unbounded + 1);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::nearest::count_unbounded_results",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int i) {
+        if (positions(i) != -1)
+          unbounded_offset(positions(i)) = offset(i + 1) - offset(i);
+      });
+  exclusivePrefixSum(space, unbounded_offset);
+  Kokkos::View<float *, DeviceType> unbounded_distances(
+      Kokkos::view_alloc(
+          space, Kokkos::WithoutInitializing,
+          "ArborX::DistributedTree::query::nearest::unbounded_distances"),
+      KokkosExt::lastElement(space, unbounded_offset));
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::nearest::copy_unbounded_distances",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int i) {
+        int const p = positions(i);
+        if (p == -1)
+          return;
+        for (int j = 0; j < offset(i + 1) - offset(i); ++j)
+          unbounded_distances(unbounded_offset(p) + j) =
+              distances(offset(i) + j);
+      });
+
+  Kokkos::View<int *, DeviceType> unbounded_indices(
+      "ArborX::DistributedTree::query::nearest::unbounded_indices", 0);
+  Kokkos::View<int *, DeviceType> unbounded_ranks(
+      "ArborX::DistributedTree::query::nearest::unbounded_ranks", 0);
+  reassessStrategy(space, unbounded_queries, tree, unbounded_indices,
+                   unbounded_offset, unbounded_distances);
+  exchangeNearestQueries(space, unbounded_queries, tree,
+                         callback_with_distance, unbounded_indices,
+                         unbounded_offset, unbounded_ranks,
+                         unbounded_distances);
+
+  auto new_offset = mergeOffsets(space, positions, offset, unbounded_offset);
+  mergeValues(space, positions, offset, unbounded_offset, new_offset, indices,
+              unbounded_indices);
+  mergeValues(space, positions, offset, unbounded_offset, new_offset, ranks,
+              unbounded_ranks);
+  mergeValues(space, positions, offset, unbounded_offset, new_offset,
+              distances, unbounded_distances);
+  offset = new_offset;
+}
+
+// Offsets of the results of each query q taken from the other results at
+// positions(q), or kept if positions(q) is -1
+template <typename DeviceType>
+template <typename ExecutionSpace, typename Offset, typename OtherOffset>
+Kokkos::View<int *, DeviceType> DistributedTreeImpl<DeviceType>::mergeOffsets(
+    ExecutionSpace const &space, Kokkos::View<int *, DeviceType> positions,
+    Offset const &offset, OtherOffset const &other_offset)
+{
+  int const n_queries = positions.size();
+  Kokkos::View<int *, DeviceType> new_offset(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing, offset.label()),
+      n_queries + 1);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::merge_offsets",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        int const p = positions(q);
+        new_offset(q) = (p == -1 ? offset(q + 1) - offset(q)
+                                 : other_offset(p + 1) - other_offset(p));
+      });
+  exclusivePrefixSum(space, new_offset);
+  return new_offset;
+}
+
+template <typename DeviceType>
+template <typename ExecutionSpace, typename Offset, typename OtherOffset,
+          typename Values, typename OtherValues>
+void DistributedTreeImpl<DeviceType>::mergeValues(
+    ExecutionSpace const &space, Kokkos::View<int *, DeviceType> positions,
+    Offset const &offset, OtherOffset const &other_offset,
+    Kokkos::View<int *, DeviceType> new_offset, Values &values,
+    OtherValues const &other_values)
+{
+  int const n_queries = positions.size();
+  Values new_values(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing, values.label()),
+      KokkosExt::lastElement(space, new_offset));
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::merge_values",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        int const p = positions(q);
+        for (int j = 0; j < new_offset(q + 1) - new_offset(q); ++j)
+          new_values(new_offset(q) + j) =
+              (p == -1 ? values(offset(q) + j)
+                       : other_values(other_offset(p) + j));
+      });
+  values = new_values;
 }
 
 template <typename DeviceType>
@@ -602,6 +1246,24 @@ DistributedTreeImpl<DeviceType>::queryDispatch(
   Kokkos::View<int *, DeviceType> ranks(
       "ArborX::DistributedTree::query::spatial::ranks", 0);
   query(top_tree, space, queries, indices, offset);
+  tree.refineTopTreeHits(space, queries, indices, offset);
+
+  auto const &query_counts = tree._query_counts;
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::spatial::count_hits",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, indices.extent(0)),
+      KOKKOS_LAMBDA(int i) {
+        Kokkos::atomic_increment(&query_counts(indices(i)));
+      });
+
+  if constexpr (std::is_same_v<Callback, DefaultCallbackWithRank>)
+  {
+    if (tree._replica_holders.size() > 0)
+    {
+      queryWithReplicas(tree, space, queries, indices, out, offset);
+      return;
+    }
+  }
 
   {
     // NOTE_COMM_SPATIAL: The communication pattern here for the spatial search
@@ -611,18 +1273,12 @@ DistributedTreeImpl<DeviceType>::queryDispatch(
     // - no explicit distances
     // - no results filtering
 
-    // Forward queries
+    // Forward queries and perform them as they are received
     using Access = AccessTraits<Predicates, PredicatesTag>;
-    using Query = typename AccessTraitsHelper<Access>::type;
     Kokkos::View<int *, DeviceType> ids(
         "ArborX::DistributedTree::query::spatial::query_ids", 0);
-    Kokkos::View<Query *, DeviceType> fwd_queries(
-        "ArborX::DistributedTree::query::spatial::fwd_queries", 0);
-    forwardQueries(comm, space, queries, indices, offset, fwd_queries, ids,
-                   ranks);
-
-    // Perform queries that have been received
-    query(bottom_tree, space, fwd_queries, callback, out, offset);
+    forwardAndPerformQueries(comm, space, bottom_tree, queries, indices,
+                             offset, callback, out, offset, ids, ranks);
 
     // Communicate results back
     communicateResultsBack(comm, space, out, offset, ranks, ids);
@@ -639,11 +1295,334 @@ DistributedTreeImpl<DeviceType>::queryDispatch(
   }
 }
 
+// The ranks whose bounds the geometry of a query enters are visited in the
+// order of the distances at which it enters them. The query is first
+// forwarded to the closest rank only, and then to the other ranks it enters
+// before its k-th hit, if any, since the farther ones cannot hold closer hits.
+template <typename DeviceType>
+template <typename DistributedTree, typename ExecutionSpace,
+          typename Predicates, typename IndicesAndRanks, typename Offset>
+std::enable_if_t<Kokkos::is_view<IndicesAndRanks>{} &&
+                 Kokkos::is_view<Offset>{}>
+DistributedTreeImpl<DeviceType>::queryDispatch(
+    Experimental::OrderedSpatialPredicateTag, DistributedTree const &tree,
+    ExecutionSpace const &space, Predicates const &queries,
+    IndicesAndRanks &values, Offset &offset)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::query::ordered_spatial");
+
+  auto const &top_tree = tree._top_tree;
+  auto const &rank_bounds = tree._rank_bounds;
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using Query = typename AccessTraitsHelper<Access>::type;
+  using Geometry =
+      std::decay_t<decltype(getGeometry(std::declval<Query const &>()))>;
+  int const n_queries = Access::size(queries);
+
+  // The ranks entered, closest first, without the limit on the number of
+  // results of the queries
+  Kokkos::View<Experimental::OrderedSpatial<Geometry> *, DeviceType>
+      top_queries(Kokkos::view_alloc(
+                      space, Kokkos::WithoutInitializing,
+                      "ArborX::DistributedTree::query::ordered::top_queries"),
+                  n_queries);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::ordered::strip_limits",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        top_queries(q) = Experimental::ordered_intersects(
+            getGeometry(Access::get(queries, q)));
+      });
+  Kokkos::View<int *, DeviceType> entered(
+      "ArborX::DistributedTree::query::ordered::entered_ranks", 0);
+  Kokkos::View<int *, DeviceType> entered_offset(
+      "ArborX::DistributedTree::query::ordered::entered_offset", 0);
+  query(top_tree, space, top_queries, entered, entered_offset);
+
+  CallbackWithDistance<BVH<typename DeviceType::memory_space>>
+      callback_with_distance(space, tree._bottom_tree);
+
+  // First round, to the closest rank
+  Kokkos::View<int *, DeviceType> indices(
+      Kokkos::view_alloc(space, "ArborX::DistributedTree::query::ordered::"
+                                "closest_ranks"),
+      0);
+  Kokkos::View<int *, DeviceType> first_offset(
+      Kokkos::view_alloc(space,
+                         "ArborX::DistributedTree::query::ordered::offset"),
+      n_queries + 1);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::ordered::count_closest_ranks",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        first_offset(q) = (entered_offset(q + 1) > entered_offset(q) ? 1 : 0);
+      });
+  exclusivePrefixSum(space, first_offset);
+  KokkosExt::reallocWithoutInitializing(
+      space, indices, KokkosExt::lastElement(space, first_offset));
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::ordered::closest_ranks",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        if (first_offset(q + 1) > first_offset(q))
+          indices(first_offset(q)) = entered(entered_offset(q));
+      });
+  Kokkos::View<int *, DeviceType> ranks(
+      "ArborX::DistributedTree::query::ordered::ranks", 0);
+  Kokkos::View<float *, DeviceType> distances(
+      "ArborX::DistributedTree::query::ordered::distances", 0);
+  exchangeNearestQueries(space, queries, tree, callback_with_distance, indices,
+                         first_offset, ranks, distances);
+
+  // Second round, to the other ranks entered before the k-th hit, the hits
+  // being sorted by distance
+  Kokkos::View<int *, DeviceType> other_indices(
+      "ArborX::DistributedTree::query::ordered::other_entered_ranks", 0);
+  Kokkos::View<int *, DeviceType> other_offset(
+      Kokkos::view_alloc(
+          space, "ArborX::DistributedTree::query::ordered::other_offset"),
+      n_queries + 1);
+  int n_others = 0;
+  Kokkos::parallel_reduce(
+      "ArborX::DistributedTree::query::ordered::count_other_ranks",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q, int &update) {
+        auto const &query = Access::get(queries, q);
+        bool const is_bounded =
+            (first_offset(q + 1) - first_offset(q) >= getK(query));
+        constexpr auto inf =
+            KokkosExt::ArithmeticTraits::infinity<float>::value;
+        float const radius =
+            (is_bounded ? distances(first_offset(q + 1) - 1) : inf);
+        int count = 0;
+        for (int j = entered_offset(q) + 1; j < entered_offset(q + 1); ++j)
+        {
+          if (!(query.distance(rank_bounds(entered(j))) < radius))
+            break;
+          ++count;
+        }
+        other_offset(q) = count;
+        update += count;
+      },
+      n_others);
+  MPI_Allreduce(MPI_IN_PLACE, &n_others, 1, MPI_INT, MPI_SUM, tree.getComm());
+  if (n_others > 0)
+  {
+    exclusivePrefixSum(space, other_offset);
+    KokkosExt::reallocWithoutInitializing(
+        space, other_indices, KokkosExt::lastElement(space, other_offset));
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::ordered::other_ranks",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+        KOKKOS_LAMBDA(int q) {
+          for (int j = other_offset(q); j < other_offset(q + 1); ++j)
+            other_indices(j) = entered(entered_offset(q) + 1 + j -
+                                       other_offset(q));
+        });
+    Kokkos::View<int *, DeviceType> other_ranks(
+        "ArborX::DistributedTree::query::ordered::other_ranks", 0);
+    Kokkos::View<float *, DeviceType> other_distances(
+        "ArborX::DistributedTree::query::ordered::other_distances", 0);
+    exchangeNearestQueries(space, queries, tree, callback_with_distance,
+                           other_indices, other_offset, other_ranks,
+                           other_distances);
+
+    // Merge the hits of both rounds, and keep the first k of them
+    Kokkos::View<int *, DeviceType> new_offset(
+        Kokkos::view_alloc(space, first_offset.label()), n_queries + 1);
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::ordered::count_all_hits",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+        KOKKOS_LAMBDA(int q) {
+          new_offset(q) = (first_offset(q + 1) - first_offset(q)) +
+                          (other_offset(q + 1) - other_offset(q));
+        });
+    exclusivePrefixSum(space, new_offset);
+    int const n_hits = KokkosExt::lastElement(space, new_offset);
+    Kokkos::View<int *, DeviceType> new_indices(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           indices.label()),
+        n_hits);
+    Kokkos::View<int *, DeviceType> new_ranks(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing, ranks.label()),
+        n_hits);
+    Kokkos::View<float *, DeviceType> new_distances(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           distances.label()),
+        n_hits);
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::ordered::merge_hits",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+        KOKKOS_LAMBDA(int q) {
+          int position = new_offset(q);
+          for (int j = first_offset(q); j < first_offset(q + 1); ++j)
+          {
+            new_indices(position) = indices(j);
+            new_ranks(position) = ranks(j);
+            new_distances(position) = distances(j);
+            ++position;
+          }
+          for (int j = other_offset(q); j < other_offset(q + 1); ++j)
+          {
+            new_indices(position) = other_indices(j);
+            new_ranks(position) = other_ranks(j);
+            new_distances(position) = other_distances(j);
+            ++position;
+          }
+        });
+    indices = new_indices;
+    ranks = new_ranks;
+    distances = new_distances;
+    first_offset = new_offset;
+    filterResults(space, queries, distances, indices, first_offset, ranks);
+  }
+
+  auto const n = indices.extent(0);
+  KokkosExt::reallocWithoutInitializing(space, values, n);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::ordered::zip_indices_and_ranks",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        values(i) = {indices(i), ranks(i)};
+      });
+  offset = first_offset;
+}
+
+// The hits of the local trees that have replicas are spread over the owners
+// and the holders of the replicas. The queries for the owners and for the
+// replicas are forwarded and performed separately, and their results merged.
+template <typename DeviceType>
+template <typename DistributedTree, typename ExecutionSpace,
+          typename Predicates, typename OutputView, typename OffsetView>
+void DistributedTreeImpl<DeviceType>::queryWithReplicas(
+    DistributedTree const &tree, ExecutionSpace const &space,
+    Predicates const &queries, Kokkos::View<int *, DeviceType> indices,
+    OutputView &out, OffsetView &offset)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::DistributedTree::query::spatial::replicas");
+
+  auto comm = tree.getComm();
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  int const n_queries = Access::size(queries);
+
+  // Hit i of query q goes to copy (q + comm_rank) % (number of copies) of the
+  // tree, the owner being copy 0
+  auto const &replica_offsets = tree._replica_offsets;
+  auto const &replica_holders = tree._replica_holders;
+  Kokkos::View<int *, DeviceType> owner_offset(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::query::owner_offset"),
+      n_queries + 1);
+  Kokkos::View<int *, DeviceType> replica_offset(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::query::replica_offset"),
+      n_queries + 1);
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::count_replica_hits",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        int num_replica_hits = 0;
+        for (int i = offset(q); i < offset(q + 1); ++i)
+        {
+          int const rank = indices(i);
+          int const num_copies =
+              1 + replica_offsets(rank + 1) - replica_offsets(rank);
+          if ((q + comm_rank) % num_copies != 0)
+            ++num_replica_hits;
+        }
+        owner_offset(q) = offset(q + 1) - offset(q) - num_replica_hits;
+        replica_offset(q) = num_replica_hits;
+      });
+  exclusivePrefixSum(space, owner_offset);
+  exclusivePrefixSum(space, replica_offset);
+
+  Kokkos::View<int *, DeviceType> owner_indices(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::query::owner_indices"),
+      KokkosExt::lastElement(space, owner_offset));
+  Kokkos::View<int *, DeviceType> replica_indices(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::query::replica_indices"),
+      KokkosExt::lastElement(space, replica_offset));
+  Kokkos::parallel_for(
+      "ArborX::DistributedTree::query::split_replica_hits",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int q) {
+        int owner_pos = owner_offset(q);
+        int replica_pos = replica_offset(q);
+        for (int i = offset(q); i < offset(q + 1); ++i)
+        {
+          int const rank = indices(i);
+          int const num_copies =
+              1 + replica_offsets(rank + 1) - replica_offsets(rank);
+          int const copy = (q + comm_rank) % num_copies;
+          if (copy == 0)
+            owner_indices(owner_pos++) = rank;
+          else
+            replica_indices(replica_pos++) =
+                replica_holders(replica_offsets(rank) + copy - 1);
+        }
+      });
+
+  // The results of the replicas are reported as those of the owners
+  OutputView owner_out(Kokkos::view_alloc(space, out.label()), 0);
+  Kokkos::View<int *, DeviceType> owner_ids(
+      "ArborX::DistributedTree::query::spatial::owner_query_ids", 0);
+  Kokkos::View<int *, DeviceType> owner_ranks(
+      "ArborX::DistributedTree::query::spatial::owner_ranks", 0);
+  forwardAndPerformQueries(comm, space, tree._bottom_tree, queries,
+                           owner_indices, owner_offset,
+                           DefaultCallbackWithRank{comm_rank}, owner_out,
+                           owner_offset, owner_ids, owner_ranks);
+  communicateResultsBack(comm, space, owner_out, owner_offset, owner_ranks,
+                         owner_ids);
+
+  OutputView replica_out(Kokkos::view_alloc(space, out.label()), 0);
+  Kokkos::View<int *, DeviceType> replica_ids(
+      "ArborX::DistributedTree::query::spatial::replica_query_ids", 0);
+  Kokkos::View<int *, DeviceType> replica_ranks(
+      "ArborX::DistributedTree::query::spatial::replica_ranks", 0);
+  forwardAndPerformQueries(comm, space, tree._replica_tree, queries,
+                           replica_indices, replica_offset,
+                           DefaultCallbackWithRank{tree._replica_rank},
+                           replica_out, replica_offset, replica_ids,
+                           replica_ranks);
+  communicateResultsBack(comm, space, replica_out, replica_offset,
+                         replica_ranks, replica_ids);
+
+  Kokkos::Profiling::pushRegion(
+      "ArborX::DistributedTree::spatial::postprocess_results");
+
+  int const n_owner_results = owner_out.extent(0);
+  int const n_results = n_owner_results + replica_out.extent(0);
+  auto const owner_range = Kokkos::make_pair(0, n_owner_results);
+  auto const replica_range = Kokkos::make_pair(n_owner_results, n_results);
+  KokkosExt::reallocWithoutInitializing(space, out, n_results);
+  Kokkos::deep_copy(space, Kokkos::subview(out, owner_range), owner_out);
+  Kokkos::deep_copy(space, Kokkos::subview(out, replica_range), replica_out);
+  Kokkos::View<int *, DeviceType> ids(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::DistributedTree::query::spatial::query_ids"),
+      n_results);
+  Kokkos::deep_copy(space, Kokkos::subview(ids, owner_range), owner_ids);
+  Kokkos::deep_copy(space, Kokkos::subview(ids, replica_range), replica_ids);
+
+  countResults(space, n_queries, ids, offset);
+  sortResults(space, ids, out);
+
+  Kokkos::Profiling::popRegion();
+}
+
 template <typename DeviceType>
 template <typename ExecutionSpace, typename View, typename... OtherViews>
 void DistributedTreeImpl<DeviceType>::sortResults(ExecutionSpace const &space,
                                                   View keys,
-                                                  OtherViews... other_views)
+                                                  OtherViews &...other_views)
 {
   auto const n = keys.extent(0);
   // If they were no queries, min_val and max_val values won't change after
@@ -652,24 +1631,11 @@ void DistributedTreeImpl<DeviceType>::sortResults(ExecutionSpace const &space,
   if (n == 0)
     return;
 
-  // We only want to get the permutation here, but sortObjects also sorts the
-  // elements given to it. Hence, we need to create a copy.
-  // TODO try to avoid the copy
-  View keys_clone(
-      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
-                         "ArborX::DistributedTree::query::sortResults::keys"),
-      keys.size());
-  Kokkos::deep_copy(space, keys_clone, keys);
-  auto const permutation = ArborX::Details::sortObjects(space, keys_clone);
-
-  // Call applyPermutation for every entry in the parameter pack.
-  // We need to use the comma operator here since the function returns void.
-  // The variable we assign to is actually not needed. We just need something
-  // to store the initializer list (that contains only zeros).
-  auto dummy = {
-      (ArborX::Details::applyPermutation(space, permutation, other_views),
-       0)...};
-  std::ignore = dummy;
+  // The keys are not needed past this point, so they are sorted in place
+  auto const permutation = ArborX::Details::sortObjects(space, keys);
+
+  // Permute all the other views at once
+  ArborX::Details::applyPermutations(space, permutation, other_views...);
 }
 
 template <typename DeviceType>
@@ -797,9 +1763,6 @@ void DistributedTreeImpl<DeviceType>::communicateResultsBack(
   KokkosExt::ScopedProfileRegion guard(
       "ArborX::DistributedTree::communicateResultsBack");
 
-  int comm_rank;
-  MPI_Comm_rank(comm, &comm_rank);
-
   int const n_fwd_queries = offset.extent_int(0) - 1;
   int const n_exports = KokkosExt::lastElement(space, offset);
 
@@ -814,20 +1777,84 @@ void DistributedTreeImpl<DeviceType>::communicateResultsBack(
   int const n_imports =
       distributor.createFromSends(space, ranks, static_cast<Ranks>(offset));
 
+  // The rank of the results is implied by the process they come from
+  Ranks const fwd_ranks = ranks;
   {
-    Kokkos::View<int *, DeviceType> export_ranks(
-        Kokkos::view_alloc(space, Kokkos::WithoutInitializing, ranks.label()),
-        n_exports);
-    Kokkos::deep_copy(space, export_ranks, comm_rank);
-
     Kokkos::View<int *, DeviceType> import_ranks(
         Kokkos::view_alloc(space, Kokkos::WithoutInitializing, ranks.label()),
         n_imports);
-
-    sendAcrossNetwork(space, distributor, export_ranks, import_ranks);
+    auto const &sources = distributor.getSources();
+    auto const &src_offsets = distributor.getSourceOffsets();
+    for (int i = 0; i < (int)sources.size(); ++i)
+    {
+      auto const range = Kokkos::make_pair(src_offsets[i], src_offsets[i + 1]);
+      Kokkos::deep_copy(space, Kokkos::subview(import_ranks, range),
+                        sources[i]);
+    }
     ranks = import_ranks;
   }
 
+  // The query ids are the same for all the results of a query. When there are
+  // enough results per query, it is cheaper to send the ids along with the
+  // numbers of results per query, at the cost of creating another pattern.
+  long long sizes[2] = {n_exports, n_fwd_queries};
+  MPI_Allreduce(MPI_IN_PLACE, sizes, 2, MPI_LONG_LONG, MPI_SUM, comm);
+  if (sizes[0] > 2 * sizes[1])
+  {
+    Kokkos::View<int *, DeviceType> query_offset(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedTree::query::query_offset"),
+        n_fwd_queries + 1);
+    iota(space, query_offset);
+    Distributor<DeviceType> query_distributor(comm);
+    int const n_import_queries = query_distributor.createFromSends(
+        space, fwd_ranks, static_cast<Ranks>(query_offset));
+
+    Kokkos::View<Kokkos::pair<int, int> *, DeviceType> export_ids_and_counts(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedTree::query::ids_and_counts"),
+        n_fwd_queries);
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::fill_ids_and_counts",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_fwd_queries),
+        KOKKOS_LAMBDA(int q) {
+          export_ids_and_counts(q) = {ids(q), offset(q + 1) - offset(q)};
+        });
+    Kokkos::View<Kokkos::pair<int, int> *, DeviceType> import_ids_and_counts(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           export_ids_and_counts.label()),
+        n_import_queries);
+    sendAcrossNetwork(space, query_distributor, export_ids_and_counts,
+                      import_ids_and_counts);
+
+    // The queries come from the same processes in the same order as their
+    // results, so that the positions of the results are the prefix sums of
+    // the counts
+    Kokkos::View<int *, DeviceType> import_offset(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DistributedTree::query::import_offset"),
+        n_import_queries + 1);
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::copy_counts",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_import_queries),
+        KOKKOS_LAMBDA(int q) {
+          import_offset(q) = import_ids_and_counts(q).second;
+        });
+    exclusivePrefixSum(space, import_offset);
+
+    Kokkos::View<int *, DeviceType> import_ids(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing, ids.label()),
+        n_imports);
+    Kokkos::parallel_for(
+        "ArborX::DistributedTree::query::expand_ids",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_import_queries),
+        KOKKOS_LAMBDA(int q) {
+          for (int i = import_offset(q); i < import_offset(q + 1); ++i)
+            import_ids(i) = import_ids_and_counts(q).first;
+        });
+    ids = import_ids;
+  }
+  else
   {
     Kokkos::View<int *, DeviceType> export_ids(
         Kokkos::view_alloc(space, Kokkos::WithoutInitializing, ids.label()),
@@ -875,12 +1902,11 @@ void DistributedTreeImpl<DeviceType>::communicateResultsBack(
 }
 
 template <typename DeviceType>
-template <typename ExecutionSpace, typename Predicates, typename Indices,
-          typename Offset, typename Ranks>
+template <typename ExecutionSpace, typename Predicates, typename Distances,
+          typename Indices, typename Offset, typename Ranks>
 void DistributedTreeImpl<DeviceType>::filterResults(
     ExecutionSpace const &space, Predicates const &queries,
-    Kokkos::View<float *, DeviceType> distances, Indices &indices,
-    Offset &offset, Ranks &ranks)
+    Distances &distances, Indices &indices, Offset &offset, Ranks &ranks)
 {
   KokkosExt::ScopedProfileRegion guard(
       "ArborX::DistributedTree::filterResults");
@@ -907,6 +1933,8 @@ void DistributedTreeImpl<DeviceType>::filterResults(
       Kokkos::view_alloc(space, indices.label()), n_truncated_results);
   Kokkos::View<int *, DeviceType> new_ranks(
       Kokkos::view_alloc(space, ranks.label()), n_truncated_results);
+  Kokkos::View<float *, DeviceType> new_distances(
+      Kokkos::view_alloc(space, distances.label()), n_truncated_results);
 
   using PairIndexDistance = Kokkos::pair<Kokkos::Array<int, 2>, float>;
   struct CompareDistance
@@ -950,6 +1978,7 @@ void DistributedTreeImpl<DeviceType>::filterResults(
           {
             new_indices(new_offset(q) + count) = queue.top().first[0];
             new_ranks(new_offset(q) + count) = queue.top().first[1];
+            new_distances(new_offset(q) + count) = queue.top().second;
             queue.pop();
             ++count;
           }
@@ -957,6 +1986,7 @@ void DistributedTreeImpl<DeviceType>::filterResults(
       });
   indices = new_indices;
   ranks = new_ranks;
+  distances = new_distances;
   offset = new_offset;
 }
 
@@ -21,8 +21,12 @@
 #include <Kokkos_Core.hpp>
 
 #include <algorithm> // max_element
-#include <numeric>   // iota
+#include <array>
+#include <map>
+#include <memory>
+#include <numeric> // iota
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include <mpi.h>
@@ -202,12 +206,222 @@ static void sortAndDetermineBufferLayout(ExecutionSpace const &space,
   ARBORX_ASSERT(offsets.back() == static_cast<int>(ranks.size()));
 }
 
+// Processes sharing a node, as given by a communicator per node, attached to
+// a communicator as an MPI attribute so that the distributors created from it
+// route their messages through the nodes (see Distributor).
+struct NodeTopology
+{
+  MPI_Comm node_comm;
+  // Node of each process, identified by its smallest rank, and rank of the
+  // process within its node
+  std::vector<int> nodes;
+  std::vector<int> local_ranks;
+  // Processes of each node, indexed by the node, ordered by local rank
+  std::vector<std::vector<int>> node_ranks;
+};
+
+inline int nodeTopologyKeyval()
+{
+  static int const keyval = [] {
+    int keyval;
+    MPI_Comm_create_keyval(
+        MPI_COMM_NULL_COPY_FN,
+        [](MPI_Comm, int, void *attribute, void *) {
+          auto *topology = static_cast<NodeTopology *>(attribute);
+          MPI_Comm_free(&topology->node_comm);
+          delete topology;
+          return MPI_SUCCESS;
+        },
+        &keyval, nullptr);
+    return keyval;
+  }();
+  return keyval;
+}
+
+// Collective over comm. The processes of a same node_comm are on the same
+// node. Passing MPI_COMM_NULL on all processes restores the direct routing.
+inline void setNodeAwareRouting(MPI_Comm comm, MPI_Comm node_comm)
+{
+  if (node_comm == MPI_COMM_NULL)
+  {
+    MPI_Comm_delete_attr(comm, nodeTopologyKeyval());
+    return;
+  }
+
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  auto topology = std::make_unique<NodeTopology>();
+  MPI_Comm_dup(node_comm, &topology->node_comm);
+  int node_and_local_rank[2] = {comm_rank, 0};
+  MPI_Allreduce(&comm_rank, &node_and_local_rank[0], 1, MPI_INT, MPI_MIN,
+                topology->node_comm);
+  MPI_Comm_rank(topology->node_comm, &node_and_local_rank[1]);
+  std::vector<int> nodes_and_local_ranks(2 * comm_size);
+  MPI_Allgather(node_and_local_rank, 2, MPI_INT, nodes_and_local_ranks.data(),
+                2, MPI_INT, comm);
+
+  topology->nodes.resize(comm_size);
+  topology->local_ranks.resize(comm_size);
+  topology->node_ranks.resize(comm_size);
+  for (int r = 0; r < comm_size; ++r)
+  {
+    topology->nodes[r] = nodes_and_local_ranks[2 * r];
+    topology->local_ranks[r] = nodes_and_local_ranks[2 * r + 1];
+    topology->node_ranks[topology->nodes[r]].push_back(r);
+  }
+  for (auto &ranks : topology->node_ranks)
+    std::sort(ranks.begin(), ranks.end(), [&](int a, int b) {
+      return topology->local_ranks[a] < topology->local_ranks[b];
+    });
+
+  MPI_Comm_set_attr(comm, nodeTopologyKeyval(), topology.release());
+}
+
+// Returns nullptr if the routing through the nodes is not enabled on comm
+inline NodeTopology const *getNodeTopology(MPI_Comm comm)
+{
+  void *attribute;
+  int found;
+  MPI_Comm_get_attr(comm, nodeTopologyKeyval(), &attribute, &found);
+  return (found ? static_cast<NodeTopology const *>(attribute) : nullptr);
+}
+
+// Tags of the asynchronous exchanges (see Distributor::doPosts()), taken in
+// turn from a range of tags by the successive requests on a communicator,
+// whose count is attached to it as an MPI attribute. The messages of the
+// requests in flight on a communicator then never match those of another
+// one, as long as fewer than num_async_tags of them are pending. The
+// processes must create their requests on a communicator in the same order to
+// agree on the tags, e.g. at a collective call. The exchanges of a same
+// request may share its tag if each one starts once the previous one has
+// completed, its messages being matched in order.
+constexpr int first_async_tag = 1024;
+constexpr int num_async_tags = 16384;
+
+inline int asyncExchangeCountKeyval()
+{
+  static int const keyval = [] {
+    int keyval;
+    MPI_Comm_create_keyval(
+        MPI_COMM_NULL_COPY_FN,
+        [](MPI_Comm, int, void *attribute, void *) {
+          delete static_cast<unsigned *>(attribute);
+          return MPI_SUCCESS;
+        },
+        &keyval, nullptr);
+    return keyval;
+  }();
+  return keyval;
+}
+
+inline int nextAsyncTag(MPI_Comm comm)
+{
+  void *attribute;
+  int found;
+  MPI_Comm_get_attr(comm, asyncExchangeCountKeyval(), &attribute, &found);
+  auto *count = static_cast<unsigned *>(attribute);
+  if (!found)
+  {
+    count = new unsigned(0);
+    MPI_Comm_set_attr(comm, asyncExchangeCountKeyval(), count);
+  }
+  return first_async_tag + (int)((*count)++ % num_async_tags);
+}
+
+// Exchange started by Distributor::doPosts(). Its messages only progress
+// when the request is tested or waited on, and the imports may only be used
+// once it has completed. A pending request is waited on when destroyed.
+class DistributorRequest
+{
+public:
+  DistributorRequest() = default;
+  DistributorRequest(DistributorRequest const &) = delete;
+  DistributorRequest &operator=(DistributorRequest const &) = delete;
+  DistributorRequest(DistributorRequest &&other) noexcept
+      : _requests(std::exchange(other._requests, {}))
+      , _send_buffer(std::move(other._send_buffer))
+  {}
+  DistributorRequest &operator=(DistributorRequest &&other) noexcept
+  {
+    wait();
+    _requests = std::exchange(other._requests, {});
+    _send_buffer = std::move(other._send_buffer);
+    return *this;
+  }
+  ~DistributorRequest() { wait(); }
+
+  // Returns whether the exchange has completed, without blocking
+  bool test()
+  {
+    if (_requests.empty())
+      return true;
+    int done;
+    MPI_Testall(_requests.size(), _requests.data(), &done,
+                MPI_STATUSES_IGNORE);
+    if (done)
+      release();
+    return done;
+  }
+
+  void wait()
+  {
+    if (_requests.empty())
+      return;
+    MPI_Waitall(_requests.size(), _requests.data(), MPI_STATUSES_IGNORE);
+    release();
+  }
+
+private:
+  template <typename DeviceType>
+  friend class Distributor;
+
+  void release()
+  {
+    _requests.clear();
+    _send_buffer.reset();
+  }
+
+  std::vector<MPI_Request> _requests;
+  // Keeps the packed exports alive until the sends have completed
+  std::shared_ptr<void> _send_buffer;
+};
+
 template <typename DeviceType>
 class Distributor
 {
 public:
-  Distributor(MPI_Comm comm)
+  // How the processes find out which processes send to them and how much
+  enum class SourceDiscovery
+  {
+    // Dense exchange of the counts with MPI_Alltoall, O(comm_size)
+    Alltoall,
+    // Non-blocking consensus (NBX) of Hoefler, Siebert, and Lumsdaine
+    // (2010), O(number of destinations + log(comm_size))
+    NonBlockingConsensus
+  };
+
+  // With persistent_communication, the packed exchanges go through buffers
+  // owned by the distributor and persistent requests, both of which are kept
+  // for as long as the pattern does not change. This is only worth it when the
+  // distributor is reused for the same pattern, as the received items are
+  // then copied once more.
+  //
+  // If setNodeAwareRouting() was called on comm, the items for the processes
+  // of another node are sent in a single message to one of them, the relay,
+  // which forwards them over the node. The relay of a node is chosen by the
+  // rank of the sender within its own node, so that the relaying is spread
+  // over the processes of the node. This takes precedence over the persistent
+  // communication.
+  Distributor(MPI_Comm comm,
+              SourceDiscovery source_discovery = SourceDiscovery::Alltoall,
+              bool persistent_communication = false)
       : _comm(comm)
+      , _source_discovery(source_discovery)
+      , _persistent_communication(persistent_communication)
+      , _node_topology(getNodeTopology(comm))
       , _permute{Kokkos::view_alloc(Kokkos::WithoutInitializing,
                                     "ArborX::Distributor::permute"),
                  0}
@@ -222,6 +436,8 @@ public:
     static_assert(
         std::is_same<typename View::non_const_value_type, int>::value);
 
+    clearPattern();
+
     // The next two function calls are the only difference to the other
     // overload.
     // Note that we don't resize _permute here since we are assuming that no
@@ -240,6 +456,8 @@ public:
     static_assert(
         std::is_same<typename View::non_const_value_type, int>::value);
 
+    clearPattern();
+
     // The next two function calls are the only difference to the other
     // overload.
     KokkosExt::reallocWithoutInitializing(space, _permute,
@@ -250,9 +468,60 @@ public:
     return preparePointToPointCommunication();
   }
 
+  // Reverse of the pattern of other: the items received from each of its
+  // sources are sent back to it, in the order in which they were received, and
+  // the items sent to each of its destinations come back from it, in the
+  // order of the send buffer of other. Other numbers of items may be sent to
+  // the sources of other and received from its destinations, given in the
+  // order of getSources() and getDestinations() of other. As all the processes
+  // know the reverse pattern already, they are not involved.
+  size_t createReverse(Distributor const &other,
+                       std::vector<int> dest_counts = {},
+                       std::vector<int> src_counts = {})
+  {
+    clearPattern();
+
+    _destinations = other._sources;
+    _dest_counts = (dest_counts.empty() ? other._src_counts
+                                        : std::move(dest_counts));
+    _sources = other._destinations;
+    _src_counts =
+        (src_counts.empty() ? other._dest_counts : std::move(src_counts));
+    ARBORX_ASSERT(_dest_counts.size() == _destinations.size());
+    ARBORX_ASSERT(_src_counts.size() == _sources.size());
+
+    _dest_offsets.push_back(0);
+    for (auto const count : _dest_counts)
+      _dest_offsets.push_back(_dest_offsets.back() + count);
+    _src_offsets.clear();
+    _src_offsets.push_back(0);
+    for (auto const count : _src_counts)
+      _src_offsets.push_back(_src_offsets.back() + count);
+    _has_sources = true;
+    _persistent_exchanges.clear();
+
+    if (_node_topology != nullptr)
+      prepareNodeAwareRouting();
+
+    return _src_offsets.back();
+  }
+
   template <typename ExecutionSpace, typename ExportView, typename ImportView>
   void doPostsAndWaits(ExecutionSpace const &space, ExportView const &exports,
                        size_t num_packets, ImportView const &imports) const
+  {
+    doPostsAndProcess(space, exports, num_packets, imports, [](int, int) {});
+  }
+
+  // Same as doPostsAndWaits, but process(begin, end) is called on each range
+  // [begin, end) of imported items as soon as it has been received, so that
+  // processing overlaps the communication of the others. The items a process
+  // sends to itself come first. Their copy is enqueued on space.
+  template <typename ExecutionSpace, typename ExportView, typename ImportView,
+            typename Process>
+  void doPostsAndProcess(ExecutionSpace const &space, ExportView const &exports,
+                         size_t num_packets, ImportView const &imports,
+                         Process const &process) const
   {
     ARBORX_ASSERT(num_packets * _src_offsets.back() == imports.size());
     ARBORX_ASSERT(num_packets * _dest_offsets.back() == exports.size());
@@ -267,6 +536,24 @@ public:
         std::is_same<typename ExportView::memory_space,
                      typename decltype(_permute)::memory_space>::value);
 
+    if constexpr (ExportView::rank == 1 &&
+                  std::is_same_v<typename ImportView::memory_space,
+                                 MemorySpace>)
+    {
+      if (_node_topology != nullptr)
+      {
+        doNodeAwarePostsAndProcess(space, exports, num_packets, imports,
+                                   process);
+        return;
+      }
+      if (_persistent_communication)
+      {
+        doPersistentPostsAndProcess(space, exports, num_packets, imports,
+                                    process);
+        return;
+      }
+    }
+
     // This allows function to work even when ExportView is unmanaged.
     using ExportViewWithoutMemoryTraits =
         Kokkos::View<typename ExportView::data_type,
@@ -330,8 +617,10 @@ public:
     MPI_Comm_size(_comm, &comm_size);
     int const indegrees = _sources.size();
     int const outdegrees = _destinations.size();
-    std::vector<MPI_Request> requests;
-    requests.reserve(outdegrees + indegrees);
+    std::vector<MPI_Request> receive_requests;
+    std::vector<int> receive_sources;
+    receive_requests.reserve(indegrees);
+    receive_sources.reserve(indegrees);
     for (int i = 0; i < indegrees; ++i)
     {
       if (_sources[i] != comm_rank)
@@ -340,9 +629,10 @@ public:
             _src_counts[i] * num_packets * sizeof(ValueType);
         auto const receive_buffer_ptr =
             imports.data() + _src_offsets[i] * num_packets;
-        requests.emplace_back();
+        receive_requests.emplace_back();
+        receive_sources.push_back(i);
         MPI_Irecv(receive_buffer_ptr, message_size, MPI_BYTE, _sources[i], 123,
-                  _comm, &requests.back());
+                  _comm, &receive_requests.back());
       }
     }
 
@@ -351,6 +641,9 @@ public:
       space.fence("ArborX::Distributor::doPostsAndWaits"
                   " (permute done before packing data into send buffer)");
 
+    std::vector<MPI_Request> send_requests;
+    send_requests.reserve(outdegrees);
+    int self_position = -1;
     for (int i = 0; i < outdegrees; ++i)
     {
       auto const message_size =
@@ -362,6 +655,7 @@ public:
         auto const it = std::find(_sources.begin(), _sources.end(), comm_rank);
         ARBORX_ASSERT(it != _sources.end());
         auto const position = it - _sources.begin();
+        self_position = position;
         auto const receive_buffer_ptr =
             imports.data() + _src_offsets[position] * num_packets;
 
@@ -376,19 +670,800 @@ public:
       }
       else
       {
-        requests.emplace_back();
+        send_requests.emplace_back();
         MPI_Isend(send_buffer_ptr, message_size, MPI_BYTE, _destinations[i],
-                  123, _comm, &requests.back());
+                  123, _comm, &send_requests.back());
       }
     }
-    if (!requests.empty())
-      MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+    if (self_position != -1)
+      process(_src_offsets[self_position], _src_offsets[self_position + 1]);
+
+    // Process the messages in the order in which they complete
+    int n_pending = receive_requests.size();
+    std::vector<int> completed(n_pending);
+    while (n_pending > 0)
+    {
+      int n_completed;
+      MPI_Waitsome(receive_requests.size(), receive_requests.data(),
+                   &n_completed, completed.data(), MPI_STATUSES_IGNORE);
+      for (int k = 0; k < n_completed; ++k)
+      {
+        int const i = receive_sources[completed[k]];
+        process(_src_offsets[i], _src_offsets[i + 1]);
+      }
+      n_pending -= n_completed;
+    }
+
+    if (!send_requests.empty())
+      MPI_Waitall(send_requests.size(), send_requests.data(),
+                  MPI_STATUSES_IGNORE);
+  }
+  // Starts the exchange and returns without waiting for its messages. The
+  // exports are packed into a send buffer held by the request, so that they
+  // may be modified right away, and the items a process sends to itself are
+  // copied on space. The messages go directly to the destinations, whether or
+  // not the routing through the nodes or the persistent communication is
+  // enabled, and with the tag of the request they belong to (see
+  // nextAsyncTag()), so that other exchanges, including those of other
+  // requests, may take place on the communicator in the meantime.
+  template <typename ExecutionSpace, typename ExportView, typename ImportView>
+  DistributorRequest doPosts(ExecutionSpace const &space,
+                             ExportView const &exports, size_t num_packets,
+                             ImportView const &imports, int tag) const
+  {
+    ARBORX_ASSERT(tag >= first_async_tag &&
+                  tag < first_async_tag + num_async_tags);
+    ARBORX_ASSERT(num_packets * _src_offsets.back() == imports.size());
+    ARBORX_ASSERT(num_packets * _dest_offsets.back() == exports.size());
+
+    using ValueType = typename ImportView::value_type;
+    static_assert(
+        std::is_same<ValueType,
+                     std::remove_cv_t<typename ExportView::value_type>>::value);
+    static_assert(ExportView::rank == 1 && ImportView::rank == 1);
+    static_assert(
+        std::is_same_v<typename ExportView::memory_space, MemorySpace> &&
+        std::is_same_v<typename ImportView::memory_space, MemorySpace>);
+
+    Kokkos::View<ValueType *, MemorySpace> send_buffer(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::Distributor::doPosts::send_buffer"),
+        exports.size());
+    // If _permute is empty, we are assuming that we don't need to permute
+    // exports.
+    if (_permute.size() != 0)
+      ArborX::Details::applyInversePermutation(space, _permute, exports,
+                                               send_buffer);
+    else
+      Kokkos::deep_copy(space, send_buffer, exports);
+    space.fence("ArborX::Distributor::doPosts (pack data into send buffer)");
+
+    auto const range = [num_packets](int begin, int end) {
+      return std::make_pair(begin * num_packets, end * num_packets);
+    };
+
+    int comm_rank;
+    MPI_Comm_rank(_comm, &comm_rank);
+    DistributorRequest request;
+    request._requests.reserve(_sources.size() + _destinations.size());
+    request._send_buffer =
+        std::make_shared<decltype(send_buffer)>(send_buffer);
+    int self_source = -1;
+    for (int i = 0; i < (int)_sources.size(); ++i)
+    {
+      if (_sources[i] == comm_rank)
+      {
+        self_source = i;
+        continue;
+      }
+      request._requests.emplace_back();
+      MPI_Irecv(imports.data() + _src_offsets[i] * num_packets,
+                _src_counts[i] * num_packets * sizeof(ValueType), MPI_BYTE,
+                _sources[i], tag, _comm, &request._requests.back());
+    }
+    for (int i = 0; i < (int)_destinations.size(); ++i)
+    {
+      if (_destinations[i] == comm_rank)
+      {
+        ARBORX_ASSERT(self_source != -1);
+        Kokkos::deep_copy(
+            space,
+            Kokkos::subview(imports, range(_src_offsets[self_source],
+                                           _src_offsets[self_source + 1])),
+            Kokkos::subview(send_buffer,
+                            range(_dest_offsets[i], _dest_offsets[i + 1])));
+        continue;
+      }
+      request._requests.emplace_back();
+      MPI_Isend(send_buffer.data() + _dest_offsets[i] * num_packets,
+                _dest_counts[i] * num_packets * sizeof(ValueType), MPI_BYTE,
+                _destinations[i], tag, _comm, &request._requests.back());
+    }
+    return request;
   }
+
   size_t getTotalReceiveLength() const { return _src_offsets.back(); }
   size_t getTotalSendLength() const { return _dest_offsets.back(); }
+  // The imported items [getSourceOffsets()[i], getSourceOffsets()[i + 1])
+  // come from process getSources()[i]
+  std::vector<int> const &getSources() const { return _sources; }
+  std::vector<int> const &getSourceOffsets() const { return _src_offsets; }
+  // The exported items [getDestinationOffsets()[i],
+  // getDestinationOffsets()[i + 1]) of the send buffer go to process
+  // getDestinations()[i]
+  std::vector<int> const &getDestinations() const { return _destinations; }
+  std::vector<int> const &getDestinationOffsets() const
+  {
+    return _dest_offsets;
+  }
 
 private:
+  // A distributor may be reused. The sources found for the previous pattern
+  // are kept until it is known whether the new one is the same.
+  void clearPattern()
+  {
+    _previous_destinations = std::move(_destinations);
+    _previous_dest_counts = std::move(_dest_counts);
+    _destinations.clear();
+    _dest_counts.clear();
+    _dest_offsets.clear();
+    _permute = Kokkos::View<int *, DeviceType>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, _permute.label()), 0);
+  }
+
+  using MemorySpace = typename DeviceType::memory_space;
+
+  // Buffers and persistent requests of the exchanges of items of a given size
+  // for the current pattern. The requests only differ from one exchange to the
+  // next by the data in the buffers, so that they are set up once.
+  struct PersistentExchange
+  {
+    PersistentExchange() = default;
+    PersistentExchange(PersistentExchange const &) = delete;
+    PersistentExchange &operator=(PersistentExchange const &) = delete;
+    ~PersistentExchange()
+    {
+      for (auto &request : send_requests)
+        MPI_Request_free(&request);
+      for (auto &request : receive_requests)
+        MPI_Request_free(&request);
+    }
+
+    Kokkos::View<unsigned char *, MemorySpace> send_buffer;
+    Kokkos::View<unsigned char *, MemorySpace> receive_buffer;
+    std::vector<MPI_Request> send_requests;
+    std::vector<MPI_Request> receive_requests;
+    // Positions in _sources of the receive requests
+    std::vector<int> receive_sources;
+    // Positions in _destinations and _sources of the process itself
+    int self_destination = -1;
+    int self_source = -1;
+  };
+
+  PersistentExchange &persistentExchange(size_t item_size) const
+  {
+    auto it = _persistent_exchanges.find(item_size);
+    if (it != _persistent_exchanges.end())
+      return it->second;
+
+    auto &exchange = _persistent_exchanges[item_size];
+    exchange.send_buffer = Kokkos::View<unsigned char *, MemorySpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                           "ArborX::Distributor::persistent_send_buffer"),
+        _dest_offsets.back() * item_size);
+    exchange.receive_buffer = Kokkos::View<unsigned char *, MemorySpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                           "ArborX::Distributor::persistent_receive_buffer"),
+        _src_offsets.back() * item_size);
+
+    int comm_rank;
+    MPI_Comm_rank(_comm, &comm_rank);
+    int const indegrees = _sources.size();
+    for (int i = 0; i < indegrees; ++i)
+    {
+      if (_sources[i] == comm_rank)
+      {
+        exchange.self_source = i;
+        continue;
+      }
+      exchange.receive_requests.emplace_back();
+      exchange.receive_sources.push_back(i);
+      MPI_Recv_init(exchange.receive_buffer.data() +
+                        _src_offsets[i] * item_size,
+                    _src_counts[i] * item_size, MPI_BYTE, _sources[i], 123,
+                    _comm, &exchange.receive_requests.back());
+    }
+    int const outdegrees = _destinations.size();
+    for (int i = 0; i < outdegrees; ++i)
+    {
+      if (_destinations[i] == comm_rank)
+      {
+        exchange.self_destination = i;
+        continue;
+      }
+      exchange.send_requests.emplace_back();
+      MPI_Send_init(exchange.send_buffer.data() + _dest_offsets[i] * item_size,
+                    _dest_counts[i] * item_size, MPI_BYTE, _destinations[i],
+                    123, _comm, &exchange.send_requests.back());
+    }
+    return exchange;
+  }
+
+  template <typename ExecutionSpace, typename ExportView, typename ImportView,
+            typename Process>
+  void doPersistentPostsAndProcess(ExecutionSpace const &space,
+                                   ExportView const &exports,
+                                   size_t num_packets,
+                                   ImportView const &imports,
+                                   Process const &process) const
+  {
+    using ValueType = typename ImportView::value_type;
+    using UnmanagedView =
+        Kokkos::View<ValueType *, MemorySpace,
+                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+
+    auto &exchange = persistentExchange(num_packets * sizeof(ValueType));
+    UnmanagedView send_view(
+        reinterpret_cast<ValueType *>(exchange.send_buffer.data()),
+        exports.size());
+    UnmanagedView receive_view(
+        reinterpret_cast<ValueType *>(exchange.receive_buffer.data()),
+        imports.size());
+
+    auto &receive_requests = exchange.receive_requests;
+    if (!receive_requests.empty())
+      MPI_Startall(receive_requests.size(), receive_requests.data());
+
+    // If _permute is empty, we are assuming that we don't need to permute
+    // exports.
+    if (_permute.size() != 0)
+      ArborX::Details::applyInversePermutation(space, _permute, exports,
+                                               send_view);
+    else
+      Kokkos::deep_copy(space, send_view, exports);
+    space.fence("ArborX::Distributor::doPostsAndWaits"
+                " (pack data into persistent send buffer)");
+
+    auto &send_requests = exchange.send_requests;
+    if (!send_requests.empty())
+      MPI_Startall(send_requests.size(), send_requests.data());
+
+    auto const range = [num_packets](int begin, int end) {
+      return std::make_pair(begin * num_packets, end * num_packets);
+    };
+
+    if (exchange.self_destination != -1)
+    {
+      int const i = exchange.self_source;
+      int const j = exchange.self_destination;
+      Kokkos::deep_copy(
+          space,
+          Kokkos::subview(imports, range(_src_offsets[i], _src_offsets[i + 1])),
+          Kokkos::subview(send_view,
+                          range(_dest_offsets[j], _dest_offsets[j + 1])));
+      process(_src_offsets[i], _src_offsets[i + 1]);
+    }
+
+    // Process the messages in the order in which they complete
+    int n_pending = receive_requests.size();
+    std::vector<int> completed(n_pending);
+    while (n_pending > 0)
+    {
+      int n_completed;
+      MPI_Waitsome(receive_requests.size(), receive_requests.data(),
+                   &n_completed, completed.data(), MPI_STATUSES_IGNORE);
+      for (int k = 0; k < n_completed; ++k)
+      {
+        int const i = exchange.receive_sources[completed[k]];
+        auto const items = range(_src_offsets[i], _src_offsets[i + 1]);
+        Kokkos::deep_copy(space, Kokkos::subview(imports, items),
+                          Kokkos::subview(receive_view, items));
+        process(_src_offsets[i], _src_offsets[i + 1]);
+      }
+      n_pending -= n_completed;
+    }
+
+    // The send buffer is only overwritten by the next exchange once the sends
+    // have completed
+    if (!send_requests.empty())
+      MPI_Waitall(send_requests.size(), send_requests.data(),
+                  MPI_STATUSES_IGNORE);
+  }
+
+  // Copies of ranges [source_begin, source_begin + count) of items to
+  // [destination_begin, destination_begin + count), done in a single kernel.
+  // The segments hold the source and destination beginnings, and the number of
+  // items in the previous segments.
+  struct SegmentCopy
+  {
+    Kokkos::View<int *[3], MemorySpace> segments;
+    int size = 0;
+  };
+
+  // From (source begin, destination begin, count) on the host
+  static SegmentCopy
+  makeSegmentCopy(std::vector<std::array<int, 3>> const &segments)
+  {
+    SegmentCopy copy;
+    int num_segments = 0;
+    for (auto const &segment : segments)
+      if (segment[2] > 0)
+        ++num_segments;
+    copy.segments = Kokkos::View<int *[3], MemorySpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                           "ArborX::Distributor::segments"),
+        num_segments);
+    auto segments_host = Kokkos::create_mirror_view(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing), copy.segments);
+    int k = 0;
+    for (auto const &segment : segments)
+    {
+      if (segment[2] == 0)
+        continue;
+      segments_host(k, 0) = segment[0];
+      segments_host(k, 1) = segment[1];
+      segments_host(k, 2) = copy.size;
+      copy.size += segment[2];
+      ++k;
+    }
+    Kokkos::deep_copy(copy.segments, segments_host);
+    return copy;
+  }
+
+  template <typename ExecutionSpace, typename SourceView,
+            typename DestinationView>
+  static void copySegments(ExecutionSpace const &space,
+                           SegmentCopy const &copy, SourceView const &source,
+                           DestinationView const &destination,
+                           size_t num_packets)
+  {
+    auto const segments = copy.segments;
+    int const num_segments = segments.extent(0);
+    Kokkos::parallel_for(
+        "ArborX::Distributor::copy_segments",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, copy.size * num_packets),
+        KOKKOS_LAMBDA(size_t j) {
+          int const t = j / num_packets;
+          int const packet = j % num_packets;
+          // Last segment starting at or before t
+          int first = 0;
+          int last = num_segments;
+          while (last - first > 1)
+          {
+            int const middle = (first + last) / 2;
+            if (segments(middle, 2) <= t)
+              first = middle;
+            else
+              last = middle;
+          }
+          int const k = t - segments(first, 2);
+          destination((segments(first, 1) + k) * num_packets + packet) =
+              source((segments(first, 0) + k) * num_packets + packet);
+        });
+  }
+
+  // Messages of the routing through the nodes, in items. The sends (tag 123)
+  // go directly to the processes of the node and to the relays of the other
+  // nodes. The relays forward what they receive from the other nodes to the
+  // processes of their node (tag 125).
+  struct NodeAwareRouting
+  {
+    struct Message
+    {
+      int rank;
+      int offset;
+      int count;
+    };
+    std::vector<Message> sends;
+    SegmentCopy pack; // from the destination layout to the send buffer
+    int send_size = 0;
+    // Positions in _destinations and _sources of the process itself
+    int self_destination = -1;
+    int self_source = -1;
+    // Positions in _sources of the processes of the node sending directly
+    std::vector<int> direct_receives;
+    // As a relay, from the processes of the other nodes, with where their
+    // items go in the imports and in the relay sends, the positions in
+    // _sources of the former, and the relay sends they contribute to
+    std::vector<Message> relay_receives;
+    std::vector<SegmentCopy> relay_imports;
+    std::vector<SegmentCopy> relay_forwards;
+    std::vector<std::vector<int>> relay_import_sources;
+    std::vector<std::vector<int>> relay_forward_sends;
+    int relay_receive_size = 0;
+    // As a relay, to the processes of the node, with the number of relay
+    // receives each one waits for
+    std::vector<Message> relay_sends;
+    std::vector<int> relay_send_contributions;
+    int relay_send_size = 0;
+    // From the relays of the node, with where the items go in the imports and
+    // the positions in _sources of the processes they come from
+    std::vector<Message> relayed_receives;
+    std::vector<SegmentCopy> relayed_imports;
+    std::vector<std::vector<int>> relayed_sources;
+    int relayed_receive_size = 0;
+  };
+
+  void prepareNodeAwareRouting()
+  {
+    auto &routing = _node_aware_routing;
+    routing = NodeAwareRouting{};
+    auto const &topology = *_node_topology;
+
+    int comm_rank;
+    MPI_Comm_rank(_comm, &comm_rank);
+    int const node = topology.nodes[comm_rank];
+    auto const &node_ranks = topology.node_ranks[node];
+    int const node_size = node_ranks.size();
+
+    // Process receiving the message from source to destination
+    auto const relay = [&topology](int source, int destination) {
+      if (topology.nodes[source] == topology.nodes[destination])
+        return destination;
+      auto const &ranks = topology.node_ranks[topology.nodes[destination]];
+      return ranks[topology.local_ranks[source] % ranks.size()];
+    };
+
+    // The items for a relay are sent in the order of their destinations
+    int const outdegrees = _destinations.size();
+    std::vector<std::pair<int, int>> relays_and_destinations(outdegrees);
+    for (int i = 0; i < outdegrees; ++i)
+      relays_and_destinations[i] = {relay(comm_rank, _destinations[i]), i};
+    std::sort(relays_and_destinations.begin(), relays_and_destinations.end(),
+              [this](auto const &a, auto const &b) {
+                return std::make_pair(a.first, _destinations[a.second]) <
+                       std::make_pair(b.first, _destinations[b.second]);
+              });
+    std::vector<std::array<int, 3>> pack_segments;
+    for (auto const &[relay_rank, i] : relays_and_destinations)
+    {
+      if (_destinations[i] == comm_rank)
+      {
+        routing.self_destination = i;
+        continue;
+      }
+      if (routing.sends.empty() || routing.sends.back().rank != relay_rank)
+        routing.sends.push_back({relay_rank, routing.send_size, 0});
+      routing.sends.back().count += _dest_counts[i];
+      pack_segments.push_back(
+          {_dest_offsets[i], routing.send_size, _dest_counts[i]});
+      routing.send_size += _dest_counts[i];
+    }
+    routing.pack = makeSegmentCopy(pack_segments);
+
+    int const indegrees = _sources.size();
+    for (int i = 0; i < indegrees; ++i)
+    {
+      if (_sources[i] == comm_rank)
+        routing.self_source = i;
+      else if (topology.nodes[_sources[i]] == node)
+        routing.direct_receives.push_back(i);
+    }
+
+    // The relays of the node forward the items from the other nodes in the
+    // order of the processes they come from
+    for (int q : node_ranks)
+    {
+      if (q == comm_rank)
+        continue;
+      typename NodeAwareRouting::Message message{
+          q, routing.relayed_receive_size, 0};
+      std::vector<std::array<int, 3>> segments;
+      std::vector<int> sources;
+      for (int i = 0; i < indegrees; ++i)
+        if (topology.nodes[_sources[i]] != node &&
+            relay(_sources[i], comm_rank) == q)
+        {
+          segments.push_back({message.offset + message.count, _src_offsets[i],
+                              _src_counts[i]});
+          message.count += _src_counts[i];
+          sources.push_back(i);
+        }
+      if (message.count == 0)
+        continue;
+      routing.relayed_receives.push_back(message);
+      routing.relayed_imports.push_back(makeSegmentCopy(segments));
+      routing.relayed_sources.push_back(std::move(sources));
+      routing.relayed_receive_size += message.count;
+    }
+
+    // What this process relays follows from the sources of the processes of
+    // the node
+    std::vector<int> node_indegrees(node_size);
+    MPI_Allgather(&indegrees, 1, MPI_INT, node_indegrees.data(), 1, MPI_INT,
+                  topology.node_comm);
+    std::vector<int> node_displs(node_size + 1, 0);
+    for (int l = 0; l < node_size; ++l)
+      node_displs[l + 1] = node_displs[l] + node_indegrees[l];
+    std::vector<int> node_sources(node_displs.back());
+    std::vector<int> node_src_counts(node_displs.back());
+    MPI_Allgatherv(_sources.data(), indegrees, MPI_INT, node_sources.data(),
+                   node_indegrees.data(), node_displs.data(), MPI_INT,
+                   topology.node_comm);
+    MPI_Allgatherv(_src_counts.data(), indegrees, MPI_INT,
+                   node_src_counts.data(), node_indegrees.data(),
+                   node_displs.data(), MPI_INT, topology.node_comm);
+
+    // Destinations and counts of the relayed items of each source, and
+    // sources and counts of those of each destination
+    std::map<int, std::vector<std::pair<int, int>>> from_sources;
+    std::map<int, std::vector<std::pair<int, int>>> to_destinations;
+    for (int l = 0; l < node_size; ++l)
+      for (int j = node_displs[l]; j < node_displs[l + 1]; ++j)
+      {
+        int const source = node_sources[j];
+        if (topology.nodes[source] != node &&
+            relay(source, node_ranks[l]) == comm_rank)
+          from_sources[source].emplace_back(node_ranks[l], node_src_counts[j]);
+      }
+    for (auto &[source, destinations_and_counts] : from_sources)
+    {
+      std::sort(destinations_and_counts.begin(),
+                destinations_and_counts.end());
+      for (auto const &[destination, count] : destinations_and_counts)
+        if (destination != comm_rank)
+          to_destinations[destination].emplace_back(source, count);
+    }
+
+    std::map<std::pair<int, int>, int> relay_send_positions;
+    std::map<int, int> relay_send_indices;
+    for (auto const &[destination, sources_and_counts] : to_destinations)
+    {
+      relay_send_indices[destination] = routing.relay_sends.size();
+      routing.relay_sends.push_back(
+          {destination, routing.relay_send_size, 0});
+      routing.relay_send_contributions.push_back(sources_and_counts.size());
+      for (auto const &[source, count] : sources_and_counts)
+      {
+        relay_send_positions[{source, destination}] = routing.relay_send_size;
+        routing.relay_sends.back().count += count;
+        routing.relay_send_size += count;
+      }
+    }
+
+    for (auto const &[source, destinations_and_counts] : from_sources)
+    {
+      typename NodeAwareRouting::Message message{
+          source, routing.relay_receive_size, 0};
+      std::vector<std::array<int, 3>> import_segments;
+      std::vector<std::array<int, 3>> forward_segments;
+      std::vector<int> import_sources;
+      std::vector<int> forward_sends;
+      for (auto const &[destination, count] : destinations_and_counts)
+      {
+        int const begin = message.offset + message.count;
+        if (destination == comm_rank)
+        {
+          int const i =
+              std::lower_bound(_sources.begin(), _sources.end(), source) -
+              _sources.begin();
+          import_segments.push_back({begin, _src_offsets[i], count});
+          import_sources.push_back(i);
+        }
+        else
+        {
+          forward_segments.push_back(
+              {begin, relay_send_positions[{source, destination}], count});
+          forward_sends.push_back(relay_send_indices[destination]);
+        }
+        message.count += count;
+      }
+      routing.relay_receives.push_back(message);
+      routing.relay_imports.push_back(makeSegmentCopy(import_segments));
+      routing.relay_forwards.push_back(makeSegmentCopy(forward_segments));
+      routing.relay_import_sources.push_back(std::move(import_sources));
+      routing.relay_forward_sends.push_back(std::move(forward_sends));
+      routing.relay_receive_size += message.count;
+    }
+  }
+
+  template <typename ExecutionSpace, typename ExportView, typename ImportView,
+            typename Process>
+  void doNodeAwarePostsAndProcess(ExecutionSpace const &space,
+                                  ExportView const &exports,
+                                  size_t num_packets,
+                                  ImportView const &imports,
+                                  Process const &process) const
+  {
+    using ValueType = typename ImportView::value_type;
+    auto const &routing = _node_aware_routing;
+
+    auto const buffer = [&space, num_packets](char const *label, int size) {
+      return Kokkos::View<ValueType *, MemorySpace>(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing, label),
+          size * num_packets);
+    };
+    auto const send_buffer =
+        buffer("ArborX::Distributor::node_aware::send_buffer",
+               routing.send_size);
+    auto const relay_receive_buffer =
+        buffer("ArborX::Distributor::node_aware::relay_receive_buffer",
+               routing.relay_receive_size);
+    auto const relay_send_buffer =
+        buffer("ArborX::Distributor::node_aware::relay_send_buffer",
+               routing.relay_send_size);
+    auto const relayed_receive_buffer =
+        buffer("ArborX::Distributor::node_aware::relayed_receive_buffer",
+               routing.relayed_receive_size);
+
+    auto const bytes = [num_packets](int count) {
+      return count * num_packets * sizeof(ValueType);
+    };
+
+    // Kind of the message (direct, relay, or relayed) and its index
+    std::vector<MPI_Request> receive_requests;
+    std::vector<std::pair<int, int>> receives;
+    for (int i : routing.direct_receives)
+    {
+      receive_requests.emplace_back();
+      receives.emplace_back(0, i);
+      MPI_Irecv(imports.data() + _src_offsets[i] * num_packets,
+                bytes(_src_counts[i]), MPI_BYTE, _sources[i], 123, _comm,
+                &receive_requests.back());
+    }
+    for (int k = 0; k < (int)routing.relay_receives.size(); ++k)
+    {
+      auto const &message = routing.relay_receives[k];
+      receive_requests.emplace_back();
+      receives.emplace_back(1, k);
+      MPI_Irecv(relay_receive_buffer.data() + message.offset * num_packets,
+                bytes(message.count), MPI_BYTE, message.rank, 123, _comm,
+                &receive_requests.back());
+    }
+    for (int k = 0; k < (int)routing.relayed_receives.size(); ++k)
+    {
+      auto const &message = routing.relayed_receives[k];
+      receive_requests.emplace_back();
+      receives.emplace_back(2, k);
+      MPI_Irecv(relayed_receive_buffer.data() + message.offset * num_packets,
+                bytes(message.count), MPI_BYTE, message.rank, 125, _comm,
+                &receive_requests.back());
+    }
+
+    auto const range = [num_packets](int begin, int end) {
+      return std::make_pair(begin * num_packets, end * num_packets);
+    };
+    auto const pack = [&](auto const &packed) {
+      copySegments(space, routing.pack, packed, send_buffer, num_packets);
+      if (routing.self_destination != -1)
+      {
+        int const i = routing.self_source;
+        int const j = routing.self_destination;
+        Kokkos::deep_copy(
+            space,
+            Kokkos::subview(imports,
+                            range(_src_offsets[i], _src_offsets[i + 1])),
+            Kokkos::subview(packed,
+                            range(_dest_offsets[j], _dest_offsets[j + 1])));
+      }
+    };
+    // If _permute is empty, we are assuming that we don't need to permute
+    // exports.
+    if (_permute.size() != 0)
+    {
+      Kokkos::View<ValueType *, MemorySpace> permuted(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                             "ArborX::Distributor::node_aware::permuted"),
+          exports.size());
+      ArborX::Details::applyInversePermutation(space, _permute, exports,
+                                               permuted);
+      pack(permuted);
+    }
+    else
+    {
+      pack(exports);
+    }
+    space.fence("ArborX::Distributor::doPostsAndWaits"
+                " (pack data into node-aware send buffer)");
+
+    std::vector<MPI_Request> send_requests;
+    send_requests.reserve(routing.sends.size() + routing.relay_sends.size());
+    for (auto const &message : routing.sends)
+    {
+      send_requests.emplace_back();
+      MPI_Isend(send_buffer.data() + message.offset * num_packets,
+                bytes(message.count), MPI_BYTE, message.rank, 123, _comm,
+                &send_requests.back());
+    }
+
+    auto const process_source = [&](int i) {
+      process(_src_offsets[i], _src_offsets[i + 1]);
+    };
+    if (routing.self_source != -1)
+      process_source(routing.self_source);
+
+    // Forward the relayed items as soon as all of those for a process are in,
+    // and process the messages in the order in which they complete
+    auto contributions = routing.relay_send_contributions;
+    int n_pending = receive_requests.size();
+    std::vector<int> completed(n_pending);
+    while (n_pending > 0)
+    {
+      int n_completed;
+      MPI_Waitsome(receive_requests.size(), receive_requests.data(),
+                   &n_completed, completed.data(), MPI_STATUSES_IGNORE);
+      for (int c = 0; c < n_completed; ++c)
+      {
+        auto const [kind, k] = receives[completed[c]];
+        if (kind == 0)
+        {
+          process_source(k);
+        }
+        else if (kind == 1)
+        {
+          copySegments(space, routing.relay_imports[k], relay_receive_buffer,
+                       imports, num_packets);
+          copySegments(space, routing.relay_forwards[k], relay_receive_buffer,
+                       relay_send_buffer, num_packets);
+          std::vector<int> ready;
+          for (int f : routing.relay_forward_sends[k])
+            if (--contributions[f] == 0)
+              ready.push_back(f);
+          if (!ready.empty())
+            space.fence("ArborX::Distributor::doPostsAndWaits"
+                        " (relayed data copied into send buffer)");
+          for (int f : ready)
+          {
+            auto const &message = routing.relay_sends[f];
+            send_requests.emplace_back();
+            MPI_Isend(relay_send_buffer.data() + message.offset * num_packets,
+                      bytes(message.count), MPI_BYTE, message.rank, 125, _comm,
+                      &send_requests.back());
+          }
+          for (int i : routing.relay_import_sources[k])
+            process_source(i);
+        }
+        else
+        {
+          copySegments(space, routing.relayed_imports[k],
+                       relayed_receive_buffer, imports, num_packets);
+          for (int i : routing.relayed_sources[k])
+            process_source(i);
+        }
+      }
+      n_pending -= n_completed;
+    }
+
+    if (!send_requests.empty())
+      MPI_Waitall(send_requests.size(), send_requests.data(),
+                  MPI_STATUSES_IGNORE);
+  }
+
   size_t preparePointToPointCommunication()
+  {
+    // The sources only depend on the destinations and counts of all the
+    // processes, so that they can be reused if none of them changed
+    if (_has_sources)
+    {
+      int unchanged = (_destinations == _previous_destinations &&
+                       _dest_counts == _previous_dest_counts);
+      MPI_Allreduce(MPI_IN_PLACE, &unchanged, 1, MPI_INT, MPI_LAND, _comm);
+      if (unchanged)
+        return _src_offsets.back();
+    }
+
+    _persistent_exchanges.clear();
+    _sources.clear();
+    _src_counts.clear();
+    _src_offsets.clear();
+    if (_source_discovery == SourceDiscovery::NonBlockingConsensus)
+      discoverSourcesWithNonBlockingConsensus();
+    else
+      discoverSourcesWithAlltoall();
+
+    _src_offsets.push_back(0);
+    for (auto const count : _src_counts)
+      _src_offsets.push_back(_src_offsets.back() + count);
+    _has_sources = true;
+
+    if (_node_topology != nullptr)
+      prepareNodeAwareRouting();
+
+    return _src_offsets.back();
+  }
+
+  void discoverSourcesWithAlltoall()
   {
     int comm_size;
     MPI_Comm_size(_comm, &comm_size);
@@ -402,19 +1477,80 @@ private:
     MPI_Alltoall(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, src_counts_dense.data(), 1,
                  MPI_INT, _comm);
 
-    _src_offsets.push_back(0);
     for (int i = 0; i < comm_size; ++i)
       if (src_counts_dense[i] > 0)
       {
         _sources.push_back(i);
         _src_counts.push_back(src_counts_dense[i]);
-        _src_offsets.push_back(_src_offsets.back() + _src_counts.back());
       }
+  }
 
-    return _src_offsets.back();
+  // The counts are sent with synchronous sends, which only complete once
+  // received. A process enters a non-blocking barrier once all of its sends
+  // have completed, and keeps receiving until the barrier completes, at which
+  // point all the counts have been received.
+  void discoverSourcesWithNonBlockingConsensus()
+  {
+    constexpr int tag = 124;
+
+    int const dest_size = _destinations.size();
+    std::vector<MPI_Request> send_requests(dest_size);
+    for (int i = 0; i < dest_size; ++i)
+      MPI_Issend(&_dest_counts[i], 1, MPI_INT, _destinations[i], tag, _comm,
+                 &send_requests[i]);
+
+    std::vector<std::pair<int, int>> sources_and_counts;
+    MPI_Request barrier_request;
+    bool in_barrier = false;
+    while (true)
+    {
+      int has_message;
+      MPI_Status status;
+      MPI_Iprobe(MPI_ANY_SOURCE, tag, _comm, &has_message, &status);
+      if (has_message)
+      {
+        int count;
+        MPI_Recv(&count, 1, MPI_INT, status.MPI_SOURCE, tag, _comm,
+                 MPI_STATUS_IGNORE);
+        sources_and_counts.emplace_back(status.MPI_SOURCE, count);
+      }
+
+      int done;
+      if (!in_barrier)
+      {
+        MPI_Testall(dest_size, send_requests.data(), &done,
+                    MPI_STATUSES_IGNORE);
+        if (done)
+        {
+          MPI_Ibarrier(_comm, &barrier_request);
+          in_barrier = true;
+        }
+      }
+      else
+      {
+        MPI_Test(&barrier_request, &done, MPI_STATUS_IGNORE);
+        if (done)
+          break;
+      }
+    }
+    // A process leaving the loop early could otherwise start sending the
+    // counts of the next discovery to one still probing for this one.
+    MPI_Barrier(_comm);
+
+    // Same order as with MPI_Alltoall
+    std::sort(sources_and_counts.begin(), sources_and_counts.end());
+    for (auto const &[source, count] : sources_and_counts)
+    {
+      _sources.push_back(source);
+      _src_counts.push_back(count);
+    }
   }
 
   MPI_Comm _comm;
+  SourceDiscovery _source_discovery;
+  bool _persistent_communication;
+  NodeTopology const *_node_topology;
+  NodeAwareRouting _node_aware_routing;
   Kokkos::View<int *, DeviceType> _permute;
   std::vector<int> _dest_offsets;
   std::vector<int> _dest_counts;
@@ -422,6 +1558,11 @@ private:
   std::vector<int> _src_counts;
   std::vector<int> _sources;
   std::vector<int> _destinations;
+  std::vector<int> _previous_dest_counts;
+  std::vector<int> _previous_destinations;
+  bool _has_sources = false;
+  // Keyed by the size in bytes of the items exchanged
+  mutable std::map<size_t, PersistentExchange> _persistent_exchanges;
 };
 
 } // namespace Details
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_DUAL_TREE_TRAVERSAL_HPP
+#define ARBORX_DETAILS_DUAL_TREE_TRAVERSAL_HPP
+
+#include <ArborX_Callbacks.hpp> // LegacyTreeArchetypeExpression
+#include <ArborX_DetailsAlgorithms.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtViewHelpers.hpp> // reallocWithoutInitializing
+#include <ArborX_Predicates.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+#include <utility> // swap
+
+namespace ArborX::Details
+{
+
+// Walk two hierarchies together, descending simultaneously into the pairs of
+// nodes with intersecting bounding volumes. The traversal proceeds one level
+// at a time so that all the pairs at a given depth are processed in a single
+// kernel. The callback is called as callback(predicate, value_b) for each pair
+// of leaves with intersecting bounding volumes, where the predicate is an
+// intersects() predicate for the bounding volume of the leaf of the first
+// hierarchy with its value attached. Values are replaced with their indices
+// for legacy trees. The callbacks may not request an early exit.
+template <class TreeA, class TreeB, class Callback>
+struct DualTreeTraversal
+{
+  using memory_space = typename TreeA::memory_space;
+  static_assert(std::is_same_v<memory_space, typename TreeB::memory_space>);
+
+  using NodePair = Kokkos::pair<int, int>;
+
+  TreeA _tree_a;
+  TreeB _tree_b;
+  Callback _callback;
+  Kokkos::View<NodePair *, memory_space> _frontier;
+  Kokkos::View<NodePair *, memory_space> _next_frontier;
+  Kokkos::View<int, memory_space> _next_frontier_size;
+
+  template <class ExecutionSpace>
+  DualTreeTraversal(ExecutionSpace const &space, TreeA const &tree_a,
+                    TreeB const &tree_b, Callback const &callback)
+      : _tree_a{tree_a}
+      , _tree_b{tree_b}
+      , _callback{callback}
+  {
+    if (_tree_a.empty() || _tree_b.empty() ||
+        !Details::intersects(_tree_a.bounds(), _tree_b.bounds()))
+      return;
+
+    _frontier = Kokkos::View<NodePair *, memory_space>(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DualTreeTraversal::frontier"),
+        1);
+    _next_frontier = Kokkos::View<NodePair *, memory_space>(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::DualTreeTraversal::next_frontier"),
+        0);
+    _next_frontier_size = Kokkos::View<int, memory_space>(
+        Kokkos::view_alloc(space, "ArborX::DualTreeTraversal::size"));
+    Kokkos::deep_copy(space, Kokkos::subview(_frontier, 0),
+                      NodePair{getRoot(_tree_a), getRoot(_tree_b)});
+
+    int frontier_size = 1;
+    do
+    {
+      // Each pair of nodes yields at most four pairs of children
+      if (_next_frontier.extent_int(0) < 4 * frontier_size)
+        KokkosExt::reallocWithoutInitializing(space, _next_frontier,
+                                              4 * frontier_size);
+      Kokkos::deep_copy(space, _next_frontier_size, 0);
+
+      Kokkos::parallel_for(
+          "ArborX::DualTreeTraversal",
+          Kokkos::RangePolicy<ExecutionSpace>(space, 0, frontier_size), *this);
+
+      Kokkos::deep_copy(space, frontier_size, _next_frontier_size);
+      space.fence();
+      std::swap(_frontier, _next_frontier);
+    } while (frontier_size > 0);
+  }
+
+  template <class Tree>
+  static KOKKOS_FUNCTION bool isLeaf(Tree const &tree, int node)
+  {
+    return tree.size() == 1 || HappyTreeFriends::isLeaf(tree, node);
+  }
+
+  template <class Tree>
+  static KOKKOS_FUNCTION int getRoot(Tree const &tree)
+  {
+    return tree.size() == 1 ? 0 : HappyTreeFriends::getRoot(tree);
+  }
+
+  template <class Tree>
+  static KOKKOS_FUNCTION auto getBoundingVolume(Tree const &tree, int node)
+  {
+    std::decay_t<decltype(tree.bounds())> bounding_volume;
+    if (isLeaf(tree, node))
+      expand(bounding_volume, HappyTreeFriends::getIndexable(tree, node));
+    else
+      bounding_volume = HappyTreeFriends::getInternalBoundingVolume(tree, node);
+    return bounding_volume;
+  }
+
+  template <class Tree>
+  static KOKKOS_FUNCTION decltype(auto) getValue(Tree const &tree, int node)
+  {
+    if constexpr (Kokkos::is_detected_v<LegacyTreeArchetypeExpression, Tree>)
+      return HappyTreeFriends::getValue(tree, node).index;
+    else
+      return HappyTreeFriends::getValue(tree, node);
+  }
+
+  // A leaf has no children and is paired as is with those of the other node
+  template <class Tree>
+  static KOKKOS_FUNCTION int getChildren(Tree const &tree, int node,
+                                         int (&children)[2])
+  {
+    if (isLeaf(tree, node))
+    {
+      children[0] = node;
+      return 1;
+    }
+    children[0] = HappyTreeFriends::getLeftChild(tree, node);
+    children[1] = HappyTreeFriends::getRightChild(tree, node);
+    return 2;
+  }
+
+  KOKKOS_FUNCTION void operator()(int k) const
+  {
+    auto const node_a = _frontier(k).first;
+    auto const node_b = _frontier(k).second;
+
+    int children_a[2];
+    int children_b[2];
+    int const num_children_a = getChildren(_tree_a, node_a, children_a);
+    int const num_children_b = getChildren(_tree_b, node_b, children_b);
+
+    for (int i = 0; i < num_children_a; ++i)
+    {
+      int const child_a = children_a[i];
+      auto const bounding_volume_a = getBoundingVolume(_tree_a, child_a);
+      bool const is_leaf_a = isLeaf(_tree_a, child_a);
+      for (int j = 0; j < num_children_b; ++j)
+      {
+        int const child_b = children_b[j];
+        if (!Details::intersects(bounding_volume_a,
+                                 getBoundingVolume(_tree_b, child_b)))
+          continue;
+
+        if (is_leaf_a && isLeaf(_tree_b, child_b))
+          _callback(ArborX::attach(ArborX::intersects(bounding_volume_a),
+                                   getValue(_tree_a, child_a)),
+                    getValue(_tree_b, child_b));
+        else
+          _next_frontier(Kokkos::atomic_fetch_inc(&_next_frontier_size())) =
+              NodePair{child_a, child_b};
+      }
+    }
+  }
+};
+
+} // namespace ArborX::Details
+
+#endif
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_DYNAMIC_BVH_IMPL_HPP
+#define ARBORX_DETAILS_DYNAMIC_BVH_IMPL_HPP
+
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <string>
+
+namespace ArborX::Details
+{
+
+struct DynamicBVHImpl
+{
+  // Grow the view geometrically so that it holds at least n elements, keeping
+  // the ones it already holds
+  template <typename ExecutionSpace, typename View>
+  static void reserve(ExecutionSpace const &space, View &view, int n,
+                      std::string const &label)
+  {
+    if (view.extent_int(0) >= n)
+      return;
+    if (view.data() == nullptr)
+      view = View(Kokkos::view_alloc(space, Kokkos::WithoutInitializing, label),
+                  n);
+    else
+      Kokkos::resize(Kokkos::view_alloc(space, Kokkos::WithoutInitializing),
+                     view, KokkosExt::max(n, 2 * view.extent_int(0)));
+  }
+
+  // Write the bounding volumes and the identifiers of the values of the
+  // leaves that were not removed, starting at position offset, and return
+  // their number
+  template <typename ExecutionSpace, typename LeafNodes, typename Removed,
+            typename BoundingVolumes, typename Ids>
+  static int gatherLiveValues(ExecutionSpace const &space,
+                              LeafNodes const &leaf_nodes,
+                              Removed const &removed,
+                              BoundingVolumes const &bounding_volumes,
+                              Ids const &ids, int offset)
+  {
+    int count = 0;
+    Kokkos::parallel_scan(
+        "ArborX::DynamicBVH::gather_live_values",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, leaf_nodes.extent(0)),
+        KOKKOS_LAMBDA(int i, int &update, bool final) {
+          auto const &value = leaf_nodes(i).value;
+          if (removed(value.index))
+            return;
+          if (final)
+          {
+            bounding_volumes(offset + update) = value.bounding_volume;
+            ids(offset + update) = value.index;
+          }
+          ++update;
+        },
+        count);
+    return count;
+  }
+
+  // Copy the nodes of the tree, replacing the index of each value by the
+  // identifier of the primitive
+  template <typename ExecutionSpace, typename Tree, typename Ids,
+            typename LeafNodes, typename InternalNodes>
+  static void copyNodes(ExecutionSpace const &space, Tree const &tree,
+                        Ids const &ids, LeafNodes const &leaf_nodes,
+                        InternalNodes const &internal_nodes)
+  {
+    auto const &tree_leaf_nodes = HappyTreeFriends::getLeafNodes(tree);
+    Kokkos::parallel_for(
+        "ArborX::DynamicBVH::copy_leaf_nodes",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, leaf_nodes.extent(0)),
+        KOKKOS_LAMBDA(int i) {
+          auto leaf_node = tree_leaf_nodes(i);
+          leaf_node.value.index = ids(leaf_node.value.index);
+          leaf_nodes(i) = leaf_node;
+        });
+    Kokkos::deep_copy(space, internal_nodes,
+                      HappyTreeFriends::getInternalNodes(tree));
+  }
+};
+
+// Callback skipping the removed primitives, and passing the identifier of the
+// others to the user callback
+template <typename Callback, typename Removed>
+struct DynamicBVHCallback
+{
+  Callback _callback;
+  Removed _removed;
+
+  template <typename Predicate, typename Value>
+  KOKKOS_FUNCTION CallbackTreeTraversalControl
+  operator()(Predicate const &predicate, Value const &value) const
+  {
+    if (!_removed(value.index) &&
+        invoke_callback_and_check_early_exit(_callback, predicate,
+                                             (int)value.index))
+      return CallbackTreeTraversalControl::early_exit;
+    return CallbackTreeTraversalControl::normal_continuation;
+  }
+};
+
+} // namespace ArborX::Details
+
+#endif
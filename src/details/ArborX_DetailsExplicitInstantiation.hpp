@@ -0,0 +1,76 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_EXPLICIT_INSTANTIATION_HPP
+#define ARBORX_DETAILS_EXPLICIT_INSTANTIATION_HPP
+
+#include <ArborX_Config.hpp> // ARBORX_ENABLE_EXPLICIT_INSTANTIATION
+
+#include <Kokkos_Core.hpp>
+
+// With ARBORX_ENABLE_EXPLICIT_INSTANTIATION, the construction of the
+// hierarchies, the queries into compressed row storage, DBSCAN and the minimum
+// spanning tree are compiled once in the ArborX library for the most common
+// argument types, e.g. Kokkos::View<ArborX::Point *, MemorySpace> with the
+// default execution space of MemorySpace, and declared extern in the headers.
+// Other argument types are instantiated in the user code as before.
+//
+// ARBORX_IMPL_FOR_EACH_EXECUTION_SPACE(MACRO, EXTERN) expands to
+// MACRO(EXTERN, ExecutionSpace) for each execution space enabled in Kokkos,
+// where EXTERN is either extern, for the declarations, or empty, for the
+// definitions in the library.
+
+#ifdef KOKKOS_ENABLE_SERIAL
+#define ARBORX_IMPL_FOR_SERIAL(MACRO, EXTERN) MACRO(EXTERN, Kokkos::Serial)
+#else
+#define ARBORX_IMPL_FOR_SERIAL(MACRO, EXTERN)
+#endif
+
+#ifdef KOKKOS_ENABLE_OPENMP
+#define ARBORX_IMPL_FOR_OPENMP(MACRO, EXTERN) MACRO(EXTERN, Kokkos::OpenMP)
+#else
+#define ARBORX_IMPL_FOR_OPENMP(MACRO, EXTERN)
+#endif
+
+#ifdef KOKKOS_ENABLE_THREADS
+#define ARBORX_IMPL_FOR_THREADS(MACRO, EXTERN) MACRO(EXTERN, Kokkos::Threads)
+#else
+#define ARBORX_IMPL_FOR_THREADS(MACRO, EXTERN)
+#endif
+
+#ifdef KOKKOS_ENABLE_CUDA
+#define ARBORX_IMPL_FOR_CUDA(MACRO, EXTERN) MACRO(EXTERN, Kokkos::Cuda)
+#else
+#define ARBORX_IMPL_FOR_CUDA(MACRO, EXTERN)
+#endif
+
+#ifdef KOKKOS_ENABLE_HIP
+#define ARBORX_IMPL_FOR_HIP(MACRO, EXTERN) MACRO(EXTERN, Kokkos::HIP)
+#else
+#define ARBORX_IMPL_FOR_HIP(MACRO, EXTERN)
+#endif
+
+#ifdef KOKKOS_ENABLE_SYCL
+#define ARBORX_IMPL_FOR_SYCL(MACRO, EXTERN)                                    \
+  MACRO(EXTERN, Kokkos::Experimental::SYCL)
+#else
+#define ARBORX_IMPL_FOR_SYCL(MACRO, EXTERN)
+#endif
+
+#define ARBORX_IMPL_FOR_EACH_EXECUTION_SPACE(MACRO, EXTERN)                    \
+  ARBORX_IMPL_FOR_SERIAL(MACRO, EXTERN)                                        \
+  ARBORX_IMPL_FOR_OPENMP(MACRO, EXTERN)                                        \
+  ARBORX_IMPL_FOR_THREADS(MACRO, EXTERN)                                       \
+  ARBORX_IMPL_FOR_CUDA(MACRO, EXTERN)                                          \
+  ARBORX_IMPL_FOR_HIP(MACRO, EXTERN)                                           \
+  ARBORX_IMPL_FOR_SYCL(MACRO, EXTERN)
+
+#endif
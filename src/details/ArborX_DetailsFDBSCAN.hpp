@@ -23,36 +23,27 @@ namespace ArborX
 namespace Details
 {
 
-template <typename MemorySpace>
-struct CountUpToN
-{
-  Kokkos::View<int *, MemorySpace> _counts;
-  int _n;
-
-  template <typename Query, typename Value>
-  KOKKOS_FUNCTION auto operator()(Query const &query, Value const &) const
-  {
-    auto i = getData(query);
-    Kokkos::atomic_increment(&_counts(i));
-
-    if (_counts(i) < _n)
-      return ArborX::CallbackTreeTraversalControl::normal_continuation;
-
-    // Once count reaches threshold, terminate the traversal.
-    return ArborX::CallbackTreeTraversalControl::early_exit;
-  }
-};
-
 template <typename UnionFind, typename CorePointsType>
 struct FDBSCANCallback
 {
   UnionFind _union_find;
   CorePointsType _is_core_point;
+  // Only merge core points (DBSCAN*), leaving border points as noise
+  bool _core_points_only = false;
 
   KOKKOS_FUNCTION auto operator()(int i, int j) const
   {
     bool const is_border_point = !_is_core_point(i);
     bool const neighbor_is_core_point = _is_core_point(j);
+    if (_core_points_only)
+    {
+      if (is_border_point)
+        return ArborX::CallbackTreeTraversalControl::early_exit;
+      if (neighbor_is_core_point)
+        _union_find.merge(i, j);
+      return ArborX::CallbackTreeTraversalControl::normal_continuation;
+    }
+
     if (is_border_point)
     {
       if (neighbor_is_core_point)
@@ -0,0 +1,402 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILSFDBSCANCELLSTENCIL_HPP
+#define ARBORX_DETAILSFDBSCANCELLSTENCIL_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // distance
+#include <ArborX_DetailsCartesianGrid.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsSortUtils.hpp> // sortObjects
+#include <ArborX_DetailsUtils.hpp>     // computeOffsetsInOrderedView
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <climits> // INT_MAX
+
+namespace ArborX::Details
+{
+
+// Cartesian grid of cells of size h = eps/sqrt(dimension) covering a set of
+// points
+template <int DIM>
+struct StencilGrid
+{
+  ExperimentalHyperGeometry::Point<DIM> min_corner;
+  float h;
+  float eps;
+  int core_min_size;
+  Kokkos::Array<int, DIM> extents;
+  // Offset of the indices of the cells of this grid among those of all the
+  // grids
+  size_t first_cell;
+
+  // Coordinate along dimension d of the cell containing x, clamped to the
+  // grid so that the points on the upper bounds are in the last cells
+  KOKKOS_FUNCTION int cellCoordinate(float x, int d) const
+  {
+    int const i = Kokkos::floor((x - min_corner[d]) / h);
+    return KokkosExt::min(KokkosExt::max(i, 0), extents[d] - 1);
+  }
+
+  KOKKOS_FUNCTION size_t cellIndex(int const (&coordinates)[DIM]) const
+  {
+    size_t s = 0;
+    for (int d = DIM - 1; d >= 0; --d)
+      s = s * extents[d] + coordinates[d];
+    return first_cell + s;
+  }
+
+  template <typename Point>
+  KOKKOS_FUNCTION size_t cellIndex(Point const &point) const
+  {
+    int coordinates[DIM];
+    for (int d = 0; d < DIM; ++d)
+      coordinates[d] = cellCoordinate(point[d], d);
+    return cellIndex(coordinates);
+  }
+};
+
+// Points sorted by the cell of a Cartesian grid that contains them. The
+// neighbors within eps of a point are found by going through the points of
+// the cells of a fixed stencil around its cell, without a bounding volume
+// hierarchy. The stencil extends floor(sqrt(dimension)) + 1 cells in each
+// direction, i.e., two cells in 2D and 3D, the cells all of whose points are
+// farther than eps being skipped. Only the nonempty cells are stored, and
+// looked up by a binary search.
+//
+// The points may be split into independent sets, each with its own grid, the
+// cells of all the grids being numbered one after the other. The stencil of a
+// point never leaves its grid, so that the points of different sets are never
+// neighbors.
+template <typename MemorySpace, typename Primitives, int DIM>
+struct CellStencil
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+
+  static constexpr int radius = [] {
+    int r = 1;
+    while (r * r <= DIM)
+      ++r;
+    return r;
+  }();
+
+  Primitives _primitives;
+  Kokkos::View<StencilGrid<DIM> *, MemorySpace> _grids;
+  // Set of each point, empty if there is a single set
+  Kokkos::View<int *, MemorySpace> _sets;
+  // Original indices of the points in the order of their cells
+  Kokkos::View<unsigned int *, MemorySpace> _permute;
+  // Indices of the nonempty cells in increasing order, and the offsets of
+  // their points
+  Kokkos::View<size_t *, MemorySpace> _cells;
+  Kokkos::View<int *, MemorySpace> _cell_offsets;
+
+  KOKKOS_FUNCTION StencilGrid<DIM> const &grid(int i) const
+  {
+    return _grids(_sets.size() == 0 ? 0 : _sets(i));
+  }
+
+  // Position of the cell among the nonempty cells, or -1 if it is empty
+  KOKKOS_FUNCTION int findCell(size_t cell) const
+  {
+    int first = 0;
+    int last = _cells.extent_int(0);
+    while (first < last)
+    {
+      int const middle = first + (last - first) / 2;
+      if (_cells(middle) < cell)
+        first = middle + 1;
+      else
+        last = middle;
+    }
+    return (first < _cells.extent_int(0) && _cells(first) == cell) ? first
+                                                                   : -1;
+  }
+
+  KOKKOS_FUNCTION int numPointsInCellOf(int i) const
+  {
+    int const k = findCell(grid(i).cellIndex(Access::get(_primitives, i)));
+    return _cell_offsets(k + 1) - _cell_offsets(k);
+  }
+
+  // Call f(j) for each point j within eps of point i, i itself included,
+  // until it returns true
+  template <typename F>
+  KOKKOS_FUNCTION void forEachNeighbor(int i, F const &f) const
+  {
+    auto const &grid = this->grid(i);
+    auto const &point = Access::get(_primitives, i);
+    int center[DIM];
+    for (int d = 0; d < DIM; ++d)
+      center[d] = grid.cellCoordinate(point[d], d);
+
+    constexpr int width = 2 * radius + 1;
+    int num_stencil_cells = 1;
+    for (int d = 0; d < DIM; ++d)
+      num_stencil_cells *= width;
+
+    for (int s = 0; s < num_stencil_cells; ++s)
+    {
+      int coordinates[DIM];
+      bool inside = true;
+      // Squared distance between the cells, in units of h, so that the cells
+      // farther than eps = h * sqrt(DIM) are skipped
+      int gap = 0;
+      for (int d = 0, t = s; d < DIM; ++d, t /= width)
+      {
+        int const offset = t % width - radius;
+        int const g = KokkosExt::max(Kokkos::abs(offset) - 1, 0);
+        gap += g * g;
+        coordinates[d] = center[d] + offset;
+        inside &= (0 <= coordinates[d] && coordinates[d] < grid.extents[d]);
+      }
+      if (!inside || gap > DIM)
+        continue;
+
+      int const k = findCell(grid.cellIndex(coordinates));
+      if (k < 0)
+        continue;
+      for (int jj = _cell_offsets(k); jj < _cell_offsets(k + 1); ++jj)
+      {
+        int const j = _permute(jj);
+        if (distance(point, Access::get(_primitives, j)) <= grid.eps && f(j))
+          return;
+      }
+    }
+  }
+};
+
+// Sort the points by cell, once the grids and sets are known
+template <typename ExecutionSpace, typename Stencil>
+void sortPointsByCell(ExecutionSpace const &exec_space, Stencil &stencil)
+{
+  using Access = typename Stencil::Access;
+  using MemorySpace = typename Access::memory_space;
+
+  int const n = Access::size(stencil._primitives);
+  Kokkos::View<size_t *, MemorySpace> cell_indices(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::cell_indices"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::compute_cell_indices",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        cell_indices(i) = stencil.grid(i).cellIndex(
+            Access::get(stencil._primitives, i));
+      });
+
+  stencil._permute = sortObjects(exec_space, cell_indices);
+
+  stencil._cell_offsets = Kokkos::View<int *, MemorySpace>(
+      "ArborX::DBSCAN::cell_offsets", 0);
+  computeOffsetsInOrderedView(exec_space, cell_indices, stencil._cell_offsets);
+
+  int const num_nonempty_cells = stencil._cell_offsets.extent(0) - 1;
+  stencil._cells = Kokkos::View<size_t *, MemorySpace>(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::nonempty_cells"),
+      num_nonempty_cells);
+  auto const &cells = stencil._cells;
+  auto const &cell_offsets = stencil._cell_offsets;
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::compute_nonempty_cells",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_nonempty_cells),
+      KOKKOS_LAMBDA(int k) { cells(k) = cell_indices(cell_offsets(k)); });
+}
+
+template <typename ExecutionSpace, typename Primitives, int DIM>
+auto makeCellStencil(ExecutionSpace const &exec_space,
+                     Primitives const &primitives,
+                     ExperimentalHyperGeometry::Box<DIM> const &bounds,
+                     float eps, int core_min_size)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+
+  float const h = eps / std::sqrt(DIM);
+
+  // Only used to check the extents and the precision of the grid
+  CartesianGrid<DIM> const grid(bounds, h);
+
+  Kokkos::View<StencilGrid<DIM> *, MemorySpace> grids(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::grids"),
+      1);
+  auto grids_host = Kokkos::create_mirror_view(grids);
+  grids_host(0) = {bounds.minCorner(), h, eps, core_min_size, {}, 0};
+  for (int d = 0; d < DIM; ++d)
+  {
+    ARBORX_ASSERT(grid.extent(d) <= (size_t)INT_MAX);
+    grids_host(0).extents[d] = grid.extent(d);
+  }
+  Kokkos::deep_copy(exec_space, grids, grids_host);
+
+  CellStencil<MemorySpace, Primitives, DIM> stencil{primitives, grids};
+  sortPointsByCell(exec_space, stencil);
+  return stencil;
+}
+
+// Same, for the independent sets of points given by their offsets, with one
+// eps and one core_min_size per set. The grids are computed on the device.
+template <typename ExecutionSpace, typename Primitives, typename Offsets,
+          typename Eps, typename CoreMinSizes>
+auto makeBatchedCellStencil(ExecutionSpace const &exec_space,
+                            Primitives const &primitives,
+                            Offsets const &offsets, Eps const &eps,
+                            CoreMinSizes const &core_min_sizes)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  constexpr int DIM = GeometryTraits::dimension_v<
+      typename AccessTraitsHelper<Access>::type>;
+  using Box = ExperimentalHyperGeometry::Box<DIM>;
+
+  int const n = Access::size(primitives);
+  int const num_sets = offsets.extent_int(0) - 1;
+
+  Kokkos::View<int *, MemorySpace> sets(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::sets"),
+      n);
+  Kokkos::View<Box *, MemorySpace> bounds(
+      Kokkos::view_alloc(exec_space, "ArborX::DBSCAN::bounds"), num_sets);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::compute_bounds_of_sets",
+      Kokkos::TeamPolicy<ExecutionSpace>(exec_space, num_sets, Kokkos::AUTO),
+      KOKKOS_LAMBDA(
+          typename Kokkos::TeamPolicy<ExecutionSpace>::member_type const
+              &team) {
+        int const s = team.league_rank();
+        Box set_bounds;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange(team, offsets(s), offsets(s + 1)),
+            [&](int i, Box &update) {
+              sets(i) = s;
+              expand(update, Access::get(primitives, i));
+            },
+            Kokkos::Sum<Box>(set_bounds));
+        Kokkos::single(Kokkos::PerTeam(team), [&] { bounds(s) = set_bounds; });
+      });
+
+  Kokkos::View<StencilGrid<DIM> *, MemorySpace> grids(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::grids"),
+      num_sets);
+  Kokkos::View<size_t *, MemorySpace> num_cells(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::num_cells"),
+      num_sets);
+  int num_invalid_grids = 0;
+  Kokkos::parallel_reduce(
+      "ArborX::DBSCAN::compute_grids",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_sets),
+      KOKKOS_LAMBDA(int s, int &update) {
+        auto &grid = grids(s);
+        grid.min_corner = bounds(s).minCorner();
+        grid.eps = eps(s);
+        grid.h = grid.eps / Kokkos::sqrt((float)DIM);
+        grid.core_min_size = core_min_sizes(s);
+        size_t count = 1;
+        for (int d = 0; d < DIM; ++d)
+        {
+          // The bounds of an empty set are inverted
+          float const delta = KokkosExt::max(
+              bounds(s).maxCorner()[d] - grid.min_corner[d], 0.f);
+          float const extent =
+              KokkosExt::max(Kokkos::ceil(delta / grid.h), 1.f);
+          if (!(grid.eps > 0) || !(extent < (float)INT_MAX))
+          {
+            ++update;
+            grid.extents[d] = 1;
+          }
+          else
+            grid.extents[d] = extent;
+          count *= grid.extents[d];
+        }
+        num_cells(s) = count;
+      },
+      num_invalid_grids);
+  // The eps must be positive and the number of cells along each dimension
+  // addressable
+  ARBORX_ASSERT(num_invalid_grids == 0);
+
+  exclusivePrefixSum(exec_space, num_cells);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::number_cells",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_sets),
+      KOKKOS_LAMBDA(int s) { grids(s).first_cell = num_cells(s); });
+
+  CellStencil<MemorySpace, Primitives, DIM> stencil{primitives, grids, sets};
+  sortPointsByCell(exec_space, stencil);
+  return stencil;
+}
+
+// Count the neighbors within eps of each point, itself included, up to the
+// core_min_size of its set. The core points get INT_MAX, so that they are
+// told apart from the others whatever their set. The points of the cells with
+// at least core_min_size points are within eps of each other and are core
+// points without counting.
+template <typename ExecutionSpace, typename Stencil, typename NumNeigh>
+void countNeighborsUpToN(ExecutionSpace const &exec_space,
+                         Stencil const &stencil, NumNeigh const &num_neigh)
+{
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::count_neighbors_cell_stencil",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0,
+                                          stencil._permute.extent(0)),
+      KOKKOS_LAMBDA(int p) {
+        int const i = stencil._permute(p);
+        int const core_min_size = stencil.grid(i).core_min_size;
+        int count = 0;
+        if (stencil.numPointsInCellOf(i) >= core_min_size)
+          count = core_min_size;
+        else
+          stencil.forEachNeighbor(
+              i, [&](int) { return ++count >= core_min_size; });
+        num_neigh(i) = (count < core_min_size ? count : INT_MAX);
+      });
+}
+
+// Visit each pair of distinct points (i, j) within eps of each other once,
+// as (i, j) with i < j, and pass it to the callback, the traversal for i
+// stopping early if the callback asks to
+template <typename ExecutionSpace, typename Stencil, typename Callback>
+void forEachPairWithinEps(ExecutionSpace const &exec_space,
+                          Stencil const &stencil, Callback const &callback)
+{
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::cell_stencil_traversal",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0,
+                                          stencil._permute.extent(0)),
+      KOKKOS_LAMBDA(int p) {
+        int const i = stencil._permute(p);
+        stencil.forEachNeighbor(i, [&](int j) {
+          return i < j && callback(i, j) ==
+                              CallbackTreeTraversalControl::early_exit;
+        });
+      });
+}
+
+} // namespace ArborX::Details
+
+#endif
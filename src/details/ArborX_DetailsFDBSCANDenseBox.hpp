@@ -13,11 +13,14 @@
 #define ARBORX_DETAILSFDBSCANDENSEBOX_HPP
 
 #include <ArborX_Callbacks.hpp>
+#include <ArborX_DetailsAlgorithms.hpp>
 #include <ArborX_DetailsCartesianGrid.hpp>
 #include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
 #include <ArborX_DetailsKokkosExtViewHelpers.hpp>
+#include <ArborX_DetailsSortUtils.hpp>
 #include <ArborX_DetailsUnionFind.hpp>
 #include <ArborX_DetailsUtils.hpp>
+#include <ArborX_HyperBox.hpp>
 #include <ArborX_Predicates.hpp>
 
 #include <Kokkos_Core.hpp>
@@ -108,6 +111,11 @@ struct FDBSCANDenseBoxCallback
   int _num_points_in_dense_cells;
   Permutation _permute;
   float eps;
+  // Only merge core points (DBSCAN*), leaving border points as noise
+  bool _core_points_only;
+  // The query points are in dense cells, which were all merged with their
+  // neighboring dense cells already (see mergeNeighboringDenseCells)
+  bool _dense_cells_merged = false;
 
   template <typename ExecutionSpace>
   FDBSCANDenseBoxCallback(UnionFind const &union_find,
@@ -115,7 +123,8 @@ struct FDBSCANDenseBoxCallback
                           Primitives const &primitives,
                           DenseCellOffsets const &dense_cell_offsets,
                           ExecutionSpace const &exec_space,
-                          Permutation const &permute, float eps_in)
+                          Permutation const &permute, float eps_in,
+                          bool core_points_only = false)
       : _union_find(union_find)
       , _is_core_point(is_core_point)
       , _primitives(primitives)
@@ -125,6 +134,7 @@ struct FDBSCANDenseBoxCallback
             KokkosExt::lastElement(exec_space, _dense_cell_offsets))
       , _permute(permute)
       , eps(eps_in)
+      , _core_points_only(core_points_only)
   {}
 
   template <typename Query, typename Value>
@@ -143,6 +153,9 @@ struct FDBSCANDenseBoxCallback
 
     if (is_dense_cell)
     {
+      if (_dense_cells_merged)
+        return ArborX::CallbackTreeTraversalControl::normal_continuation;
+
       int const cell_start = _dense_cell_offsets(k);
       int const cell_end = _dense_cell_offsets(k + 1);
 
@@ -182,7 +195,7 @@ struct FDBSCANDenseBoxCallback
       bool const is_neighbor_core_point = _is_core_point(j);
       if (is_neighbor_core_point && i > j)
         _union_find.merge(i, j);
-      else if (!is_neighbor_core_point)
+      else if (!is_neighbor_core_point && !_core_points_only)
         _union_find.merge_into(j, i);
     }
 
@@ -190,15 +203,128 @@ struct FDBSCANDenseBoxCallback
   }
 };
 
-template <typename ExecutionSpace, typename Primitives>
+// Merges a dense cell with the dense cells found within eps of the bounds of
+// its points. Each pair of cells is processed once, by the cell with the
+// smaller index, and stops at the first pair of points within eps.
+template <typename UnionFind, typename Primitives, typename DenseCellOffsets,
+          typename Permutation, typename CellBoxes>
+struct DenseCellPairsCallback
+{
+  UnionFind _union_find;
+  Primitives _primitives;
+  DenseCellOffsets _dense_cell_offsets;
+  int _num_dense_cells;
+  Permutation _permute;
+  CellBoxes _cell_boxes;
+  float eps;
+
+  template <typename Query, typename Value>
+  KOKKOS_FUNCTION void operator()(Query const &query, Value const &value) const
+  {
+    using Access = AccessTraits<Primitives, PrimitivesTag>;
+
+    int const k = value.index;
+    int const c = ArborX::getData(query);
+
+    // Sparse points are handled by the main query
+    if (k >= _num_dense_cells || k <= c)
+      return;
+
+    int const c_start = _dense_cell_offsets(c);
+    int const c_end = _dense_cell_offsets(c + 1);
+    int const k_start = _dense_cell_offsets(k);
+    int const k_end = _dense_cell_offsets(k + 1);
+
+    auto const &k_box = _cell_boxes(k);
+    for (int ii = c_start; ii < c_end; ++ii)
+    {
+      if (_union_find.representative(_permute(c_start)) ==
+          _union_find.representative(_permute(k_start)))
+        return;
+
+      // Only the points close to the other cell may have a neighbor in it
+      auto const &point = Access::get(_primitives, _permute(ii));
+      if (distance(point, k_box) > eps)
+        continue;
+
+      for (int jj = k_start; jj < k_end; ++jj)
+        if (distance(point, Access::get(_primitives, _permute(jj))) <= eps)
+        {
+          _union_find.merge(_permute(c_start), _permute(k_start));
+          return;
+        }
+    }
+  }
+};
+
+// Merge the pairs of dense cells with points within eps of each other, before
+// the main query. The points in dense cells then skip the dense cells in the
+// main query, instead of each of them searching through the points of every
+// neighboring dense cell.
+template <typename ExecutionSpace, typename UnionFind, typename Primitives,
+          typename BVH, typename DenseCellOffsets, typename Permutation>
+void mergeNeighboringDenseCells(ExecutionSpace const &exec_space,
+                                UnionFind const &union_find,
+                                Primitives const &primitives, BVH const &bvh,
+                                DenseCellOffsets const &dense_cell_offsets,
+                                Permutation const &permute, float eps)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename DenseCellOffsets::memory_space;
+  constexpr int dim =
+      GeometryTraits::dimension_v<typename AccessTraitsHelper<Access>::type>;
+  using Box = ExperimentalHyperGeometry::Box<dim>;
+
+  int const num_dense_cells = dense_cell_offsets.size() - 1;
+  if (num_dense_cells < 2)
+    return;
+
+  // Bounds of the points of each dense cell, tighter than the cells of the
+  // grid
+  Kokkos::View<Box *, MemorySpace> cell_boxes(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::dense_cell_boxes"),
+      num_dense_cells);
+  using Predicate = decltype(ArborX::attach(ArborX::intersects(Box{}), int{}));
+  Kokkos::View<Predicate *, MemorySpace> predicates(
+      Kokkos::view_alloc(exec_space, Kokkos::WithoutInitializing,
+                         "ArborX::DBSCAN::dense_cell_predicates"),
+      num_dense_cells);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::compute_dense_cell_boxes",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, num_dense_cells),
+      KOKKOS_LAMBDA(int c) {
+        Box box;
+        for (int jj = dense_cell_offsets(c); jj < dense_cell_offsets(c + 1);
+             ++jj)
+          expand(box, Access::get(primitives, permute(jj)));
+        cell_boxes(c) = box;
+
+        for (int d = 0; d < dim; ++d)
+        {
+          box.minCorner()[d] -= eps;
+          box.maxCorner()[d] += eps;
+        }
+        predicates(c) = ArborX::attach(ArborX::intersects(box), c);
+      });
+
+  bvh.query(exec_space, predicates,
+            DenseCellPairsCallback<UnionFind, Primitives, DenseCellOffsets,
+                                   Permutation, decltype(cell_boxes)>{
+                union_find, primitives, dense_cell_offsets, num_dense_cells,
+                permute, cell_boxes, eps});
+}
+
+template <typename ExecutionSpace, typename Primitives, typename Grid>
 Kokkos::View<size_t *,
              typename AccessTraits<Primitives, PrimitivesTag>::memory_space>
-computeCellIndices(
-    ExecutionSpace const &exec_space, Primitives const &primitives,
-    CartesianGrid<GeometryTraits::dimension_v<typename AccessTraitsHelper<
-        AccessTraits<Primitives, PrimitivesTag>>::type>> const &grid)
+computeCellIndices(ExecutionSpace const &exec_space,
+                   Primitives const &primitives, Grid const &grid)
 {
   using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(
+      Grid::dim ==
+      GeometryTraits::dimension_v<typename AccessTraitsHelper<Access>::type>);
   using MemorySpace = typename Access::memory_space;
 
   auto const n = Access::size(primitives);
@@ -277,6 +403,75 @@ int reorderDenseAndSparseCells(ExecutionSpace const &exec_space,
   return num_points_in_dense_cells;
 }
 
+// Give the points in the sparse cells another chance to be in a dense cell,
+// using a second grid shifted with respect to the first one. This recovers
+// dense groups of points split by the boundaries of the first grid. The dense
+// cells of the second grid are appended to the dense cells, and their indices
+// are offset so as to not collide with the indices of the cells of the first
+// grid. Returns the number of points in the new dense cells.
+template <typename ExecutionSpace, typename Primitives, typename Grid,
+          typename CellIndices, typename Permutation>
+int reorderShiftedDenseCells(ExecutionSpace const &exec_space,
+                             Primitives const &primitives,
+                             Grid const &shifted_grid,
+                             size_t shifted_cell_indices_offset,
+                             int core_min_size, int num_points_in_dense_cells,
+                             CellIndices &sorted_cell_indices,
+                             Permutation &permute)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename CellIndices::memory_space;
+
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+
+  int const n = permute.size();
+  int const num_points_in_sparse_cells = n - num_points_in_dense_cells;
+  auto const sparse_range = Kokkos::make_pair(num_points_in_dense_cells, n);
+
+  auto sparse_cell_indices = KokkosExt::cloneWithoutInitializingNorCopying(
+      exec_space, Kokkos::subview(sorted_cell_indices, sparse_range));
+  auto sparse_permute = KokkosExt::cloneWithoutInitializingNorCopying(
+      exec_space, Kokkos::subview(permute, sparse_range));
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::compute_shifted_cell_indices",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0,
+                                          num_points_in_sparse_cells),
+      KOKKOS_LAMBDA(int i) {
+        auto const &xyz =
+            Access::get(primitives, permute(num_points_in_dense_cells + i));
+        sparse_cell_indices(i) =
+            shifted_cell_indices_offset + shifted_grid.cellIndex(xyz);
+      });
+
+  auto shifted_permute = sortObjects(exec_space, sparse_cell_indices);
+  Kokkos::parallel_for(
+      "ArborX::DBSCAN::permute_sparse_points",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0,
+                                          num_points_in_sparse_cells),
+      KOKKOS_LAMBDA(int i) {
+        sparse_permute(i) =
+            permute(num_points_in_dense_cells + shifted_permute(i));
+      });
+
+  Kokkos::View<int *, MemorySpace> shifted_cell_offsets(
+      "ArborX::DBSCAN::shifted_cell_offsets", 0);
+  computeOffsetsInOrderedView(exec_space, sparse_cell_indices,
+                              shifted_cell_offsets);
+  int const num_points_in_shifted_dense_cells =
+      reorderDenseAndSparseCells(exec_space, shifted_cell_offsets,
+                                 core_min_size, sparse_cell_indices,
+                                 sparse_permute);
+
+  Kokkos::deep_copy(exec_space,
+                    Kokkos::subview(sorted_cell_indices, sparse_range),
+                    sparse_cell_indices);
+  Kokkos::deep_copy(exec_space, Kokkos::subview(permute, sparse_range),
+                    sparse_permute);
+
+  return num_points_in_shifted_dense_cells;
+}
+
 template <typename ExecutionSpace, typename CellIndices, typename Permutation,
           typename UnionFind>
 void unionFindWithinEachDenseCell(ExecutionSpace const &exec_space,
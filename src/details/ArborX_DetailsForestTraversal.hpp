@@ -0,0 +1,224 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+#ifndef ARBORX_DETAILS_FOREST_TRAVERSAL_HPP
+#define ARBORX_DETAILS_FOREST_TRAVERSAL_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsNode.hpp> // ROPE_SENTINEL
+#include <ArborX_Predicates.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cassert>
+
+namespace ArborX::Details
+{
+
+struct ForestTreeOffsets
+{
+  int leaf_nodes;
+  int internal_nodes;
+};
+
+// Non-owning view of one of the trees of a forest, with the same layout as a
+// hierarchy so that HappyTreeFriends can navigate it
+template <typename LeafNode, typename InternalNode, typename BoundingVolume,
+          typename IndexableGetter, typename MemorySpace>
+struct ForestTree
+{
+  using memory_space = MemorySpace;
+
+  int _size;
+  BoundingVolume _bounds;
+  Kokkos::View<LeafNode const *, MemorySpace, Kokkos::MemoryUnmanaged>
+      _leaf_nodes;
+  Kokkos::View<InternalNode const *, MemorySpace, Kokkos::MemoryUnmanaged>
+      _internal_nodes;
+  IndexableGetter _indexable_getter;
+
+  KOKKOS_FUNCTION int size() const { return _size; }
+  KOKKOS_FUNCTION bool empty() const { return _size == 0; }
+};
+
+template <typename LeafNodes, typename InternalNodes, typename BoundingVolume,
+          typename IndexableGetter>
+struct Forest
+{
+  using memory_space = typename LeafNodes::memory_space;
+
+  Kokkos::View<ForestTreeOffsets *, memory_space> _offsets;
+  Kokkos::View<BoundingVolume *, memory_space> _bounds;
+  LeafNodes _leaf_nodes;
+  InternalNodes _internal_nodes;
+  IndexableGetter _indexable_getter;
+
+  KOKKOS_FUNCTION int size() const
+  {
+    return _offsets.extent_int(0) > 0 ? _offsets.extent_int(0) - 1 : 0;
+  }
+
+  KOKKOS_FUNCTION auto getTree(int tree_id) const
+  {
+    assert(tree_id >= 0 && tree_id < size());
+    auto const &offsets = _offsets(tree_id);
+    int const tree_size =
+        _offsets(tree_id + 1).leaf_nodes - offsets.leaf_nodes;
+    int const num_internal_nodes =
+        _offsets(tree_id + 1).internal_nodes - offsets.internal_nodes;
+    using Tree =
+        ForestTree<typename LeafNodes::value_type,
+                   typename InternalNodes::value_type, BoundingVolume,
+                   IndexableGetter, memory_space>;
+    using TreeLeafNodes = decltype(Tree::_leaf_nodes);
+    using TreeInternalNodes = decltype(Tree::_internal_nodes);
+    return Tree{tree_size, _bounds(tree_id),
+                TreeLeafNodes(_leaf_nodes.data() + offsets.leaf_nodes,
+                              tree_size),
+                TreeInternalNodes(
+                    _internal_nodes.data() + offsets.internal_nodes,
+                    num_internal_nodes),
+                _indexable_getter};
+  }
+};
+
+// Traverse each predicate in the tree it is directed to, or in all the trees
+// of the forest one after the other when the AllTrees tag is given
+template <typename Forest, typename Predicates, typename Callback>
+struct ForestTraversal
+{
+  Forest _forest;
+  Predicates _predicates;
+  Callback _callback;
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+
+  struct AllTrees
+  {};
+
+  template <typename ExecutionSpace>
+  ForestTraversal(ExecutionSpace const &space, Forest const &forest,
+                  Predicates const &predicates, Callback const &callback)
+      : _forest{forest}
+      , _predicates{predicates}
+      , _callback{callback}
+  {
+    if (_forest.size() == 0)
+      return;
+
+    // All the trees are traversed at once
+    Kokkos::parallel_for(
+        "ArborX::ForestTraversal::spatial",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, Access::size(predicates)),
+        *this);
+  }
+
+  template <typename ExecutionSpace>
+  ForestTraversal(AllTrees, ExecutionSpace const &space, Forest const &forest,
+                  Predicates const &predicates, Callback const &callback)
+      : _forest{forest}
+      , _predicates{predicates}
+      , _callback{callback}
+  {
+    if (_forest.size() == 0)
+      return;
+
+    Kokkos::parallel_for(
+        "ArborX::ForestTraversal::spatial_all_trees",
+        Kokkos::RangePolicy<ExecutionSpace, AllTrees>(
+            space, 0, Access::size(predicates)),
+        *this);
+  }
+
+  KOKKOS_FUNCTION void operator()(int queryIndex) const
+  {
+    auto const &predicate = Access::get(_predicates, queryIndex);
+    search(predicate, _forest.getTree(Experimental::getTreeId(predicate)));
+  }
+
+  KOKKOS_FUNCTION void operator()(AllTrees, int queryIndex) const
+  {
+    auto const &predicate = Access::get(_predicates, queryIndex);
+    for (int tree_id = 0; tree_id < _forest.size(); ++tree_id)
+      if (search(predicate, _forest.getTree(tree_id)))
+        return;
+  }
+
+  // Return whether the callback requested an early exit
+  template <typename Predicate, typename Tree>
+  KOKKOS_FUNCTION bool search(Predicate const &predicate,
+                              Tree const &tree) const
+  {
+    if (tree.empty())
+      return false;
+
+    if (tree.size() == 1)
+    {
+      return predicate(HappyTreeFriends::getIndexable(tree, 0)) &&
+             invoke_callback_and_check_early_exit(
+                 _callback, predicate, HappyTreeFriends::getValue(tree, 0));
+    }
+
+    int node = HappyTreeFriends::getRoot(tree); // start with root
+    do
+    {
+      bool const is_leaf = HappyTreeFriends::isLeaf(tree, node);
+
+      if (is_leaf ? predicate(HappyTreeFriends::getIndexable(tree, node))
+                  : predicate(HappyTreeFriends::getInternalBoundingVolume(
+                        tree, node)))
+      {
+        if (is_leaf)
+        {
+          if (invoke_callback_and_check_early_exit(
+                  _callback, predicate, HappyTreeFriends::getValue(tree, node)))
+            return true;
+          node = HappyTreeFriends::getRope(tree, node);
+        }
+        else
+        {
+          node = HappyTreeFriends::getLeftChild(tree, node);
+        }
+      }
+      else
+      {
+        node = HappyTreeFriends::getRope(tree, node);
+      }
+    } while (node != ROPE_SENTINEL);
+    return false;
+  }
+};
+
+template <typename ExecutionSpace, typename Forest, typename Predicates,
+          typename Callback>
+void traverseForest(ExecutionSpace const &space, Forest const &forest,
+                    Predicates const &predicates, Callback const &callback)
+{
+  ForestTraversal<Forest, Predicates, Callback>(space, forest, predicates,
+                                                callback);
+}
+
+// Search all the trees of the forest with each predicate
+template <typename ExecutionSpace, typename Forest, typename Predicates,
+          typename Callback>
+void traverseAllTreesOfForest(ExecutionSpace const &space, Forest const &forest,
+                              Predicates const &predicates,
+                              Callback const &callback)
+{
+  using Traversal = ForestTraversal<Forest, Predicates, Callback>;
+  Traversal(typename Traversal::AllTrees{}, space, forest, predicates,
+            callback);
+}
+
+} // namespace ArborX::Details
+
+#endif
@@ -15,22 +15,40 @@
 #include <ArborX_Callbacks.hpp> // LegacyCallbackWrapper
 #include <ArborX_DetailsHappyTreeFriends.hpp>
 #include <ArborX_DetailsNode.hpp> // ROPE_SENTINEL
+#include <ArborX_TraversalPolicy.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <type_traits>
+
 namespace ArborX::Details
 {
 
+// Visit each pair of distinct leaves (i, j) such that the predicate obtained
+// from the indexable of i is satisfied by j exactly once, assuming that the
+// predicates are symmetric. The callback is passed the two values, or their
+// indices for legacy trees and for callbacks that only accept indices.
 template <class BVH, class Callback, class PredicateGetter>
 struct HalfTraversal
 {
+  using value_type = typename BVH::value_type;
+
+  static constexpr bool passes_values =
+      !Kokkos::is_detected_v<LegacyTreeArchetypeExpression, BVH> &&
+      std::is_invocable_v<Callback const &, value_type const &,
+                          value_type const &>;
+
   BVH _bvh;
   PredicateGetter _get_predicate;
-  LegacyCallbackWrapper<Callback, typename BVH::value_type> _callback;
+  std::conditional_t<passes_values, Callback,
+                     LegacyCallbackWrapper<Callback, value_type>>
+      _callback;
 
   template <class ExecutionSpace>
   HalfTraversal(ExecutionSpace const &space, BVH const &bvh,
-                Callback const &callback, PredicateGetter const &getter)
+                Callback const &callback, PredicateGetter const &getter,
+                Experimental::TraversalPolicy const &policy =
+                    Experimental::TraversalPolicy())
       : _bvh{bvh}
       , _get_predicate{getter}
       , _callback{callback}
@@ -45,9 +63,10 @@ struct HalfTraversal
     }
     else
     {
-      Kokkos::parallel_for(
-          "ArborX::Experimental::HalfTraversal",
-          Kokkos::RangePolicy<ExecutionSpace>(space, 0, _bvh.size()), *this);
+      // The leaves early along the curve visit more of the tree than the last
+      // ones, so that a dynamic schedule evens out the work on host
+      launchTraversal("ArborX::Experimental::HalfTraversal", space,
+                      _bvh.size(), policy, *this);
     }
   }
 
@@ -55,7 +74,12 @@ struct HalfTraversal
   {
     auto const predicate =
         _get_predicate(HappyTreeFriends::getIndexable(_bvh, i));
-    auto const leaf_permutation_i = HappyTreeFriends::getValue(_bvh, i).index;
+    auto const leaf_permutation_i = [&]() {
+      if constexpr (passes_values)
+        return HappyTreeFriends::getValue(_bvh, i);
+      else
+        return HappyTreeFriends::getValue(_bvh, i).index;
+    }();
 
     int node = HappyTreeFriends::getRope(_bvh, i);
     while (node != ROPE_SENTINEL)
@@ -13,6 +13,7 @@
 #define ARBORX_DETAILS_HAPPY_TREE_FRIENDS_HPP
 
 #include <ArborX_DetailsNode.hpp>
+#include <ArborX_DetailsQuantizedNode.hpp>
 
 #include <Kokkos_Macros.hpp>
 
@@ -22,6 +23,11 @@
 namespace ArborX::Details
 {
 
+// Construction of a hierarchy that leaves its bounds on the device, see
+// ArborX::Experimental::constructHierarchies()
+struct DeferredBoundsTag
+{};
+
 struct HappyTreeFriends
 {
   template <class BVH>
@@ -46,6 +52,13 @@ struct HappyTreeFriends
   }
 
   template <class BVH>
+  static constexpr bool isQuantized()
+  {
+    return is_quantized_internal_node<
+        typename decltype(BVH::_internal_nodes)::non_const_value_type>::value;
+  }
+
+  template <class BVH, std::enable_if_t<!isQuantized<BVH>()> * = nullptr>
   static KOKKOS_FUNCTION
 // FIXME_HIP See https://github.com/arborx/ArborX/issues/553
 #ifdef __HIP_DEVICE_COMPILE__
@@ -58,13 +71,22 @@ struct HappyTreeFriends
     return bvh._internal_nodes(internalIndex(bvh, i)).bounding_volume;
   }
 
+  template <class BVH, std::enable_if_t<isQuantized<BVH>()> * = nullptr>
+  static KOKKOS_FUNCTION auto getInternalBoundingVolume(BVH const &bvh, int i)
+  {
+    return getBoundingVolume(bvh._internal_nodes(internalIndex(bvh, i)),
+                             bvh._bounds);
+  }
+
   template <class BVH>
   static KOKKOS_FUNCTION
 // FIXME_HIP See https://github.com/arborx/ArborX/issues/553
 #ifdef __HIP_DEVICE_COMPILE__
       auto
 #else
-      auto const &
+      // The indexable getter may return the indexable by value, e.g. a
+      // triangle assembled from the vertices of a mesh
+      decltype(auto)
 #endif
       getIndexable(BVH const &bvh, int i)
   {
@@ -98,6 +120,42 @@ struct HappyTreeFriends
     return (isLeaf(bvh, i) ? bvh._leaf_nodes(i).rope
                            : bvh._internal_nodes(internalIndex(bvh, i)).rope);
   }
+
+  template <class BVH>
+  static KOKKOS_FUNCTION bool hasContiguousSubtrees(BVH const &bvh)
+  {
+    return bvh._contiguous_subtrees;
+  }
+
+  template <class BVH>
+  static auto const &getLeafNodes(BVH const &bvh)
+  {
+    return bvh._leaf_nodes;
+  }
+
+  template <class BVH>
+  static auto const &getInternalNodes(BVH const &bvh)
+  {
+    return bvh._internal_nodes;
+  }
+
+  template <class BVH>
+  static auto const &getIndexableGetter(BVH const &bvh)
+  {
+    return bvh._indexable_getter;
+  }
+
+  template <class BVH, class... Args>
+  static BVH constructWithDeferredBounds(Args const &...args)
+  {
+    return BVH(DeferredBoundsTag{}, args...);
+  }
+
+  template <class BVH, class... Args>
+  static void copyBoundsToHost(BVH &bvh, Args const &...args)
+  {
+    bvh.copyBoundsToHost(args...);
+  }
 };
 } // namespace ArborX::Details
 
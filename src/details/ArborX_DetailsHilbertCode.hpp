@@ -0,0 +1,112 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_HILBERT_CODE_HPP
+#define ARBORX_DETAILS_HILBERT_CODE_HPP
+
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp> // min. max
+#include <ArborX_DetailsMortonCode.hpp>                // expandBitsBy
+#include <ArborX_GeometryTraits.hpp>
+
+#include <Kokkos_Macros.hpp>
+
+#include <type_traits>
+
+namespace ArborX::Details
+{
+
+// Transform in place the coordinates of a cell of a grid with 2^BITS cells in
+// each dimension into the "transpose" of its index along the Hilbert curve,
+// i.e. the index is obtained by interleaving the bits of the result with the
+// first dimension most significant. See J. Skilling, "Programming the Hilbert
+// curve", AIP Conference Proceedings 707 (2004).
+template <int BITS, int DIM, typename UInt>
+KOKKOS_INLINE_FUNCTION void axesToTranspose(UInt (&x)[DIM])
+{
+  constexpr UInt M = UInt(1) << (BITS - 1);
+
+  // Inverse undo
+  for (UInt q = M; q > 1; q >>= 1)
+  {
+    UInt const p = q - 1;
+    for (int i = 0; i < DIM; ++i)
+    {
+      if (x[i] & q)
+      {
+        x[0] ^= p; // invert
+      }
+      else
+      {
+        UInt const t = (x[0] ^ x[i]) & p; // exchange
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+  for (int i = 1; i < DIM; ++i)
+    x[i] ^= x[i - 1];
+  UInt t = 0;
+  for (UInt q = M; q > 1; q >>= 1)
+    if (x[DIM - 1] & q)
+      t ^= q - 1;
+  for (int i = 0; i < DIM; ++i)
+    x[i] ^= t;
+}
+
+template <typename UInt, int BITS, typename Point>
+KOKKOS_INLINE_FUNCTION UInt hilbertCode(Point const &p)
+{
+  constexpr int DIM = GeometryTraits::dimension_v<Point>;
+  static_assert(DIM == 2 || DIM == 3,
+                "Hilbert codes are only available in 2D and 3D");
+  // Have to use double as float is not sufficient to represent large
+  // integers, which would result in some missing bins.
+  using Float = std::conditional_t<(BITS > 24), double, float>;
+  constexpr Float N = UInt(1) << BITS;
+
+  using KokkosExt::max;
+  using KokkosExt::min;
+
+  UInt x[DIM];
+  for (int d = 0; d < DIM; ++d)
+    x[d] = (UInt)min(max((Float)p[d] * N, (Float)0), N - 1);
+
+  axesToTranspose<BITS>(x);
+
+  UInt r = 0;
+  for (int d = 0; d < DIM; ++d)
+    r += (expandBits<DIM - 1>(x[d]) << (DIM - d - 1));
+  return r;
+}
+
+// Calculate a 32-bit Hilbert code for a 2D or 3D point located within [0, 1]^d
+template <typename Point,
+          typename Enable = std::enable_if_t<GeometryTraits::is_point<Point>{}>>
+KOKKOS_INLINE_FUNCTION unsigned int hilbert32(Point const &p)
+{
+  constexpr int DIM = GeometryTraits::dimension_v<Point>;
+  return hilbertCode<unsigned int, 32 / DIM>(p);
+}
+
+// Calculate a 64-bit Hilbert code for a 2D or 3D point located within [0, 1]^d
+template <typename Point,
+          typename Enable = std::enable_if_t<GeometryTraits::is_point<Point>{}>>
+KOKKOS_INLINE_FUNCTION unsigned long long hilbert64(Point const &p)
+{
+  constexpr int DIM = GeometryTraits::dimension_v<Point>;
+  return hilbertCode<unsigned long long, 63 / DIM>(p);
+}
+
+} // namespace ArborX::Details
+
+#endif
@@ -17,6 +17,12 @@
 
 #include <Kokkos_Core.hpp> // abort
 
+#if defined(__BMI2__) && !defined(__CUDA_ARCH__) &&                            \
+    !defined(__HIP_DEVICE_COMPILE__) && !defined(__SYCL_DEVICE_ONLY__)
+#define ARBORX_DETAILS_MORTON_CODE_USE_PDEP
+#include <immintrin.h> // _pdep_u32, _pdep_u64
+#endif
+
 namespace ArborX
 {
 
@@ -282,6 +288,34 @@ KOKKOS_INLINE_FUNCTION unsigned long long expandBitsBy<9>(unsigned long long x)
   return x;
 }
 
+// Positions of the low bits of x after expandBitsBy<N>(x), which keeps as
+// many of them as fit in 32 bits, or in 63 bits for 64-bit integers
+template <int N, typename UInt>
+KOKKOS_INLINE_FUNCTION constexpr UInt expandBitsMask()
+{
+  constexpr int num_bits = (sizeof(UInt) < 8 ? 32 : 63) / (N + 1);
+  UInt mask = 0;
+  for (int k = 0; k < num_bits; ++k)
+    mask |= UInt(1) << (k * (N + 1));
+  return mask;
+}
+
+// Same as expandBitsBy<N>(x). When compiling for the host with BMI2, the bits
+// are scattered with a single parallel bit deposit instead of the sequence of
+// shifts and masks.
+template <int N, typename UInt>
+KOKKOS_INLINE_FUNCTION UInt expandBits(UInt x)
+{
+#ifdef ARBORX_DETAILS_MORTON_CODE_USE_PDEP
+  if constexpr (N > 0 && sizeof(UInt) == 4)
+    return _pdep_u32(x, expandBitsMask<N, UInt>());
+  else if constexpr (N > 0 && sizeof(UInt) == 8)
+    return _pdep_u64(x, expandBitsMask<N, UInt>());
+  else
+#endif
+    return expandBitsBy<N>(x);
+}
+
 template <typename Point,
           typename Enable = std::enable_if_t<GeometryTraits::is_point<Point>{}>>
 KOKKOS_INLINE_FUNCTION unsigned int morton32(Point const &p)
@@ -296,15 +330,17 @@ KOKKOS_INLINE_FUNCTION unsigned int morton32(Point const &p)
   for (int d = 0; d < DIM; ++d)
   {
     auto x = min(max((float)p[d] * N, 0.f), (float)N - 1);
-    r += (expandBitsBy<DIM - 1>((unsigned int)x) << (DIM - d - 1));
+    r += (expandBits<DIM - 1>((unsigned int)x) << (DIM - d - 1));
   }
 
   return r;
 }
 
+// The scaling is done in double precision whatever the coordinate type of the
+// point, as float is not sufficient to represent large integers, which would
+// result in some missing bins (e.g., 2^31 bins per direction in 2D).
 template <typename Point,
-          std::enable_if_t<GeometryTraits::is_point<Point>{} &&
-                           GeometryTraits::dimension_v<Point> != 2> * = nullptr>
+          typename Enable = std::enable_if_t<GeometryTraits::is_point<Point>{}>>
 KOKKOS_INLINE_FUNCTION unsigned long long morton64(Point const &p)
 {
   constexpr int DIM = GeometryTraits::dimension_v<Point>;
@@ -316,38 +352,17 @@ KOKKOS_INLINE_FUNCTION unsigned long long morton64(Point const &p)
   unsigned long long r = 0;
   for (int d = 0; d < DIM; ++d)
   {
-    auto x = min(max((float)p[d] * N, 0.f), (float)N - 1);
-    r += (expandBitsBy<DIM - 1>((unsigned long long)x) << (DIM - d - 1));
+    auto x = min(max((double)p[d] * N, 0.), (double)N - 1);
+    r += (expandBits<DIM - 1>((unsigned long long)x) << (DIM - d - 1));
   }
 
   return r;
 }
 
-// Calculate a 62-bit Morton code for a 2D point located within [0, 1]^2.
-// Special case because it needs double.
-template <typename Point,
-          std::enable_if_t<GeometryTraits::is_point<Point>{} &&
-                           GeometryTraits::dimension_v<Point> == 2> * = nullptr>
-KOKKOS_INLINE_FUNCTION unsigned long long morton64(Point const &p)
-{
-  // The interval [0,1] is subdivided into 2,147,483,648 bins (in each
-  // direction).
-  constexpr unsigned N = (1u << 31);
-
-  using KokkosExt::max;
-  using KokkosExt::min;
-
-  // Have to use double as float is not sufficient to represent large
-  // integers, which would result in some missing bins.
-  auto xd = min(max((double)p[0] * N, 0.), (double)N - 1);
-  auto yd = min(max((double)p[1] * N, 0.), (double)N - 1);
-
-  return 2 * expandBitsBy<1>((unsigned long long)xd) +
-         expandBitsBy<1>((unsigned long long)yd);
-}
-
 } // namespace Details
 
 } // namespace ArborX
 
+#undef ARBORX_DETAILS_MORTON_CODE_USE_PDEP
+
 #endif
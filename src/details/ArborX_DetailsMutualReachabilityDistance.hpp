@@ -78,6 +78,11 @@ struct AccessTraits<Details::NearestK<Primitives>, PredicatesTag>
 namespace Details
 {
 
+// Metrics are called with the indices of the leaves of the hierarchy during
+// the Boruvka iterations, so that the core distances are stored in the order
+// of the leaves and read contiguously by neighboring queries. The internal
+// nodes may follow the leaves, holding the smallest core distance of their
+// subtree, see lowerBound().
 template <class CoreDistances>
 struct MutualReachability
 {
@@ -91,6 +96,15 @@ struct MutualReachability
     using KokkosExt::max;
     return max({_core_distances(i), _core_distances(j), distance_ij});
   }
+
+  // Bound from below on the distance between the leaf i and any leaf in the
+  // subtree of the node, regardless of their Euclidean distance. Requires the
+  // core distances of the internal nodes.
+  KOKKOS_FUNCTION value_type lowerBound(size_type i, size_type node) const
+  {
+    using KokkosExt::max;
+    return max(_core_distances(i), _core_distances(node));
+  }
 };
 
 struct Euclidean
@@ -102,6 +116,12 @@ struct Euclidean
   {
     return distance_ij;
   }
+
+  KOKKOS_FUNCTION value_type lowerBound(size_type /*i*/,
+                                        size_type /*node*/) const
+  {
+    return 0;
+  }
 };
 
 } // namespace Details
@@ -0,0 +1,237 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_NODE_AGGREGATES_HPP
+#define ARBORX_DETAILS_NODE_AGGREGATES_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsNode.hpp>             // ROPE_SENTINEL
+#include <ArborX_DetailsTreeNodeLabeling.hpp> // findParents
+#include <ArborX_Exception.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+
+namespace ArborX
+{
+namespace Details
+{
+
+// Traversal in which the callback decides at each internal node whether the
+// aggregate of its subtree is an acceptable approximation, in which case the
+// subtree is skipped, or whether to open the node. The leaves that are
+// reached are passed to the callback as in a spatial query.
+template <typename BVH, typename Predicates, typename Aggregates,
+          typename Callback>
+struct NodeAggregatesTraversal
+{
+  BVH _bvh;
+  Predicates _predicates;
+  Aggregates _aggregates;
+  Callback _callback;
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+
+  template <typename ExecutionSpace>
+  NodeAggregatesTraversal(ExecutionSpace const &space, BVH const &bvh,
+                          Predicates const &predicates,
+                          Aggregates const &aggregates,
+                          Callback const &callback,
+                          Experimental::TraversalPolicy const &policy)
+      : _bvh{bvh}
+      , _predicates{predicates}
+      , _aggregates{aggregates}
+      , _callback{callback}
+  {
+    if (_bvh.empty())
+    {
+      // do nothing
+    }
+    else
+    {
+      launchTraversal("ArborX::Experimental::traverseNodeAggregates", space,
+                      Access::size(predicates), policy, *this);
+    }
+  }
+
+  KOKKOS_FUNCTION void operator()(int queryIndex) const
+  {
+    auto const &predicate = Access::get(_predicates, queryIndex);
+
+    if (_bvh.size() == 1)
+    {
+      _callback(predicate, HappyTreeFriends::getValue(_bvh, 0));
+      return;
+    }
+
+    int node = HappyTreeFriends::getRoot(_bvh); // start with root
+    do
+    {
+      if (HappyTreeFriends::isLeaf(_bvh, node))
+      {
+        _callback(predicate, HappyTreeFriends::getValue(_bvh, node));
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+      else if (_callback(
+                   predicate, _aggregates(node),
+                   HappyTreeFriends::getInternalBoundingVolume(_bvh, node)))
+      {
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+      else
+      {
+        node = HappyTreeFriends::getLeftChild(_bvh, node);
+      }
+    } while (node != ROPE_SENTINEL);
+  }
+};
+
+} // namespace Details
+
+namespace Experimental
+{
+
+/** Reduce user-defined aggregates over the subtrees of a hierarchy, e.g. the
+ * mass and the center of mass of the points below each node for a Barnes-Hut
+ * approximation of gravitational forces.
+ *
+ * The aggregate of a leaf is leaf_aggregate(value) and that of an internal
+ * node is combine(left_aggregate, right_aggregate). The nodes are reduced from
+ * the leaves up as when the hierarchy is refitted, so combine() need not be
+ * commutative but must be associative for the aggregates not to depend on the
+ * shape of the hierarchy. They have to be computed again after a refit.
+ *
+ * Returns the aggregates indexed by node: the leaves in [0, n) followed by the
+ * internal nodes in [n, 2n-1), as expected by traverseNodeAggregates().
+ */
+template <typename ExecutionSpace, typename BVH, typename LeafAggregate,
+          typename Combine>
+auto computeNodeAggregates(ExecutionSpace const &space, BVH const &bvh,
+                           LeafAggregate const &leaf_aggregate,
+                           Combine const &combine)
+{
+  using MemorySpace = typename BVH::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  using Aggregate = std::decay_t<std::invoke_result_t<
+      LeafAggregate const &, typename BVH::value_type const &>>;
+  static_assert(
+      std::is_convertible_v<std::invoke_result_t<Combine const &,
+                                                 Aggregate const &,
+                                                 Aggregate const &>,
+                            Aggregate>,
+      "Combining two aggregates must return an aggregate");
+
+  using Details::HappyTreeFriends;
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::computeNodeAggregates");
+
+  int const n = bvh.size();
+  Kokkos::View<Aggregate *, MemorySpace> aggregates(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::computeNodeAggregates::aggregates"),
+      n > 0 ? 2 * n - 1 : 0);
+  if (n < 2)
+  {
+    Kokkos::parallel_for(
+        "ArborX::computeNodeAggregates::single_leaf",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int) {
+          aggregates(0) = leaf_aggregate(HappyTreeFriends::getValue(bvh, 0));
+        });
+    return aggregates;
+  }
+
+  Kokkos::View<int *, MemorySpace> parents(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::computeNodeAggregates::parents"),
+      2 * n - 1);
+  Details::findParents(space, bvh, parents);
+
+  Kokkos::View<int *, MemorySpace> visits(
+      Kokkos::view_alloc(space, "ArborX::computeNodeAggregates::visits"),
+      n - 1);
+  Kokkos::parallel_for(
+      "ArborX::computeNodeAggregates::reduce",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        aggregates(i) = leaf_aggregate(HappyTreeFriends::getValue(bvh, i));
+
+        int const root = HappyTreeFriends::getRoot(bvh);
+        int node = i;
+        do
+        {
+          int const parent = parents(node);
+
+          // Same as in refitHierarchy(), only the second thread to reach an
+          // internal node goes through, once both of its children are done
+          Kokkos::memory_fence();
+          if (Kokkos::atomic_fetch_add(&visits(parent - n), 1) == 0)
+            break;
+          Kokkos::load_fence();
+
+          aggregates(parent) =
+              combine(aggregates(HappyTreeFriends::getLeftChild(bvh, parent)),
+                      aggregates(HappyTreeFriends::getRightChild(bvh, parent)));
+
+          node = parent;
+        } while (node != root);
+      });
+
+  return aggregates;
+}
+
+/** Traverse the hierarchy for each predicate, letting the callback accept the
+ * aggregate of an internal node, as computed by computeNodeAggregates(), in
+ * place of the leaves below it. The callback is invoked as
+ *  - callback(predicate, aggregate, bounding_volume) at the internal nodes,
+ *    and returns true to accept the aggregate and skip the subtree, or false
+ *    to open the node and visit its children;
+ *  - callback(predicate, value) at the leaves that are reached.
+ *
+ * The predicates are any type accessible through AccessTraits with the
+ * PredicatesTag, e.g. the target points of a Barnes-Hut evaluation. Every leaf
+ * is accounted for exactly once per predicate, either by itself or through
+ * the aggregate of one of its ancestors.
+ */
+template <typename ExecutionSpace, typename BVH, typename Predicates,
+          typename Aggregates, typename Callback>
+void traverseNodeAggregates(ExecutionSpace const &space, BVH const &bvh,
+                            Predicates const &predicates,
+                            Aggregates const &aggregates,
+                            Callback const &callback,
+                            TraversalPolicy const &policy = TraversalPolicy())
+{
+  static_assert(
+      KokkosExt::is_accessible_from<typename BVH::memory_space,
+                                    ExecutionSpace>::value);
+  static_assert(Kokkos::is_view_v<Aggregates> && Aggregates::rank == 1);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Predicates must be accessible from the execution space");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::traverseNodeAggregates");
+
+  int const n = bvh.size();
+  ARBORX_ASSERT((int)aggregates.size() == (n > 0 ? 2 * n - 1 : 0));
+
+  Details::NodeAggregatesTraversal(space, bvh, predicates, aggregates,
+                                   callback, policy);
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
@@ -13,6 +13,9 @@
 #define ARBORX_DETAILS_PERMUTED_DATA_HPP
 
 #include <ArborX_AccessTraits.hpp>
+#include <ArborX_Predicates.hpp>
+
+#include <type_traits>
 
 namespace ArborX
 {
@@ -28,8 +31,119 @@ struct PermutedData
   KOKKOS_FUNCTION auto &operator()(int i) const { return _data(_permute(i)); }
 };
 
+// Predicate reordered for the traversal, with its index attached in place of
+// the data the user attached to it. The traversal then only carries the
+// geometry and the index while the original predicate, attachment included,
+// is read through its address once the callback fires.
+template <typename Predicate, typename Original>
+struct PredicateWithAttachedIndex : PredicateWithAttachment<Predicate, int>
+{
+  Original const *_original;
+};
+
+template <typename Predicate, typename Data>
+KOKKOS_FUNCTION Predicate const &
+getOriginalPredicate(PredicateWithAttachment<Predicate, Data> const &pred)
+{
+  return getPredicate(pred);
+}
+
+template <typename Predicate, typename Original>
+KOKKOS_FUNCTION Original const &getOriginalPredicate(
+    PredicateWithAttachedIndex<Predicate, Original> const &pred)
+{
+  return *pred._original;
+}
+
+template <typename T>
+struct is_predicate_with_attachment : std::false_type
+{};
+template <typename Predicate, typename Data>
+struct is_predicate_with_attachment<PredicateWithAttachment<Predicate, Data>>
+    : std::true_type
+{};
+
+// Attach the index to the predicate. Predicates stored with attachments
+// larger than a pointer are not copied, only their address is kept.
+template <typename Access, typename Predicates>
+KOKKOS_FUNCTION auto getWithAttachedIndex(Predicates const &predicates,
+                                          int native_index, int index)
+{
+  decltype(auto) predicate = Access::get(predicates, native_index);
+  using Original = std::decay_t<decltype(predicate)>;
+  if constexpr (std::is_lvalue_reference_v<decltype(predicate)> &&
+                is_predicate_with_attachment<Original>::value)
+  {
+    using Data = std::decay_t<decltype(getData(predicate))>;
+    if constexpr (sizeof(Data) > sizeof(Original const *))
+    {
+      using Predicate = std::decay_t<decltype(getPredicate(predicate))>;
+      return PredicateWithAttachedIndex<Predicate, Original>{
+          {getPredicate(predicate), index}, &predicate};
+    }
+    else
+      return attach(predicate, index);
+  }
+  else
+    return attach(predicate, index);
+}
+
+// Indices of the consecutive predicates of a batch, in the order given by a
+// permutation of the batch, or in their own order if it is empty
+template <typename DeviceType>
+struct BatchIndices
+{
+  int _begin;
+  Kokkos::View<unsigned int *, DeviceType> _permute;
+
+  KOKKOS_FUNCTION int operator()(int i) const
+  {
+    return _begin + (_permute.size() > 0 ? (int)_permute(i) : i);
+  }
+};
+
+// Predicates of a batch, possibly reordered. Attached indices are the
+// positions within the batch.
+template <typename Predicates, typename DeviceType, bool AttachIndices = false>
+struct PredicatesBatch
+{
+  Predicates _data;
+  BatchIndices<DeviceType> _indices;
+  int _size;
+};
+
 } // namespace Details
 
+template <typename Predicates, typename DeviceType, bool AttachIndices>
+struct AccessTraits<
+    Details::PredicatesBatch<Predicates, DeviceType, AttachIndices>,
+    PredicatesTag>
+{
+  using Batch = Details::PredicatesBatch<Predicates, DeviceType, AttachIndices>;
+  using NativeAccess = AccessTraits<Predicates, PredicatesTag>;
+
+  KOKKOS_FUNCTION static std::size_t size(Batch const &batch)
+  {
+    return batch._size;
+  }
+
+  template <bool _Attach = AttachIndices>
+  KOKKOS_FUNCTION static auto
+  get(Batch const &batch, std::enable_if_t<_Attach, std::size_t> index)
+  {
+    return Details::getWithAttachedIndex<NativeAccess>(
+        batch._data, batch._indices(index), (int)index);
+  }
+
+  template <bool _Attach = AttachIndices>
+  KOKKOS_FUNCTION static decltype(auto)
+  get(Batch const &batch, std::enable_if_t<!_Attach, std::size_t> index)
+  {
+    return NativeAccess::get(batch._data, batch._indices(index));
+  }
+  using memory_space = typename NativeAccess::memory_space;
+};
+
 template <typename Predicates, typename Permute, bool AttachIndices>
 struct AccessTraits<Details::PermutedData<Predicates, Permute, AttachIndices>,
                     PredicatesTag>
@@ -48,9 +162,9 @@ struct AccessTraits<Details::PermutedData<Predicates, Permute, AttachIndices>,
   KOKKOS_FUNCTION static auto get(PermutedPredicates const &permuted_predicates,
                                   std::enable_if_t<_Attach, std::size_t> index)
   {
-    auto const permuted_index = permuted_predicates._permute(index);
-    return attach(NativeAccess::get(permuted_predicates._data, permuted_index),
-                  (int)index);
+    return Details::getWithAttachedIndex<NativeAccess>(
+        permuted_predicates._data, permuted_predicates._permute(index),
+        (int)index);
   }
 
   template <bool _Attach = AttachIndices>
@@ -0,0 +1,274 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_QUANTIZED_NODE_HPP
+#define ARBORX_DETAILS_QUANTIZED_NODE_HPP
+
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsNode.hpp>
+#include <ArborX_GeometryTraits.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_MathematicalFunctions.hpp> // floor, ceil
+
+#include <cstdint>
+#include <type_traits>
+
+namespace ArborX
+{
+namespace Experimental
+{
+// Use as the BoundingVolume template parameter of the hierarchy to store the
+// bounding volumes of the internal nodes with StorageType (8 or 16 bits)
+// coordinates instead of floating point ones. The coordinates are quantized
+// conservatively on a regular grid spanning the bounds of the scene, so that
+// a quantized box always contains the original one. Leaf nodes are not
+// affected. Queries return the same results, but may visit more nodes as the
+// boxes get looser, the more so with 8 bits. The nodes are quantized as they
+// are built or refitted, so that full precision internal nodes are never
+// allocated, except temporarily for the PLOC hierarchy.
+template <typename BoundingVolume, typename StorageType = std::uint16_t>
+struct Quantized
+{
+  static_assert(GeometryTraits::is_box<BoundingVolume>{},
+                "Only boxes can be quantized");
+  static_assert(std::is_same_v<StorageType, std::uint8_t> ||
+                    std::is_same_v<StorageType, std::uint16_t>,
+                "Quantized coordinates must be stored with 8 or 16 bits");
+};
+} // namespace Experimental
+
+namespace Details
+{
+
+template <class BoundingVolume, class StorageType>
+struct QuantizedInternalNode
+{
+  using bounding_volume_type = BoundingVolume;
+  using storage_type = StorageType;
+
+  static constexpr int DIM = GeometryTraits::dimension_v<BoundingVolume>;
+
+  // Right child is the rope of the left child
+  int left_child = -1;
+  int rope = ROPE_SENTINEL;
+  StorageType min_corner[DIM];
+  StorageType max_corner[DIM];
+};
+
+template <class BoundingVolume>
+struct InternalNodeTraits
+{
+  using bounding_volume_type = BoundingVolume;
+  using type = InternalNode<BoundingVolume>;
+};
+
+template <class BoundingVolume, class StorageType>
+struct InternalNodeTraits<Experimental::Quantized<BoundingVolume, StorageType>>
+{
+  using bounding_volume_type = BoundingVolume;
+  using type = QuantizedInternalNode<BoundingVolume, StorageType>;
+};
+
+template <class Node>
+struct is_quantized_internal_node : std::false_type
+{};
+
+template <class BoundingVolume, class StorageType>
+struct is_quantized_internal_node<
+    QuantizedInternalNode<BoundingVolume, StorageType>> : std::true_type
+{};
+
+template <class StorageType, class Coordinate>
+KOKKOS_FUNCTION Coordinate dequantize(StorageType q, Coordinate lo,
+                                      Coordinate hi)
+{
+  constexpr auto q_max =
+      KokkosExt::ArithmeticTraits::finite_max<StorageType>::value;
+  // Make sure the upper end of the grid maps exactly to the bounds
+  if (q == q_max)
+    return hi;
+  return lo + (hi - lo) * ((Coordinate)q / (Coordinate)q_max);
+}
+
+// Largest q such that dequantize(q) <= x, or 0
+template <class StorageType, class Coordinate>
+KOKKOS_FUNCTION StorageType quantizeDown(Coordinate x, Coordinate lo,
+                                         Coordinate hi)
+{
+  constexpr auto q_max =
+      KokkosExt::ArithmeticTraits::finite_max<StorageType>::value;
+  if (!(x > lo))
+    return 0;
+  if (!(x < hi))
+    return q_max;
+  auto const t = Kokkos::floor((x - lo) / (hi - lo) * q_max);
+  auto q = (StorageType)(t < 0 ? 0 : (t > q_max ? q_max : t));
+  // Correct for rounding errors
+  while (q > 0 && dequantize(q, lo, hi) > x)
+    --q;
+  return q;
+}
+
+// Smallest q such that dequantize(q) >= x, or the largest value
+template <class StorageType, class Coordinate>
+KOKKOS_FUNCTION StorageType quantizeUp(Coordinate x, Coordinate lo,
+                                       Coordinate hi)
+{
+  constexpr auto q_max =
+      KokkosExt::ArithmeticTraits::finite_max<StorageType>::value;
+  if (!(x < hi))
+    return q_max;
+  if (!(x > lo))
+    return 0;
+  auto const t = Kokkos::ceil((x - lo) / (hi - lo) * q_max);
+  auto q = (StorageType)(t < 0 ? 0 : (t > q_max ? q_max : t));
+  // Correct for rounding errors
+  while (q < q_max && dequantize(q, lo, hi) < x)
+    ++q;
+  return q;
+}
+
+// Store the bounding volume of an internal node, quantized with respect to
+// the bounds of the scene if needed. The union of quantized boxes lies on the
+// grid already, so that building a hierarchy from quantized children gives
+// (up to rounding) the same boxes as quantizing it once built.
+template <class BoundingVolume>
+KOKKOS_FUNCTION void setBoundingVolume(InternalNode<BoundingVolume> &node,
+                                       BoundingVolume const &bounding_volume,
+                                       BoundingVolume const &)
+{
+  node.bounding_volume = bounding_volume;
+}
+
+template <class BoundingVolume, class StorageType>
+KOKKOS_FUNCTION void
+setBoundingVolume(QuantizedInternalNode<BoundingVolume, StorageType> &node,
+                  BoundingVolume const &bounding_volume,
+                  BoundingVolume const &scene_bounding_volume)
+{
+  auto const &lo = scene_bounding_volume.minCorner();
+  auto const &hi = scene_bounding_volume.maxCorner();
+  for (int d = 0; d < node.DIM; ++d)
+  {
+    node.min_corner[d] = quantizeDown<StorageType>(
+        bounding_volume.minCorner()[d], lo[d], hi[d]);
+    node.max_corner[d] = quantizeUp<StorageType>(
+        bounding_volume.maxCorner()[d], lo[d], hi[d]);
+  }
+}
+
+template <class BoundingVolume, class StorageType>
+KOKKOS_FUNCTION auto
+makeQuantizedInternalNode(InternalNode<BoundingVolume> const &node,
+                          BoundingVolume const &scene_bounding_volume)
+{
+  QuantizedInternalNode<BoundingVolume, StorageType> quantized_node;
+  quantized_node.left_child = node.left_child;
+  quantized_node.rope = node.rope;
+  setBoundingVolume(quantized_node, node.bounding_volume,
+                    scene_bounding_volume);
+  return quantized_node;
+}
+
+// Bounding volume of an internal node, dequantized with respect to the bounds
+// of the scene if needed
+template <class BoundingVolume>
+KOKKOS_FUNCTION
+// FIXME_HIP See https://github.com/arborx/ArborX/issues/553
+#ifdef __HIP_DEVICE_COMPILE__
+    BoundingVolume
+#else
+    BoundingVolume const &
+#endif
+    getBoundingVolume(InternalNode<BoundingVolume> const &node,
+                      BoundingVolume const &)
+{
+  return node.bounding_volume;
+}
+
+template <class BoundingVolume, class StorageType>
+KOKKOS_FUNCTION BoundingVolume getBoundingVolume(
+    QuantizedInternalNode<BoundingVolume, StorageType> const &node,
+    BoundingVolume const &scene_bounding_volume)
+{
+  BoundingVolume bounding_volume;
+  auto const &lo = scene_bounding_volume.minCorner();
+  auto const &hi = scene_bounding_volume.maxCorner();
+  for (int d = 0; d < node.DIM; ++d)
+  {
+    bounding_volume.minCorner()[d] =
+        dequantize(node.min_corner[d], lo[d], hi[d]);
+    bounding_volume.maxCorner()[d] =
+        dequantize(node.max_corner[d], lo[d], hi[d]);
+  }
+  return bounding_volume;
+}
+
+// Return a view of non-quantized internal nodes to be used during the
+// construction of hierarchies that need them (PLOC). This is internal_nodes
+// itself, unless the nodes are quantized.
+template <class ExecutionSpace, class InternalNodes>
+auto makeUnquantizedInternalNodes(ExecutionSpace const &space,
+                                  InternalNodes const &internal_nodes)
+{
+  using Node = typename InternalNodes::value_type;
+  if constexpr (is_quantized_internal_node<Node>::value)
+  {
+    using MemorySpace = typename InternalNodes::memory_space;
+    return Kokkos::View<InternalNode<typename Node::bounding_volume_type> *,
+                        MemorySpace>(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::BVH::unquantized_internal_nodes"),
+        internal_nodes.extent(0));
+  }
+  else
+  {
+    return internal_nodes;
+  }
+}
+
+// Store the unquantized nodes into internal_nodes if needed.
+template <class ExecutionSpace, class UnquantizedInternalNodes,
+          class InternalNodes>
+void quantizeInternalNodes(
+    ExecutionSpace const &space,
+    UnquantizedInternalNodes const &unquantized_internal_nodes,
+    typename InternalNodes::value_type::bounding_volume_type const &bounds,
+    InternalNodes const &internal_nodes)
+{
+  using Node = typename InternalNodes::value_type;
+  if constexpr (is_quantized_internal_node<Node>::value)
+  {
+    using StorageType = typename Node::storage_type;
+    Kokkos::parallel_for(
+        "ArborX::BVH::quantize_internal_nodes",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, internal_nodes.extent(0)),
+        KOKKOS_LAMBDA(int i) {
+          internal_nodes(i) = makeQuantizedInternalNode<
+              typename Node::bounding_volume_type, StorageType>(
+              unquantized_internal_nodes(i), bounds);
+        });
+  }
+  else
+  {
+    static_assert(std::is_same_v<UnquantizedInternalNodes, InternalNodes>);
+    (void)space;
+    (void)unquantized_internal_nodes;
+    (void)bounds;
+    (void)internal_nodes;
+  }
+}
+
+} // namespace Details
+} // namespace ArborX
+
+#endif
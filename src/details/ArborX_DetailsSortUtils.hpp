@@ -17,9 +17,12 @@
 #include <ArborX_DetailsKokkosExtViewHelpers.hpp> // clone
 #include <ArborX_DetailsUtils.hpp>                // iota
 #include <ArborX_Exception.hpp>
+#include <ArborX_Workspace.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <optional>
+
 namespace ArborX::Details
 {
 
@@ -43,6 +46,159 @@ auto sortObjects(ExecutionSpace const &space, ViewType &view)
   return permute;
 }
 
+// Same, for a temporary permutation that is taken from the workspace, or the
+// default one, if any
+template <typename ExecutionSpace, typename ViewType,
+          class SizeType = unsigned int>
+auto sortObjects(ExecutionSpace const &space, ViewType &view,
+                 std::optional<Experimental::Workspace> const &workspace)
+{
+  Kokkos::Profiling::pushRegion("ArborX::Sorting");
+
+  auto permute = temporaryView<
+      Kokkos::View<SizeType *, typename ViewType::device_type>>(
+      space, workspace, "ArborX::Sorting::permute", view.extent(0));
+  ArborX::iota(space, permute);
+
+  KokkosExt::sortByKey(space, view, permute);
+
+  Kokkos::Profiling::popRegion();
+
+  return permute;
+}
+
+// Smallest range of a view that, once sorted, leaves the whole view sorted.
+// The elements before the first descent and after the last one are sorted
+// already, and the range only extends into them as far as the smallest and
+// largest elements between the descents need to go.
+template <typename ExecutionSpace, typename ViewType>
+Kokkos::pair<int, int> unsortedRange(ExecutionSpace const &space,
+                                     ViewType const &view)
+{
+  static_assert(ViewType::rank == 1);
+  int const n = view.extent(0);
+
+  int first_descent;
+  int last_descent;
+  Kokkos::parallel_reduce(
+      "ArborX::Sorting::find_descents",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 1, (n > 1 ? n : 1)),
+      KOKKOS_LAMBDA(int i, int &local_first, int &local_last) {
+        if (view(i) < view(i - 1))
+        {
+          if (i < local_first)
+            local_first = i;
+          if (i > local_last)
+            local_last = i;
+        }
+      },
+      Kokkos::Min<int>(first_descent), Kokkos::Max<int>(last_descent));
+  if (first_descent >= n)
+    return {0, 0};
+
+  auto const min_max = ArborX::minMax(
+      space,
+      Kokkos::subview(view, Kokkos::make_pair(first_descent - 1,
+                                              last_descent + 1)));
+  auto const min_val = min_max.first;
+  auto const max_val = min_max.second;
+
+  // The elements on both sides of the first and last descents are always
+  // found, so that the range spans them
+
+  int begin;
+  Kokkos::parallel_reduce(
+      "ArborX::Sorting::extend_unsorted_range_left",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, first_descent),
+      KOKKOS_LAMBDA(int i, int &update) {
+        if (min_val < view(i) && i < update)
+          update = i;
+      },
+      Kokkos::Min<int>(begin));
+
+  int end;
+  Kokkos::parallel_reduce(
+      "ArborX::Sorting::extend_unsorted_range_right",
+      Kokkos::RangePolicy<ExecutionSpace>(space, last_descent, n),
+      KOKKOS_LAMBDA(int i, int &update) {
+        if (view(i) < max_val && i + 1 > update)
+          update = i + 1;
+      },
+      Kokkos::Max<int>(end));
+
+  return {begin, end};
+}
+
+// Sort the consecutive blocks of a view that start at the given shift with
+// insertion sort, the permutation along
+template <typename ExecutionSpace, typename ViewType, typename PermuteType>
+void insertionSortBlocks(ExecutionSpace const &space, ViewType const &view,
+                         PermuteType const &permute, int block_size,
+                         int shift)
+{
+  int const n = view.extent(0);
+  int const num_blocks =
+      (n > shift ? (n - shift + block_size - 1) / block_size : 0);
+  Kokkos::parallel_for(
+      "ArborX::Sorting::insertion_sort_blocks",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_blocks),
+      KOKKOS_LAMBDA(int b) {
+        int const begin = shift + b * block_size;
+        int const end = (begin + block_size < n ? begin + block_size : n);
+        for (int i = begin + 1; i < end; ++i)
+        {
+          auto const key = view(i);
+          auto const index = permute(i);
+          int j = i;
+          for (; j > begin && key < view(j - 1); --j)
+          {
+            view(j) = view(j - 1);
+            permute(j) = permute(j - 1);
+          }
+          view(j) = key;
+          permute(j) = index;
+        }
+      });
+}
+
+// Same, for input that is nearly sorted already, e.g. the codes of primitives
+// kept in the order of the previous construction as they move. Blocks of
+// consecutive elements are first sorted independently with insertion sort,
+// which only costs as much as the elements are out of place, and then the
+// blocks straddling their boundaries, which mostly brings in place the
+// elements moved across them by less than half a block. The full sort then
+// only runs over the range of the elements still out of order, if any.
+template <typename ExecutionSpace, typename ViewType,
+          class SizeType = unsigned int>
+auto sortNearlySortedObjects(
+    ExecutionSpace const &space, ViewType &view,
+    std::optional<Experimental::Workspace> const &workspace)
+{
+  Kokkos::Profiling::pushRegion("ArborX::Sorting");
+
+  auto permute = temporaryView<
+      Kokkos::View<SizeType *, typename ViewType::device_type>>(
+      space, workspace, "ArborX::Sorting::permute", view.extent(0));
+  ArborX::iota(space, permute);
+
+  constexpr int block_size = 128;
+  insertionSortBlocks(space, view, permute, block_size, 0);
+  insertionSortBlocks(space, view, permute, block_size, block_size / 2);
+
+  // The permutation is sorted along, and so composed with that of the blocks
+  auto const range = unsortedRange(space, view);
+  if (range.first < range.second)
+  {
+    auto keys = Kokkos::subview(view, range);
+    auto values = Kokkos::subview(permute, range);
+    KokkosExt::sortByKey(space, keys, values);
+  }
+
+  Kokkos::Profiling::popRegion();
+
+  return permute;
+}
+
 // Helper functions and structs for applyPermutations
 namespace PermuteHelper
 {
@@ -84,6 +240,73 @@ struct CopyOp<DstViewType, SrcViewType, 3>
         dst(i_dst, j, k) = src(i_src, j, k);
   }
 };
+
+// Permute several views in a single kernel. Each level of the hierarchy
+// holds one view and the view its permuted data is written to.
+template <class PermutationView, class... Views>
+struct FusedPermute;
+
+template <class PermutationView>
+struct FusedPermute<PermutationView>
+{
+  PermutationView _permutation;
+
+  template <class ExecutionSpace>
+  FusedPermute(ExecutionSpace const &, PermutationView const &permutation)
+      : _permutation(permutation)
+  {}
+
+  KOKKOS_FUNCTION void operator()(int) const {}
+
+  template <class ExecutionSpace>
+  void assignTo(ExecutionSpace const &)
+  {}
+};
+
+template <class PermutationView, class View, class... Views>
+struct FusedPermute<PermutationView, View, Views...>
+    : FusedPermute<PermutationView, Views...>
+{
+  using Base = FusedPermute<PermutationView, Views...>;
+  using PermutedView =
+      Kokkos::View<typename View::non_const_data_type,
+                   typename View::array_layout, typename View::device_type>;
+
+  View _view;
+  PermutedView _permuted_view;
+
+  template <class ExecutionSpace>
+  FusedPermute(ExecutionSpace const &space, PermutationView const &permutation,
+               View const &view, Views const &...views)
+      : Base(space, permutation, views...)
+      , _view(view)
+      , _permuted_view(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                          view.label()),
+                       view.layout())
+  {}
+
+  KOKKOS_FUNCTION void operator()(int i) const
+  {
+    CopyOp<PermutedView, View>::copy(_permuted_view, i, _view,
+                                     this->_permutation(i));
+    Base::operator()(i);
+  }
+
+  // When the caller holds the only reference to the data, the view is rebound
+  // to its permuted data, which nobody can tell apart from permuting it in
+  // place. Unmanaged or shared views are copied back instead.
+  template <class ExecutionSpace>
+  void assignTo(ExecutionSpace const &space, View &view, Views &...views)
+  {
+    _view = View();
+    if (view.use_count() == 1)
+      view = _permuted_view;
+    else
+      Kokkos::deep_copy(space, view, _permuted_view);
+    _permuted_view = PermutedView();
+    Base::assignTo(space, views...);
+  }
+};
 } // namespace PermuteHelper
 
 template <typename ExecutionSpace, typename PermutationView, typename InputView,
@@ -135,6 +358,26 @@ void applyPermutation(ExecutionSpace const &space,
   applyPermutation(space, permutation, scratch_view, view);
 }
 
+// Apply the same permutation to all the views, permuting them in a single
+// kernel. The data is not cloned beforehand, and views whose data nobody else
+// references are not copied back either.
+template <typename ExecutionSpace, typename PermutationView, typename... Views>
+void applyPermutations(ExecutionSpace const &space,
+                       PermutationView const &permutation, Views &...views)
+{
+  static_assert(std::is_integral<typename PermutationView::value_type>::value);
+  for (bool compatible : {(permutation.extent(0) == views.extent(0))...})
+    ARBORX_ASSERT(compatible);
+
+  PermuteHelper::FusedPermute<PermutationView, Views...> permute(
+      space, permutation, views...);
+  Kokkos::parallel_for(
+      "ArborX::Sorting::fused_permute",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, permutation.extent(0)),
+      permute);
+  permute.assignTo(space, views...);
+}
+
 } // namespace ArborX::Details
 
 #endif
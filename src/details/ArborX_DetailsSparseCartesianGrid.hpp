@@ -0,0 +1,179 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_SPARSE_CARTESIAN_GRID_HPP
+#define ARBORX_DETAILS_SPARSE_CARTESIAN_GRID_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsCartesianGrid.hpp> // checkCellBoxPrecision
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_HyperBox.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UnorderedMap.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+namespace ArborX::Details
+{
+
+// Number the cells of the grid occupied by the points. Returns the map from
+// the cell coordinates to the cell indices, and the coordinates of each cell.
+template <typename MemorySpace, typename ExecutionSpace, typename Primitives,
+          typename Grid>
+auto numberOccupiedCells(ExecutionSpace const &space,
+                         Primitives const &primitives, Grid const &grid)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using CellCoordinates =
+      decltype(grid.cellCoordinates(Access::get(primitives, 0)));
+
+  int const n = Access::size(primitives);
+
+  // Insert the coordinates of the occupied cells, growing the map until all
+  // insertions succeed
+  Kokkos::UnorderedMap<CellCoordinates, int, MemorySpace> cell_map(n);
+  while (true)
+  {
+    Kokkos::parallel_for(
+        "ArborX::SparseCartesianGrid::insert_cells",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          cell_map.insert(grid.cellCoordinates(Access::get(primitives, i)));
+        });
+    space.fence("ArborX::SparseCartesianGrid (check insertions)");
+    if (!cell_map.failed_insert())
+      break;
+    cell_map.rehash(2 * cell_map.capacity());
+  }
+
+  // Number the cells in the order of the slots of the map
+  int const capacity = cell_map.capacity();
+  int const num_cells = cell_map.size();
+  Kokkos::View<CellCoordinates *, MemorySpace> cells(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::SparseCartesianGrid::cells"),
+      num_cells);
+  Kokkos::parallel_scan(
+      "ArborX::SparseCartesianGrid::number_cells",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, capacity),
+      KOKKOS_LAMBDA(int k, int &update, bool final_pass) {
+        if (!cell_map.valid_at(k))
+          return;
+        if (final_pass)
+        {
+          cell_map.value_at(k) = update;
+          cells(update) = cell_map.key_at(k);
+        }
+        ++update;
+      });
+
+  return std::make_pair(cell_map, cells);
+}
+
+// Cartesian grid in which only the cells occupied by a given set of points are
+// numbered, consecutively and in no particular order. The cells are
+// identified by their integer coordinates, which a hash map translates into
+// cell indices. Unlike CartesianGrid, the number of cells is bounded by the
+// number of points rather than by the extent of the domain, which allows for
+// very fine grids over large domains.
+template <int DIM, typename MemorySpace>
+struct SparseCartesianGrid
+{
+private:
+  using Box = ExperimentalHyperGeometry::Box<DIM>;
+  using CellCoordinates = Kokkos::Array<long long, DIM>;
+  using CellMap = Kokkos::UnorderedMap<CellCoordinates, int, MemorySpace>;
+
+public:
+  static constexpr int dim = DIM;
+
+  template <typename ExecutionSpace, typename Primitives>
+  SparseCartesianGrid(ExecutionSpace const &space, Primitives const &primitives,
+                      Box const &bounds, float h)
+      : _bounds(bounds)
+  {
+    static_assert(
+        KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+
+    ARBORX_ASSERT(h > 0);
+    for (int d = 0; d < DIM; ++d)
+    {
+      _h[d] = h;
+      // The cell coordinates must be representable
+      ARBORX_ASSERT((double)(bounds.maxCorner()[d] - bounds.minCorner()[d]) /
+                        h <
+                    (double)(1ll << 62));
+    }
+    checkCellBoxPrecision(bounds.minCorner(), _h);
+
+    std::tie(_cell_map, _cells) =
+        numberOccupiedCells<MemorySpace>(space, primitives, *this);
+  }
+
+  template <typename Point, typename Enable = std::enable_if_t<
+                                GeometryTraits::is_point<Point>{}>>
+  KOKKOS_FUNCTION size_t cellIndex(Point const &point) const
+  {
+    static_assert(GeometryTraits::dimension_v<Point> == DIM);
+
+    auto const k = _cell_map.find(cellCoordinates(point));
+    assert(_cell_map.valid_at(k));
+    return _cell_map.value_at(k);
+  }
+
+  KOKKOS_FUNCTION
+  Box cellBox(size_t cell_index) const
+  {
+    auto const &coordinates = _cells(cell_index);
+
+    auto const &min_corner = _bounds.minCorner();
+    Box box;
+    for (int d = 0; d < DIM; ++d)
+    {
+      box.minCorner()[d] = min_corner[d] + coordinates[d] * (double)_h[d];
+      box.maxCorner()[d] = min_corner[d] + (coordinates[d] + 1) * (double)_h[d];
+    }
+    return box;
+  }
+
+  // Number of occupied cells
+  KOKKOS_FUNCTION
+  size_t size() const { return _cells.size(); }
+
+  template <typename Point>
+  KOKKOS_FUNCTION CellCoordinates cellCoordinates(Point const &point) const
+  {
+    // Double precision keeps the coordinates exact for grids far larger than
+    // the 2^24 cells per dimension that single precision can count
+    auto const &min_corner = _bounds.minCorner();
+    CellCoordinates coordinates;
+    for (int d = 0; d < DIM; ++d)
+      coordinates[d] = static_cast<long long>(
+          Kokkos::floor(((double)point[d] - min_corner[d]) / _h[d]));
+    return coordinates;
+  }
+
+private:
+  Box _bounds;
+  float _h[DIM];
+  CellMap _cell_map;
+  // Coordinates of each occupied cell
+  Kokkos::View<CellCoordinates *, MemorySpace> _cells;
+};
+
+} // namespace ArborX::Details
+
+#endif
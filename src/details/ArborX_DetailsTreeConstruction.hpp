@@ -12,9 +12,14 @@
 #ifndef ARBORX_DETAILS_TREE_CONSTRUCTION_HPP
 #define ARBORX_DETAILS_TREE_CONSTRUCTION_HPP
 
-#include <ArborX_DetailsAlgorithms.hpp> // expand
+#include <ArborX_DetailsAlgorithms.hpp> // expand, makeEmptyBoundingVolume
 #include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
-#include <ArborX_DetailsNode.hpp> // makeLeafNode
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsNode.hpp>      // makeLeafNode
+#include <ArborX_DetailsQuantizedNode.hpp>
+#include <ArborX_DetailsSortUtils.hpp> // sortObjects
+#include <ArborX_DetailsUtils.hpp>     // computeOffsetsInOrderedView
+#include <ArborX_HyperBox.hpp>
 #include <ArborX_SpaceFillingCurves.hpp>
 
 #include <Kokkos_Core.hpp>
@@ -24,16 +29,65 @@
 namespace ArborX::Details::TreeConstruction
 {
 
+// The bounding box of the scene may be given as a rank-0 view, in which case
+// the reduction is stored on the device and the host does not wait for it.
 template <typename ExecutionSpace, typename Indexables, typename Box>
 inline void calculateBoundingBoxOfTheScene(ExecutionSpace const &space,
                                            Indexables const &indexables,
                                            Box &scene_bounding_box)
 {
-  Kokkos::parallel_reduce(
-      "ArborX::TreeConstruction::calculate_bounding_box_of_the_scene",
-      Kokkos::RangePolicy<ExecutionSpace>(space, 0, indexables.size()),
-      KOKKOS_LAMBDA(int i, Box &update) { update += indexables(i); },
-      Kokkos::Sum<Box>{scene_bounding_box});
+  if constexpr (Kokkos::is_view_v<Box>)
+  {
+    using BoundingBox = typename Box::non_const_value_type;
+    Kokkos::parallel_reduce(
+        "ArborX::TreeConstruction::calculate_bounding_box_of_the_scene",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, indexables.size()),
+        KOKKOS_LAMBDA(int i, BoundingBox &update) {
+          expand(update, indexables(i));
+        },
+        Kokkos::Sum<BoundingBox, typename Box::memory_space>{
+            scene_bounding_box});
+  }
+  else
+  {
+    Kokkos::parallel_reduce(
+        "ArborX::TreeConstruction::calculate_bounding_box_of_the_scene",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, indexables.size()),
+        KOKKOS_LAMBDA(int i, Box &update) { expand(update, indexables(i)); },
+        Kokkos::Sum<Box>{scene_bounding_box});
+  }
+}
+
+// Indexables evenly spaced in the input, over which the bounds of the scene
+// are estimated without reading all of it
+template <typename Indexables>
+struct SampledIndexables
+{
+  Indexables _indexables;
+  int _num_samples;
+
+  KOKKOS_FUNCTION decltype(auto) operator()(int i) const
+  {
+    return _indexables((long long)i * _indexables.size() / _num_samples);
+  }
+
+  KOKKOS_FUNCTION int size() const { return _num_samples; }
+};
+
+// Estimate the bounding box of the scene from num_samples indexables, or
+// compute it exactly if there are not more indexables than that
+template <typename ExecutionSpace, typename Indexables, typename Box>
+inline void calculateBoundingBoxOfTheSceneFromSample(
+    ExecutionSpace const &space, Indexables const &indexables,
+    int num_samples, Box &scene_bounding_box)
+{
+  ARBORX_ASSERT(num_samples > 0);
+  if (num_samples >= (int)indexables.size())
+    calculateBoundingBoxOfTheScene(space, indexables, scene_bounding_box);
+  else
+    calculateBoundingBoxOfTheScene(
+        space, SampledIndexables<Indexables>{indexables, num_samples},
+        scene_bounding_box);
 }
 
 template <typename ExecutionSpace, typename Indexables,
@@ -46,15 +100,133 @@ inline void projectOntoSpaceFillingCurve(ExecutionSpace const &space,
 {
   size_t const n = indexables.size();
   ARBORX_ASSERT(linear_ordering_indices.extent(0) == n);
-  static_assert(
-      std::is_same<typename LinearOrdering::value_type,
-                   decltype(curve(scene_bounding_box, indexables(0)))>::value);
 
+  // As above, the bounding box of the scene may be read from the device
+  if constexpr (Kokkos::is_view_v<Box>)
+  {
+    static_assert(std::is_same<typename LinearOrdering::value_type,
+                               decltype(curve(scene_bounding_box(),
+                                              indexables(0)))>::value);
+    Kokkos::parallel_for(
+        "ArborX::TreeConstruction::project_primitives_onto_space_filling_curve",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          linear_ordering_indices(i) =
+              curve(scene_bounding_box(), indexables(i));
+        });
+  }
+  else
+  {
+    static_assert(std::is_same<typename LinearOrdering::value_type,
+                               decltype(curve(scene_bounding_box,
+                                              indexables(0)))>::value);
+    Kokkos::parallel_for(
+        "ArborX::TreeConstruction::project_primitives_onto_space_filling_curve",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+          linear_ordering_indices(i) = curve(scene_bounding_box, indexables(i));
+        });
+  }
+}
+
+// Clustered data yields many indexables sharing the same code along the
+// space-filling curve, which are then ordered arbitrarily. Re-encode each
+// group of duplicates with a 32-bit Morton code relative to the bounding box
+// of the group, and sort the group accordingly. Returns these secondary codes
+// in sorted order to break the ties in generateHierarchy(), or an empty view
+// if the codes are all unique.
+template <typename ExecutionSpace, typename Indexables,
+          typename SortedLinearOrdering, typename PermutationIndices>
+auto refineDuplicateCodes(ExecutionSpace const &space,
+                          Indexables const &indexables,
+                          SortedLinearOrdering const &sorted_morton_codes,
+                          PermutationIndices &permutation_indices)
+{
+  using MemorySpace = typename SortedLinearOrdering::memory_space;
+  using Point = std::decay_t<decltype(returnCentroid(indexables(0)))>;
+  using Box = ExperimentalHyperGeometry::Box<
+      GeometryTraits::dimension_v<Point>,
+      typename GeometryTraits::coordinate_type<Point>::type>;
+
+  int const n = sorted_morton_codes.extent_int(0);
+  ARBORX_ASSERT(permutation_indices.extent_int(0) == n);
+
+  Kokkos::View<unsigned int *, MemorySpace> duplicate_codes(
+      "ArborX::TreeConstruction::duplicate_codes", 0);
+
+  Kokkos::View<int *, MemorySpace> offsets(
+      "ArborX::TreeConstruction::duplicate_offsets", 0);
+  computeOffsetsInOrderedView(space, sorted_morton_codes, offsets);
+  int const num_groups = offsets.extent_int(0) - 1;
+  if (num_groups == n)
+    return duplicate_codes;
+
+  // Only keep the groups with more than one indexable
+  Kokkos::View<int *, MemorySpace> groups(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::TreeConstruction::duplicate_groups"),
+      num_groups);
+  int num_duplicate_groups;
+  Kokkos::parallel_scan(
+      "ArborX::TreeConstruction::find_duplicate_groups",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_groups),
+      KOKKOS_LAMBDA(int i, int &update, bool final_pass) {
+        if (offsets(i + 1) - offsets(i) > 1)
+        {
+          if (final_pass)
+            groups(update) = i;
+          ++update;
+        }
+      },
+      num_duplicate_groups);
+
+  // Sort by (position of the group, secondary code) to keep the groups in
+  // place
+  Kokkos::View<unsigned long long *, MemorySpace> keys(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::TreeConstruction::duplicate_keys"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::initialize_duplicate_keys",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) { keys(i) = (unsigned long long)i << 32; });
+
+  using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace>;
   Kokkos::parallel_for(
-      "ArborX::TreeConstruction::project_primitives_onto_space_filling_curve",
+      "ArborX::TreeConstruction::refine_duplicate_codes",
+      TeamPolicy(space, num_duplicate_groups, Kokkos::AUTO),
+      KOKKOS_LAMBDA(typename TeamPolicy::member_type const &team) {
+        int const group = groups(team.league_rank());
+        int const first = offsets(group);
+        int const last = offsets(group + 1);
+
+        Box bounding_box;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange(team, first, last),
+            [&](int i, Box &update) {
+              expand(update, indexables(permutation_indices(i)));
+            },
+            Kokkos::Sum<Box>{bounding_box});
+
+        Kokkos::parallel_for(Kokkos::TeamThreadRange(team, first, last),
+                             [&](int i) {
+                               auto p = returnCentroid(
+                                   indexables(permutation_indices(i)));
+                               translateAndScale(p, p, bounding_box);
+                               keys(i) = ((unsigned long long)first << 32) |
+                                         morton32(p);
+                             });
+      });
+
+  auto const permute = sortObjects(space, keys);
+  applyPermutation(space, permute, permutation_indices);
+
+  KokkosExt::reallocWithoutInitializing(space, duplicate_codes, n);
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::extract_duplicate_codes",
       Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
-        linear_ordering_indices(i) = curve(scene_bounding_box, indexables(i));
+        duplicate_codes(i) = keys(i) & 0xffffffffu;
       });
+
+  return duplicate_codes;
 }
 
 template <typename ExecutionSpace, typename Values, typename IndexableGetter,
@@ -75,7 +247,7 @@ initializeSingleLeafTree(ExecutionSpace const &space, Values const &values,
       "ArborX::TreeConstruction::initialize_single_leaf_tree",
       Kokkos::RangePolicy<ExecutionSpace>(space, 0, 1), KOKKOS_LAMBDA(int) {
         leaf_nodes(0) = makeLeafNode(values(0));
-        BoundingVolume bv;
+        auto bv = makeEmptyBoundingVolume<BoundingVolume>();
         expand(bv, indexable_getter(leaf_nodes(0).value));
         bounding_volume() = bv;
       });
@@ -98,6 +270,8 @@ class GenerateHierarchy
   using LinearOrderingValueType = typename LinearOrdering::non_const_value_type;
   using BoundingVolume =
       typename InternalNodes::value_type::bounding_volume_type;
+  static constexpr bool is_quantized =
+      is_quantized_internal_node<typename InternalNodes::value_type>::value;
 
 public:
   template <typename ExecutionSpace>
@@ -106,17 +280,22 @@ public:
                     PermutationIndices const &permutation_indices,
                     LinearOrdering const &sorted_morton_codes,
                     LeafNodes leaf_nodes, InternalNodes internal_nodes,
-                    BoundingVolume &bounds)
+                    BoundingVolume &bounds,
+                    Kokkos::View<unsigned int const *, MemorySpace> const
+                        &duplicate_codes = {},
+                    bool copy_bounds_to_host = true)
       : _values(values)
       , _indexable_getter(indexable_getter)
       , _permutation_indices(permutation_indices)
       , _sorted_morton_codes(sorted_morton_codes)
+      , _duplicate_codes(duplicate_codes)
       , _leaf_nodes(leaf_nodes)
       , _internal_nodes(internal_nodes)
       , _ranges(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
                                    "ArborX::BVH::BVH::ranges"),
                 internal_nodes.extent(0))
       , _num_internal_nodes(_internal_nodes.extent_int(0))
+      , _scene_bounding_volume(bounds)
   {
     Kokkos::deep_copy(space, _ranges, UNTOUCHED_NODE);
 
@@ -125,12 +304,16 @@ public:
         Kokkos::RangePolicy<ExecutionSpace>(space, 0, leaf_nodes.extent(0)),
         *this);
 
-    Kokkos::deep_copy(
-        space,
-        Kokkos::View<BoundingVolume, Kokkos::HostSpace,
-                     Kokkos::MemoryUnmanaged>(&bounds),
-        Kokkos::View<BoundingVolume const, MemorySpace,
-                     Kokkos::MemoryUnmanaged>(getRootBoundingVolumePtr()));
+    // The root of a quantized hierarchy spans the whole grid, i.e. the bounds
+    // of the scene that were given
+    if constexpr (!is_quantized)
+      if (copy_bounds_to_host)
+        Kokkos::deep_copy(
+            space,
+            Kokkos::View<BoundingVolume, Kokkos::HostSpace,
+                         Kokkos::MemoryUnmanaged>(&bounds),
+            Kokkos::View<BoundingVolume const, MemorySpace,
+                         Kokkos::MemoryUnmanaged>(getRootBoundingVolumePtr()));
   }
 
   KOKKOS_FUNCTION
@@ -182,6 +365,19 @@ public:
     // Morton comparison. Thus, we add LLONG_MIN to it.
     auto const x = _sorted_morton_codes(i) ^ _sorted_morton_codes(i + 1);
 
+    // Duplicate codes may have been refined with a secondary code (see
+    // refineDuplicateCodes()), which is then concatenated between the code
+    // and the index. It needs at least 64-bit keys to fit.
+    if constexpr (sizeof(DeltaValueType) >= 8)
+    {
+      if (!x && _duplicate_codes.size() > 0)
+      {
+        DeltaValueType const y =
+            _duplicate_codes(i) ^ _duplicate_codes(i + 1);
+        return min_value + (y << 31) + (i ^ (i + 1)) - 1;
+      }
+    }
+
     return x + (!x) * (min_value + (i ^ (i + 1))) - 1;
     //                                            ^^^
     // When using 63 bits for Morton codes, the LLONG_MAX is actually a valid
@@ -223,7 +419,7 @@ public:
     auto &leaf_node = _leaf_nodes(i);
     leaf_node = makeLeafNode(_values(original_index));
 
-    BoundingVolume bounding_volume{};
+    auto bounding_volume = makeEmptyBoundingVolume<BoundingVolume>();
     expand(bounding_volume, _indexable_getter(leaf_node.value));
 
     // For a leaf node, the range is just one index
@@ -287,7 +483,9 @@ public:
           expand(bounding_volume,
                  _indexable_getter(_leaf_nodes(right_child).value));
         else
-          expand(bounding_volume, _internal_nodes(right_child).bounding_volume);
+          expand(bounding_volume,
+                 getBoundingVolume(_internal_nodes(right_child),
+                                   _scene_bounding_volume));
       }
       else
       {
@@ -311,7 +509,9 @@ public:
           expand(bounding_volume,
                  _indexable_getter(_leaf_nodes(left_child).value));
         else
-          expand(bounding_volume, _internal_nodes(left_child).bounding_volume);
+          expand(bounding_volume,
+                 getBoundingVolume(_internal_nodes(left_child),
+                                   _scene_bounding_volume));
 
         if (!left_child_is_leaf)
           left_child = internalIndex(left_child);
@@ -324,7 +524,7 @@ public:
       auto &parent_node = _internal_nodes(karras_parent);
       parent_node.left_child = left_child;
       setRope(parent_node, range_right, delta_right);
-      parent_node.bounding_volume = bounding_volume;
+      setBoundingVolume(parent_node, bounding_volume, _scene_bounding_volume);
 
       i = internalIndex(karras_parent);
     } while (i != root);
@@ -335,12 +535,47 @@ private:
   IndexableGetter _indexable_getter;
   PermutationIndices _permutation_indices;
   LinearOrdering _sorted_morton_codes;
+  Kokkos::View<unsigned int const *, MemorySpace> _duplicate_codes;
   LeafNodes _leaf_nodes;
   InternalNodes _internal_nodes;
   Kokkos::View<int *, MemorySpace> _ranges;
   int _num_internal_nodes;
+  BoundingVolume _scene_bounding_volume;
 };
 
+// Touch the pages of the nodes in a static schedule over their index, so that
+// on host backends each of them is first touched, and thus placed on NUMA
+// systems, by the thread that later processes the predicates sorted next to
+// it along the space-filling curve. Leaf i and internal node i both span the
+// i-th position along the curve. The hierarchy generation otherwise writes
+// them in the order in which the threads climb the tree.
+template <typename ExecutionSpace, typename LeafNodes, typename InternalNodes>
+void firstTouchNodes(ExecutionSpace const &space, LeafNodes leaf_nodes,
+                     InternalNodes internal_nodes)
+{
+  if constexpr (Kokkos::SpaceAccessibility<ExecutionSpace,
+                                           Kokkos::HostSpace>::accessible)
+  {
+    KokkosExt::ScopedProfileRegion guard(
+        "ArborX::TreeConstruction::first_touch_nodes");
+    Kokkos::parallel_for(
+        "ArborX::TreeConstruction::first_touch_nodes",
+        Kokkos::RangePolicy<ExecutionSpace, Kokkos::Schedule<Kokkos::Static>>(
+            space, 0, leaf_nodes.extent(0)),
+        KOKKOS_LAMBDA(int i) {
+          *reinterpret_cast<char *>(&leaf_nodes(i)) = 0;
+          if (i < (int)internal_nodes.extent(0))
+            *reinterpret_cast<char *>(&internal_nodes(i)) = 0;
+        });
+  }
+}
+
+// Quantized internal nodes can be generated directly, on the grid spanned by
+// the bounds of the scene, which must then be given in bounds. Otherwise,
+// bounds is set to the bounding volume of the root, unless copy_bounds_to_host
+// is false, in which case the caller reads it from the first internal node
+// once it no longer minds waiting for the hierarchy to be generated.
+
 template <typename ExecutionSpace, typename Values, typename IndexableGetter,
           typename... PermutationIndicesViewProperties,
           typename LinearOrderingValueType,
@@ -354,7 +589,10 @@ void generateHierarchy(
     Kokkos::View<LinearOrderingValueType *, LinearOrderingViewProperties...>
         sorted_morton_codes,
     LeafNodes leaf_nodes, InternalNodes internal_nodes,
-    typename InternalNodes::value_type::bounding_volume_type &bounds)
+    typename InternalNodes::value_type::bounding_volume_type &bounds,
+    Kokkos::View<unsigned int const *, typename LeafNodes::memory_space> const
+        &duplicate_codes = {},
+    bool copy_bounds_to_host = true)
 {
   using ConstPermutationIndices =
       Kokkos::View<unsigned int const *, PermutationIndicesViewProperties...>;
@@ -364,7 +602,276 @@ void generateHierarchy(
   GenerateHierarchy(space, values, indexable_getter,
                     ConstPermutationIndices(permutation_indices),
                     ConstLinearOrdering(sorted_morton_codes), leaf_nodes,
-                    internal_nodes, bounds);
+                    internal_nodes, bounds, duplicate_codes,
+                    copy_bounds_to_host);
+}
+
+// Reorder the internal nodes depth-first, left child first, so that the left
+// child of an internal node, when internal, is the next node in memory and
+// the rope out of a subtree leads right past it. The root stays first and the
+// leaves stay in place, only their ropes are updated.
+template <typename ExecutionSpace, typename LeafNodes, typename InternalNodes>
+void reorderInternalNodesDepthFirst(ExecutionSpace const &space,
+                                    LeafNodes leaf_nodes,
+                                    InternalNodes &internal_nodes)
+{
+  using MemorySpace = typename LeafNodes::memory_space;
+
+  int const n = leaf_nodes.extent_int(0);
+  if (n <= 2)
+    return;
+  ARBORX_ASSERT(internal_nodes.extent_int(0) == n - 1);
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::TreeConstruction::reorder_internal_nodes_depth_first");
+
+  Kokkos::View<int *, MemorySpace> parents(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::TreeConstruction::reorder::parents"),
+      2 * n - 1);
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::reorder::find_parents",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n - 1),
+      KOKKOS_LAMBDA(int k) {
+        // Right child is the rope of the left child
+        int const left_child = internal_nodes(k).left_child;
+        int const right_child =
+            (left_child < n ? leaf_nodes(left_child).rope
+                            : internal_nodes(left_child - n).rope);
+        parents(left_child) = n + k;
+        parents(right_child) = n + k;
+      });
+
+  // Number of leaves of the subtree of each internal node, accumulated from
+  // the leaves up as in refitHierarchy()
+  Kokkos::View<int *, MemorySpace> sizes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::TreeConstruction::reorder::sizes"),
+      n - 1);
+  Kokkos::View<int *, MemorySpace> visits(
+      Kokkos::view_alloc(space, "ArborX::TreeConstruction::reorder::visits"),
+      n - 1);
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::reorder::compute_sizes",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        int const root = n;
+        int size = 1;
+        int node = i;
+        do
+        {
+          int const parent = parents(node);
+
+          Kokkos::memory_fence();
+          if (Kokkos::atomic_fetch_add(&visits(parent - n), 1) == 0)
+            break;
+          Kokkos::load_fence();
+
+          int const left_child = internal_nodes(parent - n).left_child;
+          int sibling = left_child;
+          if (node == left_child)
+            sibling = (node < n ? leaf_nodes(node).rope
+                                : internal_nodes(node - n).rope);
+          size += (sibling < n ? 1 : sizes(sibling - n));
+          sizes(parent - n) = size;
+
+          node = parent;
+        } while (node != root);
+      });
+
+  // The left child comes right after its parent, and the right child after
+  // the internal nodes of the subtree of the left child
+  Kokkos::View<int *, MemorySpace> positions(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::TreeConstruction::reorder::positions"),
+      n - 1);
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::reorder::compute_positions",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n - 1),
+      KOKKOS_LAMBDA(int k) {
+        int const root = n;
+        int position = 0;
+        for (int node = n + k; node != root;)
+        {
+          int const parent = parents(node);
+          int const left_child = internal_nodes(parent - n).left_child;
+          ++position;
+          if (node != left_child && left_child >= n)
+            position += sizes(left_child - n) - 1;
+          node = parent;
+        }
+        positions(k) = position;
+      });
+
+  InternalNodes reordered_internal_nodes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         internal_nodes.label()),
+      n - 1);
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::reorder::permute_internal_nodes",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n - 1),
+      KOKKOS_LAMBDA(int k) {
+        auto node = internal_nodes(k);
+        if (node.left_child >= n)
+          node.left_child = n + positions(node.left_child - n);
+        if (node.rope >= n)
+          node.rope = n + positions(node.rope - n);
+        reordered_internal_nodes(positions(k)) = node;
+      });
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::reorder::update_leaf_ropes",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        int const rope = leaf_nodes(i).rope;
+        if (rope >= n)
+          leaf_nodes(i).rope = n + positions(rope - n);
+      });
+  internal_nodes = reordered_internal_nodes;
+}
+
+// As for generateHierarchy(), quantized internal nodes are refitted in place
+// on the grid spanned by the bounds of the scene given in bounds.
+template <typename ExecutionSpace, typename Values, typename IndexableGetter,
+          typename Parents, typename LeafNodes, typename InternalNodes>
+void refitHierarchy(
+    ExecutionSpace const &space, Values const &values,
+    IndexableGetter const &indexable_getter, Parents const &parents,
+    LeafNodes leaf_nodes, InternalNodes internal_nodes,
+    typename InternalNodes::value_type::bounding_volume_type &bounds)
+{
+  using MemorySpace = typename LeafNodes::memory_space;
+  using BoundingVolume =
+      typename InternalNodes::value_type::bounding_volume_type;
+  constexpr bool is_quantized =
+      is_quantized_internal_node<typename InternalNodes::value_type>::value;
+
+  int const n = leaf_nodes.extent_int(0);
+  ARBORX_ASSERT(n >= 2);
+  ARBORX_ASSERT((int)values.size() == n);
+  ARBORX_ASSERT(parents.extent_int(0) == 2 * n - 1);
+
+  Kokkos::View<int *, MemorySpace> visits(
+      Kokkos::view_alloc(space, "ArborX::BVH::refit::visits"), n - 1);
+
+  BoundingVolume const scene_bounding_volume = bounds;
+
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::refit_hierarchy",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        // Leaf nodes keep their position along the space-filling curve, only
+        // the value (and hence the indexable) is updated. Ropes are left
+        // untouched.
+        auto &leaf_node = leaf_nodes(i);
+        leaf_node.value = values(leaf_node.value.index);
+
+        auto bounding_volume = makeEmptyBoundingVolume<BoundingVolume>();
+        expand(bounding_volume, indexable_getter(leaf_node.value));
+
+        int const root = n;
+        int node = i;
+        do
+        {
+          int const parent = parents(node);
+
+          // Make sure the writes to the subtree rooted at node are visible to
+          // the thread processing the sibling before signaling arrival.
+          Kokkos::memory_fence();
+
+          // Same as in GenerateHierarchy, terminate the first thread that
+          // reaches an internal node and let the second one through, so that
+          // every node is processed once and only after both of its children.
+          if (Kokkos::atomic_fetch_add(&visits(parent - n), 1) == 0)
+            break;
+
+          Kokkos::load_fence();
+
+          // Right child is the rope of the left child
+          int const left_child = internal_nodes(parent - n).left_child;
+          int sibling = left_child;
+          if (node == left_child)
+            sibling = (node < n ? leaf_nodes(node).rope
+                                : internal_nodes(node - n).rope);
+
+          if (sibling < n)
+            expand(bounding_volume,
+                   indexable_getter(leaf_nodes(sibling).value));
+          else
+            expand(bounding_volume,
+                   getBoundingVolume(internal_nodes(sibling - n),
+                                     scene_bounding_volume));
+
+          setBoundingVolume(internal_nodes(parent - n), bounding_volume,
+                            scene_bounding_volume);
+
+          node = parent;
+        } while (node != root);
+      });
+
+  if constexpr (!is_quantized)
+    Kokkos::deep_copy(
+        space,
+        Kokkos::View<BoundingVolume, Kokkos::HostSpace,
+                     Kokkos::MemoryUnmanaged>(&bounds),
+        Kokkos::View<BoundingVolume const, MemorySpace,
+                     Kokkos::MemoryUnmanaged>(
+            &internal_nodes.data()->bounding_volume));
+}
+
+// Half of the surface area of the axis-aligned box enclosing the bounding
+// volume (its length in 1D)
+template <typename BoundingVolume>
+KOKKOS_FUNCTION float halfSurfaceArea(BoundingVolume const &bounding_volume)
+{
+  constexpr int DIM = GeometryTraits::dimension_v<BoundingVolume>;
+  using Coordinate =
+      typename GeometryTraits::coordinate_type<BoundingVolume>::type;
+
+  ExperimentalHyperGeometry::Box<DIM, Coordinate> box{};
+  expand(box, bounding_volume);
+
+  float extents[DIM];
+  for (int d = 0; d < DIM; ++d)
+  {
+    extents[d] = box.maxCorner()[d] - box.minCorner()[d];
+    if (!(extents[d] > 0)) // also catches empty boxes
+      extents[d] = 0;
+  }
+
+  if constexpr (DIM == 1)
+    return extents[0];
+
+  float area = 0;
+  for (int d = 0; d < DIM; ++d)
+  {
+    float face = 1;
+    for (int e = 0; e < DIM; ++e)
+      if (e != d)
+        face *= extents[e];
+    area += face;
+  }
+  return area;
+}
+
+// Surface area heuristic cost of the hierarchy, i.e. the sum of the surface
+// areas of the internal nodes normalized by that of the root. The lower, the
+// fewer nodes a random query is expected to visit.
+template <typename ExecutionSpace, typename InternalNodes>
+float computeSurfaceAreaHeuristicCost(
+    ExecutionSpace const &space, InternalNodes const &internal_nodes,
+    typename InternalNodes::value_type::bounding_volume_type const &bounds)
+{
+  float const root_area = halfSurfaceArea(bounds);
+  if (!(root_area > 0))
+    return 0.f;
+
+  float cost = 0;
+  Kokkos::parallel_reduce(
+      "ArborX::TreeConstruction::compute_surface_area_heuristic_cost",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, internal_nodes.extent(0)),
+      KOKKOS_LAMBDA(int i, float &update) {
+        update +=
+            halfSurfaceArea(getBoundingVolume(internal_nodes(i), bounds));
+      },
+      cost);
+  return cost / root_area;
 }
 
 } // namespace ArborX::Details::TreeConstruction
@@ -0,0 +1,287 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_TREE_CONSTRUCTION_PLOC_HPP
+#define ARBORX_DETAILS_TREE_CONSTRUCTION_PLOC_HPP
+
+#include <ArborX_DetailsAlgorithms.hpp> // expand, makeEmptyBoundingVolume
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsNode.hpp> // makeLeafNode, ROPE_SENTINEL
+#include <ArborX_DetailsTreeConstruction.hpp> // halfSurfaceArea
+#include <ArborX_Exception.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <vector>
+
+namespace ArborX::Details::TreeConstruction
+{
+
+// Parallel locally-ordered clustering (PLOC) as described in
+//   D. Meister, J. Bittner, "Parallel Locally-Ordered Clustering for Bounding
+//   Volume Hierarchy Construction", IEEE TVCG, 2018.
+//
+// Starting from the leaves ordered along the space-filling curve, every
+// cluster looks for its nearest neighbor (smallest enclosing surface area)
+// among the search_radius clusters on each side. Mutual nearest neighbors are
+// merged, and the process is repeated on the compacted list of clusters until
+// a single cluster remains.
+//
+// Nodes are identified during the clustering by an id: ids [0, n) are the
+// leaves and an internal node gets the next available id [n, 2n-1) when it
+// is created. Hence, the root has id 2n-2 and the parent of a node always has
+// a larger id. Once done, the internal nodes are stored in reverse order of
+// creation so that the root ends up in position 0, as expected by the
+// traversal.
+template <typename ExecutionSpace, typename Values, typename IndexableGetter,
+          typename PermutationIndices, typename LeafNodes,
+          typename InternalNodes>
+void generateHierarchyPLOC(
+    ExecutionSpace const &space, Values const &values,
+    IndexableGetter const &indexable_getter,
+    PermutationIndices const &permutation_indices, int search_radius,
+    LeafNodes leaf_nodes, InternalNodes internal_nodes,
+    typename InternalNodes::value_type::bounding_volume_type &bounds)
+{
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::TreeConstruction::generate_hierarchy_ploc");
+
+  using MemorySpace = typename LeafNodes::memory_space;
+  using BoundingVolume =
+      typename InternalNodes::value_type::bounding_volume_type;
+
+  int const n = leaf_nodes.extent_int(0);
+  ARBORX_ASSERT(n >= 2);
+  ARBORX_ASSERT(internal_nodes.extent_int(0) == n - 1);
+  ARBORX_ASSERT(permutation_indices.extent_int(0) == n);
+  ARBORX_ASSERT(search_radius >= 1);
+
+  int const num_nodes = 2 * n - 1;
+  int const root_id = num_nodes - 1;
+
+  Kokkos::View<BoundingVolume *, MemorySpace> bounding_volumes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVH::BVH::PLOC::bounding_volumes"),
+      num_nodes);
+  Kokkos::View<Kokkos::pair<int, int> *, MemorySpace> children(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVH::BVH::PLOC::children"),
+      n - 1);
+  Kokkos::View<int *, MemorySpace> clusters(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVH::BVH::PLOC::clusters"),
+      n);
+  Kokkos::View<int *, MemorySpace> merged_clusters(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVH::BVH::PLOC::merged_clusters"),
+      n);
+  Kokkos::View<int *, MemorySpace> nearest_neighbors(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVH::BVH::PLOC::nearest_neighbors"),
+      n);
+
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::PLOC::initialize_leaves",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        auto &leaf_node = leaf_nodes(i);
+        leaf_node = makeLeafNode(values(permutation_indices(i)));
+
+        auto bounding_volume = makeEmptyBoundingVolume<BoundingVolume>();
+        expand(bounding_volume, indexable_getter(leaf_node.value));
+        bounding_volumes(i) = bounding_volume;
+
+        clusters(i) = i;
+      });
+
+  // Ranges of ids of the internal nodes created at each iteration
+  std::vector<int> iteration_offsets{n};
+
+  int num_clusters = n;
+  while (num_clusters > 1)
+  {
+    Kokkos::parallel_for(
+        "ArborX::TreeConstruction::PLOC::find_nearest_neighbors",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_clusters),
+        KOKKOS_LAMBDA(int i) {
+          auto const &bounding_volume = bounding_volumes(clusters(i));
+
+          // Pairs are compared by cost first. Ties are broken by preferring
+          // closer pairs along the curve, then pairs starting at an even
+          // position. This defines a total order on pairs, which guarantees
+          // that at least one pair of mutual nearest neighbors exists, and
+          // lets adjacent clusters pair up in degenerate situations (e.g.,
+          // duplicate primitives).
+          auto less = [](float cost, int distance, int first, float other_cost,
+                         int other_distance, int other_first) {
+            if (cost != other_cost)
+              return cost < other_cost;
+            if (distance != other_distance)
+              return distance < other_distance;
+            if ((first & 1) != (other_first & 1))
+              return (first & 1) < (other_first & 1);
+            return first < other_first;
+          };
+
+          int nearest = -1;
+          float nearest_cost =
+              KokkosExt::ArithmeticTraits::infinity<float>::value;
+          int nearest_distance = num_clusters;
+          int nearest_first = num_clusters;
+
+          int const first = (i > search_radius ? i - search_radius : 0);
+          int const last = (i + search_radius < num_clusters - 1
+                                ? i + search_radius
+                                : num_clusters - 1);
+          for (int j = first; j <= last; ++j)
+          {
+            if (j == i)
+              continue;
+
+            BoundingVolume merged = bounding_volume;
+            expand(merged, bounding_volumes(clusters(j)));
+            float const cost = halfSurfaceArea(merged);
+            int const distance = (i < j ? j - i : i - j);
+            int const pair_first = (i < j ? i : j);
+
+            if (nearest == -1 || less(cost, distance, pair_first, nearest_cost,
+                                      nearest_distance, nearest_first))
+            {
+              nearest = j;
+              nearest_cost = cost;
+              nearest_distance = distance;
+              nearest_first = pair_first;
+            }
+          }
+          nearest_neighbors(i) = nearest;
+        });
+
+    int const num_created = iteration_offsets.back();
+
+    // Merge mutual nearest neighbors. The left cluster of the pair is
+    // replaced by the new node, and the right one is marked for removal.
+    int num_merges;
+    Kokkos::parallel_scan(
+        "ArborX::TreeConstruction::PLOC::merge_clusters",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_clusters),
+        KOKKOS_LAMBDA(int i, int &update, bool final_pass) {
+          int const j = nearest_neighbors(i);
+          bool const is_mutual = (nearest_neighbors(j) == i);
+          if (!final_pass)
+          {
+            if (is_mutual && i < j)
+              ++update;
+            return;
+          }
+
+          if (!is_mutual)
+          {
+            merged_clusters(i) = clusters(i);
+            return;
+          }
+          if (j < i)
+          {
+            merged_clusters(i) = -1;
+            return;
+          }
+
+          int const id = num_created + update;
+          int const left_child = clusters(i);
+          int const right_child = clusters(j);
+          children(id - n) = {left_child, right_child};
+
+          BoundingVolume bounding_volume = bounding_volumes(left_child);
+          expand(bounding_volume, bounding_volumes(right_child));
+          bounding_volumes(id) = bounding_volume;
+
+          merged_clusters(i) = id;
+          ++update;
+        },
+        num_merges);
+
+    // Each iteration merges at least one pair
+    ARBORX_ASSERT(num_merges > 0);
+
+    int num_remaining_clusters;
+    Kokkos::parallel_scan(
+        "ArborX::TreeConstruction::PLOC::compact_clusters",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_clusters),
+        KOKKOS_LAMBDA(int i, int &update, bool final_pass) {
+          int const cluster = merged_clusters(i);
+          if (cluster == -1)
+            return;
+          if (final_pass)
+            clusters(update) = cluster;
+          ++update;
+        },
+        num_remaining_clusters);
+
+    ARBORX_ASSERT(num_remaining_clusters == num_clusters - num_merges);
+    num_clusters = num_remaining_clusters;
+    iteration_offsets.push_back(num_created + num_merges);
+  }
+  ARBORX_ASSERT(iteration_offsets.back() == num_nodes);
+
+  // Map a node id to the position in the tree (leaves are unchanged, internal
+  // nodes are stored in reverse order of creation)
+  auto position = KOKKOS_LAMBDA(int id)
+  {
+    return (id < n ? id : n + (root_id - id));
+  };
+
+  // Compute ropes top-down. Nodes created during the same iteration do not
+  // depend on each other, and their parents were created in later iterations.
+  Kokkos::View<int *, MemorySpace> ropes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::BVH::BVH::PLOC::ropes"),
+      num_nodes);
+  Kokkos::deep_copy(space, Kokkos::subview(ropes, root_id), ROPE_SENTINEL);
+  for (int iteration = (int)iteration_offsets.size() - 2; iteration >= 0;
+       --iteration)
+  {
+    Kokkos::parallel_for(
+        "ArborX::TreeConstruction::PLOC::compute_ropes",
+        Kokkos::RangePolicy<ExecutionSpace>(space,
+                                            iteration_offsets[iteration],
+                                            iteration_offsets[iteration + 1]),
+        KOKKOS_LAMBDA(int id) {
+          int const left_child = children(id - n).first;
+          int const right_child = children(id - n).second;
+          ropes(left_child) = position(right_child);
+          ropes(right_child) = ropes(id);
+        });
+  }
+
+  Kokkos::parallel_for(
+      "ArborX::TreeConstruction::PLOC::finalize_hierarchy",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_nodes),
+      KOKKOS_LAMBDA(int id) {
+        if (id < n)
+        {
+          leaf_nodes(id).rope = ropes(id);
+          return;
+        }
+        auto &internal_node = internal_nodes(position(id) - n);
+        internal_node.left_child = position(children(id - n).first);
+        internal_node.rope = ropes(id);
+        internal_node.bounding_volume = bounding_volumes(id);
+      });
+
+  Kokkos::deep_copy(
+      space,
+      Kokkos::View<BoundingVolume, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>(
+          &bounds),
+      Kokkos::subview(bounding_volumes, root_id));
+}
+
+} // namespace ArborX::Details::TreeConstruction
+
+#endif
@@ -13,6 +13,7 @@
 #define ARBORX_DETAILS_TREE_NODE_LABELING_HPP
 
 #include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
 #include <ArborX_Exception.hpp>
 
 #include <Kokkos_Core.hpp>
@@ -91,6 +92,106 @@ void reduceLabels(ExecutionSpace const &exec_space, Parents const &parents,
       });
 }
 
+// Incremental counterpart of reduceLabels, once the labels of the leaves
+// have been updated by merging the components. The nodes of a single
+// component stay so, and are relabeled with the new label of the leaf whose
+// index was their label (which belongs to the component). Only the other
+// nodes are reduced again. They form the top of the tree, and their
+// reduction starts from the nodes of a single component right below, rather
+// than from all the leaves. The updates view (of size n - 1) records the
+// internal nodes being reduced.
+template <class ExecutionSpace, class Parents, class Labels, class Updates>
+void updateLabels(ExecutionSpace const &exec_space, Parents const &parents,
+                  Labels labels, Updates updates)
+{
+  int const n = (parents.size() + 1) / 2;
+
+  ARBORX_ASSERT(n >= 2);
+  ARBORX_ASSERT(labels.size() == parents.size());
+  ARBORX_ASSERT((int)updates.size() == n - 1);
+
+  using ValueType = typename Labels::value_type;
+  constexpr ValueType indeterminate = -1;
+  constexpr ValueType untouched = -2;
+
+  Kokkos::parallel_for(
+      "ArborX::update_internal_node_labels",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, n, 2 * n - 1),
+      KOKKOS_LAMBDA(int i) {
+        auto const label = labels(i);
+        bool const update = (label == indeterminate);
+        updates(i - n) = update;
+        labels(i) = (update ? untouched : labels(label));
+      });
+  Kokkos::parallel_for(
+      "ArborX::reduce_updated_internal_node_labels",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, 2 * n - 1),
+      KOKKOS_LAMBDA(int i) {
+        int const root = n;
+        if (i == root || (i >= n && updates(i - n)) ||
+            !updates(parents(i) - n))
+          return;
+
+        do
+        {
+          int const label = labels(i);
+          int const parent = parents(i);
+
+          int const parent_label = Kokkos::atomic_compare_exchange(
+              &labels(parent), untouched, label);
+
+          if (parent_label == untouched)
+            break;
+
+          if (parent_label != label)
+            labels(parent) = indeterminate;
+
+          i = parent;
+        } while (i != root);
+      });
+}
+
+// Set the value of each internal node to the smallest value of the leaves of
+// its subtree, the values of the leaves being given
+template <class ExecutionSpace, class Parents, class Values>
+void reduceMinValues(ExecutionSpace const &exec_space, Parents const &parents,
+                     Values values)
+{
+  int const n = (parents.size() + 1) / 2;
+
+  ARBORX_ASSERT(n >= 2);
+  ARBORX_ASSERT(values.size() == parents.size());
+
+  using ValueType = typename Values::non_const_value_type;
+  using MemorySpace = typename Values::memory_space;
+
+  Kokkos::deep_copy(
+      exec_space, Kokkos::subview(values, std::make_pair(n, 2 * n - 1)),
+      KokkosExt::ArithmeticTraits::infinity<ValueType>::value);
+  Kokkos::View<int *, MemorySpace> visits(
+      Kokkos::view_alloc(exec_space, "ArborX::reduce_min_values::visits"),
+      n - 1);
+  Kokkos::parallel_for(
+      "ArborX::reduce_internal_node_min_values",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        int const root = n;
+        do
+        {
+          int const parent = parents(i);
+          Kokkos::atomic_min(&values(parent), Kokkos::atomic_load(&values(i)));
+          Kokkos::memory_fence();
+
+          // Only the second child to arrive continues, once the parent holds
+          // the values of both
+          if (Kokkos::atomic_fetch_inc(&visits(parent - n)) == 0)
+            break;
+
+          i = parent;
+        } while (i != root);
+      });
+}
+
 } // namespace Details
 } // namespace ArborX
 
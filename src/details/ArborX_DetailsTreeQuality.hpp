@@ -0,0 +1,189 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_TREE_QUALITY_HPP
+#define ARBORX_DETAILS_TREE_QUALITY_HPP
+
+#include <ArborX_DetailsAlgorithms.hpp> // expand
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsTreeConstruction.hpp> // halfSurfaceArea
+#include <ArborX_DetailsTreeNodeLabeling.hpp> // findParents
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_HyperBox.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <vector>
+
+namespace ArborX
+{
+namespace Experimental
+{
+
+// Measures of the quality of a hierarchy, e.g. to decide whether to rebuild
+// it rather than refitting it, or to compare space-filling curves
+struct TreeQuality
+{
+  // Sum of the half surface areas of the internal nodes normalized by that of
+  // the root. The lower, the fewer nodes a random query is expected to visit.
+  float surface_area_heuristic_cost = 0;
+
+  // Sum over the internal nodes of the volume of the intersection of the
+  // boxes enclosing their two children. The lower, the fewer nodes are
+  // visited on both sides of the hierarchy.
+  float sibling_overlap_volume = 0;
+
+  // Number of leaves at each depth, the root being at depth 0
+  std::vector<int> leaf_depth_histogram;
+
+  // Mean over the internal nodes with a leaf child of the ratio of the half
+  // surface area of the box enclosing their children to that of their own
+  // bounding volume. It is one for tight boxes, and lower for looser bounding
+  // volumes, e.g. quantized ones.
+  float leaf_tightness = 1;
+};
+
+// Compute the quality measures of the hierarchy on the device. Only the
+// depth histogram is copied back to the host.
+template <typename ExecutionSpace, typename BVH>
+TreeQuality computeTreeQuality(ExecutionSpace const &space, BVH const &bvh)
+{
+  using MemorySpace = typename BVH::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+
+  using Details::HappyTreeFriends;
+  using BoundingVolume = typename BVH::bounding_volume_type;
+  constexpr int DIM = GeometryTraits::dimension_v<BoundingVolume>;
+  using Coordinate =
+      typename GeometryTraits::coordinate_type<BoundingVolume>::type;
+  using Box = ExperimentalHyperGeometry::Box<DIM, Coordinate>;
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::computeTreeQuality");
+
+  TreeQuality quality;
+
+  int const n = bvh.size();
+  if (n < 2)
+  {
+    if (n == 1)
+      quality.leaf_depth_histogram = {1};
+    return quality;
+  }
+
+  float area_sum = 0;
+  float tightness_sum = 0;
+  int n_bottom_nodes = 0;
+  Kokkos::parallel_reduce(
+      "ArborX::computeTreeQuality::internal_nodes",
+      Kokkos::RangePolicy<ExecutionSpace>(space, n, 2 * n - 1),
+      KOKKOS_LAMBDA(int i, float &area, float &overlap, float &tightness,
+                    int &count) {
+        using Details::expand;
+        auto enclose = [&bvh](int node) {
+          Box box{};
+          if (HappyTreeFriends::isLeaf(bvh, node))
+            expand(box, HappyTreeFriends::getIndexable(bvh, node));
+          else
+            expand(box, HappyTreeFriends::getInternalBoundingVolume(bvh, node));
+          return box;
+        };
+
+        int const left_child = HappyTreeFriends::getLeftChild(bvh, i);
+        int const right_child = HappyTreeFriends::getRightChild(bvh, i);
+        auto const left_box = enclose(left_child);
+        auto const right_box = enclose(right_child);
+
+        float const node_area = Details::TreeConstruction::halfSurfaceArea(
+            HappyTreeFriends::getInternalBoundingVolume(bvh, i));
+        area += node_area;
+
+        float volume = 1;
+        for (int d = 0; d < DIM; ++d)
+        {
+          float const extent =
+              KokkosExt::min(left_box.maxCorner()[d],
+                             right_box.maxCorner()[d]) -
+              KokkosExt::max(left_box.minCorner()[d], right_box.minCorner()[d]);
+          volume *= (extent > 0 ? extent : 0);
+        }
+        overlap += volume;
+
+        if (HappyTreeFriends::isLeaf(bvh, left_child) ||
+            HappyTreeFriends::isLeaf(bvh, right_child))
+        {
+          auto children_box = left_box;
+          expand(children_box, right_box);
+          tightness +=
+              (node_area > 0 ? Details::TreeConstruction::halfSurfaceArea(
+                                   children_box) /
+                                   node_area
+                             : 1.f);
+          ++count;
+        }
+      },
+      area_sum, quality.sibling_overlap_volume, tightness_sum, n_bottom_nodes);
+
+  float const root_area =
+      Details::TreeConstruction::halfSurfaceArea(bvh.bounds());
+  quality.surface_area_heuristic_cost =
+      (root_area > 0 ? area_sum / root_area : 0.f);
+  quality.leaf_tightness =
+      (n_bottom_nodes > 0 ? tightness_sum / n_bottom_nodes : 1.f);
+
+  // The depths of the leaves are found by walking up to the root
+  Kokkos::View<int *, MemorySpace> parents(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::computeTreeQuality::parents"),
+      2 * n - 1);
+  Details::findParents(space, bvh, parents);
+  Kokkos::View<int *, MemorySpace> depths(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::computeTreeQuality::depths"),
+      n);
+  int max_depth = 0;
+  Kokkos::parallel_reduce(
+      "ArborX::computeTreeQuality::leaf_depths",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, int &update) {
+        int const root = HappyTreeFriends::getRoot(bvh);
+        int depth = 0;
+        for (int node = i; node != root; node = parents(node))
+          ++depth;
+        depths(i) = depth;
+        update = KokkosExt::max(update, depth);
+      },
+      Kokkos::Max<int>(max_depth));
+
+  Kokkos::View<int *, MemorySpace> histogram(
+      Kokkos::view_alloc(space, "ArborX::computeTreeQuality::histogram"),
+      max_depth + 1);
+  Kokkos::parallel_for(
+      "ArborX::computeTreeQuality::depth_histogram",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        Kokkos::atomic_increment(&histogram(depths(i)));
+      });
+  auto const histogram_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, histogram);
+  quality.leaf_depth_histogram.assign(
+      histogram_host.data(), histogram_host.data() + histogram_host.size());
+
+  return quality;
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
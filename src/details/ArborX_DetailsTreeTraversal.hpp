@@ -12,9 +12,13 @@
 #define ARBORX_DETAILS_TREE_TRAVERSAL_HPP
 
 #include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_ConvexPolytope.hpp>
 #include <ArborX_DetailsAlgorithms.hpp>
 #include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
 #include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
 #include <ArborX_DetailsKokkosExtViewHelpers.hpp>
 #include <ArborX_DetailsNode.hpp> // ROPE_SENTINEL
 #include <ArborX_DetailsPriorityQueue.hpp>
@@ -22,31 +26,192 @@
 #include <ArborX_DetailsUtils.hpp>
 #include <ArborX_Exception.hpp>
 #include <ArborX_Predicates.hpp>
+#include <ArborX_Ray.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_MathematicalFunctions.hpp> // nextafter
+
+#include <algorithm> // min
+#include <cstddef>
+#include <type_traits>
 
 namespace ArborX
 {
 namespace Details
 {
 
-template <typename BVH, typename Predicates, typename Callback, typename Tag>
+// Form of a predicate in which it tests the bounding volumes of the
+// hierarchy. The callbacks are still given the predicate itself.
+template <typename Predicate>
+KOKKOS_INLINE_FUNCTION Predicate const &
+makeTraversalPredicate(Predicate const &predicate)
+{
+  return predicate;
+}
+
+KOKKOS_INLINE_FUNCTION auto
+makeTraversalPredicate(Intersects<Experimental::Ray> const &predicate)
+{
+  return Intersects<Experimental::PrecomputedRay>(
+      Experimental::precompute(getGeometry(predicate)));
+}
+
+KOKKOS_INLINE_FUNCTION auto makeTraversalPredicate(
+    Experimental::OrderedSpatial<Experimental::Ray> const &predicate)
+{
+  return Experimental::OrderedSpatial<Experimental::PrecomputedRay>(
+      Experimental::precompute(getGeometry(predicate)), getK(predicate));
+}
+
+// Whether the geometry of a spatial predicate contains a bounding volume of
+// the hierarchy, in which case all the leaves below it satisfy the predicate
+KOKKOS_INLINE_FUNCTION constexpr bool
+containsBoundingVolume(void const *, void const *)
+{
+  return false;
+}
+
+template <typename Geometry, typename BoundingVolume>
+KOKKOS_INLINE_FUNCTION bool
+containsBoundingVolume(Intersects<Geometry> const *predicate,
+                       BoundingVolume const *bounding_volume)
+{
+  if constexpr (Kokkos::is_detected<ContainsArchetypeExpression, Geometry,
+                                    BoundingVolume>{})
+    return contains(getGeometry(*predicate), *bounding_volume);
+  else
+    return false;
+}
+
+// Metric in which the nearest and ordered traversals compare the distances
+// from the geometry of a predicate to the leaves and the internal nodes
+template <typename BVH, typename Predicate>
+using TraversalComparableDistance = ComparableDistance<
+    std::decay_t<decltype(getGeometry(std::declval<Predicate const &>()))>,
+    std::decay_t<decltype(HappyTreeFriends::getIndexable(
+        std::declval<BVH const &>(), 0))>,
+    std::decay_t<decltype(HappyTreeFriends::getInternalBoundingVolume(
+        std::declval<BVH const &>(), 0))>>;
+
+// Statistics of the traversals when none are requested, whose counters are
+// optimized away
+struct NoTraversalStatistics
+{
+  struct Counters
+  {
+    KOKKOS_FUNCTION void visitInternalNode(int) {}
+    KOKKOS_FUNCTION void testLeaf(int) {}
+    KOKKOS_FUNCTION void invokeCallback() {}
+    KOKKOS_FUNCTION void updateStackDepth(int) {}
+    KOKKOS_FUNCTION void exitEarly() {}
+  };
+
+  KOKKOS_FUNCTION Counters counters() const { return {}; }
+};
+
+// Statistics of the traversals recorded in the histograms of
+// Experimental::TraversalStatistics. The counters of a predicate are added to
+// them once its traversal is done. The visits of the nodes, if recorded, are
+// counted as they happen.
+template <typename MemorySpace>
+struct TraversalStatisticsRecorder
+{
+  using Statistics = Experimental::TraversalStatistics;
+
+  Kokkos::View<unsigned long long **, Kokkos::LayoutRight, MemorySpace>
+      _counts;
+  Kokkos::View<unsigned long long *, MemorySpace> _node_visits;
+
+  class Counters
+  {
+  public:
+    KOKKOS_FUNCTION explicit Counters(TraversalStatisticsRecorder const &r)
+        : _counts(r._counts)
+        , _node_visits(r._node_visits)
+    {}
+
+    Counters(Counters const &) = delete;
+    Counters &operator=(Counters const &) = delete;
+
+    KOKKOS_FUNCTION ~Counters()
+    {
+      for (int counter = 0; counter < Statistics::number_of_counters;
+           ++counter)
+      {
+        unsigned int const value = _values[counter];
+        int bin = 0;
+        for (unsigned int v = value; v > 0; v >>= 1)
+          ++bin;
+        Kokkos::atomic_increment(&_counts(counter, bin));
+        Kokkos::atomic_add(&_counts(counter, Statistics::number_of_bins),
+                           (unsigned long long)value);
+      }
+    }
+
+    KOKKOS_FUNCTION void visitInternalNode(int node)
+    {
+      ++_values[Statistics::internal_node_visits];
+      visitNode(node);
+    }
+    KOKKOS_FUNCTION void testLeaf(int node)
+    {
+      ++_values[Statistics::leaf_tests];
+      visitNode(node);
+    }
+    KOKKOS_FUNCTION void invokeCallback()
+    {
+      ++_values[Statistics::callback_invocations];
+    }
+    KOKKOS_FUNCTION void updateStackDepth(int depth)
+    {
+      auto &max_depth = _values[Statistics::max_stack_depth];
+      max_depth = KokkosExt::max(max_depth, depth);
+    }
+    KOKKOS_FUNCTION void exitEarly() { _values[Statistics::early_exits] = 1; }
+
+  private:
+    KOKKOS_FUNCTION void visitNode(int node)
+    {
+      if (_node_visits.size() > 0)
+        Kokkos::atomic_increment(&_node_visits(node));
+    }
+
+    Kokkos::View<unsigned long long **, Kokkos::LayoutRight, MemorySpace>
+        _counts;
+    Kokkos::View<unsigned long long *, MemorySpace> _node_visits;
+    int _values[Statistics::number_of_counters] = {};
+  };
+
+  KOKKOS_FUNCTION Counters counters() const { return Counters(*this); }
+};
+
+template <typename BVH, typename Predicates, typename Callback, typename Tag,
+          typename Statistics = NoTraversalStatistics>
 struct TreeTraversal
 {};
 
-template <typename BVH, typename Predicates, typename Callback>
-struct TreeTraversal<BVH, Predicates, Callback, SpatialPredicateTag>
+template <typename BVH, typename Predicates, typename Callback,
+          typename Statistics>
+struct TreeTraversal<BVH, Predicates, Callback, SpatialPredicateTag,
+                     Statistics>
 {
   BVH _bvh;
   Predicates _predicates;
   Callback _callback;
+  Statistics _statistics;
 
   using Access = AccessTraits<Predicates, PredicatesTag>;
 
   template <typename ExecutionSpace>
   TreeTraversal(ExecutionSpace const &space, BVH const &bvh,
-                Predicates const &predicates, Callback const &callback)
+                Predicates const &predicates, Callback const &callback,
+                Experimental::TraversalPolicy const &policy =
+                    Experimental::TraversalPolicy(),
+                Statistics const &statistics = Statistics())
       : _bvh{bvh}
       , _predicates{predicates}
       , _callback{callback}
+      , _statistics{statistics}
   {
     if (_bvh.empty())
     {
@@ -60,15 +225,29 @@ struct TreeTraversal<BVH, Predicates, Callback, SpatialPredicateTag>
               space, 0, Access::size(predicates)),
           *this);
     }
+    else if (policy._leaf_blocks &&
+             KokkosExt::is_accessible_from<Kokkos::HostSpace,
+                                           ExecutionSpace>::value)
+    {
+      launchTraversal<LeafBlocks>("ArborX::TreeTraversal::spatial::leaf_blocks",
+                                  space, Access::size(predicates), policy,
+                                  *this);
+    }
     else
     {
-      Kokkos::parallel_for("ArborX::TreeTraversal::spatial",
-                           Kokkos::RangePolicy<ExecutionSpace>(
-                               space, 0, Access::size(predicates)),
-                           *this);
+      launchTraversal("ArborX::TreeTraversal::spatial", space,
+                      Access::size(predicates), policy, *this);
     }
   }
 
+  // Traversal that is not launched, for another traversal to search with
+  TreeTraversal(BVH const &bvh, Callback const &callback,
+                Statistics const &statistics)
+      : _bvh{bvh}
+      , _callback{callback}
+      , _statistics{statistics}
+  {}
+
   struct OneLeafTree
   {};
 
@@ -87,44 +266,588 @@ struct TreeTraversal<BVH, Predicates, Callback, SpatialPredicateTag>
   KOKKOS_FUNCTION void operator()(int queryIndex) const
   {
     auto const &predicate = Access::get(_predicates, queryIndex);
+    scopedSearch(predicate, std::false_type{});
+  }
+
+  // Maximum number of consecutive leaves tested together
+  static constexpr int leaf_block_size = 8;
+
+  struct LeafBlocks
+  {};
+
+  KOKKOS_FUNCTION void operator()(LeafBlocks, int queryIndex) const
+  {
+    auto const &predicate = Access::get(_predicates, queryIndex);
+    scopedSearch(predicate, std::true_type{});
+  }
+
+  // Search with the callback scoped to the traversal of the predicate, if it
+  // holds some state for it, e.g. staged output
+  template <typename Predicate, typename BlockedLeaves>
+  KOKKOS_FUNCTION void scopedSearch(Predicate const &predicate,
+                                    BlockedLeaves) const
+  {
+    if constexpr (is_scoped_callback<Callback>{})
+    {
+      _callback.scope(predicate, [&](auto const &callback) {
+        TreeTraversal<BVH, Predicates, std::decay_t<decltype(callback)>,
+                      SpatialPredicateTag, Statistics>(_bvh, callback,
+                                                       _statistics)
+            .search(predicate, predicate, &predicate, BlockedLeaves{});
+      });
+    }
+    else
+    {
+      search(predicate, predicate, &predicate, BlockedLeaves{});
+    }
+  }
+
+  // The callback is passed callback_predicate, which is the predicate itself
+  // unless it is held by another one, e.g. a predicate variant
+  template <typename Predicate, typename CallbackPredicate,
+            typename BlockedLeaves = std::false_type>
+  KOKKOS_FUNCTION void search(Predicate const &predicate,
+                              CallbackPredicate const &callback_predicate,
+                              void const *, BlockedLeaves = {}) const
+  {
+    auto const &traversal_predicate = makeTraversalPredicate(predicate);
+    auto counters = _statistics.counters();
+    LeftAncestors ancestors; // only used with blocked leaves
 
     int node = HappyTreeFriends::getRoot(_bvh); // start with root
     do
     {
-      bool const is_leaf = HappyTreeFriends::isLeaf(_bvh, node);
-
-      if (is_leaf ? predicate(HappyTreeFriends::getIndexable(_bvh, node))
-                  : predicate(HappyTreeFriends::getInternalBoundingVolume(
-                        _bvh, node)))
+      if (HappyTreeFriends::isLeaf(_bvh, node))
       {
-        if (is_leaf)
+        if constexpr (BlockedLeaves::value)
+        {
+          if (testLeafBlock(node, ancestors, traversal_predicate,
+                            callback_predicate, counters))
+          {
+            counters.exitEarly();
+            return;
+          }
+          ancestors.clear();
+          continue;
+        }
+        counters.testLeaf(node);
+        if (traversal_predicate(HappyTreeFriends::getIndexable(_bvh, node)))
         {
+          counters.invokeCallback();
           if (invoke_callback_and_check_early_exit(
-                  _callback, predicate, HappyTreeFriends::getValue(_bvh, node)))
+                  _callback, callback_predicate,
+                  HappyTreeFriends::getValue(_bvh, node)))
+          {
+            counters.exitEarly();
             return;
+          }
+        }
+        node = HappyTreeFriends::getRope(_bvh, node);
+        continue;
+      }
+
+      counters.visitInternalNode(node);
+      auto const &bounding_volume =
+          HappyTreeFriends::getInternalBoundingVolume(_bvh, node);
+      if (traversal_predicate(bounding_volume))
+      {
+        if (containsBoundingVolume(&traversal_predicate, &bounding_volume))
+        {
+          if (reportSubtree(node, callback_predicate, counters))
+          {
+            counters.exitEarly();
+            return;
+          }
           node = HappyTreeFriends::getRope(_bvh, node);
+          if constexpr (BlockedLeaves::value)
+            ancestors.clear();
         }
         else
         {
+          if constexpr (BlockedLeaves::value)
+            ancestors.push(HappyTreeFriends::getRope(_bvh, node));
           node = HappyTreeFriends::getLeftChild(_bvh, node);
         }
       }
       else
       {
         node = HappyTreeFriends::getRope(_bvh, node);
+        if constexpr (BlockedLeaves::value)
+          ancestors.clear();
       }
     } while (node != ROPE_SENTINEL);
   }
+
+  // Ropes of the internal nodes the traversal went down to their left child
+  // from since it last followed a rope, i.e. of the ancestors of the current
+  // node that it is the first leaf of. Only the last ones are kept, those
+  // that may have few enough leaves to be tested as a block.
+  struct LeftAncestors
+  {
+    static constexpr int capacity = leaf_block_size - 1;
+    int _ropes[capacity];
+    int _size = 0;
+
+    KOKKOS_FUNCTION void push(int rope) { _ropes[_size++ % capacity] = rope; }
+    KOKKOS_FUNCTION void clear() { _size = 0; }
+    KOKKOS_FUNCTION bool contains(int rope) const
+    {
+      int const size = KokkosExt::min(_size, capacity);
+      for (int i = 0; i < size; ++i)
+        if (_ropes[i] == rope)
+          return true;
+      return false;
+    }
+  };
+
+  // Number of leaves tested together starting at a leaf. If the leaves below
+  // each internal node are consecutive, the block spans the largest ancestor
+  // that the leaf is the first of and that has at most leaf_block_size
+  // leaves, its last leaf being the one whose rope is that of the ancestor.
+  // The block is then extended by the leaves that follow it in memory as
+  // long as they are linked by their ropes, e.g. siblings.
+  KOKKOS_FUNCTION int leafBlockSize(int node,
+                                    LeftAncestors const &ancestors) const
+  {
+    int count = 1;
+    if (HappyTreeFriends::hasContiguousSubtrees(_bvh) && ancestors._size > 0)
+    {
+      int const last = KokkosExt::min(node + leaf_block_size, (int)_bvh.size());
+      for (int j = node + 1; j < last; ++j)
+        if (ancestors.contains(HappyTreeFriends::getRope(_bvh, j)))
+          count = j - node + 1;
+    }
+    while (count < leaf_block_size &&
+           HappyTreeFriends::getRope(_bvh, node + count - 1) == node + count)
+      ++count;
+    return count;
+  }
+
+  // Test the block of leaves starting at a leaf, see leafBlockSize(). The
+  // indexables of the block are all tested first, with no branch out of the
+  // loop, and the callback is then invoked on those satisfying the predicate.
+  // The node is advanced to the rope of the last leaf. Returns whether the
+  // callback asked for an early exit.
+  template <typename TraversalPredicate, typename CallbackPredicate,
+            typename Counters>
+  KOKKOS_FUNCTION bool
+  testLeafBlock(int &node, LeftAncestors const &ancestors,
+                TraversalPredicate const &traversal_predicate,
+                CallbackPredicate const &callback_predicate,
+                Counters &counters) const
+  {
+    int const count = leafBlockSize(node, ancestors);
+
+    bool satisfied[leaf_block_size];
+    for (int j = 0; j < count; ++j)
+      satisfied[j] =
+          traversal_predicate(HappyTreeFriends::getIndexable(_bvh, node + j));
+
+    for (int j = 0; j < count; ++j)
+    {
+      counters.testLeaf(node + j);
+      if (!satisfied[j])
+        continue;
+      counters.invokeCallback();
+      if (invoke_callback_and_check_early_exit(
+              _callback, callback_predicate,
+              HappyTreeFriends::getValue(_bvh, node + j)))
+        return true;
+    }
+    node = HappyTreeFriends::getRope(_bvh, node + count - 1);
+    return false;
+  }
+
+  // Invoke the callback on all the leaves below an internal node, which are
+  // known to satisfy the predicate. The subtree is walked through the left
+  // children and the ropes without testing any of its nodes, as its leaves
+  // need not be contiguous, e.g. in a hierarchy built by PLOC. The nodes still
+  // count as visited. Returns whether the callback asked for an early exit.
+  template <typename CallbackPredicate, typename Counters>
+  KOKKOS_FUNCTION bool
+  reportSubtree(int node, CallbackPredicate const &callback_predicate,
+                Counters &counters) const
+  {
+    int const end = HappyTreeFriends::getRope(_bvh, node);
+    node = HappyTreeFriends::getLeftChild(_bvh, node);
+    while (node != end)
+    {
+      if (!HappyTreeFriends::isLeaf(_bvh, node))
+      {
+        counters.visitInternalNode(node);
+        node = HappyTreeFriends::getLeftChild(_bvh, node);
+        continue;
+      }
+      counters.testLeaf(node);
+      counters.invokeCallback();
+      if (invoke_callback_and_check_early_exit(
+              _callback, callback_predicate,
+              HappyTreeFriends::getValue(_bvh, node)))
+        return true;
+      node = HappyTreeFriends::getRope(_bvh, node);
+    }
+    return false;
+  }
+
+  // Convex polytopes are only tested against the planes that do not already
+  // contain the parent of a node entirely. The nodes left to visit are kept on
+  // a stack together with their masks of planes, which the ropes cannot carry.
+  template <typename Predicate, typename CallbackPredicate, int N,
+            typename BlockedLeaves = std::false_type>
+  KOKKOS_FUNCTION void
+  search(Predicate const &predicate,
+         CallbackPredicate const &callback_predicate,
+         Intersects<Experimental::ConvexPolytope<N>> const *,
+         BlockedLeaves = {}) const
+  {
+    using Mask = typename Experimental::ConvexPolytope<N>::Mask;
+    auto const &polytope = getGeometry(predicate);
+
+    auto counters = _statistics.counters();
+
+    Stack<Kokkos::pair<int, Mask>> stack;
+    int node = HappyTreeFriends::getRoot(_bvh); // start with root
+    Mask mask = polytope.allPlanes();
+    while (true)
+    {
+      if (HappyTreeFriends::isLeaf(_bvh, node))
+      {
+        counters.testLeaf(node);
+        if (intersects(polytope, HappyTreeFriends::getIndexable(_bvh, node),
+                       mask))
+        {
+          counters.invokeCallback();
+          if (invoke_callback_and_check_early_exit(
+                  _callback, callback_predicate,
+                  HappyTreeFriends::getValue(_bvh, node)))
+          {
+            counters.exitEarly();
+            return;
+          }
+        }
+      }
+      else
+      {
+        counters.visitInternalNode(node);
+        if (intersects(polytope,
+                       HappyTreeFriends::getInternalBoundingVolume(_bvh, node),
+                       mask))
+        {
+          stack.push({HappyTreeFriends::getRightChild(_bvh, node), mask});
+          counters.updateStackDepth((int)stack.size());
+          node = HappyTreeFriends::getLeftChild(_bvh, node);
+          continue;
+        }
+      }
+
+      if (stack.empty())
+        return;
+      node = stack.top().first;
+      mask = stack.top().second;
+      stack.pop();
+    }
+  }
 };
 
+// Spatial traversal of packets of predicates by teams. Each vector lane of a
+// team handles one predicate of the packet, and the lanes vote at every
+// internal node whether to descend or to follow the rope.
 template <typename BVH, typename Predicates, typename Callback>
-struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
+struct TreePacketTraversal
+{
+  BVH _bvh;
+  Predicates _predicates;
+  Callback _callback;
+  int _packet_size;
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+
+  template <typename ExecutionSpace>
+  TreePacketTraversal(ExecutionSpace const &space, BVH const &bvh,
+                      Predicates const &predicates, Callback const &callback,
+                      int packet_size)
+      : _bvh{bvh}
+      , _predicates{predicates}
+      , _callback{callback}
+      , _packet_size{packet_size}
+  {
+    ARBORX_ASSERT(_bvh.size() > 1);
+    ARBORX_ASSERT(_packet_size > 0);
+
+    using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace>;
+    int const n_queries = Access::size(predicates);
+    int const n_packets = (n_queries + _packet_size - 1) / _packet_size;
+    // The vector length must be a power of two, the lanes looping over the
+    // predicates of larger packets
+    int const max_vector_length =
+        std::min(_packet_size, TeamPolicy::vector_length_max());
+    int vector_length = 1;
+    while (2 * vector_length <= max_vector_length)
+      vector_length *= 2;
+    Kokkos::parallel_for(
+        "ArborX::TreeTraversal::spatial::packets",
+        TeamPolicy(space, n_packets, 1, vector_length)
+            .set_scratch_size(0, Kokkos::PerTeam(ActiveLanes<ExecutionSpace>::
+                                                     shmem_size(_packet_size))),
+        *this);
+  }
+
+  template <typename ExecutionSpace>
+  using ActiveLanes =
+      Kokkos::View<bool *, typename ExecutionSpace::scratch_memory_space,
+                   Kokkos::MemoryUnmanaged>;
+
+  template <typename TeamMember>
+  KOKKOS_FUNCTION void operator()(TeamMember const &team) const
+  {
+    int const offset = team.league_rank() * _packet_size;
+    int const n = KokkosExt::min(_packet_size,
+                                 (int)Access::size(_predicates) - offset);
+
+    // Lanes whose predicate has exited early stop voting
+    ActiveLanes<typename TeamMember::execution_space> active(
+        team.team_scratch(0), _packet_size);
+    Kokkos::parallel_for(Kokkos::ThreadVectorRange(team, n),
+                         [&](int lane) { active(lane) = true; });
+
+    int node = HappyTreeFriends::getRoot(_bvh); // start with root
+    do
+    {
+      if (HappyTreeFriends::isLeaf(_bvh, node))
+      {
+        auto const &indexable = HappyTreeFriends::getIndexable(_bvh, node);
+        bool any_active = false;
+        Kokkos::parallel_reduce(
+            Kokkos::ThreadVectorRange(team, n),
+            [&](int lane, bool &update) {
+              if (!active(lane))
+                return;
+              auto const &predicate = Access::get(_predicates, offset + lane);
+              if (predicate(indexable) &&
+                  invoke_callback_and_check_early_exit(
+                      _callback, predicate,
+                      HappyTreeFriends::getValue(_bvh, node)))
+                active(lane) = false;
+              else
+                update = true;
+            },
+            Kokkos::LOr<bool>(any_active));
+        if (!any_active)
+          return;
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+      else
+      {
+        auto const &bounding_volume =
+            HappyTreeFriends::getInternalBoundingVolume(_bvh, node);
+        bool any_hit = false;
+        Kokkos::parallel_reduce(
+            Kokkos::ThreadVectorRange(team, n),
+            [&](int lane, bool &update) {
+              if (active(lane) &&
+                  Access::get(_predicates, offset + lane)(bounding_volume))
+                update = true;
+            },
+            Kokkos::LOr<bool>(any_hit));
+        node = (any_hit ? HappyTreeFriends::getLeftChild(_bvh, node)
+                        : HappyTreeFriends::getRope(_bvh, node));
+      }
+    } while (node != ROPE_SENTINEL);
+  }
+};
+
+// Spatial traversal by teams for team callbacks. Each team handles one
+// predicate. A single thread expands the top of the hierarchy into a frontier
+// of subtrees, which the threads of the team then traverse concurrently along
+// the ropes. The values found are staged in scratch memory and passed in
+// batches to the callback, which is invoked by the whole team as
+// callback(team, predicate, values). Threads interrupted by a full batch
+// resume from the leaf they stopped at once the callback has returned.
+template <typename BVH, typename Predicates, typename Callback>
+struct TreeTeamTraversal
+{
+  BVH _bvh;
+  Predicates _predicates;
+  Callback _callback;
+
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using Value = typename BVH::value_type;
+
+  // Maximum number of subtrees in the frontier
+  static constexpr int frontier_capacity = 64;
+  // Maximum number of values passed at once to the callback
+  static constexpr int batch_capacity = 128;
+
+  template <typename ExecutionSpace>
+  TreeTeamTraversal(ExecutionSpace const &space, BVH const &bvh,
+                    Predicates const &predicates, Callback const &callback)
+      : _bvh{bvh}
+      , _predicates{predicates}
+      , _callback{callback}
+  {
+    if (_bvh.empty())
+      return;
+
+    using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace>;
+    using ScratchSpace = typename ExecutionSpace::scratch_memory_space;
+    int const scratch_size =
+        2 * ScratchView<int *, ScratchSpace>::shmem_size(frontier_capacity) +
+        ScratchView<int, ScratchSpace>::shmem_size() +
+        ScratchView<Value *, ScratchSpace>::shmem_size(batch_capacity);
+    Kokkos::parallel_for(
+        "ArborX::TreeTraversal::spatial::teams",
+        TeamPolicy(space, Access::size(predicates), Kokkos::AUTO, Kokkos::AUTO)
+            .set_scratch_size(0, Kokkos::PerTeam(scratch_size)),
+        *this);
+  }
+
+  template <typename DataType, typename ScratchSpace>
+  using ScratchView =
+      Kokkos::View<DataType, ScratchSpace, Kokkos::MemoryUnmanaged>;
+
+  template <typename TeamMember>
+  KOKKOS_FUNCTION void operator()(TeamMember const &team) const
+  {
+    using ScratchSpace =
+        typename TeamMember::execution_space::scratch_memory_space;
+    auto const &predicate = Access::get(_predicates, team.league_rank());
+    auto const &traversal_predicate = makeTraversalPredicate(predicate);
+
+    ScratchView<int *, ScratchSpace> frontier(team.team_scratch(0),
+                                              frontier_capacity);
+    // Ropes of the roots of the subtrees, at which their traversal stops
+    ScratchView<int *, ScratchSpace> stops(team.team_scratch(0),
+                                           frontier_capacity);
+    ScratchView<int, ScratchSpace> count(team.team_scratch(0));
+    ScratchView<Value *, ScratchSpace> values(team.team_scratch(0),
+                                              batch_capacity);
+
+    if (_bvh.size() == 1)
+    {
+      Kokkos::single(Kokkos::PerTeam(team), [&]() {
+        count() = 0;
+        if (predicate(HappyTreeFriends::getIndexable(_bvh, 0)))
+          values(count()++) = HappyTreeFriends::getValue(_bvh, 0);
+      });
+      team.team_barrier();
+      if (count() > 0)
+        _callback(team, predicate,
+                  Kokkos::subview(values, Kokkos::make_pair(0, count())));
+      return;
+    }
+
+    // Breadth-first expansion into at least as many subtrees as there are
+    // threads, unless only leaves are left. The frontier is a circular queue
+    // whose first element and size are broadcast to the team.
+    Kokkos::pair<int, int> range;
+    Kokkos::single(
+        Kokkos::PerTeam(team),
+        [&](Kokkos::pair<int, int> &update) {
+          int const target =
+              KokkosExt::min((int)team.team_size(), frontier_capacity - 1);
+          int head = 0;
+          int size = 1;
+          frontier(0) = HappyTreeFriends::getRoot(_bvh);
+          int n_internal = 1;
+          while (size < target && n_internal > 0)
+          {
+            int const node = frontier(head);
+            head = (head + 1) % frontier_capacity;
+            --size;
+            if (HappyTreeFriends::isLeaf(_bvh, node))
+            {
+              frontier((head + size++) % frontier_capacity) = node;
+              continue;
+            }
+            --n_internal;
+            if (!traversal_predicate(
+                    HappyTreeFriends::getInternalBoundingVolume(_bvh, node)))
+              continue;
+            int const children[2] = {
+                HappyTreeFriends::getLeftChild(_bvh, node),
+                HappyTreeFriends::getRightChild(_bvh, node)};
+            for (int child : children)
+            {
+              frontier((head + size++) % frontier_capacity) = child;
+              if (!HappyTreeFriends::isLeaf(_bvh, child))
+                ++n_internal;
+            }
+          }
+          for (int i = 0; i < size; ++i)
+          {
+            int const slot = (head + i) % frontier_capacity;
+            stops(slot) = HappyTreeFriends::getRope(_bvh, frontier(slot));
+          }
+          count() = 0;
+          update = {head, size};
+        },
+        range);
+    team.team_barrier();
+
+    while (true)
+    {
+      Kokkos::parallel_for(
+          Kokkos::TeamThreadRange(team, range.second), [&](int i) {
+            Kokkos::single(Kokkos::PerThread(team), [&]() {
+              int const slot = (range.first + i) % frontier_capacity;
+              int node = frontier(slot);
+              int const stop = stops(slot);
+              while (node != stop)
+              {
+                if (HappyTreeFriends::isLeaf(_bvh, node))
+                {
+                  if (traversal_predicate(
+                          HappyTreeFriends::getIndexable(_bvh, node)))
+                  {
+                    int const k = Kokkos::atomic_fetch_add(&count(), 1);
+                    if (k >= batch_capacity)
+                      break;
+                    values(k) = HappyTreeFriends::getValue(_bvh, node);
+                  }
+                  node = HappyTreeFriends::getRope(_bvh, node);
+                }
+                else if (traversal_predicate(
+                             HappyTreeFriends::getInternalBoundingVolume(
+                                 _bvh, node)))
+                {
+                  node = HappyTreeFriends::getLeftChild(_bvh, node);
+                }
+                else
+                {
+                  node = HappyTreeFriends::getRope(_bvh, node);
+                }
+              }
+              frontier(slot) = node;
+            });
+          });
+      team.team_barrier();
+
+      int const n_found = count();
+      int const n_values = KokkosExt::min(n_found, batch_capacity);
+      if (n_values > 0)
+        _callback(team, predicate,
+                  Kokkos::subview(values, Kokkos::make_pair(0, n_values)));
+      // All the subtrees have been traversed unless the batch overflowed
+      if (n_found <= batch_capacity)
+        return;
+      team.team_barrier();
+      Kokkos::single(Kokkos::PerTeam(team), [&]() { count() = 0; });
+      team.team_barrier();
+    }
+  }
+};
+
+template <typename BVH, typename Predicates, typename Callback,
+          typename Statistics>
+struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag,
+                     Statistics>
 {
   using MemorySpace = typename BVH::memory_space;
 
   BVH _bvh;
   Predicates _predicates;
   Callback _callback;
+  Statistics _statistics;
 
   using Access = AccessTraits<Predicates, PredicatesTag>;
 
@@ -134,9 +857,16 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
   {
     Buffer _buffer;
     Offset _offset;
+    // Number of neighbors of all the predicates if it is known to be the
+    // same, in which case no offsets are needed
+    int _k = 0;
 
     KOKKOS_FUNCTION auto operator()(int i) const
     {
+      if (_k > 0)
+        return Kokkos::subview(
+            _buffer, Kokkos::make_pair((std::size_t)i * _k,
+                                       (std::size_t)(i + 1) * _k));
       auto const *offset_ptr = &_offset(i);
       return Kokkos::subview(_buffer,
                              Kokkos::make_pair(*offset_ptr, *(offset_ptr + 1)));
@@ -145,40 +875,96 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
 
   BufferProvider _buffer;
 
+  // Largest number of neighbors over all the predicates, only set when
+  // traversing in scratch memory
+  int _max_k = 0;
+
+  // Number of neighbors of all the predicates if it is known at compile time,
+  // in which case the heaps are local arrays and no buffer is allocated
+  static constexpr int fixed_k = fixed_number_of_neighbors_v<
+      std::decay_t<decltype(Access::get(std::declval<Predicates const &>(),
+                                        0))>>;
+
   template <typename ExecutionSpace>
-  void allocateBuffer(ExecutionSpace const &space)
+  void allocateBuffer(ExecutionSpace const &space,
+                      Experimental::TraversalPolicy const &policy)
   {
     auto const n_queries = Access::size(_predicates);
+    auto const &workspace = policy._nearest_workspace;
+    int const k = policy._number_of_neighbors;
 
-    Offset offset(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
-                                     "ArborX::TreeTraversal::nearest::offset"),
-                  n_queries + 1);
-    Kokkos::parallel_for(
-        "ArborX::TreeTraversal::nearest::"
-        "scan_queries_for_numbers_of_neighbors",
-        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
-        KOKKOS_CLASS_LAMBDA(int i) {
-          offset(i) = getK(Access::get(_predicates, i));
-        });
-    exclusivePrefixSum(space, offset);
-    int const buffer_size = KokkosExt::lastElement(space, offset);
+    std::size_t buffer_size = (std::size_t)n_queries * k;
+    Offset offset;
+    if (k <= 0)
+    {
+      if (workspace)
+        offset = Kokkos::subview(
+            workspace->template offset<MemorySpace>(space, n_queries + 1),
+            Kokkos::make_pair(0, (int)n_queries + 1));
+      else
+        offset = temporaryView<Offset>(space, policy._workspace,
+                                       "ArborX::TreeTraversal::nearest::offset",
+                                       n_queries + 1);
+      Kokkos::parallel_for(
+          "ArborX::TreeTraversal::nearest::"
+          "scan_queries_for_numbers_of_neighbors",
+          Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+          KOKKOS_CLASS_LAMBDA(int i) {
+            offset(i) = getK(Access::get(_predicates, i));
+          });
+      exclusivePrefixSum(space, offset);
+      buffer_size = KokkosExt::lastElement(space, offset);
+    }
     // Allocate buffer over which to perform heap operations in
     // TreeTraversal::nearestQuery() to store nearest leaf nodes found so far.
     // It is not possible to anticipate how much memory to allocate since the
     // number of nearest neighbors k is only known at runtime.
 
-    Buffer buffer(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
-                                     "ArborX::TreeTraversal::nearest::buffer"),
-                  buffer_size);
-    _buffer = BufferProvider{buffer, offset};
+    Buffer buffer =
+        workspace ? workspace->template buffer<MemorySpace>(space, buffer_size)
+                  : temporaryView<Buffer>(
+                        space, policy._workspace,
+                        "ArborX::TreeTraversal::nearest::buffer", buffer_size);
+    _buffer = BufferProvider{buffer, offset, k};
+  }
+
+  // Depth of the stack of nodes left to visit
+  static constexpr int stack_size = 64;
+
+  template <typename ExecutionSpace>
+  using ScratchBuffer =
+      Kokkos::View<Kokkos::pair<int, float> *,
+                   typename ExecutionSpace::scratch_memory_space,
+                   Kokkos::MemoryUnmanaged>;
+  template <typename ExecutionSpace>
+  using ScratchStack =
+      Kokkos::View<int *, typename ExecutionSpace::scratch_memory_space,
+                   Kokkos::MemoryUnmanaged>;
+  template <typename ExecutionSpace>
+  using ScratchStackDistance =
+      Kokkos::View<float *, typename ExecutionSpace::scratch_memory_space,
+                   Kokkos::MemoryUnmanaged>;
+
+  // Scratch memory needed by every thread to store its heap of size k, and
+  // its stack
+  template <typename ExecutionSpace>
+  static std::size_t scratchSize(int k)
+  {
+    return ScratchBuffer<ExecutionSpace>::shmem_size(k) +
+           ScratchStack<ExecutionSpace>::shmem_size(stack_size) +
+           ScratchStackDistance<ExecutionSpace>::shmem_size(stack_size);
   }
 
   template <typename ExecutionSpace>
   TreeTraversal(ExecutionSpace const &space, BVH const &bvh,
-                Predicates const &predicates, Callback const &callback)
+                Predicates const &predicates, Callback const &callback,
+                Experimental::TraversalPolicy const &policy =
+                    Experimental::TraversalPolicy(),
+                Statistics const &statistics = Statistics())
       : _bvh{bvh}
       , _predicates{predicates}
       , _callback{callback}
+      , _statistics{statistics}
   {
     if (_bvh.empty())
     {
@@ -192,17 +978,84 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
               space, 0, Access::size(predicates)),
           *this);
     }
-    else
+    else if (fixed_k > 0)
     {
-      allocateBuffer(space);
+      if (policy._nearest_stackless)
+        launchTraversal<Stackless>(
+            "ArborX::TreeTraversal::nearest::fixed_k_stackless", space,
+            Access::size(predicates), policy, *this);
+      else
+        launchTraversal("ArborX::TreeTraversal::nearest::fixed_k", space,
+                        Access::size(predicates), policy, *this);
+    }
+    else if (policy._nearest_stackless)
+    {
+      allocateBuffer(space, policy);
 
-      Kokkos::parallel_for("ArborX::TreeTraversal::nearest",
-                           Kokkos::RangePolicy<ExecutionSpace>(
-                               space, 0, Access::size(predicates)),
-                           *this);
+      launchTraversal<Stackless>("ArborX::TreeTraversal::nearest::stackless",
+                                 space, Access::size(predicates), policy,
+                                 *this);
     }
+    else if (!policy._nearest_scratch_memory ||
+             !launchInScratchMemory(space, policy._number_of_neighbors))
+    {
+      allocateBuffer(space, policy);
+
+      launchTraversal("ArborX::TreeTraversal::nearest", space,
+                      Access::size(predicates), policy, *this);
+    }
+  }
+
+  // Keep the heap and the stack of each query in the scratch memory of the
+  // team. The number of neighbors k is the same for all the predicates if
+  // positive. Return false without launching anything if the largest k makes
+  // them too large to fit, so that the caller falls back to the global
+  // buffer.
+  template <typename ExecutionSpace>
+  bool launchInScratchMemory(ExecutionSpace const &space, int k)
+  {
+    auto const n_queries = Access::size(_predicates);
+
+    _max_k = k;
+    if (k <= 0)
+      Kokkos::parallel_reduce(
+          "ArborX::TreeTraversal::nearest::find_max_number_of_neighbors",
+          Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+          KOKKOS_CLASS_LAMBDA(int i, int &update) {
+            int const k = getK(Access::get(_predicates, i));
+            update = KokkosExt::max(update, k);
+          },
+          Kokkos::Max<int>(_max_k));
+
+    using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace, ScratchMemory>;
+    auto const scratch_size = scratchSize<ExecutionSpace>(_max_k);
+    int const team_size_recommended =
+        TeamPolicy(space, 1, Kokkos::AUTO)
+            .set_scratch_size(0, Kokkos::PerThread(scratch_size))
+            .team_size_recommended(*this, Kokkos::ParallelForTag{});
+    int const team_size = std::min<std::size_t>(
+        team_size_recommended, TeamPolicy::scratch_size_max(0) / scratch_size);
+    // Teams that are too small would leave most of the hardware idle
+    if (team_size < std::min(32, team_size_recommended))
+      return false;
+
+    int const n_teams = (n_queries + team_size - 1) / team_size;
+    Kokkos::parallel_for(
+        "ArborX::TreeTraversal::nearest::scratch_memory",
+        TeamPolicy(space, n_teams, team_size)
+            .set_scratch_size(0, Kokkos::PerThread(scratch_size)),
+        *this);
+    return true;
   }
 
+  // Traversal that is not launched, for another traversal to search with
+  TreeTraversal(BVH const &bvh, Callback const &callback,
+                Statistics const &statistics)
+      : _bvh{bvh}
+      , _callback{callback}
+      , _statistics{statistics}
+  {}
+
   struct OneLeafTree
   {};
 
@@ -215,30 +1068,124 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
     if (k < 1)
       return;
 
+    auto const &root_indexable = HappyTreeFriends::getIndexable(_bvh, 0);
+    if (!(predicate.distance(root_indexable) <= getMaxDistance(predicate)))
+      return;
+
     _callback(predicate, HappyTreeFriends::getValue(_bvh, 0));
   }
 
+  struct ScratchMemory
+  {};
+
+  template <typename TeamMember>
+  KOKKOS_FUNCTION void operator()(ScratchMemory, TeamMember const &team) const
+  {
+    using ExecutionSpace = typename TeamMember::execution_space;
+
+    ScratchBuffer<ExecutionSpace> buffer(team.thread_scratch(0), _max_k);
+    ScratchStack<ExecutionSpace> stack(team.thread_scratch(0), stack_size);
+    ScratchStackDistance<ExecutionSpace> stack_distance(team.thread_scratch(0),
+                                                        stack_size);
+
+    int const queryIndex =
+        team.league_rank() * team.team_size() + team.team_rank();
+    if (queryIndex >= (int)Access::size(_predicates))
+      return;
+
+    nearestQuery(Access::get(_predicates, queryIndex), buffer.data(),
+                 buffer.size(), stack.data(), stack_distance.data());
+  }
+
   KOKKOS_FUNCTION void operator()(int queryIndex) const
   {
-    auto const &predicate = Access::get(_predicates, queryIndex);
+    int stack[stack_size];
+#if defined(__CUDA_ARCH__)
+    float *stack_distance = nullptr;
+#else
+    float stack_distance[stack_size];
+#endif
+    if constexpr (fixed_k > 0)
+    {
+      Kokkos::pair<int, float> buffer[fixed_k];
+      nearestQuery(Access::get(_predicates, queryIndex), buffer, fixed_k,
+                   stack, stack_distance);
+    }
+    else
+    {
+      auto const buffer = _buffer(queryIndex);
+      nearestQuery(Access::get(_predicates, queryIndex), buffer.data(),
+                   buffer.size(), stack, stack_distance);
+    }
+  }
+
+  struct Stackless
+  {};
+
+  KOKKOS_FUNCTION void operator()(Stackless, int queryIndex) const
+  {
+    if constexpr (fixed_k > 0)
+    {
+      Kokkos::pair<int, float> buffer[fixed_k];
+      nearestQueryStackless(Access::get(_predicates, queryIndex), buffer,
+                            fixed_k);
+    }
+    else
+    {
+      auto const buffer = _buffer(queryIndex);
+      nearestQueryStackless(Access::get(_predicates, queryIndex),
+                            buffer.data(), buffer.size());
+    }
+  }
+
+  // Search the k nearest leaves of the predicate using a heap of size k
+  // stored in buffer. In device code, the stack_distance stack is not used.
+  template <typename Predicate>
+  KOKKOS_FUNCTION void nearestQuery(Predicate const &predicate,
+                                    Kokkos::pair<int, float> *buffer,
+                                    int buffer_size, int *stack,
+                                    float *stack_distance) const
+  {
+    nearestQuery(predicate, predicate, buffer, buffer_size, stack,
+                 stack_distance);
+  }
+
+  // The callback is passed callback_predicate, which is the predicate itself
+  // unless it is held by another one, e.g. a predicate variant
+  template <typename Predicate, typename CallbackPredicate>
+  KOKKOS_FUNCTION void nearestQuery(Predicate const &predicate,
+                                    CallbackPredicate const &callback_predicate,
+                                    Kokkos::pair<int, float> *buffer,
+                                    int buffer_size, int *stack,
+                                    float *stack_distance) const
+  {
     auto const k = getK(predicate);
-    auto const buffer = _buffer(queryIndex);
 
     // NOTE thinking about making this a precondition
     if (k < 1)
       return;
 
+    assert(k <= buffer_size);
+    (void)buffer_size;
+
     // Nodes with a distance that exceed that radius can safely be
-    // discarded. Initialize the radius to infinity and tighten it once k
-    // neighbors have been found.
-    auto radius = KokkosExt::ArithmeticTraits::infinity<float>::value;
+    // discarded. Initialize the radius to the largest distance allowed
+    // (infinity unless bounded) and tighten it once k neighbors have been
+    // found. The neighbors at exactly that distance are kept, as for the
+    // spatial searches within a sphere. For approximate searches, the radius
+    // is shrunk by a factor (1 + epsilon) to prune more aggressively. All of
+    // them are comparable distances, e.g. squared distances between points
+    // and boxes, since the distances themselves are never reported.
+    using Comparable = TraversalComparableDistance<BVH, Predicate>;
+    float radius = Kokkos::nextafter(
+        Comparable::fromDistance(getMaxDistance(predicate)),
+        KokkosExt::ArithmeticTraits::infinity<float>::value);
+    float const shrink_factor =
+        Comparable::fromDistance(1 / (1 + getEpsilon(predicate)));
+    int const max_visited_nodes = getMaxVisitedNodes(predicate);
+    int visited_nodes = 0;
 
     using PairIndexDistance = Kokkos::pair<int, float>;
-    static_assert(
-        std::is_same<typename decltype(buffer)::value_type,
-                     PairIndexDistance>::value,
-        "Type of the elements stored in the buffer passed as argument to "
-        "TreeTraversal::nearestQuery is not right");
     struct CompareDistance
     {
       KOKKOS_INLINE_FUNCTION bool operator()(PairIndexDistance const &lhs,
@@ -251,26 +1198,27 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
     // preserve the heap structure internally at all time.  There is no
     // memory allocation, elements are stored in the buffer passed as an
     // argument. The farthest leaf node is on top.
-    assert(k == (int)buffer.size());
     PriorityQueue<PairIndexDistance, CompareDistance,
                   UnmanagedStaticVector<PairIndexDistance>>
-        heap(UnmanagedStaticVector<PairIndexDistance>(buffer.data(),
-                                                      buffer.size()));
+        heap(UnmanagedStaticVector<PairIndexDistance>(buffer, k));
 
     auto &bvh = _bvh;
-    auto const distance = [&predicate, &bvh](int j) {
+    auto const &geometry = getGeometry(predicate);
+    auto const distance = [&geometry, &bvh](int j) -> float {
       return HappyTreeFriends::isLeaf(bvh, j)
-                 ? predicate.distance(HappyTreeFriends::getIndexable(bvh, j))
-                 : predicate.distance(
+                 ? Comparable::apply(geometry,
+                                     HappyTreeFriends::getIndexable(bvh, j))
+                 : Comparable::apply(
+                       geometry,
                        HappyTreeFriends::getInternalBoundingVolume(bvh, j));
     };
 
     constexpr int SENTINEL = -1;
-    int stack[64];
     auto *stack_ptr = stack;
     *stack_ptr++ = SENTINEL;
-#if !defined(__CUDA_ARCH__)
-    float stack_distance[64];
+#if defined(__CUDA_ARCH__)
+    (void)stack_distance;
+#else
     auto *stack_distance_ptr = stack_distance;
     *stack_distance_ptr++ = 0.f;
 #endif
@@ -283,6 +1231,8 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
     float distance_right = 0.f;
     float distance_node = 0.f;
 
+    auto counters = _statistics.counters();
+
     do
     {
       bool traverse_left = false;
@@ -290,6 +1240,13 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
 
       if (distance_node < radius)
       {
+        if (max_visited_nodes > 0 && ++visited_nodes > max_visited_nodes)
+        {
+          counters.exitEarly();
+          break;
+        }
+        counters.visitInternalNode(node);
+
         // Insert children into the stack and make sure that the
         // closest one ends on top.
         left_child = HappyTreeFriends::getLeftChild(_bvh, node);
@@ -297,6 +1254,10 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
 
         distance_left = distance(left_child);
         distance_right = distance(right_child);
+        if (HappyTreeFriends::isLeaf(_bvh, left_child))
+          counters.testLeaf(left_child);
+        if (HappyTreeFriends::isLeaf(_bvh, right_child))
+          counters.testLeaf(right_child);
 
         if (distance_left < radius)
         {
@@ -308,7 +1269,7 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
             else
               heap.popPush(leaf_pair);
             if ((int)heap.size() == k)
-              radius = heap.top().second;
+              radius = heap.top().second * shrink_factor;
           }
           else
           {
@@ -327,7 +1288,7 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
             else
               heap.popPush(leaf_pair);
             if ((int)heap.size() == k)
-              radius = heap.top().second;
+              radius = heap.top().second * shrink_factor;
           }
           else
           {
@@ -361,6 +1322,8 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
         if (traverse_left && traverse_right)
         {
           *stack_ptr++ = (node == left_child ? right_child : left_child);
+          // Not counting the sentinel at the bottom of the stack
+          counters.updateStackDepth(stack_ptr - stack - 1);
 #if !defined(__CUDA_ARCH__)
           *stack_distance_ptr++ =
               (node == left_child ? distance_right : distance_left);
@@ -375,12 +1338,220 @@ struct TreeTraversal<BVH, Predicates, Callback, NearestPredicateTag>
     sortHeap(heap.data(), heap.data() + heap.size(), heap.valueComp());
     for (decltype(heap.size()) i = 0; i < heap.size(); ++i)
     {
+      counters.invokeCallback();
+      _callback(callback_predicate,
+                HappyTreeFriends::getValue(_bvh, (heap.data() + i)->first));
+    }
+  }
+
+  // Same as nearestQuery(), along the ropes and without a stack. The heap is
+  // filled first with the k leaves around the one reached by descending into
+  // the closest children, so that the radius is bounded from the start.
+  template <typename Predicate>
+  KOKKOS_FUNCTION void nearestQueryStackless(Predicate const &predicate,
+                                             Kokkos::pair<int, float> *buffer,
+                                             int buffer_size) const
+  {
+    auto const k = getK(predicate);
+
+    // NOTE thinking about making this a precondition
+    if (k < 1)
+      return;
+
+    assert(k <= buffer_size);
+    (void)buffer_size;
+
+    using Comparable = TraversalComparableDistance<BVH, Predicate>;
+    float radius = Kokkos::nextafter(
+        Comparable::fromDistance(getMaxDistance(predicate)),
+        KokkosExt::ArithmeticTraits::infinity<float>::value);
+    float const shrink_factor =
+        Comparable::fromDistance(1 / (1 + getEpsilon(predicate)));
+    int const max_visited_nodes = getMaxVisitedNodes(predicate);
+    int visited_nodes = 0;
+
+    using PairIndexDistance = Kokkos::pair<int, float>;
+    struct CompareDistance
+    {
+      KOKKOS_INLINE_FUNCTION bool operator()(PairIndexDistance const &lhs,
+                                             PairIndexDistance const &rhs) const
+      {
+        return lhs.second < rhs.second;
+      }
+    };
+    PriorityQueue<PairIndexDistance, CompareDistance,
+                  UnmanagedStaticVector<PairIndexDistance>>
+        heap(UnmanagedStaticVector<PairIndexDistance>(buffer, k));
+
+    auto &bvh = _bvh;
+    auto const &geometry = getGeometry(predicate);
+    auto const distance = [&geometry, &bvh](int j) -> float {
+      return HappyTreeFriends::isLeaf(bvh, j)
+                 ? Comparable::apply(geometry,
+                                     HappyTreeFriends::getIndexable(bvh, j))
+                 : Comparable::apply(
+                       geometry,
+                       HappyTreeFriends::getInternalBoundingVolume(bvh, j));
+    };
+
+    auto counters = _statistics.counters();
+
+    auto const test_leaf = [&](int leaf) {
+      counters.testLeaf(leaf);
+      float const distance_leaf = distance(leaf);
+      if (!(distance_leaf < radius))
+        return;
+      auto leaf_pair = Kokkos::make_pair(leaf, distance_leaf);
+      if ((int)heap.size() < k)
+        heap.push(leaf_pair);
+      else
+        heap.popPush(leaf_pair);
+      if ((int)heap.size() == k)
+        radius = heap.top().second * shrink_factor;
+    };
+
+    // The leaves are numbered in their order along the space-filling curve,
+    // so that those next to the closest leaf are likely close too
+    int node = HappyTreeFriends::getRoot(_bvh);
+    while (!HappyTreeFriends::isLeaf(_bvh, node))
+    {
+      ++visited_nodes;
+      counters.visitInternalNode(node);
+      int const left_child = HappyTreeFriends::getLeftChild(_bvh, node);
+      int const right_child = HappyTreeFriends::getRightChild(_bvh, node);
+      node = (distance(left_child) <= distance(right_child) ? left_child
+                                                            : right_child);
+    }
+    int const n = _bvh.size();
+    int const num_seeds = KokkosExt::min(k, n);
+    int const seeds_begin =
+        KokkosExt::min(KokkosExt::max(node - num_seeds / 2, 0), n - num_seeds);
+    int const seeds_end = seeds_begin + num_seeds;
+    for (int leaf = seeds_begin; leaf < seeds_end; ++leaf)
+      test_leaf(leaf);
+
+    node = HappyTreeFriends::getRoot(_bvh);
+    do
+    {
+      if (HappyTreeFriends::isLeaf(_bvh, node))
+      {
+        if (node < seeds_begin || node >= seeds_end)
+          test_leaf(node);
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+      else if (distance(node) < radius)
+      {
+        if (max_visited_nodes > 0 && ++visited_nodes > max_visited_nodes)
+        {
+          counters.exitEarly();
+          break;
+        }
+        counters.visitInternalNode(node);
+        node = HappyTreeFriends::getLeftChild(_bvh, node);
+      }
+      else
+      {
+        node = HappyTreeFriends::getRope(_bvh, node);
+      }
+    } while (node != ROPE_SENTINEL);
+
+    sortHeap(heap.data(), heap.data() + heap.size(), heap.valueComp());
+    for (decltype(heap.size()) i = 0; i < heap.size(); ++i)
+    {
+      counters.invokeCallback();
       _callback(predicate,
                 HappyTreeFriends::getValue(_bvh, (heap.data() + i)->first));
     }
   }
 };
 
+// Traversal of predicate variants in a single launch. Each predicate goes
+// through the spatial or the nearest traversal of the alternative it holds,
+// the heaps of the nearest ones being local arrays since their number of
+// neighbors is known at compile time.
+template <typename BVH, typename Predicates, typename Callback,
+          typename Statistics>
+struct TreeTraversal<BVH, Predicates, Callback,
+                     Experimental::VariantPredicateTag, Statistics>
+{
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+
+  using SpatialTraversal = TreeTraversal<BVH, Predicates, Callback,
+                                         SpatialPredicateTag, Statistics>;
+  using NearestTraversal = TreeTraversal<BVH, Predicates, Callback,
+                                         NearestPredicateTag, Statistics>;
+
+  BVH _bvh;
+  Predicates _predicates;
+  Callback _callback;
+  SpatialTraversal _spatial;
+  NearestTraversal _nearest;
+
+  template <typename ExecutionSpace>
+  TreeTraversal(ExecutionSpace const &space, BVH const &bvh,
+                Predicates const &predicates, Callback const &callback,
+                Experimental::TraversalPolicy const &policy =
+                    Experimental::TraversalPolicy(),
+                Statistics const &statistics = Statistics())
+      : _bvh{bvh}
+      , _predicates{predicates}
+      , _callback{callback}
+      , _spatial{bvh, callback, statistics}
+      , _nearest{bvh, callback, statistics}
+  {
+    if (_bvh.empty())
+    {
+      // do nothing
+    }
+    else
+    {
+      launchTraversal("ArborX::TreeTraversal::variant", space,
+                      Access::size(predicates), policy, *this);
+    }
+  }
+
+  KOKKOS_FUNCTION void operator()(int queryIndex) const
+  {
+    auto const &predicate = Access::get(_predicates, queryIndex);
+    predicate.visit([&](auto const &alternative) {
+      using Alternative = std::decay_t<decltype(alternative)>;
+      constexpr int k = fixed_number_of_neighbors_v<Alternative>;
+
+      if (_bvh.size() == 1)
+      {
+        auto const &indexable = HappyTreeFriends::getIndexable(_bvh, 0);
+        bool hit;
+        if constexpr (k > 0)
+          hit = (alternative.distance(indexable) <=
+                 getMaxDistance(alternative));
+        else
+          hit = alternative(indexable);
+        if (hit)
+          _callback(predicate, HappyTreeFriends::getValue(_bvh, 0));
+        return;
+      }
+
+      if constexpr (k > 0)
+      {
+        constexpr int stack_size = NearestTraversal::stack_size;
+        Kokkos::pair<int, float> buffer[k];
+        int stack[stack_size];
+#if defined(__CUDA_ARCH__)
+        float *stack_distance = nullptr;
+#else
+        float stack_distance[stack_size];
+#endif
+        _nearest.nearestQuery(alternative, predicate, buffer, k, stack,
+                              stack_distance);
+      }
+      else
+      {
+        _spatial.search(alternative, predicate, &alternative);
+      }
+    });
+  }
+};
+
 template <class BVH, class Predicates, class Callback>
 struct TreeTraversal<BVH, Predicates, Callback,
                      Experimental::OrderedSpatialPredicateTag>
@@ -393,7 +1564,9 @@ struct TreeTraversal<BVH, Predicates, Callback,
 
   template <class ExecutionSpace>
   TreeTraversal(ExecutionSpace const &space, BVH const &bvh,
-                Predicates const &predicates, Callback const &callback)
+                Predicates const &predicates, Callback const &callback,
+                Experimental::TraversalPolicy const &policy =
+                    Experimental::TraversalPolicy())
       : _bvh{bvh}
       , _predicates{predicates}
       , _callback{callback}
@@ -413,11 +1586,9 @@ struct TreeTraversal<BVH, Predicates, Callback,
     }
     else
     {
-      Kokkos::parallel_for(
+      launchTraversal(
           "ArborX::Experimental::TreeTraversal::OrderedSpatialPredicate",
-          Kokkos::RangePolicy<ExecutionSpace>(space, 0,
-                                              Access::size(predicates)),
-          *this);
+          space, Access::size(predicates), policy, *this);
     }
   }
 
@@ -434,7 +1605,8 @@ struct TreeTraversal<BVH, Predicates, Callback,
         decltype(distance(getGeometry(predicate), root_bounding_volume));
     constexpr auto inf =
         KokkosExt::ArithmeticTraits::infinity<distance_type>::value;
-    if (distance(getGeometry(predicate), root_bounding_volume) != inf)
+    if (getK(predicate) > 0 &&
+        distance(getGeometry(predicate), root_bounding_volume) != inf)
     {
       _callback(predicate, HappyTreeFriends::getValue(_bvh, 0));
     }
@@ -443,10 +1615,24 @@ struct TreeTraversal<BVH, Predicates, Callback,
   KOKKOS_FUNCTION void operator()(int queryIndex) const
   {
     auto const &predicate = Access::get(_predicates, queryIndex);
+    auto const &traversal_predicate = makeTraversalPredicate(predicate);
+    using TraversalPredicate = std::decay_t<decltype(traversal_predicate)>;
     using ArborX::Details::HappyTreeFriends;
 
-    using distance_type = decltype(predicate.distance(
-        HappyTreeFriends::getInternalBoundingVolume(_bvh, 0)));
+    int const k = getK(predicate);
+    if (k <= 0)
+      return;
+    if (k == 1)
+    {
+      closestHit(predicate, traversal_predicate);
+      return;
+    }
+
+    // Only the order of the distances matters
+    using Comparable = TraversalComparableDistance<BVH, TraversalPredicate>;
+    auto const &geometry = getGeometry(traversal_predicate);
+    using distance_type = decltype(Comparable::apply(
+        geometry, HappyTreeFriends::getInternalBoundingVolume(_bvh, 0)));
     using PairIndexDistance = Kokkos::pair<int, distance_type>;
     struct CompareDistance
     {
@@ -467,13 +1653,17 @@ struct TreeTraversal<BVH, Predicates, Callback,
         KokkosExt::ArithmeticTraits::infinity<distance_type>::value;
 
     auto &bvh = _bvh;
-    auto const distance = [&predicate, &bvh](int j) {
+    auto const distance = [&geometry, &bvh](int j) -> distance_type {
       return HappyTreeFriends::isLeaf(bvh, j)
-                 ? predicate.distance(HappyTreeFriends::getIndexable(bvh, j))
-                 : predicate.distance(
+                 ? Comparable::apply(geometry,
+                                     HappyTreeFriends::getIndexable(bvh, j))
+                 : Comparable::apply(
+                       geometry,
                        HappyTreeFriends::getInternalBoundingVolume(bvh, j));
     };
 
+    int count = 0;
+
     int node = HappyTreeFriends::getRoot(_bvh);
     int left_child;
     int right_child;
@@ -483,7 +1673,8 @@ struct TreeTraversal<BVH, Predicates, Callback,
       if (HappyTreeFriends::isLeaf(_bvh, node))
       {
         if (invoke_callback_and_check_early_exit(
-                _callback, predicate, HappyTreeFriends::getValue(_bvh, node)))
+                _callback, predicate, HappyTreeFriends::getValue(_bvh, node)) ||
+            ++count == k)
           return;
 
         if (heap.empty())
@@ -522,17 +1713,152 @@ struct TreeTraversal<BVH, Predicates, Callback,
       }
     }
   }
+
+  // Closest hit, e.g. for shadow or visibility rays. The nodes are visited
+  // depth first, the nearer child first, and those entered beyond the closest
+  // leaf found so far are pruned, so that neither the results nor the nodes
+  // need a heap.
+  template <typename Predicate, typename TraversalPredicate>
+  KOKKOS_FUNCTION void
+  closestHit(Predicate const &predicate,
+             TraversalPredicate const &traversal_predicate) const
+  {
+    // Only the order of the distances matters
+    using Comparable = TraversalComparableDistance<BVH, TraversalPredicate>;
+    auto const &geometry = getGeometry(traversal_predicate);
+    using distance_type = decltype(Comparable::apply(
+        geometry, HappyTreeFriends::getInternalBoundingVolume(_bvh, 0)));
+
+    auto &bvh = _bvh;
+    auto const distance = [&geometry, &bvh](int j) -> distance_type {
+      return HappyTreeFriends::isLeaf(bvh, j)
+                 ? Comparable::apply(geometry,
+                                     HappyTreeFriends::getIndexable(bvh, j))
+                 : Comparable::apply(
+                       geometry,
+                       HappyTreeFriends::getInternalBoundingVolume(bvh, j));
+    };
+
+    constexpr int stack_size = 64;
+    int stack[stack_size];
+    distance_type stack_distance[stack_size];
+    int stack_top = 0;
+
+    auto radius = KokkosExt::ArithmeticTraits::infinity<distance_type>::value;
+    int closest = -1;
+
+    int node = HappyTreeFriends::getRoot(_bvh);
+    distance_type distance_node = 0;
+    while (true)
+    {
+      // The radius may have shrunk since the node was pushed
+      if (distance_node < radius)
+      {
+        if (HappyTreeFriends::isLeaf(_bvh, node))
+        {
+          radius = distance_node;
+          closest = node;
+        }
+        else
+        {
+          int const left_child = HappyTreeFriends::getLeftChild(_bvh, node);
+          int const right_child = HappyTreeFriends::getRightChild(_bvh, node);
+          auto const distance_left = distance(left_child);
+          auto const distance_right = distance(right_child);
+
+          bool const left_is_closer = (distance_left < distance_right);
+          int const closer = (left_is_closer ? left_child : right_child);
+          int const further = (left_is_closer ? right_child : left_child);
+          auto const distance_closer =
+              (left_is_closer ? distance_left : distance_right);
+          auto const distance_further =
+              (left_is_closer ? distance_right : distance_left);
+
+          if (distance_further < radius)
+          {
+            assert(stack_top < stack_size);
+            stack[stack_top] = further;
+            stack_distance[stack_top] = distance_further;
+            ++stack_top;
+          }
+          if (distance_closer < radius)
+          {
+            node = closer;
+            distance_node = distance_closer;
+            continue;
+          }
+        }
+      }
+      if (stack_top == 0)
+        break;
+      --stack_top;
+      node = stack[stack_top];
+      distance_node = stack_distance[stack_top];
+    }
+
+    if (closest != -1)
+      invoke_callback_and_check_early_exit(
+          _callback, predicate, HappyTreeFriends::getValue(_bvh, closest));
+  }
 };
 
 template <typename ExecutionSpace, typename BVH, typename Predicates,
           typename Callback>
 void traverse(ExecutionSpace const &space, BVH const &bvh,
-              Predicates const &predicates, Callback const &callback)
+              Predicates const &predicates, Callback const &callback,
+              Experimental::TraversalPolicy const &policy =
+                  Experimental::TraversalPolicy())
 {
   using Access = AccessTraits<Predicates, PredicatesTag>;
   using Tag = typename AccessTraitsHelper<Access>::tag;
-  TreeTraversal<BVH, Predicates, Callback, Tag>(space, bvh, predicates,
-                                                callback);
+  if constexpr (is_tagged_team_callback<Callback>{})
+  {
+    static_assert(std::is_same_v<Tag, SpatialPredicateTag>,
+                  "Team callbacks are only supported for spatial predicates");
+    TreeTeamTraversal<BVH, Predicates, Callback>(space, bvh, predicates,
+                                                 callback);
+  }
+  else
+  {
+    using MemorySpace = typename BVH::memory_space;
+    using Recorder = TraversalStatisticsRecorder<MemorySpace>;
+    auto make_recorder = [&]() {
+      auto const &statistics = *policy._statistics;
+      int const num_nodes = bvh.size() > 0 ? 2 * (int)bvh.size() - 1 : 0;
+      return Recorder{
+          statistics.template counts<MemorySpace>(space),
+          statistics.template nodeVisits<MemorySpace>(space, num_nodes)};
+    };
+    if constexpr (std::is_same_v<Tag, SpatialPredicateTag>)
+    {
+      if (policy._statistics)
+      {
+        TreeTraversal<BVH, Predicates, Callback, Tag, Recorder>(
+            space, bvh, predicates, callback, policy, make_recorder());
+        return;
+      }
+      if (policy._packet_size > 0 && bvh.size() > 1)
+      {
+        TreePacketTraversal<BVH, Predicates, Callback>(
+            space, bvh, predicates, callback, policy._packet_size);
+        return;
+      }
+    }
+    if constexpr (std::is_same_v<Tag, NearestPredicateTag>)
+    {
+      if (policy._statistics)
+        TreeTraversal<BVH, Predicates, Callback, Tag, Recorder>(
+            space, bvh, predicates, callback, policy, make_recorder());
+      else
+        TreeTraversal<BVH, Predicates, Callback, Tag>(space, bvh, predicates,
+                                                      callback, policy);
+    }
+    else
+    {
+      TreeTraversal<BVH, Predicates, Callback, Tag>(space, bvh, predicates,
+                                                    callback, policy);
+    }
+  }
 }
 
 } // namespace Details
@@ -11,13 +11,20 @@
 #ifndef ARBORX_DETAILS_TREE_VISUALIZATION_HPP
 #define ARBORX_DETAILS_TREE_VISUALIZATION_HPP
 
+#include <ArborX_DetailsAlgorithms.hpp> // expand
 #include <ArborX_DetailsHappyTreeFriends.hpp>
 #include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
 #include <ArborX_DetailsTreeTraversal.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_TraversalPolicy.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <ostream>
 #include <tuple> // ignore
+#include <vector>
 
 namespace ArborX
 {
@@ -204,6 +211,101 @@ struct TreeVisualization
                        Callback{tree, visitor, permute});
 #endif
   }
+
+  // Write, in legacy VTK format, the bounding boxes of the nodes of the
+  // hierarchy that the traversals recorded in the statistics visited, as
+  // hexahedra (quadrilaterals in 2D) with the number of visits and whether
+  // the node is a leaf as cell data, to be colored as a heatmap in ParaView.
+  // The visits must have been enabled before the queries.
+  template <typename ExecutionSpace, typename Tree>
+  static void
+  writeNodeVisitsVTK(std::ostream &os, ExecutionSpace const &space,
+                     Tree const &tree,
+                     Experimental::TraversalStatistics const &statistics)
+  {
+    using MemorySpace = typename Tree::memory_space;
+    constexpr int DIM = GeometryTraits::dimension_v<
+        typename Tree::bounding_volume_type>;
+    static_assert(DIM == 2 || DIM == 3);
+    using Box = ExperimentalHyperGeometry::Box<DIM>;
+
+    int const n = tree.size();
+    int const num_nodes = n > 0 ? 2 * n - 1 : 0;
+    auto const node_visits = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{},
+        statistics.template nodeVisits<MemorySpace>(space, num_nodes));
+    ARBORX_ASSERT(node_visits.extent_int(0) == num_nodes);
+
+    Kokkos::View<Box *, MemorySpace> boxes(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::Viz::node_boxes"),
+        num_nodes);
+    Kokkos::parallel_for(
+        "ArborX::Viz::gather_node_boxes",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_nodes),
+        KOKKOS_LAMBDA(int node) {
+          Box box;
+          if (HappyTreeFriends::isLeaf(tree, node))
+            expand(box, HappyTreeFriends::getIndexable(tree, node));
+          else
+            expand(box,
+                   HappyTreeFriends::getInternalBoundingVolume(tree, node));
+          boxes(node) = box;
+        });
+    auto const boxes_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+    std::vector<int> visited;
+    for (int node = 0; node < num_nodes; ++node)
+      if (node_visits(node) > 0)
+        visited.push_back(node);
+    int const num_cells = visited.size();
+    constexpr int num_corners = 1 << DIM;
+
+    os << "# vtk DataFile Version 3.0\n"
+       << "ArborX node visits\n"
+       << "ASCII\n"
+       << "DATASET UNSTRUCTURED_GRID\n";
+    os << "POINTS " << num_cells * num_corners << " float\n";
+    for (int node : visited)
+    {
+      auto const &min_corner = boxes_host(node).minCorner();
+      auto const &max_corner = boxes_host(node).maxCorner();
+      // Corners in the order of the VTK_QUAD and VTK_HEXAHEDRON cells
+      for (int corner = 0; corner < num_corners; ++corner)
+      {
+        int const i = (corner & 1) ^ ((corner >> 1) & 1);
+        int const j = (corner >> 1) & 1;
+        os << (i ? max_corner[0] : min_corner[0]) << ' '
+           << (j ? max_corner[1] : min_corner[1]) << ' ';
+        if constexpr (DIM == 3)
+          os << ((corner >> 2) ? max_corner[2] : min_corner[2]);
+        else
+          os << 0;
+        os << '\n';
+      }
+    }
+    os << "CELLS " << num_cells << ' ' << num_cells * (num_corners + 1)
+       << '\n';
+    for (int cell = 0; cell < num_cells; ++cell)
+    {
+      os << num_corners;
+      for (int corner = 0; corner < num_corners; ++corner)
+        os << ' ' << cell * num_corners + corner;
+      os << '\n';
+    }
+    os << "CELL_TYPES " << num_cells << '\n';
+    for (int cell = 0; cell < num_cells; ++cell)
+      os << (DIM == 3 ? 12 : 9) << '\n';
+    os << "CELL_DATA " << num_cells << '\n';
+    os << "SCALARS visits unsigned_long 1\nLOOKUP_TABLE default\n";
+    for (int node : visited)
+      os << node_visits(node) << '\n';
+    os << "SCALARS leaf int 1\nLOOKUP_TABLE default\n";
+    // The leaves are numbered first
+    for (int node : visited)
+      os << (node < n) << '\n';
+  }
 };
 } // namespace Details
 } // namespace ArborX
@@ -0,0 +1,76 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_TWO_PASS_CALLBACKS_HPP
+#define ARBORX_DETAILS_TWO_PASS_CALLBACKS_HPP
+
+#include <ArborX_Predicates.hpp>
+
+#include <Kokkos_Core.hpp>
+
+namespace ArborX::Details
+{
+
+// Pure callbacks of the two passes of a search, to count and then to store
+// the outputs of a user callback called as callback(predicate, index, out).
+// The predicates carry the row of their results, and the leaf i stands for
+// the index _indices(i).
+
+// Counts the outputs of the callback for the predicate it is attached to
+template <typename Callback, typename Indices, typename Counts>
+struct TwoPassCountCallback
+{
+  Callback _callback;
+  Indices _indices;
+  Counts _counts;
+
+  template <typename Predicate>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate, int i) const
+  {
+    auto &count = _counts(getData(predicate));
+    _callback(getPredicate(predicate), (int)_indices(i),
+              [&](auto const &) { Kokkos::atomic_increment(&count); });
+  }
+};
+
+// Writes the outputs of the callback into the slots of the predicate it is
+// attached to
+template <typename Callback, typename Indices, typename Offset,
+          typename Cursors, typename Out>
+struct TwoPassFillCallback
+{
+  Callback _callback;
+  Indices _indices;
+  Offset _offset;
+  Cursors _cursors;
+  Out _out;
+
+  template <typename Predicate>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate, int i) const
+  {
+    int const q = getData(predicate);
+    _callback(getPredicate(predicate), (int)_indices(i),
+              [&](typename Out::value_type const &value) {
+                _out(_offset(q) + Kokkos::atomic_fetch_inc(&_cursors(q))) =
+                    value;
+              });
+  }
+};
+
+// Leaves that are given as they are to the user callback
+struct IdentityIndices
+{
+  KOKKOS_FUNCTION int operator()(int i) const { return i; }
+};
+
+} // namespace ArborX::Details
+
+#endif
@@ -64,13 +64,32 @@
 // ```
 //
 // This is encoded in `representative()` function.
+//
+// The other variants differ in how `representative()` compresses the paths.
+// All of them hook the larger representative onto the smaller one, so that
+// the labels never increase along a path and the smallest index of each set
+// is its representative (union by index).
 
 #include <Kokkos_Core.hpp>
 
 namespace ArborX::Details
 {
 
-template <typename MemorySpace, bool DoSerial = false>
+enum class UnionFindVariant
+{
+  // Intermediate pointer jumping with plain (benignly racy) writes, as in
+  // ECL-CC
+  ECL,
+  // Path halving, each element being made to skip over its parent with an
+  // atomic CAS, so that a concurrent update of the parent is never undone
+  PATH_HALVING,
+  // Union by index only, without path compression. The paths are never
+  // written to when searching for the representatives.
+  UNION_BY_INDEX
+};
+
+template <typename MemorySpace, bool DoSerial = false,
+          UnionFindVariant Variant = UnionFindVariant::ECL>
 struct UnionFind
 {
   using memory_space = MemorySpace;
@@ -108,7 +127,7 @@ struct UnionFind
   // sees the new representative, it will return it. Otherwise, it will return
   // the old representative. Either return value is handled correctly.
   KOKKOS_FUNCTION
-  int representative(int const i) const
+  int representativeECL(int const i) const
   {
     // ##### ECL license (see LICENSE.ECL) #####
     int curr = _labels(i);
@@ -126,6 +145,41 @@ struct UnionFind
     return curr;
   }
 
+  KOKKOS_FUNCTION
+  int representative(int const i) const
+  {
+    // The paths start from the label of i rather than from i itself, as
+    // merge_into() may have given i a larger label
+    if constexpr (Variant == UnionFindVariant::PATH_HALVING)
+    {
+      int prev = i;
+      int curr = _labels(i);
+      int next;
+      while (curr > (next = _labels(curr)))
+      {
+        if constexpr (DoSerial)
+          _labels(prev) = next;
+        else
+          Kokkos::atomic_compare_exchange(&_labels(prev), curr, next);
+        prev = next;
+        curr = _labels(next);
+      }
+      return curr;
+    }
+    else if constexpr (Variant == UnionFindVariant::UNION_BY_INDEX)
+    {
+      int curr = _labels(i);
+      int next;
+      while (curr > (next = _labels(curr)))
+        curr = next;
+      return curr;
+    }
+    else
+    {
+      return representativeECL(i);
+    }
+  }
+
   // In some situations it is necessary to make sure that the a particular
   // label is assigned to a point. As a regular merge() does not guarantee
   // that, an extra function is introduced, which assigns the label of the
@@ -133,8 +187,10 @@ struct UnionFind
   KOKKOS_FUNCTION
   void merge_into(int i, int j) const { _labels(i) = representative(j); }
 
+  // Returns whether the two sets were distinct, i.e., whether this call is
+  // the one that merged them.
   KOKKOS_FUNCTION
-  void merge(int i, int j) const
+  bool merge(int i, int j) const
   {
     // Per [1]:
     //
@@ -156,25 +212,39 @@ struct UnionFind
 
     if constexpr (DoSerial)
     {
+      if (vstat == ostat)
+        return false;
       if (vstat < ostat)
         _labels(ostat) = vstat;
       else
         _labels(vstat) = ostat;
+      return true;
     }
     else
     {
-      // Note: the code does one extra iteration even when the labels array was
-      // updated. However, it does not show up in any of the performance
-      // studies, and the code is cleaner and more compact.
       while (vstat != ostat)
       {
-        if (vstat < ostat)
-          ostat =
-              Kokkos::atomic_compare_exchange(&_labels(ostat), ostat, vstat);
-        else
-          vstat =
-              Kokkos::atomic_compare_exchange(&_labels(vstat), vstat, ostat);
+        int &larger = (vstat < ostat ? ostat : vstat);
+        int const smaller = (vstat < ostat ? vstat : ostat);
+
+        // Test before the CAS. In large clusters, many threads merge into
+        // the same hot representative, which another thread has often hooked
+        // already. A plain read detects it and moves on to the new
+        // representative, so that the CAS is only attempted on a label that
+        // was a representative the last time it was read.
+        if (_labels(larger) != larger)
+        {
+          larger = representative(larger);
+          continue;
+        }
+
+        int const prev =
+            Kokkos::atomic_compare_exchange(&_labels(larger), larger, smaller);
+        if (prev == larger)
+          return true;
+        larger = prev;
       }
+      return false;
     }
   }
 };
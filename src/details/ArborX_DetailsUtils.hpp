@@ -163,23 +163,197 @@ class ExclusiveScanFunctor
 {
 public:
   ExclusiveScanFunctor(Kokkos::View<T *, DeviceType> const &in,
-                       Kokkos::View<T *, DeviceType> const &out)
+                       Kokkos::View<T *, DeviceType> const &out,
+                       Kokkos::View<T, DeviceType> const &total = {})
       : _in(in)
       , _out(out)
+      , _total(total)
   {}
   KOKKOS_INLINE_FUNCTION void operator()(int i, T &update,
                                          bool final_pass) const
   {
     T const in_i = _in(i);
     if (final_pass)
+    {
       _out(i) = update;
+      if (_total.data() && i == (int)_in.extent(0) - 1)
+        _total() = update + in_i;
+    }
     update += in_i;
   }
 
 private:
   Kokkos::View<T *, DeviceType> _in;
   Kokkos::View<T *, DeviceType> _out;
+  Kokkos::View<T, DeviceType> _total;
 };
+
+// Single-pass exclusive scan with decoupled look-back (Merrill and Garland,
+// 2016). Each team scans a tile of contiguous elements. Tiles are numbered in
+// the order the teams start, so that a tile only ever waits on tiles whose
+// teams are already running. The first thread of the team publishes the sum
+// of the tile, then walks back over the preceding tiles, adding their sums
+// until it finds one that has published its inclusive prefix.
+template <typename T, typename DeviceType>
+class DecoupledLookBackScanFunctor
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using Member = typename Kokkos::TeamPolicy<ExecutionSpace>::member_type;
+
+  enum : int
+  {
+    NOT_READY = 0,
+    AGGREGATE_READY = 1,
+    PREFIX_READY = 2
+  };
+
+public:
+  static constexpr int items_per_thread = 8;
+
+  DecoupledLookBackScanFunctor(ExecutionSpace const &space,
+                               Kokkos::View<T *, DeviceType> const &in,
+                               Kokkos::View<T *, DeviceType> const &out,
+                               Kokkos::View<T, DeviceType> const &total,
+                               int team_size)
+      : _in(in)
+      , _out(out)
+      , _total(total)
+      , _tile_size(team_size * items_per_thread)
+  {
+    int const n = in.extent(0);
+    int const num_tiles = (n + _tile_size - 1) / _tile_size;
+    _status = Kokkos::View<int *, DeviceType>(
+        Kokkos::view_alloc(space, "ArborX::Algorithms::exclusive_scan::status"),
+        num_tiles);
+    _aggregates = Kokkos::View<T *, DeviceType>(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::Algorithms::exclusive_scan::aggregates"),
+        num_tiles);
+    _prefixes = Kokkos::View<T *, DeviceType>(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::Algorithms::exclusive_scan::prefixes"),
+        num_tiles);
+    _tile_counter = Kokkos::View<int, DeviceType>(Kokkos::view_alloc(
+        space, "ArborX::Algorithms::exclusive_scan::tile_counter"));
+  }
+
+  int numTiles() const { return _status.extent(0); }
+
+  KOKKOS_FUNCTION void operator()(Member const &member) const
+  {
+    int tile = 0;
+    if (member.team_rank() == 0)
+      tile = Kokkos::atomic_fetch_add(&_tile_counter(), 1);
+    member.team_broadcast(tile, 0);
+
+    int const n = _in.extent(0);
+    int const begin =
+        tile * _tile_size + member.team_rank() * items_per_thread;
+
+    // Read all the values before writing any of them for in-place scans
+    T values[items_per_thread];
+    T thread_sum = 0;
+    for (int k = 0; k < items_per_thread; ++k)
+    {
+      values[k] = (begin + k < n ? _in(begin + k) : T(0));
+      thread_sum += values[k];
+    }
+
+    T const thread_offset = member.team_scan(thread_sum);
+    T tile_sum = thread_offset + thread_sum;
+    member.team_broadcast(tile_sum, member.team_size() - 1);
+
+    T tile_prefix = 0;
+    if (member.team_rank() == 0)
+    {
+      if (tile == 0)
+      {
+        publish(tile, _prefixes, tile_sum, PREFIX_READY);
+      }
+      else
+      {
+        publish(tile, _aggregates, tile_sum, AGGREGATE_READY);
+        for (int j = tile - 1;;)
+        {
+          int const status = Kokkos::atomic_load(&_status(j));
+          if (status == NOT_READY)
+            continue;
+          Kokkos::memory_fence();
+          if (status == PREFIX_READY)
+          {
+            tile_prefix += Kokkos::atomic_load(&_prefixes(j));
+            break;
+          }
+          tile_prefix += Kokkos::atomic_load(&_aggregates(j));
+          --j;
+        }
+        publish(tile, _prefixes, tile_prefix + tile_sum, PREFIX_READY);
+      }
+      if (tile == numTiles() - 1 && _total.data())
+        _total() = tile_prefix + tile_sum;
+    }
+    member.team_broadcast(tile_prefix, 0);
+
+    T update = tile_prefix + thread_offset;
+    for (int k = 0; k < items_per_thread && begin + k < n; ++k)
+    {
+      _out(begin + k) = update;
+      update += values[k];
+    }
+  }
+
+private:
+  KOKKOS_FUNCTION void publish(int tile,
+                               Kokkos::View<T *, DeviceType> const &values,
+                               T value, int status) const
+  {
+    Kokkos::atomic_store(&values(tile), value);
+    Kokkos::memory_fence();
+    Kokkos::atomic_store(&_status(tile), status);
+  }
+
+  Kokkos::View<T *, DeviceType> _in;
+  Kokkos::View<T *, DeviceType> _out;
+  Kokkos::View<T, DeviceType> _total;
+  int _tile_size;
+  Kokkos::View<int *, DeviceType> _status;
+  Kokkos::View<T *, DeviceType> _aggregates;
+  Kokkos::View<T *, DeviceType> _prefixes;
+  Kokkos::View<int, DeviceType> _tile_counter;
+};
+
+template <typename ExecutionSpace, typename T, typename DeviceType>
+void exclusivePrefixSumImpl(ExecutionSpace const &space,
+                            Kokkos::View<T *, DeviceType> const &src,
+                            Kokkos::View<T *, DeviceType> const &dst,
+                            Kokkos::View<T, DeviceType> const &total)
+{
+  int const n = src.extent(0);
+  // The look-back is only used on devices, where the teams that have started
+  // are guaranteed to make progress while others spin
+  if constexpr (!Kokkos::SpaceAccessibility<
+                    ExecutionSpace, Kokkos::HostSpace>::accessible)
+  {
+    if (n > 0)
+    {
+      using Functor = DecoupledLookBackScanFunctor<T, DeviceType>;
+      int const team_size = 256;
+      Functor functor(space, src, dst, total, team_size);
+      Kokkos::parallel_for(
+          "ArborX::Algorithms::exclusive_scan_single_pass",
+          Kokkos::TeamPolicy<ExecutionSpace>(space, functor.numTiles(),
+                                             team_size),
+          functor);
+      return;
+    }
+  }
+  Kokkos::parallel_scan(
+      "ArborX::Algorithms::exclusive_scan",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      ExclusiveScanFunctor<T, DeviceType>(src, dst, total));
+  if (n == 0 && total.data())
+    Kokkos::deep_copy(space, total, 0);
+}
 } // namespace Details
 
 /** \brief Computes an exclusive scan.
@@ -224,6 +398,53 @@ void exclusivePrefixSum(ExecutionSpace &&space,
       Details::ExclusiveScanFunctor<ValueType, DeviceType>(src, dst));
 }
 
+/** \brief Computes an exclusive scan in a single pass and stores the sum of
+ *  all elements.
+ *
+ *  \param[in] space Execution space
+ *  \param[in] src Input view with range of elements to sum
+ *  \param[out] dst Output view; may be equal to \p src
+ *  \param[out] total Scalar view in which the sum of all the elements of \p
+ *  src is written
+ *
+ *  On devices, the scan reads and writes every element once (decoupled
+ *  look-back).  The total is written on the device without copying it back
+ *  to the host, so that subsequent kernels on \p space can read it directly.
+ *
+ *  \pre \p src and \p dst must be of rank 1 and have the same size.
+ */
+template <typename ExecutionSpace, typename ST, typename... SP, typename DT,
+          typename... DP, typename TT, typename... TP>
+void exclusivePrefixSum(ExecutionSpace const &space,
+                        Kokkos::View<ST, SP...> const &src,
+                        Kokkos::View<DT, DP...> const &dst,
+                        Kokkos::View<TT, TP...> const &total)
+{
+  static_assert(
+      std::is_same<
+          typename Kokkos::ViewTraits<DT, DP...>::value_type,
+          typename Kokkos::ViewTraits<DT, DP...>::non_const_value_type>::value,
+      "exclusivePrefixSum requires non-const destination type");
+
+  static_assert(
+      (unsigned(Kokkos::ViewTraits<DT, DP...>::rank) ==
+       unsigned(Kokkos::ViewTraits<ST, SP...>::rank)) &&
+          (unsigned(Kokkos::ViewTraits<DT, DP...>::rank) == unsigned(1)),
+      "exclusivePrefixSum requires Views of rank 1");
+
+  static_assert(unsigned(Kokkos::ViewTraits<TT, TP...>::rank) == unsigned(0),
+                "exclusivePrefixSum requires a total View of rank 0");
+
+  using ValueType = typename Kokkos::ViewTraits<DT, DP...>::value_type;
+  using DeviceType = typename Kokkos::ViewTraits<DT, DP...>::device_type;
+
+  ARBORX_ASSERT(src.extent(0) == dst.extent(0));
+  Details::exclusivePrefixSumImpl(
+      space, Kokkos::View<ValueType *, DeviceType>(src),
+      Kokkos::View<ValueType *, DeviceType>(dst),
+      Kokkos::View<ValueType, DeviceType>(total));
+}
+
 /** \brief In-place exclusive scan.
  *
  *  \param[in] space Execution space
@@ -0,0 +1,312 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_WIDE_BVH_IMPL_HPP
+#define ARBORX_DETAILS_WIDE_BVH_IMPL_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsStack.hpp>
+#include <ArborX_DetailsTreeConstruction.hpp> // halfSurfaceArea
+#include <ArborX_GeometryTraits.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm> // max
+
+namespace ArborX::Details
+{
+
+template <class BoundingVolume, int Width>
+struct WideNode
+{
+  static constexpr int DIM = GeometryTraits::dimension_v<BoundingVolume>;
+  using coordinate_type =
+      typename GeometryTraits::coordinate_type<BoundingVolume>::type;
+
+  // Bounding volumes of the children in structure-of-arrays layout so that
+  // they can all be checked at once
+  coordinate_type min_corner[DIM][Width];
+  coordinate_type max_corner[DIM][Width];
+  // Index of the child node if non-negative, -1 - index of the value for
+  // leaves otherwise
+  int children[Width];
+  int num_children;
+
+  KOKKOS_FUNCTION BoundingVolume getBoundingVolume(int k) const
+  {
+    BoundingVolume bounding_volume;
+    for (int d = 0; d < DIM; ++d)
+    {
+      bounding_volume.minCorner()[d] = min_corner[d][k];
+      bounding_volume.maxCorner()[d] = max_corner[d][k];
+    }
+    return bounding_volume;
+  }
+
+  template <class Box>
+  KOKKOS_FUNCTION void setChild(int k, int child, Box const &bounding_volume)
+  {
+    children[k] = child;
+    for (int d = 0; d < DIM; ++d)
+    {
+      min_corner[d][k] = bounding_volume.minCorner()[d];
+      max_corner[d][k] = bounding_volume.maxCorner()[d];
+    }
+  }
+};
+
+struct WideBVHImpl
+{
+  // Maximum number of nodes waiting to be visited during the traversal.
+  // Hierarchies needing more are searched through their binary counterpart.
+  static constexpr int stack_capacity = 128;
+
+  static KOKKOS_FUNCTION constexpr int leafChild(int index)
+  {
+    return -1 - index;
+  }
+
+  // Collapse a binary hierarchy into a wide one. Starting from the root, each
+  // wide node is formed by repeatedly replacing the internal child with the
+  // largest surface area by its two children, until there are Width children
+  // or all children are leaves. Nodes are created level by level. Return the
+  // largest number of nodes the traversal may have to defer, that is the
+  // largest number of internal siblings left behind on the way to any node.
+  template <typename ExecutionSpace, typename BVH, typename WideNodes>
+  static int collapse(ExecutionSpace const &space, BVH const &bvh,
+                      WideNodes &wide_nodes)
+  {
+    using MemorySpace = typename WideNodes::memory_space;
+    using WideNodeType = typename WideNodes::value_type;
+    constexpr int Width = sizeof(WideNodeType::children) / sizeof(int);
+
+    int const n = bvh.size();
+    if (n == 0)
+    {
+      Kokkos::resize(wide_nodes, 0);
+      return 0;
+    }
+
+    Kokkos::realloc(Kokkos::view_alloc(space, Kokkos::WithoutInitializing),
+                    wide_nodes, n > 1 ? n - 1 : 1);
+
+    if (n == 1)
+    {
+      Kokkos::parallel_for(
+          "ArborX::WideBVH::collapse::degenerated_one_leaf_tree",
+          Kokkos::RangePolicy<ExecutionSpace>(space, 0, 1),
+          KOKKOS_LAMBDA(int) {
+            WideNodeType node{};
+            node.num_children = 1;
+            node.setChild(0,
+                          leafChild(HappyTreeFriends::getValue(bvh, 0).index),
+                          HappyTreeFriends::getIndexable(bvh, 0));
+            wide_nodes(0) = node;
+          });
+      return 0;
+    }
+
+    // Binary internal nodes that are the roots of the wide nodes of the
+    // current level
+    Kokkos::View<int *, MemorySpace> level(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::WideBVH::collapse::level"),
+        n - 1);
+    Kokkos::View<int *, MemorySpace> next_level(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::WideBVH::collapse::next_level"),
+        n - 1);
+    // Number of nodes deferred when reaching the nodes of the current level
+    Kokkos::View<int *, MemorySpace> level_deferred(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::WideBVH::collapse::level_deferred"),
+        n - 1);
+    Kokkos::View<int *, MemorySpace> next_level_deferred(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::WideBVH::collapse::next_level_deferred"),
+        n - 1);
+    Kokkos::deep_copy(space, Kokkos::subview(level, 0),
+                      HappyTreeFriends::getRoot(bvh));
+    Kokkos::deep_copy(space, Kokkos::subview(level_deferred, 0), 0);
+
+    int max_deferred = 0;
+    int offset = 0;
+    int level_size = 1;
+    while (level_size > 0)
+    {
+      int next_level_size;
+      Kokkos::parallel_scan(
+          "ArborX::WideBVH::collapse::level",
+          Kokkos::RangePolicy<ExecutionSpace>(space, 0, level_size),
+          KOKKOS_LAMBDA(int i, int &update, bool final_pass) {
+            int children[Width];
+            int num_children = 2;
+            children[0] = HappyTreeFriends::getLeftChild(bvh, level(i));
+            children[1] = HappyTreeFriends::getRightChild(bvh, level(i));
+            while (num_children < Width)
+            {
+              int largest = -1;
+              float largest_area = -1;
+              for (int k = 0; k < num_children; ++k)
+              {
+                if (HappyTreeFriends::isLeaf(bvh, children[k]))
+                  continue;
+                auto const area = TreeConstruction::halfSurfaceArea(
+                    HappyTreeFriends::getInternalBoundingVolume(bvh,
+                                                                children[k]));
+                if (area > largest_area)
+                {
+                  largest = k;
+                  largest_area = area;
+                }
+              }
+              if (largest == -1)
+                break;
+              int const child = children[largest];
+              children[largest] = HappyTreeFriends::getLeftChild(bvh, child);
+              children[num_children++] =
+                  HappyTreeFriends::getRightChild(bvh, child);
+            }
+
+            if (!final_pass)
+            {
+              for (int k = 0; k < num_children; ++k)
+                if (!HappyTreeFriends::isLeaf(bvh, children[k]))
+                  ++update;
+              return;
+            }
+
+            // All the internal children but one may be deferred
+            int num_internal_children = 0;
+            for (int k = 0; k < num_children; ++k)
+              if (!HappyTreeFriends::isLeaf(bvh, children[k]))
+                ++num_internal_children;
+            int const deferred = level_deferred(i) + num_internal_children - 1;
+
+            WideNodeType node{};
+            node.num_children = num_children;
+            for (int k = 0; k < num_children; ++k)
+            {
+              int const child = children[k];
+              if (HappyTreeFriends::isLeaf(bvh, child))
+              {
+                node.setChild(
+                    k, leafChild(HappyTreeFriends::getValue(bvh, child).index),
+                    HappyTreeFriends::getIndexable(bvh, child));
+              }
+              else
+              {
+                next_level(update) = child;
+                next_level_deferred(update) = deferred;
+                node.setChild(
+                    k, offset + level_size + update,
+                    HappyTreeFriends::getInternalBoundingVolume(bvh, child));
+                ++update;
+              }
+            }
+            wide_nodes(offset + i) = node;
+          },
+          next_level_size);
+
+      int level_max_deferred = 0;
+      Kokkos::parallel_reduce(
+          "ArborX::WideBVH::collapse::max_deferred",
+          Kokkos::RangePolicy<ExecutionSpace>(space, 0, next_level_size),
+          KOKKOS_LAMBDA(int i, int &update) {
+            if (next_level_deferred(i) > update)
+              update = next_level_deferred(i);
+          },
+          Kokkos::Max<int>(level_max_deferred));
+      max_deferred = std::max(max_deferred, level_max_deferred);
+
+      offset += level_size;
+      level_size = next_level_size;
+      std::swap(level, next_level);
+      std::swap(level_deferred, next_level_deferred);
+    }
+
+    Kokkos::resize(Kokkos::view_alloc(space, Kokkos::WithoutInitializing),
+                   wide_nodes, offset);
+
+    return max_deferred;
+  }
+
+  template <typename ExecutionSpace, typename WideNodes, typename Predicates,
+            typename Callback>
+  static void query(ExecutionSpace const &space, WideNodes const &wide_nodes,
+                    Predicates const &predicates, Callback const &callback)
+  {
+    using WideNodeType = typename WideNodes::value_type;
+    constexpr int Width = sizeof(WideNodeType::children) / sizeof(int);
+    using Access = AccessTraits<Predicates, PredicatesTag>;
+
+    if (wide_nodes.extent(0) == 0)
+      return;
+
+    Kokkos::parallel_for(
+        "ArborX::WideBVH::query::spatial",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, Access::size(predicates)),
+        KOKKOS_LAMBDA(int i) {
+          auto const &predicate = Access::get(predicates, i);
+
+          Stack<int, StaticVector<int, stack_capacity>> stack;
+          int node = 0;
+          while (true)
+          {
+            auto const &wide_node = wide_nodes(node);
+
+            // Check all the children at once
+            bool hits[Width];
+            for (int k = 0; k < Width; ++k)
+              hits[k] = (k < wide_node.num_children &&
+                         predicate(wide_node.getBoundingVolume(k)));
+
+            int next = -1;
+            for (int k = 0; k < wide_node.num_children; ++k)
+            {
+              if (!hits[k])
+                continue;
+              int const child = wide_node.children[k];
+              if (child < 0)
+              {
+                if (invoke_callback_and_check_early_exit(callback, predicate,
+                                                         leafChild(child)))
+                  return;
+              }
+              else if (next == -1)
+              {
+                next = child;
+              }
+              else
+              {
+                stack.push(child);
+              }
+            }
+
+            if (next == -1)
+            {
+              if (stack.empty())
+                return;
+              next = stack.top();
+              stack.pop();
+            }
+            node = next;
+          }
+        });
+  }
+};
+
+} // namespace ArborX::Details
+
+#endif
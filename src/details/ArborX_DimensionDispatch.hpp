@@ -0,0 +1,46 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DIMENSION_DISPATCH_HPP
+#define ARBORX_DIMENSION_DISPATCH_HPP
+
+#include <type_traits>
+
+namespace ArborX::Experimental
+{
+
+/** Call f(std::integral_constant<int, DIM>{}) for the DIM among DIMS that is
+ * equal to the dimension only known at runtime, e.g., that of the points read
+ * from a file. Returns whether the dimension is one of DIMS.
+ *
+ * The code for each dimension may then be explicitly instantiated in
+ * translation units of its own, compiled in parallel, with the list of
+ * dimensions kept in one place:
+ * \code
+ * template <int DIM> void run(Parameters const &); // defined elsewhere
+ *
+ * bool const supported = ArborX::Experimental::dispatchDimension<2, 3>(
+ *     dim, [&](auto dim_c) { run<decltype(dim_c)::value>(parameters); });
+ * \endcode
+ */
+template <int... DIMS, typename F>
+bool dispatchDimension(int dim, F &&f)
+{
+  static_assert(sizeof...(DIMS) > 0);
+  static_assert(((DIMS > 0) && ...), "Dimensions must be positive");
+  return ((dim == DIMS ? (f(std::integral_constant<int, DIMS>{}), true)
+                       : false) ||
+          ...);
+}
+
+} // namespace ArborX::Experimental
+
+#endif
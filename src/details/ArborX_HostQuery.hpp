@@ -0,0 +1,138 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_HOST_QUERY_HPP
+#define ARBORX_HOST_QUERY_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp>
+#include <ArborX_DetailsHappyTreeFriends.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsTreeTraversal.hpp>
+#include <ArborX_Predicates.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace ArborX
+{
+namespace Details
+{
+
+template <typename Tag, typename Predicates, typename Tree, typename Predicate,
+          typename Callback>
+void queryOnHost(Tree const &tree, Predicate const &predicate,
+                 Callback const &callback)
+{
+  if (tree.empty())
+    return;
+
+  // Traversal that is not launched, searched with in place
+  using Traversal = TreeTraversal<Tree, Predicates, Callback, Tag>;
+  Traversal const traversal(tree, callback, NoTraversalStatistics{});
+
+  auto const &indexable = HappyTreeFriends::getIndexable(tree, 0);
+  if constexpr (std::is_same_v<Tag, SpatialPredicateTag>)
+  {
+    if (tree.size() == 1)
+    {
+      if (predicate(indexable))
+        callback(predicate, HappyTreeFriends::getValue(tree, 0));
+      return;
+    }
+    traversal.search(predicate, predicate, &predicate);
+  }
+  else
+  {
+    if (tree.size() == 1)
+    {
+      if (getK(predicate) >= 1 &&
+          predicate.distance(indexable) <= getMaxDistance(predicate))
+        callback(predicate, HappyTreeFriends::getValue(tree, 0));
+      return;
+    }
+
+    int stack[Traversal::stack_size];
+    float stack_distance[Traversal::stack_size];
+    if constexpr (Traversal::fixed_k > 0)
+    {
+      Kokkos::pair<int, float> buffer[Traversal::fixed_k];
+      traversal.nearestQuery(predicate, buffer, Traversal::fixed_k, stack,
+                             stack_distance);
+    }
+    else
+    {
+      thread_local std::vector<Kokkos::pair<int, float>> buffer;
+      int const k = getK(predicate);
+      if ((int)buffer.size() < k)
+        buffer.resize(k);
+      traversal.nearestQuery(predicate, buffer.data(), k, stack,
+                             stack_distance);
+    }
+  }
+}
+
+} // namespace Details
+
+namespace Experimental
+{
+
+/** Search a single spatial or nearest predicate in a hierarchy residing in
+ * host memory, on the calling thread, e.g. for each request of an online
+ * service. Unlike query(), nothing is launched, sorted nor allocated: the
+ * traversal of the predicate is that of query(), run in place. The callback
+ * is invoked as callback(predicate, value), as the pure callbacks of
+ * query().
+ *
+ * Any number of threads may search the same hierarchy concurrently as long
+ * as it is not modified meanwhile. The heaps of the nearest predicates whose
+ * number of neighbors is only known at runtime are kept per thread, and only
+ * grow with the largest number of neighbors searched by the thread.
+ */
+template <typename Tree, typename Predicate, typename Callback>
+void queryOnHost(Tree const &tree, Predicate const &predicate,
+                 Callback const &callback)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<typename Tree::memory_space,
+                                    Kokkos::DefaultHostExecutionSpace>::value,
+      "The hierarchy must be accessible from the host");
+
+  // The traversals are given the predicate as the only one of a batch
+  using Predicates = Kokkos::View<Predicate *, Kokkos::HostSpace>;
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  static_assert(std::is_same_v<Tag, Details::SpatialPredicateTag> ||
+                    std::is_same_v<Tag, Details::NearestPredicateTag>,
+                "Only spatial and nearest predicates are supported");
+
+  // Legacy trees pass the indices of the values to the callbacks
+  if constexpr (Kokkos::is_detected_v<Details::LegacyTreeArchetypeExpression,
+                                      Tree>)
+  {
+    using Wrapper =
+        Details::LegacyCallbackWrapper<Callback, typename Tree::value_type>;
+    Details::queryOnHost<Tag, Predicates>(tree, predicate, Wrapper{callback});
+  }
+  else
+  {
+    Details::check_valid_callback<typename Tree::value_type>(callback,
+                                                             Predicates{});
+    Details::queryOnHost<Tag, Predicates>(tree, predicate, callback);
+  }
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
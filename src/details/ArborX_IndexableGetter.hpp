@@ -13,9 +13,12 @@
 #define ARBORX_INDEXABLE_GETTER_HPP
 
 #include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // expand, makeEmptyBoundingVolume
 #include <ArborX_DetailsNode.hpp> // PairIndexVolume
 #include <ArborX_GeometryTraits.hpp>
 
+#include <type_traits>
+
 namespace ArborX::Details
 {
 
@@ -67,7 +70,7 @@ public:
     }
     else
     {
-      BoundingVolume bounding_volume{};
+      auto bounding_volume = makeEmptyBoundingVolume<BoundingVolume>();
       expand(bounding_volume, Access::get(_primitives, i));
       return value_type{(unsigned)i, bounding_volume};
     }
@@ -92,6 +95,51 @@ struct Indexables
   KOKKOS_FUNCTION auto size() const { return Access::size(_primitives); }
 };
 
+// Values given along with the indexable getter of the hierarchy built over
+// them, exposed as the primitives they are the values of
+template <typename Values, typename IndexableGetter>
+struct IndexableValues
+{
+  Values _values;
+  IndexableGetter _indexable_getter;
+
+  using memory_space = typename Values::memory_space;
+
+  KOKKOS_FUNCTION decltype(auto) operator()(int i) const { return _values(i); }
+
+  KOKKOS_FUNCTION auto size() const { return _values.extent(0); }
+};
+
+template <typename T>
+struct is_indexable_values : std::false_type
+{};
+
+template <typename Values, typename IndexableGetter>
+struct is_indexable_values<IndexableValues<Values, IndexableGetter>>
+    : std::true_type
+{};
+
 } // namespace ArborX::Details
 
+template <typename Values, typename IndexableGetter>
+struct ArborX::AccessTraits<
+    ArborX::Details::IndexableValues<Values, IndexableGetter>,
+    ArborX::PrimitivesTag>
+{
+  using Primitives = Details::IndexableValues<Values, IndexableGetter>;
+
+  KOKKOS_FUNCTION static decltype(auto) get(Primitives const &primitives,
+                                            int i)
+  {
+    return primitives._indexable_getter(primitives._values(i));
+  }
+
+  KOKKOS_FUNCTION static auto size(Primitives const &primitives)
+  {
+    return primitives.size();
+  }
+
+  using memory_space = typename Primitives::memory_space;
+};
+
 #endif
@@ -0,0 +1,127 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_INDEXED_TRIANGLES_HPP
+#define ARBORX_INDEXED_TRIANGLES_HPP
+
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_HyperTriangle.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+
+namespace ArborX::Experimental
+{
+
+// Triangle of a mesh given by the indices of its vertices in a vertex buffer
+// shared by all the triangles, and by its own index in the mesh, which is
+// what the callbacks of the queries get to know. Stored as the values of a
+// hierarchy, it takes 16 bytes per leaf instead of the 40 bytes of a triangle
+// paired with its index, and each vertex is stored once rather than in every
+// triangle it belongs to.
+//
+// \code
+// using Getter = ArborX::Experimental::IndexedTriangleGetter<MemorySpace>;
+// using Tree = ArborX::BasicBoundingVolumeHierarchy<
+//     MemorySpace, ArborX::Experimental::IndexedTriangle, Getter>;
+// Tree tree(space, triangles, Getter{vertices});
+// \endcode
+struct IndexedTriangle
+{
+  unsigned int index;
+  unsigned int vertices[3];
+};
+
+// Same, with the second and third vertices given by their offsets from the
+// first one, which take 16 bits each for meshes whose vertices are numbered
+// locally, e.g. in the order in which the triangles are traversed. The leaves
+// then take 12 bytes.
+struct CompactIndexedTriangle
+{
+  unsigned int index;
+  unsigned int vertex;
+  std::int16_t offsets[2];
+};
+
+// Indexable getter assembling the triangles from the vertex buffer while the
+// hierarchy is built and traversed
+template <typename MemorySpace, int DIM = 3, typename Coordinate = float>
+struct IndexedTriangleGetter
+{
+  using point_type = ExperimentalHyperGeometry::Point<DIM, Coordinate>;
+  using triangle_type = ExperimentalHyperGeometry::Triangle<DIM, Coordinate>;
+
+  Kokkos::View<point_type const *, MemorySpace> _vertices;
+
+  KOKKOS_FUNCTION triangle_type
+  operator()(IndexedTriangle const &triangle) const
+  {
+    return {_vertices(triangle.vertices[0]), _vertices(triangle.vertices[1]),
+            _vertices(triangle.vertices[2])};
+  }
+
+  KOKKOS_FUNCTION triangle_type
+  operator()(CompactIndexedTriangle const &triangle) const
+  {
+    auto const vertex = triangle.vertex;
+    return {_vertices(vertex), _vertices(vertex + triangle.offsets[0]),
+            _vertices(vertex + triangle.offsets[1])};
+  }
+};
+
+// Store the second and third vertices of the triangles as offsets from the
+// first one. Throws if any of the offsets does not fit in 16 bits.
+template <typename ExecutionSpace, typename MemorySpace>
+Kokkos::View<CompactIndexedTriangle *, MemorySpace> compressIndexedTriangles(
+    ExecutionSpace const &space,
+    Kokkos::View<IndexedTriangle *, MemorySpace> const &triangles)
+{
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::compressIndexedTriangles");
+
+  int const n = triangles.extent(0);
+  Kokkos::View<CompactIndexedTriangle *, MemorySpace> compact_triangles(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::compressIndexedTriangles::triangles"),
+      n);
+  int num_overflows = 0;
+  Kokkos::parallel_reduce(
+      "ArborX::compressIndexedTriangles",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, int &update) {
+        auto const &triangle = triangles(i);
+        auto &compact_triangle = compact_triangles(i);
+        compact_triangle.index = triangle.index;
+        compact_triangle.vertex = triangle.vertices[0];
+        for (int k = 0; k < 2; ++k)
+        {
+          auto const offset = (long long)triangle.vertices[k + 1] -
+                              (long long)triangle.vertices[0];
+          if (offset < INT16_MIN || offset > INT16_MAX)
+            ++update;
+          compact_triangle.offsets[k] = (std::int16_t)offset;
+        }
+      },
+      num_overflows);
+  ARBORX_ASSERT(num_overflows == 0);
+
+  return compact_triangles;
+}
+
+} // namespace ArborX::Experimental
+
+#endif
@@ -0,0 +1,312 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_MEMORY_USAGE_HPP
+#define ARBORX_MEMORY_USAGE_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_ConstructionPolicy.hpp>
+#include <ArborX_DetailsNode.hpp>
+#include <ArborX_DetailsQuantizedNode.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_Predicates.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace ArborX
+{
+namespace Details
+{
+// Sorting by key may need a copy of the keys and of the values on top of the
+// permutation it returns
+template <typename Key>
+std::size_t sortObjectsMemory(std::size_t n)
+{
+  return n * (2 * sizeof(Key) + 2 * sizeof(unsigned int));
+}
+} // namespace Details
+
+namespace Experimental
+{
+
+// Device memory needed by an operation, in bytes. The output is what is
+// still allocated once the operation returns (the hierarchy, or the offsets
+// and values of the results), and the temporaries are the largest amount of
+// additional memory allocated at any point during the operation.
+struct MemoryEstimate
+{
+  std::size_t output = 0;
+  std::size_t temporaries = 0;
+
+  std::size_t total() const noexcept { return output + temporaries; }
+};
+
+// Estimate the memory needed to query a hierarchy with the predicates in CRS
+// format, i.e. bvh.query(space, predicates, values, offsets, policy), with
+// values of type Value. Nothing is accessed on the device, only the number of
+// predicates is needed.
+//
+// The results of spatial predicates cannot be known before the traversal, so
+// the average number of results per predicate must be given. It defaults to
+// the buffer size of the policy for spatial predicates, and to the number of
+// neighbors of the policy for nearest predicates. The estimate follows the
+// allocations of the pass (two passes, single pass, asynchronous or in
+// batches) selected by the policy.
+template <typename Value = int, typename Predicates>
+MemoryEstimate estimateQueryMemory(Predicates const &predicates,
+                                   TraversalPolicy const &policy = {},
+                                   int results_per_query = -1)
+{
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using Tag = typename Details::AccessTraitsHelper<Access>::tag;
+  constexpr bool is_nearest =
+      std::is_same_v<Tag, Details::NearestPredicateTag>;
+
+  std::size_t const n = Access::size(predicates);
+  std::size_t const buffer_size = std::abs(policy._buffer_size);
+  if (results_per_query < 0)
+    results_per_query =
+        is_nearest ? policy._number_of_neighbors : (int)buffer_size;
+  ARBORX_ASSERT(results_per_query >= 0);
+  std::size_t const r = results_per_query;
+
+  constexpr std::size_t int_size = sizeof(int);
+  constexpr std::size_t value_size = sizeof(Value);
+
+  MemoryEstimate estimate;
+  estimate.output = (n + 1) * int_size + n * r * value_size;
+
+  // In batches, the ordering of all the predicates is kept but only one
+  // batch is traversed at a time, and the results are written in place
+  if (policy._batch_size > 0 && (std::size_t)policy._batch_size < n)
+  {
+    std::size_t const batch_size = policy._batch_size;
+    std::size_t temporaries = batch_size * int_size;
+    if (policy._sort_predicates)
+      temporaries += n * sizeof(unsigned int) +
+                     batch_size * sizeof(unsigned int) +
+                     Details::sortObjectsMemory<unsigned int>(batch_size);
+    if constexpr (is_nearest)
+      if (!policy._nearest_scratch_memory)
+        temporaries += batch_size * r * (sizeof(int) + sizeof(float));
+    estimate.temporaries = temporaries;
+    return estimate;
+  }
+
+  // Counts of the results of each predicate
+  std::size_t temporaries = n * int_size;
+
+  // Codes of the predicates along the space-filling curve, and the
+  // permutation that sorts them, unless the policy provides it already
+  if (policy._sort_predicates && !policy._predicate_permutation)
+    temporaries += n * sizeof(unsigned int) +
+                   Details::sortObjectsMemory<unsigned int>(n);
+
+  if constexpr (is_nearest)
+  {
+    // Heaps of the nearest neighbors found so far, and their offsets when
+    // the number of neighbors differs between the predicates
+    if (!policy._nearest_scratch_memory)
+      temporaries += n * r * (sizeof(int) + sizeof(float));
+    if (policy._number_of_neighbors <= 0)
+      temporaries += (n + 1) * int_size;
+  }
+  else if (policy._future)
+  {
+    // The results are compacted into a copy of the preallocated buffers
+    estimate.output = (n + 1) * int_size + n * buffer_size * value_size;
+    temporaries += n * buffer_size * value_size + (n + 1) * int_size;
+  }
+  else if (policy._single_pass)
+  {
+    // Pool of chunks of results, sized from the buffer size and grown to
+    // the number of results if needed, with the links between the chunks
+    // and the first and last chunk of each predicate
+    constexpr std::size_t chunk_size = 16;
+    std::size_t const num_chunks =
+        n * ((std::max<std::size_t>({buffer_size, r, 1}) + chunk_size - 1) /
+             chunk_size);
+    temporaries += num_chunks * (chunk_size * value_size + int_size) +
+                   2 * n * int_size;
+  }
+  else if (buffer_size > 0 && r <= buffer_size)
+  {
+    // The results are compacted out of the preallocated buffers, which
+    // are released afterwards
+    temporaries += n * buffer_size * value_size + (n + 1) * int_size;
+  }
+  // Otherwise the buffers are released before the results are stored
+
+  estimate.temporaries = temporaries;
+  return estimate;
+}
+
+// Estimate the memory needed to construct a hierarchy of n values with
+// BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
+// BoundingVolume>, along the default Morton curve.
+template <typename Value, typename BoundingVolume = Box>
+MemoryEstimate estimateConstructionMemory(int n,
+                                          ConstructionPolicy const &policy = {})
+{
+  ARBORX_ASSERT(n >= 0);
+  using LeafNode = Details::LeafNode<Value>;
+  using InternalNodeTraits = Details::InternalNodeTraits<BoundingVolume>;
+  using InternalNode = typename InternalNodeTraits::type;
+  using LinearOrderingValueType = unsigned long long;
+
+  std::size_t const num_leaves = n;
+  std::size_t const num_internal_nodes = (n > 1 ? n - 1 : 0);
+
+  MemoryEstimate estimate;
+  estimate.output =
+      num_leaves * sizeof(LeafNode) + num_internal_nodes * sizeof(InternalNode);
+  if (n <= 1)
+    return estimate;
+
+  // Codes of the values along the curve, held until the hierarchy is
+  // generated, and the permutation that sorts them
+  std::size_t temporaries = num_leaves * sizeof(LinearOrderingValueType) +
+                            (policy._primitives_sorted
+                                 ? num_leaves * sizeof(unsigned int)
+                                 : Details::sortObjectsMemory<
+                                       LinearOrderingValueType>(num_leaves));
+  if (policy._refine_duplicate_codes)
+    temporaries += num_leaves * (sizeof(unsigned int) + sizeof(long long) +
+                                 3 * sizeof(int));
+
+  std::size_t generation = 0;
+  switch (policy._hierarchy)
+  {
+  case ConstructionPolicy::Hierarchy::Linear:
+    // Ranges of the internal nodes that are being merged
+    generation = num_internal_nodes * sizeof(int);
+    break;
+  case ConstructionPolicy::Hierarchy::PLOC:
+    // Full precision internal nodes, and the clusters being merged
+    if constexpr (Details::is_quantized_internal_node<InternalNode>::value)
+      generation = num_internal_nodes *
+                   sizeof(Details::InternalNode<
+                          typename InternalNodeTraits::bounding_volume_type>);
+    generation += num_leaves * (4 * sizeof(int) + sizeof(float));
+    break;
+  }
+  // Once the hierarchy is generated, the parents, sizes and positions of the
+  // nodes, and the reordered copy of the internal nodes
+  if (policy._depth_first_layout)
+    generation = std::max(generation,
+                          (2 * num_leaves - 1) * sizeof(int) +
+                              num_internal_nodes *
+                                  (3 * sizeof(int) + sizeof(InternalNode)));
+  temporaries += generation;
+  estimate.temporaries = temporaries;
+  return estimate;
+}
+
+// Track the device memory allocated by ArborX, i.e. for the views whose
+// label starts with the prefix, from construction to destruction. The
+// allocation callbacks of Kokkos tools are chained, so that a tool already
+// loaded keeps receiving the events. Only one tracker can be alive at a time.
+//
+//   AllocationTracker tracker;
+//   bvh.query(space, predicates, values, offsets);
+//   std::size_t const bytes = tracker.peak();
+class AllocationTracker
+{
+public:
+  explicit AllocationTracker(std::string prefix = "ArborX::")
+      : _prefix(std::move(prefix))
+  {
+    ARBORX_ASSERT(instance() == nullptr);
+    instance() = this;
+    _previous = Kokkos::Tools::Experimental::get_callbacks();
+    Kokkos::Tools::Experimental::set_allocate_data_callback(&allocate);
+    Kokkos::Tools::Experimental::set_deallocate_data_callback(&deallocate);
+  }
+
+  ~AllocationTracker()
+  {
+    Kokkos::Tools::Experimental::set_allocate_data_callback(
+        _previous.allocate_data);
+    Kokkos::Tools::Experimental::set_deallocate_data_callback(
+        _previous.deallocate_data);
+    instance() = nullptr;
+  }
+
+  AllocationTracker(AllocationTracker const &) = delete;
+  AllocationTracker &operator=(AllocationTracker const &) = delete;
+
+  // Bytes currently allocated
+  std::size_t current() const noexcept { return _current; }
+
+  // High watermark of the bytes allocated since construction or the last
+  // reset
+  std::size_t peak() const noexcept { return _peak; }
+
+  void resetPeak() noexcept { _peak = _current; }
+
+private:
+  static AllocationTracker *&instance()
+  {
+    static AllocationTracker *tracker = nullptr;
+    return tracker;
+  }
+
+  bool tracks(char const *label) const
+  {
+    return std::strncmp(label, _prefix.c_str(), _prefix.size()) == 0;
+  }
+
+  static void allocate(Kokkos::Profiling::SpaceHandle handle,
+                       char const *label, void const *ptr, std::uint64_t size)
+  {
+    auto &tracker = *instance();
+    if (tracker.tracks(label))
+    {
+      tracker._current += size;
+      tracker._peak = std::max(tracker._peak, tracker._current);
+    }
+    if (tracker._previous.allocate_data)
+      tracker._previous.allocate_data(handle, label, ptr, size);
+  }
+
+  static void deallocate(Kokkos::Profiling::SpaceHandle handle,
+                         char const *label, void const *ptr,
+                         std::uint64_t size)
+  {
+    auto &tracker = *instance();
+    // Views allocated before the tracker was constructed are not counted
+    if (tracker.tracks(label))
+      tracker._current -= std::min<std::size_t>(tracker._current, size);
+    if (tracker._previous.deallocate_data)
+      tracker._previous.deallocate_data(handle, label, ptr, size);
+  }
+
+  std::string _prefix;
+  Kokkos::Tools::Experimental::EventSet _previous;
+  std::size_t _current = 0;
+  std::size_t _peak = 0;
+};
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
@@ -13,22 +13,31 @@
 #define ARBORX_MINIMUM_SPANNING_TREE_HPP
 
 #include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsAllNearestNeighbors.hpp>
+#include <ArborX_DetailsExplicitInstantiation.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
 #include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
 #include <ArborX_DetailsKokkosExtBitManipulation.hpp>
 #include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
 #include <ArborX_DetailsKokkosExtViewHelpers.hpp>
 #include <ArborX_DetailsMutualReachabilityDistance.hpp>
 #include <ArborX_DetailsTreeNodeLabeling.hpp>
+#include <ArborX_DetailsUnionFind.hpp>
 #include <ArborX_DetailsUtils.hpp>
 #include <ArborX_DetailsWeightedEdge.hpp>
 #include <ArborX_HyperBox.hpp>
 #include <ArborX_LinearBVH.hpp>
+#include <ArborX_PhaseTimings.hpp>
 
 #if KOKKOS_VERSION >= 40100
 #include <Kokkos_BitManipulation.hpp>
 #endif
 #include <Kokkos_Core.hpp>
 
+#include <tuple>
+#include <vector>
+
 namespace ArborX::Details
 {
 
@@ -38,6 +47,34 @@ enum class BoruvkaMode
   HDBSCAN
 };
 
+// Statistics of a single Boruvka iteration
+struct BoruvkaRoundStatistics
+{
+  // Number of components at the start of the iteration
+  int num_components;
+  // Number of points whose search was not pruned by their lower bound
+  long long num_searched_points;
+  // Number of nodes of the hierarchy visited by the searches
+  long long num_visited_nodes;
+  bool used_shared_radii;
+  bool used_lower_bounds;
+  // Whether the lower bounds were raised by the distances to the bounds of
+  // the other components
+  bool used_component_bounds;
+  // Time in seconds spent labeling the nodes and initializing the radii,
+  // searching for the shortest edges, and merging the components
+  double labeling_time;
+  double search_time;
+  double merging_time;
+};
+
+// Optional statistics of the Boruvka iterations of a minimum spanning tree.
+// Collecting them synchronizes the execution space after every phase.
+struct BoruvkaStatistics
+{
+  std::vector<BoruvkaRoundStatistics> rounds;
+};
+
 constexpr int ROOT_CHAIN_VALUE = -2;
 constexpr int FOLLOW_CHAIN_VALUE = -3;
 
@@ -122,16 +159,30 @@ struct FindComponentNearestNeighbors
   Metric _metric;
   Radii _radii;
   LowerBounds _lower_bounds;
+  // Nodes are pruned once they are not closer than the current best by this
+  // factor (1 for the exact search)
+  float _pruning_factor;
+  // Number of searched points and of visited nodes (not counted if empty)
+  Kokkos::View<long long *, typename BVH::memory_space> _counters;
 
   struct WithLowerBounds
   {};
 
+  // The searches of the points of small components end early, and the lower
+  // bounds discard some points right away, so that the points are handed out
+  // dynamically in chunks on host
+  static constexpr int dynamic_chunk_size = 64;
+
   template <class ExecutionSpace>
   FindComponentNearestNeighbors(ExecutionSpace const &space, BVH const &bvh,
                                 Labels const &labels, Weights const &weights,
                                 Edges const &edges, Metric const &metric,
                                 Radii const &radii,
                                 LowerBounds const &lower_bounds,
+                                float pruning_factor,
+                                Kokkos::View<long long *,
+                                             typename BVH::memory_space>
+                                    counters,
                                 std::bool_constant<UseSharedRadii>)
       : _bvh(bvh)
       , _labels(labels)
@@ -140,33 +191,36 @@ struct FindComponentNearestNeighbors
       , _metric{metric}
       , _radii(radii)
       , _lower_bounds(lower_bounds)
+      , _pruning_factor(pruning_factor)
+      , _counters(counters)
   {
     int const n = bvh.size();
     ARBORX_ASSERT(labels.extent_int(0) == 2 * n - 1);
     ARBORX_ASSERT(edges.extent_int(0) == n);
     ARBORX_ASSERT(radii.extent_int(0) == n);
+    ARBORX_ASSERT(lower_bounds.extent_int(0) == 0 ||
+                  lower_bounds.extent_int(0) == n);
 
-#ifdef KOKKOS_ENABLE_SERIAL
-    if (std::is_same<ExecutionSpace, Kokkos::Serial>{})
+    auto const policy =
+        Experimental::TraversalPolicy().setDynamicChunkSize(dynamic_chunk_size);
+    // The lower bounds are not used if empty
+    if (lower_bounds.extent_int(0) > 0)
     {
-      Kokkos::parallel_for(
+      launchTraversal<WithLowerBounds>(
           "ArborX::MST::find_component_nearest_neighbors_with_lower_bounds",
-          Kokkos::RangePolicy<ExecutionSpace, WithLowerBounds>(space, 0, n),
-          *this);
+          space, n, policy, *this);
     }
     else
-#endif
     {
-      Kokkos::parallel_for("ArborX::MST::find_component_nearest_neighbors",
-                           Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
-                           *this);
+      launchTraversal("ArborX::MST::find_component_nearest_neighbors", space,
+                      n, policy, *this);
     }
   }
 
   KOKKOS_FUNCTION void operator()(WithLowerBounds, int i) const
   {
     auto const component = _labels(i);
-    if (_lower_bounds(i) <= _radii(component))
+    if (_pruning_factor * _lower_bounds(i) <= _radii(component))
     {
       this->operator()(i);
     }
@@ -176,14 +230,22 @@ struct FindComponentNearestNeighbors
   {
     constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
 
+    // The nodes are compared through comparable distances, e.g. squared
+    // distances between points, against an upper bound of the comparable
+    // radius. The distance, needed by the metric, is only computed for the
+    // leaves that pass that test, and the radius is checked against it as
+    // before so that the equidistant leaves are resolved identically.
+    using Comparable = ComparableDistance<
+        std::decay_t<decltype(HappyTreeFriends::getIndexable(_bvh, i))>,
+        std::decay_t<decltype(HappyTreeFriends::getInternalBoundingVolume(
+            _bvh, 0))>>;
     auto const distance = [bounding_volume_i =
                                HappyTreeFriends::getIndexable(_bvh, i),
-                           &bvh = _bvh](int j) {
-      using Details::distance;
+                           &bvh = _bvh](int j) -> float {
       return HappyTreeFriends::isLeaf(bvh, j)
-                 ? distance(bounding_volume_i,
-                            HappyTreeFriends::getIndexable(bvh, j))
-                 : distance(
+                 ? Comparable::apply(bounding_volume_i,
+                                     HappyTreeFriends::getIndexable(bvh, j))
+                 : Comparable::apply(
                        bounding_volume_i,
                        HappyTreeFriends::getInternalBoundingVolume(bvh, j));
     };
@@ -192,13 +254,15 @@ struct FindComponentNearestNeighbors
     auto const predicate = [label_i = component, &labels = _labels](int j) {
       return label_i != labels(j);
     };
-    auto const leaf_permutation_i = HappyTreeFriends::getValue(_bvh, i).index;
-
     DirectedEdge current_best{};
 
     // Use a reference for shared radii, and a copy otherwise.
     std::conditional_t<UseSharedRadii, float &, float> radius =
         _radii(component);
+    float const pruning_factor = Comparable::fromDistance(_pruning_factor);
+    auto const within_radius = [&radius, pruning_factor](float distance) {
+      return pruning_factor * distance <= Comparable::upperBound(radius);
+    };
 
     constexpr int SENTINEL = -1;
     int stack[64];
@@ -212,6 +276,7 @@ struct FindComponentNearestNeighbors
 
     int node = HappyTreeFriends::getRoot(_bvh);
     float distance_node = 0;
+    long long num_visited_nodes = 0;
 
     // Important! The truncation radius is computed using the provided metric,
     // rather than just assigning the Euclidean distance. This only works for
@@ -220,6 +285,8 @@ struct FindComponentNearestNeighbors
     // criteria may return wrong results.
     do
     {
+      ++num_visited_nodes;
+
       bool traverse_left = false;
       bool traverse_right = false;
 
@@ -233,7 +300,7 @@ struct FindComponentNearestNeighbors
       // points we take so that they don't create a cycle among component
       // connectivity. This requires us to uniquely resolve equidistant
       // neighbors, so we cannot skip any of them.
-      if (distance_node <= radius)
+      if (within_radius(distance_node))
       {
         // Insert children into the stack and make sure that the closest one
         // ends on top.
@@ -242,22 +309,26 @@ struct FindComponentNearestNeighbors
         distance_left = distance(left_child);
         distance_right = distance(right_child);
 
-        if (predicate(left_child) && distance_left <= radius)
+        if (predicate(left_child) && within_radius(distance_left) &&
+            _pruning_factor * _metric.lowerBound(i, left_child) <= radius)
         {
           if (HappyTreeFriends::isLeaf(_bvh, left_child))
           {
-            float const candidate_dist =
-                _metric(leaf_permutation_i,
-                        HappyTreeFriends::getValue(_bvh, left_child).index,
-                        distance_left);
-            DirectedEdge const candidate_edge{i, left_child, candidate_dist};
-            if (candidate_edge < current_best)
+            float const leaf_distance = Comparable::toDistance(distance_left);
+            if (_pruning_factor * leaf_distance <= radius)
             {
-              current_best = candidate_edge;
-              if constexpr (UseSharedRadii)
-                Kokkos::atomic_min(&radius, candidate_dist);
-              else
-                radius = candidate_dist;
+              float const candidate_dist =
+                  _metric(i, left_child, leaf_distance);
+              DirectedEdge const candidate_edge{i, left_child,
+                                                candidate_dist};
+              if (candidate_edge < current_best)
+              {
+                current_best = candidate_edge;
+                if constexpr (UseSharedRadii)
+                  Kokkos::atomic_min(&radius, candidate_dist);
+                else
+                  radius = candidate_dist;
+              }
             }
           }
           else
@@ -267,22 +338,26 @@ struct FindComponentNearestNeighbors
         }
 
         // Note: radius may have been already updated here from the left child
-        if (predicate(right_child) && distance_right <= radius)
+        if (predicate(right_child) && within_radius(distance_right) &&
+            _pruning_factor * _metric.lowerBound(i, right_child) <= radius)
         {
           if (HappyTreeFriends::isLeaf(_bvh, right_child))
           {
-            float const candidate_dist =
-                _metric(leaf_permutation_i,
-                        HappyTreeFriends::getValue(_bvh, right_child).index,
-                        distance_right);
-            DirectedEdge const candidate_edge{i, right_child, candidate_dist};
-            if (candidate_edge < current_best)
+            float const leaf_distance = Comparable::toDistance(distance_right);
+            if (_pruning_factor * leaf_distance <= radius)
             {
-              current_best = candidate_edge;
-              if constexpr (UseSharedRadii)
-                Kokkos::atomic_min(&radius, candidate_dist);
-              else
-                radius = candidate_dist;
+              float const candidate_dist =
+                  _metric(i, right_child, leaf_distance);
+              DirectedEdge const candidate_edge{i, right_child,
+                                                candidate_dist};
+              if (candidate_edge < current_best)
+              {
+                current_best = candidate_edge;
+                if constexpr (UseSharedRadii)
+                  Kokkos::atomic_min(&radius, candidate_dist);
+                else
+                  radius = candidate_dist;
+              }
             }
           }
           else
@@ -325,6 +400,12 @@ struct FindComponentNearestNeighbors
       }
     } while (node != SENTINEL);
 
+    if (_counters.size() > 0)
+    {
+      Kokkos::atomic_inc(&_counters(0));
+      Kokkos::atomic_add(&_counters(1), num_visited_nodes);
+    }
+
     // This check is only here to reduce hammering the atomics for large
     // components. Otherwise, for a large number of points and a small number of
     // components it becomes extremely expensive.
@@ -341,21 +422,27 @@ struct FindComponentNearestNeighbors
 };
 
 // For every component C, find the shortest edge (v, w) such that v is in C
-// and w is not in C. The found edge is stored in component_out_edges(C).
+// and w is not in C. The found edge is stored in component_out_edges(C). With
+// a pruning factor 1 + eps > 1, the found edge is only guaranteed to be within
+// that factor of the shortest one.
 template <class ExecutionSpace, class BVH, class Labels, class Weights,
           class Edges, class Metric, class Radii, class LowerBounds,
           bool UseSharedRadii>
-FindComponentNearestNeighbors(ExecutionSpace, BVH, Labels, Weights, Edges,
-                              Metric, Radii, LowerBounds,
-                              std::bool_constant<UseSharedRadii>)
+FindComponentNearestNeighbors(
+    ExecutionSpace, BVH, Labels, Weights, Edges, Metric, Radii, LowerBounds,
+    float, Kokkos::View<long long *, typename BVH::memory_space>,
+    std::bool_constant<UseSharedRadii>)
     -> FindComponentNearestNeighbors<BVH, Labels, Weights, Edges, Metric, Radii,
                                      LowerBounds, UseSharedRadii>;
 
+// The weight of the edge found for a component, divided by the pruning
+// factor, bounds from below the distance of each of its vertices to the other
+// components.
 template <class ExecutionSpace, class Labels, class ComponentOutEdges,
           class LowerBounds>
 void updateLowerBounds(ExecutionSpace const &space, Labels const &labels,
                        ComponentOutEdges const &component_out_edges,
-                       LowerBounds lower_bounds)
+                       LowerBounds lower_bounds, float pruning_factor = 1)
 {
   auto const n = lower_bounds.extent(0);
   Kokkos::parallel_for(
@@ -364,10 +451,103 @@ void updateLowerBounds(ExecutionSpace const &space, Labels const &labels,
         using KokkosExt::max;
         auto component = labels(i);
         auto const &edge = component_out_edges(component);
-        lower_bounds(i) = max(lower_bounds(i), edge.weight);
+        lower_bounds(i) = max(lower_bounds(i), edge.weight / pruning_factor);
       });
 }
 
+// Once only a few components remain, raise the lower bound of each vertex to
+// its distance to the bounds of the other components, computed for all of
+// them. The metrics are not smaller than the Euclidean distance, so that it
+// bounds that of the edges out of the vertex from below. The vertices deep
+// inside large components are then pruned from the search rather than all
+// searching the full hierarchy in every round.
+template <class ExecutionSpace, class BVH, class Labels, class LowerBounds>
+void updateComponentLowerBounds(ExecutionSpace const &space, BVH const &bvh,
+                                Labels const &labels, int num_components,
+                                LowerBounds const &lower_bounds)
+{
+  using MemorySpace = typename LowerBounds::memory_space;
+  using Box = std::decay_t<decltype(HappyTreeFriends::getInternalBoundingVolume(
+      bvh, 0))>;
+  constexpr int dim = GeometryTraits::dimension_v<Box>;
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::MST::update_component_lower_bounds");
+
+  auto const n = lower_bounds.extent(0);
+
+  // The representatives are the leaves labeled with their own index
+  Kokkos::View<int *, MemorySpace> representatives(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MST::component_representatives"),
+      num_components);
+  Kokkos::parallel_scan(
+      "ArborX::MST::find_component_representatives",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, int &update, bool final) {
+        if (labels(i) == i)
+        {
+          if (final)
+            representatives(update) = i;
+          ++update;
+        }
+      });
+
+  Kokkos::View<Box *, MemorySpace> boxes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MST::component_boxes"),
+      num_components);
+  Kokkos::deep_copy(space, boxes, Box{});
+  Kokkos::parallel_for(
+      "ArborX::MST::compute_component_boxes",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        int c = 0;
+        while (representatives(c) != labels(i))
+          ++c;
+        Box box;
+        expand(box, HappyTreeFriends::getIndexable(bvh, i));
+        for (int d = 0; d < dim; ++d)
+        {
+          Kokkos::atomic_min(&boxes(c).minCorner()[d], box.minCorner()[d]);
+          Kokkos::atomic_max(&boxes(c).maxCorner()[d], box.maxCorner()[d]);
+        }
+      });
+
+  Kokkos::parallel_for(
+      "ArborX::MST::raise_lower_bounds_to_component_boxes",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        using KokkosExt::max;
+        using KokkosExt::min;
+        constexpr auto inf =
+            KokkosExt::ArithmeticTraits::infinity<float>::value;
+        auto const &indexable = HappyTreeFriends::getIndexable(bvh, i);
+        float bound = inf;
+        for (int c = 0; c < num_components; ++c)
+          if (representatives(c) != labels(i))
+            bound = min(bound, (float)distance(indexable, boxes(c)));
+        lower_bounds(i) = max(lower_bounds(i), bound);
+      });
+}
+
+// Number of points whose search would be pruned by their lower bound given
+// the current radii of their components
+template <class ExecutionSpace, class Labels, class Radii, class LowerBounds>
+int countPrunedPoints(ExecutionSpace const &space, Labels const &labels,
+                      Radii const &radii, LowerBounds const &lower_bounds,
+                      float pruning_factor)
+{
+  int num_pruned;
+  Kokkos::parallel_reduce(
+      "ArborX::MST::count_pruned_points",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, lower_bounds.extent(0)),
+      KOKKOS_LAMBDA(int i, int &update) {
+        if (pruning_factor * lower_bounds(i) > radii(labels(i)))
+          ++update;
+      },
+      num_pruned);
+  return num_pruned;
+}
+
 // workaround slow atomic min operations on edge type
 template <class ExecutionSpace, class Labels, class Weights, class Edges>
 void retrieveEdges(ExecutionSpace const &space, Labels const &labels,
@@ -482,6 +662,36 @@ struct UpdateComponentsAndEdges
   }
 };
 
+// Approximate counterpart of UpdateComponentsAndEdges. When the found edges
+// are not the shortest ones, they may form cycles among the components, so
+// that the components are merged through a union-find instead. An edge is
+// added to the tree only when it merges two distinct sets.
+template <class ExecutionSpace, class UnionFind, class Labels, class OutEdges,
+          class Edges, class EdgesCount>
+void mergeComponentsApproximately(ExecutionSpace const &space,
+                                  UnionFind const &union_find,
+                                  Labels const &labels,
+                                  OutEdges const &out_edges, Edges const &edges,
+                                  EdgesCount const &num_edges)
+{
+  int const n = out_edges.extent_int(0);
+  Kokkos::parallel_for(
+      "ArborX::MST::merge_components",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        if (labels(i) != i)
+          return;
+        auto edge = out_edges(i);
+        if (union_find.merge(i, labels(edge.target())))
+          edges(Kokkos::atomic_fetch_inc(&num_edges())) =
+              static_cast<WeightedEdge>(edge);
+      });
+  Kokkos::parallel_for(
+      "ArborX::MST::update_labels",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        labels(i) = union_find.representative(labels(i));
+      });
+}
+
 // Reverse node leaf permutation order back to original indices
 template <class ExecutionSpace, class BVH, class Edges>
 void finalizeEdges(ExecutionSpace const &space, BVH const &bvh,
@@ -677,8 +887,7 @@ void resetSharedRadii(ExecutionSpace const &space, BVH const &bvh,
         if (label_i != label_j)
         {
           auto const r =
-              metric(HappyTreeFriends::getValue(bvh, i).index,
-                     HappyTreeFriends::getValue(bvh, j).index,
+              metric(i, j,
                      distance(HappyTreeFriends::getIndexable(bvh, i),
                               HappyTreeFriends::getIndexable(bvh, j)));
           Kokkos::atomic_min(&radii(label_i), r);
@@ -696,56 +905,72 @@ struct MinimumSpanningTree
   Kokkos::View<WeightedEdge *, MemorySpace> edges;
   Kokkos::View<int *, MemorySpace> dendrogram_parents;
   Kokkos::View<float *, MemorySpace> dendrogram_parent_heights;
-
+  // Distances to the k-th nearest neighbors, used for the mutual reachability
+  // distances (only computed when k > 1)
+  Kokkos::View<float *, MemorySpace> core_distances;
+
+  // With eps > 0, the tree is approximate: each of its edges is within a
+  // factor 1 + eps of the shortest edge leaving the component it was chosen
+  // for, which allows for much more pruning in the search. This is only
+  // available without the dendrogram.
+  //
+  // The statistics of the Boruvka iterations are collected if provided.
   template <class ExecutionSpace, class Primitives>
   MinimumSpanningTree(ExecutionSpace const &space, Primitives const &primitives,
-                      int k = 1)
+                      int k = 1, float eps = 0,
+                      BoruvkaStatistics *statistics = nullptr,
+                      Experimental::PhaseTimings *timings = nullptr);
+
+  // Build the tree over the values of an existing hierarchy, with the given
+  // core distances for the mutual reachability distance (Euclidean distance
+  // if empty). This allows to reuse the hierarchy and the nearest neighbors
+  // distances over several trees.
+  template <class ExecutionSpace, class BVH, class CoreDistances,
+            class Enable = std::enable_if_t<Kokkos::is_view_v<CoreDistances>>>
+  MinimumSpanningTree(ExecutionSpace const &space, BVH const &bvh,
+                      CoreDistances const &core_distances_in,
+                      BoruvkaStatistics *statistics = nullptr,
+                      Experimental::PhaseTimings *timings = nullptr)
       : edges(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
                                  "ArborX::MST::edges"),
-              AccessTraits<Primitives, PrimitivesTag>::size(primitives) - 1)
+              bvh.size() - 1)
       , dendrogram_parents("ArborX::MST::dendrogram_parents", 0)
       , dendrogram_parent_heights("ArborX::MST::dendrogram_parent_heights", 0)
+      , core_distances(core_distances_in)
   {
-    Kokkos::Profiling::pushRegion("ArborX::MST::MST");
+    pushPhase(space, timings, "ArborX::MST::MST");
 
-    using Access = AccessTraits<Primitives, PrimitivesTag>;
-    constexpr int dim = GeometryTraits::dimension_v<
-        typename Details::AccessTraitsHelper<Access>::type>;
-    using Box = ExperimentalHyperGeometry::Box<dim>;
+    ARBORX_ASSERT(core_distances.size() == 0 ||
+                  core_distances.size() == bvh.size());
 
-    auto const n = AccessTraits<Primitives, PrimitivesTag>::size(primitives);
-
-    Kokkos::Profiling::pushRegion("ArborX::MST::construction");
-    BasicBoundingVolumeHierarchy<MemorySpace, PairIndexVolume<Box>> bvh(
-        space, primitives);
-    Kokkos::Profiling::popRegion();
-
-    if (k > 1)
+    if (core_distances.size() > 0)
     {
-      Kokkos::Profiling::pushRegion("ArborX::MST::compute_core_distances");
-      Kokkos::View<float *, MemorySpace> core_distances(
-          "ArborX::MST::core_distances", n);
-      bvh.query(space, NearestK<Primitives>{primitives, k},
-                MaxDistance<Primitives, decltype(core_distances)>{
-                    primitives, core_distances});
-      Kokkos::Profiling::popRegion();
-
-      MutualReachability<decltype(core_distances)> mutual_reachability{
-          core_distances};
-      Kokkos::Profiling::pushRegion("ArborX::MST::boruvka");
-      doBoruvka(space, bvh, mutual_reachability);
-      Kokkos::Profiling::popRegion();
+      Kokkos::View<float *, MemorySpace> node_core_distances(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                             "ArborX::MST::node_core_distances"),
+          2 * bvh.size() - 1);
+      permuteCoreDistances(space, bvh, core_distances, node_core_distances,
+                           true /*to_leaf_order*/);
+      pushPhase(space, timings, "ArborX::MST::boruvka");
+      auto tree_parents = computeTreeParents(space, bvh);
+      reduceMinValues(space, tree_parents, node_core_distances);
+      MutualReachability<decltype(node_core_distances)> mutual_reachability{
+          node_core_distances};
+      doBoruvka(space, bvh, tree_parents, mutual_reachability, 0, statistics,
+                timings);
+      popPhase(space, timings);
     }
     else
     {
-      Kokkos::Profiling::pushRegion("ArborX::MST::boruvka");
-      doBoruvka(space, bvh, Euclidean{});
-      Kokkos::Profiling::popRegion();
+      pushPhase(space, timings, "ArborX::MST::boruvka");
+      auto tree_parents = computeTreeParents(space, bvh);
+      doBoruvka(space, bvh, tree_parents, Euclidean{}, 0, statistics, timings);
+      popPhase(space, timings);
     }
 
     finalizeEdges(space, bvh, edges);
 
-    Kokkos::Profiling::popRegion();
+    popPhase(space, timings);
   }
 
   // enclosing function for an extended __host__ __device__ lambda cannot have
@@ -753,24 +978,61 @@ struct MinimumSpanningTree
 #ifndef KOKKOS_COMPILER_NVCC
 private:
 #endif
-  template <class ExecutionSpace, class BVH, class Metric>
-  void doBoruvka(ExecutionSpace const &space, BVH const &bvh,
-                 Metric const &metric)
+  // The metric is evaluated for the leaves of the hierarchy, so the core
+  // distances are moved between the order of the values (their index) and
+  // that of the leaves
+  template <class ExecutionSpace, class BVH, class Src, class Dst>
+  void permuteCoreDistances(ExecutionSpace const &space, BVH const &bvh,
+                            Src const &src, Dst const &dst,
+                            bool to_leaf_order)
+  {
+    Kokkos::parallel_for(
+        "ArborX::MST::permute_core_distances",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, bvh.size()),
+        KOKKOS_LAMBDA(int i) {
+          auto const index = HappyTreeFriends::getValue(bvh, i).index;
+          if (to_leaf_order)
+            dst(i) = src(index);
+          else
+            dst(index) = src(i);
+        });
+  }
+
+  template <class ExecutionSpace, class BVH>
+  Kokkos::View<int *, MemorySpace>
+  computeTreeParents(ExecutionSpace const &space, BVH const &bvh)
   {
-    auto const n = bvh.size();
     Kokkos::View<int *, MemorySpace> tree_parents(
         Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
                            "ArborX::MST::tree_parents"),
-        2 * n - 1);
+        2 * bvh.size() - 1);
     findParents(space, bvh, tree_parents);
+    return tree_parents;
+  }
+
+  template <class ExecutionSpace, class BVH, class Metric>
+  void doBoruvka(ExecutionSpace const &space, BVH const &bvh,
+                 Kokkos::View<int *, MemorySpace> &tree_parents,
+                 Metric const &metric, float eps,
+                 BoruvkaStatistics *statistics,
+                 Experimental::PhaseTimings *timings)
+  {
+    auto const n = bvh.size();
+    bool const approximate = (eps > 0);
+    float const pruning_factor = 1 + eps;
 
-    Kokkos::Profiling::pushRegion("ArborX::MST::initialize_node_labels");
+    pushPhase(space, timings, "ArborX::MST::initialize_node_labels");
     Kokkos::View<int *, MemorySpace> labels(
         Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
                            "ArborX::MST::labels"),
         2 * n - 1);
     iota(space, Kokkos::subview(labels, std::make_pair((decltype(n))0, n)));
-    Kokkos::Profiling::popRegion();
+    popPhase(space, timings);
+
+    Kokkos::View<int *, MemorySpace> label_updates(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::MST::label_updates"),
+        n - 1);
 
     Kokkos::View<DirectedEdge *, MemorySpace> component_out_edges(
         Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
@@ -787,34 +1049,46 @@ private:
                            "ArborX::MST::radii"),
         n);
 
-    Kokkos::View<float *, MemorySpace> lower_bounds("ArborX::MST::lower_bounds",
-                                                    0);
-
-    constexpr bool use_lower_bounds =
-#ifdef KOKKOS_ENABLE_SERIAL
-        std::is_same<ExecutionSpace, Kokkos::Serial>::value;
-#else
-        false;
-#endif
-
-    // Shared radii may or may not be faster for CUDA depending on the problem.
-    // In the ICPP'51 paper experiments, we ended up using it only in Serial.
-    // But we would like to keep an option open for the future, so the code is
-    // written to be able to run it if we want.
-    constexpr bool use_shared_radii =
+    // The lower bounds are maintained in every iteration, so that they can be
+    // used whenever they pay off
+    Kokkos::View<float *, MemorySpace> lower_bounds(
+        Kokkos::view_alloc(space, "ArborX::MST::lower_bounds"), n);
+    Kokkos::View<float *, MemorySpace> no_lower_bounds(
+        "ArborX::MST::no_lower_bounds", 0);
+
+    // Shared radii and lower bounds trade some overhead (contended atomics on
+    // the radii, extra checks) for more pruning. In the ICPP'51 paper
+    // experiments, both only paid off in Serial, where they are always used.
+    // On the other backends, they are chosen at every iteration: the radii
+    // are shared once the components are large enough that many points search
+    // on behalf of the same one, and the lower bounds are used once they
+    // would prune a sizable fraction of the points.
+    constexpr bool is_serial =
 #ifdef KOKKOS_ENABLE_SERIAL
         std::is_same<ExecutionSpace, Kokkos::Serial>::value;
 #else
         false;
 #endif
+    constexpr int shared_radii_min_component_size = 8;
+    constexpr float lower_bounds_min_pruned_fraction = 0.25f;
+    // The distances to the bounds of the other components are computed for
+    // every vertex, which only pays off in the late rounds
+    constexpr int component_bounds_max_num_components = 32;
+
+    Kokkos::View<long long *, MemorySpace> counters(
+        "ArborX::MST::statistics_counters", (statistics ? 2 : 0));
+    Kokkos::Timer timer;
+    // Time since the last call, only measured when collecting statistics
+    auto const lap = [&]() {
+      if (!statistics)
+        return 0.;
+      space.fence("ArborX::MST::Boruvka (statistics)");
+      double const time = timer.seconds();
+      timer.reset();
+      return time;
+    };
 
-    if constexpr (use_lower_bounds)
-    {
-      KokkosExt::reallocWithoutInitializing(space, lower_bounds, n);
-      Kokkos::deep_copy(space, lower_bounds, 0);
-    }
-
-    Kokkos::Profiling::pushRegion("ArborX::MST::Boruvka_loop");
+    pushPhase(space, timings, "ArborX::MST::Boruvka_loop");
     Kokkos::View<int, MemorySpace> num_edges(
         Kokkos::view_alloc(space, "ArborX::MST::num_edges")); // initialize to 0
 
@@ -823,6 +1097,15 @@ private:
 
     Kokkos::View<int *, MemorySpace> sided_parents("ArborX::MST::sided_parents",
                                                    0);
+
+    Kokkos::View<int *, MemorySpace> union_find_labels(
+        "ArborX::MST::union_find_labels", 0);
+    if (approximate)
+    {
+      KokkosExt::reallocWithoutInitializing(space, union_find_labels, n);
+      iota(space, union_find_labels);
+    }
+    UnionFind<MemorySpace> union_find(union_find_labels);
     if constexpr (Mode == BoruvkaMode::HDBSCAN)
     {
       KokkosExt::reallocWithoutInitializing(space, edges_mapping, n - 1);
@@ -838,12 +1121,21 @@ private:
     [[maybe_unused]] int edges_end = 0;
     do
     {
-      Kokkos::Profiling::pushRegion("ArborX::Boruvka_" +
-                                    std::to_string(++iterations) + "_" +
-                                    std::to_string(num_components));
-
-      // Propagate leaf node labels to internal nodes
-      reduceLabels(space, tree_parents, labels);
+      pushPhase(space, timings,
+                "ArborX::Boruvka_" + std::to_string(++iterations) + "_" +
+                    std::to_string(num_components));
+
+      BoruvkaRoundStatistics round{};
+      round.num_components = num_components;
+      lap();
+
+      // Propagate leaf node labels to internal nodes. After the first
+      // iteration, the internal nodes within a single component stay so as
+      // the components merge, and only the others need to be reduced again.
+      if (iterations == 1)
+        reduceLabels(space, tree_parents, labels);
+      else
+        updateLabels(space, tree_parents, labels, label_updates);
 
       constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
       constexpr DirectedEdge uninitialized_edge;
@@ -852,13 +1144,51 @@ private:
       Kokkos::deep_copy(space, radii, inf);
       resetSharedRadii(space, bvh, labels, metric, radii);
 
-      FindComponentNearestNeighbors(
-          space, bvh, labels, weights, component_out_edges, metric, radii,
-          lower_bounds, std::bool_constant<use_shared_radii>());
+      bool const use_component_bounds =
+          (iterations > 1 &&
+           num_components <= component_bounds_max_num_components);
+      if (use_component_bounds)
+        updateComponentLowerBounds(space, bvh, labels, num_components,
+                                   lower_bounds);
+
+      bool const use_shared_radii =
+          is_serial ||
+          (long long)n >=
+              (long long)shared_radii_min_component_size * num_components;
+      // In the first iteration, the lower bounds are all 0
+      bool const use_lower_bounds =
+          is_serial ||
+          (iterations > 1 &&
+           countPrunedPoints(space, labels, radii, lower_bounds,
+                             pruning_factor) >=
+               lower_bounds_min_pruned_fraction * n);
+      round.used_shared_radii = use_shared_radii;
+      round.used_lower_bounds = use_lower_bounds;
+      round.used_component_bounds = use_component_bounds;
+      if (statistics)
+        Kokkos::deep_copy(space, counters, 0);
+      round.labeling_time = lap();
+
+      auto const find_component_nearest_neighbors = [&](auto shared_radii) {
+        FindComponentNearestNeighbors(
+            space, bvh, labels, weights, component_out_edges, metric, radii,
+            (use_lower_bounds ? lower_bounds : no_lower_bounds),
+            pruning_factor, counters, shared_radii);
+      };
+      if (use_shared_radii)
+        find_component_nearest_neighbors(std::true_type{});
+      else
+        find_component_nearest_neighbors(std::false_type{});
       retrieveEdges(space, labels, weights, component_out_edges);
-      if constexpr (use_lower_bounds)
+      updateLowerBounds(space, labels, component_out_edges, lower_bounds,
+                        pruning_factor);
+      round.search_time = lap();
+      if (statistics)
       {
-        updateLowerBounds(space, labels, component_out_edges, lower_bounds);
+        auto const counters_host =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, counters);
+        round.num_searched_points = counters_host(0);
+        round.num_visited_nodes = counters_host(1);
       }
 
       UpdateComponentsAndEdges<decltype(labels), decltype(component_out_edges),
@@ -868,11 +1198,15 @@ private:
 
       // For every component C and a found shortest edge `(u, w)`, add the
       // edge to the list of MST edges.
-      Kokkos::parallel_for(
-          "ArborX::MST::update_unidirectional_edges",
-          Kokkos::RangePolicy<ExecutionSpace, UnidirectionalEdgesTag>(space, 0,
-                                                                      n),
-          f);
+      if (approximate)
+        mergeComponentsApproximately(space, union_find, labels,
+                                     component_out_edges, edges, num_edges);
+      else
+        Kokkos::parallel_for(
+            "ArborX::MST::update_unidirectional_edges",
+            Kokkos::RangePolicy<ExecutionSpace, UnidirectionalEdgesTag>(space,
+                                                                        0, n),
+            f);
 
       int num_edges_host;
       Kokkos::deep_copy(space, num_edges_host, num_edges);
@@ -900,16 +1234,21 @@ private:
 
       // For every component C and a found shortest edge `(u, w)`, merge C
       // with the component that w belongs to by updating the labels
-      Kokkos::parallel_for(
-          "ArborX::MST::update_labels",
-          Kokkos::RangePolicy<ExecutionSpace, LabelsTag>(space, 0, n), f);
+      if (!approximate)
+        Kokkos::parallel_for(
+            "ArborX::MST::update_labels",
+            Kokkos::RangePolicy<ExecutionSpace, LabelsTag>(space, 0, n), f);
 
       num_components = static_cast<int>(n) - num_edges_host;
 
       edges_start = edges_end;
       edges_end = num_edges_host;
 
-      Kokkos::Profiling::popRegion();
+      round.merging_time = lap();
+      if (statistics)
+        statistics->rounds.push_back(round);
+
+      popPhase(space, timings);
     } while (num_components > 1);
 
     // Deallocate some memory to reduce high water mark
@@ -917,6 +1256,8 @@ private:
     Kokkos::resize(lower_bounds, 0);
     Kokkos::resize(radii, 0);
     Kokkos::resize(labels, 0);
+    Kokkos::resize(label_updates, 0);
+    Kokkos::resize(union_find_labels, 0);
     Kokkos::resize(weights, 0);
     Kokkos::resize(component_out_edges, 0);
     Kokkos::resize(tree_parents, 0);
@@ -943,10 +1284,309 @@ private:
           });
     }
 
+    popPhase(space, timings);
+  }
+};
+
+template <class MemorySpace, BoruvkaMode Mode>
+template <class ExecutionSpace, class Primitives>
+MinimumSpanningTree<MemorySpace, Mode>::MinimumSpanningTree(
+    ExecutionSpace const &space, Primitives const &primitives, int k, float eps,
+    BoruvkaStatistics *statistics, Experimental::PhaseTimings *timings)
+    : edges(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                               "ArborX::MST::edges"),
+            AccessTraits<Primitives, PrimitivesTag>::size(primitives) - 1)
+    , dendrogram_parents("ArborX::MST::dendrogram_parents", 0)
+    , dendrogram_parent_heights("ArborX::MST::dendrogram_parent_heights", 0)
+    , core_distances("ArborX::MST::core_distances", 0)
+{
+  pushPhase(space, timings, "ArborX::MST::MST");
+
+  ARBORX_ASSERT(eps >= 0);
+  ARBORX_ASSERT(eps == 0 || Mode == BoruvkaMode::MST);
+
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  constexpr int dim = GeometryTraits::dimension_v<
+      typename Details::AccessTraitsHelper<Access>::type>;
+  using Box = ExperimentalHyperGeometry::Box<dim>;
+
+  auto const n = AccessTraits<Primitives, PrimitivesTag>::size(primitives);
+
+  pushPhase(space, timings, "ArborX::MST::construction");
+  BasicBoundingVolumeHierarchy<MemorySpace, PairIndexVolume<Box>> bvh(
+      space, primitives);
+  popPhase(space, timings);
+
+  if (k > 1)
+  {
+    pushPhase(space, timings, "ArborX::MST::compute_core_distances");
+    Kokkos::View<float *, MemorySpace> node_core_distances(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::MST::node_core_distances"),
+        2 * n - 1);
+    KthNearestNeighborDistances(space, bvh, k, node_core_distances,
+                                true /*in_leaf_order*/);
+    KokkosExt::reallocWithoutInitializing(space, core_distances, n);
+    permuteCoreDistances(space, bvh, node_core_distances, core_distances,
+                         false /*to_leaf_order*/);
+    popPhase(space, timings);
+
+    pushPhase(space, timings, "ArborX::MST::boruvka");
+    auto tree_parents = computeTreeParents(space, bvh);
+    reduceMinValues(space, tree_parents, node_core_distances);
+    MutualReachability<decltype(node_core_distances)> mutual_reachability{
+        node_core_distances};
+    doBoruvka(space, bvh, tree_parents, mutual_reachability, eps, statistics,
+              timings);
+    popPhase(space, timings);
+  }
+  else
+  {
+    pushPhase(space, timings, "ArborX::MST::boruvka");
+    auto tree_parents = computeTreeParents(space, bvh);
+    doBoruvka(space, bvh, tree_parents, Euclidean{}, eps, statistics, timings);
+    popPhase(space, timings);
+  }
+
+  finalizeEdges(space, bvh, edges);
+
+  popPhase(space, timings);
+}
+
+// Symmetrize the graph given in the CRS format: every edge (i, j) is listed
+// both in the row of i and in the row of j.
+template <class ExecutionSpace, class Offsets, class Indices, class Weights>
+auto symmetrizeGraph(ExecutionSpace const &space, Offsets const &offsets,
+                     Indices const &indices, Weights const &weights)
+{
+  KokkosExt::ScopedProfileRegion guard("ArborX::MSF::symmetrize_graph");
+
+  using MemorySpace = typename Indices::memory_space;
+
+  int const n = offsets.extent_int(0) - 1;
+  int const num_entries = indices.extent_int(0);
+
+  Kokkos::View<int *, MemorySpace> symmetric_offsets(
+      "ArborX::MSF::symmetric_offsets", n + 1);
+  Kokkos::parallel_for(
+      "ArborX::MSF::count_symmetric_entries",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        for (int k = offsets(i); k < offsets(i + 1); ++k)
+        {
+          Kokkos::atomic_inc(&symmetric_offsets(i));
+          Kokkos::atomic_inc(&symmetric_offsets(indices(k)));
+        }
+      });
+  exclusivePrefixSum(space, symmetric_offsets);
+
+  Kokkos::View<int *, MemorySpace> symmetric_indices(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MSF::symmetric_indices"),
+      2 * num_entries);
+  Kokkos::View<float *, MemorySpace> symmetric_weights(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MSF::symmetric_weights"),
+      2 * num_entries);
+  // Next free position in each row
+  Kokkos::View<int *, MemorySpace> counts(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::MSF::counts"),
+      n);
+  Kokkos::deep_copy(space, counts,
+                    Kokkos::subview(symmetric_offsets, std::make_pair(0, n)));
+  Kokkos::parallel_for(
+      "ArborX::MSF::fill_symmetric_entries",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        for (int k = offsets(i); k < offsets(i + 1); ++k)
+        {
+          int const j = indices(k);
+          int const pos_i = Kokkos::atomic_fetch_inc(&counts(i));
+          symmetric_indices(pos_i) = j;
+          symmetric_weights(pos_i) = weights(k);
+          int const pos_j = Kokkos::atomic_fetch_inc(&counts(j));
+          symmetric_indices(pos_j) = i;
+          symmetric_weights(pos_j) = weights(k);
+        }
+      });
+
+  return std::make_tuple(symmetric_offsets, symmetric_indices,
+                         symmetric_weights);
+}
+
+// Graph counterpart of FindComponentNearestNeighbors. For every component C,
+// find the lightest edge (v, w) of the graph such that v is in C and w is not
+// in C. The found edge is stored in component_out_edges(C) by retrieveEdges.
+template <class ExecutionSpace, class Offsets, class Indices, class Weights,
+          class Labels, class ComponentWeights, class Edges>
+void findComponentOutEdges(ExecutionSpace const &space, Offsets const &offsets,
+                           Indices const &indices, Weights const &weights,
+                           Labels const &labels,
+                           ComponentWeights const &component_weights,
+                           Edges const &edges)
+{
+  int const n = labels.extent_int(0);
+  Kokkos::parallel_for(
+      "ArborX::MSF::find_component_out_edges",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        constexpr auto inf =
+            KokkosExt::ArithmeticTraits::infinity<float>::value;
+
+        auto const component = labels(i);
+        DirectedEdge current_best{};
+        for (int k = offsets(i); k < offsets(i + 1); ++k)
+        {
+          int const j = indices(k);
+          if (labels(j) == component)
+            continue;
+          DirectedEdge const candidate{i, j, weights(k)};
+          if (candidate < current_best)
+            current_best = candidate;
+        }
+
+        auto &component_weight = component_weights(component);
+        if (current_best.weight < inf &&
+            current_best.weight <= component_weight)
+        {
+          if (Kokkos::atomic_min_fetch(&component_weight,
+                                       current_best.weight) ==
+              current_best.weight)
+          {
+            edges(i) = current_best;
+          }
+        }
+      });
+  retrieveEdges(space, labels, component_weights, edges);
+
+  // A component without outgoing edges is a tree of the forest. Make its
+  // edge a self-loop so that it is left alone when merging components.
+  Kokkos::parallel_for(
+      "ArborX::MSF::close_trees",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        constexpr auto inf =
+            KokkosExt::ArithmeticTraits::infinity<float>::value;
+        if (labels(i) == i && !(edges(i).weight < inf))
+          edges(i) = DirectedEdge{i, i, inf};
+      });
+}
+
+// Minimum spanning forest of a weighted graph given in the CRS format: the
+// neighbors of the vertex i are indices(offsets(i)) through
+// indices(offsets(i + 1) - 1), with weights given in the same positions. The
+// graph is treated as undirected, and does not need to be symmetric. Edges of
+// infinite weight are ignored. Unlike MinimumSpanningTree, no spatial search
+// is performed, so that a k-nearest neighbors graph or any other sparse
+// candidate graph can be used directly.
+template <class MemorySpace>
+struct MinimumSpanningForest
+{
+  using memory_space = MemorySpace;
+  static_assert(Kokkos::is_memory_space<MemorySpace>::value);
+
+  // One fewer edge than vertices per connected component of the graph
+  Kokkos::View<WeightedEdge *, MemorySpace> edges;
+
+  template <class ExecutionSpace, class Offsets, class Indices, class Weights>
+  MinimumSpanningForest(ExecutionSpace const &space, Offsets const &offsets,
+                        Indices const &indices, Weights const &weights)
+      : edges("ArborX::MSF::edges", 0)
+  {
+    KokkosExt::ScopedProfileRegion guard("ArborX::MSF::MSF");
+
+    static_assert(
+        KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+    ARBORX_ASSERT(offsets.extent_int(0) >= 1);
+    ARBORX_ASSERT(indices.size() == weights.size());
+
+    int const n = offsets.extent_int(0) - 1;
+    if (n <= 1)
+      return;
+
+    auto const [symmetric_offsets, symmetric_indices, symmetric_weights] =
+        symmetrizeGraph(space, offsets, indices, weights);
+
+    KokkosExt::reallocWithoutInitializing(space, edges, n - 1);
+
+    Kokkos::View<int *, MemorySpace> labels(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::MSF::labels"),
+        n);
+    iota(space, labels);
+
+    Kokkos::View<DirectedEdge *, MemorySpace> component_out_edges(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::MSF::component_out_edges"),
+        n);
+    Kokkos::View<float *, MemorySpace> component_weights(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::MSF::component_weights"),
+        n);
+
+    Kokkos::View<int, MemorySpace> num_edges(
+        Kokkos::view_alloc(space, "ArborX::MSF::num_edges")); // initialize to 0
+    Kokkos::View<int *, MemorySpace> edges_mapping("ArborX::MSF::edges_mapping",
+                                                   0);
+
+    UpdateComponentsAndEdges<decltype(labels), decltype(component_out_edges),
+                             decltype(edges), decltype(edges_mapping),
+                             decltype(num_edges), BoruvkaMode::MST>
+        f{labels, component_out_edges, edges, edges_mapping, num_edges};
+
+    // Boruvka iterations, until no component has an outgoing edge
+    Kokkos::Profiling::pushRegion("ArborX::MSF::Boruvka_loop");
+    int num_edges_host = 0;
+    int prev_num_edges_host;
+    do
+    {
+      prev_num_edges_host = num_edges_host;
+
+      constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
+      constexpr DirectedEdge uninitialized_edge;
+      Kokkos::deep_copy(space, component_out_edges, uninitialized_edge);
+      Kokkos::deep_copy(space, component_weights, inf);
+
+      findComponentOutEdges(space, symmetric_offsets, symmetric_indices,
+                            symmetric_weights, labels, component_weights,
+                            component_out_edges);
+
+      Kokkos::parallel_for(
+          "ArborX::MSF::update_unidirectional_edges",
+          Kokkos::RangePolicy<ExecutionSpace, UnidirectionalEdgesTag>(space, 0,
+                                                                      n),
+          f);
+      Kokkos::parallel_for(
+          "ArborX::MSF::update_labels",
+          Kokkos::RangePolicy<ExecutionSpace, LabelsTag>(space, 0, n), f);
+
+      Kokkos::deep_copy(space, num_edges_host, num_edges);
+      space.fence();
+    } while (num_edges_host > prev_num_edges_host);
     Kokkos::Profiling::popRegion();
+
+    Kokkos::resize(edges, num_edges_host);
   }
 };
 
 } // namespace ArborX::Details
 
+#define ARBORX_IMPL_INSTANTIATE_MST_CONSTRUCTION(EXTERN, ExecutionSpace,       \
+                                                 Point)                        \
+  EXTERN template ArborX::Details::MinimumSpanningTree<                        \
+      ExecutionSpace::memory_space, ArborX::Details::BoruvkaMode::MST>::       \
+      MinimumSpanningTree(                                                     \
+          ExecutionSpace const &,                                              \
+          Kokkos::View<Point *, ExecutionSpace::memory_space> const &, int,    \
+          float, ArborX::Details::BoruvkaStatistics *,                         \
+          ArborX::Experimental::PhaseTimings *);
+
+#define ARBORX_IMPL_INSTANTIATE_MST(EXTERN, ExecutionSpace)                    \
+  ARBORX_IMPL_INSTANTIATE_MST_CONSTRUCTION(EXTERN, ExecutionSpace,             \
+                                           ArborX::Point)                      \
+  ARBORX_IMPL_INSTANTIATE_MST_CONSTRUCTION(                                    \
+      EXTERN, ExecutionSpace, ArborX::ExperimentalHyperGeometry::Point<2>)
+
+#ifdef ARBORX_ENABLE_EXPLICIT_INSTANTIATION
+ARBORX_IMPL_FOR_EACH_EXECUTION_SPACE(ARBORX_IMPL_INSTANTIATE_MST, extern)
+#endif
+
 #endif
@@ -0,0 +1,92 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_NEAREST_WARM_START_HPP
+#define ARBORX_NEAREST_WARM_START_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // distance
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_Predicates.hpp>
+
+#include <Kokkos_Core.hpp>
+
+namespace ArborX::Experimental
+{
+
+// Predicates of the k nearest neighbors of each geometry, searched within the
+// current distance to the farthest of its neighbors at a previous step, e.g.
+// the results of the same query before the primitives moved. There are still
+// k primitives within that distance, so the neighbors found are exact, but
+// the search prunes from the start instead of once k neighbors are found.
+// The distance is inflated by a factor (1 + inflation) to absorb rounding.
+// Geometries with fewer than k previous neighbors are searched without bound.
+template <class ExecutionSpace, class Geometries, class Primitives,
+          class Offsets, class Indices>
+Kokkos::View<NearestWithin<typename Geometries::value_type> *,
+             typename Geometries::memory_space>
+makeWarmStartedNearestQueries(ExecutionSpace const &space,
+                              Geometries const &geometries,
+                              Primitives const &primitives,
+                              Offsets const &previous_offsets,
+                              Indices const &previous_indices, int k,
+                              float inflation = 1e-5f)
+{
+  static_assert(Kokkos::is_view_v<Geometries> && Geometries::rank == 1);
+  using MemorySpace = typename Geometries::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PrimitivesTag{}, primitives);
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              ExecutionSpace>::value,
+                "Primitives must be accessible from the execution space");
+
+  KokkosExt::ScopedProfileRegion guard(
+      "ArborX::Experimental::makeWarmStartedNearestQueries");
+
+  int const n = geometries.extent(0);
+  ARBORX_ASSERT(previous_offsets.extent_int(0) == n + 1);
+
+  using Geometry = typename Geometries::value_type;
+  Kokkos::View<NearestWithin<Geometry> *, MemorySpace> queries(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::NearestWarmStart::queries"),
+      n);
+  Kokkos::parallel_for(
+      "ArborX::NearestWarmStart::compute_max_distances",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        using Details::distance;
+        auto const &geometry = geometries(i);
+        float max_distance =
+            KokkosExt::ArithmeticTraits::infinity<float>::value;
+        if (previous_offsets(i + 1) - previous_offsets(i) >= k)
+        {
+          max_distance = 0;
+          for (int j = previous_offsets(i); j < previous_offsets(i + 1); ++j)
+            max_distance = KokkosExt::max(
+                max_distance,
+                (float)distance(geometry,
+                                Access::get(primitives, previous_indices(j))));
+          max_distance *= 1 + inflation;
+        }
+        queries(i) = nearest_within(geometry, k, max_distance);
+      });
+  return queries;
+}
+
+} // namespace ArborX::Experimental
+
+#endif
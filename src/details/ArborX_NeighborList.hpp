@@ -12,14 +12,19 @@
 #ifndef ARBORX_NEIGHBOR_LIST_HPP
 #define ARBORX_NEIGHBOR_LIST_HPP
 
-#include <ArborX_DetailsHalfTraversal.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
 #include <ArborX_DetailsKokkosExtViewHelpers.hpp> // reallocWithoutInitializing
 #include <ArborX_DetailsUtils.hpp>                // exclusivePrefixSum
+#include <ArborX_Exception.hpp>
 #include <ArborX_LinearBVH.hpp>
 #include <ArborX_Sphere.hpp>
 
 #include <Kokkos_Core.hpp>
 
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
 namespace ArborX::Experimental
 {
 
@@ -33,115 +38,305 @@ struct NeighborListPredicateGetter
   }
 };
 
-template <class ExecutionSpace, class Primitives, class Offsets, class Indices>
-void findHalfNeighborList(ExecutionSpace const &space,
-                          Primitives const &primitives, float radius,
-                          Offsets &offsets, Indices &indices)
+enum class SelfJoinOutput
 {
-  Kokkos::Profiling::pushRegion("ArborX::Experimental::HalfNeighborList");
+  Half, // each pair (i, j) with i < j is stored once, in row i
+  Full  // each pair is stored in both rows i and j
+};
 
-  using Details::HalfTraversal;
+// Self-join of a hierarchy whose callbacks are passed the indices of the
+// values (e.g. BoundingVolumeHierarchy), stored in compressed row format.
+// The predicates returned by get_predicate must be symmetric. By default,
+// the pairs are counted in a first traversal and written in a second one.
+// A nonzero buffer_size, the estimated number of pairs per value, finds them
+// in a single traversal that appends them to storage sized from the
+// estimate, and only traverses again with storage of the exact size when
+// the estimate was too small. A negative buffer_size throws instead.
+template <class Tree, class ExecutionSpace, class PredicateGetter,
+          class Offsets, class Indices>
+void selfJoin(Tree const &tree, ExecutionSpace const &space,
+              PredicateGetter const &get_predicate, Offsets &offsets,
+              Indices &indices, SelfJoinOutput output = SelfJoinOutput::Full,
+              int buffer_size = 0)
+{
+  Kokkos::Profiling::pushRegion("ArborX::Experimental::SelfJoin");
 
-  using MemorySpace =
-      typename AccessTraits<Primitives, PrimitivesTag>::memory_space;
-  BVH<MemorySpace> bvh(space, primitives);
-  int const n = bvh.size();
+  using MemorySpace = typename Offsets::memory_space;
 
-  Kokkos::Profiling::pushRegion(
-      "ArborX::Experimental::HalfNeighborList::Count");
+  int const n = tree.size();
+  bool const full = (output == SelfJoinOutput::Full);
 
   KokkosExt::reallocWithoutInitializing(space, offsets, n + 1);
   Kokkos::deep_copy(space, offsets, 0);
-  HalfTraversal(
-      space, bvh,
-      KOKKOS_LAMBDA(int, int j) { Kokkos::atomic_increment(&offsets(j)); },
-      NeighborListPredicateGetter{radius});
+
+  Kokkos::View<Kokkos::pair<int, int> *, MemorySpace> pairs;
+  if (buffer_size != 0)
+  {
+    Kokkos::Profiling::pushRegion("ArborX::Experimental::SelfJoin::Append");
+
+    // The pairs are counted in their rows while they are appended, so that
+    // the rows are known even if they do not all fit
+    long long const capacity = (long long)n * std::abs(buffer_size);
+    ARBORX_ASSERT(capacity <= std::numeric_limits<int>::max());
+    Kokkos::View<int, MemorySpace> num_pairs(
+        Kokkos::view_alloc(space, "ArborX::Experimental::SelfJoin::num_pairs"));
+    pairs = decltype(pairs)(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::Experimental::SelfJoin::pairs"),
+        capacity);
+    tree.selfJoin(
+        space, get_predicate, KOKKOS_LAMBDA(int i, int j) {
+          auto const row = KokkosExt::min(i, j);
+          auto const column = KokkosExt::max(i, j);
+          Kokkos::atomic_increment(&offsets(row));
+          if (full)
+            Kokkos::atomic_increment(&offsets(column));
+          int const k = Kokkos::atomic_fetch_inc(&num_pairs());
+          if (k < pairs.extent_int(0))
+            pairs(k) = {row, column};
+        });
+    int const num_pairs_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, num_pairs)();
+    if (num_pairs_host > capacity)
+    {
+      // If it was hard preallocation, we simply throw
+      ARBORX_ASSERT(buffer_size > 0);
+      pairs = {};
+      Kokkos::deep_copy(space, offsets, 0);
+    }
+    else
+      pairs = Kokkos::subview(pairs, std::make_pair(0, num_pairs_host));
+
+    Kokkos::Profiling::popRegion();
+  }
+
+  if (pairs.data() == nullptr)
+  {
+    Kokkos::Profiling::pushRegion("ArborX::Experimental::SelfJoin::Count");
+
+    tree.selfJoin(
+        space, get_predicate, KOKKOS_LAMBDA(int i, int j) {
+          Kokkos::atomic_increment(&offsets(KokkosExt::min(i, j)));
+          if (full)
+            Kokkos::atomic_increment(&offsets(KokkosExt::max(i, j)));
+        });
+
+    Kokkos::Profiling::popRegion();
+  }
+
   exclusivePrefixSum(space, offsets);
   KokkosExt::reallocWithoutInitializing(space, indices,
                                         KokkosExt::lastElement(space, offsets));
 
-  Kokkos::Profiling::popRegion();
-  Kokkos::Profiling::pushRegion("ArborX::Experimental::HalfNeighborList::Fill");
+  Kokkos::Profiling::pushRegion("ArborX::Experimental::SelfJoin::Fill");
 
+  // Both rows of the full output are written directly with their cursors
   auto counts =
       KokkosExt::clone(space, Kokkos::subview(offsets, std::make_pair(0, n)),
-                       "ArborX::Experimental::HalfNeighborList::counts");
-  HalfTraversal(
-      space, bvh,
-      KOKKOS_LAMBDA(int i, int j) {
-        indices(Kokkos::atomic_fetch_inc(&counts(j))) = i;
-      },
-      NeighborListPredicateGetter{radius});
+                       "ArborX::Experimental::SelfJoin::counts");
+  auto const insert = KOKKOS_LAMBDA(int i, int j)
+  {
+    auto const row = KokkosExt::min(i, j);
+    auto const column = KokkosExt::max(i, j);
+    indices(Kokkos::atomic_fetch_inc(&counts(row))) = column;
+    if (full)
+      indices(Kokkos::atomic_fetch_inc(&counts(column))) = row;
+  };
+  if (pairs.data() != nullptr)
+    Kokkos::parallel_for(
+        "ArborX::Experimental::SelfJoin::Fill",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, pairs.extent(0)),
+        KOKKOS_LAMBDA(int k) { insert(pairs(k).first, pairs(k).second); });
+  else
+    tree.selfJoin(space, get_predicate, insert);
 
   Kokkos::Profiling::popRegion();
+
+  Kokkos::Profiling::popRegion();
+}
+
+// Each pair of primitives within the radius of each other is stored once, in
+// the row of the smaller of their indices, i.e. index j > i is in row i
+template <class ExecutionSpace, class Primitives, class Offsets, class Indices>
+void findHalfNeighborList(ExecutionSpace const &space,
+                          Primitives const &primitives, float radius,
+                          Offsets &offsets, Indices &indices,
+                          int buffer_size = 0)
+{
+  Kokkos::Profiling::pushRegion("ArborX::Experimental::HalfNeighborList");
+
+  using MemorySpace =
+      typename AccessTraits<Primitives, PrimitivesTag>::memory_space;
+  BVH<MemorySpace> bvh(space, primitives);
+  selfJoin(bvh, space, NeighborListPredicateGetter{radius}, offsets, indices,
+           SelfJoinOutput::Half, buffer_size);
+
   Kokkos::Profiling::popRegion();
 }
 
 template <class ExecutionSpace, class Primitives, class Offsets, class Indices>
 void findFullNeighborList(ExecutionSpace const &space,
                           Primitives const &primitives, float radius,
-                          Offsets &offsets, Indices &indices)
+                          Offsets &offsets, Indices &indices,
+                          int buffer_size = 0)
 {
   Kokkos::Profiling::pushRegion("ArborX::Experimental::FullNeighborList");
 
-  using Details::HalfTraversal;
-
   using MemorySpace =
       typename AccessTraits<Primitives, PrimitivesTag>::memory_space;
   BVH<MemorySpace> bvh(space, primitives);
-  int const n = bvh.size();
+  selfJoin(bvh, space, NeighborListPredicateGetter{radius}, offsets, indices,
+           SelfJoinOutput::Full, buffer_size);
 
-  Kokkos::Profiling::pushRegion(
-      "ArborX::Experimental::FullNeighborList::Count");
+  Kokkos::Profiling::popRegion();
+}
 
-  KokkosExt::reallocWithoutInitializing(space, offsets, n + 1);
-  Kokkos::deep_copy(space, offsets, 0);
-  HalfTraversal(
-      space, bvh,
-      KOKKOS_LAMBDA(int i, int j) {
-        Kokkos::atomic_increment(&offsets(i));
-        Kokkos::atomic_increment(&offsets(j));
-      },
-      NeighborListPredicateGetter{radius});
-  exclusivePrefixSum(space, offsets);
-  KokkosExt::reallocWithoutInitializing(space, indices,
-                                        KokkosExt::lastElement(space, offsets));
+// Verlet list of the pairs of points within a cutoff distance. The pairs
+// within the cutoff plus a skin distance are searched, and kept until a point
+// moves by more than half the skin from where it was then. Until that
+// happens, the pairs within the cutoff are all among the kept ones, so that
+// updating the list only filters them instead of searching the points again.
+template <class MemorySpace>
+class VerletNeighborList
+{
+public:
+  VerletNeighborList() = default;
 
-  Kokkos::Profiling::popRegion();
-  Kokkos::Profiling::pushRegion("ArborX::Experimental::FullNeighborList::Fill");
+  VerletNeighborList(float cutoff, float skin,
+                     SelfJoinOutput output = SelfJoinOutput::Full)
+      : _cutoff(cutoff)
+      , _skin(skin)
+      , _output(output)
+  {}
 
-  auto counts =
-      KokkosExt::clone(space, Kokkos::subview(offsets, std::make_pair(0, n)),
-                       "ArborX::Experimental::FullNeighborList::counts");
-  HalfTraversal(
-      space, bvh,
-      KOKKOS_LAMBDA(int i, int j) {
-        indices(Kokkos::atomic_fetch_inc(&counts(j))) = i;
-      },
-      NeighborListPredicateGetter{radius});
+  // Update the list with the current positions of the points, which must be
+  // the same points as the previous time. Return whether the pairs within
+  // the cutoff plus the skin were searched again.
+  template <class ExecutionSpace, class Points>
+  bool update(ExecutionSpace const &space, Points const &points);
 
-  Kokkos::Profiling::popRegion();
-  Kokkos::Profiling::pushRegion("ArborX::Experimental::FullNeighborList::Copy");
+  // Pairs within the cutoff in compressed row format, as found by
+  // findFullNeighborList() or findHalfNeighborList()
+  Kokkos::View<int *, MemorySpace> const &offsets() const { return _offsets; }
+  Kokkos::View<int *, MemorySpace> const &indices() const { return _indices; }
+
+  int numberOfRebuilds() const noexcept { return _number_of_rebuilds; }
+
+private:
+  float _cutoff = 0;
+  float _skin = 0;
+  SelfJoinOutput _output = SelfJoinOutput::Full;
+  int _number_of_rebuilds = 0;
+  // Positions of the points when the pairs were searched
+  Kokkos::View<Point *, MemorySpace> _reference_points;
+  // Pairs within the cutoff plus the skin
+  Kokkos::View<int *, MemorySpace> _verlet_offsets;
+  Kokkos::View<int *, MemorySpace> _verlet_indices;
+  Kokkos::View<int *, MemorySpace> _offsets;
+  Kokkos::View<int *, MemorySpace> _indices;
+};
+
+template <class MemorySpace>
+template <class ExecutionSpace, class Points>
+bool VerletNeighborList<MemorySpace>::update(ExecutionSpace const &space,
+                                             Points const &points)
+{
+  using Access = AccessTraits<Points, PrimitivesTag>;
+  static_assert(
+      std::is_same_v<typename Details::AccessTraitsHelper<Access>::type,
+                     Point>,
+      "Verlet neighbor lists are built for points");
+
+  Kokkos::Profiling::pushRegion("ArborX::Experimental::VerletNeighborList");
 
-  auto counts_copy = KokkosExt::clone(space, counts, counts.label() + "_copy");
+  int const n = Access::size(points);
+  auto const &reference_points = _reference_points;
+
+  // Search again when a point moved by more than half the skin, or when the
+  // pairs were never searched
+  bool rebuild = (reference_points.extent_int(0) != n ||
+                  _verlet_offsets.extent_int(0) != n + 1);
+  if (!rebuild)
+  {
+    float max_displacement = 0;
+    Kokkos::parallel_reduce(
+        "ArborX::Experimental::VerletNeighborList::max_displacement",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+        KOKKOS_LAMBDA(int i, float &update) {
+          using Details::distance;
+          update = KokkosExt::max(
+              update, distance(Access::get(points, i), reference_points(i)));
+        },
+        Kokkos::Max<float>(max_displacement));
+    rebuild = (max_displacement > _skin / 2);
+  }
+
+  if (rebuild)
+  {
+    Kokkos::Profiling::pushRegion(
+        "ArborX::Experimental::VerletNeighborList::rebuild");
+
+    if (_output == SelfJoinOutput::Full)
+      findFullNeighborList(space, points, _cutoff + _skin, _verlet_offsets,
+                           _verlet_indices);
+    else
+      findHalfNeighborList(space, points, _cutoff + _skin, _verlet_offsets,
+                           _verlet_indices);
+
+    KokkosExt::reallocWithoutInitializing(space, _reference_points, n);
+    auto const &new_reference_points = _reference_points;
+    Kokkos::parallel_for(
+        "ArborX::Experimental::VerletNeighborList::copy_reference_points",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+        KOKKOS_LAMBDA(int i) {
+          new_reference_points(i) = Access::get(points, i);
+        });
+    ++_number_of_rebuilds;
+
+    Kokkos::Profiling::popRegion();
+  }
+
+  Kokkos::Profiling::pushRegion(
+      "ArborX::Experimental::VerletNeighborList::filter");
+
+  auto const &verlet_offsets = _verlet_offsets;
+  auto const &verlet_indices = _verlet_indices;
+  float const cutoff = _cutoff;
+  auto const within_cutoff = KOKKOS_LAMBDA(int i, int j)
+  {
+    using Details::distance;
+    return distance(Access::get(points, i), Access::get(points, j)) <= cutoff;
+  };
+
+  KokkosExt::reallocWithoutInitializing(space, _offsets, n + 1);
+  auto const &offsets = _offsets;
   Kokkos::parallel_for(
-      "ArborX::Experimental::FullNeighborList::Copy",
-      Kokkos::TeamPolicy<ExecutionSpace>(space, n, Kokkos::AUTO, 1),
-      KOKKOS_LAMBDA(
-          typename Kokkos::TeamPolicy<ExecutionSpace>::member_type const
-              &member) {
-        auto const i = member.league_rank();
-        auto const first = offsets(i);
-        auto const last = counts_copy(i);
-        Kokkos::parallel_for(
-            Kokkos::TeamVectorRange(member, last - first), [&](int j) {
-              int const k = indices(first + j);
-              indices(Kokkos::atomic_fetch_inc(&counts(k))) = i;
-            });
+      "ArborX::Experimental::VerletNeighborList::count",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n + 1),
+      KOKKOS_LAMBDA(int i) {
+        int count = 0;
+        if (i < n)
+          for (int j = verlet_offsets(i); j < verlet_offsets(i + 1); ++j)
+            count += within_cutoff(i, verlet_indices(j));
+        offsets(i) = count;
+      });
+  exclusivePrefixSum(space, offsets);
+  KokkosExt::reallocWithoutInitializing(space, _indices,
+                                        KokkosExt::lastElement(space, offsets));
+  auto const &indices = _indices;
+  Kokkos::parallel_for(
+      "ArborX::Experimental::VerletNeighborList::fill",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        int position = offsets(i);
+        for (int j = verlet_offsets(i); j < verlet_offsets(i + 1); ++j)
+          if (within_cutoff(i, verlet_indices(j)))
+            indices(position++) = verlet_indices(j);
       });
 
   Kokkos::Profiling::popRegion();
   Kokkos::Profiling::popRegion();
+
+  return rebuild;
 }
 
 } // namespace ArborX::Experimental
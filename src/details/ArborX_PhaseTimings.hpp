@@ -0,0 +1,170 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_PHASE_TIMINGS_HPP
+#define ARBORX_PHASE_TIMINGS_HPP
+
+#include <ArborX_Exception.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ArborX
+{
+namespace Experimental
+{
+
+// Sink for the wall-clock times of the phases of the clustering algorithms
+// (DBSCAN, HDBSCAN, minimum spanning tree). The phases carry the labels of
+// the corresponding profiling regions, and can be nested.
+//
+// A phase starts once the work previously submitted to the execution space
+// instance is complete and stops once its own work is. Only that instance is
+// fenced, not the whole device, and only when a sink is given.
+class PhaseTimings
+{
+public:
+  struct Phase
+  {
+    std::string label;
+    // Number of enclosing phases
+    int depth;
+    double seconds;
+  };
+
+  template <typename ExecutionSpace>
+  void start(ExecutionSpace const &space, std::string label)
+  {
+    space.fence("ArborX::PhaseTimings::start");
+    _open.push_back(_phases.size());
+    _phases.push_back({std::move(label), (int)_open.size() - 1, 0.});
+    _timers.emplace_back();
+  }
+
+  template <typename ExecutionSpace>
+  void stop(ExecutionSpace const &space)
+  {
+    ARBORX_ASSERT(!_open.empty());
+    space.fence("ArborX::PhaseTimings::stop");
+    _phases[_open.back()].seconds = _timers.back().seconds();
+    _open.pop_back();
+    _timers.pop_back();
+  }
+
+  // Phases in the order they were started
+  std::vector<Phase> const &phases() const noexcept { return _phases; }
+
+  // Total time of the phases with that label, e.g. over several calls
+  double seconds(std::string const &label) const
+  {
+    double total = 0;
+    for (auto const &phase : _phases)
+      if (phase.label == label)
+        total += phase.seconds;
+    return total;
+  }
+
+  void clear()
+  {
+    ARBORX_ASSERT(_open.empty());
+    _phases.clear();
+  }
+
+  // Write the phases as a JSON object
+  //   {"phases": [{"label": "...", "depth": 0, "seconds": ...}, ...]}
+  void writeJSON(std::ostream &os) const
+  {
+    std::ostringstream out;
+    out << std::setprecision(std::numeric_limits<double>::max_digits10);
+    out << "{\"phases\": [";
+    for (int i = 0; i < (int)_phases.size(); ++i)
+    {
+      auto const &phase = _phases[i];
+      out << (i > 0 ? ", " : "") << "{\"label\": \"";
+      for (char c : phase.label)
+      {
+        if (c == '"' || c == '\\')
+          out << '\\';
+        out << c;
+      }
+      out << "\", \"depth\": " << phase.depth
+          << ", \"seconds\": " << phase.seconds << '}';
+    }
+    out << "]}";
+    os << out.str();
+  }
+
+  std::string toJSON() const
+  {
+    std::ostringstream os;
+    writeJSON(os);
+    return os.str();
+  }
+
+private:
+  std::vector<Phase> _phases;
+  // Indices of the phases being timed, innermost last
+  std::vector<int> _open;
+  std::vector<Kokkos::Timer> _timers;
+};
+
+} // namespace Experimental
+
+namespace Details
+{
+// Push a profiling region, and time it as a phase if there is a sink
+template <typename ExecutionSpace>
+void pushPhase(ExecutionSpace const &space,
+               Experimental::PhaseTimings *timings, std::string const &label)
+{
+  Kokkos::Profiling::pushRegion(label);
+  if (timings)
+    timings->start(space, label);
+}
+
+template <typename ExecutionSpace>
+void popPhase(ExecutionSpace const &space,
+              Experimental::PhaseTimings *timings)
+{
+  if (timings)
+    timings->stop(space);
+  Kokkos::Profiling::popRegion();
+}
+
+template <typename ExecutionSpace>
+class ScopedPhase
+{
+public:
+  ScopedPhase(ExecutionSpace const &space,
+              Experimental::PhaseTimings *timings, std::string const &label)
+      : _space(space)
+      , _timings(timings)
+  {
+    pushPhase(_space, _timings, label);
+  }
+  ~ScopedPhase() { popPhase(_space, _timings); }
+  ScopedPhase(ScopedPhase const &) = delete;
+  ScopedPhase &operator=(ScopedPhase const &) = delete;
+
+private:
+  ExecutionSpace _space;
+  Experimental::PhaseTimings *_timings;
+};
+} // namespace Details
+} // namespace ArborX
+
+#endif
@@ -12,6 +12,11 @@
 #define ARBORX_PREDICATE_HPP
 
 #include <ArborX_DetailsAlgorithms.hpp>
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace ArborX
 {
@@ -26,6 +31,8 @@ namespace Experimental
 {
 struct OrderedSpatialPredicateTag
 {};
+struct VariantPredicateTag
+{};
 } // namespace Experimental
 
 namespace Details
@@ -37,7 +44,8 @@ struct is_valid_predicate_tag
   static constexpr bool value =
       std::is_same<PredicateTag, SpatialPredicateTag>{} ||
       std::is_same<PredicateTag, NearestPredicateTag>{} ||
-      std::is_same<PredicateTag, Experimental::OrderedSpatialPredicateTag>{};
+      std::is_same<PredicateTag, Experimental::OrderedSpatialPredicateTag>{} ||
+      std::is_same<PredicateTag, Experimental::VariantPredicateTag>{};
 };
 } // namespace Details
 
@@ -89,6 +97,8 @@ struct Intersects
 
 namespace Experimental
 {
+// Spatial predicate whose results are found in the order of their distances
+// to the geometry, stopping after the first k of them (all by default)
 template <typename Geometry>
 struct OrderedSpatial
 {
@@ -102,6 +112,12 @@ struct OrderedSpatial
       : _geometry(geometry)
   {}
 
+  KOKKOS_FUNCTION
+  OrderedSpatial(Geometry const &geometry, int k)
+      : _geometry(geometry)
+      , _k(k)
+  {}
+
   template <class OtherGeometry>
   KOKKOS_FUNCTION auto distance(OtherGeometry const &other) const
   {
@@ -110,6 +126,7 @@ struct OrderedSpatial
   }
 
   Geometry _geometry;
+  int _k = KokkosExt::ArithmeticTraits::finite_max<int>::value;
 };
 } // namespace Experimental
 
@@ -132,6 +149,149 @@ KOKKOS_INLINE_FUNCTION int getK(Nearest<Geometry> const &pred)
   return pred._k;
 }
 
+namespace Experimental
+{
+// Nearest predicate that trades accuracy for speed. The neighbors found are
+// within a factor (1 + epsilon) of the distance to the true k-th nearest
+// neighbor. Optionally, the search gives up after visiting a given number of
+// internal nodes, in which case fewer than k neighbors may be found.
+template <typename Geometry>
+struct ApproximateNearest : Nearest<Geometry>
+{
+  KOKKOS_DEFAULTED_FUNCTION
+  ApproximateNearest() = default;
+
+  KOKKOS_FUNCTION
+  ApproximateNearest(Geometry const &geometry, int k, float epsilon,
+                     int max_visited_nodes = 0)
+      : Nearest<Geometry>(geometry, k)
+      , _epsilon(epsilon)
+      , _max_visited_nodes(max_visited_nodes)
+  {}
+
+  float _epsilon = 0.f;
+  int _max_visited_nodes = 0; // no limit
+};
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION ApproximateNearest<Geometry>
+approximate_nearest(Geometry const &geometry, int k, float epsilon,
+                    int max_visited_nodes = 0)
+{
+  return ApproximateNearest<Geometry>(geometry, k, epsilon, max_visited_nodes);
+}
+
+// Nearest predicate that only looks for neighbors within a given distance of
+// the geometry, so that fewer than k may be found. The search starts pruning
+// at that distance instead of once k neighbors have been found.
+template <typename Geometry>
+struct NearestWithin : Nearest<Geometry>
+{
+  KOKKOS_DEFAULTED_FUNCTION
+  NearestWithin() = default;
+
+  KOKKOS_FUNCTION
+  NearestWithin(Geometry const &geometry, int k, float max_distance)
+      : Nearest<Geometry>(geometry, k)
+      , _max_distance(max_distance)
+  {}
+
+  float _max_distance = KokkosExt::ArithmeticTraits::infinity<float>::value;
+};
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION NearestWithin<Geometry>
+nearest_within(Geometry const &geometry, int k, float max_distance)
+{
+  return NearestWithin<Geometry>(geometry, k, max_distance);
+}
+
+// Nearest predicate whose number of neighbors K is known at compile time, so
+// that the traversal keeps the heap of the neighbors found so far in a local
+// array instead of a buffer allocated for all the predicates. Meant for small
+// K, e.g. up to 16 or 32.
+template <typename Geometry, int K>
+struct FixedNearest : Nearest<Geometry>
+{
+  static_assert(K > 0);
+
+  KOKKOS_FUNCTION
+  FixedNearest() { this->_k = K; }
+
+  KOKKOS_FUNCTION
+  FixedNearest(Geometry const &geometry)
+      : Nearest<Geometry>(geometry, K)
+  {}
+};
+
+template <int K, typename Geometry>
+KOKKOS_INLINE_FUNCTION FixedNearest<Geometry, K>
+fixed_nearest(Geometry const &geometry)
+{
+  return FixedNearest<Geometry, K>(geometry);
+}
+} // namespace Experimental
+
+template <typename Geometry, int K>
+KOKKOS_INLINE_FUNCTION constexpr int
+getK(Experimental::FixedNearest<Geometry, K> const &)
+{
+  return K;
+}
+
+namespace Details
+{
+template <typename Geometry, int K>
+std::integral_constant<int, K>
+fixedNumberOfNeighbors(Experimental::FixedNearest<Geometry, K> const *);
+std::integral_constant<int, 0> fixedNumberOfNeighbors(void const *);
+
+// Number of neighbors of the predicates of that type if it is known at compile
+// time, including when they are attached data, and zero otherwise
+template <typename Predicate>
+inline constexpr int fixed_number_of_neighbors_v = decltype(
+    fixedNumberOfNeighbors(std::declval<Predicate const *>()))::value;
+} // namespace Details
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION float getEpsilon(Nearest<Geometry> const &)
+{
+  return 0.f;
+}
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION float
+getEpsilon(Experimental::ApproximateNearest<Geometry> const &pred)
+{
+  return pred._epsilon;
+}
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION int getMaxVisitedNodes(Nearest<Geometry> const &)
+{
+  return 0;
+}
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION int
+getMaxVisitedNodes(Experimental::ApproximateNearest<Geometry> const &pred)
+{
+  return pred._max_visited_nodes;
+}
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION float getMaxDistance(Nearest<Geometry> const &)
+{
+  return KokkosExt::ArithmeticTraits::infinity<float>::value;
+}
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION float
+getMaxDistance(Experimental::NearestWithin<Geometry> const &pred)
+{
+  return pred._max_distance;
+}
+
 namespace Experimental
 {
 template <typename Geometry>
@@ -140,8 +300,22 @@ ordered_intersects(Geometry const &geometry)
 {
   return OrderedSpatial<Geometry>(geometry);
 }
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION OrderedSpatial<Geometry>
+ordered_intersects(Geometry const &geometry, int k)
+{
+  return OrderedSpatial<Geometry>(geometry, k);
+}
 } // namespace Experimental
 
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION int
+getK(Experimental::OrderedSpatial<Geometry> const &pred)
+{
+  return pred._k;
+}
+
 template <typename Geometry>
 KOKKOS_INLINE_FUNCTION Geometry const &
 getGeometry(Nearest<Geometry> const &pred)
@@ -200,6 +374,146 @@ KOKKOS_INLINE_FUNCTION constexpr auto attach(Predicate &&pred, Data &&data)
       std::forward<Predicate>(pred), std::forward<Data>(data)};
 }
 
+namespace Experimental
+{
+// Predicate directed to one of the trees of a forest
+template <typename Predicate>
+struct PredicateWithTreeId : Predicate
+{
+  KOKKOS_DEFAULTED_FUNCTION PredicateWithTreeId() = default;
+  KOKKOS_INLINE_FUNCTION PredicateWithTreeId(Predicate const &pred,
+                                             int tree_id)
+      : Predicate{pred}
+      , _tree_id{tree_id}
+  {}
+  int _tree_id;
+};
+
+template <typename Predicate>
+KOKKOS_INLINE_FUNCTION int
+getTreeId(PredicateWithTreeId<Predicate> const &pred) noexcept
+{
+  return pred._tree_id;
+}
+
+template <typename Predicate>
+KOKKOS_INLINE_FUNCTION constexpr auto inTree(Predicate &&pred, int tree_id)
+{
+  return PredicateWithTreeId<std::decay_t<Predicate>>{
+      std::forward<Predicate>(pred), tree_id};
+}
+} // namespace Experimental
+
+namespace Details
+{
+template <typename... Predicates>
+union PredicateVariantStorage;
+
+template <>
+union PredicateVariantStorage<>
+{
+};
+
+// Storage of the active alternative of a predicate variant, the others being
+// left untouched
+template <typename Predicate, typename... Predicates>
+union PredicateVariantStorage<Predicate, Predicates...>
+{
+  KOKKOS_FUNCTION PredicateVariantStorage() {}
+
+  template <typename Alternative>
+  KOKKOS_FUNCTION void emplace(Alternative const &alternative)
+  {
+    if constexpr (std::is_same_v<Alternative, Predicate>)
+      ::new (static_cast<void *>(&_head)) Predicate(alternative);
+    else
+      _tail.emplace(alternative);
+  }
+
+  template <typename Visitor>
+  KOKKOS_FUNCTION void visit(int index, Visitor &visitor) const
+  {
+    if (index == 0)
+      visitor(_head);
+    else if constexpr (sizeof...(Predicates) > 0)
+      _tail.visit(index - 1, visitor);
+  }
+
+  Predicate _head;
+  PredicateVariantStorage<Predicates...> _tail;
+};
+} // namespace Details
+
+namespace Experimental
+{
+// Predicate holding one of several spatial predicates, or nearest predicates
+// whose number of neighbors is known at compile time (FixedNearest), so that
+// predicates of different kinds are traversed in a single kernel launch, each
+// one along the traversal of the alternative it holds. The callback is passed
+// the variant, whose alternative is given by index() and visit(). Only
+// callback queries are supported.
+template <typename... Predicates>
+struct PredicateVariant
+{
+  using Tag = VariantPredicateTag;
+
+  static_assert(sizeof...(Predicates) > 0);
+  static_assert((std::is_trivially_copyable_v<Predicates> && ...),
+                "The alternatives of a predicate variant must be trivially "
+                "copyable");
+  static_assert(((std::is_same_v<typename Predicates::Tag,
+                                 Details::SpatialPredicateTag> ||
+                  Details::fixed_number_of_neighbors_v<Predicates> > 0) &&
+                 ...),
+                "The alternatives of a predicate variant must be spatial "
+                "predicates or nearest predicates with a fixed number of "
+                "neighbors");
+
+  KOKKOS_DEFAULTED_FUNCTION PredicateVariant() = default;
+
+  template <typename Predicate,
+            typename = std::enable_if_t<
+                (std::is_same_v<Predicate, Predicates> || ...)>>
+  KOKKOS_FUNCTION PredicateVariant(Predicate const &predicate)
+  {
+    int index = 0;
+    ((std::is_same_v<Predicate, Predicates> ? false : (++index, true)) &&
+     ...);
+    _index = index;
+    _storage.emplace(predicate);
+  }
+
+  // Index of the alternative held, -1 if none
+  KOKKOS_FUNCTION int index() const { return _index; }
+
+  // Call the visitor with the alternative held, if any
+  template <typename Visitor>
+  KOKKOS_FUNCTION void visit(Visitor &&visitor) const
+  {
+    if (_index >= 0)
+      _storage.visit(_index, visitor);
+  }
+
+  int _index = -1;
+  Details::PredicateVariantStorage<Predicates...> _storage;
+};
+} // namespace Experimental
+
+// The geometry of a predicate variant stands for the centroid of the geometry
+// of its alternative, which is all that ordering the predicates needs
+template <typename... Predicates>
+KOKKOS_INLINE_FUNCTION auto
+getGeometry(Experimental::PredicateVariant<Predicates...> const &pred)
+{
+  using Point = std::common_type_t<decltype(Details::returnCentroid(
+      getGeometry(std::declval<Predicates const &>())))...>;
+  Point centroid{};
+  pred.visit([&centroid](auto const &alternative) {
+    centroid = Details::returnCentroid(getGeometry(alternative));
+  });
+  return centroid;
+}
+
 } // namespace ArborX
 
 #endif
@@ -0,0 +1,101 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_SORT_RESULTS_PER_PREDICATE_HPP
+#define ARBORX_SORT_RESULTS_PER_PREDICATE_HPP
+
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp> // is_accessible_from
+#include <ArborX_DetailsKokkosExtBitManipulation.hpp>     // bit_cast
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_DetailsSortUtils.hpp> // sortObjects, applyPermutations
+#include <ArborX_Exception.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace ArborX::Experimental
+{
+
+/** Sort the results of each predicate, as output by a query in compressed
+ * row storage, in increasing order of the floating point key of each value.
+ * The results of predicate i are values(offsets(i)) to values(offsets(i+1)-1);
+ * the offsets are left unchanged. Results with equal keys come out in an
+ * unspecified order.
+ *
+ * This is a segmented sort: the index of the predicate and the bits of the
+ * key, in an order that matches the order of floats, are packed into a single
+ * 64-bit integer, so that all the segments are sorted at once by a radix sort
+ * of integers rather than by comparing values.
+ *
+ * \param space Execution space
+ * \param offsets Offsets of the results of each predicate
+ * \param values Results of the query, permuted in place
+ * \param key Function object returning the key of a value, e.g. the distance
+ *        along a ray at which a box is entered
+ */
+template <typename ExecutionSpace, typename Offsets, typename Values,
+          typename Key>
+void sortResultsPerPredicate(ExecutionSpace const &space,
+                             Offsets const &offsets, Values &values,
+                             Key const &key)
+{
+  static_assert(Kokkos::is_view_v<Offsets> && Offsets::rank == 1);
+  static_assert(Kokkos::is_view_v<Values> && Values::rank == 1);
+  using MemorySpace = typename Values::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  static_assert(KokkosExt::is_accessible_from<typename Offsets::memory_space,
+                                              ExecutionSpace>::value);
+  static_assert(
+      std::is_convertible_v<std::invoke_result_t<
+                                Key, typename Values::value_type const &>,
+                            float>,
+      "The key of a value must be convertible to float");
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::sortResultsPerPredicate");
+
+  int const num_predicates = offsets.extent(0) > 0 ? offsets.extent(0) - 1 : 0;
+  auto const num_values = values.extent(0);
+  if (num_predicates == 0 || num_values == 0)
+    return;
+
+  static_assert(sizeof(float) == sizeof(std::uint32_t));
+  constexpr int shift = 32;
+
+  Kokkos::View<std::uint64_t *, MemorySpace> keys(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::sortResultsPerPredicate::keys"),
+      num_values);
+  Kokkos::parallel_for(
+      "ArborX::sortResultsPerPredicate::pack_keys",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_predicates),
+      KOKKOS_LAMBDA(int i) {
+        for (int j = offsets(i); j < offsets(i + 1); ++j)
+        {
+          auto bits = KokkosExt::bit_cast<std::uint32_t>((float)key(values(j)));
+          // Flip all bits of negative numbers, and only the sign bit of
+          // positive ones
+          bits ^= (bits & 0x80000000u) ? 0xffffffffu : 0x80000000u;
+          keys(j) = ((std::uint64_t)i << shift) + bits;
+        }
+      });
+
+  // The predicate index being the most significant part of the keys, the
+  // values do not leave the segment of their predicate
+  auto const permutation = Details::sortObjects(space, keys);
+  Details::applyPermutations(space, permutation, values);
+}
+
+} // namespace ArborX::Experimental
+
+#endif
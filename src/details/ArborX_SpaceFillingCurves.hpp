@@ -12,14 +12,20 @@
 #ifndef ARBORX_SPACE_FILLING_CURVES_HPP
 #define ARBORX_SPACE_FILLING_CURVES_HPP
 
+#include <ArborX_AccessTraits.hpp>
 #include <ArborX_DetailsAlgorithms.hpp>
+#include <ArborX_DetailsHilbertCode.hpp>
 #include <ArborX_DetailsMortonCode.hpp>
 #include <ArborX_HyperBox.hpp>
 #include <ArborX_HyperPoint.hpp>
 
+#include <Kokkos_Core.hpp>
 #include <Kokkos_DetectionIdiom.hpp>
 #include <Kokkos_Macros.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace ArborX
 {
 namespace Experimental
@@ -69,6 +75,219 @@ struct Morton64
   }
 };
 
+// Only available in 2D and 3D
+struct Hilbert32
+{
+  template <typename Box, typename Point,
+            std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                             GeometryTraits::is_point<Point>{}> * = nullptr>
+  KOKKOS_FUNCTION auto operator()(Box const &scene_bounding_box, Point p) const
+  {
+    Details::translateAndScale(p, p, scene_bounding_box);
+    return Details::hilbert32(p);
+  }
+  template <typename Box, class Geometry,
+            std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                             !GeometryTraits::is_point<Geometry>{}> * = nullptr>
+  KOKKOS_FUNCTION auto operator()(Box const &scene_bounding_box,
+                                  Geometry const &geometry) const
+  {
+    auto p = Details::returnCentroid(geometry);
+    Details::translateAndScale(p, p, scene_bounding_box);
+    return Details::hilbert32(p);
+  }
+};
+
+// Only available in 2D and 3D
+struct Hilbert64
+{
+  template <typename Box, typename Point,
+            std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                             GeometryTraits::is_point<Point>{}> * = nullptr>
+  KOKKOS_FUNCTION auto operator()(Box const &scene_bounding_box, Point p) const
+  {
+    Details::translateAndScale(p, p, scene_bounding_box);
+    return Details::hilbert64(p);
+  }
+  template <typename Box, class Geometry,
+            std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                             !GeometryTraits::is_point<Geometry>{}> * = nullptr>
+  KOKKOS_FUNCTION auto operator()(Box const &scene_bounding_box,
+                                  Geometry const &geometry) const
+  {
+    auto p = Details::returnCentroid(geometry);
+    Details::translateAndScale(p, p, scene_bounding_box);
+    return Details::hilbert64(p);
+  }
+};
+
+// Morton curve in the space spanned by the (at most three) principal axes of
+// the data. In high dimensions, a Morton code only has a few bits per
+// dimension left and barely orders the primitives, whereas data typically
+// varies mostly along a few directions. The curve is data-dependent and must
+// be obtained from makePrincipalAxesMorton64(). The scene bounding box passed
+// at construction of the hierarchy is ignored.
+template <int DIM>
+struct PrincipalAxesMorton64
+{
+  static constexpr int NUM_AXES = (DIM < 3 ? DIM : 3);
+
+  float _origin[DIM] = {};
+  float _axes[NUM_AXES][DIM] = {};
+  // Bounds of the projections of the data onto the axes, with the same
+  // extent along all of them
+  ExperimentalHyperGeometry::Box<NUM_AXES> _bounds;
+
+  template <typename Point>
+  KOKKOS_FUNCTION auto project(Point const &p) const
+  {
+    static_assert(GeometryTraits::dimension_v<Point> == DIM);
+    ExperimentalHyperGeometry::Point<NUM_AXES> q;
+    for (int a = 0; a < NUM_AXES; ++a)
+    {
+      float dot = 0;
+      for (int d = 0; d < DIM; ++d)
+        dot += (p[d] - _origin[d]) * _axes[a][d];
+      q[a] = dot;
+    }
+    return q;
+  }
+
+  template <typename Box, typename Geometry,
+            std::enable_if_t<GeometryTraits::is_box<Box>{}> * = nullptr>
+  KOKKOS_FUNCTION auto operator()(Box const &, Geometry const &geometry) const
+  {
+    auto q = project(Details::returnCentroid(geometry));
+    Details::translateAndScale(q, q, _bounds);
+    return Details::morton64(q);
+  }
+};
+
+template <typename ExecutionSpace, typename Primitives>
+auto makePrincipalAxesMorton64(ExecutionSpace const &space,
+                               Primitives const &primitives)
+{
+  using Access = AccessTraits<Primitives, PrimitivesTag>;
+  using MemorySpace = typename Access::memory_space;
+  constexpr int DIM = GeometryTraits::dimension_v<
+      typename Details::AccessTraitsHelper<Access>::type>;
+  using Curve = PrincipalAxesMorton64<DIM>;
+  constexpr int NUM_AXES = Curve::NUM_AXES;
+
+  Kokkos::Profiling::pushRegion("ArborX::PrincipalAxesMorton64");
+
+  int const n = Access::size(primitives);
+  Curve curve;
+  if (n == 0)
+  {
+    Kokkos::Profiling::popRegion();
+    return curve;
+  }
+
+  // Covariance of the centroids, with the mean in the last column
+  using TeamPolicy = Kokkos::TeamPolicy<ExecutionSpace>;
+  Kokkos::View<double * [DIM + 1], MemorySpace> moments(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::PrincipalAxesMorton64::moments"),
+      DIM);
+  Kokkos::parallel_for(
+      "ArborX::PrincipalAxesMorton64::mean",
+      TeamPolicy(space, DIM, Kokkos::AUTO),
+      KOKKOS_LAMBDA(typename TeamPolicy::member_type const &member) {
+        int const d = member.league_rank();
+        double sum = 0;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange(member, n),
+            [&](int i, double &partial_sum) {
+              partial_sum +=
+                  Details::returnCentroid(Access::get(primitives, i))[d];
+            },
+            sum);
+        Kokkos::single(Kokkos::PerTeam(member),
+                       [&]() { moments(d, DIM) = sum / n; });
+      });
+  Kokkos::parallel_for(
+      "ArborX::PrincipalAxesMorton64::covariance",
+      TeamPolicy(space, DIM * DIM, Kokkos::AUTO),
+      KOKKOS_LAMBDA(typename TeamPolicy::member_type const &member) {
+        int const a = member.league_rank() / DIM;
+        int const b = member.league_rank() % DIM;
+        if (b < a)
+          return;
+        double const mean_a = moments(a, DIM);
+        double const mean_b = moments(b, DIM);
+        double sum = 0;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange(member, n),
+            [&](int i, double &partial_sum) {
+              auto const p =
+                  Details::returnCentroid(Access::get(primitives, i));
+              partial_sum += (p[a] - mean_a) * (p[b] - mean_b);
+            },
+            sum);
+        Kokkos::single(Kokkos::PerTeam(member), [&]() {
+          moments(a, b) = sum / n;
+          moments(b, a) = sum / n;
+        });
+      });
+  auto moments_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, moments);
+
+  // Leading eigenvectors of the covariance by power iteration with deflation
+  for (int d = 0; d < DIM; ++d)
+    curve._origin[d] = moments_host(d, DIM);
+  for (int a = 0; a < NUM_AXES; ++a)
+  {
+    double v[DIM];
+    for (int d = 0; d < DIM; ++d)
+      v[d] = (d == a ? 1. : 1e-3) / std::sqrt(1 + (DIM - 1) * 1e-6);
+    double eigenvalue = 0;
+    for (int iter = 0; iter < 100; ++iter)
+    {
+      double w[DIM] = {};
+      for (int d = 0; d < DIM; ++d)
+        for (int e = 0; e < DIM; ++e)
+          w[d] += moments_host(d, e) * v[e];
+      double norm = 0;
+      for (int d = 0; d < DIM; ++d)
+        norm += w[d] * w[d];
+      norm = std::sqrt(norm);
+      if (norm == 0)
+        break; // no variance left, keep the current direction
+      for (int d = 0; d < DIM; ++d)
+        v[d] = w[d] / norm;
+      eigenvalue = norm;
+    }
+    for (int d = 0; d < DIM; ++d)
+      for (int e = 0; e < DIM; ++e)
+        moments_host(d, e) -= eigenvalue * v[d] * v[e];
+    for (int d = 0; d < DIM; ++d)
+      curve._axes[a][d] = v[d];
+  }
+
+  using Box = ExperimentalHyperGeometry::Box<NUM_AXES>;
+  Box bounds;
+  Kokkos::parallel_reduce(
+      "ArborX::PrincipalAxesMorton64::bounds",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i, Box &update) {
+        update += curve.project(
+            Details::returnCentroid(Access::get(primitives, i)));
+      },
+      Kokkos::Sum<Box>{bounds});
+  // Use the same scale for all the axes so that the minor ones do not get
+  // stretched and take precedence in the ordering
+  float extent = 0;
+  for (int a = 0; a < NUM_AXES; ++a)
+    extent = std::max(extent, bounds.maxCorner()[a] - bounds.minCorner()[a]);
+  for (int a = 0; a < NUM_AXES; ++a)
+    bounds.maxCorner()[a] = bounds.minCorner()[a] + extent;
+  curve._bounds = bounds;
+
+  Kokkos::Profiling::popRegion();
+  return curve;
+}
+
 } // namespace Experimental
 
 namespace Details
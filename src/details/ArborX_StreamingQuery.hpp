@@ -0,0 +1,196 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_STREAMING_QUERY_HPP
+#define ARBORX_STREAMING_QUERY_HPP
+
+#include <ArborX_AccessTraits.hpp>
+#include <ArborX_Callbacks.hpp> // DefaultCallback
+#include <ArborX_CrsGraphWrapper.hpp>
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_TraversalPolicy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm> // min
+#include <type_traits>
+#include <utility>
+
+namespace ArborX::Experimental
+{
+
+/** Query predicates residing in host memory, e.g. read from disk, chunk by
+ * chunk. Each chunk of at most chunk_size predicates is gathered into pinned
+ * host memory, copied to the device, queried, and its results are copied back
+ * to pinned host memory. The chunks alternate between two instances of the
+ * execution space with buffers of their own, so that the copies of a chunk
+ * overlap with the traversal of the next one.
+ *
+ * The results of each chunk are handed over, in the order of the chunks, as
+ * receiver(first, offsets, values) on the host, where first is the index of
+ * the first predicate of the chunk and offsets and values are the results of
+ * the chunk in CRS format, as returned by query(). The views are only valid
+ * during the call.
+ *
+ * \code
+ * ArborX::Experimental::queryStreaming<int>(
+ *     space, bvh, host_predicates, ArborX::Details::DefaultCallback{},
+ *     [&](int first, auto const &offsets, auto const &indices) {
+ *       write(first, offsets, indices);
+ *     },
+ *     1 << 20);
+ * \endcode
+ */
+template <typename Value, typename ExecutionSpace, typename Tree,
+          typename Predicates, typename Callback, typename Receiver>
+void queryStreaming(ExecutionSpace const &space, Tree const &tree,
+                    Predicates const &predicates, Callback const &callback,
+                    Receiver const &receiver, int chunk_size,
+                    TraversalPolicy const &policy = TraversalPolicy())
+{
+  using MemorySpace = typename Tree::memory_space;
+  static_assert(
+      KokkosExt::is_accessible_from<MemorySpace, ExecutionSpace>::value);
+  Details::check_valid_access_traits(PredicatesTag{}, predicates);
+  using Access = AccessTraits<Predicates, PredicatesTag>;
+  using HostExecutionSpace = Kokkos::DefaultHostExecutionSpace;
+  static_assert(KokkosExt::is_accessible_from<typename Access::memory_space,
+                                              HostExecutionSpace>::value,
+                "Predicates must be accessible from the host");
+
+  // The results of a chunk are copied back as soon as they are found
+  ARBORX_ASSERT(!policy._future);
+  ARBORX_ASSERT(chunk_size > 0);
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::Experimental::queryStreaming");
+
+  using Predicate = std::decay_t<decltype(Access::get(
+      std::declval<Predicates const &>(), 0))>;
+#ifdef KOKKOS_HAS_SHARED_HOST_PINNED_SPACE
+  using PinnedSpace = Kokkos::SharedHostPinnedSpace;
+#else
+  using PinnedSpace = Kokkos::HostSpace;
+#endif
+
+  int const n = Access::size(predicates);
+  chunk_size = std::min(chunk_size, n);
+
+  // Buffers of a chunk, and the first predicate of the chunk whose results
+  // are still to be handed over, if any
+  struct Slot
+  {
+    ExecutionSpace space;
+    Kokkos::View<Predicate *, PinnedSpace> host_predicates;
+    Kokkos::View<Predicate *, MemorySpace> predicates;
+    Kokkos::View<Value *, MemorySpace> values;
+    Kokkos::View<int *, MemorySpace> offsets;
+    Kokkos::View<Value *, PinnedSpace> host_values;
+    Kokkos::View<int *, PinnedSpace> host_offsets;
+    int first = -1;
+    int size = 0;
+  };
+  auto const instances = Kokkos::Experimental::partition_space(space, 1, 1);
+  Slot slots[2];
+  for (int s = 0; s < 2; ++s)
+  {
+    auto &slot = slots[s];
+    slot.space = instances[s];
+    slot.host_predicates = Kokkos::View<Predicate *, PinnedSpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                           "ArborX::queryStreaming::host_predicates"),
+        chunk_size);
+    slot.predicates = Kokkos::View<Predicate *, MemorySpace>(
+        Kokkos::view_alloc(slot.space, Kokkos::WithoutInitializing,
+                           "ArborX::queryStreaming::predicates"),
+        chunk_size);
+    slot.values = Kokkos::View<Value *, MemorySpace>(
+        "ArborX::queryStreaming::values", 0);
+    slot.offsets = Kokkos::View<int *, MemorySpace>(
+        "ArborX::queryStreaming::offsets", 0);
+    slot.host_offsets = Kokkos::View<int *, PinnedSpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                           "ArborX::queryStreaming::host_offsets"),
+        chunk_size + 1);
+  }
+
+  // Once the copies of a chunk are done, its buffers may be reused
+  auto const hand_over = [&](Slot &slot) {
+    if (slot.first < 0)
+      return;
+    slot.space.fence("ArborX::queryStreaming::wait_for_chunk");
+    auto const offsets =
+        Kokkos::subview(slot.host_offsets, Kokkos::make_pair(0, slot.size + 1));
+    auto const values = Kokkos::subview(
+        slot.host_values, Kokkos::make_pair(0, offsets(slot.size)));
+    receiver(slot.first, offsets, values);
+    slot.first = -1;
+  };
+
+  int chunk = 0;
+  for (int first = 0; first < n; first += chunk_size, ++chunk)
+  {
+    auto &slot = slots[chunk % 2];
+    hand_over(slot);
+
+    int const size = std::min(chunk_size, n - first);
+    auto const range = Kokkos::make_pair(0, size);
+
+    auto const host_chunk = Kokkos::subview(slot.host_predicates, range);
+    Kokkos::parallel_for(
+        "ArborX::queryStreaming::gather",
+        Kokkos::RangePolicy<HostExecutionSpace>(HostExecutionSpace{}, 0, size),
+        KOKKOS_LAMBDA(int i) {
+          host_chunk(i) = Access::get(predicates, first + i);
+        });
+    HostExecutionSpace{}.fence();
+    auto const device_chunk = Kokkos::subview(slot.predicates, range);
+    Kokkos::deep_copy(slot.space, device_chunk, host_chunk);
+
+    ArborX::query(tree, slot.space, device_chunk, callback, slot.values,
+                  slot.offsets, policy);
+
+    int const n_values = slot.values.extent(0);
+    if (slot.host_values.extent_int(0) < n_values)
+      slot.host_values = Kokkos::View<Value *, PinnedSpace>(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                             "ArborX::queryStreaming::host_values"),
+          n_values);
+    Kokkos::deep_copy(slot.space,
+                      Kokkos::subview(slot.host_offsets,
+                                      Kokkos::make_pair(0, size + 1)),
+                      slot.offsets);
+    Kokkos::deep_copy(
+        slot.space,
+        Kokkos::subview(slot.host_values, Kokkos::make_pair(0, n_values)),
+        slot.values);
+    slot.first = first;
+    slot.size = size;
+  }
+  hand_over(slots[chunk % 2]);
+  hand_over(slots[(chunk + 1) % 2]);
+}
+
+template <typename ExecutionSpace, typename Tree, typename Predicates,
+          typename Receiver>
+void queryStreaming(ExecutionSpace const &space, Tree const &tree,
+                    Predicates const &predicates, Receiver const &receiver,
+                    int chunk_size,
+                    TraversalPolicy const &policy = TraversalPolicy())
+{
+  queryStreaming<int>(space, tree, predicates, Details::DefaultCallback{},
+                      receiver, chunk_size, policy);
+}
+
+} // namespace ArborX::Experimental
+
+#endif
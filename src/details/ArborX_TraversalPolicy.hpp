@@ -12,10 +12,316 @@
 #ifndef ARBORX_TRAVERSAL_POLICY_HPP
 #define ARBORX_TRAVERSAL_POLICY_HPP
 
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_Exception.hpp>
+#include <ArborX_Workspace.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <any>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace ArborX
 {
+namespace Details
+{
+struct QueryFutureAccess;
+}
+
 namespace Experimental
 {
+
+// Completion of the queries executed asynchronously, see
+// TraversalPolicy::setAsynchronous(). Copies share the same state.
+class QueryFuture
+{
+public:
+  // Block until the last query attached to the future is done. Throw if some
+  // of its results did not fit in the buffer.
+  void wait() const
+  {
+    auto wait = std::exchange(_state->wait, nullptr);
+    if (wait)
+      wait();
+  }
+
+private:
+  friend struct Details::QueryFutureAccess;
+
+  struct State
+  {
+    std::function<void()> wait;
+  };
+  std::shared_ptr<State> _state = std::make_shared<State>();
+};
+
+// Storage for the heaps of nearest queries that is kept alive across query
+// calls and grown as needed, so that repeated queries do not allocate. Copies
+// share the same storage. It must not be used by queries that may execute
+// concurrently.
+class NearestQueryWorkspace
+{
+public:
+  template <typename MemorySpace, typename ExecutionSpace>
+  auto buffer(ExecutionSpace const &space, std::size_t size) const
+  {
+    return get<Kokkos::pair<int, float>, MemorySpace>(
+        space, _storage->buffer, "ArborX::NearestQueryWorkspace::buffer", size);
+  }
+
+  template <typename MemorySpace, typename ExecutionSpace>
+  auto offset(ExecutionSpace const &space, std::size_t size) const
+  {
+    return get<int, MemorySpace>(space, _storage->offset,
+                                 "ArborX::NearestQueryWorkspace::offset", size);
+  }
+
+private:
+  template <typename T, typename MemorySpace, typename ExecutionSpace>
+  static Kokkos::View<T *, MemorySpace> get(ExecutionSpace const &space,
+                                            std::any &storage,
+                                            std::string const &label,
+                                            std::size_t size)
+  {
+    using View = Kokkos::View<T *, MemorySpace>;
+    auto *view = std::any_cast<View>(&storage);
+    if (view == nullptr || view->size() < size)
+      storage = View(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing, label), size);
+    return std::any_cast<View>(storage);
+  }
+
+  struct Storage
+  {
+    std::any buffer;
+    std::any offset;
+  };
+  std::shared_ptr<Storage> _storage = std::make_shared<Storage>();
+};
+
+// Permutation of the predicates along the space-filling curve that is kept
+// across query calls, so that a fixed set of predicates queried against
+// successive hierarchies is only sorted once. It is computed by the first
+// query using it unless a custom ordering of the predicates is given. The
+// following queries must pass the same number of predicates. Copies share
+// the same permutation.
+class PredicatePermutation
+{
+public:
+  PredicatePermutation() = default;
+
+  template <typename MemorySpace>
+  explicit PredicatePermutation(
+      Kokkos::View<unsigned int *, MemorySpace> const &permutation)
+  {
+    _storage->permutation = permutation;
+  }
+
+  // Discard the permutation, e.g. when the predicates have changed, for the
+  // next query to compute it again
+  void reset() const { _storage->permutation.reset(); }
+
+  template <typename MemorySpace, typename Compute>
+  Kokkos::View<unsigned int *, MemorySpace> get(int size,
+                                                Compute const &compute) const
+  {
+    using View = Kokkos::View<unsigned int *, MemorySpace>;
+    if (!_storage->permutation.has_value())
+      _storage->permutation = View(compute());
+    auto const *view = std::any_cast<View>(&_storage->permutation);
+    ARBORX_ASSERT(view != nullptr && (int)view->size() == size);
+    return *view;
+  }
+
+private:
+  struct Storage
+  {
+    std::any permutation;
+  };
+  std::shared_ptr<Storage> _storage = std::make_shared<Storage>();
+};
+
+// State of an asynchronous query with storage that is replayed, e.g. once per
+// time step, see TraversalPolicy::setQueryPlan(). The temporary storage of the
+// query, the buffer of the heaps of nearest predicates and the permutation of
+// the predicates are kept across the calls, so that once the first call is
+// done, the following ones neither allocate nor wait for the device. Their
+// kernels may then be captured in a CUDA or HIP graph. The permutation is
+// kept even if the predicates move, until reset. A plan serves a single
+// query at a time, so that a sequence of queries uses one plan per query.
+// Copies share the same state.
+class QueryPlan
+{
+public:
+  QueryFuture const &future() const { return _storage->future; }
+
+  NearestQueryWorkspace const &nearestWorkspace() const
+  {
+    return _storage->nearest_workspace;
+  }
+
+  PredicatePermutation const &predicatePermutation() const
+  {
+    return _storage->predicate_permutation;
+  }
+
+  // Discard the storage and the permutation, e.g. when the number of
+  // predicates has changed, for the next call to set them up again
+  void reset() const
+  {
+    _storage->views.clear();
+    _storage->nearest_workspace = NearestQueryWorkspace();
+    _storage->predicate_permutation.reset();
+  }
+
+  // View of the given extents kept under the label, only allocated, without
+  // initializing, when missing or of another size
+  template <typename View, typename ExecutionSpace, typename... Extents>
+  View view(ExecutionSpace const &space, std::string const &label,
+            Extents... extents) const
+  {
+    auto &storage = _storage->views[label];
+    auto *view = std::any_cast<View>(&storage);
+    if (view == nullptr || view->size() != (std::size_t(1) * ... * extents))
+      storage = View(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing, label),
+          extents...);
+    return std::any_cast<View>(storage);
+  }
+
+  // Keep the view under the label for the next call
+  template <typename View>
+  void keep(std::string const &label, View const &view) const
+  {
+    _storage->views[label] = view;
+  }
+
+private:
+  struct Storage
+  {
+    QueryFuture future;
+    NearestQueryWorkspace nearest_workspace;
+    PredicatePermutation predicate_permutation;
+    std::map<std::string, std::any> views;
+  };
+  std::shared_ptr<Storage> _storage = std::make_shared<Storage>();
+};
+
+// Statistics of the traversals of the queries using them, accumulated across
+// query calls until reset. For each counter, the queries are counted in a
+// histogram of logarithmic bins: bin 0 holds the queries for which the
+// counter is zero, and bin b > 0 those for which it is in [2^(b-1), 2^b).
+// They are recorded on a single memory space. Copies share the same
+// statistics.
+class TraversalStatistics
+{
+public:
+  enum Counter
+  {
+    internal_node_visits,
+    leaf_tests,
+    callback_invocations,
+    max_stack_depth,
+    early_exits,
+    number_of_counters
+  };
+
+  static constexpr int number_of_bins = 33;
+
+  // Numbers of queries for each counter and bin, the last column holding
+  // the total of the counter over all the queries
+  template <typename MemorySpace, typename ExecutionSpace>
+  Kokkos::View<unsigned long long **, Kokkos::LayoutRight, MemorySpace>
+  counts(ExecutionSpace const &space) const
+  {
+    using View =
+        Kokkos::View<unsigned long long **, Kokkos::LayoutRight, MemorySpace>;
+    if (auto const *view = std::any_cast<View>(&_storage->counts))
+      return *view;
+    View view(Kokkos::view_alloc(space, "ArborX::TraversalStatistics::counts"),
+              (int)number_of_counters, number_of_bins + 1);
+    _storage->counts = view;
+    _storage->copy_to_host = [view]() {
+      return Kokkos::View<unsigned long long **, Kokkos::LayoutRight,
+                          Kokkos::HostSpace>(
+          Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, view));
+    };
+    return view;
+  }
+
+  std::vector<unsigned long long> histogram(Counter counter) const
+  {
+    std::vector<unsigned long long> histogram(number_of_bins);
+    if (_storage->copy_to_host)
+    {
+      auto const counts = _storage->copy_to_host();
+      for (int bin = 0; bin < number_of_bins; ++bin)
+        histogram[bin] = counts(counter, bin);
+    }
+    return histogram;
+  }
+
+  unsigned long long total(Counter counter) const
+  {
+    if (!_storage->copy_to_host)
+      return 0;
+    return _storage->copy_to_host()(counter, number_of_bins);
+  }
+
+  // Lets the traversals also count the visits of each node of the hierarchy,
+  // i.e. the tests of its bounding volume. This is costlier than the
+  // histograms, as the counts are incremented atomically during the
+  // traversals.
+  void enableNodeVisits() const { _storage->record_node_visits = true; }
+
+  // Numbers of visits of each node of a hierarchy with the given number of
+  // nodes, the leaves coming first, as numbered by the traversals. The view
+  // is empty unless the visits are recorded. It is reallocated, and the
+  // counts reset, if the number of nodes changed.
+  template <typename MemorySpace, typename ExecutionSpace>
+  Kokkos::View<unsigned long long *, MemorySpace>
+  nodeVisits(ExecutionSpace const &space, int num_nodes) const
+  {
+    using View = Kokkos::View<unsigned long long *, MemorySpace>;
+    if (!_storage->record_node_visits)
+      return View();
+    if (auto const *view = std::any_cast<View>(&_storage->node_visits);
+        view && view->extent_int(0) == num_nodes)
+      return *view;
+    View view(
+        Kokkos::view_alloc(space, "ArborX::TraversalStatistics::node_visits"),
+        num_nodes);
+    _storage->node_visits = view;
+    return view;
+  }
+
+  void reset() const
+  {
+    _storage->counts.reset();
+    _storage->copy_to_host = nullptr;
+    _storage->node_visits.reset();
+  }
+
+private:
+  struct Storage
+  {
+    bool record_node_visits = false;
+    std::any node_visits;
+    std::any counts;
+    std::function<Kokkos::View<unsigned long long **, Kokkos::LayoutRight,
+                               Kokkos::HostSpace>()>
+        copy_to_host;
+  };
+  std::shared_ptr<Storage> _storage = std::make_shared<Storage>();
+};
+
 struct TraversalPolicy
 {
   // Buffer size lets a user provide an upper bound for the number of results
@@ -33,6 +339,161 @@ struct TraversalPolicy
   // Sort predicates allows disabling predicate sorting.
   bool _sort_predicates = true;
 
+  // Hilbert predicate sorting lets predicates be sorted along the Hilbert
+  // curve rather than the Morton curve, which has better locality. It is
+  // ignored outside of 2D and 3D.
+  bool _hilbert_predicate_sorting = false;
+
+  // Predicate permutation lets the ordering of the predicates be reused
+  // across calls rather than computed for each of them, or be given by the
+  // user. It is ignored if predicate sorting is disabled.
+  std::optional<PredicatePermutation> _predicate_permutation;
+
+  // Adaptive predicate sorting lets the predicates be sorted only if it is
+  // estimated to pay off. Small batches are not sorted, nor those whose
+  // consecutive predicates are already mostly in order along the Morton
+  // curve over a sample of them. The decision is reported as a profiling
+  // region. It is ignored if predicate sorting is disabled or a predicate
+  // permutation is given.
+  bool _adaptive_predicate_sorting = false;
+
+  // Packet size lets spatial predicates be traversed in packets of
+  // consecutive predicates that follow a common path through the hierarchy,
+  // one packet per team (a warp on GPUs). A node is visited if any predicate
+  // in the packet needs it, so that it is loaded once for the whole packet.
+  // This pays off for coherent predicates, e.g. sorted along a space-filling
+  // curve or primary rays. The default value zero disables it. It is ignored
+  // for other kinds of predicates.
+  int _packet_size = 0;
+
+  // Leaf blocks let spatial predicates test the consecutive leaves linked by
+  // their ropes, e.g. siblings, by blocks of up to eight, all the leaves of a
+  // block being tested before the callback is invoked on any of them. In
+  // linear hierarchies, whose subtrees have consecutive leaves, a block spans
+  // the largest subtree of up to eight leaves that the traversal goes down
+  // into, the rest of whose internal nodes are then not visited. The tests of
+  // a block are free of branches out of the loop, which compilers can
+  // vectorize on CPUs. It is only used on execution spaces that can access
+  // host memory, and is ignored for other kinds of predicates.
+  bool _leaf_blocks = false;
+
+  // Nearest scratch memory lets the heap of the k nearest neighbors found so
+  // far and the stack of nodes left to visit be kept in the scratch memory
+  // of teams (shared memory on GPUs) rather than in a global buffer. It
+  // falls back to the global buffer when the largest k does not fit. It is
+  // ignored for other kinds of predicates.
+  bool _nearest_scratch_memory = false;
+
+  // Nearest stackless lets nearest predicates be traversed along the ropes
+  // without a stack of nodes left to visit, which takes local memory that
+  // spills on GPUs. The heap is first filled with the leaves around the one
+  // reached by descending into the closest children, and the subtrees
+  // farther than the k-th neighbor found so far are then skipped. The
+  // children are not visited closest first, so that more nodes are visited.
+  // It takes precedence over the nearest scratch memory, and is ignored for
+  // other kinds of predicates.
+  bool _nearest_stackless = false;
+
+  // Nearest workspace lets the buffer holding the heaps of nearest queries be
+  // reused across calls rather than allocated for each of them.
+  std::optional<NearestQueryWorkspace> _nearest_workspace;
+
+  // Number of neighbors lets the user guarantee that all the nearest
+  // predicates search for the same number k of neighbors. It allows skipping
+  // the computation of the offsets of the heaps in the buffer, along with the
+  // device-to-host copy of the buffer size. The default value zero means that
+  // k may differ from a predicate to another.
+  int _number_of_neighbors = 0;
+
+  // Single pass lets spatial queries with storage append their results to a
+  // pool of chunks as they are found, rather than counting them first. They
+  // are then gathered in CRS format, so that the tree is traversed only once
+  // unless the pool turns out to be too small. The buffer size is then used
+  // as an estimate of the number of results per query to size the pool. If
+  // it is negative, an exception is thrown when the pool is too small. It is
+  // ignored for nearest predicates, whose results are always gathered in a
+  // single pass.
+  bool _single_pass = false;
+
+  // Max results per predicate lets spatial queries with storage keep at most
+  // that many results per predicate, the traversal of a predicate exiting
+  // early once they are found. The results are written in a single pass to
+  // buffers of that size allocated up front, and are then compacted. Which
+  // results are kept depends on the order of the traversal. The buffer size,
+  // single pass and batch size are then ignored. The default value zero keeps
+  // all the results. It cannot be combined with asynchronous queries, and is
+  // ignored for other kinds of predicates.
+  int _max_results_per_predicate = 0;
+
+  // Asynchronous lets queries with storage return without ever waiting for
+  // the device, so that they can be pipelined with other work on other
+  // execution space instances. The results are ready once the future has
+  // been waited on. All sizes must be known in advance: the buffer size for
+  // spatial predicates and the number of neighbors for nearest predicates.
+  // The results are stored per query in a buffer of that size and are then
+  // compacted in place, so that the output view may be larger than the
+  // number of results, given by the last offset. Predicates are not sorted.
+  std::optional<QueryFuture> _future;
+
+  // Query plan lets an asynchronous query with storage be replayed without
+  // allocating nor waiting for the device after its first call. It sets the
+  // future, the nearest workspace and the predicate permutation to those of
+  // the plan. Unlike other asynchronous queries, the predicates are sorted
+  // (by the first call only) unless predicate sorting is disabled.
+  std::optional<QueryPlan> _query_plan;
+
+  // Statistics let the spatial and nearest traversals of the hierarchies
+  // record, for each predicate, the internal nodes visited, the leaves
+  // tested, the callbacks invoked, the maximum depth of the stack, and
+  // whether the traversal exited early. Packets are not used meanwhile.
+  // Without them, the traversals are compiled without any counter.
+  std::optional<TraversalStatistics> _statistics;
+
+  // Batch size lets queries with storage traverse at most that many
+  // predicates at a time, so that the temporary storage of the traversals
+  // (the ordering of the predicates, the heaps of nearest predicates) only
+  // spans a batch. The results are counted batch by batch first, and then
+  // written batch by batch directly at their final location in the output,
+  // so that the tree is traversed twice and the outputs of the batches never
+  // need to be stitched together. The buffer size and single pass are then
+  // ignored. The default value zero disables batching. It cannot be combined
+  // with asynchronous queries.
+  int _batch_size = 0;
+
+  // Temporary memory limit lets the batch size be chosen so that the
+  // temporary storage of the traversal of a batch fits in that many bytes.
+  // The default value zero means no limit. It is ignored if the batch size
+  // is given.
+  std::size_t _temporary_memory_limit = 0;
+
+  // Dynamic chunk size lets host backends hand the predicates out to the
+  // threads in chunks of that many as the threads become idle, rather than
+  // splitting them evenly ahead of time. This balances the load when the
+  // predicates are skewed, e.g. when those in dense regions find many more
+  // results than the others. The default value zero keeps the static
+  // schedule. It is ignored on devices, whose hardware already schedules
+  // the warps dynamically, except by persistent threads, and by packets and
+  // team callbacks.
+  int _dynamic_chunk_size = 0;
+
+  // Persistent threads let the spatial, nearest and ordered traversals, and
+  // the self-joins, be run on devices by that many threads only, which pull
+  // the predicates from a global counter in chunks of the dynamic chunk size
+  // (one at a time if it is zero) until all of them are traversed. A warp
+  // then stays busy as long as any predicate is left, instead of idling
+  // while a few of its lanes traverse costly predicates. It should be a few
+  // times the number of threads resident on the device. The default value
+  // zero launches one thread per predicate. It is ignored on host backends,
+  // and by packets and team callbacks.
+  int _persistent_threads = 0;
+
+  // Workspace lets the temporaries of the queries (the counts of the results,
+  // the ordering of the predicates, the heaps of nearest predicates) be taken
+  // from storage kept across calls rather than allocated for each of them.
+  // Without it, the default workspace is used if set. The nearest workspace
+  // takes precedence for the heaps.
+  std::optional<Workspace> _workspace;
+
   TraversalPolicy &setBufferSize(int buffer_size)
   {
     _buffer_size = buffer_size;
@@ -44,9 +505,187 @@ struct TraversalPolicy
     _sort_predicates = sort_predicates;
     return *this;
   }
+
+  TraversalPolicy &setHilbertPredicateSorting(bool hilbert_predicate_sorting)
+  {
+    _hilbert_predicate_sorting = hilbert_predicate_sorting;
+    return *this;
+  }
+
+  TraversalPolicy &
+  setAdaptivePredicateSorting(bool adaptive_predicate_sorting)
+  {
+    _adaptive_predicate_sorting = adaptive_predicate_sorting;
+    return *this;
+  }
+
+  TraversalPolicy &
+  setPredicatePermutation(PredicatePermutation const &predicate_permutation)
+  {
+    _predicate_permutation = predicate_permutation;
+    return *this;
+  }
+
+  TraversalPolicy &setPacketSize(int packet_size)
+  {
+    _packet_size = packet_size;
+    return *this;
+  }
+
+  TraversalPolicy &setLeafBlocks(bool leaf_blocks)
+  {
+    _leaf_blocks = leaf_blocks;
+    return *this;
+  }
+
+  TraversalPolicy &setNearestScratchMemory(bool nearest_scratch_memory)
+  {
+    _nearest_scratch_memory = nearest_scratch_memory;
+    return *this;
+  }
+
+  TraversalPolicy &setNearestStackless(bool nearest_stackless)
+  {
+    _nearest_stackless = nearest_stackless;
+    return *this;
+  }
+
+  TraversalPolicy &
+  setNearestWorkspace(NearestQueryWorkspace const &nearest_workspace)
+  {
+    _nearest_workspace = nearest_workspace;
+    return *this;
+  }
+
+  TraversalPolicy &setNumberOfNeighbors(int number_of_neighbors)
+  {
+    _number_of_neighbors = number_of_neighbors;
+    return *this;
+  }
+
+  TraversalPolicy &setSinglePass(bool single_pass)
+  {
+    _single_pass = single_pass;
+    return *this;
+  }
+
+  TraversalPolicy &setMaxResultsPerPredicate(int max_results_per_predicate)
+  {
+    _max_results_per_predicate = max_results_per_predicate;
+    return *this;
+  }
+
+  TraversalPolicy &setAsynchronous(QueryFuture const &future)
+  {
+    _future = future;
+    return *this;
+  }
+
+  TraversalPolicy &setQueryPlan(QueryPlan const &query_plan)
+  {
+    _query_plan = query_plan;
+    _future = query_plan.future();
+    _nearest_workspace = query_plan.nearestWorkspace();
+    _predicate_permutation = query_plan.predicatePermutation();
+    return *this;
+  }
+
+  TraversalPolicy &setStatistics(TraversalStatistics const &statistics)
+  {
+    _statistics = statistics;
+    return *this;
+  }
+
+  TraversalPolicy &setBatchSize(int batch_size)
+  {
+    _batch_size = batch_size;
+    return *this;
+  }
+
+  TraversalPolicy &setTemporaryMemoryLimit(std::size_t temporary_memory_limit)
+  {
+    _temporary_memory_limit = temporary_memory_limit;
+    return *this;
+  }
+
+  TraversalPolicy &setDynamicChunkSize(int dynamic_chunk_size)
+  {
+    _dynamic_chunk_size = dynamic_chunk_size;
+    return *this;
+  }
+
+  TraversalPolicy &setPersistentThreads(int persistent_threads)
+  {
+    _persistent_threads = persistent_threads;
+    return *this;
+  }
+
+  TraversalPolicy &setWorkspace(Workspace const &workspace)
+  {
+    _workspace = workspace;
+    return *this;
+  }
 };
 
 } // namespace Experimental
+
+namespace Details
+{
+// Launch the traversal of n predicates, or points, with a dynamic schedule on
+// host backends if the chunk size is positive, or with persistent threads on
+// devices if requested, see TraversalPolicy::_dynamic_chunk_size and
+// TraversalPolicy::_persistent_threads
+template <typename... Traits, typename ExecutionSpace, typename Functor>
+void launchTraversal(std::string const &label, ExecutionSpace const &space,
+                     int n, Experimental::TraversalPolicy const &policy,
+                     Functor const &functor)
+{
+  static_assert(sizeof...(Traits) <= 1, "Only a work tag may be given");
+  if constexpr (Kokkos::SpaceAccessibility<ExecutionSpace,
+                                           Kokkos::HostSpace>::accessible)
+  {
+    if (policy._dynamic_chunk_size > 0)
+    {
+      Kokkos::parallel_for(
+          label,
+          Kokkos::RangePolicy<ExecutionSpace, Traits...,
+                              Kokkos::Schedule<Kokkos::Dynamic>>(
+              space, 0, n, Kokkos::ChunkSize(policy._dynamic_chunk_size)),
+          functor);
+      return;
+    }
+  }
+  else
+  {
+    if (policy._persistent_threads > 0 && n > 0)
+    {
+      int const chunk_size = KokkosExt::max(policy._dynamic_chunk_size, 1);
+      // Cannot overflow as long as n + persistent_threads * chunk_size does
+      // not, since each thread pulls at most one chunk past the end
+      Kokkos::View<int, typename ExecutionSpace::memory_space> next(
+          Kokkos::view_alloc(space, "ArborX::TreeTraversal::next_predicate"));
+      Kokkos::parallel_for(
+          label,
+          Kokkos::RangePolicy<ExecutionSpace>(
+              space, 0, KokkosExt::min(policy._persistent_threads, n)),
+          KOKKOS_LAMBDA(int) {
+            for (int begin = Kokkos::atomic_fetch_add(&next(), chunk_size);
+                 begin < n;
+                 begin = Kokkos::atomic_fetch_add(&next(), chunk_size))
+            {
+              int const end = KokkosExt::min(begin + chunk_size, n);
+              for (int i = begin; i < end; ++i)
+                functor(Traits{}..., i);
+            }
+          });
+      return;
+    }
+  }
+  Kokkos::parallel_for(
+      label, Kokkos::RangePolicy<ExecutionSpace, Traits...>(space, 0, n),
+      functor);
+}
+} // namespace Details
 } // namespace ArborX
 
 #endif
@@ -0,0 +1,99 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_WORKSPACE_HPP
+#define ARBORX_WORKSPACE_HPP
+
+#include <Kokkos_Core.hpp>
+
+#include <any>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace ArborX::Experimental
+{
+
+// Storage for the temporaries of the constructions and queries given it,
+// kept alive across the calls and grown as needed, so that repeated calls
+// neither allocate nor free device memory once warmed up (cudaMalloc and
+// cudaFree synchronize the device). Each temporary is kept under its label,
+// so that the storage is as large as the largest of each at once. The calls
+// using a workspace must execute one after the other on the same execution
+// space instance, since a call reuses the storage of the previous one
+// without waiting for it, and asynchronous queries use it until they are
+// waited on. Copies share the same storage.
+class Workspace
+{
+public:
+  // View of n elements under the label, uninitialized and only allocated
+  // when missing, of another type, or too small
+  template <typename View, typename ExecutionSpace>
+  View view(ExecutionSpace const &space, std::string const &label,
+            std::size_t n) const
+  {
+    static_assert(Kokkos::is_view_v<View> && View::rank == 1);
+    using Storage = Kokkos::View<typename View::non_const_value_type *,
+                                 typename View::memory_space>;
+    auto &storage = _storage->views[label];
+    auto *view = std::any_cast<Storage>(&storage);
+    if (view == nullptr || view->size() < n)
+      storage = Storage(
+          Kokkos::view_alloc(space, Kokkos::WithoutInitializing, label), n);
+    return Kokkos::subview(std::any_cast<Storage>(storage),
+                           Kokkos::make_pair(std::size_t(0), n));
+  }
+
+  // Free all the storage
+  void release() const { _storage->views.clear(); }
+
+private:
+  struct Storage
+  {
+    std::map<std::string, std::any> views;
+  };
+  std::shared_ptr<Storage> _storage = std::make_shared<Storage>();
+};
+
+// Workspace of the constructions and queries that are not given one, none by
+// default. It is shared by all of them, which must then all execute on the
+// same execution space instance.
+inline std::optional<Workspace> &defaultWorkspace()
+{
+  static std::optional<Workspace> workspace;
+  return workspace;
+}
+
+} // namespace ArborX::Experimental
+
+namespace ArborX::Details
+{
+
+// Temporary view of n elements, taken from the workspace if any or else from
+// the default one, and otherwise allocated. It is not initialized.
+template <typename View, typename ExecutionSpace>
+View temporaryView(ExecutionSpace const &space,
+                   std::optional<Experimental::Workspace> const &workspace,
+                   std::string const &label, std::size_t n)
+{
+  if (workspace)
+    return workspace->template view<View>(space, label, n);
+  if (auto const &default_workspace = Experimental::defaultWorkspace())
+    return default_workspace->template view<View>(space, label, n);
+  return View(Kokkos::view_alloc(space, Kokkos::WithoutInitializing, label),
+              n);
+}
+
+} // namespace ArborX::Details
+
+#endif
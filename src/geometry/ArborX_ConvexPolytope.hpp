@@ -0,0 +1,220 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+#ifndef ARBORX_CONVEX_POLYTOPE_HPP
+#define ARBORX_CONVEX_POLYTOPE_HPP
+
+#include <ArborX_Box.hpp>
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_KDOP.hpp>
+#include <ArborX_Point.hpp>
+#include <ArborX_Ray.hpp> // Vector
+
+#include <Kokkos_Array.hpp>
+#include <Kokkos_Macros.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace ArborX
+{
+namespace Experimental
+{
+
+// Half-space of the points x such that dot(normal, x) <= offset. The normal
+// points outwards and does not need to be of unit length.
+struct HalfSpace
+{
+  Vector _normal = {};
+  float _offset = 0;
+
+  KOKKOS_FUNCTION
+  constexpr Vector &normal() { return _normal; }
+
+  KOKKOS_FUNCTION
+  constexpr Vector const &normal() const { return _normal; }
+
+  KOKKOS_FUNCTION
+  constexpr float &offset() { return _offset; }
+
+  KOKKOS_FUNCTION
+  constexpr float const &offset() const { return _offset; }
+};
+
+// Convex polytope given as the intersection of at most N half-spaces, e.g. a
+// view frustum with N = 6. It does not need to be bounded.
+//
+// The tests against a geometry take a mask of the planes left to test. The
+// planes found to contain the geometry entirely are removed from it, so that
+// the tree traversal does not test them again for the descendants of a node.
+template <int N>
+struct ConvexPolytope
+{
+  static_assert(N > 0 && N <= 32, "the planes must fit in a 32-bit mask");
+
+  using Mask = std::uint32_t;
+
+  Kokkos::Array<HalfSpace, N> _half_spaces = {};
+  int _size = 0;
+
+  KOKKOS_FUNCTION
+  constexpr int size() const { return _size; }
+
+  KOKKOS_FUNCTION
+  constexpr HalfSpace const &halfSpace(int i) const
+  {
+    return _half_spaces[i];
+  }
+
+  KOKKOS_FUNCTION
+  constexpr void add(HalfSpace const &half_space)
+  {
+    assert(_size < N);
+    _half_spaces[_size++] = half_space;
+  }
+
+  // Mask of all the planes of the polytope
+  KOKKOS_FUNCTION
+  constexpr Mask allPlanes() const
+  {
+    return (_size == 32 ? ~Mask(0) : (Mask(1) << _size) - 1);
+  }
+};
+
+template <typename Point,
+          std::enable_if_t<GeometryTraits::is_point<Point>{} &&
+                           GeometryTraits::dimension_v<Point> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION constexpr float signedDistance(HalfSpace const &h,
+                                                      Point const &point)
+{
+  return h.normal()[0] * point[0] + h.normal()[1] * point[1] +
+         h.normal()[2] * point[2] - h.offset();
+}
+
+template <int N, typename Point,
+          std::enable_if_t<GeometryTraits::is_point<Point>{} &&
+                           GeometryTraits::dimension_v<Point> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION bool
+intersects(ConvexPolytope<N> const &polytope, Point const &point,
+           typename ConvexPolytope<N>::Mask &mask)
+{
+  for (int i = 0; i < polytope.size(); ++i)
+    if ((mask >> i) & 1)
+    {
+      if (signedDistance(polytope.halfSpace(i), point) > 0)
+        return false;
+      mask &= ~(typename ConvexPolytope<N>::Mask(1) << i);
+    }
+  return true;
+}
+
+// The box is tested against the planes one at a time, through its corners
+// closest to and farthest from each of them. This is conservative: a box
+// outside of the polytope but not of any of its half-spaces is not rejected.
+// Empty boxes are never hit.
+template <int N, typename Box,
+          std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                           GeometryTraits::dimension_v<Box> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION bool
+intersects(ConvexPolytope<N> const &polytope, Box const &box,
+           typename ConvexPolytope<N>::Mask &mask)
+{
+  for (int i = 0; i < polytope.size(); ++i)
+    if ((mask >> i) & 1)
+    {
+      auto const &h = polytope.halfSpace(i);
+      float near = -h.offset();
+      float far = -h.offset();
+      for (int d = 0; d < 3; ++d)
+      {
+        // Components along which the normal vanishes are skipped, the
+        // corners of empty boxes being infinite
+        if (h.normal()[d] > 0)
+        {
+          near += h.normal()[d] * box.minCorner()[d];
+          far += h.normal()[d] * box.maxCorner()[d];
+        }
+        else if (h.normal()[d] < 0)
+        {
+          near += h.normal()[d] * box.maxCorner()[d];
+          far += h.normal()[d] * box.minCorner()[d];
+        }
+      }
+      if (near > 0 || !(near <= far))
+        return false;
+      if (far <= 0)
+        mask &= ~(typename ConvexPolytope<N>::Mask(1) << i);
+    }
+  return true;
+}
+
+template <int N, typename Sphere,
+          std::enable_if_t<GeometryTraits::is_sphere<Sphere>{} &&
+                           GeometryTraits::dimension_v<Sphere> == 3> * =
+              nullptr>
+KOKKOS_INLINE_FUNCTION bool
+intersects(ConvexPolytope<N> const &polytope, Sphere const &sphere,
+           typename ConvexPolytope<N>::Mask &mask)
+{
+  for (int i = 0; i < polytope.size(); ++i)
+    if ((mask >> i) & 1)
+    {
+      auto const &h = polytope.halfSpace(i);
+      float const distance = signedDistance(h, sphere.centroid());
+      float const radius =
+          sphere.radius() * std::sqrt(dotProduct(h.normal(), h.normal()));
+      if (distance > radius)
+        return false;
+      if (distance <= -radius)
+        mask &= ~(typename ConvexPolytope<N>::Mask(1) << i);
+    }
+  return true;
+}
+
+// The k-DOP is tested through its bounding box, which it lies within
+template <int N, int k>
+KOKKOS_INLINE_FUNCTION bool
+intersects(ConvexPolytope<N> const &polytope, KDOP<k> const &kdop,
+           typename ConvexPolytope<N>::Mask &mask)
+{
+  return intersects(polytope, static_cast<Box>(kdop), mask);
+}
+
+template <int N, typename Geometry>
+KOKKOS_INLINE_FUNCTION bool intersects(ConvexPolytope<N> const &polytope,
+                                       Geometry const &geometry)
+{
+  auto mask = polytope.allPlanes();
+  return intersects(polytope, geometry, mask);
+}
+
+// Average of the points of the planes closest to the origin. It is only meant
+// as a location by which to sort the predicates.
+template <int N>
+KOKKOS_INLINE_FUNCTION Point returnCentroid(ConvexPolytope<N> const &polytope)
+{
+  Point c{0, 0, 0};
+  for (int i = 0; i < polytope.size(); ++i)
+  {
+    auto const &h = polytope.halfSpace(i);
+    float const scale =
+        h.offset() / dotProduct(h.normal(), h.normal()) / polytope.size();
+    for (int d = 0; d < 3; ++d)
+      c[d] += scale * h.normal()[d];
+  }
+  return c;
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
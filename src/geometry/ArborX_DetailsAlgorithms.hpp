@@ -15,9 +15,15 @@
 #include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
 #include <ArborX_DetailsKokkosExtMinMaxOperations.hpp> // min, max
 #include <ArborX_GeometryTraits.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperOBB.hpp>
+#include <ArborX_HyperPoint.hpp>
 
 #include <Kokkos_Macros.hpp>
-#include <Kokkos_MathematicalFunctions.hpp> // isfinite
+#include <Kokkos_MathematicalFunctions.hpp> // abs, isfinite
+
+#include <type_traits>
+#include <utility> // declval
 
 namespace ArborX
 {
@@ -27,9 +33,12 @@ namespace Details
 namespace Dispatch
 {
 using GeometryTraits::BoxTag;
+using GeometryTraits::CapsuleTag;
 using GeometryTraits::KDOPTag;
+using GeometryTraits::OBBTag;
 using GeometryTraits::PointTag;
 using GeometryTraits::SphereTag;
+using GeometryTraits::TriangleTag;
 
 template <typename Tag, typename Geometry>
 struct equals;
@@ -46,9 +55,19 @@ struct expand;
 template <typename Tag1, typename Tag2, typename Geometry1, typename Geometry2>
 struct intersects;
 
+template <typename Tag1, typename Tag2, typename Geometry1, typename Geometry2>
+struct contains;
+
 template <typename Tag, typename Geometry>
 struct centroid;
 
+// Type in which to compute the distance between two geometries, so that the
+// distance is exact in the precision of the most precise of them
+template <typename Geometry1, typename Geometry2>
+using distance_coordinate_t = std::common_type_t<
+    typename GeometryTraits::coordinate_type<Geometry1>::type,
+    typename GeometryTraits::coordinate_type<Geometry2>::type>;
+
 } // namespace Dispatch
 
 template <typename Geometry>
@@ -67,8 +86,8 @@ KOKKOS_INLINE_FUNCTION constexpr bool isValid(Geometry const &geometry)
 }
 
 template <typename Geometry1, typename Geometry2>
-KOKKOS_INLINE_FUNCTION float distance(Geometry1 const &geometry1,
-                                      Geometry2 const &geometry2)
+KOKKOS_INLINE_FUNCTION auto distance(Geometry1 const &geometry1,
+                                     Geometry2 const &geometry2)
 {
   static_assert(GeometryTraits::dimension_v<Geometry1> ==
                 GeometryTraits::dimension_v<Geometry2>);
@@ -100,6 +119,27 @@ KOKKOS_INLINE_FUNCTION constexpr bool intersects(Geometry1 const &geometry1,
                                                            geometry2);
 }
 
+// Whether geometry1 contains all of geometry2, boundary included
+template <typename Geometry1, typename Geometry2>
+KOKKOS_INLINE_FUNCTION constexpr bool contains(Geometry1 const &geometry1,
+                                               Geometry2 const &geometry2)
+{
+  static_assert(GeometryTraits::dimension_v<Geometry1> ==
+                GeometryTraits::dimension_v<Geometry2>);
+  return Dispatch::contains<typename GeometryTraits::tag<Geometry1>::type,
+                            typename GeometryTraits::tag<Geometry2>::type,
+                            Geometry1, Geometry2>::apply(geometry1, geometry2);
+}
+
+// Detects the pairs of geometries for which contains() is implemented
+template <typename Geometry1, typename Geometry2>
+using ContainsArchetypeExpression =
+    decltype(Dispatch::contains<typename GeometryTraits::tag<Geometry1>::type,
+                                typename GeometryTraits::tag<Geometry2>::type,
+                                Geometry1, Geometry2>::
+                 apply(std::declval<Geometry1 const &>(),
+                       std::declval<Geometry2 const &>()));
+
 template <typename Geometry>
 KOKKOS_INLINE_FUNCTION decltype(auto) returnCentroid(Geometry const &geometry)
 {
@@ -107,6 +147,614 @@ KOKKOS_INLINE_FUNCTION decltype(auto) returnCentroid(Geometry const &geometry)
                             Geometry>::apply(geometry);
 }
 
+// Squared distances from a point, which spare the square root when the
+// distance is only compared, e.g. to the radius of a sphere. They compute in
+// the same precision as distance().
+
+template <typename Point1, typename Point2>
+KOKKOS_INLINE_FUNCTION auto pointPointDistanceSquared(Point1 const &a,
+                                                      Point2 const &b)
+{
+  using Coordinate = Dispatch::distance_coordinate_t<Point1, Point2>;
+  constexpr int DIM = GeometryTraits::dimension_v<Point1>;
+  Coordinate distance_squared = 0;
+  for (int d = 0; d < DIM; ++d)
+  {
+    Coordinate const tmp = Coordinate(b[d]) - Coordinate(a[d]);
+    distance_squared += tmp * tmp;
+  }
+  return distance_squared;
+}
+
+template <typename Point, typename Box>
+KOKKOS_INLINE_FUNCTION auto pointBoxDistanceSquared(Point const &point,
+                                                    Box const &box)
+{
+  using Coordinate = Dispatch::distance_coordinate_t<Point, Box>;
+  constexpr int DIM = GeometryTraits::dimension_v<Point>;
+  Coordinate distance_squared = 0;
+  for (int d = 0; d < DIM; ++d)
+  {
+    Coordinate tmp = 0;
+    if (point[d] < box.minCorner()[d])
+      tmp = Coordinate(box.minCorner()[d]) - Coordinate(point[d]);
+    else if (point[d] > box.maxCorner()[d])
+      tmp = Coordinate(point[d]) - Coordinate(box.maxCorner()[d]);
+    distance_squared += tmp * tmp;
+  }
+  return distance_squared;
+}
+
+// Squared distance from the point to the closest point of the triangle,
+// found from the Voronoi region of the triangle the point projects into (see
+// Ericson, Real-Time Collision Detection, 5.1.5). This holds in any dimension.
+template <typename Point, typename Triangle>
+KOKKOS_INLINE_FUNCTION auto
+pointTriangleDistanceSquared(Point const &point, Triangle const &triangle)
+{
+  using Coordinate = Dispatch::distance_coordinate_t<Point, Triangle>;
+  constexpr int DIM = GeometryTraits::dimension_v<Point>;
+
+  auto const &a = triangle.a;
+  auto const &b = triangle.b;
+  auto const &c = triangle.c;
+  auto const dot = [&](auto const &u0, auto const &u1, auto const &v0,
+                       auto const &v1) {
+    Coordinate result = 0;
+    for (int d = 0; d < DIM; ++d)
+      result += (Coordinate(u1[d]) - Coordinate(u0[d])) *
+                (Coordinate(v1[d]) - Coordinate(v0[d]));
+    return result;
+  };
+  // Squared distance to the point a + v (b - a) + w (c - a)
+  auto const distance_squared = [&](Coordinate v, Coordinate w) {
+    Coordinate result = 0;
+    for (int d = 0; d < DIM; ++d)
+    {
+      Coordinate const tmp = Coordinate(a[d]) +
+                             v * (Coordinate(b[d]) - Coordinate(a[d])) +
+                             w * (Coordinate(c[d]) - Coordinate(a[d])) -
+                             Coordinate(point[d]);
+      result += tmp * tmp;
+    }
+    return result;
+  };
+
+  Coordinate const d1 = dot(a, b, a, point);
+  Coordinate const d2 = dot(a, c, a, point);
+  if (d1 <= 0 && d2 <= 0)
+    return distance_squared(0, 0); // vertex a
+
+  Coordinate const d3 = dot(a, b, b, point);
+  Coordinate const d4 = dot(a, c, b, point);
+  if (d3 >= 0 && d4 <= d3)
+    return distance_squared(1, 0); // vertex b
+
+  Coordinate const vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0)
+    return distance_squared(d1 / (d1 - d3), 0); // edge ab
+
+  Coordinate const d5 = dot(a, b, c, point);
+  Coordinate const d6 = dot(a, c, c, point);
+  if (d6 >= 0 && d5 <= d6)
+    return distance_squared(0, 1); // vertex c
+
+  Coordinate const vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0)
+    return distance_squared(0, d2 / (d2 - d6)); // edge ac
+
+  Coordinate const va = d3 * d6 - d5 * d4;
+  if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+  {
+    Coordinate const w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    return distance_squared(1 - w, w); // edge bc
+  }
+
+  // Degenerate triangles have no interior, and the point is then closest to
+  // either of the edges
+  Coordinate const denominator = va + vb + vc;
+  if (!(denominator > 0))
+  {
+    using KokkosExt::max;
+    using KokkosExt::min;
+    auto const t = [](Coordinate x, Coordinate y) {
+      return (y > 0 ? min(max(x / y, Coordinate(0)), Coordinate(1))
+                    : Coordinate(0));
+    };
+    Coordinate const ab = dot(a, b, a, b);
+    Coordinate const ac = dot(a, c, a, c);
+    Coordinate const bc = dot(b, c, b, c);
+    Coordinate const s = t(d4 - d3, bc);
+    return min(min(distance_squared(t(d1, ab), 0),
+                   distance_squared(0, t(d2, ac))),
+               distance_squared(1 - s, s));
+  }
+
+  return distance_squared(vb / denominator, vc / denominator); // interior
+}
+
+// Metric used by the traversals that only compare distances from a geometry
+// to indexables and to bounding volumes of the given types. The comparable
+// distances are the squared distances when the geometry is a point and the
+// others are points, boxes or triangles, and the distances themselves
+// otherwise. They are converted back with toDistance() only when a distance is
+// reported.
+template <typename Geometry, typename... Others>
+struct ComparableDistance
+{
+  static constexpr bool is_squared =
+      GeometryTraits::is_point<Geometry>{} &&
+      ((GeometryTraits::is_point<Others>{} ||
+        GeometryTraits::is_box<Others>{} ||
+        GeometryTraits::is_triangle<Others>{}) &&
+       ...);
+
+  template <typename Other>
+  KOKKOS_FUNCTION static auto apply(Geometry const &geometry,
+                                    Other const &other)
+  {
+    if constexpr (!is_squared)
+      return distance(geometry, other);
+    else if constexpr (GeometryTraits::is_point<Other>{})
+      return pointPointDistanceSquared(geometry, other);
+    else if constexpr (GeometryTraits::is_triangle<Other>{})
+      return pointTriangleDistanceSquared(geometry, other);
+    else
+      return pointBoxDistanceSquared(geometry, other);
+  }
+
+  template <typename T>
+  KOKKOS_FUNCTION static T fromDistance(T distance)
+  {
+    if constexpr (is_squared)
+      return distance * distance;
+    else
+      return distance;
+  }
+
+  template <typename T>
+  KOKKOS_FUNCTION static T toDistance(T comparable_distance)
+  {
+    if constexpr (is_squared)
+      return std::sqrt(comparable_distance);
+    else
+      return comparable_distance;
+  }
+
+  // Comparable distance that is not smaller than that of any other geometry
+  // within the given distance despite the rounding of the squares, so that
+  // pruning against it never discards what comparing distances would keep
+  template <typename T>
+  KOKKOS_FUNCTION static T upperBound(T distance)
+  {
+    if constexpr (is_squared)
+      return distance * distance *
+             (1 + 8 * KokkosExt::ArithmeticTraits::epsilon<T>::value);
+    else
+      return distance;
+  }
+};
+
+// Helpers for the oriented boxes and the capsules. They all compute in single
+// precision.
+
+template <int DIM, typename Vector1, typename Vector2>
+KOKKOS_INLINE_FUNCTION float innerProduct(Vector1 const &u, Vector2 const &v)
+{
+  float result = 0;
+  for (int d = 0; d < DIM; ++d)
+    result += u[d] * v[d];
+  return result;
+}
+
+// squared distance from a point to the segment [a, b]
+template <typename Point1, typename Point2, typename Point3>
+KOKKOS_FUNCTION float segmentPointDistanceSquared(Point1 const &a,
+                                                  Point2 const &b,
+                                                  Point3 const &point)
+{
+  using KokkosExt::max;
+  using KokkosExt::min;
+
+  constexpr int DIM = GeometryTraits::dimension_v<Point1>;
+  float length_squared = 0;
+  float projection = 0;
+  for (int d = 0; d < DIM; ++d)
+  {
+    float const u = b[d] - a[d];
+    length_squared += u * u;
+    projection += (point[d] - a[d]) * u;
+  }
+  float const t =
+      (length_squared > 0 ? min(max(projection / length_squared, 0.f), 1.f)
+                          : 0.f);
+  float distance_squared = 0;
+  for (int d = 0; d < DIM; ++d)
+  {
+    float const delta = a[d] + t * (b[d] - a[d]) - point[d];
+    distance_squared += delta * delta;
+  }
+  return distance_squared;
+}
+
+// squared distance between the segments [p1, q1] and [p2, q2], from the
+// closest points of the two segments (see Ericson, Real-Time Collision
+// Detection, 5.1.9)
+template <typename Point1, typename Point2, typename Point3, typename Point4>
+KOKKOS_FUNCTION float
+segmentSegmentDistanceSquared(Point1 const &p1, Point2 const &q1,
+                              Point3 const &p2, Point4 const &q2)
+{
+  using KokkosExt::max;
+  using KokkosExt::min;
+
+  constexpr int DIM = GeometryTraits::dimension_v<Point1>;
+  float a = 0; // squared length of the first segment
+  float b = 0;
+  float c = 0;
+  float e = 0; // squared length of the second segment
+  float f = 0;
+  for (int d = 0; d < DIM; ++d)
+  {
+    float const d1 = q1[d] - p1[d];
+    float const d2 = q2[d] - p2[d];
+    float const r = p1[d] - p2[d];
+    a += d1 * d1;
+    b += d1 * d2;
+    c += d1 * r;
+    e += d2 * d2;
+    f += d2 * r;
+  }
+
+  float s = 0;
+  float t = 0;
+  if (a <= 0 && e <= 0)
+  {
+    // Both segments degenerate into points
+  }
+  else if (a <= 0)
+  {
+    t = min(max(f / e, 0.f), 1.f);
+  }
+  else if (e <= 0)
+  {
+    s = min(max(-c / a, 0.f), 1.f);
+  }
+  else
+  {
+    float const denominator = a * e - b * b;
+    if (denominator > 0)
+      s = min(max((b * f - c * e) / denominator, 0.f), 1.f);
+    t = (b * s + f) / e;
+    if (t < 0)
+    {
+      t = 0;
+      s = min(max(-c / a, 0.f), 1.f);
+    }
+    else if (t > 1)
+    {
+      t = 1;
+      s = min(max((b - c) / a, 0.f), 1.f);
+    }
+  }
+
+  float distance_squared = 0;
+  for (int d = 0; d < DIM; ++d)
+  {
+    float const delta =
+        (p1[d] + s * (q1[d] - p1[d])) - (p2[d] + t * (q2[d] - p2[d]));
+    distance_squared += delta * delta;
+  }
+  return distance_squared;
+}
+
+// squared distance between the segment [a, b] and an axis-aligned box
+template <typename Point1, typename Point2, typename Box>
+KOKKOS_FUNCTION float segmentBoxDistanceSquared(Point1 const &a,
+                                                Point2 const &b,
+                                                Box const &box)
+{
+  using KokkosExt::max;
+  using KokkosExt::min;
+
+  constexpr int DIM = GeometryTraits::dimension_v<Box>;
+
+  // Along the segment a + t (b - a), the squared distance to the box is a
+  // convex piecewise quadratic function of t, with breakpoints where the
+  // segment crosses the planes of the faces of the box. Its minimum is found
+  // at the stationary point of one of the pieces, clamped to the piece.
+  float breakpoints[2 * DIM + 2];
+  int num_breakpoints = 0;
+  breakpoints[num_breakpoints++] = 0;
+  breakpoints[num_breakpoints++] = 1;
+  for (int d = 0; d < DIM; ++d)
+  {
+    float const u = b[d] - a[d];
+    if (u == 0)
+      continue;
+    for (int side = 0; side < 2; ++side)
+    {
+      float const bound = (side == 0 ? box.minCorner()[d] : box.maxCorner()[d]);
+      float const t = (bound - a[d]) / u;
+      if (t > 0 && t < 1)
+        breakpoints[num_breakpoints++] = t;
+    }
+  }
+  for (int i = 1; i < num_breakpoints; ++i)
+    for (int j = i; j > 0 && breakpoints[j - 1] > breakpoints[j]; --j)
+    {
+      float const tmp = breakpoints[j];
+      breakpoints[j] = breakpoints[j - 1];
+      breakpoints[j - 1] = tmp;
+    }
+
+  float result = KokkosExt::ArithmeticTraits::infinity<float>::value;
+  for (int k = 0; k + 1 < num_breakpoints; ++k)
+  {
+    float const t_begin = breakpoints[k];
+    float const t_end = breakpoints[k + 1];
+    float const t_middle = (t_begin + t_end) / 2;
+
+    // On the piece, the function is A t^2 + 2 B t + C, summed over the
+    // dimensions along which the segment is outside of the box
+    float A = 0;
+    float B = 0;
+    for (int d = 0; d < DIM; ++d)
+    {
+      float const u = b[d] - a[d];
+      float const x = a[d] + t_middle * u;
+      float bound;
+      if (x < box.minCorner()[d])
+        bound = box.minCorner()[d];
+      else if (x > box.maxCorner()[d])
+        bound = box.maxCorner()[d];
+      else
+        continue;
+      A += u * u;
+      B += (a[d] - bound) * u;
+    }
+    float const t = (A > 0 ? min(max(-B / A, t_begin), t_end) : t_begin);
+
+    float distance_squared = 0;
+    for (int d = 0; d < DIM; ++d)
+    {
+      float const x = a[d] + t * (b[d] - a[d]);
+      float delta = 0;
+      if (x < box.minCorner()[d])
+        delta = box.minCorner()[d] - x;
+      else if (x > box.maxCorner()[d])
+        delta = x - box.maxCorner()[d];
+      distance_squared += delta * delta;
+    }
+    result = min(result, distance_squared);
+  }
+  return result;
+}
+
+// half width of an oriented box along a unit direction
+template <typename OBB, typename Vector>
+KOKKOS_FUNCTION float projectedHalfWidth(OBB const &obb,
+                                         Vector const &direction)
+{
+  constexpr int DIM = GeometryTraits::dimension_v<OBB>;
+  float result = 0;
+  for (int i = 0; i < DIM; ++i)
+    result += obb.halfExtent(i) *
+              Kokkos::abs(innerProduct<DIM>(obb.axis(i), direction));
+  return result;
+}
+
+// expand an oriented box, keeping its axes, to include the intervals
+// [lower[i], upper[i]] of the projections onto its axes
+template <typename OBB>
+KOKKOS_FUNCTION void expandAlongAxes(OBB &obb, float const *lower,
+                                     float const *upper)
+{
+  using KokkosExt::max;
+  using KokkosExt::min;
+
+  constexpr int DIM = GeometryTraits::dimension_v<OBB>;
+  float middles[DIM];
+  for (int i = 0; i < DIM; ++i)
+  {
+    float lo = lower[i];
+    float hi = upper[i];
+    if (obb.halfExtent(i) >= 0)
+    {
+      float const c = innerProduct<DIM>(obb.center(), obb.axis(i));
+      lo = min(lo, c - obb.halfExtent(i));
+      hi = max(hi, c + obb.halfExtent(i));
+    }
+    obb.halfExtent(i) = (hi - lo) / 2;
+    middles[i] = (lo + hi) / 2;
+  }
+  for (int d = 0; d < DIM; ++d)
+  {
+    obb.center()[d] = 0;
+    for (int i = 0; i < DIM; ++i)
+      obb.center()[d] += middles[i] * obb.axis(i)[d];
+  }
+}
+
+template <typename Box>
+KOKKOS_FUNCTION auto toOBB(Box const &box)
+{
+  constexpr int DIM = GeometryTraits::dimension_v<Box>;
+  ExperimentalHyperGeometry::OBB<DIM> obb;
+  for (int d = 0; d < DIM; ++d)
+  {
+    obb.center()[d] = (box.minCorner()[d] + box.maxCorner()[d]) / 2;
+    obb.halfExtent(d) = (box.maxCorner()[d] - box.minCorner()[d]) / 2;
+  }
+  return obb;
+}
+
+// whether the projections of two oriented boxes onto a direction are disjoint
+template <typename OBB1, typename OBB2, typename Vector>
+KOKKOS_FUNCTION bool separatedAlong(OBB1 const &obb1, OBB2 const &obb2,
+                                    Vector const &direction)
+{
+  constexpr int DIM = GeometryTraits::dimension_v<OBB1>;
+  float distance = 0;
+  for (int d = 0; d < DIM; ++d)
+    distance += (obb2.center()[d] - obb1.center()[d]) * direction[d];
+  return Kokkos::abs(distance) > projectedHalfWidth(obb1, direction) +
+                                     projectedHalfWidth(obb2, direction);
+}
+
+// separating axis test for two oriented boxes
+template <typename OBB1, typename OBB2>
+KOKKOS_FUNCTION bool intersectsOBB(OBB1 const &obb1, OBB2 const &obb2)
+{
+  constexpr int DIM = GeometryTraits::dimension_v<OBB1>;
+  if (obb1.halfExtent(0) < 0 || obb2.halfExtent(0) < 0)
+    return false;
+
+  for (int i = 0; i < DIM; ++i)
+    if (separatedAlong(obb1, obb2, obb1.axis(i)) ||
+        separatedAlong(obb1, obb2, obb2.axis(i)))
+      return false;
+  if constexpr (DIM == 3)
+  {
+    for (int i = 0; i < 3; ++i)
+      for (int j = 0; j < 3; ++j)
+      {
+        auto const &u = obb1.axis(i);
+        auto const &v = obb2.axis(j);
+        float const direction[3] = {u[1] * v[2] - u[2] * v[1],
+                                    u[2] * v[0] - u[0] * v[2],
+                                    u[0] * v[1] - u[1] * v[0]};
+        // The cross product of (nearly) parallel axes vanishes, and the face
+        // axes already cover that case
+        if (innerProduct<3>(direction, direction) < 1e-6f)
+          continue;
+        if (separatedAlong(obb1, obb2, direction))
+          return false;
+      }
+  }
+  return true;
+}
+
+// expand a capsule to include the capsule of segment [a, b] and given radius,
+// choosing the segment between the two farthest apart of the four end balls
+template <typename Capsule, typename Point1, typename Point2>
+KOKKOS_FUNCTION void expandCapsule(Capsule &capsule, Point1 const &a,
+                                   Point2 const &b, float radius)
+{
+  using KokkosExt::max;
+
+  constexpr int DIM = GeometryTraits::dimension_v<Capsule>;
+  if (radius < 0)
+    return;
+  if (capsule.radius() < 0)
+  {
+    for (int d = 0; d < DIM; ++d)
+    {
+      capsule.a()[d] = a[d];
+      capsule.b()[d] = b[d];
+    }
+    capsule.radius() = radius;
+    return;
+  }
+
+  using Point = std::decay_t<decltype(capsule.a())>;
+  Point ends[4] = {capsule.a(), capsule.b(), capsule.a(), capsule.b()};
+  for (int d = 0; d < DIM; ++d)
+  {
+    ends[2][d] = a[d];
+    ends[3][d] = b[d];
+  }
+  float const radii[4] = {capsule.radius(), capsule.radius(), radius, radius};
+
+  int first = 0;
+  int second = 1;
+  float extent = -1;
+  for (int i = 0; i < 4; ++i)
+    for (int j = i + 1; j < 4; ++j)
+    {
+      float const e =
+          Details::distance(ends[i], ends[j]) + radii[i] + radii[j];
+      if (e > extent)
+      {
+        extent = e;
+        first = i;
+        second = j;
+      }
+    }
+
+  // The distance to a segment being convex, a capsule containing the end
+  // balls of another capsule contains all of it
+  float new_radius = 0;
+  for (int k = 0; k < 4; ++k)
+    new_radius =
+        max(new_radius, std::sqrt(segmentPointDistanceSquared(
+                            ends[first], ends[second], ends[k])) +
+                            radii[k]);
+  capsule.a() = ends[first];
+  capsule.b() = ends[second];
+  capsule.radius() = new_radius;
+}
+
+// the empty sphere, with a negative radius, from which the spheres bounding
+// the nodes of a hierarchy are expanded. A default constructed sphere is
+// a point instead.
+template <typename Sphere>
+KOKKOS_FUNCTION constexpr Sphere makeEmptySphere()
+{
+  using Coordinate = typename GeometryTraits::coordinate_type<Sphere>::type;
+  Sphere sphere{};
+  sphere.radius() = KokkosExt::ArithmeticTraits::finite_min<Coordinate>::value;
+  return sphere;
+}
+
+// the bounding volume that expanding with a geometry turns into the bounding
+// volume of that geometry
+template <typename BoundingVolume>
+KOKKOS_FUNCTION constexpr BoundingVolume makeEmptyBoundingVolume()
+{
+  if constexpr (GeometryTraits::is_sphere<BoundingVolume>{})
+    return makeEmptySphere<BoundingVolume>();
+  else
+    return BoundingVolume{};
+}
+
+// expand a sphere to the smallest sphere containing both it and the ball of
+// given center and radius
+template <typename Sphere, typename Point, typename Coordinate>
+KOKKOS_FUNCTION void expandSphere(Sphere &sphere, Point const &center,
+                                  Coordinate radius)
+{
+  using KokkosExt::max;
+
+  constexpr int DIM = GeometryTraits::dimension_v<Sphere>;
+  if (radius < 0)
+    return;
+  Coordinate const old_radius = sphere.radius();
+  Coordinate const d = Details::distance(sphere.centroid(), center);
+  if (old_radius >= 0 && d + radius <= old_radius)
+    return;
+  if (old_radius < 0 || d + old_radius <= radius)
+  {
+    for (int k = 0; k < DIM; ++k)
+      sphere.centroid()[k] = center[k];
+    sphere.radius() = radius;
+    return;
+  }
+
+  // The new center lies on the segment joining the old one and the given one
+  auto const old_center = sphere.centroid();
+  Coordinate const new_radius = (d + old_radius + radius) / 2;
+  Coordinate const t = (new_radius - old_radius) / d;
+  for (int k = 0; k < DIM; ++k)
+    sphere.centroid()[k] = old_center[k] + t * (center[k] - old_center[k]);
+  // Make up for rounding so that neither ball sticks out
+  sphere.radius() = max<Coordinate>(
+      new_radius,
+      max<Coordinate>(
+          Details::distance(sphere.centroid(), old_center) + old_radius,
+          Details::distance(sphere.centroid(), center) + radius));
+}
+
 namespace Dispatch
 {
 
@@ -192,16 +840,11 @@ struct isValid<SphereTag, Sphere>
 template <typename Point1, typename Point2>
 struct distance<PointTag, PointTag, Point1, Point2>
 {
-  KOKKOS_FUNCTION static float apply(Point1 const &a, Point2 const &b)
+  using Coordinate = distance_coordinate_t<Point1, Point2>;
+
+  KOKKOS_FUNCTION static Coordinate apply(Point1 const &a, Point2 const &b)
   {
-    constexpr int DIM = GeometryTraits::dimension_v<Point1>;
-    float distance_squared = 0.0;
-    for (int d = 0; d < DIM; ++d)
-    {
-      float tmp = b[d] - a[d];
-      distance_squared += tmp * tmp;
-    }
-    return std::sqrt(distance_squared);
+    return std::sqrt(Details::pointPointDistanceSquared(a, b));
   }
 };
 
@@ -209,7 +852,9 @@ struct distance<PointTag, PointTag, Point1, Point2>
 template <typename Point, typename Box>
 struct distance<PointTag, BoxTag, Point, Box>
 {
-  KOKKOS_FUNCTION static float apply(Point const &point, Box const &box)
+  using Coordinate = distance_coordinate_t<Point, Box>;
+
+  KOKKOS_FUNCTION static Coordinate apply(Point const &point, Box const &box)
   {
     constexpr int DIM = GeometryTraits::dimension_v<Point>;
     Point projected_point;
@@ -230,11 +875,14 @@ struct distance<PointTag, BoxTag, Point, Box>
 template <typename Point, typename Sphere>
 struct distance<PointTag, SphereTag, Point, Sphere>
 {
-  KOKKOS_FUNCTION static float apply(Point const &point, Sphere const &sphere)
+  using Coordinate = distance_coordinate_t<Point, Sphere>;
+
+  KOKKOS_FUNCTION static Coordinate apply(Point const &point,
+                                          Sphere const &sphere)
   {
     using KokkosExt::max;
-    return max(Details::distance(point, sphere.centroid()) - sphere.radius(),
-               0.f);
+    return max<Coordinate>(
+        Details::distance(point, sphere.centroid()) - sphere.radius(), 0);
   }
 };
 
@@ -242,24 +890,26 @@ struct distance<PointTag, SphereTag, Point, Sphere>
 template <typename Box1, typename Box2>
 struct distance<BoxTag, BoxTag, Box1, Box2>
 {
-  KOKKOS_FUNCTION static float apply(Box1 const &box_a, Box2 const &box_b)
+  using Coordinate = distance_coordinate_t<Box1, Box2>;
+
+  KOKKOS_FUNCTION static Coordinate apply(Box1 const &box_a, Box2 const &box_b)
   {
     constexpr int DIM = GeometryTraits::dimension_v<Box1>;
-    float distance_squared = 0.;
+    Coordinate distance_squared = 0;
     for (int d = 0; d < DIM; ++d)
     {
-      auto const a_min = box_a.minCorner()[d];
-      auto const a_max = box_a.maxCorner()[d];
-      auto const b_min = box_b.minCorner()[d];
-      auto const b_max = box_b.maxCorner()[d];
+      Coordinate const a_min = box_a.minCorner()[d];
+      Coordinate const a_max = box_a.maxCorner()[d];
+      Coordinate const b_min = box_b.minCorner()[d];
+      Coordinate const b_max = box_b.maxCorner()[d];
       if (a_min > b_max)
       {
-        float const delta = a_min - b_max;
+        Coordinate const delta = a_min - b_max;
         distance_squared += delta * delta;
       }
       else if (b_min > a_max)
       {
-        float const delta = b_min - a_max;
+        Coordinate const delta = b_min - a_max;
         distance_squared += delta * delta;
       }
       else
@@ -275,12 +925,92 @@ struct distance<BoxTag, BoxTag, Box1, Box2>
 template <typename Sphere, typename Box>
 struct distance<SphereTag, BoxTag, Sphere, Box>
 {
-  KOKKOS_FUNCTION static float apply(Sphere const &sphere, Box const &box)
+  using Coordinate = distance_coordinate_t<Sphere, Box>;
+
+  KOKKOS_FUNCTION static Coordinate apply(Sphere const &sphere, Box const &box)
   {
     using KokkosExt::max;
 
-    float distance_center_box = Details::distance(sphere.centroid(), box);
-    return max(distance_center_box - sphere.radius(), 0.f);
+    Coordinate distance_center_box = Details::distance(sphere.centroid(), box);
+    return max<Coordinate>(distance_center_box - sphere.radius(), 0);
+  }
+};
+
+// distance box-sphere
+template <typename Box, typename Sphere>
+struct distance<BoxTag, SphereTag, Box, Sphere>
+{
+  using Coordinate = distance_coordinate_t<Box, Sphere>;
+
+  KOKKOS_FUNCTION static Coordinate apply(Box const &box, Sphere const &sphere)
+  {
+    return Details::distance(sphere, box);
+  }
+};
+
+// distance sphere-sphere
+template <typename Sphere1, typename Sphere2>
+struct distance<SphereTag, SphereTag, Sphere1, Sphere2>
+{
+  using Coordinate = distance_coordinate_t<Sphere1, Sphere2>;
+
+  KOKKOS_FUNCTION static Coordinate apply(Sphere1 const &sphere,
+                                          Sphere2 const &other)
+  {
+    using KokkosExt::max;
+    return max<Coordinate>(Details::distance(sphere.centroid(),
+                                             other.centroid()) -
+                               sphere.radius() - other.radius(),
+                           0);
+  }
+};
+
+// distance point-triangle
+template <typename Point, typename Triangle>
+struct distance<PointTag, TriangleTag, Point, Triangle>
+{
+  KOKKOS_FUNCTION static auto apply(Point const &point,
+                                    Triangle const &triangle)
+  {
+    return std::sqrt(pointTriangleDistanceSquared(point, triangle));
+  }
+};
+
+// distance point-obb
+template <typename Point, typename OBB>
+struct distance<PointTag, OBBTag, Point, OBB>
+{
+  KOKKOS_FUNCTION static float apply(Point const &point, OBB const &obb)
+  {
+    using KokkosExt::max;
+
+    constexpr int DIM = GeometryTraits::dimension_v<Point>;
+    float distance_squared = 0;
+    for (int i = 0; i < DIM; ++i)
+    {
+      float projection = 0;
+      for (int d = 0; d < DIM; ++d)
+        projection += (point[d] - obb.center()[d]) * obb.axis(i)[d];
+      float const delta =
+          max(Kokkos::abs(projection) - obb.halfExtent(i), 0.f);
+      distance_squared += delta * delta;
+    }
+    return std::sqrt(distance_squared);
+  }
+};
+
+// distance point-capsule
+template <typename Point, typename Capsule>
+struct distance<PointTag, CapsuleTag, Point, Capsule>
+{
+  KOKKOS_FUNCTION static float apply(Point const &point,
+                                     Capsule const &capsule)
+  {
+    using KokkosExt::max;
+    return max(std::sqrt(segmentPointDistanceSquared(capsule.a(), capsule.b(),
+                                                     point)) -
+                   capsule.radius(),
+               0.f);
   }
 };
 
@@ -327,16 +1057,285 @@ struct expand<BoxTag, SphereTag, Box, Sphere>
     using KokkosExt::min;
 
     constexpr int DIM = GeometryTraits::dimension_v<Box>;
+    using Coordinate = typename GeometryTraits::coordinate_type<Box>::type;
+    for (int d = 0; d < DIM; ++d)
+    {
+      box.minCorner()[d] =
+          min(box.minCorner()[d], Details::roundDown<Coordinate>(
+                                      sphere.centroid()[d] - sphere.radius()));
+      box.maxCorner()[d] =
+          max(box.maxCorner()[d], Details::roundUp<Coordinate>(
+                                      sphere.centroid()[d] + sphere.radius()));
+    }
+  }
+};
+
+// expand a box to include a triangle
+template <typename Box, typename Triangle>
+struct expand<BoxTag, TriangleTag, Box, Triangle>
+{
+  KOKKOS_FUNCTION static void apply(Box &box, Triangle const &triangle)
+  {
+    using KokkosExt::max;
+    using KokkosExt::min;
+
+    constexpr int DIM = GeometryTraits::dimension_v<Box>;
+    using Coordinate = typename GeometryTraits::coordinate_type<Box>::type;
+    for (int d = 0; d < DIM; ++d)
+    {
+      box.minCorner()[d] =
+          min(box.minCorner()[d],
+              Details::roundDown<Coordinate>(
+                  min({triangle.a[d], triangle.b[d], triangle.c[d]})));
+      box.maxCorner()[d] =
+          max(box.maxCorner()[d],
+              Details::roundUp<Coordinate>(
+                  max({triangle.a[d], triangle.b[d], triangle.c[d]})));
+    }
+  }
+};
+
+// expand a box to include an oriented box
+template <typename Box, typename OBB>
+struct expand<BoxTag, OBBTag, Box, OBB>
+{
+  KOKKOS_FUNCTION static void apply(Box &box, OBB const &obb)
+  {
+    using KokkosExt::max;
+    using KokkosExt::min;
+
+    constexpr int DIM = GeometryTraits::dimension_v<Box>;
+    if (obb.halfExtent(0) < 0)
+      return;
+    for (int d = 0; d < DIM; ++d)
+    {
+      float half_width = 0;
+      for (int i = 0; i < DIM; ++i)
+        half_width += obb.halfExtent(i) * Kokkos::abs(obb.axis(i)[d]);
+      box.minCorner()[d] =
+          min(box.minCorner()[d], obb.center()[d] - half_width);
+      box.maxCorner()[d] =
+          max(box.maxCorner()[d], obb.center()[d] + half_width);
+    }
+  }
+};
+
+// expand a box to include a capsule
+template <typename Box, typename Capsule>
+struct expand<BoxTag, CapsuleTag, Box, Capsule>
+{
+  KOKKOS_FUNCTION static void apply(Box &box, Capsule const &capsule)
+  {
+    using KokkosExt::max;
+    using KokkosExt::min;
+
+    constexpr int DIM = GeometryTraits::dimension_v<Box>;
+    if (capsule.radius() < 0)
+      return;
     for (int d = 0; d < DIM; ++d)
     {
       box.minCorner()[d] =
-          min(box.minCorner()[d], sphere.centroid()[d] - sphere.radius());
+          min({box.minCorner()[d], capsule.a()[d] - capsule.radius(),
+               capsule.b()[d] - capsule.radius()});
       box.maxCorner()[d] =
-          max(box.maxCorner()[d], sphere.centroid()[d] + sphere.radius());
+          max({box.maxCorner()[d], capsule.a()[d] + capsule.radius(),
+               capsule.b()[d] + capsule.radius()});
     }
   }
 };
 
+// expand an oriented box to include a point
+template <typename OBB, typename Point>
+struct expand<OBBTag, PointTag, OBB, Point>
+{
+  KOKKOS_FUNCTION static void apply(OBB &obb, Point const &point)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<OBB>;
+    float projections[DIM];
+    for (int i = 0; i < DIM; ++i)
+      projections[i] = innerProduct<DIM>(point, obb.axis(i));
+    expandAlongAxes(obb, projections, projections);
+  }
+};
+
+// expand an oriented box to include a box
+template <typename OBB, typename Box>
+struct expand<OBBTag, BoxTag, OBB, Box>
+{
+  KOKKOS_FUNCTION static void apply(OBB &obb, Box const &box)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<OBB>;
+    if (box.minCorner()[0] > box.maxCorner()[0])
+      return;
+    float lower[DIM];
+    float upper[DIM];
+    for (int i = 0; i < DIM; ++i)
+    {
+      float center = 0;
+      float half_width = 0;
+      for (int d = 0; d < DIM; ++d)
+      {
+        center +=
+            (box.minCorner()[d] + box.maxCorner()[d]) / 2 * obb.axis(i)[d];
+        half_width += (box.maxCorner()[d] - box.minCorner()[d]) / 2 *
+                      Kokkos::abs(obb.axis(i)[d]);
+      }
+      lower[i] = center - half_width;
+      upper[i] = center + half_width;
+    }
+    expandAlongAxes(obb, lower, upper);
+  }
+};
+
+// expand an oriented box to include a sphere
+template <typename OBB, typename Sphere>
+struct expand<OBBTag, SphereTag, OBB, Sphere>
+{
+  KOKKOS_FUNCTION static void apply(OBB &obb, Sphere const &sphere)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<OBB>;
+    float lower[DIM];
+    float upper[DIM];
+    for (int i = 0; i < DIM; ++i)
+    {
+      float const center = innerProduct<DIM>(sphere.centroid(), obb.axis(i));
+      lower[i] = center - sphere.radius();
+      upper[i] = center + sphere.radius();
+    }
+    expandAlongAxes(obb, lower, upper);
+  }
+};
+
+// expand an oriented box to include an oriented box. An empty box takes the
+// orientation of the other one.
+template <typename OBB1, typename OBB2>
+struct expand<OBBTag, OBBTag, OBB1, OBB2>
+{
+  KOKKOS_FUNCTION static void apply(OBB1 &obb, OBB2 const &other)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<OBB1>;
+    if (other.halfExtent(0) < 0)
+      return;
+    if (obb.halfExtent(0) < 0)
+    {
+      for (int i = 0; i < DIM; ++i)
+      {
+        obb.center()[i] = other.center()[i];
+        for (int d = 0; d < DIM; ++d)
+          obb.axis(i)[d] = other.axis(i)[d];
+        obb.halfExtent(i) = other.halfExtent(i);
+      }
+      return;
+    }
+    float lower[DIM];
+    float upper[DIM];
+    for (int i = 0; i < DIM; ++i)
+    {
+      float const center = innerProduct<DIM>(other.center(), obb.axis(i));
+      float const half_width = projectedHalfWidth(other, obb.axis(i));
+      lower[i] = center - half_width;
+      upper[i] = center + half_width;
+    }
+    expandAlongAxes(obb, lower, upper);
+  }
+};
+
+// expand a capsule to include a point
+template <typename Capsule, typename Point>
+struct expand<CapsuleTag, PointTag, Capsule, Point>
+{
+  KOKKOS_FUNCTION static void apply(Capsule &capsule, Point const &point)
+  {
+    expandCapsule(capsule, point, point, 0.f);
+  }
+};
+
+// expand a capsule to include a box, seen as the capsule along its longest
+// axis that contains it
+template <typename Capsule, typename Box>
+struct expand<CapsuleTag, BoxTag, Capsule, Box>
+{
+  KOKKOS_FUNCTION static void apply(Capsule &capsule, Box const &box)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<Capsule>;
+    if (box.minCorner()[0] > box.maxCorner()[0])
+      return;
+    int longest = 0;
+    for (int d = 1; d < DIM; ++d)
+      if (box.maxCorner()[d] - box.minCorner()[d] >
+          box.maxCorner()[longest] - box.minCorner()[longest])
+        longest = d;
+    auto a = returnCentroid(box);
+    auto b = a;
+    a[longest] = box.minCorner()[longest];
+    b[longest] = box.maxCorner()[longest];
+    float radius_squared = 0;
+    for (int d = 0; d < DIM; ++d)
+    {
+      if (d == longest)
+        continue;
+      float const half_width = (box.maxCorner()[d] - box.minCorner()[d]) / 2;
+      radius_squared += half_width * half_width;
+    }
+    expandCapsule(capsule, a, b, std::sqrt(radius_squared));
+  }
+};
+
+// expand a capsule to include a sphere
+template <typename Capsule, typename Sphere>
+struct expand<CapsuleTag, SphereTag, Capsule, Sphere>
+{
+  KOKKOS_FUNCTION static void apply(Capsule &capsule, Sphere const &sphere)
+  {
+    expandCapsule(capsule, sphere.centroid(), sphere.centroid(),
+                  sphere.radius());
+  }
+};
+
+// expand a capsule to include a capsule
+template <typename Capsule1, typename Capsule2>
+struct expand<CapsuleTag, CapsuleTag, Capsule1, Capsule2>
+{
+  KOKKOS_FUNCTION static void apply(Capsule1 &capsule, Capsule2 const &other)
+  {
+    expandCapsule(capsule, other.a(), other.b(), other.radius());
+  }
+};
+
+// expand a sphere to include a point
+template <typename Sphere, typename Point>
+struct expand<SphereTag, PointTag, Sphere, Point>
+{
+  KOKKOS_FUNCTION static void apply(Sphere &sphere, Point const &point)
+  {
+    using Coordinate = typename GeometryTraits::coordinate_type<Sphere>::type;
+    expandSphere(sphere, point, Coordinate(0));
+  }
+};
+
+// expand a sphere to include a box, seen as its circumscribed sphere
+template <typename Sphere, typename Box>
+struct expand<SphereTag, BoxTag, Sphere, Box>
+{
+  KOKKOS_FUNCTION static void apply(Sphere &sphere, Box const &box)
+  {
+    if (box.minCorner()[0] > box.maxCorner()[0])
+      return;
+    expandSphere(sphere, returnCentroid(box),
+                 Details::distance(box.minCorner(), box.maxCorner()) / 2);
+  }
+};
+
+// expand a sphere to include a sphere
+template <typename Sphere1, typename Sphere2>
+struct expand<SphereTag, SphereTag, Sphere1, Sphere2>
+{
+  KOKKOS_FUNCTION static void apply(Sphere1 &sphere, Sphere2 const &other)
+  {
+    expandSphere(sphere, other.centroid(), other.radius());
+  }
+};
+
 // check if two axis-aligned bounding boxes intersect
 template <typename Box1, typename Box2>
 struct intersects<BoxTag, BoxTag, Box1, Box2>
@@ -353,6 +1352,47 @@ struct intersects<BoxTag, BoxTag, Box1, Box2>
   }
 };
 
+// check if an axis-aligned bounding box contains another one
+template <typename Box1, typename Box2>
+struct contains<BoxTag, BoxTag, Box1, Box2>
+{
+  KOKKOS_FUNCTION static constexpr bool apply(Box1 const &box,
+                                              Box2 const &other)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<Box1>;
+    for (int d = 0; d < DIM; ++d)
+      if (other.minCorner()[d] < box.minCorner()[d] ||
+          other.maxCorner()[d] > box.maxCorner()[d])
+        return false;
+    return true;
+  }
+};
+
+// check if a sphere contains an axis-aligned bounding box, i.e., its farthest
+// corner from the center
+template <typename Sphere, typename Box>
+struct contains<SphereTag, BoxTag, Sphere, Box>
+{
+  KOKKOS_FUNCTION static bool apply(Sphere const &sphere, Box const &box)
+  {
+    using Coordinate = distance_coordinate_t<Sphere, Box>;
+    constexpr int DIM = GeometryTraits::dimension_v<Sphere>;
+    auto const &center = sphere.centroid();
+    Coordinate distance_squared = 0;
+    for (int d = 0; d < DIM; ++d)
+    {
+      Coordinate const to_min =
+          Coordinate(center[d]) - Coordinate(box.minCorner()[d]);
+      Coordinate const to_max =
+          Coordinate(box.maxCorner()[d]) - Coordinate(center[d]);
+      Coordinate const tmp = (to_min > to_max ? to_min : to_max);
+      distance_squared += tmp * tmp;
+    }
+    Coordinate const radius = sphere.radius();
+    return radius >= 0 && distance_squared <= radius * radius;
+  }
+};
+
 // check it a box intersects with a point
 template <typename Point, typename Box>
 struct intersects<PointTag, BoxTag, Point, Box>
@@ -374,7 +1414,37 @@ struct intersects<SphereTag, BoxTag, Sphere, Box>
 {
   KOKKOS_FUNCTION static bool apply(Sphere const &sphere, Box const &box)
   {
-    return Details::distance(sphere.centroid(), box) <= sphere.radius();
+    using Coordinate = distance_coordinate_t<Sphere, Box>;
+    Coordinate const radius = sphere.radius();
+    return radius >= 0 &&
+           Details::pointBoxDistanceSquared(sphere.centroid(), box) <=
+               radius * radius;
+  }
+};
+
+// check if an axis-aligned bounding box intersects with a sphere
+template <typename Box, typename Sphere>
+struct intersects<BoxTag, SphereTag, Box, Sphere>
+{
+  KOKKOS_FUNCTION static bool apply(Box const &box, Sphere const &sphere)
+  {
+    return Details::intersects(sphere, box);
+  }
+};
+
+// check if two spheres intersect
+template <typename Sphere1, typename Sphere2>
+struct intersects<SphereTag, SphereTag, Sphere1, Sphere2>
+{
+  KOKKOS_FUNCTION static bool apply(Sphere1 const &sphere,
+                                    Sphere2 const &other)
+  {
+    using Coordinate = distance_coordinate_t<Sphere1, Sphere2>;
+    Coordinate const radius = sphere.radius() + other.radius();
+    return sphere.radius() >= 0 && other.radius() >= 0 &&
+           Details::pointPointDistanceSquared(sphere.centroid(),
+                                              other.centroid()) <=
+               radius * radius;
   }
 };
 
@@ -384,7 +1454,11 @@ struct intersects<SphereTag, PointTag, Sphere, Point>
 {
   KOKKOS_FUNCTION static bool apply(Sphere const &sphere, Point const &point)
   {
-    return Details::distance(sphere.centroid(), point) <= sphere.radius();
+    using Coordinate = distance_coordinate_t<Sphere, Point>;
+    Coordinate const radius = sphere.radius();
+    return radius >= 0 &&
+           Details::pointPointDistanceSquared(sphere.centroid(), point) <=
+               radius * radius;
   }
 };
 
@@ -397,6 +1471,183 @@ struct intersects<PointTag, SphereTag, Point, Sphere>
   }
 };
 
+// check if a point intersects with an oriented box
+template <typename Point, typename OBB>
+struct intersects<PointTag, OBBTag, Point, OBB>
+{
+  KOKKOS_FUNCTION static bool apply(Point const &point, OBB const &obb)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<Point>;
+    for (int i = 0; i < DIM; ++i)
+    {
+      float projection = 0;
+      for (int d = 0; d < DIM; ++d)
+        projection += (point[d] - obb.center()[d]) * obb.axis(i)[d];
+      if (Kokkos::abs(projection) > obb.halfExtent(i))
+        return false;
+    }
+    return true;
+  }
+};
+
+template <typename OBB, typename Point>
+struct intersects<OBBTag, PointTag, OBB, Point>
+{
+  KOKKOS_FUNCTION static bool apply(OBB const &obb, Point const &point)
+  {
+    return Details::intersects(point, obb);
+  }
+};
+
+// check if a sphere intersects with an oriented box
+template <typename Sphere, typename OBB>
+struct intersects<SphereTag, OBBTag, Sphere, OBB>
+{
+  KOKKOS_FUNCTION static bool apply(Sphere const &sphere, OBB const &obb)
+  {
+    return obb.halfExtent(0) >= 0 &&
+           Details::distance(sphere.centroid(), obb) <= sphere.radius();
+  }
+};
+
+// check if an axis-aligned box intersects with an oriented box
+template <typename Box, typename OBB>
+struct intersects<BoxTag, OBBTag, Box, OBB>
+{
+  KOKKOS_FUNCTION static bool apply(Box const &box, OBB const &obb)
+  {
+    return intersectsOBB(toOBB(box), obb);
+  }
+};
+
+template <typename OBB, typename Box>
+struct intersects<OBBTag, BoxTag, OBB, Box>
+{
+  KOKKOS_FUNCTION static bool apply(OBB const &obb, Box const &box)
+  {
+    return Details::intersects(box, obb);
+  }
+};
+
+// check if two oriented boxes intersect
+template <typename OBB1, typename OBB2>
+struct intersects<OBBTag, OBBTag, OBB1, OBB2>
+{
+  KOKKOS_FUNCTION static bool apply(OBB1 const &obb, OBB2 const &other)
+  {
+    return intersectsOBB(obb, other);
+  }
+};
+
+// check if a point intersects with a capsule
+template <typename Point, typename Capsule>
+struct intersects<PointTag, CapsuleTag, Point, Capsule>
+{
+  KOKKOS_FUNCTION static bool apply(Point const &point,
+                                    Capsule const &capsule)
+  {
+    return std::sqrt(segmentPointDistanceSquared(capsule.a(), capsule.b(),
+                                                 point)) <= capsule.radius();
+  }
+};
+
+template <typename Capsule, typename Point>
+struct intersects<CapsuleTag, PointTag, Capsule, Point>
+{
+  KOKKOS_FUNCTION static bool apply(Capsule const &capsule,
+                                    Point const &point)
+  {
+    return Details::intersects(point, capsule);
+  }
+};
+
+// check if a sphere intersects with a capsule
+template <typename Sphere, typename Capsule>
+struct intersects<SphereTag, CapsuleTag, Sphere, Capsule>
+{
+  KOKKOS_FUNCTION static bool apply(Sphere const &sphere,
+                                    Capsule const &capsule)
+  {
+    return capsule.radius() >= 0 &&
+           std::sqrt(segmentPointDistanceSquared(capsule.a(), capsule.b(),
+                                                 sphere.centroid())) <=
+               sphere.radius() + capsule.radius();
+  }
+};
+
+// check if an axis-aligned box intersects with a capsule
+template <typename Box, typename Capsule>
+struct intersects<BoxTag, CapsuleTag, Box, Capsule>
+{
+  KOKKOS_FUNCTION static bool apply(Box const &box, Capsule const &capsule)
+  {
+    return std::sqrt(segmentBoxDistanceSquared(capsule.a(), capsule.b(),
+                                               box)) <= capsule.radius();
+  }
+};
+
+template <typename Capsule, typename Box>
+struct intersects<CapsuleTag, BoxTag, Capsule, Box>
+{
+  KOKKOS_FUNCTION static bool apply(Capsule const &capsule, Box const &box)
+  {
+    return Details::intersects(box, capsule);
+  }
+};
+
+// check if a capsule intersects with an oriented box, from the distance
+// between the capsule segment and the box in the frame of the box
+template <typename Capsule, typename OBB>
+struct intersects<CapsuleTag, OBBTag, Capsule, OBB>
+{
+  KOKKOS_FUNCTION static bool apply(Capsule const &capsule, OBB const &obb)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<Capsule>;
+    if (obb.halfExtent(0) < 0)
+      return false;
+    ExperimentalHyperGeometry::Point<DIM> a;
+    ExperimentalHyperGeometry::Point<DIM> b;
+    ExperimentalHyperGeometry::Box<DIM> box;
+    for (int i = 0; i < DIM; ++i)
+    {
+      a[i] = 0;
+      b[i] = 0;
+      for (int d = 0; d < DIM; ++d)
+      {
+        a[i] += (capsule.a()[d] - obb.center()[d]) * obb.axis(i)[d];
+        b[i] += (capsule.b()[d] - obb.center()[d]) * obb.axis(i)[d];
+      }
+      box.minCorner()[i] = -obb.halfExtent(i);
+      box.maxCorner()[i] = obb.halfExtent(i);
+    }
+    return std::sqrt(segmentBoxDistanceSquared(a, b, box)) <=
+           capsule.radius();
+  }
+};
+
+template <typename OBB, typename Capsule>
+struct intersects<OBBTag, CapsuleTag, OBB, Capsule>
+{
+  KOKKOS_FUNCTION static bool apply(OBB const &obb, Capsule const &capsule)
+  {
+    return Details::intersects(capsule, obb);
+  }
+};
+
+// check if two capsules intersect
+template <typename Capsule1, typename Capsule2>
+struct intersects<CapsuleTag, CapsuleTag, Capsule1, Capsule2>
+{
+  KOKKOS_FUNCTION static bool apply(Capsule1 const &capsule,
+                                    Capsule2 const &other)
+  {
+    return capsule.radius() >= 0 && other.radius() >= 0 &&
+           std::sqrt(segmentSegmentDistanceSquared(
+               capsule.a(), capsule.b(), other.a(), other.b())) <=
+               capsule.radius() + other.radius();
+  }
+};
+
 template <typename Point>
 struct centroid<PointTag, Point>
 {
@@ -425,6 +1676,38 @@ struct centroid<SphereTag, Sphere>
   }
 };
 
+template <typename Triangle>
+struct centroid<TriangleTag, Triangle>
+{
+  KOKKOS_FUNCTION static auto apply(Triangle const &triangle)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<Triangle>;
+    auto c = triangle.a;
+    for (int d = 0; d < DIM; ++d)
+      c[d] = (c[d] + triangle.b[d] + triangle.c[d]) / 3;
+    return c;
+  }
+};
+
+template <typename OBB>
+struct centroid<OBBTag, OBB>
+{
+  KOKKOS_FUNCTION static auto apply(OBB const &obb) { return obb.center(); }
+};
+
+template <typename Capsule>
+struct centroid<CapsuleTag, Capsule>
+{
+  KOKKOS_FUNCTION static auto apply(Capsule const &capsule)
+  {
+    constexpr int DIM = GeometryTraits::dimension_v<Capsule>;
+    auto c = capsule.a();
+    for (int d = 0; d < DIM; ++d)
+      c[d] = (c[d] + capsule.b()[d]) / 2;
+    return c;
+  }
+};
+
 } // namespace Dispatch
 
 // transformation that maps the unit cube into a new axis-aligned box
@@ -35,6 +35,12 @@ struct TriangleTag
 struct KDOPTag
 {};
 
+struct OBBTag
+{};
+
+struct CapsuleTag
+{};
+
 template <typename Geometry>
 struct dimension
 {
@@ -85,6 +91,10 @@ template <typename Geometry>
 struct is_sphere : std::is_same<typename tag<Geometry>::type, SphereTag>
 {};
 
+template <typename Geometry>
+struct is_triangle : std::is_same<typename tag<Geometry>::type, TriangleTag>
+{};
+
 template <typename Geometry>
 void check_valid_geometry_traits(Geometry const &)
 {
@@ -114,9 +124,11 @@ void check_valid_geometry_traits(Geometry const &)
   static_assert(std::is_same<Tag, PointTag>{} || std::is_same<Tag, BoxTag>{} ||
                     std::is_same<Tag, SphereTag>{} ||
                     std::is_same<Tag, TriangleTag>{} ||
-                    std::is_same<Tag, KDOPTag>{},
+                    std::is_same<Tag, KDOPTag>{} ||
+                    std::is_same<Tag, OBBTag>{} ||
+                    std::is_same<Tag, CapsuleTag>{},
                 "GeometryTraits::tag<Geometry>::type must be PointTag, BoxTag, "
-                "SphereTag, TriangleTag or KDOPTag");
+                "SphereTag, TriangleTag, KDOPTag, OBBTag or CapsuleTag");
 
   static_assert(!std::is_same<typename coordinate_type<Geometry>::type,
                               not_specialized>::value,
@@ -18,8 +18,64 @@
 #include <ArborX_HyperPoint.hpp>
 
 #include <Kokkos_Macros.hpp>
+#include <Kokkos_MathematicalFunctions.hpp> // nextafter
 #include <Kokkos_ReductionIdentity.hpp>
 
+#include <limits>
+#include <type_traits>
+
+namespace ArborX::Details
+{
+template <typename Coordinate, typename T>
+inline constexpr bool is_narrowing_coordinate_v =
+    std::is_floating_point_v<Coordinate> && std::is_floating_point_v<T> &&
+    (std::numeric_limits<Coordinate>::digits < std::numeric_limits<T>::digits);
+
+// Convert a coordinate to a possibly narrower floating-point type, rounding
+// towards minus infinity, so that a box with single precision corners still
+// contains geometries given in double precision
+template <typename Coordinate, typename T>
+KOKKOS_INLINE_FUNCTION Coordinate roundDown(T x)
+{
+  if constexpr (is_narrowing_coordinate_v<Coordinate, T>)
+  {
+    constexpr auto largest =
+        KokkosExt::ArithmeticTraits::finite_max<Coordinate>::value;
+    constexpr auto inf =
+        KokkosExt::ArithmeticTraits::infinity<Coordinate>::value;
+    if (x >= largest)
+      return largest;
+    if (x < -largest)
+      return -inf;
+    auto const y = static_cast<Coordinate>(x);
+    return (y > x ? Kokkos::nextafter(y, -inf) : y);
+  }
+  else
+    return x;
+}
+
+// Same as above, rounding towards plus infinity
+template <typename Coordinate, typename T>
+KOKKOS_INLINE_FUNCTION Coordinate roundUp(T x)
+{
+  if constexpr (is_narrowing_coordinate_v<Coordinate, T>)
+  {
+    constexpr auto largest =
+        KokkosExt::ArithmeticTraits::finite_max<Coordinate>::value;
+    constexpr auto inf =
+        KokkosExt::ArithmeticTraits::infinity<Coordinate>::value;
+    if (x <= -largest)
+      return -largest;
+    if (x > largest)
+      return inf;
+    auto const y = static_cast<Coordinate>(x);
+    return (y < x ? Kokkos::nextafter(y, inf) : y);
+  }
+  else
+    return x;
+}
+} // namespace ArborX::Details
+
 namespace ArborX::ExperimentalHyperGeometry
 {
 /**
@@ -73,8 +129,10 @@ struct Box
 
     for (int d = 0; d < DIM; ++d)
     {
-      minCorner()[d] = min(minCorner()[d], other.minCorner()[d]);
-      maxCorner()[d] = max(maxCorner()[d], other.maxCorner()[d]);
+      minCorner()[d] = min(
+          minCorner()[d], Details::roundDown<Coordinate>(other.minCorner()[d]));
+      maxCorner()[d] = max(
+          maxCorner()[d], Details::roundUp<Coordinate>(other.maxCorner()[d]));
     }
     return *this;
   }
@@ -88,8 +146,10 @@ struct Box
 
     for (int d = 0; d < DIM; ++d)
     {
-      minCorner()[d] = min(minCorner()[d], point[d]);
-      maxCorner()[d] = max(maxCorner()[d], point[d]);
+      minCorner()[d] =
+          min(minCorner()[d], Details::roundDown<Coordinate>(point[d]));
+      maxCorner()[d] =
+          max(maxCorner()[d], Details::roundUp<Coordinate>(point[d]));
     }
     return *this;
   }
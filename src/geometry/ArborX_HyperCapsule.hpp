@@ -0,0 +1,86 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_HYPERCAPSULE_HPP
+#define ARBORX_HYPERCAPSULE_HPP
+
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_HyperPoint.hpp>
+
+#include <Kokkos_Macros.hpp>
+
+namespace ArborX::ExperimentalHyperGeometry
+{
+/**
+ * Capsule, i.e. the set of points within a given radius of a segment. The
+ * default constructor initializes an "empty" capsule, with a negative radius.
+ */
+template <int DIM, class Coordinate = float>
+struct Capsule
+{
+  KOKKOS_DEFAULTED_FUNCTION
+  Capsule() = default;
+
+  KOKKOS_FUNCTION
+  constexpr Capsule(Point<DIM, Coordinate> const &a,
+                    Point<DIM, Coordinate> const &b, Coordinate radius)
+      : _a(a)
+      , _b(b)
+      , _radius(radius)
+  {}
+
+  KOKKOS_FUNCTION
+  constexpr auto &a() { return _a; }
+
+  KOKKOS_FUNCTION
+  constexpr auto const &a() const { return _a; }
+
+  KOKKOS_FUNCTION
+  constexpr auto &b() { return _b; }
+
+  KOKKOS_FUNCTION
+  constexpr auto const &b() const { return _b; }
+
+  KOKKOS_FUNCTION
+  constexpr auto &radius() { return _radius; }
+
+  KOKKOS_FUNCTION
+  constexpr auto radius() const { return _radius; }
+
+  Point<DIM, Coordinate> _a = {};
+  Point<DIM, Coordinate> _b = {};
+  Coordinate _radius =
+      KokkosExt::ArithmeticTraits::finite_min<Coordinate>::value;
+};
+
+} // namespace ArborX::ExperimentalHyperGeometry
+
+template <int DIM, class Coordinate>
+struct ArborX::GeometryTraits::dimension<
+    ArborX::ExperimentalHyperGeometry::Capsule<DIM, Coordinate>>
+{
+  static constexpr int value = DIM;
+};
+template <int DIM, class Coordinate>
+struct ArborX::GeometryTraits::tag<
+    ArborX::ExperimentalHyperGeometry::Capsule<DIM, Coordinate>>
+{
+  using type = CapsuleTag;
+};
+template <int DIM, class Coordinate>
+struct ArborX::GeometryTraits::coordinate_type<
+    ArborX::ExperimentalHyperGeometry::Capsule<DIM, Coordinate>>
+{
+  using type = Coordinate;
+};
+
+#endif
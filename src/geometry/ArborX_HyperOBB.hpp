@@ -0,0 +1,103 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_HYPEROBB_HPP
+#define ARBORX_HYPEROBB_HPP
+
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_HyperPoint.hpp>
+
+#include <Kokkos_Array.hpp>
+#include <Kokkos_Macros.hpp>
+
+namespace ArborX::ExperimentalHyperGeometry
+{
+/**
+ * Oriented Bounding Box, given by its center, an orthonormal basis of axes,
+ * and its half extents along these axes. The default constructor initializes
+ * an "empty" box with the axes of the coordinate system. When an empty box is
+ * expanded to include another oriented box, it takes the orientation of the
+ * latter.
+ */
+template <int DIM, class Coordinate = float>
+struct OBB
+{
+  KOKKOS_FUNCTION
+  constexpr OBB()
+  {
+    for (int i = 0; i < DIM; ++i)
+    {
+      for (int d = 0; d < DIM; ++d)
+        _axes[i][d] = (i == d ? 1 : 0);
+      _half_extents[i] =
+          KokkosExt::ArithmeticTraits::finite_min<Coordinate>::value;
+    }
+  }
+
+  KOKKOS_FUNCTION
+  constexpr OBB(Point<DIM, Coordinate> const &center,
+                Kokkos::Array<Point<DIM, Coordinate>, DIM> const &axes,
+                Kokkos::Array<Coordinate, DIM> const &half_extents)
+      : _center(center)
+  {
+    for (int i = 0; i < DIM; ++i)
+    {
+      _axes[i] = axes[i];
+      _half_extents[i] = half_extents[i];
+    }
+  }
+
+  KOKKOS_FUNCTION
+  constexpr auto &center() { return _center; }
+
+  KOKKOS_FUNCTION
+  constexpr auto const &center() const { return _center; }
+
+  KOKKOS_FUNCTION
+  constexpr auto &axis(int i) { return _axes[i]; }
+
+  KOKKOS_FUNCTION
+  constexpr auto const &axis(int i) const { return _axes[i]; }
+
+  KOKKOS_FUNCTION
+  constexpr auto &halfExtent(int i) { return _half_extents[i]; }
+
+  KOKKOS_FUNCTION
+  constexpr auto halfExtent(int i) const { return _half_extents[i]; }
+
+  Point<DIM, Coordinate> _center = {};
+  Point<DIM, Coordinate> _axes[DIM] = {};
+  Coordinate _half_extents[DIM] = {};
+};
+
+} // namespace ArborX::ExperimentalHyperGeometry
+
+template <int DIM, class Coordinate>
+struct ArborX::GeometryTraits::dimension<
+    ArborX::ExperimentalHyperGeometry::OBB<DIM, Coordinate>>
+{
+  static constexpr int value = DIM;
+};
+template <int DIM, class Coordinate>
+struct ArborX::GeometryTraits::tag<
+    ArborX::ExperimentalHyperGeometry::OBB<DIM, Coordinate>>
+{
+  using type = OBBTag;
+};
+template <int DIM, class Coordinate>
+struct ArborX::GeometryTraits::coordinate_type<
+    ArborX::ExperimentalHyperGeometry::OBB<DIM, Coordinate>>
+{
+  using type = Coordinate;
+};
+
+#endif
@@ -37,6 +37,9 @@ struct Sphere
   KOKKOS_FUNCTION
   constexpr auto const &centroid() const { return _centroid; }
 
+  KOKKOS_FUNCTION
+  constexpr auto &radius() { return _radius; }
+
   KOKKOS_FUNCTION
   constexpr auto radius() const { return _radius; }
 
@@ -31,6 +31,25 @@ struct Direction
   float _data[3];
 };
 
+// Directions of a k-DOP stored component-wise (structure of arrays), so that
+// the projections onto all of them are computed in vectorizable loops
+template <int n_directions>
+struct DirectionMatrix
+{
+  float _data[3][n_directions];
+};
+
+template <int n_directions>
+KOKKOS_INLINE_FUNCTION constexpr DirectionMatrix<n_directions>
+makeDirectionMatrix(Direction const (&directions)[n_directions])
+{
+  DirectionMatrix<n_directions> matrix{};
+  for (int i = 0; i < n_directions; ++i)
+    for (int d = 0; d < 3; ++d)
+      matrix._data[d][i] = directions[i]._data[d];
+  return matrix;
+}
+
 template <int k>
 struct KDOP_Directions;
 
@@ -39,14 +58,13 @@ struct KDOP_Directions<6>
 {
 protected:
   static constexpr int n_directions = 3;
-  static KOKKOS_FUNCTION Kokkos::Array<Direction, n_directions> const &
-  directions()
+  static KOKKOS_FUNCTION DirectionMatrix<n_directions> const &directions()
   {
-    static constexpr Kokkos::Array<Direction, n_directions> directions = {
+    static constexpr auto directions = makeDirectionMatrix<n_directions>({
         Direction{1, 0, 0},
         Direction{0, 1, 0},
         Direction{0, 0, 1},
-    };
+    });
     return directions;
   }
 };
@@ -56,10 +74,9 @@ struct KDOP_Directions<14>
 {
 protected:
   static constexpr int n_directions = 7;
-  static KOKKOS_FUNCTION Kokkos::Array<Direction, n_directions> const &
-  directions()
+  static KOKKOS_FUNCTION DirectionMatrix<n_directions> const &directions()
   {
-    static constexpr Kokkos::Array<Direction, n_directions> directions = {
+    static constexpr auto directions = makeDirectionMatrix<n_directions>({
         Direction{1, 0, 0},
         Direction{0, 1, 0},
         Direction{0, 0, 1},
@@ -68,7 +85,7 @@ protected:
         Direction{1, -1, 1},
         Direction{1, 1, -1},
         Direction{1, -1, -1},
-    };
+    });
     return directions;
   }
 };
@@ -78,10 +95,9 @@ struct KDOP_Directions<18>
 {
 protected:
   static constexpr int n_directions = 9;
-  static KOKKOS_FUNCTION Kokkos::Array<Direction, n_directions> const &
-  directions()
+  static KOKKOS_FUNCTION DirectionMatrix<n_directions> const &directions()
   {
-    static constexpr Kokkos::Array<Direction, n_directions> directions = {
+    static constexpr auto directions = makeDirectionMatrix<n_directions>({
         Direction{1, 0, 0},
         Direction{0, 1, 0},
         Direction{0, 0, 1},
@@ -92,7 +108,7 @@ protected:
         Direction{1, -1, 0},
         Direction{1, 0, -1},
         Direction{0, 1, -1},
-    };
+    });
     return directions;
   }
 };
@@ -102,10 +118,9 @@ struct KDOP_Directions<26>
 {
 protected:
   static constexpr int n_directions = 13;
-  static KOKKOS_FUNCTION Kokkos::Array<Direction, n_directions> const &
-  directions()
+  static KOKKOS_FUNCTION DirectionMatrix<n_directions> const &directions()
   {
-    static constexpr Kokkos::Array<Direction, n_directions> directions = {
+    static constexpr auto directions = makeDirectionMatrix<n_directions>({
         Direction{1, 0, 0},
         Direction{0, 1, 0},
         Direction{0, 0, 1},
@@ -121,18 +136,17 @@ protected:
         Direction{1, -1, 1},
         Direction{1, 1, -1},
         Direction{1, -1, -1},
-    };
+    });
     return directions;
   }
 };
-KOKKOS_INLINE_FUNCTION float project(Point const &p, Direction const &d)
+
+template <int n_directions>
+KOKKOS_INLINE_FUNCTION float project(Point const &p,
+                                     DirectionMatrix<n_directions> const &m,
+                                     int i)
 {
-  float r = 0.;
-  for (int i = 0; i < 3; ++i)
-  {
-    r += p[i] * d._data[i];
-  }
-  return r;
+  return p[0] * m._data[0][i] + p[1] * m._data[1][i] + p[2] * m._data[2][i];
 }
 } // namespace Details
 
@@ -157,9 +171,10 @@ struct KDOP : private Details::KDOP_Directions<k>
   {
     using KokkosExt::max;
     using KokkosExt::min;
+    auto const &directions = this->directions();
     for (int i = 0; i < n_directions; ++i)
     {
-      auto const proj_i = Details::project(p, this->directions()[i]);
+      auto const proj_i = Details::project(p, directions, i);
       _min_values[i] = min(_min_values[i], proj_i);
       _max_values[i] = max(_max_values[i], proj_i);
     }
@@ -180,24 +195,26 @@ struct KDOP : private Details::KDOP_Directions<k>
       }
     }
 
-    auto const xmin = b.minCorner()[0];
-    auto const ymin = b.minCorner()[1];
-    auto const zmin = b.minCorner()[2];
-    auto const xmax = b.maxCorner()[0];
-    auto const ymax = b.maxCorner()[1];
-    auto const zmax = b.maxCorner()[2];
-    for (auto const &point : {
-             Point{xmin, ymin, zmin},
-             Point{xmin, ymax, zmin},
-             Point{xmin, ymin, zmax},
-             Point{xmin, ymax, zmax},
-             Point{xmax, ymin, zmin},
-             Point{xmax, ymax, zmin},
-             Point{xmax, ymin, zmax},
-             Point{xmax, ymax, zmax},
-         })
+    // The extreme projections of the box onto a direction are those of the
+    // corners picking, along each axis, the bound that minimizes
+    // (respectively maximizes) the product with the direction component.
+    // This avoids projecting all eight corners.
+    using KokkosExt::max;
+    using KokkosExt::min;
+    auto const &directions = this->directions();
+    for (int i = 0; i < n_directions; ++i)
     {
-      *this += point;
+      float lower[3];
+      float upper[3];
+      for (int d = 0; d < 3; ++d)
+      {
+        auto const a = b.minCorner()[d] * directions._data[d][i];
+        auto const c = b.maxCorner()[d] * directions._data[d][i];
+        lower[d] = min(a, c);
+        upper[d] = max(a, c);
+      }
+      _min_values[i] = min(_min_values[i], lower[0] + lower[1] + lower[2]);
+      _max_values[i] = max(_max_values[i], upper[0] + upper[1] + upper[2]);
     }
     return *this;
   }
@@ -223,17 +240,18 @@ struct KDOP : private Details::KDOP_Directions<k>
     }
     return b;
   }
+  // The intersection tests accumulate the separation over all the directions
+  // instead of returning early, so that the loops vectorize.
   KOKKOS_FUNCTION bool intersects(Point const &point) const
   {
+    auto const &directions = this->directions();
+    bool separated = false;
     for (int i = 0; i < n_directions; ++i)
     {
-      auto const proj_i = Details::project(point, this->directions()[i]);
-      if (proj_i < _min_values[i] || proj_i > _max_values[i])
-      {
-        return false;
-      }
+      auto const proj_i = Details::project(point, directions, i);
+      separated |= (proj_i < _min_values[i]) | (proj_i > _max_values[i]);
     }
-    return true;
+    return !separated;
   }
   KOKKOS_FUNCTION bool intersects(Box const &box) const
   {
@@ -243,15 +261,11 @@ struct KDOP : private Details::KDOP_Directions<k>
   }
   KOKKOS_FUNCTION bool intersects(KDOP<k> const &other) const
   {
+    bool separated = false;
     for (int i = 0; i < n_directions; ++i)
-    {
-      if (other._max_values[i] < _min_values[i] ||
-          other._min_values[i] > _max_values[i])
-      {
-        return false;
-      }
-    }
-    return true;
+      separated |= (other._max_values[i] < _min_values[i]) |
+                   (other._min_values[i] > _max_values[i]);
+    return !separated;
   }
 };
 
@@ -0,0 +1,156 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+#ifndef ARBORX_PERIODIC_HPP
+#define ARBORX_PERIODIC_HPP
+
+#include <ArborX_Box.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_Point.hpp>
+#include <ArborX_Sphere.hpp>
+
+#include <Kokkos_MathematicalFunctions.hpp>
+
+#include <type_traits>
+
+namespace ArborX
+{
+namespace Experimental
+{
+
+// Geometry located in a domain that is periodic along all dimensions, e.g.
+// the simulation box of particles. The primitives are indexed once, without
+// ghost copies, and the predicates on a periodic geometry match the
+// primitives close to any of its images, the distances being those to the
+// nearest image. Only the extents of the domain matter, and the primitives
+// may lie outside of it. Primitives within reach of several images, when the
+// geometry extends over more than half of the domain, are found once.
+template <typename Geometry>
+struct Periodic
+{
+  Geometry _geometry = {};
+  Box _domain = {};
+
+  KOKKOS_DEFAULTED_FUNCTION
+  constexpr Periodic() = default;
+
+  KOKKOS_FUNCTION
+  constexpr Periodic(Geometry const &geometry, Box const &domain)
+      : _geometry(geometry)
+      , _domain(domain)
+  {}
+
+  KOKKOS_FUNCTION
+  constexpr Geometry const &geometry() const { return _geometry; }
+
+  KOKKOS_FUNCTION
+  constexpr Box const &domain() const { return _domain; }
+};
+
+} // namespace Experimental
+
+namespace Details
+{
+// Distance along a dimension of period L from the interval [lower, upper] to
+// the nearest image of the point at x
+KOKKOS_INLINE_FUNCTION float periodicDistance(float x, float lower,
+                                              float upper, float L)
+{
+  auto const width = upper - lower;
+  if (width >= L)
+    return 0;
+  auto t = x - lower;
+  t -= L * Kokkos::floor(t / L);
+  if (t <= width)
+    return 0;
+  return KokkosExt::min(t - width, L - t);
+}
+
+// Minimum image distance from the point to the box, the box being widened
+// by the given half extents of the geometry around the point
+KOKKOS_INLINE_FUNCTION float
+periodicDistance(Point const &point, Box const &box, Box const &domain,
+                 Point const &half_extents = {0, 0, 0})
+{
+  float distance_squared = 0;
+  for (int d = 0; d < 3; ++d)
+  {
+    auto const delta = periodicDistance(
+        point[d], box.minCorner()[d] - half_extents[d],
+        box.maxCorner()[d] + half_extents[d],
+        domain.maxCorner()[d] - domain.minCorner()[d]);
+    distance_squared += delta * delta;
+  }
+  return Kokkos::sqrt(distance_squared);
+}
+} // namespace Details
+
+namespace Experimental
+{
+
+template <typename Other,
+          std::enable_if_t<std::is_same_v<Other, Point> ||
+                           std::is_same_v<Other, Box>> * = nullptr>
+KOKKOS_INLINE_FUNCTION float distance(Periodic<Point> const &periodic,
+                                      Other const &other)
+{
+  Box box{};
+  box += other;
+  return Details::periodicDistance(periodic.geometry(), box,
+                                   periodic.domain());
+}
+
+template <typename Other,
+          std::enable_if_t<std::is_same_v<Other, Point> ||
+                           std::is_same_v<Other, Box>> * = nullptr>
+KOKKOS_INLINE_FUNCTION float distance(Periodic<Sphere> const &periodic,
+                                      Other const &other)
+{
+  auto const &sphere = periodic.geometry();
+  return KokkosExt::max(
+      distance(Periodic<Point>{sphere.centroid(), periodic.domain()}, other) -
+          sphere.radius(),
+      0.f);
+}
+
+template <typename Other,
+          std::enable_if_t<std::is_same_v<Other, Point> ||
+                           std::is_same_v<Other, Box>> * = nullptr>
+KOKKOS_INLINE_FUNCTION float distance(Periodic<Box> const &periodic,
+                                      Other const &other)
+{
+  // The boxes are as far apart as the center of one from the other widened
+  // by the half extents of the first
+  auto const &box = periodic.geometry();
+  Point center;
+  Point half_extents;
+  for (int d = 0; d < 3; ++d)
+  {
+    center[d] = (box.minCorner()[d] + box.maxCorner()[d]) / 2;
+    half_extents[d] = (box.maxCorner()[d] - box.minCorner()[d]) / 2;
+  }
+  Box other_box{};
+  other_box += other;
+  return Details::periodicDistance(center, other_box, periodic.domain(),
+                                   half_extents);
+}
+
+template <typename Geometry, typename Other>
+KOKKOS_INLINE_FUNCTION auto intersects(Periodic<Geometry> const &periodic,
+                                       Other const &other)
+    -> decltype(distance(periodic, other) <= 0)
+{
+  return distance(periodic, other) <= 0;
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
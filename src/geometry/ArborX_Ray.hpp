@@ -23,6 +23,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <type_traits>
 
 namespace ArborX
 {
@@ -162,8 +163,11 @@ Point returnCentroid(Ray const &ray) { return ray.origin(); }
 // [2] Williams, A., Barrus, S., Morley, R. K., & Shirley, P. (2005). An
 // efficient and robust ray-box intersection algorithm. In ACM SIGGRAPH 2005
 // Courses (pp. 9-es).
-KOKKOS_INLINE_FUNCTION
-bool intersection(Ray const &ray, Box const &box, float &tmin, float &tmax)
+template <typename Box,
+          std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                           GeometryTraits::dimension_v<Box> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION bool intersection(Ray const &ray, Box const &box,
+                                         float &tmin, float &tmax)
 {
   auto const &min = box.minCorner();
   auto const &max = box.maxCorner();
@@ -196,8 +200,10 @@ bool intersection(Ray const &ray, Box const &box, float &tmin, float &tmax)
   return (tmin <= tmax);
 }
 
-KOKKOS_INLINE_FUNCTION
-bool intersects(Ray const &ray, Box const &box)
+template <typename Box,
+          std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                           GeometryTraits::dimension_v<Box> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION bool intersects(Ray const &ray, Box const &box)
 {
   float tmin;
   float tmax;
@@ -454,13 +460,106 @@ intersects(Ray const &ray,
   return intersection(ray, triangle, tmin, tmax) && (tmax >= 0.f);
 }
 
+// Returns the first nonnegative value of t at which the ray hits the triangle,
+// or inf if it misses it, as for boxes
+KOKKOS_INLINE_FUNCTION float
+distance(Ray const &ray,
+         ExperimentalHyperGeometry::Triangle<3> const &triangle)
+{
+  float tmin;
+  float tmax;
+  bool intersects = intersection(ray, triangle, tmin, tmax) && (tmax >= 0.f);
+  return intersects ? (tmin > 0.f ? tmin : 0.f)
+                    : KokkosExt::ArithmeticTraits::infinity<float>::value;
+}
+
 // Returns the first positive value for t such that ray.origin + t * direction
 // intersects the given box. If no such value exists, returns inf.
 // Note that this definiton is different from the standard
 // "smallest distance between a point on the ray and a point in the box"
 // so we can use nearest queries for ray tracing.
+template <typename Box,
+          std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                           GeometryTraits::dimension_v<Box> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION float distance(Ray const &ray, Box const &box)
+{
+  float tmin;
+  float tmax;
+  bool intersects = intersection(ray, box, tmin, tmax) && (tmax >= 0.f);
+  return intersects ? (tmin > 0.f ? tmin : 0.f)
+                    : KokkosExt::ArithmeticTraits::infinity<float>::value;
+}
+
+// Ray along with the inverse of its direction and the signs of the latter,
+// computed once per query so that the tests against the many bounding boxes
+// visited during a traversal use multiplications instead of divisions and pick
+// the near and far corners without branching. Other geometries are tested
+// against the ray itself.
+struct PrecomputedRay
+{
+  Ray _ray;
+  Vector _inv_direction;
+  int _sign[3];
+};
+
 KOKKOS_INLINE_FUNCTION
-float distance(Ray const &ray, Box const &box)
+PrecomputedRay precompute(Ray const &ray)
+{
+  PrecomputedRay precomputed{ray, {}, {}};
+  for (int d = 0; d < 3; ++d)
+  {
+    precomputed._inv_direction[d] = 1.f / ray.direction()[d];
+    precomputed._sign[d] = (precomputed._inv_direction[d] < 0 ? 1 : 0);
+  }
+  return precomputed;
+}
+
+// Same slab test as intersection(Ray, Box, tmin, tmax). The products are NaN
+// when the origin lies on the plane of a face parallel to the ray, and the
+// comparisons, being false for NaN, then leave that slab out just as there.
+template <typename Box,
+          std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                           GeometryTraits::dimension_v<Box> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION bool intersection(PrecomputedRay const &ray,
+                                         Box const &box, float &tmin,
+                                         float &tmax)
+{
+  auto const &orig = ray._ray.origin();
+  auto const &inv_dir = ray._inv_direction;
+  using Corner = std::decay_t<decltype(box.minCorner())>;
+  Corner const *const corners[2] = {&box.minCorner(), &box.maxCorner()};
+
+  constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
+  tmin = -inf;
+  tmax = inf;
+
+  for (int d = 0; d < 3; ++d)
+  {
+    float const tdmin = ((*corners[ray._sign[d]])[d] - orig[d]) * inv_dir[d];
+    float const tdmax =
+        ((*corners[1 - ray._sign[d]])[d] - orig[d]) * inv_dir[d];
+    tmin = (tmin < tdmin ? tdmin : tmin);
+    tmax = (tmax > tdmax ? tdmax : tmax);
+  }
+  return (tmin <= tmax);
+}
+
+template <typename Box,
+          std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                           GeometryTraits::dimension_v<Box> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION bool intersects(PrecomputedRay const &ray,
+                                       Box const &box)
+{
+  float tmin;
+  float tmax;
+  return intersection(ray, box, tmin, tmax) && (tmax >= 0.f);
+}
+
+template <typename Box,
+          std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                           GeometryTraits::dimension_v<Box> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION float distance(PrecomputedRay const &ray,
+                                      Box const &box)
 {
   float tmin;
   float tmax;
@@ -469,6 +568,22 @@ float distance(Ray const &ray, Box const &box)
                     : KokkosExt::ArithmeticTraits::infinity<float>::value;
 }
 
+template <typename Geometry,
+          std::enable_if_t<!GeometryTraits::is_box<Geometry>{}> * = nullptr>
+KOKKOS_INLINE_FUNCTION bool intersects(PrecomputedRay const &ray,
+                                       Geometry const &geometry)
+{
+  return intersects(ray._ray, geometry);
+}
+
+template <typename Geometry,
+          std::enable_if_t<!GeometryTraits::is_box<Geometry>{}> * = nullptr>
+KOKKOS_INLINE_FUNCTION float distance(PrecomputedRay const &ray,
+                                      Geometry const &geometry)
+{
+  return distance(ray._ray, geometry);
+}
+
 // Solves a*x^2 + b*x + c = 0.
 // If a solution exists, return true and stores roots at x1, x2.
 // If a solution does not exist, returns false.
@@ -542,6 +657,25 @@ KOKKOS_INLINE_FUNCTION bool intersection(Ray const &ray, Sphere const &sphere,
   return false;
 }
 
+KOKKOS_INLINE_FUNCTION bool intersects(Ray const &ray, Sphere const &sphere)
+{
+  float tmin;
+  float tmax;
+  // intersects only if sphere is in front of the ray
+  return intersection(ray, sphere, tmin, tmax) && (tmax >= 0.f);
+}
+
+// Returns the first nonnegative value of t at which the ray hits the sphere,
+// or inf if it misses it, as for boxes
+KOKKOS_INLINE_FUNCTION float distance(Ray const &ray, Sphere const &sphere)
+{
+  float tmin;
+  float tmax;
+  bool intersects = intersection(ray, sphere, tmin, tmax) && (tmax >= 0.f);
+  return intersects ? (tmin > 0.f ? tmin : 0.f)
+                    : KokkosExt::ArithmeticTraits::infinity<float>::value;
+}
+
 template <typename Geometry>
 KOKKOS_INLINE_FUNCTION void
 overlapDistance(Ray const &ray, Geometry const &geometry, float &length,
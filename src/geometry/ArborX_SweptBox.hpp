@@ -0,0 +1,231 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+#ifndef ARBORX_SWEPT_BOX_HPP
+#define ARBORX_SWEPT_BOX_HPP
+
+#include <ArborX_Box.hpp>
+#include <ArborX_DetailsAlgorithms.hpp> // returnCentroid
+#include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
+#include <ArborX_GeometryTraits.hpp>
+#include <ArborX_KDOP.hpp>
+#include <ArborX_Point.hpp>
+#include <ArborX_Ray.hpp> // Vector
+
+#include <Kokkos_Macros.hpp>
+
+#include <type_traits>
+
+namespace ArborX
+{
+namespace Experimental
+{
+
+// Box moving by translation during a time step, from its position at the
+// beginning of the step to that position shifted by the displacement at its
+// end. Times are given as fractions of the step, between 0 and 1.
+struct SweptBox
+{
+  Box _box = {};
+  Vector _displacement = {};
+
+  KOKKOS_DEFAULTED_FUNCTION
+  constexpr SweptBox() = default;
+
+  KOKKOS_FUNCTION
+  constexpr SweptBox(Box const &box, Vector const &displacement)
+      : _box(box)
+      , _displacement(displacement)
+  {}
+
+  KOKKOS_FUNCTION
+  constexpr Box &box() { return _box; }
+
+  KOKKOS_FUNCTION
+  constexpr Box const &box() const { return _box; }
+
+  KOKKOS_FUNCTION
+  constexpr Vector &displacement() { return _displacement; }
+
+  KOKKOS_FUNCTION
+  constexpr Vector const &displacement() const { return _displacement; }
+};
+
+// Segment from a start to an end point. It is swept by a point, and the times
+// are the fractions of its length from the start.
+struct Segment
+{
+  Point _start = {};
+  Point _end = {};
+
+  KOKKOS_FUNCTION
+  constexpr Point &start() { return _start; }
+
+  KOKKOS_FUNCTION
+  constexpr Point const &start() const { return _start; }
+
+  KOKKOS_FUNCTION
+  constexpr Point &end() { return _end; }
+
+  KOKKOS_FUNCTION
+  constexpr Point const &end() const { return _end; }
+};
+
+KOKKOS_INLINE_FUNCTION
+constexpr SweptBox sweep(Segment const &segment)
+{
+  return {Box{segment.start(), segment.start()},
+          makeVector(segment.start(), segment.end())};
+}
+
+KOKKOS_INLINE_FUNCTION
+Point returnCentroid(SweptBox const &swept)
+{
+  auto c = Details::returnCentroid(swept.box());
+  for (int d = 0; d < 3; ++d)
+    c[d] += swept.displacement()[d] / 2;
+  return c;
+}
+
+KOKKOS_INLINE_FUNCTION
+Point returnCentroid(Segment const &segment)
+{
+  return returnCentroid(sweep(segment));
+}
+
+} // namespace Experimental
+
+namespace Details
+{
+// Narrow the interval [tmin, tmax] to the times t for which t * velocity lies
+// in [lower, upper]. This is the slab test of the rays, the slab of the
+// target being widened by the extent of the moving box.
+KOKKOS_INLINE_FUNCTION void clipSweptSlab(float lower, float upper,
+                                          float velocity, float &tmin,
+                                          float &tmax)
+{
+  using KokkosExt::max;
+  using KokkosExt::min;
+
+  if (velocity == 0)
+  {
+    if (lower > 0 || upper < 0)
+    {
+      tmin = KokkosExt::ArithmeticTraits::infinity<float>::value;
+      tmax = -KokkosExt::ArithmeticTraits::infinity<float>::value;
+    }
+    return;
+  }
+  tmin = max(tmin, (velocity > 0 ? lower : upper) / velocity);
+  tmax = min(tmax, (velocity > 0 ? upper : lower) / velocity);
+}
+} // namespace Details
+
+namespace Experimental
+{
+
+// Computes the interval of times [tmin, tmax] during which the swept box
+// overlaps the given box. Returns false if they never do during the step.
+// Empty boxes are never hit.
+template <typename Box,
+          std::enable_if_t<GeometryTraits::is_box<Box>{} &&
+                           GeometryTraits::dimension_v<Box> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION bool intersection(SweptBox const &swept, Box const &box,
+                                         float &tmin, float &tmax)
+{
+  tmin = 0;
+  tmax = 1;
+  for (int d = 0; d < 3; ++d)
+    Details::clipSweptSlab(box.minCorner()[d] - swept.box().maxCorner()[d],
+                           box.maxCorner()[d] - swept.box().minCorner()[d],
+                           swept.displacement()[d], tmin, tmax);
+  return (tmin <= tmax);
+}
+
+template <typename Point,
+          std::enable_if_t<GeometryTraits::is_point<Point>{} &&
+                           GeometryTraits::dimension_v<Point> == 3> * = nullptr>
+KOKKOS_INLINE_FUNCTION bool intersection(SweptBox const &swept,
+                                         Point const &point, float &tmin,
+                                         float &tmax)
+{
+  tmin = 0;
+  tmax = 1;
+  for (int d = 0; d < 3; ++d)
+    Details::clipSweptSlab(point[d] - swept.box().maxCorner()[d],
+                           point[d] - swept.box().minCorner()[d],
+                           swept.displacement()[d], tmin, tmax);
+  return (tmin <= tmax);
+}
+
+// The k-DOP is tested along its own directions only, the swept box being
+// projected onto them. This is conservative, as for the boxes against k-DOPs.
+template <int k>
+KOKKOS_INLINE_FUNCTION bool intersection(SweptBox const &swept,
+                                         KDOP<k> const &kdop, float &tmin,
+                                         float &tmax)
+{
+  KDOP<k> start;
+  start += swept.box();
+  KDOP<k> velocity;
+  velocity += Point{swept.displacement()[0], swept.displacement()[1],
+                    swept.displacement()[2]};
+
+  tmin = 0;
+  tmax = 1;
+  for (int i = 0; i < KDOP<k>::n_directions; ++i)
+    Details::clipSweptSlab(kdop._min_values[i] - start._max_values[i],
+                           kdop._max_values[i] - start._min_values[i],
+                           velocity._min_values[i], tmin, tmax);
+  return (tmin <= tmax);
+}
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION bool intersects(SweptBox const &swept,
+                                       Geometry const &geometry)
+{
+  float tmin;
+  float tmax;
+  return intersection(swept, geometry, tmin, tmax);
+}
+
+// Returns the time of impact, i.e. the first time at which the swept box
+// touches the geometry, or inf if it does not during the step. As for rays,
+// this lets ordered spatial queries report the earliest contacts first.
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION float distance(SweptBox const &swept,
+                                      Geometry const &geometry)
+{
+  float tmin;
+  float tmax;
+  return intersection(swept, geometry, tmin, tmax)
+             ? tmin
+             : KokkosExt::ArithmeticTraits::infinity<float>::value;
+}
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION bool intersects(Segment const &segment,
+                                       Geometry const &geometry)
+{
+  return intersects(sweep(segment), geometry);
+}
+
+template <typename Geometry>
+KOKKOS_INLINE_FUNCTION float distance(Segment const &segment,
+                                      Geometry const &geometry)
+{
+  return distance(sweep(segment), geometry);
+}
+
+} // namespace Experimental
+} // namespace ArborX
+
+#endif
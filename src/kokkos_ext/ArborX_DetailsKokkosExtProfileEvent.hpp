@@ -0,0 +1,39 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#ifndef ARBORX_DETAILS_KOKKOS_EXT_PROFILE_EVENT_HPP
+#define ARBORX_DETAILS_KOKKOS_EXT_PROFILE_EVENT_HPP
+
+#include <Kokkos_Core.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace KokkosExt
+{
+
+// Mark an event "name=value" for the Kokkos Tools, e.g.
+// "ArborX::CrsGraphWrapper::query::spatial::predicates=1000", so that tools
+// can relate the regions around it to the sizes of the workload. The event is
+// only formatted if a tool is listening.
+template <typename T>
+void markProfileEvent(std::string const &name, T const &value)
+{
+  if (!Kokkos::Tools::profileLibraryLoaded())
+    return;
+  std::ostringstream os;
+  os << std::boolalpha << name << '=' << value;
+  Kokkos::Tools::markEvent(os.str());
+}
+
+} // namespace KokkosExt
+
+#endif
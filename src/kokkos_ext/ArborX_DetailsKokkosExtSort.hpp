@@ -14,11 +14,16 @@
 
 #include <ArborX_Config.hpp> // ARBORX_ENABLE_ROCTHRUST
 
+#include <ArborX_DetailsKokkosExtAccessibilityTraits.hpp>
+#include <ArborX_DetailsKokkosExtMinMaxOperations.hpp>
 #include <ArborX_DetailsKokkosExtScopedProfileRegion.hpp>
 #include <ArborX_DetailsUtils.hpp> // minMax
 
 #include <Kokkos_Sort.hpp>
 
+#include <cstddef>
+#include <type_traits>
+
 // clang-format off
 #if defined(KOKKOS_ENABLE_CUDA)
 #  if defined(KOKKOS_COMPILER_CLANG)
@@ -48,6 +53,7 @@
 #      define ARBORX_CubLog_save _CubLog
 #    endif
 #    define _CubLog
+#    include <cub/device/device_radix_sort.cuh>
 #    include <thrust/device_ptr.h>
 #    include <thrust/sort.h>
 #    undef _CubLog
@@ -56,6 +62,7 @@
 #      undef ARBORX_CubLog_save
 #    endif
 #  else // #if defined(KOKKOS_COMPILER_CLANG)
+#    include <cub/device/device_radix_sort.cuh>
 #    include <thrust/device_ptr.h>
 #    include <thrust/sort.h>
 #  endif // #if defined(KOKKOS_COMPILER_CLANG)
@@ -76,10 +83,138 @@
 namespace KokkosExt
 {
 
+namespace Impl
+{
+
+// One pass of the radix sort, stably scattering the keys and the values by
+// the digit at the given bit offset. The input is split into contiguous
+// chunks, each of which is processed by a single thread. Returns false if all
+// keys share the same digit, in which case nothing is moved.
+template <typename ExecutionSpace, typename SrcKeys, typename SrcValues,
+          typename DstKeys, typename DstValues, typename Offsets,
+          typename UnsignedKey>
+bool radixSortPass(ExecutionSpace const &space, SrcKeys const &src_keys,
+                   SrcValues const &src_values, DstKeys const &dst_keys,
+                   DstValues const &dst_values, Offsets const &offsets,
+                   UnsignedKey min_key, int shift)
+{
+  int const n = src_keys.size();
+  int const num_chunks = offsets.extent_int(0);
+  int const num_buckets = offsets.extent_int(1);
+  int const chunk_size = (n + num_chunks - 1) / num_chunks;
+  auto digit = KOKKOS_LAMBDA(int i) {
+    return (int)((((UnsignedKey)src_keys(i) - min_key) >> shift) &
+                 (num_buckets - 1));
+  };
+
+  Kokkos::parallel_for(
+      "ArborX::KokkosExt::sortByKey::radix_histogram",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_chunks),
+      KOKKOS_LAMBDA(int chunk) {
+        for (int b = 0; b < num_buckets; ++b)
+          offsets(chunk, b) = 0;
+        int const last = KokkosExt::min(n, (chunk + 1) * chunk_size);
+        for (int i = chunk * chunk_size; i < last; ++i)
+          ++offsets(chunk, digit(i));
+      });
+  space.fence();
+
+  // Offsets are ordered by bucket first and by chunk second to keep the sort
+  // stable
+  int sum = 0;
+  for (int b = 0; b < num_buckets; ++b)
+    for (int chunk = 0; chunk < num_chunks; ++chunk)
+    {
+      int const count = offsets(chunk, b);
+      if (count == n)
+        return false;
+      offsets(chunk, b) = sum;
+      sum += count;
+    }
+
+  Kokkos::parallel_for(
+      "ArborX::KokkosExt::sortByKey::radix_scatter",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, num_chunks),
+      KOKKOS_LAMBDA(int chunk) {
+        int const last = KokkosExt::min(n, (chunk + 1) * chunk_size);
+        for (int i = chunk * chunk_size; i < last; ++i)
+        {
+          int const pos = offsets(chunk, digit(i))++;
+          dst_keys(pos) = src_keys(i);
+          dst_values(pos) = src_values(i);
+        }
+      });
+  return true;
+}
+
+// Least significant digit radix sort for integral keys on execution spaces
+// that run on the host, where the Kokkos bin sort performs poorly. Only the
+// bits spanned by the range of the keys are sorted, so that, e.g., Morton
+// codes over a part of the curve take fewer passes.
+template <typename ExecutionSpace, typename Keys, typename Values>
+void radixSortByKey(ExecutionSpace const &space, Keys &keys, Values &values,
+                    typename Keys::non_const_value_type min_val,
+                    typename Keys::non_const_value_type max_val)
+{
+  using Key = typename Keys::non_const_value_type;
+  using Value = typename Values::non_const_value_type;
+  using UnsignedKey = std::make_unsigned_t<Key>;
+  using MemorySpace = typename Keys::memory_space;
+  constexpr int num_key_bits = 8 * sizeof(Key);
+  constexpr int radix_bits = 8;
+
+  UnsignedKey const min_key = min_val;
+  UnsignedKey const range = (UnsignedKey)max_val - min_key;
+  int num_bits = 0;
+  while (num_bits < num_key_bits && (range >> num_bits) != 0)
+    ++num_bits;
+
+  int const n = keys.size();
+  // Keep chunks large enough for the histograms to pay off
+  int const num_chunks =
+      KokkosExt::max(1, KokkosExt::min((int)space.concurrency(), n / 4096));
+
+  Kokkos::View<int **, Kokkos::LayoutRight, Kokkos::HostSpace> offsets(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "ArborX::KokkosExt::sortByKey::radix_offsets"),
+      num_chunks, 1 << radix_bits);
+  Kokkos::View<Key *, MemorySpace> keys_buffer(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::KokkosExt::sortByKey::keys_buffer"),
+      n);
+  Kokkos::View<Value *, typename Values::memory_space> values_buffer(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "ArborX::KokkosExt::sortByKey::values_buffer"),
+      n);
+
+  bool in_buffer = false;
+  for (int shift = 0; shift < num_bits; shift += radix_bits)
+  {
+    bool const moved =
+        in_buffer ? radixSortPass(space, keys_buffer, values_buffer, keys,
+                                  values, offsets, min_key, shift)
+                  : radixSortPass(space, keys, values, keys_buffer,
+                                  values_buffer, offsets, min_key, shift);
+    in_buffer ^= moved;
+  }
+  if (in_buffer)
+  {
+    Kokkos::deep_copy(space, keys, keys_buffer);
+    Kokkos::deep_copy(space, values, values_buffer);
+  }
+}
+
+} // namespace Impl
+
 template <typename ExecutionSpace, typename Keys, typename Values>
 void sortByKey(ExecutionSpace const &space, Keys &keys, Values &values)
 {
-  KokkosExt::ScopedProfileRegion guard("ArborX::KokkosExt::sortByKey::Kokkos");
+  constexpr bool use_radix_sort =
+      std::is_integral_v<typename Keys::non_const_value_type> &&
+      KokkosExt::is_accessible_from<Kokkos::HostSpace, ExecutionSpace>::value;
+  KokkosExt::ScopedProfileRegion guard(
+      use_radix_sort ? "ArborX::KokkosExt::sortByKey::RadixSort"
+                     : "ArborX::KokkosExt::sortByKey::Kokkos");
 
   static_assert(Kokkos::is_view<Keys>::value);
   static_assert(Kokkos::is_view<Values>::value);
@@ -99,6 +234,12 @@ void sortByKey(ExecutionSpace const &space, Keys &keys, Values &values)
   if (min_val == max_val)
     return;
 
+  if constexpr (use_radix_sort)
+  {
+    Impl::radixSortByKey(space, keys, values, min_val, max_val);
+    return;
+  }
+
   using SizeType = unsigned int;
   using CompType = Kokkos::BinOp1D<Keys>;
 
@@ -120,7 +261,15 @@ void sortByKey(
 #endif
     Keys &keys, Values &values)
 {
-  KokkosExt::ScopedProfileRegion guard("ArborX::KokkosExt::sortByKey::Thrust");
+  using Key = typename Keys::non_const_value_type;
+#if defined(KOKKOS_ENABLE_CUDA)
+  constexpr bool use_cub = std::is_arithmetic_v<Key>;
+#else
+  constexpr bool use_cub = false;
+#endif
+  KokkosExt::ScopedProfileRegion guard(
+      use_cub ? "ArborX::KokkosExt::sortByKey::CUB"
+              : "ArborX::KokkosExt::sortByKey::Thrust");
 
   using ExecutionSpace = std::decay_t<decltype(space)>;
   static_assert(Kokkos::is_view<Keys>::value);
@@ -138,6 +287,47 @@ void sortByKey(
     return;
 
 #if defined(KOKKOS_ENABLE_CUDA)
+  if constexpr (use_cub)
+  {
+    // Unlike Thrust, the radix sort of CUB neither allocates its temporary
+    // storage itself nor synchronizes on return, so that sorts on different
+    // instances can overlap
+    using Value = typename Values::non_const_value_type;
+    Kokkos::View<Key *, typename Keys::memory_space> keys_buffer(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::KokkosExt::sortByKey::keys_buffer"),
+        n);
+    Kokkos::View<Value *, typename Values::memory_space> values_buffer(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::KokkosExt::sortByKey::values_buffer"),
+        n);
+    cub::DoubleBuffer<Key> keys_double_buffer(keys.data(), keys_buffer.data());
+    cub::DoubleBuffer<Value> values_double_buffer(values.data(),
+                                                  values_buffer.data());
+
+    std::size_t temporary_storage_size = 0;
+    cub::DeviceRadixSort::SortPairs(
+        nullptr, temporary_storage_size, keys_double_buffer,
+        values_double_buffer, (int)n, 0, 8 * (int)sizeof(Key),
+        space.cuda_stream());
+    Kokkos::View<char *, typename Keys::memory_space> temporary_storage(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::KokkosExt::sortByKey::temporary_storage"),
+        temporary_storage_size);
+    cub::DeviceRadixSort::SortPairs(
+        temporary_storage.data(), temporary_storage_size, keys_double_buffer,
+        values_double_buffer, (int)n, 0, 8 * (int)sizeof(Key),
+        space.cuda_stream());
+
+    // The sorted data ends up in either buffer depending on the number of
+    // passes
+    if (keys_double_buffer.Current() != keys.data())
+      Kokkos::deep_copy(space, keys, keys_buffer);
+    if (values_double_buffer.Current() != values.data())
+      Kokkos::deep_copy(space, values, values_buffer);
+    return;
+  }
+
   auto const execution_policy = thrust::cuda::par.on(space.cuda_stream());
 #else
   auto const execution_policy = thrust::hip::par.on(space.hip_stream());
@@ -185,6 +375,56 @@ void sortByKey(Kokkos::Experimental::SYCL const &space, Keys &keys,
 }
 #endif
 
+// Sort of the keys alone, e.g., when the values are packed into the low bits
+// of the keys
+template <typename ExecutionSpace, typename Keys>
+void sort(ExecutionSpace const &space, Keys &keys)
+{
+  static_assert(Kokkos::is_view<Keys>::value);
+  static_assert(Keys::rank == 1);
+  static_assert(KokkosExt::is_accessible_from<typename Keys::memory_space,
+                                              ExecutionSpace>::value);
+  auto const n = keys.size();
+
+  if (n == 0)
+    return;
+
+#if defined(KOKKOS_ENABLE_CUDA)
+  using Key = typename Keys::non_const_value_type;
+  if constexpr (std::is_same_v<ExecutionSpace, Kokkos::Cuda> &&
+                std::is_arithmetic_v<Key>)
+  {
+    KokkosExt::ScopedProfileRegion guard("ArborX::KokkosExt::sort::CUB");
+
+    Kokkos::View<Key *, typename Keys::memory_space> keys_buffer(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::KokkosExt::sort::keys_buffer"),
+        n);
+    cub::DoubleBuffer<Key> keys_double_buffer(keys.data(), keys_buffer.data());
+
+    std::size_t temporary_storage_size = 0;
+    cub::DeviceRadixSort::SortKeys(nullptr, temporary_storage_size,
+                                   keys_double_buffer, (int)n, 0,
+                                   8 * (int)sizeof(Key), space.cuda_stream());
+    Kokkos::View<char *, typename Keys::memory_space> temporary_storage(
+        Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                           "ArborX::KokkosExt::sort::temporary_storage"),
+        temporary_storage_size);
+    cub::DeviceRadixSort::SortKeys(temporary_storage.data(),
+                                   temporary_storage_size, keys_double_buffer,
+                                   (int)n, 0, 8 * (int)sizeof(Key),
+                                   space.cuda_stream());
+
+    if (keys_double_buffer.Current() != keys.data())
+      Kokkos::deep_copy(space, keys, keys_buffer);
+    return;
+  }
+#endif
+
+  KokkosExt::ScopedProfileRegion guard("ArborX::KokkosExt::sort::Kokkos");
+  Kokkos::sort(space, keys);
+}
+
 } // namespace KokkosExt
 
 #endif
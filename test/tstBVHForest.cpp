@@ -0,0 +1,109 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_BVHForest.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(BVHForest)
+
+namespace tt = boost::test_tools;
+
+template <typename DeviceType>
+auto makeIntersectsBoxInTreeQueries(std::vector<ArborX::Box> const &boxes,
+                                    std::vector<int> const &tree_ids)
+{
+  int const n = boxes.size();
+  Kokkos::View<decltype(ArborX::Experimental::inTree(
+                   ArborX::intersects(ArborX::Box{}), 0)) *,
+               DeviceType>
+      queries("Testing::intersecting_with_box_in_tree_predicates", n);
+  auto queries_host = Kokkos::create_mirror_view(queries);
+  for (int i = 0; i < n; ++i)
+    queries_host(i) = ArborX::Experimental::inTree(
+        ArborX::intersects(boxes[i]), tree_ids[i]);
+  Kokkos::deep_copy(queries, queries_host);
+  return queries;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(forest_query, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+  using Forest = ArborX::Experimental::BoundingVolumeHierarchyForest<Tree>;
+
+  ExecutionSpace space;
+
+  BOOST_TEST(Forest().empty());
+  BOOST_TEST(Forest(space, {}).empty());
+
+  // Trees of all sizes, including degenerate ones
+  std::vector<int> const sizes = {0, 1, 2, 37, 100, 1, 5};
+  std::vector<Tree> trees;
+  std::vector<std::vector<ArborX::Box>> primitives;
+  std::vector<ArborX::Box> query_boxes;
+  std::vector<int> tree_ids;
+  for (int t = 0; t < (int)sizes.size(); ++t)
+  {
+    auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(
+        space, sizes[t] ? sizes[t] : 1);
+    trees.emplace_back(space,
+                       Kokkos::subview(boxes, Kokkos::make_pair(0, sizes[t])));
+
+    auto const boxes_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+    primitives.emplace_back(boxes_host.data(),
+                            boxes_host.data() + sizes[t]);
+    for (int i = 0; i < (int)boxes_host.extent(0); i += 3)
+    {
+      auto box = boxes_host(i);
+      ArborX::Details::expand(box,
+                              boxes_host((i + 1) % boxes_host.extent(0)));
+      // Query the same box against every tree
+      for (int s = 0; s < (int)sizes.size(); ++s)
+      {
+        query_boxes.push_back(box);
+        tree_ids.push_back(s);
+      }
+    }
+  }
+
+  Forest forest(space, trees);
+  BOOST_TEST(forest.size() == sizes.size());
+
+  auto const forest_results =
+      query(space, forest,
+            makeIntersectsBoxInTreeQueries<DeviceType>(query_boxes, tree_ids));
+
+  // Compare against brute force search in the tree of each query
+  std::vector<int> values;
+  std::vector<int> offsets = {0};
+  for (int i = 0; i < (int)query_boxes.size(); ++i)
+  {
+    auto const &tree_primitives = primitives[tree_ids[i]];
+    for (int j = 0; j < (int)tree_primitives.size(); ++j)
+      if (ArborX::Details::intersects(query_boxes[i], tree_primitives[j]))
+        values.push_back(j);
+    offsets.push_back(values.size());
+  }
+  BOOST_TEST(forest_results == make_reference_solution(values, offsets),
+             tt::per_element());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -65,6 +65,10 @@ void test_access_traits_compile_only()
   check_valid_access_traits(PrimitivesTag{}, p);
   check_valid_access_traits(PrimitivesTag{}, v);
 
+  Kokkos::View<float *> x;
+  check_valid_access_traits(
+      PrimitivesTag{}, ArborX::Experimental::makeStructureOfArrays(x, x, x));
+
   using NearestPredicate = decltype(ArborX::nearest(ArborX::Point{}));
   Kokkos::View<NearestPredicate *> q;
   check_valid_access_traits(PredicatesTag{}, q);
@@ -99,4 +103,16 @@ void test_deduce_point_type_from_view()
       std::is_same_v<deduce_point_t<Kokkos::View<float *[2]>>, Point<2>>);
   static_assert(
       std::is_same_v<deduce_point_t<Kokkos::View<float *[5]>>, Point<5>>);
+
+  using ArborX::Experimental::StructureOfArrays;
+  static_assert(std::is_same_v<
+                deduce_point_t<StructureOfArrays<Kokkos::View<float *>, 3>>,
+                GoodOlePoint>);
+  static_assert(std::is_same_v<
+                deduce_point_t<StructureOfArrays<Kokkos::View<float *>, 2>>,
+                Point<2>>);
+  static_assert(
+      std::is_same_v<
+          deduce_point_t<StructureOfArrays<Kokkos::View<double const *>, 3>>,
+          Point<3, double>>);
 }
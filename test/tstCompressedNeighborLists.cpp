@@ -0,0 +1,102 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include "ArborX_EnableViewComparison.hpp"
+#include <ArborX_CompressedNeighborLists.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+namespace tt = boost::test_tools;
+
+template <typename MemorySpace, typename ExecutionSpace>
+auto decompress(
+    ExecutionSpace const &space,
+    ArborX::Experimental::CompressedNeighborLists<MemorySpace> const &lists)
+{
+  Kokkos::View<int *, MemorySpace> offsets("Testing::offsets", 0);
+  Kokkos::View<int *, MemorySpace> indices("Testing::indices", 0);
+  lists.decompress(space, offsets, indices);
+  return std::make_pair(
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(compressed_neighbor_lists, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Lists = ArborX::Experimental::CompressedNeighborLists<MemorySpace>;
+
+  ExecutionSpace space;
+
+  BOOST_TEST(Lists().size() == 0);
+
+  // Unsorted lists, with an empty one, a repeated index and differences
+  // taking from one to five bytes
+  Lists const lists(
+      space, ArborXTest::toView<DeviceType>(std::vector<int>{0, 3, 3, 6, 7}),
+      ArborXTest::toView<DeviceType>(
+          std::vector<int>{1 << 30, 7, 200, 300, 299, 300, 0}));
+  BOOST_TEST(lists.size() == 4);
+  // 1 + 2 + 5 bytes, then none, 2 + 1 + 1 and 1
+  BOOST_TEST(lists.memoryFootprint() == 13 + 5 * sizeof(std::size_t));
+  auto const [offsets, indices] = decompress(space, lists);
+  BOOST_TEST(offsets == (std::vector<int>{0, 3, 3, 6, 7}), tt::per_element());
+  BOOST_TEST(indices == (std::vector<int>{7, 200, 1 << 30, 299, 300, 300, 0}),
+             tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(query_compressed, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  std::vector<std::pair<ArborX::Point, float>> spheres;
+  for (int i = 0; i < n; i += 2)
+    spheres.emplace_back(points_host(i), 0.3f);
+  auto const queries = makeIntersectsSphereQueries<DeviceType>(spheres);
+  auto const reference = query(space, bvh, queries);
+
+  for (int chunk_size : {1, 7, n})
+  {
+    auto const lists =
+        ArborX::Experimental::queryCompressed(space, bvh, queries, chunk_size);
+    BOOST_TEST(lists.size() == (int)spheres.size());
+    auto const [offsets, indices] = decompress(space, lists);
+    BOOST_TEST(make_compressed_storage(offsets, indices) == reference,
+               tt::per_element());
+  }
+
+  auto const no_lists = ArborX::Experimental::queryCompressed(
+      space, bvh, makeIntersectsSphereQueries<DeviceType>({}), 7);
+  BOOST_TEST(no_lists.size() == 0);
+}
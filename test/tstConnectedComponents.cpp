@@ -0,0 +1,82 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include "ArborX_EnableViewComparison.hpp"
+#include <ArborX_ConnectedComponents.hpp>
+
+#include "BoostTest_CUDA_clang_workarounds.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(ConnectedComponents)
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(connected_components, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Point;
+  using ArborXTest::toView;
+
+  ExecutionSpace space;
+
+  // Points along a line, the gaps between consecutive points being 1, 3, 1,
+  // 1, 5 and 2
+  std::vector<Point> cloud{{{0, 0, 0}}, {{1, 0, 0}},  {{4, 0, 0}}, {{5, 0, 0}},
+                           {{6, 0, 0}}, {{11, 0, 0}}, {{13, 0, 0}}};
+  // Shuffled, so that the components are not contiguous
+  std::vector<int> const order{4, 0, 6, 2, 5, 1, 3};
+  std::vector<Point> points_host;
+  for (int i : order)
+    points_host.push_back(cloud[i]);
+  auto points = toView<DeviceType>(points_host, "Test::points");
+
+  auto components = [&](float radius) {
+    using Predicate = decltype(ArborX::intersects(ArborX::Sphere{}));
+    std::vector<Predicate> predicates_host;
+    for (auto const &point : points_host)
+      predicates_host.push_back(
+          ArborX::intersects(ArborX::Sphere{point, radius}));
+    auto predicates = toView<DeviceType>(predicates_host, "Test::predicates");
+
+    auto labels = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{},
+        ArborX::Experimental::connectedComponents(space, points, predicates));
+    return std::vector<int>(labels.data(), labels.data() + labels.size());
+  };
+
+  // The shuffled points are at 6, 0, 13, 4, 11, 1 and 5
+  BOOST_TEST(components(0.5f) == (std::vector<int>{0, 1, 2, 3, 4, 5, 6}),
+             tt::per_element());
+  BOOST_TEST(components(1.f) == (std::vector<int>{0, 1, 2, 0, 4, 1, 0}),
+             tt::per_element());
+  BOOST_TEST(components(2.f) == (std::vector<int>{0, 1, 2, 0, 2, 1, 0}),
+             tt::per_element());
+  BOOST_TEST(components(3.f) == (std::vector<int>{0, 0, 2, 0, 2, 0, 0}),
+             tt::per_element());
+  BOOST_TEST(components(5.f) == (std::vector<int>{0, 0, 0, 0, 0, 0, 0}),
+             tt::per_element());
+
+  // No points
+  auto no_points = toView<DeviceType>(std::vector<Point>{}, "Test::points");
+  auto no_predicates = toView<DeviceType>(
+      std::vector<decltype(ArborX::intersects(ArborX::Sphere{}))>{},
+      "Test::predicates");
+  BOOST_TEST(ArborX::Experimental::connectedComponents(space, no_points,
+                                                       no_predicates)
+                 .size() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
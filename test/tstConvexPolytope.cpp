@@ -0,0 +1,124 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+#include <ArborX_Box.hpp>
+#include <ArborX_ConvexPolytope.hpp>
+#include <ArborX_KDOP.hpp>
+#include <ArborX_Point.hpp>
+#include <ArborX_Sphere.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+// Frustum with its apex at the origin, looking along the z-axis with a field
+// of view of 90 degrees, and clipped between z = 1 and z = 10
+ArborX::Experimental::ConvexPolytope<6> makeFrustum()
+{
+  ArborX::Experimental::ConvexPolytope<6> frustum;
+  frustum.add({{0, 0, -1}, -1});
+  frustum.add({{0, 0, 1}, 10});
+  frustum.add({{1, 0, -1}, 0});
+  frustum.add({{-1, 0, -1}, 0});
+  frustum.add({{0, 1, -1}, 0});
+  frustum.add({{0, -1, -1}, 0});
+  return frustum;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(convex_polytope_intersects_point)
+{
+  using ArborX::Point;
+
+  auto const frustum = makeFrustum();
+  BOOST_TEST(frustum.size() == 6);
+  BOOST_TEST(frustum.allPlanes() == 0x3fu);
+
+  BOOST_TEST(intersects(frustum, Point{0, 0, 5}));
+  BOOST_TEST(intersects(frustum, Point{5, -5, 5}));
+  BOOST_TEST(!intersects(frustum, Point{6, 0, 5}));
+  BOOST_TEST(!intersects(frustum, Point{0, 0, .5}));
+  BOOST_TEST(!intersects(frustum, Point{0, 0, 11}));
+
+  // no half-space, the whole space
+  BOOST_TEST(intersects(ArborX::Experimental::ConvexPolytope<6>{},
+                        Point{0, 0, -100}));
+}
+
+BOOST_AUTO_TEST_CASE(convex_polytope_intersects_box)
+{
+  using ArborX::Box;
+  using ArborX::Experimental::ConvexPolytope;
+
+  auto const frustum = makeFrustum();
+  using Mask = ConvexPolytope<6>::Mask;
+
+  // inside all the planes, none are left to test
+  Mask mask = frustum.allPlanes();
+  BOOST_TEST(intersects(frustum, Box{{-1, -1, 4}, {1, 1, 6}}, mask));
+  BOOST_TEST(mask == 0u);
+
+  // straddles the plane x = z only
+  mask = frustum.allPlanes();
+  BOOST_TEST(intersects(frustum, Box{{4, -1, 4}, {6, 1, 6}}, mask));
+  BOOST_TEST(mask == Mask(1) << 2);
+
+  // planes already removed from the mask are not tested anymore
+  mask = 0;
+  BOOST_TEST(intersects(frustum, Box{{7, -1, 4}, {8, 1, 6}}, mask));
+  mask = frustum.allPlanes();
+  BOOST_TEST(!intersects(frustum, Box{{7, -1, 4}, {8, 1, 6}}, mask));
+
+  BOOST_TEST(intersects(frustum, Box{{-20, -20, 0}, {20, 20, 20}}));
+  BOOST_TEST(!intersects(frustum, Box{{-1, -1, 11}, {1, 1, 12}}));
+  BOOST_TEST(!intersects(frustum, Box{}));
+
+  // wedge x <= -|y|: the box lies outside of it but of neither of its
+  // half-spaces, which the test does not see
+  ConvexPolytope<2> wedge;
+  wedge.add({{1, 1, 0}, 0});
+  wedge.add({{1, -1, 0}, 0});
+  BOOST_TEST(intersects(wedge, Box{{.1, -1, 0}, {1, 1, 1}}));
+  BOOST_TEST(!intersects(wedge, Box{{.1, .1, 0}, {1, 1, 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(convex_polytope_intersects_sphere)
+{
+  using ArborX::Sphere;
+  using ArborX::Experimental::ConvexPolytope;
+
+  auto const frustum = makeFrustum();
+
+  ConvexPolytope<6>::Mask mask = frustum.allPlanes();
+  BOOST_TEST(intersects(frustum, Sphere{{0, 0, 5}, 1}, mask));
+  BOOST_TEST(mask == 0u);
+
+  BOOST_TEST(intersects(frustum, Sphere{{5.5, 0, 5}, 1}));
+  BOOST_TEST(!intersects(frustum, Sphere{{6, 0, 5}, .5}));
+  BOOST_TEST(!intersects(frustum, Sphere{{0, 0, 12}, 1.5}));
+}
+
+BOOST_AUTO_TEST_CASE(convex_polytope_intersects_kdop)
+{
+  using ArborX::Point;
+  using ArborX::Experimental::KDOP;
+
+  auto const frustum = makeFrustum();
+
+  KDOP<14> x;
+  x += Point{4, 0, 4};
+  x += Point{6, 0, 6};
+  BOOST_TEST(intersects(frustum, x));
+
+  KDOP<14> y;
+  y += Point{7, 0, 5};
+  y += Point{8, 1, 5};
+  BOOST_TEST(!intersects(frustum, y));
+}
@@ -16,6 +16,11 @@
 #include "BoostTest_CUDA_clang_workarounds.hpp"
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
 template <typename View>
 struct HiddenView
 {
@@ -159,7 +164,8 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan, DeviceType, ARBORX_DEVICE_TYPES)
   ExecutionSpace space;
 
   for (auto impl : {ArborX::DBSCAN::Implementation::FDBSCAN,
-                    ArborX::DBSCAN::Implementation::FDBSCAN_DenseBox})
+                    ArborX::DBSCAN::Implementation::FDBSCAN_DenseBox,
+                    ArborX::DBSCAN::Implementation::FDBSCAN_CellStencil})
   {
     ArborX::DBSCAN::Parameters params;
     params.setImplementation(impl);
@@ -258,4 +264,529 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan, DeviceType, ARBORX_DEVICE_TYPES)
   }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_shifted_dense_cells, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::dbscan;
+  using ArborX::Point;
+  using ArborX::Details::verifyDBSCAN;
+
+  ExecutionSpace space;
+
+  auto const params =
+      ArborX::DBSCAN::Parameters()
+          .setImplementation(ArborX::DBSCAN::Implementation::FDBSCAN_DenseBox)
+          .setShiftedDenseCells(true);
+
+  // With eps = sqrt(3), the cells are unit cubes. The points around (1, 1, 1)
+  // are each in a different cell of the first grid, but all in the same cell
+  // of the shifted one.
+  std::vector<Point> cloud{{{0, 0, 0}}, {{5, 5, 5}}, {{1.8, 1, 1}}};
+  for (float x : {0.9f, 1.1f})
+    for (float y : {0.9f, 1.1f})
+      for (float z : {0.9f, 1.1f})
+        cloud.push_back({{x, y, z}});
+  auto const points = toView<DeviceType, Point>(cloud);
+
+  float const r = std::sqrt(3);
+  for (int core_min_size : {2, 3, 8, 9, 10})
+    BOOST_TEST(verifyDBSCAN(space, points, r, core_min_size,
+                            dbscan(space, points, r, core_min_size, params)));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_sparse_grid, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::dbscan;
+  using ArborX::Point;
+  using ArborX::Details::verifyDBSCAN;
+
+  ExecutionSpace space;
+
+  // The full grid with eps = 0.5 over the scene would have about 4e13 cells,
+  // so that only the occupied cells are numbered
+  std::vector<Point> cloud;
+  for (float c : {0.f, 5000.f, 10000.f})
+  {
+    for (int i = 0; i < 4; ++i)
+      for (int j = 0; j < 4; ++j)
+        cloud.push_back({{c + 0.05f * i, c + 0.05f * j, c}});
+    for (int i = 1; i <= 5; ++i)
+      cloud.push_back({{c + 0.4f * i, c, c}});
+  }
+  auto const points = toView<DeviceType, Point>(cloud);
+
+  for (bool shifted_dense_cells : {false, true})
+  {
+    auto const params =
+        ArborX::DBSCAN::Parameters()
+            .setImplementation(ArborX::DBSCAN::Implementation::FDBSCAN_DenseBox)
+            .setShiftedDenseCells(shifted_dense_cells);
+    float const eps = 0.5;
+    for (int core_min_size : {2, 3, 5, 17})
+      BOOST_TEST(
+          verifyDBSCAN(space, points, eps, core_min_size,
+                       dbscan(space, points, eps, core_min_size, params)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_core_points_only, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::dbscan;
+  using ArborX::Point;
+
+  ExecutionSpace space;
+
+  // With eps = 1 and core_min_size = 3, the first four points are core
+  // points, the fifth one is a border point, and the last one is noise
+  auto const points = toView<DeviceType, Point>({{{0, 0, 0}},
+                                                 {{0.5, 0, 0}},
+                                                 {{1, 0, 0}},
+                                                 {{1.5, 0, 0}},
+                                                 {{2.5, 0, 0}},
+                                                 {{10, 0, 0}}});
+
+  for (auto implementation :
+       {ArborX::DBSCAN::Implementation::FDBSCAN,
+        ArborX::DBSCAN::Implementation::FDBSCAN_DenseBox,
+        ArborX::DBSCAN::Implementation::FDBSCAN_CellStencil})
+  {
+    auto const params = ArborX::DBSCAN::Parameters()
+                            .setImplementation(implementation)
+                            .setCorePointsOnly(true);
+    auto const labels = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, dbscan(space, points, 1.f, 3, params));
+    BOOST_TEST(labels(0) != -1);
+    for (int i = 1; i < 4; ++i)
+      BOOST_TEST(labels(i) == labels(0));
+    BOOST_TEST(labels(4) == -1);
+    BOOST_TEST(labels(5) == -1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_unfinalized_labels, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::dbscan;
+  using ArborX::Point;
+
+  ExecutionSpace space;
+
+  std::vector<Point> cloud;
+  for (int i = 0; i < 30; ++i)
+    cloud.push_back({{0.3f * i + (i % 7 == 0 ? 1.f : 0.f), 0, 0}});
+  auto const points = toView<DeviceType, Point>(cloud);
+  int const n = cloud.size();
+
+  for (auto implementation :
+       {ArborX::DBSCAN::Implementation::FDBSCAN,
+        ArborX::DBSCAN::Implementation::FDBSCAN_DenseBox,
+        ArborX::DBSCAN::Implementation::FDBSCAN_CellStencil})
+    for (int core_min_size : {2, 3, 5})
+    {
+      auto const params =
+          ArborX::DBSCAN::Parameters().setImplementation(implementation);
+      auto const labels = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{}, dbscan(space, points, 0.5f, core_min_size,
+                                      params));
+      auto const parents = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{},
+          dbscan(space, points, 0.5f, core_min_size,
+                 ArborX::DBSCAN::Parameters(params).setFinalizeLabels(false)));
+
+      std::vector<int> roots(n);
+      for (int i = 0; i < n; ++i)
+      {
+        roots[i] = i;
+        while (parents(roots[i]) != roots[i])
+          roots[i] = parents(roots[i]);
+      }
+      // Two distinct points are in the same tree of the union-find forest
+      // exactly when they are in the same cluster
+      for (int i = 0; i < n; ++i)
+        for (int j = i + 1; j < n; ++j)
+          BOOST_TEST((roots[i] == roots[j]) ==
+                     (labels(i) != -1 && labels(i) == labels(j)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_cluster_statistics, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::dbscan;
+  using ArborX::Point;
+
+  ExecutionSpace space;
+
+  std::vector<Point> cloud;
+  for (int i = 0; i < 40; ++i)
+    cloud.push_back({{0.3f * i + (i % 9 == 0 ? 1.f : 0.f),
+                      (i % 2 == 0 ? 0.25f : 0.f), (float)(i / 20)}});
+  auto const points = toView<DeviceType, Point>(cloud);
+  int const n = cloud.size();
+
+  for (auto implementation :
+       {ArborX::DBSCAN::Implementation::FDBSCAN,
+        ArborX::DBSCAN::Implementation::FDBSCAN_DenseBox,
+        ArborX::DBSCAN::Implementation::FDBSCAN_CellStencil})
+    for (int core_min_size : {2, 3, 5})
+    {
+      auto const params =
+          ArborX::DBSCAN::Parameters().setImplementation(implementation);
+      ArborX::DBSCAN::ClusterStatistics<MemorySpace> statistics;
+      auto const labels = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{},
+          dbscan(space, points, 0.5f, core_min_size, params, statistics));
+
+      auto const representatives = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{}, statistics.representatives);
+      auto const sizes = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{}, statistics.sizes);
+      auto const centroids = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{}, statistics.centroids);
+      auto const bounds = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{}, statistics.bounds);
+
+      int num_clustered_points = 0;
+      for (int k = 0; k < (int)representatives.size(); ++k)
+      {
+        int const r = representatives(k);
+        int size = 0;
+        float centroid[3] = {0, 0, 0};
+        ArborX::ExperimentalHyperGeometry::Box<3> box;
+        for (int i = 0; i < n; ++i)
+        {
+          if (labels(i) != r)
+            continue;
+          ++size;
+          for (int d = 0; d < 3; ++d)
+          {
+            centroid[d] += cloud[i][d];
+            box.minCorner()[d] = std::min(box.minCorner()[d], cloud[i][d]);
+            box.maxCorner()[d] = std::max(box.maxCorner()[d], cloud[i][d]);
+          }
+        }
+        BOOST_TEST(sizes(k) == size);
+        for (int d = 0; d < 3; ++d)
+        {
+          BOOST_TEST(centroids(k)[d] == centroid[d] / size,
+                     boost::test_tools::tolerance(1e-5f));
+          BOOST_TEST(bounds(k).minCorner()[d] == box.minCorner()[d]);
+          BOOST_TEST(bounds(k).maxCorner()[d] == box.maxCorner()[d]);
+        }
+        num_clustered_points += size;
+      }
+      BOOST_TEST(num_clustered_points ==
+                 n - std::count(labels.data(), labels.data() + n, -1));
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_index, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Point;
+  using ArborX::Details::verifyDBSCAN;
+
+  ExecutionSpace space;
+
+  {
+    auto points = toView<DeviceType, Point>(
+        {{{0, 0, 0}}, {{1, 1, 1}}, {{3, 3, 3}}, {{6, 6, 6}}});
+
+    auto r = std::sqrt(3);
+
+    ArborX::Experimental::DBSCANIndex index(space, points, 3 * r);
+    for (float eps : {r - 0.1f, r, 2 * r, 3 * r})
+      for (int core_min_size : {2, 3, 4, 5})
+        BOOST_TEST(verifyDBSCAN(space, points, eps, core_min_size,
+                                index.cluster(space, eps, core_min_size)));
+
+    // Test non-View primitives
+    HiddenView<decltype(points)> hidden_points{points};
+    ArborX::Experimental::DBSCANIndex hidden_index(space, hidden_points, r);
+    BOOST_TEST(verifyDBSCAN(space, hidden_points, r, 2,
+                            hidden_index.cluster(space, r, 2)));
+    BOOST_TEST(verifyDBSCAN(space, hidden_points, r, 3,
+                            hidden_index.cluster(space, r, 3)));
+  }
+
+  {
+    // check for bridging effect
+    auto points = toView<DeviceType, Point>({{-1, 0.5, 0},
+                                             {-1, -0.5, 0},
+                                             {-1, 0, 0},
+                                             {{0, 0, 0}},
+                                             {{1, 0, 0}},
+                                             {{1, 0.5, 0}},
+                                             {{1, -0.5, 0}}});
+
+    ArborX::Experimental::DBSCANIndex index(space, points, 2);
+    BOOST_TEST(
+        verifyDBSCAN(space, points, 1.0, 3, index.cluster(space, 1, 3)));
+    BOOST_TEST(
+        verifyDBSCAN(space, points, 1.0, 4, index.cluster(space, 1, 4)));
+    BOOST_CHECK_THROW(index.cluster(space, 3, 4), ArborX::SearchException);
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(incremental_dbscan, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Point;
+  using ArborX::Details::verifyDBSCAN;
+
+  ExecutionSpace space;
+
+  // Two dense blobs linked by a sparse bridge, and isolated points
+  std::vector<Point> cloud;
+  for (int i = 0; i < 100; ++i)
+  {
+    float const t = (i * 37 % 100) / 100.f;
+    float const s = (i * 61 % 100) / 100.f;
+    cloud.push_back({{t, s, 0}});
+    cloud.push_back({{5 + s, t, 0}});
+    if (i % 10 == 0)
+      cloud.push_back({{1 + 0.4f * (i / 10), 0.5, 0}});
+    if (i % 25 == 0)
+      cloud.push_back({{2.5, 10.f + i, 0}});
+  }
+  int const n = cloud.size();
+
+  for (int core_min_size : {2, 3, 5})
+  {
+    ArborX::Experimental::IncrementalDBSCAN<MemorySpace, Point>
+        incremental(0.5, core_min_size);
+    BOOST_TEST(incremental.labels(space).size() == 0);
+
+    int first = 0;
+    for (int batch_size : {1, 2, 13, 0, 40, 7, 1000})
+    {
+      int const last = std::min(first + batch_size, n);
+      incremental.insert(space, toView<DeviceType, Point>(std::vector<Point>(
+                               cloud.begin() + first, cloud.begin() + last)));
+      first = last;
+      BOOST_TEST(incremental.size() == last);
+      auto const points = toView<DeviceType, Point>(
+          std::vector<Point>(cloud.begin(), cloud.begin() + last));
+      BOOST_TEST(verifyDBSCAN(space, points, 0.5, core_min_size,
+                              incremental.labels(space)));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_phase_timings, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::dbscan;
+  using ArborX::Point;
+
+  ExecutionSpace space;
+
+  std::vector<Point> cloud;
+  for (int i = 0; i < 30; ++i)
+    cloud.push_back({{0.3f * i + (i % 7 == 0 ? 1.f : 0.f), 0, 0}});
+  auto const points = toView<DeviceType, Point>(cloud);
+
+  for (auto implementation :
+       {ArborX::DBSCAN::Implementation::FDBSCAN,
+        ArborX::DBSCAN::Implementation::FDBSCAN_DenseBox,
+        ArborX::DBSCAN::Implementation::FDBSCAN_CellStencil})
+  {
+    ArborX::Experimental::PhaseTimings timings;
+    auto const params = ArborX::DBSCAN::Parameters()
+                            .setImplementation(implementation)
+                            .setTimings(&timings);
+    BOOST_TEST(verifyDBSCAN(space, points, 0.5f, 3,
+                            dbscan(space, points, 0.5f, 3, params)));
+
+    auto const &phases = timings.phases();
+    BOOST_TEST_REQUIRE(!phases.empty());
+    BOOST_TEST(phases.front().label == "ArborX::DBSCAN");
+    BOOST_TEST(phases.front().depth == 0);
+    double sum = 0;
+    for (auto const &phase : phases)
+    {
+      BOOST_TEST(phase.seconds >= 0);
+      if (phase.depth == 1)
+        sum += phase.seconds;
+    }
+    // The nested phases fit within the whole algorithm
+    BOOST_TEST(sum <= phases.front().seconds);
+    BOOST_TEST(std::any_of(phases.begin(), phases.end(), [](auto const &phase) {
+      return phase.label == "ArborX::DBSCAN::clusters::num_neigh";
+    }));
+
+    auto const json = timings.toJSON();
+    BOOST_TEST(json.find("{\"phases\": [{\"label\": \"ArborX::DBSCAN\", "
+                         "\"depth\": 0, \"seconds\": ") == 0);
+    BOOST_TEST(json.substr(json.size() - 3) == "}]}");
+
+    timings.clear();
+    BOOST_TEST(timings.phases().empty());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_cell_stencil_2d, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::dbscan;
+  using ArborX::Details::verifyDBSCAN;
+  using Point = ArborX::ExperimentalHyperGeometry::Point<2>;
+
+  ExecutionSpace space;
+
+  // Rows of points of varying density, with points on the upper bounds of the
+  // grid and neighbors two cells away from each other
+  std::vector<Point> cloud;
+  for (int i = 0; i < 40; ++i)
+    cloud.push_back({0.2f * i * (1 + i % 3), (float)(i % 5)});
+  cloud.push_back({20.f, 0.f});
+  cloud.push_back({20.f, 4.f});
+  auto const points = toView<DeviceType, Point>(cloud);
+
+  auto const params = ArborX::DBSCAN::Parameters().setImplementation(
+      ArborX::DBSCAN::Implementation::FDBSCAN_CellStencil);
+  for (float eps : {0.3f, 1.f, 1.5f})
+    for (int core_min_size : {2, 3, 5})
+      BOOST_TEST(verifyDBSCAN(space, points, eps, core_min_size,
+                              dbscan(space, points, eps, core_min_size,
+                                     params)),
+                 "eps = " << eps << ", core_min_size = " << core_min_size);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_batched, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Point;
+  using ArborX::Details::verifyDBSCAN;
+
+  ExecutionSpace space;
+
+  // Overlapping sets of points on a line, one of them empty, so that the
+  // clusters would merge across sets if they were not independent
+  std::vector<Point> cloud;
+  std::vector<int> offsets = {0};
+  for (int s = 0; s < 4; ++s)
+  {
+    int const size = (s == 2 ? 0 : 10 + 5 * s);
+    for (int i = 0; i < size; ++i)
+      cloud.push_back(
+          {{(0.3f + 0.1f * s) * i + (i % (s + 3) == 0 ? 1.f : 0.f), 0, 0}});
+    offsets.push_back(cloud.size());
+  }
+  std::vector<float> eps = {0.35f, 0.5f, 1.f, 0.55f};
+  std::vector<int> core_min_sizes = {2, 3, 2, 5};
+  auto const points = toView<DeviceType, Point>(cloud);
+
+  auto const labels = ArborX::dbscanBatched(
+      space, points, toView<DeviceType>(offsets, "Test::offsets"),
+      toView<DeviceType>(eps, "Test::eps"),
+      toView<DeviceType>(core_min_sizes, "Test::core_min_sizes"));
+  BOOST_TEST(labels.size() == cloud.size());
+
+  for (int s = 0; s < 4; ++s)
+  {
+    auto const range = Kokkos::make_pair(offsets[s], offsets[s + 1]);
+    BOOST_TEST(verifyDBSCAN(space, Kokkos::subview(points, range), eps[s],
+                            core_min_sizes[s],
+                            Kokkos::subview(labels, range)),
+               "set " << s);
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_k_distances, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Point;
+
+  ExecutionSpace space;
+
+  // Points one apart on a line, and an outlier
+  std::vector<Point> points_host;
+  for (int i = 0; i < 10; ++i)
+    points_host.push_back({{(float)i, 0, 0}});
+  points_host.push_back({{100, 0, 0}});
+  auto points = toView<DeviceType>(points_host, "Test::points");
+
+  {
+    auto const k_distances = ArborX::sampleKDistances(space, points, 2, 100);
+    std::vector<float> expected(10, 1.f);
+    expected.push_back(91.f);
+    BOOST_TEST(k_distances.distances == expected,
+               boost::test_tools::per_element());
+    BOOST_TEST(k_distances.quantile(0.5f) == 1.f);
+    BOOST_TEST(k_distances.quantile(1.f) == 91.f);
+    BOOST_TEST(k_distances.knee() == 1.f);
+  }
+
+  {
+    // The ends of the line have a single neighbor one apart
+    auto const k_distances = ArborX::sampleKDistances(space, points, 3, 100);
+    std::vector<float> expected(8, 1.f);
+    expected.insert(expected.end(), {2.f, 2.f, 92.f});
+    BOOST_TEST(k_distances.distances == expected,
+               boost::test_tools::per_element());
+    BOOST_TEST(k_distances.knee() == 2.f);
+  }
+
+  {
+    // Only the points 0, 2, 4, 6 and 8 are sampled
+    auto const k_distances = ArborX::sampleKDistances(space, points, 2, 5);
+    BOOST_TEST(k_distances.distances == std::vector<float>(5, 1.f),
+               boost::test_tools::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dbscan_runtime_dimension, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Details::verifyDBSCAN;
+
+  ExecutionSpace space;
+
+  // Two groups of points along the diagonal, far from each other
+  int const n = 20;
+  auto check = [&](auto dim_c) {
+    constexpr int DIM = decltype(dim_c)::value;
+    using Point = ArborX::ExperimentalHyperGeometry::Point<DIM>;
+    Kokkos::View<float **, MemorySpace> coordinates("Test::coordinates", n,
+                                                    DIM);
+    auto coordinates_host = Kokkos::create_mirror_view(coordinates);
+    std::vector<Point> cloud(n);
+    for (int i = 0; i < n; ++i)
+      for (int d = 0; d < DIM; ++d)
+        cloud[i][d] = coordinates_host(i, d) = (i < n / 2 ? i : 10 * i) * .5f;
+    Kokkos::deep_copy(coordinates, coordinates_host);
+
+    float const eps = std::sqrt((float)DIM);
+    auto const labels =
+        ArborX::Experimental::dbscan(space, coordinates, eps, 2);
+    BOOST_TEST(labels.size() == n);
+    BOOST_TEST(verifyDBSCAN(space, toView<DeviceType>(cloud, "Test::points"),
+                            eps, 2, labels),
+               "DIM = " << DIM);
+  };
+  check(std::integral_constant<int, 1>{});
+  check(std::integral_constant<int, 4>{});
+  check(std::integral_constant<int, 10>{});
+
+  Kokkos::View<float **, MemorySpace> coordinates("Test::coordinates", n, 11);
+  BOOST_CHECK_THROW(ArborX::Experimental::dbscan(space, coordinates, 1.f, 2),
+                    ArborX::SearchException);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
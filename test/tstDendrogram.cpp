@@ -17,6 +17,7 @@
 #include <ArborX_DetailsKokkosExtViewHelpers.hpp>
 #include <ArborX_DetailsSortUtils.hpp>
 #include <ArborX_DetailsWeightedEdge.hpp>
+#include <ArborX_HDBSCAN.hpp>
 #include <ArborX_MinimumSpanningTree.hpp>
 
 #include "BoostTest_CUDA_clang_workarounds.hpp"
@@ -102,6 +103,23 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(dendrogram_union_find, DeviceType,
     BOOST_TEST(heights == (std::vector<float>{2.f, 3.f, 9.f}),
                tt::per_element());
   }
+
+  {
+    // Edges of equal weights are sorted by their index
+    // Dendrogram (sorted edge indices)
+    //   ----2----
+    //   |       |
+    // --1--   --0--
+    // |   |   |   |
+    // 0   1   2   3
+    auto [parents, heights] = buildDendrogram(
+        space,
+        std::vector<WeightedEdge>{{2, 3, 2.f}, {0, 1, 2.f}, {1, 2, 5.f}});
+    BOOST_TEST(parents == (std::vector<int>{2, 2, -1, 1, 1, 0, 0}),
+               tt::per_element());
+    BOOST_TEST(heights == (std::vector<float>{2.f, 2.f, 5.f}),
+               tt::per_element());
+  }
 }
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(dendrogram_boruvka, DeviceType,
@@ -188,4 +206,177 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(dendrogram_boruvka, DeviceType,
   BOOST_TEST(heights_boruvka == heights_union_find, tt::per_element());
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(dendrogram_parallel_union_find, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Experimental::Dendrogram;
+  using ArborX::Experimental::DendrogramImplementation;
+
+  ExecutionSpace space;
+
+  // Both implementations process the edges in the same sorted order, so the
+  // dendrograms are identical even for edges of equal weights
+  for (int n : {2, 3, 17, 3000})
+  {
+    auto points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+
+    ArborX::Details::MinimumSpanningTree<MemorySpace> mst(space, points, 2);
+    Dendrogram<MemorySpace> dendrogram_union_find(
+        space, mst.edges, DendrogramImplementation::UNION_FIND);
+    Dendrogram<MemorySpace> dendrogram_parallel(
+        space, mst.edges, DendrogramImplementation::PARALLEL_UNION_FIND);
+
+    auto parents_union_find = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, dendrogram_union_find._parents);
+    auto parents_parallel = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, dendrogram_parallel._parents);
+    BOOST_TEST(parents_parallel == parents_union_find, tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(hdbscan_engine, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Experimental::DendrogramImplementation;
+
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+
+  ArborX::Experimental::HDBSCANEngine<MemorySpace> engine(space, points, 8);
+  for (auto impl : {DendrogramImplementation::BORUVKA,
+                    DendrogramImplementation::UNION_FIND})
+    for (int core_min_size : {1, 2, 5, 8})
+    {
+      auto parents_ref = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{},
+          ArborX::Experimental::hdbscan(space, points, core_min_size, impl)
+              ._parents);
+      auto parents = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{},
+          engine.dendrogram(space, core_min_size, impl)._parents);
+      BOOST_TEST(parents == parents_ref, tt::per_element());
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dendrogram_cluster_extraction, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Experimental::DendrogramImplementation;
+
+  ExecutionSpace space;
+
+  // Two groups of four points and an outlier. With min_cluster_size = 3, the
+  // outlier falls out of the root cluster, which then splits into the two
+  // groups.
+  std::vector<ArborX::Point> cloud{
+      {{0, 0, 0}},     {{0.1, 0, 0}},  {{0.25, 0, 0}},  {{0.45, 0, 0}},
+      {{10, 0, 0}},    {{10.15, 0, 0}}, {{10.35, 0, 0}}, {{10.4, 0, 0}},
+      {{30, 0, 0}}};
+  auto points = ArborXTest::toView<ExecutionSpace>(cloud, "Test::points");
+
+  for (auto impl : {DendrogramImplementation::BORUVKA,
+                    DendrogramImplementation::UNION_FIND,
+                    DendrogramImplementation::PARALLEL_UNION_FIND})
+  {
+    auto dendrogram = ArborX::Experimental::hdbscan(space, points, 2, impl);
+    auto labels = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{},
+        ArborX::Experimental::extractClusters(space, dendrogram, 3));
+
+    BOOST_TEST(labels.size() == cloud.size());
+    BOOST_TEST((labels(0) == 0 || labels(0) == 1));
+    for (int i = 1; i < 4; ++i)
+      BOOST_TEST(labels(i) == labels(0));
+    BOOST_TEST(labels(4) == 1 - labels(0));
+    for (int i = 5; i < 8; ++i)
+      BOOST_TEST(labels(i) == labels(4));
+    BOOST_TEST(labels(8) == -1);
+
+    // No split produces clusters of 5 points
+    labels = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{},
+        ArborX::Experimental::extractClusters(space, dendrogram, 5));
+    for (int i = 0; i < (int)cloud.size(); ++i)
+      BOOST_TEST(labels(i) == -1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(single_linkage_clusters, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborXTest::toView;
+
+  ExecutionSpace space;
+
+  // Points at 0, 1, 3, 6 and 10 along a line, in no particular order
+  auto edges = toView<ExecutionSpace>(
+      std::vector<WeightedEdge>{{3, 2, 3}, {4, 3, 4}, {1, 0, 1}, {2, 1, 2}},
+      "Test::edges");
+
+  auto singleLinkageLabels = [&](float cutoff) {
+    auto labels = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{},
+        ArborX::Experimental::singleLinkageClusters(space, edges, cutoff));
+    return std::vector<int>(labels.data(), labels.data() + labels.size());
+  };
+
+  BOOST_TEST(singleLinkageLabels(0.5f) == (std::vector<int>{0, 1, 2, 3, 4}),
+             tt::per_element());
+  // The edges as long as the cutoff are kept
+  BOOST_TEST(singleLinkageLabels(2.f) == (std::vector<int>{0, 0, 0, 3, 4}),
+             tt::per_element());
+  BOOST_TEST(singleLinkageLabels(3.5f) == (std::vector<int>{0, 0, 0, 0, 4}),
+             tt::per_element());
+  BOOST_TEST(singleLinkageLabels(10.f) == (std::vector<int>{0, 0, 0, 0, 0}),
+             tt::per_element());
+
+  // A single vertex
+  auto no_edges =
+      toView<ExecutionSpace>(std::vector<WeightedEdge>{}, "Test::no_edges");
+  auto labels = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{},
+      ArborX::Experimental::singleLinkageClusters(space, no_edges, 1.f));
+  BOOST_TEST(labels.size() == 1);
+  BOOST_TEST(labels(0) == 0);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(single_linkage_clusters_multiple_cutoffs,
+                              DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename ExecutionSpace::memory_space;
+  using ArborXTest::toView;
+
+  ExecutionSpace space;
+
+  // Points at 0, 1, 3, 6 and 10 along a line, in no particular order
+  auto edges = toView<ExecutionSpace>(
+      std::vector<WeightedEdge>{{3, 2, 3}, {4, 3, 4}, {1, 0, 1}, {2, 1, 2}},
+      "Test::edges");
+  ArborX::Experimental::Dendrogram<MemorySpace> dendrogram{space, edges};
+
+  // Unsorted cutoffs, one of them repeated
+  std::vector<float> const cutoffs{3.5f, 0.5f, 10.f, 2.f, 3.5f};
+  auto labels = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{},
+      ArborX::Experimental::singleLinkageClusters(space, dendrogram, cutoffs));
+  BOOST_TEST(labels.extent_int(0) == 5);
+  BOOST_TEST(labels.extent_int(1) == (int)cutoffs.size());
+  for (int j = 0; j < (int)cutoffs.size(); ++j)
+  {
+    auto reference = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{},
+        ArborX::Experimental::singleLinkageClusters(space, edges, cutoffs[j]));
+    for (int i = 0; i < 5; ++i)
+      BOOST_TEST(labels(i, j) == reference(i));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -12,17 +12,25 @@
 #include <ArborX_DetailsAlgorithms.hpp>
 #include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
 #include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperCapsule.hpp>
+#include <ArborX_HyperOBB.hpp>
 #include <ArborX_HyperPoint.hpp>
 #include <ArborX_HyperSphere.hpp>
+#include <ArborX_HyperTriangle.hpp>
 
 #include <boost/mpl/list.hpp>
 
+#include <type_traits>
+
 #define BOOST_TEST_MODULE Geometry
 #include <boost/test/unit_test.hpp>
 
 using Point = ArborX::ExperimentalHyperGeometry::Point<3>;
 using Box = ArborX::ExperimentalHyperGeometry::Box<3>;
 using Sphere = ArborX::ExperimentalHyperGeometry::Sphere<3>;
+using OBB = ArborX::ExperimentalHyperGeometry::OBB<3>;
+using Capsule = ArborX::ExperimentalHyperGeometry::Capsule<3>;
+using Triangle = ArborX::ExperimentalHyperGeometry::Triangle<3>;
 
 BOOST_AUTO_TEST_CASE(distance)
 {
@@ -51,6 +59,84 @@ BOOST_AUTO_TEST_CASE(distance)
   BOOST_TEST(distance(Point{{1., 1., 1.}}, sphere) == std::sqrt(3.f) - 1.f);
 }
 
+BOOST_AUTO_TEST_CASE(distance_squared)
+{
+  using ArborX::Details::pointBoxDistanceSquared;
+  using ArborX::Details::pointPointDistanceSquared;
+  BOOST_TEST(pointPointDistanceSquared(Point{{1.0, 2.0, 3.0}},
+                                       Point{{1.0, 1.0, 1.0}}) == 5.f);
+
+  // box is unit cube
+  constexpr Box box{{{0.0, 0.0, 0.0}}, {{1.0, 1.0, 1.0}}};
+
+  BOOST_TEST(pointBoxDistanceSquared(Point{{0.5, 0.5, 0.5}}, box) == 0.f);
+  BOOST_TEST(pointBoxDistanceSquared(Point{{0.0, 0.0, 0.5}}, box) == 0.f);
+  BOOST_TEST(pointBoxDistanceSquared(Point{{2.0, 0.5, 0.5}}, box) == 1.f);
+  BOOST_TEST(pointBoxDistanceSquared(Point{{2.0, 0.75, -1.0}}, box) == 2.f);
+  BOOST_TEST(pointBoxDistanceSquared(Point{{-1.0, 2.0, 2.0}}, box) == 3.f);
+}
+
+BOOST_AUTO_TEST_CASE(comparable_distance)
+{
+  using ArborX::Details::ComparableDistance;
+  using PointBox = ComparableDistance<Point, Point, Box>;
+  static_assert(PointBox::is_squared);
+  static_assert(!ComparableDistance<Point, Sphere, Box>::is_squared);
+  static_assert(!ComparableDistance<Box, Box>::is_squared);
+
+  constexpr Box box{{{0.0, 0.0, 0.0}}, {{1.0, 1.0, 1.0}}};
+  BOOST_TEST(PointBox::apply(Point{{2.0, 0.75, -1.0}}, box) == 2.f);
+  BOOST_TEST(PointBox::apply(Point{{1.0, 2.0, 3.0}}, Point{{1.0, 1.0, 1.0}}) ==
+             5.f);
+  BOOST_TEST(PointBox::fromDistance(3.f) == 9.f);
+  BOOST_TEST(PointBox::toDistance(9.f) == 3.f);
+  BOOST_TEST(PointBox::upperBound(3.f) >= 9.f);
+
+  using PointSphere = ComparableDistance<Point, Sphere>;
+  constexpr Sphere sphere{{{0., 0., 0.}}, 1.};
+  BOOST_TEST(PointSphere::apply(Point{{2., 0., 0.}}, sphere) == 1.);
+  BOOST_TEST(PointSphere::fromDistance(3.f) == 3.f);
+}
+
+BOOST_AUTO_TEST_CASE(distance_point_triangle)
+{
+  using ArborX::Details::ComparableDistance;
+  using ArborX::Details::distance;
+  using ArborX::Details::pointTriangleDistanceSquared;
+
+  constexpr Triangle triangle{{{0, 0, 0}}, {{1, 0, 0}}, {{0, 1, 0}}};
+
+  // projection onto the interior
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{0.25, 0.25, 1}}, triangle) ==
+             1.f);
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{0.25, 0.25, 0}}, triangle) ==
+             0.f);
+  // projection onto the vertices
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{-1, -1, 0}}, triangle) == 2.f);
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{2, -1, 0}}, triangle) == 2.f);
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{0, 2, 0}}, triangle) == 1.f);
+  // projection onto the edges
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{0.5, -1, 0}}, triangle) ==
+             1.f);
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{-1, 0.5, 0}}, triangle) ==
+             1.f);
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{1, 1, 0}}, triangle) == 0.5f);
+
+  BOOST_TEST(distance(Point{{0.25, 0.25, -2}}, triangle) == 2.f);
+  BOOST_TEST(distance(Point{{2, -1, 0}}, triangle) == std::sqrt(2.f));
+
+  // degenerate triangles
+  constexpr Triangle segment{{{0, 0, 0}}, {{1, 0, 0}}, {{2, 0, 0}}};
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{1, 1, 0}}, segment) == 1.f);
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{3, 0, 0}}, segment) == 1.f);
+  constexpr Triangle vertex{{{1, 1, 1}}, {{1, 1, 1}}, {{1, 1, 1}}};
+  BOOST_TEST(pointTriangleDistanceSquared(Point{{0, 0, 0}}, vertex) == 3.f);
+
+  using PointTriangle = ComparableDistance<Point, Triangle, Box>;
+  static_assert(PointTriangle::is_squared);
+  BOOST_TEST(PointTriangle::apply(Point{{0.25, 0.25, -2}}, triangle) == 4.f);
+}
+
 BOOST_AUTO_TEST_CASE(distance_box_box)
 {
   using ArborX::Details::distance;
@@ -159,6 +245,37 @@ BOOST_AUTO_TEST_CASE(intersects)
   BOOST_TEST(!intersects(Point{-0.7, -0.8, 0.}, sphere));
 }
 
+BOOST_AUTO_TEST_CASE(contains)
+{
+  using ArborX::Details::contains;
+
+  // unit cube
+  constexpr Box box{{{0.0, 0.0, 0.0}}, {{1.0, 1.0, 1.0}}};
+  static_assert(contains(box, box));
+  static_assert(contains(box, Box{{{0.25, 0.25, 0.25}}, {{0.75, 0.75, 0.75}}}));
+  static_assert(contains(box, Box{{{0.0, 0.0, 0.0}}, {{0.5, 1.0, 1.0}}}));
+  static_assert(!contains(box, Box{{{0.5, 0.5, 0.5}}, {{1.5, 1.5, 1.5}}}));
+  static_assert(!contains(box, Box{{{-1.0, -1.0, -1.0}}, {{2.0, 2.0, 2.0}}}));
+
+  // unit sphere
+  constexpr Sphere sphere{{{0., 0., 0.}}, 1.};
+  BOOST_TEST(contains(sphere, Box{{{0., 0., 0.}}, {{0.5, 0.5, 0.5}}}));
+  BOOST_TEST(contains(sphere, Box{{{-0.5, -0.5, -0.5}}, {{0.5, 0.5, 0.5}}}));
+  // farthest corner on the sphere
+  BOOST_TEST(contains(sphere, Box{{{-1., 0., 0.}}, {{0., 0., 0.}}}));
+  BOOST_TEST(!contains(sphere, Box{{{0., 0., 0.}}, {{0.7, 0.8, 0.}}}));
+  // intersecting but not contained
+  BOOST_TEST(!contains(sphere, Box{{{0., 0., 0.}}, {{1., 1., 1.}}}));
+  BOOST_TEST(!contains(Sphere{{{0., 0., 0.}}, -1.},
+                       Box{{{0., 0., 0.}}, {{0., 0., 0.}}}));
+
+  using ArborX::Details::ContainsArchetypeExpression;
+  static_assert(
+      Kokkos::is_detected<ContainsArchetypeExpression, Sphere, Box>{});
+  static_assert(
+      !Kokkos::is_detected<ContainsArchetypeExpression, Box, Sphere>{});
+}
+
 BOOST_AUTO_TEST_CASE(equals)
 {
   using ArborX::Details::equals;
@@ -207,6 +324,54 @@ BOOST_AUTO_TEST_CASE(expand)
   BOOST_TEST(equals(box, Box{{{-24., -24., -24.}}, {{24., 24., 24.}}}));
 }
 
+BOOST_AUTO_TEST_CASE(mixed_precision)
+{
+  using ArborX::Details::distance;
+  using ArborX::Details::expand;
+  using ArborX::Details::intersects;
+  using PointD = ArborX::ExperimentalHyperGeometry::Point<3, double>;
+  using BoxD = ArborX::ExperimentalHyperGeometry::Box<3, double>;
+  using SphereD = ArborX::ExperimentalHyperGeometry::Sphere<3, double>;
+
+  // distances are computed in the most precise of the coordinate types
+  static_assert(std::is_same_v<decltype(distance(Point{}, Box{})), float>);
+  static_assert(std::is_same_v<decltype(distance(PointD{}, Box{})), double>);
+  static_assert(std::is_same_v<decltype(distance(BoxD{}, Box{})), double>);
+  BOOST_TEST(distance(PointD{{1., 0., 0.}}, PointD{{1. + 0x1p-40, 0., 0.}}) ==
+             0x1p-40);
+  BOOST_TEST(distance(SphereD{{{0., 0., 0.}}, 1.},
+                      Box{{{2, 0, 0}}, {{3, 1, 1}}}) == 1.);
+
+  // single precision boxes are rounded outwards to contain double precision
+  // geometries
+  double const x = 1. + 1e-10;
+  PointD const point{{x, -x, 0.1}};
+  Box box;
+  expand(box, point);
+  BOOST_TEST(box.minCorner()[0] == 1.f);
+  BOOST_TEST(box.maxCorner()[0] == std::nextafter(1.f, 2.f));
+  BOOST_TEST(box.minCorner()[1] == -std::nextafter(1.f, 2.f));
+  BOOST_TEST(box.maxCorner()[1] == -1.f);
+  BOOST_TEST(box.minCorner()[2] < box.maxCorner()[2]);
+  BOOST_TEST(intersects(point, box));
+
+  expand(box, BoxD{{{-x, -x, -x}}, {{x, x, x}}});
+  for (int d = 0; d < 3; ++d)
+  {
+    BOOST_TEST(box.minCorner()[d] <= -x);
+    BOOST_TEST(box.maxCorner()[d] >= x);
+  }
+
+  Box other;
+  expand(other, SphereD{{{0., 0., 0.}}, x});
+  BOOST_TEST(ArborX::Details::equals(box, other));
+
+  // an empty box in double precision remains empty
+  Box empty;
+  expand(empty, BoxD{});
+  BOOST_TEST(ArborX::Details::equals(empty, Box{}));
+}
+
 BOOST_AUTO_TEST_CASE(centroid)
 {
   using ArborX::Details::returnCentroid;
@@ -242,3 +407,194 @@ BOOST_AUTO_TEST_CASE(is_valid)
   BOOST_TEST(!isValid(Sphere{{{0., -infty, 0.}}, +1.}));
   BOOST_TEST(isValid(Sphere{}));
 }
+
+BOOST_AUTO_TEST_CASE(oriented_box)
+{
+  using ArborX::Details::distance;
+  using ArborX::Details::equals;
+  using ArborX::Details::expand;
+  using ArborX::Details::intersects;
+  using ArborX::Details::returnCentroid;
+  auto close = [](float a, float b) { return std::abs(a - b) < 1e-5f; };
+
+  // box rotated by 45 degrees around the z axis
+  float const s = 1 / std::sqrt(2.f);
+  OBB const obb{{{0., 0., 0.}},
+                {{Point{{s, s, 0.}}, Point{{-s, s, 0.}}, Point{{0., 0., 1.}}}},
+                {1., .5, .5}};
+
+  BOOST_TEST(intersects(Point{{.5, .5, 0.}}, obb));
+  BOOST_TEST(intersects(obb, Point{{-.5, -.5, .5}}));
+  // inside of the axis-aligned bounding box, but outside of the oriented one
+  BOOST_TEST(!intersects(Point{{.9, 0., 0.}}, obb));
+
+  BOOST_TEST(distance(Point{{.5, .5, 0.}}, obb) == 0.f);
+  BOOST_TEST(close(distance(Point{{3 * s, 3 * s, 0.}}, obb), 2.f));
+  BOOST_TEST(close(distance(Point{{0., 0., 2.}}, obb), 1.5f));
+
+  BOOST_TEST(intersects(Box{{{.6, .6, -1.}}, {{2., 2., 1.}}}, obb));
+  BOOST_TEST(!intersects(obb, Box{{{1., 1., -1.}}, {{2., 2., 1.}}}));
+  BOOST_TEST(!intersects(Box{{{.8, -.3, -1.}}, {{2., -.1, 1.}}}, obb));
+  BOOST_TEST(!intersects(Box{}, obb));
+
+  auto shifted = [&](float t) {
+    OBB other = obb;
+    for (int d = 0; d < 3; ++d)
+      other.center()[d] += t * obb.axis(1)[d];
+    return other;
+  };
+  BOOST_TEST(intersects(obb, shifted(.8)));
+  BOOST_TEST(!intersects(obb, shifted(1.2)));
+  BOOST_TEST(!intersects(obb, OBB{}));
+  BOOST_TEST(intersects(Sphere{{{0., 0., 1.}}, .6}, obb));
+  BOOST_TEST(!intersects(Sphere{{{0., 0., 1.}}, .4}, obb));
+
+  // expand a box with an oriented box
+  Box box;
+  expand(box, obb);
+  BOOST_TEST(close(box.minCorner()[0], -1.5f * s));
+  BOOST_TEST(close(box.maxCorner()[1], 1.5f * s));
+  BOOST_TEST(close(box.maxCorner()[2], .5f));
+
+  // an empty oriented box takes the orientation of the first oriented box it
+  // is expanded with
+  OBB other;
+  expand(other, obb);
+  BOOST_TEST(equals(other.center(), obb.center()));
+  BOOST_TEST(equals(other.axis(0), obb.axis(0)));
+  BOOST_TEST(other.halfExtent(0) == obb.halfExtent(0));
+  expand(other, shifted(1.));
+  BOOST_TEST(equals(other.axis(0), obb.axis(0)));
+  BOOST_TEST(close(other.halfExtent(0), 1.f));
+  BOOST_TEST(close(other.halfExtent(1), 1.f));
+  BOOST_TEST(close(returnCentroid(other)[0], -s / 2));
+  BOOST_TEST(close(returnCentroid(other)[1], s / 2));
+
+  // expand an oriented box with points, boxes and spheres
+  OBB aligned;
+  expand(aligned, Point{{0., 0., 0.}});
+  expand(aligned, Point{{1., 2., 3.}});
+  BOOST_TEST(equals(aligned.center(), Point{{.5, 1., 1.5}}));
+  BOOST_TEST(aligned.halfExtent(2) == 1.5f);
+  expand(aligned, Box{{{-1., 0., 0.}}, {{0., 1., 1.}}});
+  BOOST_TEST(equals(aligned.center(), Point{{0., 1., 1.5}}));
+  expand(aligned, Sphere{{{0., 1., 1.5}}, 2.});
+  BOOST_TEST(aligned.halfExtent(0) == 2.f);
+  BOOST_TEST(aligned.halfExtent(2) == 2.f);
+}
+
+BOOST_AUTO_TEST_CASE(capsule)
+{
+  using ArborX::Details::distance;
+  using ArborX::Details::equals;
+  using ArborX::Details::expand;
+  using ArborX::Details::intersects;
+  using ArborX::Details::returnCentroid;
+
+  Capsule const capsule{{{0., 0., 0.}}, {{2., 0., 0.}}, 1.};
+
+  BOOST_TEST(intersects(Point{{1., .9, 0.}}, capsule));
+  BOOST_TEST(intersects(capsule, Point{{3., 0., 0.}}));
+  BOOST_TEST(!intersects(Point{{2.8, .7, 0.}}, capsule));
+  BOOST_TEST(distance(Point{{1., 3., 0.}}, capsule) == 2.f);
+  BOOST_TEST(distance(Point{{-2., 0., 0.}}, capsule) == 1.f);
+  BOOST_TEST(distance(Point{{1., .5, 0.}}, capsule) == 0.f);
+
+  BOOST_TEST(intersects(Sphere{{{1., 0., 2.5}}, 1.5}, capsule));
+  BOOST_TEST(!intersects(Sphere{{{1., 0., 2.5}}, 1.}, capsule));
+
+  BOOST_TEST(!intersects(Box{{{1.5, 1.5, -1.}}, {{3., 3., 1.}}}, capsule));
+  BOOST_TEST(intersects(capsule, Box{{{2.5, .5, -1.}}, {{3., 3., 1.}}}));
+  BOOST_TEST(!intersects(Box{}, capsule));
+  // the closest point of the box to the oblique segment is one of its corners
+  Box const box{{{-1., .5, -1.}}, {{-.5, 1., 1.}}};
+  BOOST_TEST(intersects(box, Capsule{{{-2., -2., 0.}}, {{2., 2., 0.}}, .8}));
+  BOOST_TEST(!intersects(box, Capsule{{{-2., -2., 0.}}, {{2., 2., 0.}}, .5}));
+
+  BOOST_TEST(
+      !intersects(capsule, Capsule{{{1., 2., -1.}}, {{1., 2., 1.}}, .5}));
+  BOOST_TEST(
+      intersects(capsule, Capsule{{{1., 2., -1.}}, {{1., 2., 1.}}, 1.5}));
+  BOOST_TEST(!intersects(capsule, Capsule{}));
+
+  float const s = 1 / std::sqrt(2.f);
+  OBB const obb{{{1., 1.6, 0.}},
+                {{Point{{s, s, 0.}}, Point{{-s, s, 0.}}, Point{{0., 0., 1.}}}},
+                {1., .1, .1}};
+  BOOST_TEST(intersects(capsule, obb));
+  BOOST_TEST(!intersects(obb, Capsule{{{0., 0., 0.}}, {{2., 0., 0.}}, .5}));
+
+  BOOST_TEST(equals(returnCentroid(capsule), Point{{1., 0., 0.}}));
+
+  // expand a box with a capsule
+  Box bounding_box;
+  expand(bounding_box, capsule);
+  BOOST_TEST(equals(bounding_box, Box{{{-1., -1., -1.}}, {{3., 1., 1.}}}));
+
+  // expand a capsule with points, spheres, boxes and capsules
+  Capsule other;
+  expand(other, Point{{0., 0., 0.}});
+  expand(other, Point{{4., 0., 0.}});
+  BOOST_TEST(other.radius() == 0.f);
+  BOOST_TEST(intersects(Point{{2., 0., 0.}}, other));
+  expand(other, Sphere{{{2., 1., 0.}}, 1.});
+  BOOST_TEST(other.radius() == 2.f);
+  BOOST_TEST(intersects(Point{{2., 2., 0.}}, other));
+  expand(other, Box{{{-1., -1., -1.}}, {{1., 1., 1.}}});
+  BOOST_TEST(intersects(Point{{-1., -1., -1.}}, other));
+  BOOST_TEST(intersects(Point{{4., 2., 0.}}, other));
+  expand(other, Capsule{{{0., 0., 5.}}, {{4., 0., 5.}}, .5});
+  for (auto const &point :
+       {Point{{0., 0., 5.5}}, Point{{4., 0., 5.5}}, Point{{-1., -1., -1.}},
+        Point{{4., 2., 0.}}, Point{{2., 2., 0.}}})
+    BOOST_TEST(intersects(point, other));
+}
+
+BOOST_AUTO_TEST_CASE(sphere_bounding_volume)
+{
+  using ArborX::Details::distance;
+  using ArborX::Details::equals;
+  using ArborX::Details::expand;
+  using ArborX::Details::intersects;
+  using ArborX::Details::makeEmptySphere;
+
+  Sphere const sphere{{{0., 0., 0.}}, 1.};
+
+  BOOST_TEST(intersects(sphere, Sphere{{{2., 0., 0.}}, 1.}));
+  BOOST_TEST(!intersects(Sphere{{{2., 1., 0.}}, 1.}, sphere));
+  BOOST_TEST(!intersects(sphere, makeEmptySphere<Sphere>()));
+  BOOST_TEST(intersects(Box{{{.5, .5, .5}}, {{1., 1., 1.}}}, sphere));
+  BOOST_TEST(!intersects(Box{{{.6, .6, .6}}, {{1., 1., 1.}}}, sphere));
+  BOOST_TEST(distance(sphere, Sphere{{{0., 4., 0.}}, 1.}) == 2.f);
+  BOOST_TEST(distance(sphere, Sphere{{{0., .5, 0.}}, 1.}) == 0.f);
+  BOOST_TEST(distance(Box{{{3., -1., -1.}}, {{4., 1., 1.}}}, sphere) == 2.f);
+
+  // expand the empty sphere with points, boxes and spheres
+  auto other = makeEmptySphere<Sphere>();
+  expand(other, Point{{0., 0., 0.}});
+  BOOST_TEST(equals(other, Sphere{{{0., 0., 0.}}, 0.}));
+  expand(other, Point{{4., 0., 0.}});
+  BOOST_TEST(equals(other, Sphere{{{2., 0., 0.}}, 2.}));
+  // contained already
+  expand(other, Sphere{{{2., 1., 0.}}, .5});
+  BOOST_TEST(equals(other, Sphere{{{2., 0., 0.}}, 2.}));
+  // containing it
+  expand(other, Sphere{{{2., 0., 0.}}, 3.});
+  BOOST_TEST(equals(other, Sphere{{{2., 0., 0.}}, 3.}));
+  expand(other, Sphere{{{-6., 0., 0.}}, 1.});
+  BOOST_TEST(equals(other, Sphere{{{-1., 0., 0.}}, 6.}));
+  expand(other, Box{});
+  BOOST_TEST(equals(other, Sphere{{{-1., 0., 0.}}, 6.}));
+  Box const box{{{9., 0., 0.}}, {{11., 2., 2.}}};
+  expand(other, box);
+  for (auto const &point :
+       {Point{{-7., 0., 0.}}, Point{{11., 2., 2.}}, Point{{9., 0., 0.}},
+        Point{{9., 2., 0.}}, Point{{11., 0., 2.}}})
+    BOOST_TEST(intersects(point, other));
+  BOOST_TEST(!intersects(Point{{12., 3., 3.}}, other));
+
+  // expand a box with a sphere
+  Box bounding_box;
+  expand(bounding_box, sphere);
+  BOOST_TEST(equals(bounding_box, Box{{{-1., -1., -1.}}, {{1., 1., 1.}}}));
+}
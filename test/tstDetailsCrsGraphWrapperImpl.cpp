@@ -12,6 +12,7 @@
 #include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
 #include "ArborX_EnableViewComparison.hpp"
 #include <ArborX_DetailsCrsGraphWrapperImpl.hpp>
+#include <ArborX_LinearBVH.hpp>
 #include <ArborX_Predicates.hpp>
 #include <ArborX_TraversalPolicy.hpp>
 
@@ -93,3 +94,48 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(query_impl, DeviceType, ARBORX_DEVICE_TYPES)
   BOOST_TEST(offset_host == offset_ref, tt::per_element());
   BOOST_TEST(indices_host == indices_ref, tt::per_element());
 }
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(query_with_distances, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  ExecutionSpace space;
+
+  int const n = 10;
+  Kokkos::View<ArborX::Point *, DeviceType> points(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "Testing::points"), n);
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) { points(i) = {{(float)i, 0.f, 0.f}}; });
+  ArborX::BVH<MemorySpace> const tree(space, points);
+
+  Kokkos::View<decltype(ArborX::intersects(ArborX::Sphere{})) *, DeviceType>
+      predicates("Testing::predicates", 2);
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, 1), KOKKOS_LAMBDA(int) {
+        predicates(0) = ArborX::intersects(ArborX::Sphere{{{0, 0, 0}}, 3.5});
+        predicates(1) = ArborX::intersects(ArborX::Sphere{{{6, 1, 0}}, 1.2});
+      });
+
+  Kokkos::View<Kokkos::pair<int, float> *, DeviceType> values("Testing::values",
+                                                              0);
+  Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+  tree.query(space, predicates, ArborX::Experimental::WithDistances{true},
+             values, offset);
+
+  auto offset_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset);
+  auto values_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values);
+  std::vector<int> offset_ref = {0, 4, 5};
+  BOOST_TEST(offset_host == offset_ref, tt::per_element());
+
+  std::vector<int> indices_ref = {0, 1, 2, 3, 6};
+  std::vector<float> distances_ref = {0.f, 1.f, 2.f, 3.f, 1.f};
+  for (int j = 0; j < (int)indices_ref.size(); ++j)
+  {
+    BOOST_TEST(values_host(j).first == indices_ref[j]);
+    BOOST_TEST(values_host(j).second == distances_ref[j], tt::tolerance(1e-6f));
+  }
+}
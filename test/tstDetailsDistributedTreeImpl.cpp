@@ -9,6 +9,7 @@
  * SPDX-License-Identifier: BSD-3-Clause                                    *
  ****************************************************************************/
 
+#include "ArborXTest_StdVectorToKokkosView.hpp"
 #include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
 #include "ArborX_EnableViewComparison.hpp"
 #include <ArborX_DetailsDistributedTreeImpl.hpp>
@@ -18,6 +19,8 @@
 #define BOOST_TEST_MODULE DetailsDistributedTreeImpl
 
 #include <set>
+#include <utility>
+#include <vector>
 
 namespace tt = boost::test_tools;
 
@@ -66,16 +69,19 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(sort_results, DeviceType, ARBORX_DEVICE_TYPES)
       ranks_host(ranks_.data(), ranks_.size());
   Kokkos::deep_copy(ranks, ranks_host);
 
+  // COMMENT: another handle on the ranks must see them sorted too
+  auto ranks_alias = ranks;
+
   using ExecutionSpace = typename DeviceType::execution_space;
   ArborX::Details::DistributedTreeImpl<DeviceType>::sortResults(
       ExecutionSpace{}, ids, results, ranks);
 
-  // COMMENT: ids are untouched
+  // COMMENT: ids are sorted in place
   Kokkos::deep_copy(ids_host, ids);
-  BOOST_TEST(ids_host == ids_, tt::per_element());
+  BOOST_TEST(ids_host == sorted_ids, tt::per_element());
 
   Kokkos::deep_copy(results_host, results);
-  Kokkos::deep_copy(ranks_host, ranks);
+  Kokkos::deep_copy(ranks_host, ranks_alias);
   for (int q = 0; q < m; ++q)
     for (int i = offset[q]; i < offset[q + 1]; ++i)
     {
@@ -416,3 +422,230 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(send_across_network, DeviceType,
   Helper<DeviceType>::checkSendAcrossNetwork(comm, ranks_u, u_exp_unmanaged,
                                              u_ref);
 }
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(send_across_network_and_process, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  // send 2 items to rank k, receive 2 items from every rank
+  int const n = 2 * comm_size;
+  Kokkos::View<int *, DeviceType> exports("exports", n);
+  Kokkos::View<int *, DeviceType> ranks("ranks", n);
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(0, n), KOKKOS_LAMBDA(int i) {
+        exports(i) = 100 * comm_rank + i;
+        ranks(i) = i / 2;
+      });
+
+  ArborX::Details::Distributor<DeviceType> distributor(comm);
+  distributor.createFromSends(ExecutionSpace{}, ranks);
+  Kokkos::View<int *, DeviceType> imports("imports", n);
+
+  // Every range is processed once, and its items are available when it is
+  std::vector<int> num_processed(n, 0);
+  bool first = true;
+  ArborX::Details::DistributedTreeImpl<DeviceType>::sendAcrossNetworkAndProcess(
+      ExecutionSpace{}, distributor, exports, imports,
+      [&](int begin, int end) {
+        BOOST_TEST(end - begin == 2);
+        auto const range_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{},
+            Kokkos::subview(imports, Kokkos::make_pair(begin, end)));
+        int const source = begin / 2;
+        // The local items come first
+        if (first)
+          BOOST_TEST(source == comm_rank);
+        first = false;
+        for (int i = begin; i < end; ++i)
+        {
+          BOOST_TEST(range_host(i - begin) == 100 * source + 2 * comm_rank +
+                                                  (i - begin));
+          ++num_processed[i];
+        }
+      });
+
+  for (int i = 0; i < n; ++i)
+    BOOST_TEST(num_processed[i] == 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(distributor_source_discovery, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using Distributor = ArborX::Details::Distributor<DeviceType>;
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  // Send d + 1 + shift items to every rank d such that (comm_rank + d) % 3
+  // is not shift
+  auto make_exports = [&](int shift) {
+    std::vector<int> ranks;
+    std::vector<int> values;
+    for (int d = 0; d < comm_size; ++d)
+      if ((comm_rank + d) % 3 != shift)
+        for (int k = 0; k < d + 1 + shift; ++k)
+        {
+          ranks.push_back(d);
+          values.push_back(1000 * comm_rank + k);
+        }
+    return std::make_pair(
+        ArborXTest::toView<DeviceType>(ranks, "Testing::ranks"),
+        ArborXTest::toView<DeviceType>(values, "Testing::exports"));
+  };
+  auto exchange = [](Distributor &distributor, auto const &ranks_and_exports) {
+    auto const &[ranks, exports] = ranks_and_exports;
+    int const n_imports =
+        distributor.createFromSends(ExecutionSpace{}, ranks);
+    Kokkos::View<int *, DeviceType> imports("Testing::imports", n_imports);
+    ArborX::Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+        ExecutionSpace{}, distributor, exports, imports);
+    auto const imports_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, imports);
+    return std::vector<int>(imports_host.data(),
+                            imports_host.data() + imports_host.size());
+  };
+
+  for (int shift : {0, 1})
+  {
+    auto const ranks_and_exports = make_exports(shift);
+    Distributor alltoall(comm, Distributor::SourceDiscovery::Alltoall);
+    auto const reference = exchange(alltoall, ranks_and_exports);
+
+    // Reusing the distributor with the same pattern, and with another one
+    Distributor nbx(comm, Distributor::SourceDiscovery::NonBlockingConsensus);
+    for (int repeat = 0; repeat < 2; ++repeat)
+    {
+      auto const imports = exchange(nbx, ranks_and_exports);
+      BOOST_TEST(imports == reference, tt::per_element());
+    }
+    auto const other = make_exports(1 - shift);
+    Distributor other_alltoall(comm);
+    BOOST_TEST(exchange(nbx, other) == exchange(other_alltoall, other),
+               tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(distributor_persistent_communication,
+                              DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using Distributor = ArborX::Details::Distributor<DeviceType>;
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  // Send d + 1 + shift items, in reverse order of the ranks, to every rank d
+  // such that (comm_rank + d) % 2 is not shift
+  auto make_ranks = [&](int shift) {
+    std::vector<int> ranks;
+    for (int d = comm_size - 1; d >= 0; --d)
+      if ((comm_rank + d) % 2 != shift)
+        for (int k = 0; k < d + 1 + shift; ++k)
+          ranks.push_back(d);
+    return ArborXTest::toView<DeviceType>(ranks, "Testing::ranks");
+  };
+  auto exchange = [](Distributor &distributor, auto const &ranks,
+                     auto value) {
+    using Value = decltype(value);
+    int const n_imports = distributor.createFromSends(ExecutionSpace{}, ranks);
+    std::vector<Value> values(ranks.size());
+    for (int i = 0; i < (int)values.size(); ++i)
+      values[i] = value * (i + 1);
+    auto const exports =
+        ArborXTest::toView<DeviceType>(values, "Testing::exports");
+    Kokkos::View<Value *, DeviceType> imports("Testing::imports", n_imports);
+    ArborX::Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+        ExecutionSpace{}, distributor, exports, imports);
+    auto const imports_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, imports);
+    return std::vector<Value>(imports_host.data(),
+                              imports_host.data() + imports_host.size());
+  };
+
+  Distributor persistent(comm, Distributor::SourceDiscovery::Alltoall, true);
+  for (int shift : {0, 1})
+  {
+    auto const ranks = make_ranks(shift);
+    Distributor reference(comm);
+    auto const reference_ints = exchange(reference, ranks, 1 + comm_rank);
+    auto const reference_doubles = exchange(reference, ranks, 0.5 * comm_rank);
+
+    // Exchanges of items of different sizes for the same pattern alternate
+    for (int repeat = 0; repeat < 2; ++repeat)
+    {
+      BOOST_TEST(exchange(persistent, ranks, 1 + comm_rank) ==
+                     reference_ints,
+                 tt::per_element());
+      BOOST_TEST(exchange(persistent, ranks, 0.5 * comm_rank) ==
+                     reference_doubles,
+                 tt::per_element());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(distributor_node_aware_routing, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using Distributor = ArborX::Details::Distributor<DeviceType>;
+  MPI_Comm comm;
+  MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  // Send d + 1 items to every rank d such that (comm_rank + d) % 3 is not 0,
+  // and the items of each process to itself
+  std::vector<int> ranks_host;
+  for (int d = 0; d < comm_size; ++d)
+    if ((comm_rank + d) % 3 != 0 || d == comm_rank)
+      for (int k = 0; k < d + 1; ++k)
+        ranks_host.push_back(d);
+  auto const ranks =
+      ArborXTest::toView<DeviceType>(ranks_host, "Testing::ranks");
+  std::vector<int> values(ranks_host.size());
+  for (int i = 0; i < (int)values.size(); ++i)
+    values[i] = 1000 * comm_rank + i;
+  auto const exports =
+      ArborXTest::toView<DeviceType>(values, "Testing::exports");
+
+  auto exchange = [&]() {
+    Distributor distributor(comm);
+    int const n_imports = distributor.createFromSends(ExecutionSpace{}, ranks);
+    Kokkos::View<int *, DeviceType> imports("Testing::imports", n_imports);
+    ArborX::Details::DistributedTreeImpl<DeviceType>::sendAcrossNetwork(
+        ExecutionSpace{}, distributor, exports, imports);
+    auto const imports_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, imports);
+    return std::vector<int>(imports_host.data(),
+                            imports_host.data() + imports_host.size());
+  };
+  auto const reference = exchange();
+
+  // Pretend that the nodes hold 3 processes, or fewer for the last one, and
+  // that all the processes are on the same node
+  for (int node_size : {3, comm_size})
+  {
+    MPI_Comm node_comm;
+    MPI_Comm_split(comm, comm_rank / node_size, comm_rank, &node_comm);
+    ArborX::Details::setNodeAwareRouting(comm, node_comm);
+    MPI_Comm_free(&node_comm);
+    BOOST_TEST(exchange() == reference, tt::per_element());
+  }
+
+  ArborX::Details::setNodeAwareRouting(comm, MPI_COMM_NULL);
+  BOOST_TEST(exchange() == reference, tt::per_element());
+  MPI_Comm_free(&comm);
+}
@@ -0,0 +1,87 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include "ArborX_EnableViewComparison.hpp"
+#include <ArborX_LinearBVH.hpp>
+
+#include "BoostTest_CUDA_clang_workarounds.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace Test
+{
+template <class ExecutionSpace>
+Kokkos::View<ArborX::Box *, ExecutionSpace>
+make_boxes(ExecutionSpace const &space, int n, float shift)
+{
+  Kokkos::View<ArborX::Box *, ExecutionSpace> boxes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing, "Test::boxes"),
+      n);
+
+  Kokkos::parallel_for(
+      "Test::make_boxes", Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        float const x = i + shift;
+        boxes(i) = {{x, x, x}, {x + 1, x + 1, x + 1}};
+      });
+
+  return boxes;
+}
+
+template <class Counts>
+struct CountPairs
+{
+  Counts _counts;
+  int _m;
+
+  template <class Predicate>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate, int j) const
+  {
+    int const i = ArborX::getData(predicate);
+    Kokkos::atomic_increment(&_counts(i * _m + j));
+  }
+};
+} // namespace Test
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dual_tree_traversal, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using MemorySpace = typename DeviceType::memory_space;
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace exec_space;
+
+  // Box i of the first hierarchy intersects boxes i-1 and i of the second one
+  for (auto [n, m] : {std::pair{0, 5}, std::pair{1, 1}, std::pair{1, 7},
+                      std::pair{17, 1}, std::pair{24, 31}})
+  {
+    ArborX::BVH<MemorySpace> bvh_a(exec_space,
+                                   Test::make_boxes(exec_space, n, 0.f));
+    ArborX::BVH<MemorySpace> bvh_b(exec_space,
+                                   Test::make_boxes(exec_space, m, 0.5f));
+
+    Kokkos::View<int *, MemorySpace> counts("Test::counts", n * m);
+    bvh_a.join(exec_space, bvh_b,
+               Test::CountPairs<decltype(counts)>{counts, m});
+
+    std::vector<int> counts_ref(n * m, 0);
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < m; ++j)
+        if (j == i - 1 || j == i)
+          counts_ref[i * m + j] = 1;
+
+    BOOST_TEST(counts_ref == Kokkos::create_mirror_view_and_copy(
+                                 Kokkos::HostSpace{}, counts),
+               boost::test_tools::per_element());
+  }
+}
@@ -9,10 +9,16 @@
  * SPDX-License-Identifier: BSD-3-Clause                                    *
  ****************************************************************************/
 
+#include <ArborX_DetailsHilbertCode.hpp>
 #include <ArborX_DetailsMortonCode.hpp>
 
 #include <boost/test/unit_test.hpp>
 
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 using namespace ArborX::Details;
 
 #include <ArborX_HyperPoint.hpp>
@@ -48,6 +54,29 @@ BOOST_AUTO_TEST_CASE(expand_bits)
   // clang-format on
 }
 
+template <int N>
+void checkExpandBitsMatchesExpandBitsBy()
+{
+  for (unsigned x : {0u, 1u, 0b110010011101u, 0x12345678u, 0xffffffffu})
+    BOOST_TEST(expandBits<N>(x) == expandBitsBy<N>(x));
+  for (unsigned long long y :
+       {0llu, 1llu, 0b11111111111111000001llu, 0x123456789abcdef0llu,
+        0xffffffffffffffffllu})
+    BOOST_TEST(expandBits<N>(y) == expandBitsBy<N>(y));
+}
+
+template <std::size_t... N>
+void checkExpandBitsMatchesExpandBitsBy(std::index_sequence<N...>)
+{
+  (checkExpandBitsMatchesExpandBitsBy<N>(), ...);
+}
+
+BOOST_AUTO_TEST_CASE(expand_bits_fast_path)
+{
+  // The bit deposit, when available, drops the same high bits
+  checkExpandBitsMatchesExpandBitsBy(std::make_index_sequence<10>{});
+}
+
 BOOST_AUTO_TEST_CASE(morton_codes)
 {
   using ArborX::ExperimentalHyperGeometry::Point;
@@ -79,6 +108,66 @@ BOOST_AUTO_TEST_CASE(morton_codes)
   BOOST_TEST(morton64(Point{1.f, 1.f, 1.f}) == 0x7fffffffffffffffllu);
   BOOST_TEST(morton64(Point{0.f, 0.f, 1.f}) == 0x1249249249249249llu);
   BOOST_TEST(morton64(Point{1.f, 1.f, 0.f}) == 0x6db6db6db6db6db6llu);
+
+  // Coordinates that are the same in single precision still fall in
+  // different bins
+  BOOST_TEST(morton64(Point{0.5}) == 0x4000000000000000llu);
+  BOOST_TEST(morton64(Point{0.5 + 0x1p-40}) == 0x4000000000800000llu);
+}
+
+template <int DIM, int BITS>
+void checkHilbertCurveVisitsNeighboringCells()
+{
+  using ArborX::Details::hilbertCode;
+  constexpr int N = 1 << BITS;
+  int n = 1;
+  for (int d = 0; d < DIM; ++d)
+    n *= N;
+
+  // Cells of the grid in the order in which the curve visits them
+  std::vector<std::array<int, DIM>> cells(n);
+  std::vector<bool> visited(n, false);
+  for (int c = 0; c < n; ++c)
+  {
+    std::array<int, DIM> cell;
+    ArborX::ExperimentalHyperGeometry::Point<DIM> p;
+    for (int d = 0, stride = 1; d < DIM; ++d, stride *= N)
+    {
+      cell[d] = (c / stride) % N;
+      p[d] = (cell[d] + 0.5f) / N;
+    }
+    auto const code = hilbertCode<unsigned int, BITS>(p);
+    BOOST_TEST_REQUIRE((int)code < n);
+    BOOST_TEST(!visited[code]);
+    visited[code] = true;
+    cells[code] = cell;
+  }
+
+  for (int i = 1; i < n; ++i)
+  {
+    int manhattan_distance = 0;
+    for (int d = 0; d < DIM; ++d)
+      manhattan_distance += std::abs(cells[i][d] - cells[i - 1][d]);
+    BOOST_TEST(manhattan_distance == 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(hilbert_codes)
+{
+  checkHilbertCurveVisitsNeighboringCells<2, 1>();
+  checkHilbertCurveVisitsNeighboringCells<2, 4>();
+  checkHilbertCurveVisitsNeighboringCells<3, 1>();
+  checkHilbertCurveVisitsNeighboringCells<3, 3>();
+
+  using ArborX::Details::hilbert32;
+  using ArborX::Details::hilbert64;
+  using ArborX::ExperimentalHyperGeometry::Point;
+
+  // The curve starts at the origin
+  BOOST_TEST(hilbert32(Point{0.f, 0.f}) == 0u);
+  BOOST_TEST(hilbert64(Point{0.f, 0.f}) == 0llu);
+  BOOST_TEST(hilbert32(Point{0.f, 0.f, 0.f}) == 0u);
+  BOOST_TEST(hilbert64(Point{0.f, 0.f, 0.f}) == 0llu);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
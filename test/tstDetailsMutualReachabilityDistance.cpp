@@ -12,6 +12,7 @@
 #include "ArborXTest_StdVectorToKokkosView.hpp"
 #include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
 #include "ArborX_EnableViewComparison.hpp"
+#include <ArborX_DetailsAllNearestNeighbors.hpp>
 #include <ArborX_DetailsKokkosExtArithmeticTraits.hpp>
 #include <ArborX_DetailsMutualReachabilityDistance.hpp>
 #include <ArborX_LinearBVH.hpp>
@@ -47,8 +48,68 @@ auto compute_core_distances(ExecutionSpace exec_space,
   return Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, distances);
 }
 
+template <class ExecutionSpace>
+auto compute_kth_nearest_neighbor_distances(
+    ExecutionSpace exec_space, std::vector<ArborX::Point> const &points_host,
+    int k)
+{
+  auto points = toView<ExecutionSpace>(points_host, "Test::points");
+
+  using MemorySpace = typename ExecutionSpace::memory_space;
+  ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<ArborX::Box>>
+      bvh{exec_space, points};
+  Kokkos::View<float *, MemorySpace> distances(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "Test::core_distances"),
+      bvh.size());
+  ArborX::Details::KthNearestNeighborDistances(exec_space, bvh, k, distances);
+
+  return Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, distances);
+}
+
+// Same, stored in the order of the leaves and moved back to the order of the
+// values for the comparison
+template <class ExecutionSpace>
+auto compute_kth_nearest_neighbor_distances_in_leaf_order(
+    ExecutionSpace exec_space, std::vector<ArborX::Point> const &points_host,
+    int k)
+{
+  auto points = toView<ExecutionSpace>(points_host, "Test::points");
+
+  using MemorySpace = typename ExecutionSpace::memory_space;
+  ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<ArborX::Box>>
+      bvh{exec_space, points};
+  int const n = bvh.size();
+  Kokkos::View<float *, MemorySpace> leaf_distances(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                         "Test::leaf_core_distances"),
+      n);
+  ArborX::Details::KthNearestNeighborDistances(exec_space, bvh, k,
+                                               leaf_distances, true);
+  Kokkos::View<float *, MemorySpace> distances(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "Test::core_distances"),
+      n);
+  Kokkos::parallel_for(
+      "Test::permute_core_distances",
+      Kokkos::RangePolicy<ExecutionSpace>(exec_space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        using ArborX::Details::HappyTreeFriends;
+        distances(HappyTreeFriends::getValue(bvh, i).index) =
+            leaf_distances(i);
+      });
+
+  return Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, distances);
+}
+
 #define ARBORX_TEST_COMPUTE_CORE_DISTANCES(exec_space, points, k, ref)         \
   BOOST_TEST(Test::compute_core_distances(exec_space, points, k) == ref,       \
+             boost::test_tools::per_element());                                \
+  BOOST_TEST(Test::compute_kth_nearest_neighbor_distances(exec_space, points,  \
+                                                          k) == ref,           \
+             boost::test_tools::per_element());                                \
+  BOOST_TEST(Test::compute_kth_nearest_neighbor_distances_in_leaf_order(       \
+                 exec_space, points, k) == ref,                                \
              boost::test_tools::per_element())
 
 template <class ExecutionSpace>
@@ -0,0 +1,139 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_DetailsNodeAggregates.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include "BoostTest_CUDA_clang_workarounds.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace Test
+{
+// Mass and first moment along the x axis of the points below a node
+struct Mass
+{
+  float mass;
+  float moment;
+};
+
+struct LeafMass
+{
+  template <class Value>
+  KOKKOS_FUNCTION Mass operator()(Value const &value) const
+  {
+    return {1.f, value.bounding_volume.minCorner()[0]};
+  }
+};
+
+struct CombineMasses
+{
+  KOKKOS_FUNCTION Mass operator()(Mass const &left, Mass const &right) const
+  {
+    return {left.mass + right.mass, left.moment + right.moment};
+  }
+};
+
+// Accepts the aggregates of the nodes farther than a given distance from the
+// target, and accumulates the masses that each target sees
+template <class MemorySpace>
+struct AccumulateMasses
+{
+  Kokkos::View<float *, MemorySpace> _masses;
+  Kokkos::View<int *, MemorySpace> _leaves;
+  float _distance;
+
+  template <class Target, class Value>
+  KOKKOS_FUNCTION void operator()(Target const &target, Value const &) const
+  {
+    Kokkos::atomic_add(&_masses(target.second), 1.f);
+    Kokkos::atomic_increment(&_leaves(target.second));
+  }
+
+  template <class Target, class BoundingVolume>
+  KOKKOS_FUNCTION bool operator()(Target const &target, Mass const &aggregate,
+                                  BoundingVolume const &bounding_volume) const
+  {
+    if (ArborX::Details::distance(target.first, bounding_volume) <= _distance)
+      return false;
+    Kokkos::atomic_add(&_masses(target.second), aggregate.mass);
+    return true;
+  }
+};
+} // namespace Test
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(node_aggregates, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using MemorySpace = typename DeviceType::memory_space;
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace space;
+
+  int const n = 100;
+  Kokkos::View<ArborX::Point *, MemorySpace> points(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing, "Test::points"),
+      n);
+  Kokkos::parallel_for(
+      "Test::make_points", Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        points(i) = {(float)i, 0.f, 0.f};
+      });
+  ArborX::BVH<MemorySpace> bvh(space, points);
+
+  using ArborX::Experimental::computeNodeAggregates;
+  auto const aggregates = computeNodeAggregates(space, bvh, Test::LeafMass{},
+                                                Test::CombineMasses{});
+  BOOST_TEST(aggregates.size() == 2 * n - 1);
+  auto const aggregates_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, aggregates);
+  int const root = n;
+  BOOST_TEST(aggregates_host(root).mass == n);
+  BOOST_TEST(aggregates_host(root).moment == n * (n - 1) / 2);
+
+  // Far from all the points, and among them
+  using Target = Kokkos::pair<ArborX::Point, int>;
+  std::vector<Target> targets_host = {
+      {{{-1000.f, 0.f, 0.f}}, 0}, {{{50.f, 0.f, 0.f}}, 1}};
+  Kokkos::View<Target *, MemorySpace> targets("Test::targets",
+                                              targets_host.size());
+  Kokkos::deep_copy(
+      space, targets,
+      Kokkos::View<Target *, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>(
+          targets_host.data(), targets_host.size()));
+
+  Kokkos::View<float *, MemorySpace> masses("Test::masses", 2);
+  Kokkos::View<int *, MemorySpace> leaves("Test::leaves", 2);
+  ArborX::Experimental::traverseNodeAggregates(
+      space, bvh, targets, aggregates,
+      Test::AccumulateMasses<MemorySpace>{masses, leaves, 10.f});
+
+  // Each target sees every point once, either by itself or through the
+  // aggregate of one of its ancestors
+  auto const masses_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, masses);
+  auto const leaves_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, leaves);
+  BOOST_TEST(masses_host(0) == n);
+  BOOST_TEST(masses_host(1) == n);
+  BOOST_TEST(leaves_host(0) == 0);
+  BOOST_TEST(leaves_host(1) > 0);
+  BOOST_TEST(leaves_host(1) < n);
+
+  // Opening every node visits all the leaves
+  Kokkos::deep_copy(space, masses, 0.f);
+  Kokkos::deep_copy(space, leaves, 0);
+  ArborX::Experimental::traverseNodeAggregates(
+      space, bvh, targets, aggregates,
+      Test::AccumulateMasses<MemorySpace>{masses, leaves, 1e6f});
+  BOOST_TEST(Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                 leaves)(1) == n);
+}
@@ -8,6 +8,7 @@
  *                                                                          *
  * SPDX-License-Identifier: BSD-3-Clause                                    *
  ****************************************************************************/
+#include "ArborXTest_StdVectorToKokkosView.hpp"
 #include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
 #include "ArborX_EnableViewComparison.hpp"
 #include <ArborX_DetailsAlgorithms.hpp>
@@ -15,6 +16,7 @@
 #include <ArborX_DetailsNode.hpp>       // ROPE SENTINEL
 #include <ArborX_DetailsSortUtils.hpp>  // sortObjects
 #include <ArborX_DetailsTreeConstruction.hpp>
+#include <ArborX_HyperPoint.hpp>
 #include <ArborX_IndexableGetter.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -87,6 +89,47 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(assign_morton_codes, DeviceType,
   BOOST_TEST(morton_codes_host == ref, tt::per_element());
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(assign_principal_axes_morton_codes, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  // Points in 12 dimensions spread along the diagonal with some small
+  // deviations, so that the code only depends on the position along it
+  constexpr int DIM = 12;
+  using Point = ArborX::ExperimentalHyperGeometry::Point<DIM>;
+  int const n = 64;
+  std::vector<Point> points(n);
+  for (int i = 0; i < n; ++i)
+  {
+    for (int d = 0; d < DIM; ++d)
+      points[i][d] = i;
+    points[i][i % DIM] += 0.01f;
+  }
+  auto points_device = ArborXTest::toView<DeviceType>(points, "Test::points");
+
+  typename DeviceType::execution_space space{};
+  auto const curve =
+      ArborX::Experimental::makePrincipalAxesMorton64(space, points_device);
+  ArborX::ExperimentalHyperGeometry::Box<DIM> scene_host;
+  ArborX::Details::TreeConstruction::calculateBoundingBoxOfTheScene(
+      space, points_device, scene_host);
+
+  Kokkos::View<unsigned long long *, DeviceType> codes("codes", n);
+  ArborX::Details::TreeConstruction::projectOntoSpaceFillingCurve(
+      space, points_device, curve, scene_host, codes);
+  auto codes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, codes);
+
+  // The orientation of the principal axis is arbitrary
+  bool increasing = true;
+  bool decreasing = true;
+  for (int i = 1; i < n; ++i)
+  {
+    increasing = increasing && codes_host(i - 1) < codes_host(i);
+    decreasing = decreasing && codes_host(i - 1) > codes_host(i);
+  }
+  BOOST_TEST((increasing || decreasing));
+}
+
 template <typename DeviceType>
 class FillK
 {
@@ -94,6 +94,42 @@ auto reduceLabels(ExecutionSpace const &exec_space,
   BOOST_TEST(Test::reduceLabels(exec_space, parents, labels) == ref,           \
              boost::test_tools::per_element())
 
+template <class ExecutionSpace>
+auto updateLabels(ExecutionSpace const &exec_space,
+                  std::vector<int> const &parents_host,
+                  std::vector<int> const &labels_host)
+{
+  auto labels = toView<ExecutionSpace>(labels_host, "Test::labels");
+  auto parents = toView<ExecutionSpace>(parents_host, "Test::parents");
+
+  int const n = (parents.size() + 1) / 2;
+  Kokkos::View<int *, ExecutionSpace> updates("Test::updates", n - 1);
+  ArborX::Details::updateLabels(exec_space, parents, labels, updates);
+
+  return Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, labels);
+}
+
+#define ARBORX_TEST_UPDATE_LABELS(exec_space, parents, labels, ref)            \
+  BOOST_TEST(Test::updateLabels(exec_space, parents, labels) == ref,           \
+             boost::test_tools::per_element())
+
+template <class ExecutionSpace>
+auto reduceMinValues(ExecutionSpace const &exec_space,
+                     std::vector<int> const &parents_host,
+                     std::vector<float> const &values_host)
+{
+  auto values = toView<ExecutionSpace>(values_host, "Test::values");
+  auto parents = toView<ExecutionSpace>(parents_host, "Test::parents");
+
+  ArborX::Details::reduceMinValues(exec_space, parents, values);
+
+  return Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values);
+}
+
+#define ARBORX_TEST_REDUCE_MIN_VALUES(exec_space, parents, values, ref)        \
+  BOOST_TEST(Test::reduceMinValues(exec_space, parents, values) == ref,        \
+             boost::test_tools::per_element())
+
 } // namespace Test
 
 BOOST_AUTO_TEST_SUITE(TreeNodeLabeling)
@@ -188,4 +224,45 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(reduce_labels, DeviceType, ARBORX_DEVICE_TYPES)
       (std::vector<int>{0, 0, 0, 3, 4, 4, 4, 7, -1, 0, -1, -1, -1, -1, 4}));
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(update_labels, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  // Same tree as above
+  auto const parents =
+      std::vector<int>{9, 9, 10, 10, 12, 14, 14, 13, -1, 11, 11, 8, 8, 12, 13};
+
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace exec_space;
+
+  // The internal nodes are labeled as computed by reduceLabels for the leaves
+  // {0, 0, 0, 3, 4, 4, 4, 7}, then the components 3 and 7 are merged into 0
+  // and 4
+  ARBORX_TEST_UPDATE_LABELS(
+      exec_space, parents,
+      (std::vector<int>{0, 0, 0, 0, 4, 4, 4, 4, -1, 0, -1, -1, -1, -1, 4}),
+      (std::vector<int>{0, 0, 0, 0, 4, 4, 4, 4, -1, 0, 0, 0, 4, 4, 4}));
+
+  // Same, with a single component left, labeled by a leaf whose previous
+  // component was merged
+  ARBORX_TEST_UPDATE_LABELS(
+      exec_space, parents,
+      (std::vector<int>{7, 7, 7, 7, 7, 7, 7, 7, -1, 0, -1, -1, -1, -1, 4}),
+      (std::vector<int>{7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7}));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(reduce_min_values, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  // Same tree as above
+  auto const parents =
+      std::vector<int>{9, 9, 10, 10, 12, 14, 14, 13, -1, 11, 11, 8, 8, 12, 13};
+
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace exec_space;
+
+  ARBORX_TEST_REDUCE_MIN_VALUES(
+      exec_space, parents,
+      (std::vector<float>{3, 1, 4, 1, 5, 9, 2, 6, 0, 0, 0, 0, 0, 0, 0}),
+      (std::vector<float>{3, 1, 4, 1, 5, 9, 2, 6, 1, 1, 1, 1, 2, 2, 2}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
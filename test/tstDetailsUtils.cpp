@@ -12,16 +12,23 @@
 #include "ArborXTest_StdVectorToKokkosView.hpp"
 #include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
 #include "ArborX_EnableViewComparison.hpp"
+#include <ArborX_DetailsKokkosExtSort.hpp>
 #include <ArborX_DetailsSortUtils.hpp>
 #include <ArborX_DetailsUtils.hpp>
+#include <ArborX_DimensionDispatch.hpp>
 #include <ArborX_Exception.hpp>
+#include <ArborX_SortResultsPerPredicate.hpp>
 
 #include <Kokkos_Core.hpp>
 
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <numeric>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #define BOOST_TEST_MODULE StandardAlgorithms
@@ -105,6 +112,52 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(prefix_sum, DeviceType, ARBORX_DEVICE_TYPES)
   BOOST_TEST(w_host == w_ref, tt::per_element());
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(prefix_sum_with_total, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace space{};
+  // Spans several tiles of the single-pass scan on devices
+  int const n = 100000;
+  Kokkos::View<int *, DeviceType> x("x", n);
+  std::vector<int> x_ref(n);
+  for (int i = 0; i < n; ++i)
+    x_ref[i] = i % 3;
+  auto x_host = Kokkos::create_mirror_view(x);
+  for (int i = 0; i < n; ++i)
+    x_host(i) = x_ref[i];
+  Kokkos::deep_copy(x, x_host);
+  std::vector<int> y_ref(n);
+  std::exclusive_scan(x_ref.begin(), x_ref.end(), y_ref.begin(), 0);
+  int const total_ref = y_ref.back() + x_ref.back();
+
+  Kokkos::View<int *, DeviceType> y("y", n);
+  Kokkos::View<int, DeviceType> total("total");
+  ArborX::exclusivePrefixSum(space, x, y, total);
+  auto y_host = Kokkos::create_mirror_view(y);
+  Kokkos::deep_copy(y_host, y);
+  auto total_host = Kokkos::create_mirror_view(total);
+  Kokkos::deep_copy(total_host, total);
+  BOOST_TEST(y_host == y_ref, tt::per_element());
+  BOOST_TEST(total_host() == total_ref);
+
+  // in-place
+  ArborX::exclusivePrefixSum(space, x, x, total);
+  Kokkos::deep_copy(x_host, x);
+  Kokkos::deep_copy(total_host, total);
+  BOOST_TEST(x_host == y_ref, tt::per_element());
+  BOOST_TEST(total_host() == total_ref);
+
+  Kokkos::View<int *, DeviceType> z("z", 0);
+  ArborX::exclusivePrefixSum(space, z, z, total);
+  Kokkos::deep_copy(total_host, total);
+  BOOST_TEST(total_host() == 0);
+
+  Kokkos::View<int *, DeviceType> w("w", 11);
+  BOOST_CHECK_THROW(ArborX::exclusivePrefixSum(space, x, w, total),
+                    ArborX::SearchException);
+}
+
 BOOST_AUTO_TEST_CASE_TEMPLATE(minmax, DeviceType, ARBORX_DEVICE_TYPES)
 {
   using ExecutionSpace = typename DeviceType::execution_space;
@@ -258,6 +311,261 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(sort_objects, DeviceType, ARBORX_DEVICE_TYPES)
   }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(sort_objects_large, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace space{};
+
+  // Enough keys to be split in several chunks by the radix sort on the host,
+  // with duplicates and with a range that does not start at zero
+  int const n = 50000;
+  std::vector<unsigned long long> values(n);
+  for (int i = 0; i < n; ++i)
+    values[i] = (1ull << 40) + ((i * 7919ull) % 30011ull) * 104729ull;
+
+  Kokkos::View<unsigned long long *, Kokkos::HostSpace> host_view("data", n);
+  std::copy(values.begin(), values.end(), host_view.data());
+  auto device_view = Kokkos::create_mirror_view_and_copy(space, host_view);
+  auto device_permutation = ArborX::Details::sortObjects(space, device_view);
+  Kokkos::deep_copy(space, host_view, device_view);
+
+  std::vector<unsigned long long> values_copy = values;
+  std::sort(values_copy.begin(), values_copy.end());
+  auto host_permutation = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{}, device_permutation);
+  BOOST_TEST(host_view == values_copy, tt::per_element());
+
+  for (int i = 0; i < n; ++i)
+    values_copy[i] = values[host_permutation(i)];
+  BOOST_TEST(host_view == values_copy, tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(sort_nearly_sorted_objects, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace space{};
+
+  // Sorted, with neighbors swapped, with elements moved across the blocks of
+  // the insertion sort, and reversed
+  int const n = 1000;
+  std::vector<std::vector<int>> inputs(4, std::vector<int>(n));
+  for (int i = 0; i < n; ++i)
+  {
+    inputs[0][i] = inputs[1][i] = inputs[2][i] = 3 * i;
+    inputs[3][i] = n - i;
+  }
+  for (int i = 0; i + 1 < n; i += 5)
+    std::swap(inputs[1][i], inputs[1][i + 1]);
+  for (int i = 0; i + 300 < n; i += 97)
+    std::swap(inputs[2][i], inputs[2][i + 300]);
+
+  for (auto const &values : inputs)
+  {
+    auto device_view = ArborXTest::toView<DeviceType>(values);
+    auto device_permutation = ArborX::Details::sortNearlySortedObjects(
+        space, device_view, std::nullopt);
+    auto host_view =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, device_view);
+
+    std::vector<int> values_copy = values;
+    std::sort(values_copy.begin(), values_copy.end());
+    auto host_permutation = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, device_permutation);
+    BOOST_TEST(host_view == values_copy, tt::per_element());
+
+    for (int i = 0; i < n; ++i)
+      values_copy[i] = values[host_permutation(i)];
+    BOOST_TEST(host_view == values_copy, tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(unsorted_range, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace space{};
+
+  auto unsorted_range = [&](std::vector<int> const &values) {
+    auto const range = ArborX::Details::unsortedRange(
+        space, ArborXTest::toView<DeviceType>(values));
+    return std::make_pair(range.first, range.second);
+  };
+
+  int const n = 1000;
+  std::vector<int> values(n);
+  for (int i = 0; i < n; ++i)
+    values[i] = 3 * i;
+  BOOST_TEST((unsorted_range(values) == std::make_pair(0, 0)));
+  BOOST_TEST((unsorted_range({}) == std::make_pair(0, 0)));
+  BOOST_TEST((unsorted_range({1}) == std::make_pair(0, 0)));
+
+  // Neighbors swapped
+  std::swap(values[127], values[128]);
+  BOOST_TEST((unsorted_range(values) == std::make_pair(127, 129)));
+  std::swap(values[127], values[128]);
+
+  // Element moved past the elements that follow it
+  values[129] = 3 * 140 + 1;
+  BOOST_TEST((unsorted_range(values) == std::make_pair(129, 141)));
+
+  std::reverse(values.begin(), values.end());
+  BOOST_TEST((unsorted_range(values) == std::make_pair(0, n)));
+}
+
+namespace
+{
+int arborx_test_num_sorts_by_key;
+
+void arborx_test_count_sorts_by_key(char const *label)
+{
+  if (std::string(label).rfind("ArborX::KokkosExt::sortByKey", 0) == 0)
+    ++arborx_test_num_sorts_by_key;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(sort_nearly_sorted_objects_without_full_sort,
+                              DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace space{};
+
+  // Few elements moved across the boundaries of the blocks of the insertion
+  // sort, which it brings in place without sorting by key
+  int const n = 1000;
+  std::vector<int> values(n);
+  for (int i = 0; i < n; ++i)
+    values[i] = 3 * i;
+  for (int i : {127, 384, 639, 896})
+  {
+    std::swap(values[i - 2], values[i + 1]);
+    std::swap(values[i], values[i + 3]);
+  }
+
+  auto device_view = ArborXTest::toView<DeviceType>(values);
+  arborx_test_num_sorts_by_key = 0;
+  Kokkos::Tools::Experimental::set_push_region_callback(
+      arborx_test_count_sorts_by_key);
+  auto device_permutation = ArborX::Details::sortNearlySortedObjects(
+      space, device_view, std::nullopt);
+  Kokkos::Tools::Experimental::set_push_region_callback(nullptr);
+  BOOST_TEST(arborx_test_num_sorts_by_key == 0);
+
+  std::vector<int> values_copy = values;
+  std::sort(values_copy.begin(), values_copy.end());
+  auto host_view =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, device_view);
+  BOOST_TEST(host_view == values_copy, tt::per_element());
+
+  auto host_permutation = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{}, device_permutation);
+  for (int i = 0; i < n; ++i)
+    values_copy[i] = values[host_permutation(i)];
+  BOOST_TEST(host_view == values_copy, tt::per_element());
+}
+
+namespace
+{
+int arborx_test_num_cub_sorts_by_key;
+
+void arborx_test_count_cub_sorts_by_key(char const *label)
+{
+  if (std::string(label) == "ArborX::KokkosExt::sortByKey::CUB")
+    ++arborx_test_num_cub_sorts_by_key;
+}
+
+template <typename DeviceType, typename Key>
+void checkSortByKey(std::vector<Key> const &keys)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace space{};
+
+  int const n = keys.size();
+  std::vector<int> values(n);
+  std::iota(values.begin(), values.end(), 0);
+  auto device_keys = ArborXTest::toView<DeviceType>(keys, "Test::keys");
+  auto device_values = ArborXTest::toView<DeviceType>(values, "Test::values");
+
+  arborx_test_num_cub_sorts_by_key = 0;
+  Kokkos::Tools::Experimental::set_push_region_callback(
+      arborx_test_count_cub_sorts_by_key);
+  KokkosExt::sortByKey(space, device_keys, device_values);
+  Kokkos::Tools::Experimental::set_push_region_callback(nullptr);
+#if defined(KOKKOS_ENABLE_CUDA)
+  // Arithmetic keys are sorted by CUB on CUDA
+  if constexpr (std::is_same_v<ExecutionSpace, Kokkos::Cuda>)
+    BOOST_TEST(arborx_test_num_cub_sorts_by_key == 1);
+#endif
+
+  // The keys are distinct, so that the sorted values are unique
+  std::vector<int> permutation = values;
+  std::sort(permutation.begin(), permutation.end(),
+            [&keys](int i, int j) { return keys[i] < keys[j]; });
+  std::vector<Key> sorted_keys(n);
+  for (int i = 0; i < n; ++i)
+    sorted_keys[i] = keys[permutation[i]];
+
+  auto keys_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, device_keys);
+  auto values_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, device_values);
+  BOOST_TEST(keys_host == sorted_keys, tt::per_element());
+  BOOST_TEST(values_host == permutation, tt::per_element());
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(sort_by_key, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  // The radix sorts take a number of passes that depends on the size of the
+  // keys and on their range, and leave the data in either buffer
+  for (int n : {1, 2, 10007})
+  {
+    std::vector<int> int_keys(n);
+    std::vector<unsigned long long> long_keys(n);
+    std::vector<float> float_keys(n);
+    for (int i = 0; i < n; ++i)
+    {
+      int const j = (i * 7919ll) % n;
+      int_keys[i] = j - n / 2;
+      long_keys[i] = (1ull << 40) + j * 104729ull;
+      float_keys[i] = .5f * (j - n / 2);
+    }
+    checkSortByKey<DeviceType>(int_keys);
+    checkSortByKey<DeviceType>(long_keys);
+    checkSortByKey<DeviceType>(float_keys);
+  }
+}
+
+struct NegatedKey
+{
+  KOKKOS_FUNCTION float operator()(float value) const { return -value; }
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(sort_results_per_predicate, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace space{};
+
+  // Segments of various lengths, including empty ones, with keys of both
+  // signs and values that are smaller than values of previous segments
+  std::vector<int> const offsets = {0, 4, 4, 5, 11, 11};
+  std::vector<float> values = {3.f,  -1.f, 2.5f, 0.f, 7.f, 1.f,
+                               -3.f, 8.f,  -0.5f, 2.f, -7.f};
+  auto offsets_view = ArborXTest::toView<DeviceType>(offsets);
+  auto values_view = ArborXTest::toView<DeviceType>(values);
+  ArborX::Experimental::sortResultsPerPredicate(space, offsets_view,
+                                                values_view, NegatedKey{});
+
+  // Decreasing values within each segment, the segments being left in place
+  for (int i = 0; i + 1 < (int)offsets.size(); ++i)
+    std::sort(values.begin() + offsets[i], values.begin() + offsets[i + 1],
+              std::greater<float>());
+  auto values_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values_view);
+  BOOST_TEST(values_host == values, tt::per_element());
+}
+
 namespace Test
 {
 using ArborXTest::toView;
@@ -299,3 +607,23 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(compute_offsets_in_sorted_view, DeviceType,
                                      (std::vector<int>{14, 5, 5, 5, 3, 3}),
                                      (std::vector<int>{0, 1, 4, 6}));
 }
+
+BOOST_AUTO_TEST_CASE(dispatch_dimension)
+{
+  using ArborX::Experimental::dispatchDimension;
+
+  int called = 0;
+  auto const f = [&](auto dim_c) {
+    static_assert(decltype(dim_c)::value > 1);
+    called = decltype(dim_c)::value;
+  };
+  BOOST_TEST(dispatchDimension<2, 3, 5>(3, f));
+  BOOST_TEST(called == 3);
+  BOOST_TEST(dispatchDimension<2, 3, 5>(5, f));
+  BOOST_TEST(called == 5);
+
+  called = 0;
+  BOOST_TEST(!dispatchDimension<2, 3, 5>(4, f));
+  BOOST_TEST(!dispatchDimension<2, 3, 5>(0, f));
+  BOOST_TEST(called == 0);
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_DBSCANVerification.hpp>
+#include <ArborX_DistributedDBSCAN.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <mpi.h>
+
+BOOST_AUTO_TEST_SUITE(DistributedDBSCAN)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(distributed_dbscan, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Point;
+  using ArborX::Details::verifyDBSCAN;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  ExecutionSpace space;
+
+  // Chains of points crossing the rank boundaries, with isolated points in
+  // between, so that clusters need to be merged across ranks
+  std::vector<Point> cloud;
+  for (int i = 0; i < 50 * comm_size; ++i)
+    cloud.push_back({{0.3f * i + (i % 17 == 0 ? 1.f : 0.f),
+                      (i % 3 == 0 ? 0.2f : 0.f), 0}});
+  int const n = cloud.size();
+
+  // Contiguous partitioning, so that the global indices of the points are
+  // their indices in the cloud
+  int const first = n / comm_size * comm_rank;
+  int const last = (comm_rank == comm_size - 1 ? n : first + n / comm_size);
+  auto const local_points = ArborXTest::toView<DeviceType, Point>(
+      std::vector<Point>(cloud.begin() + first, cloud.begin() + last));
+  auto const points = ArborXTest::toView<DeviceType, Point>(cloud);
+
+  std::vector<int> counts(comm_size);
+  std::vector<int> displs(comm_size);
+  for (int r = 0; r < comm_size; ++r)
+  {
+    displs[r] = n / comm_size * r;
+    counts[r] = (r == comm_size - 1 ? n - displs[r] : n / comm_size);
+  }
+
+  float const eps = 0.5;
+  for (int core_min_size : {2, 3, 4})
+  {
+    auto const local_labels =
+        ArborX::dbscan(comm, space, local_points, eps, core_min_size);
+    BOOST_TEST(local_labels.size() == local_points.size());
+
+    auto const local_labels_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, local_labels);
+    std::vector<long long> labels_host(n);
+    MPI_Allgatherv(local_labels_host.data(), last - first, MPI_LONG_LONG,
+                   labels_host.data(), counts.data(), displs.data(),
+                   MPI_LONG_LONG, comm);
+
+    auto const labels = ArborXTest::toView<DeviceType, int>(
+        std::vector<int>(labels_host.begin(), labels_host.end()));
+    BOOST_TEST(verifyDBSCAN(space, points, eps, core_min_size, labels));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
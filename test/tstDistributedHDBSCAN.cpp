@@ -0,0 +1,93 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_DistributedHDBSCAN.hpp>
+#include <ArborX_HDBSCAN.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <mpi.h>
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(DistributedHDBSCAN)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(distributed_hdbscan, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Point;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  ExecutionSpace space;
+
+  // The same random cloud on all ranks, sorted along x so that the contiguous
+  // partitioning is a spatial decomposition
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> uniform(0.f, 1.f);
+  std::vector<Point> cloud(100 * comm_size);
+  for (auto &point : cloud)
+    point = {{uniform(gen), uniform(gen), uniform(gen)}};
+  std::sort(cloud.begin(), cloud.end(), [](Point const &a, Point const &b) {
+    return a[0] < b[0];
+  });
+  int const n = cloud.size();
+
+  int const first = n / comm_size * comm_rank;
+  int const last = (comm_rank == comm_size - 1 ? n : first + n / comm_size);
+  auto const local_points = ArborXTest::toView<DeviceType, Point>(
+      std::vector<Point>(cloud.begin() + first, cloud.begin() + last));
+  auto const points = ArborXTest::toView<DeviceType, Point>(cloud);
+
+  for (int core_min_size : {1, 2, 5})
+  {
+    auto const dendrogram =
+        ArborX::Experimental::hdbscan(comm, space, local_points, core_min_size);
+    if (comm_rank != 0)
+    {
+      BOOST_TEST(dendrogram._parents.size() == 0);
+      continue;
+    }
+
+    auto const reference = ArborX::Experimental::hdbscan(
+        space, points, core_min_size,
+        ArborX::Experimental::DendrogramImplementation::UNION_FIND);
+    BOOST_TEST(dendrogram._parents.size() == reference._parents.size());
+
+    // The trees may differ in the presence of ties, but not their weights
+    auto heights = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, dendrogram._parent_heights);
+    auto reference_heights = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{}, reference._parent_heights);
+    std::vector<float> heights_vec(heights.data(),
+                                   heights.data() + heights.size());
+    std::vector<float> reference_heights_vec(
+        reference_heights.data(),
+        reference_heights.data() + reference_heights.size());
+    std::sort(heights_vec.begin(), heights_vec.end());
+    std::sort(reference_heights_vec.begin(), reference_heights_vec.end());
+    BOOST_TEST(heights_vec == reference_heights_vec,
+               tt::tolerance(1e-5f) << tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,168 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_DistributedNeighborList.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <mpi.h>
+
+BOOST_AUTO_TEST_SUITE(DistributedNeighborList)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(distributed_neighbor_list, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::PairIndexRank;
+  using ArborX::Point;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  ExecutionSpace space;
+
+  // A slightly perturbed line of points, partitioned contiguously, so that
+  // the neighbors of the points at the ends of each rank are on other ranks
+  int const n_per_rank = 20;
+  int const n = n_per_rank * comm_size;
+  std::vector<Point> cloud;
+  for (int i = 0; i < n; ++i)
+    cloud.push_back({{0.5f * i, (i % 3 == 0 ? 0.2f : 0.f), 0}});
+  int const first = n_per_rank * comm_rank;
+  auto const local_points = ArborXTest::toView<DeviceType, Point>(
+      std::vector<Point>(cloud.begin() + first,
+                         cloud.begin() + first + n_per_rank));
+
+  for (float radius : {0.f, 0.6f, 1.1f, 3.f})
+  {
+    Kokkos::View<int *, MemorySpace> offsets("Test::offsets", 0);
+    Kokkos::View<PairIndexRank *, MemorySpace> indices("Test::indices", 0);
+    ArborX::Experimental::findDistributedNeighborList(
+        comm, space, local_points, radius, offsets, indices);
+
+    auto const offsets_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets);
+    auto const indices_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices);
+    BOOST_TEST(offsets_host.size() == n_per_rank + 1);
+
+    for (int i = 0; i < n_per_rank; ++i)
+    {
+      auto const &point = cloud[first + i];
+      std::vector<PairIndexRank> expected;
+      for (int j = 0; j < n; ++j)
+      {
+        float const dx = cloud[j][0] - point[0];
+        float const dy = cloud[j][1] - point[1];
+        if (j != first + i && std::sqrt(dx * dx + dy * dy) <= radius)
+          expected.push_back({j % n_per_rank, j / n_per_rank});
+      }
+      std::vector<PairIndexRank> found(indices_host.data() + offsets_host(i),
+                                       indices_host.data() +
+                                           offsets_host(i + 1));
+      std::sort(expected.begin(), expected.end());
+      std::sort(found.begin(), found.end());
+      BOOST_TEST((found == expected), "neighbors of point "
+                                          << i << " on rank " << comm_rank
+                                          << " with radius " << radius);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(distributed_knn_graph, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::PairIndexRank;
+  using ArborX::Point;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  ExecutionSpace space;
+
+  // Same line of points as above, with fewer points per rank than the largest
+  // k, so that some neighbors are always on other ranks
+  int const n_per_rank = 10;
+  int const n = n_per_rank * comm_size;
+  std::vector<Point> cloud;
+  for (int i = 0; i < n; ++i)
+    cloud.push_back({{0.5f * i, (i % 3 == 0 ? 0.2f : 0.f), 0}});
+  int const first = n_per_rank * comm_rank;
+  auto const local_points = ArborXTest::toView<DeviceType, Point>(
+      std::vector<Point>(cloud.begin() + first,
+                         cloud.begin() + first + n_per_rank));
+
+  auto const dist = [&](int i, int j) {
+    float const dx = cloud[j][0] - cloud[i][0];
+    float const dy = cloud[j][1] - cloud[i][1];
+    return std::sqrt(dx * dx + dy * dy);
+  };
+
+  for (int k : {1, 3, 5, 12})
+  {
+    Kokkos::View<int *, MemorySpace> offsets("Test::offsets", 0);
+    Kokkos::View<PairIndexRank *, MemorySpace> indices("Test::indices", 0);
+    Kokkos::View<float *, MemorySpace> distances("Test::distances", 0);
+    ArborX::Experimental::findDistributedKNNGraph(
+        comm, space, local_points, k, offsets, indices, distances);
+
+    auto const offsets_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets);
+    auto const indices_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices);
+    auto const distances_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, distances);
+    BOOST_TEST(offsets_host.size() == n_per_rank + 1);
+
+    // The neighbors may differ with equidistant points, but not their
+    // distances
+    for (int i = 0; i < n_per_rank; ++i)
+    {
+      std::vector<float> expected;
+      for (int j = 0; j < n; ++j)
+        if (j != first + i)
+          expected.push_back(dist(first + i, j));
+      std::sort(expected.begin(), expected.end());
+      expected.resize(std::min(k, n - 1));
+
+      std::vector<float> found;
+      for (int m = offsets_host(i); m < offsets_host(i + 1); ++m)
+      {
+        auto const neighbor = indices_host(m);
+        int const j = neighbor.rank * n_per_rank + neighbor.index;
+        BOOST_TEST(j != first + i);
+        BOOST_TEST(distances_host(m) == dist(first + i, j),
+                   boost::test_tools::tolerance(1e-5f));
+        found.push_back(distances_host(m));
+      }
+      BOOST_TEST(std::is_sorted(found.begin(), found.end()));
+      BOOST_TEST(found == expected, boost::test_tools::tolerance(1e-5f)
+                                        << boost::test_tools::per_element());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
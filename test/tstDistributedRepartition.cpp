@@ -0,0 +1,77 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_DistributedRepartition.hpp>
+#include <ArborX_DistributedTree.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <mpi.h>
+
+BOOST_AUTO_TEST_SUITE(DistributedRepartition)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(repartition, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Point;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  ExecutionSpace space;
+
+  // Interleaved points on a line, so that the bounding boxes of all the ranks
+  // intersect
+  int const n = 100;
+  std::vector<Point> points_host;
+  for (int i = 0; i < n; ++i)
+    points_host.push_back({{(float)(i * comm_size + comm_rank), 0.f, 0.f}});
+  auto const points = ArborXTest::toView<DeviceType, Point>(points_host);
+
+  ArborX::DistributedTree<MemorySpace> tree(comm, space, points);
+  BOOST_TEST(tree.overlap(space) == (float)(comm_size - 1));
+
+  auto const repartitioning =
+      ArborX::Experimental::repartition(comm, space, points);
+  int const num_local = repartitioning._primitives.size();
+  BOOST_TEST((int)repartitioning._origins.size() == num_local);
+  int num_global;
+  MPI_Allreduce(&num_local, &num_global, 1, MPI_INT, MPI_SUM, comm);
+  BOOST_TEST(num_global == n * comm_size);
+
+  // Each primitive comes along with where it was
+  auto const primitives_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{}, repartitioning._primitives);
+  auto const origins_host = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{}, repartitioning._origins);
+  for (int k = 0; k < num_local; ++k)
+  {
+    int const i = origins_host(k).index;
+    int const r = origins_host(k).rank;
+    BOOST_TEST(primitives_host(k)[0] == (float)(i * comm_size + r));
+  }
+
+  // Along the line, the curve orders the points by x, and the ranks own
+  // disjoint segments
+  ArborX::DistributedTree<MemorySpace> repartitioned_tree(
+      comm, space, repartitioning._primitives);
+  BOOST_TEST(repartitioned_tree.overlap(space) == 0.f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -14,6 +14,8 @@
 #include "ArborX_BoostRTreeHelpers.hpp"
 #include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
 #include <ArborX_DistributedTree.hpp>
+#include <ArborX_DistributedValueTree.hpp>
+#include <ArborX_Ray.hpp>
 
 #include <boost/test/unit_test.hpp>
 
@@ -866,3 +868,517 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(distributed_ray, DeviceType, ARBORX_DEVICE_TYPES)
       make_reference_solution<PairIndexRank>({{0, comm_rank}, {0, 0}},
                                              {0, 1, 2}));
 }
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(update_top_tree, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using Tree = ArborX::DistributedTree<typename DeviceType::memory_space>;
+  using ExecutionSpace = typename DeviceType::execution_space;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = 4;
+  Kokkos::View<ArborX::Point *, DeviceType> points("Testing::points", n);
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(0, n), KOKKOS_LAMBDA(int i) {
+        points(i) = {{(double)i / n + comm_rank, 0., 0.}};
+      });
+
+  Tree tree(comm, ExecutionSpace{}, points);
+
+  // Move the points of rank 0 past the last rank, and leave the other ranks
+  // untouched
+  if (comm_rank == 0)
+  {
+    Kokkos::parallel_for(
+        Kokkos::RangePolicy<ExecutionSpace>(0, n), KOKKOS_LAMBDA(int i) {
+          points(i) = {{(double)i / n + comm_size, 0., 0.}};
+        });
+    tree.refit(ExecutionSpace{}, points);
+  }
+  else
+  {
+    tree.update(ExecutionSpace{});
+  }
+
+  BOOST_TEST((int)tree.size() == n * comm_size);
+  BOOST_TEST(ArborX::Details::equals(
+      tree.bounds(),
+      {{{1., 0., 0.}}, {{comm_size + (double)(n - 1) / n, 0., 0.}}}));
+
+  auto const moved_queries = makeIntersectsBoxQueries<DeviceType>({
+      {{{(double)comm_size, 0., 0.}}, {{comm_size + .9, 0., 0.}}},
+  });
+  ARBORX_TEST_QUERY_TREE(
+      ExecutionSpace{}, tree, moved_queries,
+      make_reference_solution<PairIndexRank>({{0, 0}, {1, 0}, {2, 0}, {3, 0}},
+                                             {0, 4}));
+
+  // Rebuild rank 0 with a single point back at the origin
+  if (comm_rank == 0)
+  {
+    Kokkos::View<ArborX::Point *, DeviceType> point("Testing::point", 1);
+    Kokkos::deep_copy(point, ArborX::Point{{0., 0., 0.}});
+    tree.update(ExecutionSpace{}, point);
+  }
+  else
+  {
+    tree.update(ExecutionSpace{});
+  }
+
+  BOOST_TEST((int)tree.size() == n * (comm_size - 1) + 1);
+  BOOST_TEST(ArborX::Details::equals(
+      tree.bounds(), {{{0., 0., 0.}},
+                      {{(comm_size > 1 ? comm_size - 1 + (double)(n - 1) / n
+                                       : 0.),
+                        0., 0.}}}));
+
+  ARBORX_TEST_QUERY_TREE(
+      ExecutionSpace{}, tree, moved_queries,
+      make_reference_solution<PairIndexRank>({}, {0, 0}));
+  ARBORX_TEST_QUERY_TREE(ExecutionSpace{}, tree,
+                         makeIntersectsBoxQueries<DeviceType>({
+                             {{{-.5, 0., 0.}}, {{.5, 0., 0.}}},
+                         }),
+                         make_reference_solution<PairIndexRank>({{0, 0}},
+                                                                {0, 1}));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(single_round_nearest, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  // Only the even ranks hold points, so that the queries on the odd ranks
+  // have no local neighbors and need the second exchange
+  int const n = 100;
+  auto const cloud = ArborXTest::make_random_cloud<ArborX::Point>(
+      ExecutionSpace{}, (comm_rank % 2 == 0 ? n : 0), 10.f, 10.f, 10.f,
+      comm_rank);
+  ArborX::DistributedTree<MemorySpace> tree(comm, ExecutionSpace{}, cloud);
+
+  int const n_queries = 20;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(
+      ExecutionSpace{}, n_queries, 10.f, 10.f, 10.f, 1234 + comm_rank);
+  Kokkos::View<ArborX::Nearest<ArborX::Point> *, DeviceType> queries(
+      "Testing::queries", n_queries);
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(0, n_queries), KOKKOS_LAMBDA(int i) {
+        queries(i) = ArborX::nearest(points(i), 1 + i % 10);
+      });
+
+  auto query_with_strategy =
+      [&](ArborX::Experimental::DistributedNearestStrategy strategy) {
+        Kokkos::View<PairIndexRank *, DeviceType> values("Testing::values", 0);
+        Kokkos::View<int *, DeviceType> offsets("Testing::offsets", 0);
+        tree.query(ExecutionSpace{}, queries, values, offsets, strategy);
+        return make_compressed_storage(
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values));
+      };
+
+  using ArborX::Experimental::DistributedNearestStrategy;
+  BOOST_TEST(query_with_strategy(DistributedNearestStrategy::SINGLE_ROUND) ==
+                 query_with_strategy(DistributedNearestStrategy::TWO_ROUNDS),
+             tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(nearest_callback, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = 50;
+  auto const cloud = ArborXTest::make_random_cloud<ArborX::Point>(
+      ExecutionSpace{}, n, 10.f, 10.f, 10.f, comm_rank);
+  ArborX::DistributedTree<MemorySpace> tree(comm, ExecutionSpace{}, cloud);
+
+  int const n_queries = 20;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(
+      ExecutionSpace{}, n_queries, 10.f, 10.f, 10.f, 1234 + comm_rank);
+  Kokkos::View<ArborX::Nearest<ArborX::Point> *, DeviceType> queries(
+      "Testing::queries", n_queries);
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(0, n_queries), KOKKOS_LAMBDA(int i) {
+        queries(i) = ArborX::nearest(points(i), 1 + i % 10);
+      });
+
+  // The callback is called on the rank owning the neighbor, so the rank it
+  // outputs is that of the neighbor, as in the results without callback
+  using ArborX::Experimental::DistributedNearestStrategy;
+  for (auto strategy : {DistributedNearestStrategy::TWO_ROUNDS,
+                        DistributedNearestStrategy::SINGLE_ROUND})
+  {
+    Kokkos::View<PairIndexRank *, DeviceType> values("Testing::values", 0);
+    Kokkos::View<int *, DeviceType> offsets("Testing::offsets", 0);
+    tree.query(ExecutionSpace{}, queries,
+               ArborX::Details::DefaultCallbackWithRank{comm_rank}, values,
+               offsets, strategy);
+
+    ARBORX_TEST_QUERY_TREE(
+        ExecutionSpace{}, tree, queries,
+        make_compressed_storage(
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(balance_replicas, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using Tree = ArborX::DistributedTree<typename DeviceType::memory_space>;
+  using ExecutionSpace = typename DeviceType::execution_space;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = 4;
+  Kokkos::View<ArborX::Point *, DeviceType> points("Testing::points", n);
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(0, n), KOKKOS_LAMBDA(int i) {
+        points(i) = {{(double)i / n + comm_rank, 0., 0.}};
+      });
+
+  Tree tree(comm, ExecutionSpace{}, points);
+
+  // All the processes query the points of rank 0
+  ArborX::Box const box{{{0., 0., 0.}}, {{.9, 0., 0.}}};
+  auto const queries = makeIntersectsBoxQueries<DeviceType>({box, box, box});
+  auto const reference = make_reference_solution<PairIndexRank>(
+      {{0, 0}, {1, 0}, {2, 0}, {3, 0}, {0, 0}, {1, 0}, {2, 0}, {3, 0}, {0, 0},
+       {1, 0}, {2, 0}, {3, 0}},
+      {0, 4, 8, 12});
+  std::vector<long long> expected_counts(comm_size, 0);
+  expected_counts[0] = 3 * comm_size;
+
+  ARBORX_TEST_QUERY_TREE(ExecutionSpace{}, tree, queries, reference);
+  BOOST_TEST(tree.queryCounts() == expected_counts, tt::per_element());
+
+  // With more than one process, rank 0 is hit by more than 1.5 times the
+  // average and gets replicated
+  tree.balance(ExecutionSpace{}, 1.5f);
+  BOOST_TEST(tree.queryCounts() == std::vector<long long>(comm_size, 0),
+             tt::per_element());
+  for (int repeat = 0; repeat < 2; ++repeat)
+    ARBORX_TEST_QUERY_TREE(ExecutionSpace{}, tree, queries, reference);
+  expected_counts[0] *= 2;
+  BOOST_TEST(tree.queryCounts() == expected_counts, tt::per_element());
+
+  // The replicas are dropped along with the old trees
+  tree.update(ExecutionSpace{}, points);
+  ARBORX_TEST_QUERY_TREE(ExecutionSpace{}, tree, queries, reference);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ordered_ray_queries, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Experimental::Ray;
+  using ArborX::Experimental::Vector;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  // Unit cubes along the x axis, the first n on rank 0, the next n on rank 1,
+  // and so on
+  int const n = 2;
+  std::vector<ArborX::Box> boxes;
+  for (int i = 0; i < n; ++i)
+  {
+    float const x = 2.f * (comm_rank * n + i);
+    boxes.push_back({{{x, 0., 0.}}, {{x + 1.f, 1., 1.}}});
+  }
+  auto const tree = makeDistributedTree<DeviceType>(comm, boxes);
+
+  // Rays along the x axis, shot from beyond either end
+  float const length = 2.f * comm_size * n;
+  Ray const forward{ArborX::Point{-1.f, .5f, .5f}, Vector{1.f, 0.f, 0.f}};
+  Ray const backward{ArborX::Point{length + 1.f, .5f, .5f},
+                     Vector{-1.f, 0.f, 0.f}};
+
+  auto const query = [&](int k) {
+    using ArborX::Experimental::ordered_intersects;
+    using Predicate = decltype(ordered_intersects(forward, k));
+    Kokkos::View<Predicate *, DeviceType> queries("Testing::queries", 2);
+    auto queries_host = Kokkos::create_mirror_view(queries);
+    queries_host(0) = ordered_intersects(forward, k);
+    queries_host(1) = ordered_intersects(backward, k);
+    Kokkos::deep_copy(queries, queries_host);
+
+    Kokkos::View<PairIndexRank *, DeviceType> values("Testing::values", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    tree.query(ExecutionSpace{}, queries, values, offset);
+
+    auto const values_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values);
+    auto const offset_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset);
+    std::vector<std::vector<int>> hits(2);
+    for (int q = 0; q < 2; ++q)
+      for (int j = offset_host(q); j < offset_host(q + 1); ++j)
+        hits[q].push_back(values_host(j).rank * n + values_host(j).index);
+    return hits;
+  };
+
+  // The hits are in the order in which the rays go through the cubes
+  int const n_cubes = comm_size * n;
+  for (int k : {1, 3, n_cubes, n_cubes + 1})
+  {
+    auto const hits = query(k);
+    std::vector<int> forward_hits;
+    std::vector<int> backward_hits;
+    for (int i = 0; i < std::min(k, n_cubes); ++i)
+    {
+      forward_hits.push_back(i);
+      backward_hits.push_back(n_cubes - 1 - i);
+    }
+    BOOST_TEST(hits[0] == forward_hits, tt::per_element());
+    BOOST_TEST(hits[1] == backward_hits, tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(async_spatial_queries, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using Tree = ArborX::DistributedTree<typename DeviceType::memory_space>;
+  using ExecutionSpace = typename DeviceType::execution_space;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = 4;
+  Kokkos::View<ArborX::Point *, DeviceType> points("Testing::points", n);
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(0, n), KOKKOS_LAMBDA(int i) {
+        points(i) = {{(float)i / n + comm_rank, 0., 0.}};
+      });
+
+  Tree tree(comm, ExecutionSpace{}, points);
+
+  // Spheres around the first point of each rank also catch the last point of
+  // the previous rank, and the last sphere does not catch anything
+  std::vector<std::pair<ArborX::Point, float>> spheres;
+  for (int r = 0; r < comm_size; ++r)
+    spheres.push_back({{{(float)r, 0., 0.}}, 0.3f});
+  spheres.push_back({{{(float)comm_size + 1, 0., 0.}}, 0.3f});
+  auto const queries = makeIntersectsSphereQueries<DeviceType>(spheres);
+
+  Kokkos::View<PairIndexRank *, DeviceType> values("Testing::values", 0);
+  Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+  tree.query(ExecutionSpace{}, queries, values, offset);
+  auto const reference = make_compressed_storage(
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset),
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values));
+
+  auto request = tree.queryAsync(ExecutionSpace{}, queries);
+  while (!request.test())
+    ;
+  BOOST_TEST(make_compressed_storage(Kokkos::create_mirror_view_and_copy(
+                                         Kokkos::HostSpace{},
+                                         request.offsets()),
+                                     Kokkos::create_mirror_view_and_copy(
+                                         Kokkos::HostSpace{},
+                                         request.values())) == reference,
+             tt::per_element());
+
+  auto other_request = tree.queryAsync(ExecutionSpace{}, queries);
+  other_request.wait();
+  BOOST_TEST(make_compressed_storage(Kokkos::create_mirror_view_and_copy(
+                                         Kokkos::HostSpace{},
+                                         other_request.offsets()),
+                                     Kokkos::create_mirror_view_and_copy(
+                                         Kokkos::HostSpace{},
+                                         other_request.values())) == reference,
+             tt::per_element());
+
+  // Requests in flight together, with different queries, completed in the
+  // reverse order
+  std::vector<std::pair<ArborX::Point, float>> large_spheres;
+  for (auto const &[center, radius] : spheres)
+    large_spheres.push_back({center, 2 * radius});
+  auto const large_queries =
+      makeIntersectsSphereQueries<DeviceType>(large_spheres);
+  tree.query(ExecutionSpace{}, large_queries, values, offset);
+  auto const large_reference = make_compressed_storage(
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset),
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values));
+  auto first_request = tree.queryAsync(ExecutionSpace{}, queries);
+  auto second_request = tree.queryAsync(ExecutionSpace{}, large_queries);
+  second_request.wait();
+  first_request.wait();
+  BOOST_TEST(make_compressed_storage(Kokkos::create_mirror_view_and_copy(
+                                         Kokkos::HostSpace{},
+                                         first_request.offsets()),
+                                     Kokkos::create_mirror_view_and_copy(
+                                         Kokkos::HostSpace{},
+                                         first_request.values())) == reference,
+             tt::per_element());
+  BOOST_TEST(make_compressed_storage(Kokkos::create_mirror_view_and_copy(
+                                         Kokkos::HostSpace{},
+                                         second_request.offsets()),
+                                     Kokkos::create_mirror_view_and_copy(
+                                         Kokkos::HostSpace{},
+                                         second_request.values())) ==
+                 large_reference,
+             tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(bounds_refinement, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using Tree = ArborX::DistributedTree<typename DeviceType::memory_space>;
+  using ExecutionSpace = typename DeviceType::execution_space;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  // Each rank holds two points far apart
+  Tree tree(comm, ExecutionSpace{},
+            ArborXTest::toView<DeviceType>(std::vector<ArborX::Point>{
+                {{(float)comm_rank, 0., 0.}},
+                {{(float)comm_rank, 10., 0.}}}));
+
+  // Boxes in the gap of each rank, and around the first point of rank 0
+  std::vector<ArborX::Box> boxes;
+  for (int r = 0; r < comm_size; ++r)
+    boxes.push_back(
+        {{{(float)r - .1f, 4., -.1f}}, {{(float)r + .1f, 6., .1f}}});
+  boxes.push_back({{{-.1f, -.1f, -.1f}}, {{.1f, .1f, .1f}}});
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(boxes);
+  std::vector<int> offsets(comm_size + 2, 0);
+  offsets.back() = 1;
+  auto const reference =
+      make_reference_solution<PairIndexRank>({{0, 0}}, offsets);
+
+  ARBORX_TEST_QUERY_TREE(ExecutionSpace{}, tree, queries, reference);
+  std::vector<long long> expected_counts(comm_size, comm_size);
+  expected_counts[0] += comm_size;
+  BOOST_TEST(tree.queryCounts() == expected_counts, tt::per_element());
+
+  // Bounded by the boxes of their points, the ranks are no longer hit by the
+  // queries in their gap
+  tree.setBoundsRefinement(ExecutionSpace{}, 2);
+  ARBORX_TEST_QUERY_TREE(ExecutionSpace{}, tree, queries, reference);
+  expected_counts[0] += comm_size;
+  BOOST_TEST(tree.queryCounts() == expected_counts, tt::per_element());
+
+  // The boxes follow the points when the tree is updated
+  tree.update(ExecutionSpace{},
+              ArborXTest::toView<DeviceType>(std::vector<ArborX::Point>{
+                  {{(float)comm_rank, 0., 0.}}, {{(float)comm_rank, 5., 0.}}}));
+  std::vector<PairIndexRank> values;
+  for (int r = 0; r < comm_size; ++r)
+  {
+    values.push_back({1, r});
+    offsets[r + 1] = r + 1;
+  }
+  values.push_back({0, 0});
+  offsets.back() = comm_size + 1;
+  ARBORX_TEST_QUERY_TREE(ExecutionSpace{}, tree, queries,
+                         make_reference_solution(values, offsets));
+}
+
+struct Tracer
+{
+  ArborX::Point position;
+  int id;
+};
+
+struct TracerPosition
+{
+  KOKKOS_FUNCTION ArborX::Point const &operator()(Tracer const &tracer) const
+  {
+    return tracer.position;
+  }
+};
+
+struct TracerId
+{
+  KOKKOS_FUNCTION int operator()(Tracer const &tracer) const
+  {
+    return tracer.id;
+  }
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(distributed_values, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::Experimental::DistributedValueTree<MemorySpace, Tracer,
+                                                          TracerPosition>;
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int comm_rank;
+  MPI_Comm_rank(comm, &comm_rank);
+  int comm_size;
+  MPI_Comm_size(comm, &comm_size);
+
+  int const n = 4;
+  Kokkos::View<Tracer *, DeviceType> tracers("Testing::tracers", n);
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(0, n), KOKKOS_LAMBDA(int i) {
+        tracers(i) = {{{(float)i / n + comm_rank, 0., 0.}}, 10 * comm_rank + i};
+      });
+
+  Tree tree(comm, ExecutionSpace{}, tracers);
+  BOOST_TEST(tree.size() == n * comm_size);
+
+  // The ids of the tracers come back instead of their indices and ranks
+  ArborX::Box const box{{{0., 0., 0.}}, {{.6, 0., 0.}}};
+  ARBORX_TEST_QUERY_TREE_CALLBACK(
+      ExecutionSpace{}, tree, makeIntersectsBoxQueries<DeviceType>({box}),
+      TracerId{}, make_reference_solution<int>({0, 1, 2}, {0, 3}));
+
+  std::vector<std::pair<ArborX::Point, int>> points;
+  std::vector<int> ids;
+  std::vector<int> offsets = {0};
+  for (int r = 0; r < comm_size; ++r)
+  {
+    points.push_back({{{(float)r + .1f, 0., 0.}}, 1});
+    ids.push_back(10 * r);
+    offsets.push_back(r + 1);
+  }
+  ARBORX_TEST_QUERY_TREE_CALLBACK(
+      ExecutionSpace{}, tree, makeNearestQueries<DeviceType>(points),
+      TracerId{}, make_reference_solution(ids, offsets));
+
+  // Whole values are sent back without a projection
+  Kokkos::View<Tracer *, DeviceType> values("Testing::values", 0);
+  Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+  tree.query(ExecutionSpace{}, makeIntersectsBoxQueries<DeviceType>({box}),
+             values, offset);
+  auto const values_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values);
+  BOOST_TEST(values_host.size() == 3);
+  for (int i = 0; i < (int)values_host.size(); ++i)
+    BOOST_TEST(values_host(i).position[0] == (float)values_host(i).id / n);
+}
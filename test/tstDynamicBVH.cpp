@@ -0,0 +1,137 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_DynamicBVH.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(DynamicBVH)
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(insert_remove_query, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree =
+      ArborX::Experimental::DynamicBoundingVolumeHierarchy<MemorySpace>;
+
+  ExecutionSpace space;
+
+  Tree tree;
+  BOOST_TEST(tree.empty());
+  BOOST_TEST(tree.numberOfTrees() == 0);
+
+  std::vector<ArborX::Box> primitives;
+  std::vector<bool> removed;
+  // Compare against brute force search over the live primitives
+  auto const check = [&]() {
+    std::vector<ArborX::Box> query_boxes;
+    for (int i = 0; i < (int)primitives.size(); i += 3)
+    {
+      auto box = primitives[i];
+      ArborX::Details::expand(box, primitives[(i + 1) % primitives.size()]);
+      query_boxes.push_back(box);
+    }
+    Kokkos::View<decltype(ArborX::intersects(ArborX::Box{})) *, DeviceType>
+        queries("Testing::intersecting_with_box_predicates",
+                query_boxes.size());
+    auto queries_host = Kokkos::create_mirror_view(queries);
+    for (int q = 0; q < (int)query_boxes.size(); ++q)
+      queries_host(q) = ArborX::intersects(query_boxes[q]);
+    Kokkos::deep_copy(queries, queries_host);
+
+    std::vector<int> values;
+    std::vector<int> offsets = {0};
+    for (auto const &query_box : query_boxes)
+    {
+      for (int j = 0; j < (int)primitives.size(); ++j)
+        if (!removed[j] &&
+            ArborX::Details::intersects(query_box, primitives[j]))
+          values.push_back(j);
+      offsets.push_back(values.size());
+    }
+    BOOST_TEST(query(space, tree, queries) ==
+                   make_reference_solution(values, offsets),
+               tt::per_element());
+  };
+
+  for (int n : {10, 1, 5, 50, 3, 100, 7, 20})
+  {
+    auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+    BOOST_TEST(tree.insert(space, boxes) == primitives.size());
+
+    auto const boxes_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+    primitives.insert(primitives.end(), boxes_host.data(),
+                      boxes_host.data() + n);
+    removed.resize(primitives.size(), false);
+
+    // Each tree is more than twice as large as the following one
+    BOOST_TEST(tree.size() == primitives.size());
+    BOOST_TEST(tree.numberOfTrees() <=
+               1 + (int)std::log2(primitives.size()));
+    check();
+  }
+
+  // Removing a few primitives leaves them in the trees
+  std::vector<int> ids;
+  for (int i = 0; i < (int)primitives.size(); i += 4)
+  {
+    ids.push_back(i);
+    removed[i] = true;
+  }
+  int const num_trees = tree.numberOfTrees();
+  tree.remove(space, ArborXTest::toView<DeviceType>(ids, "Testing::ids"));
+  BOOST_TEST(tree.size() == primitives.size() - ids.size());
+  BOOST_TEST(tree.numberOfTrees() == num_trees);
+  check();
+
+  // Removing them again has no effect
+  tree.remove(space, ArborXTest::toView<DeviceType>(ids, "Testing::ids"));
+  BOOST_TEST(tree.size() == primitives.size() - ids.size());
+
+  // Removing most of them rebuilds a single tree
+  ids.clear();
+  for (int i = 0; i < (int)primitives.size(); ++i)
+    if (i % 5 != 0 && !removed[i])
+    {
+      ids.push_back(i);
+      removed[i] = true;
+    }
+  tree.remove(space, ArborXTest::toView<DeviceType>(ids, "Testing::ids"));
+  BOOST_TEST(tree.numberOfTrees() == 1);
+  check();
+
+  // Removing everything leaves no tree
+  ids.clear();
+  for (int i = 0; i < (int)primitives.size(); ++i)
+    if (!removed[i])
+    {
+      ids.push_back(i);
+      removed[i] = true;
+    }
+  tree.remove(space, ArborXTest::toView<DeviceType>(ids, "Testing::ids"));
+  BOOST_TEST(tree.empty());
+  BOOST_TEST(tree.numberOfTrees() == 0);
+  check();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
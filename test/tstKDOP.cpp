@@ -36,6 +36,29 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(conversion_to_box, KDOP_t, KDOP_types)
   BOOST_TEST(equals((Box)x, Box{{0, 0, 0}, {1, 1, 1}}));
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(expand_box, KDOP_t, KDOP_types)
+{
+  // expanding with a box is the same as expanding with its corners
+  Box const box{{-1, 2, 0.5}, {3, 2.5, 4}};
+  KDOP_t x;
+  x += box;
+  KDOP_t y;
+  for (int i = 0; i < 8; ++i)
+    y += Point{(i & 1) ? box.maxCorner()[0] : box.minCorner()[0],
+               (i & 2) ? box.maxCorner()[1] : box.minCorner()[1],
+               (i & 4) ? box.maxCorner()[2] : box.minCorner()[2]};
+  for (int i = 0; i < KDOP_t::n_directions; ++i)
+  {
+    BOOST_TEST(x._min_values[i] == y._min_values[i]);
+    BOOST_TEST(x._max_values[i] == y._max_values[i]);
+  }
+
+  // expanding with an empty box does nothing
+  KDOP_t z;
+  z += Box{};
+  BOOST_TEST(!intersects(z, z));
+}
+
 BOOST_AUTO_TEST_CASE_TEMPLATE(intersects_KDOP, KDOP_t, KDOP_types)
 {
   KDOP_t x;
@@ -11,10 +11,14 @@
 
 #include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
 #include <ArborX_LinearBVH.hpp>
+#include <ArborX_MemoryUsage.hpp>
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <regex>
+#include <string>
+#include <vector>
 
 #include "Search_UnitTestHelpers.hpp"
 
@@ -237,4 +241,85 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(regions_prefixed, DeviceType, ARBORX_DEVICE_TYPES)
   Kokkos::Tools::Experimental::set_push_region_callback(nullptr);
 }
 
+namespace
+{
+std::vector<std::string> arborx_test_events;
+
+void arborx_test_mark_event(char const *label)
+{
+  arborx_test_events.push_back(label);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(query_events, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using Tree = ArborX::BVH<typename DeviceType::memory_space>;
+  using ExecutionSpace = typename DeviceType::execution_space;
+
+  auto tree = make<Tree>(ExecutionSpace{}, {
+                                               {{{0, 0, 0}}, {{1, 1, 1}}},
+                                               {{{0, 0, 0}}, {{1, 1, 1}}},
+                                           });
+
+  arborx_test_events.clear();
+  Kokkos::Tools::Experimental::set_profile_event_callback(
+      arborx_test_mark_event);
+
+  // Without preallocated storage, the results are stored in a second pass
+  query(ExecutionSpace{}, tree,
+        makeIntersectsBoxQueries<DeviceType>({
+            {{{0, 0, 0}}, {{1, 1, 1}}},
+            {{{0, 0, 0}}, {{1, 1, 1}}},
+        }));
+
+  Kokkos::Tools::Experimental::set_profile_event_callback(nullptr);
+
+  auto const marked = [](std::string const &event) {
+    return std::find(arborx_test_events.begin(), arborx_test_events.end(),
+                     event) != arborx_test_events.end();
+  };
+  std::string const prefix = "ArborX::CrsGraphWrapper::query::spatial::";
+  BOOST_TEST(marked(prefix + "predicates=2"));
+  BOOST_TEST(marked(prefix + "results=4"));
+  BOOST_TEST((marked(prefix + "sorted_predicates=true") ||
+              marked(prefix + "sorted_predicates=false")));
+  BOOST_TEST(marked("ArborX::CrsGraphWrapper::two_pass::buffer_capacity=0"));
+  BOOST_TEST(marked("ArborX::CrsGraphWrapper::two_pass::second_pass=true"));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(memory_usage, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Experimental::AllocationTracker;
+
+  std::vector<ArborX::Box> const boxes = {
+      {{{0, 0, 0}}, {{1, 1, 1}}},
+      {{{2, 2, 2}}, {{3, 3, 3}}},
+  };
+
+  {
+    AllocationTracker tracker;
+    auto const tree = make<Tree>(ExecutionSpace{}, boxes);
+    auto const estimate = ArborX::Experimental::estimateConstructionMemory<
+        ArborX::Details::PairIndexVolume<ArborX::Box>>(boxes.size());
+    // Only the nodes of the hierarchy are still allocated
+    BOOST_TEST(tracker.current() == estimate.output);
+    BOOST_TEST(tracker.peak() > tracker.current());
+  }
+
+  auto const tree = make<Tree>(ExecutionSpace{}, boxes);
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(boxes);
+  Kokkos::View<int *, DeviceType> values("Testing::values", 0);
+  Kokkos::View<int *, DeviceType> offsets("Testing::offsets", 0);
+
+  // Every predicate has exactly one result
+  auto const estimate =
+      ArborX::Experimental::estimateQueryMemory(queries, {}, 1);
+  AllocationTracker tracker("Testing::");
+  ArborX::query(tree, ExecutionSpace{}, queries, values, offsets);
+  BOOST_TEST(tracker.current() == estimate.output);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,729 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_LinearBVH.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(ConstructionPolicy)
+
+namespace tt = boost::test_tools;
+
+using Hierarchy = ArborX::Experimental::ConstructionPolicy::Hierarchy;
+
+template <typename DeviceType>
+auto makePoints(std::vector<ArborX::Point> const &p)
+{
+  int const n = p.size();
+  Kokkos::View<ArborX::Point *, DeviceType> points("Testing::points", n);
+  auto points_host = Kokkos::create_mirror_view(points);
+  for (int i = 0; i < n; ++i)
+    points_host(i) = p[i];
+  Kokkos::deep_copy(points, points_host);
+  return points;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ploc_random_cloud, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto const boxes =
+      ArborXTest::make_random_cloud<ArborX::Box>(space, n, 10.f, 10.f, 10.f);
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+  Tree linear_bvh(space, boxes);
+  for (int search_radius : {1, 4, 16})
+  {
+    Tree ploc_bvh(space, boxes,
+                  ArborX::Experimental::ConstructionPolicy()
+                      .setHierarchy(Hierarchy::PLOC)
+                      .setSearchRadius(search_radius));
+    BOOST_TEST(ploc_bvh.size() == n);
+    BOOST_TEST(ArborX::Details::equals(
+        static_cast<ArborX::Box>(ploc_bvh.bounds()),
+        static_cast<ArborX::Box>(linear_bvh.bounds())));
+
+    std::vector<ArborX::Box> query_boxes;
+    std::vector<std::pair<ArborX::Point, int>> query_points;
+    std::vector<std::pair<ArborX::Point, float>> query_spheres;
+    for (int i = 0; i < n; i += 7)
+    {
+      auto box = boxes_host(i);
+      ArborX::Details::expand(box, boxes_host((i + 1) % n));
+      query_boxes.push_back(box);
+      query_points.push_back({box.minCorner(), 5});
+      query_spheres.push_back({box.minCorner(), 4.f});
+    }
+    auto const spatial_queries =
+        makeIntersectsBoxQueries<DeviceType>(query_boxes);
+    BOOST_TEST(query(space, ploc_bvh, spatial_queries) ==
+                   query(space, linear_bvh, spatial_queries),
+               tt::per_element());
+    // Large spheres contain whole subtrees, whose leaves are reported without
+    // being tested
+    auto const sphere_queries =
+        makeIntersectsSphereQueries<DeviceType>(query_spheres);
+    BOOST_TEST(query(space, ploc_bvh, sphere_queries) ==
+                   query(space, linear_bvh, sphere_queries),
+               tt::per_element());
+    auto const nearest_queries = makeNearestQueries<DeviceType>(query_points);
+    BOOST_TEST(query(space, ploc_bvh, nearest_queries) ==
+                   query(space, linear_bvh, nearest_queries),
+               tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ploc_degenerate, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  auto const policy =
+      ArborX::Experimental::ConstructionPolicy().setHierarchy(Hierarchy::PLOC);
+
+  Tree empty_bvh(space, makePoints<DeviceType>({}), policy);
+  BOOST_TEST(empty_bvh.empty());
+
+  Tree single_bvh(space, makePoints<DeviceType>({{{1., 2., 3.}}}), policy);
+  BOOST_TEST(single_bvh.size() == 1);
+  ARBORX_TEST_QUERY_TREE(space, single_bvh,
+                         makeNearestQueries<DeviceType>({{{{0., 0., 0.}}, 1}}),
+                         make_reference_solution<int>({0}, {0, 1}));
+
+  Tree pair_bvh(space, makePoints<DeviceType>({{{0., 0., 0.}}, {{1., 1., 1.}}}),
+                policy);
+  ARBORX_TEST_QUERY_TREE(space, pair_bvh,
+                         makeIntersectsBoxQueries<DeviceType>({
+                             {{{-1., -1., -1.}}, {{.5, .5, .5}}},
+                             {{{.5, .5, .5}}, {{2., 2., 2.}}},
+                             {{{-1., -1., -1.}}, {{2., 2., 2.}}},
+                         }),
+                         make_reference_solution<int>({0, 1, 0, 1},
+                                                      {0, 1, 2, 4}));
+
+  // All primitives at the same location
+  std::vector<ArborX::Point> duplicates(33, {{1., 1., 1.}});
+  Tree duplicates_bvh(space, makePoints<DeviceType>(duplicates), policy);
+  auto const duplicates_results =
+      query(space, duplicates_bvh,
+            makeIntersectsBoxQueries<DeviceType>({
+                {{{0., 0., 0.}}, {{2., 2., 2.}}},
+                {{{2., 2., 2.}}, {{3., 3., 3.}}},
+            }));
+  std::vector<int> all(33);
+  for (int i = 0; i < 33; ++i)
+    all[i] = i;
+  BOOST_TEST(duplicates_results ==
+                 make_reference_solution<int>(all, {0, 33, 33}),
+             tt::per_element());
+
+  // Collinear points
+  std::vector<ArborX::Point> collinear;
+  for (int i = 0; i < 50; ++i)
+    collinear.push_back({{(float)i, 0., 0.}});
+  Tree collinear_bvh(space, makePoints<DeviceType>(collinear), policy);
+  ARBORX_TEST_QUERY_TREE(
+      space, collinear_bvh,
+      makeNearestQueries<DeviceType>({
+          {{{10.1, 0., 0.}}, 2},
+          {{{-5., 0., 0.}}, 1},
+      }),
+      make_reference_solution<int>({10, 11, 0}, {0, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(refine_duplicate_codes, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  // A dense cluster much smaller than a cell of the space-filling curve over
+  // the scene, and a few identical points
+  float const h = 1e-5;
+  std::vector<ArborX::Point> cloud{{{0., 0., 0.}}, {{1000., 1000., 1000.}}};
+  for (int i = 0; i < 10; ++i)
+    for (int j = 0; j < 10; ++j)
+      for (int k = 0; k < 10; ++k)
+        cloud.push_back({{1 + i * h, 1 + j * h, 1 + k * h}});
+
+  std::vector<ArborX::Box> query_boxes{
+      {{{499., 499., 499.}}, {{501., 501., 501.}}}};
+  std::vector<std::pair<ArborX::Point, int>> query_points;
+  for (int i = 0; i < (int)cloud.size(); i += 7)
+  {
+    auto const &p = cloud[i];
+    query_boxes.push_back({{{p[0] - 1.5f * h, p[1] - h, p[2] - .5f * h}},
+                           {{p[0] + .5f * h, p[1] + h, p[2] + 1.5f * h}}});
+    query_points.push_back(
+        {{{p[0] + .3f * h, p[1] + .2f * h, p[2] + .1f * h}}, 1});
+  }
+  for (int i = 0; i < 10; ++i)
+    cloud.push_back({{500., 500., 500.}});
+  auto const points = makePoints<DeviceType>(cloud);
+
+  auto const spatial_queries =
+      makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  auto const nearest_queries = makeNearestQueries<DeviceType>(query_points);
+
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+  {
+    auto const policy =
+        ArborX::Experimental::ConstructionPolicy().setHierarchy(hierarchy);
+    Tree bvh(space, points, policy);
+    Tree refined_bvh(space, points,
+                     ArborX::Experimental::ConstructionPolicy(policy)
+                         .setRefineDuplicateCodes(true));
+    BOOST_TEST(refined_bvh.size() == (int)cloud.size());
+    BOOST_TEST(ArborX::Details::equals(
+        static_cast<ArborX::Box>(refined_bvh.bounds()),
+        static_cast<ArborX::Box>(bvh.bounds())));
+    BOOST_TEST(query(space, refined_bvh, spatial_queries) ==
+                   query(space, bvh, spatial_queries),
+               tt::per_element());
+    BOOST_TEST(query(space, refined_bvh, nearest_queries) ==
+                   query(space, bvh, nearest_queries),
+               tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(quantized_construction, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+  using QuantizedTree = ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<ArborX::Box>,
+      ArborX::Details::DefaultIndexableGetter,
+      ArborX::Experimental::Quantized<ArborX::Box, std::uint16_t>>;
+
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto const boxes =
+      ArborXTest::make_random_cloud<ArborX::Box>(space, n, 10.f, 10.f, 10.f);
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < n; i += 7)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 1) % n));
+    query_boxes.push_back(box);
+  }
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+
+  // Quantized internal nodes are generated in place with the linear
+  // hierarchy, and from full precision ones with PLOC
+  Tree bvh(space, boxes);
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+  {
+    QuantizedTree quantized_bvh(
+        space, boxes,
+        ArborX::Experimental::ConstructionPolicy().setHierarchy(hierarchy));
+    BOOST_TEST(quantized_bvh.size() == n);
+    BOOST_TEST(ArborX::Details::equals(
+        static_cast<ArborX::Box>(quantized_bvh.bounds()),
+        static_cast<ArborX::Box>(bvh.bounds())));
+    BOOST_TEST(query(space, quantized_bvh, queries) ==
+                   query(space, bvh, queries),
+               tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(streamed_construction, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  for (int n : {1, 2, 100})
+  {
+    auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+    // Primitives in host memory are streamed to the memory space of the tree
+    auto const boxes_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+    std::vector<ArborX::Box> query_boxes;
+    for (int i = 0; i < n; i += 3)
+    {
+      auto box = boxes_host(i);
+      ArborX::Details::expand(box, boxes_host((i + 1) % n));
+      query_boxes.push_back(box);
+    }
+    auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+
+    for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+    {
+      auto const policy =
+          ArborX::Experimental::ConstructionPolicy().setHierarchy(hierarchy);
+      Tree bvh(space, boxes, policy);
+      for (int chunk_size : {0, 1, 7, 1000})
+      {
+        Tree streamed_bvh(space, boxes_host,
+                          ArborX::Experimental::ConstructionPolicy(policy)
+                              .setPrimitivesChunkSize(chunk_size));
+        BOOST_TEST(streamed_bvh.size() == n);
+        BOOST_TEST(ArborX::Details::equals(
+            static_cast<ArborX::Box>(streamed_bvh.bounds()),
+            static_cast<ArborX::Box>(bvh.bounds())));
+        BOOST_TEST(query(space, streamed_bvh, queries) ==
+                       query(space, bvh, queries),
+                   tt::per_element());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(presorted_construction, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto const boxes =
+      ArborXTest::make_random_cloud<ArborX::Box>(space, n, 10.f, 10.f, 10.f);
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < n; i += 7)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 1) % n));
+    query_boxes.push_back(box);
+  }
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+
+  auto const permutation =
+      ArborX::Experimental::computeSpaceFillingCurvePermutation(space, boxes);
+  BOOST_TEST(permutation.size() == n);
+  Kokkos::View<ArborX::Box *, DeviceType> sorted_boxes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Testing::sorted_boxes"),
+      n);
+  ArborX::Details::applyPermutation(space, permutation, boxes, sorted_boxes);
+
+  // The results of the hierarchy over the sorted boxes are the positions of
+  // the results of the original one in the permutation
+  auto const permutation_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, permutation);
+  std::vector<int> inverse_permutation(n, -1);
+  for (int i = 0; i < n; ++i)
+    inverse_permutation[permutation_host(i)] = i;
+  BOOST_TEST(std::count(inverse_permutation.begin(), inverse_permutation.end(),
+                        -1) == 0);
+
+  Tree bvh(space, boxes);
+  Kokkos::View<int *, MemorySpace> indices("Testing::indices", 0);
+  Kokkos::View<int *, MemorySpace> offsets("Testing::offsets", 0);
+  bvh.query(space, queries, indices, offsets);
+  auto const indices_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices);
+  auto const offsets_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets);
+  std::vector<int> indices_ref;
+  for (int i = 0; i < (int)indices_host.size(); ++i)
+    indices_ref.push_back(inverse_permutation[indices_host(i)]);
+  std::vector<int> offsets_ref(offsets_host.data(),
+                               offsets_host.data() + offsets_host.size());
+
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+  {
+    Tree sorted_bvh(space, sorted_boxes,
+                    ArborX::Experimental::ConstructionPolicy()
+                        .setHierarchy(hierarchy)
+                        .setPrimitivesSorted(true));
+    BOOST_TEST(sorted_bvh.size() == n);
+    BOOST_TEST(ArborX::Details::equals(sorted_bvh.bounds(), bvh.bounds()));
+    ARBORX_TEST_QUERY_TREE(
+        space, sorted_bvh, queries,
+        make_reference_solution<int>(indices_ref, offsets_ref));
+
+    // The leaves are in the order of the boxes
+    Kokkos::View<int, MemorySpace> n_misplaced("Testing::n_misplaced");
+    Kokkos::parallel_for(
+        "Testing::check_leaves",
+        Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+        KOKKOS_LAMBDA(int i) {
+          if ((int)ArborX::Details::HappyTreeFriends::getValue(sorted_bvh, i)
+                  .index != i)
+            Kokkos::atomic_increment(&n_misplaced());
+        });
+    auto const n_misplaced_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, n_misplaced);
+    BOOST_TEST(n_misplaced_host() == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(nearly_sorted_construction, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto const boxes =
+      ArborXTest::make_random_cloud<ArborX::Box>(space, n, 10.f, 10.f, 10.f);
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < n; i += 7)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 1) % n));
+    query_boxes.push_back(box);
+  }
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+
+  // Unsorted boxes take the full sort, and sorted ones the insertion sort
+  // of the blocks only
+  auto const permutation =
+      ArborX::Experimental::computeSpaceFillingCurvePermutation(space, boxes);
+  Kokkos::View<ArborX::Box *, DeviceType> sorted_boxes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Testing::sorted_boxes"),
+      n);
+  ArborX::Details::applyPermutation(space, permutation, boxes, sorted_boxes);
+
+  auto const policy =
+      ArborX::Experimental::ConstructionPolicy().setPrimitivesNearlySorted(
+          true);
+  Tree const bvh(space, boxes);
+  Tree const unsorted_bvh(space, boxes, policy);
+  BOOST_TEST(query(space, unsorted_bvh, queries) == query(space, bvh, queries),
+             tt::per_element());
+
+  Tree const sorted_bvh(space, sorted_boxes);
+  Tree const nearly_sorted_bvh(space, sorted_boxes, policy);
+  BOOST_TEST(query(space, nearly_sorted_bvh, queries) ==
+                 query(space, sorted_bvh, queries),
+             tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(given_scene_bounds, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto const boxes =
+      ArborXTest::make_random_cloud<ArborX::Box>(space, n, 10.f, 10.f, 10.f);
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+  std::vector<ArborX::Box> query_boxes;
+  std::vector<std::pair<ArborX::Point, int>> query_points;
+  for (int i = 0; i < n; i += 7)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 1) % n));
+    query_boxes.push_back(box);
+    query_points.push_back({box.minCorner(), 5});
+  }
+  auto const spatial_queries =
+      makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  auto const nearest_queries = makeNearestQueries<DeviceType>(query_points);
+
+  Tree bvh(space, boxes);
+
+  // The bounds only affect the ordering of the leaves, whether they are
+  // exact, loose, or too tight and the boxes outside of them are clamped
+  std::vector<ArborX::Experimental::ConstructionPolicy> policies;
+  for (auto const &scene_bounds :
+       {ArborX::Box{{{0.f, 0.f, 0.f}}, {{10.f, 10.f, 10.f}}},
+        ArborX::Box{{{-10.f, -10.f, -10.f}}, {{20.f, 20.f, 20.f}}},
+        ArborX::Box{{{2.5f, 2.5f, 2.5f}}, {{7.5f, 7.5f, 7.5f}}}})
+    policies.push_back(
+        ArborX::Experimental::ConstructionPolicy().setSceneBounds(
+            scene_bounds));
+  for (int sample_size : {10, n, 10 * n})
+    policies.push_back(
+        ArborX::Experimental::ConstructionPolicy().setSceneBoundsSampleSize(
+            sample_size));
+
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+    for (auto policy : policies)
+    {
+      Tree other_bvh(space, boxes, policy.setHierarchy(hierarchy));
+      BOOST_TEST(other_bvh.size() == n);
+      BOOST_TEST(
+          ArborX::Details::equals(static_cast<ArborX::Box>(other_bvh.bounds()),
+                                  static_cast<ArborX::Box>(bvh.bounds())));
+      BOOST_TEST(query(space, other_bvh, spatial_queries) ==
+                     query(space, bvh, spatial_queries),
+                 tt::per_element());
+      BOOST_TEST(query(space, other_bvh, nearest_queries) ==
+                     query(space, bvh, nearest_queries),
+                 tt::per_element());
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(precomputed_codes, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto const boxes =
+      ArborXTest::make_random_cloud<ArborX::Box>(space, n, 10.f, 10.f, 10.f);
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < n; i += 7)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 1) % n));
+    query_boxes.push_back(box);
+  }
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+
+  ArborX::Box const scene_bounds{{{0.f, 0.f, 0.f}}, {{10.f, 10.f, 10.f}}};
+  Kokkos::View<unsigned long long *, MemorySpace> codes(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing, "Testing::codes"),
+      n);
+  Kokkos::parallel_for(
+      "Testing::compute_codes",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n), KOKKOS_LAMBDA(int i) {
+        codes(i) = ArborX::Experimental::Morton64{}(scene_bounds, boxes(i));
+      });
+  auto const permutation = ArborX::Details::sortObjects(space, codes);
+
+  Tree bvh(space, boxes);
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+  {
+    Tree precomputed_bvh(
+        space, boxes, codes, permutation,
+        ArborX::Experimental::ConstructionPolicy().setHierarchy(hierarchy));
+    BOOST_TEST(precomputed_bvh.size() == n);
+    BOOST_TEST(ArborX::Details::equals(precomputed_bvh.bounds(), bvh.bounds()));
+    BOOST_TEST(query(space, precomputed_bvh, queries) ==
+                   query(space, bvh, queries),
+               tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(depth_first_layout, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto const boxes =
+      ArborXTest::make_random_cloud<ArborX::Box>(space, n, 10.f, 10.f, 10.f);
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+  std::vector<ArborX::Box> query_boxes;
+  std::vector<std::pair<ArborX::Point, int>> query_points;
+  for (int i = 0; i < n; i += 7)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 1) % n));
+    query_boxes.push_back(box);
+    query_points.push_back({box.minCorner(), 5});
+  }
+  auto const spatial_queries =
+      makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  auto const nearest_queries = makeNearestQueries<DeviceType>(query_points);
+
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+  {
+    auto const policy =
+        ArborX::Experimental::ConstructionPolicy().setHierarchy(hierarchy);
+    Tree bvh(space, boxes, policy);
+    Tree reordered_bvh(space, boxes,
+                       ArborX::Experimental::ConstructionPolicy(policy)
+                           .setDepthFirstLayout(true));
+    BOOST_TEST(reordered_bvh.size() == n);
+    BOOST_TEST(ArborX::Details::equals(reordered_bvh.bounds(), bvh.bounds()));
+    BOOST_TEST(query(space, reordered_bvh, spatial_queries) ==
+                   query(space, bvh, spatial_queries),
+               tt::per_element());
+    BOOST_TEST(query(space, reordered_bvh, nearest_queries) ==
+                   query(space, bvh, nearest_queries),
+               tt::per_element());
+
+    // Internal left children follow their parent
+    using ArborX::Details::HappyTreeFriends;
+    Kokkos::View<int, MemorySpace> n_misplaced("Testing::n_misplaced");
+    Kokkos::parallel_for(
+        "Testing::check_layout",
+        Kokkos::RangePolicy<ExecutionSpace>(space, n, 2 * n - 1),
+        KOKKOS_LAMBDA(int i) {
+          int const left_child =
+              HappyTreeFriends::getLeftChild(reordered_bvh, i);
+          if (!HappyTreeFriends::isLeaf(reordered_bvh, left_child) &&
+              left_child != i + 1)
+            Kokkos::atomic_increment(&n_misplaced());
+        });
+    auto const n_misplaced_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, n_misplaced);
+    BOOST_TEST(n_misplaced_host() == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(numa_first_touch, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto const boxes =
+      ArborXTest::make_random_cloud<ArborX::Box>(space, n, 10.f, 10.f, 10.f);
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < n; i += 7)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 1) % n));
+    query_boxes.push_back(box);
+  }
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+
+  // The placement of the nodes does not change the hierarchy
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+  {
+    auto const policy =
+        ArborX::Experimental::ConstructionPolicy().setHierarchy(hierarchy);
+    Tree bvh(space, boxes, policy);
+    Tree placed_bvh(space, boxes,
+                    ArborX::Experimental::ConstructionPolicy(policy)
+                        .setNumaFirstTouch(true));
+    BOOST_TEST(ArborX::Details::equals(placed_bvh.bounds(), bvh.bounds()));
+    BOOST_TEST(query(space, placed_bvh, queries) == query(space, bvh, queries),
+               tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(construct_hierarchies, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+  using Boxes = Kokkos::View<ArborX::Box *, ExecutionSpace>;
+
+  ExecutionSpace space;
+
+  std::vector<ExecutionSpace> instances;
+  for (auto const &instance :
+       Kokkos::Experimental::partition_space(space, std::vector<int>{1, 1}))
+    instances.push_back(instance);
+
+  // More sets of primitives than instances, including degenerate ones
+  std::vector<Boxes> primitives;
+  for (int n : {500, 0, 1, 2, 300})
+    primitives.push_back(
+        n == 0 ? Boxes("Testing::boxes", 0)
+               : ArborXTest::make_random_cloud<ArborX::Box>(
+                     space, n, 10.f, 10.f, 10.f, primitives.size()));
+  int const num_trees = primitives.size();
+
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+  {
+    auto const policy =
+        ArborX::Experimental::ConstructionPolicy().setHierarchy(hierarchy);
+    auto const trees = ArborX::Experimental::constructHierarchies<Tree>(
+        instances, primitives, ArborX::Experimental::Morton64(), policy);
+    BOOST_TEST(trees.size() == primitives.size());
+
+    for (int i = 0; i < num_trees; ++i)
+    {
+      auto const &boxes = primitives[i];
+      int const n = boxes.size();
+      Tree bvh(space, boxes, policy);
+      BOOST_TEST(trees[i].size() == n);
+      if (n == 0)
+      {
+        BOOST_TEST(trees[i].empty());
+        continue;
+      }
+      BOOST_TEST(ArborX::Details::equals(trees[i].bounds(), bvh.bounds()));
+
+      auto const boxes_host =
+          Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+      std::vector<ArborX::Box> query_boxes;
+      std::vector<std::pair<ArborX::Point, int>> query_points;
+      for (int j = 0; j < n; j += 7)
+      {
+        auto box = boxes_host(j);
+        ArborX::Details::expand(box, boxes_host((j + 1) % n));
+        query_boxes.push_back(box);
+        query_points.push_back({box.minCorner(), 5});
+      }
+      auto const spatial_queries =
+          makeIntersectsBoxQueries<DeviceType>(query_boxes);
+      auto const nearest_queries =
+          makeNearestQueries<DeviceType>(query_points);
+      BOOST_TEST(query(space, trees[i], spatial_queries) ==
+                     query(space, bvh, spatial_queries),
+                 tt::per_element());
+      BOOST_TEST(query(space, trees[i], nearest_queries) ==
+                     query(space, bvh, nearest_queries),
+                 tt::per_element());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,133 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_LinearBVH.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(CountUpTo)
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(count_up_to, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  // Unit boxes at (i, 0, 0)
+  std::vector<ArborX::Box> boxes;
+  for (int i = 0; i < 10; ++i)
+    boxes.push_back({{{(float)i, 0.f, 0.f}}, {{i + 1.f, 1.f, 1.f}}});
+
+  // Intersecting 3, 10, 1 and none of the boxes
+  auto const predicates = makeIntersectsBoxQueries<DeviceType>({
+      {{{2.5, .5, .5}}, {{4.5, .5, .5}}},
+      {{{-1., -1., -1.}}, {{20., 2., 2.}}},
+      {{{7.5, .5, .5}}, {{7.5, .5, .5}}},
+      {{{30., 30., 30.}}, {{31., 31., 31.}}},
+  });
+
+  for (auto const &tree : {ArborX::BVH<MemorySpace>(
+                               space, ArborXTest::toView<DeviceType>(boxes)),
+                           ArborX::BVH<MemorySpace>(
+                               space, ArborXTest::toView<DeviceType>(
+                                          std::vector<ArborX::Box>{}))})
+  {
+    for (int n : {0, 1, 2, 100})
+    {
+      Kokkos::View<int *, MemorySpace> counts("Testing::counts", 0);
+      tree.countUpTo(space, predicates, n, counts);
+
+      std::vector<int> counts_ref;
+      for (int count : {3, 10, 1, 0})
+        counts_ref.push_back(tree.empty() ? 0 : std::min(count, n));
+      auto const counts_host =
+          Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, counts);
+      BOOST_TEST(std::vector<int>(counts_host.data(),
+                                  counts_host.data() + counts_host.size()) ==
+                     counts_ref,
+                 tt::per_element());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(count, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  // Points on a 20x20x20 grid
+  int const m = 20;
+  std::vector<ArborX::Point> points;
+  for (int i = 0; i < m; ++i)
+    for (int j = 0; j < m; ++j)
+      for (int k = 0; k < m; ++k)
+        points.push_back({{(float)i, (float)j, (float)k}});
+  ArborX::BVH<MemorySpace> const tree(space,
+                                      ArborXTest::toView<DeviceType>(points));
+
+  std::vector<std::pair<ArborX::Point, float>> spheres;
+  for (int i = 0; i < m; i += 3)
+    for (float radius : {0.5f, 2.5f, 6.5f, 40.f})
+      spheres.push_back({{{(float)i, (float)i, 10.f}}, radius});
+  auto const predicates = makeIntersectsSphereQueries<DeviceType>(spheres);
+
+  std::vector<int> counts_ref;
+  for (auto const &[center, radius] : spheres)
+  {
+    int count = 0;
+    for (auto const &point : points)
+      count += ArborX::Details::intersects(ArborX::Sphere{center, radius},
+                                           point);
+    counts_ref.push_back(count);
+  }
+
+  Kokkos::View<int *, MemorySpace> counts("Testing::counts", 0);
+  tree.count(space, predicates, counts);
+  auto counts_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, counts);
+  BOOST_TEST(std::vector<int>(counts_host.data(),
+                              counts_host.data() + counts_host.size()) ==
+                 counts_ref,
+             tt::per_element());
+
+  float const relative_tolerance = 0.1f;
+  tree.count(space, predicates, counts, relative_tolerance);
+  counts_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, counts);
+  BOOST_TEST(counts_host.size() == counts_ref.size());
+  for (int i = 0; i < (int)counts_ref.size(); ++i)
+    BOOST_TEST(std::abs(counts_host(i) - counts_ref[i]) <=
+               relative_tolerance * counts_ref[i]);
+
+  ArborX::BVH<MemorySpace> const empty_tree(
+      space, ArborXTest::toView<DeviceType>(std::vector<ArborX::Point>{}));
+  empty_tree.count(space, predicates, counts);
+  counts_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, counts);
+  BOOST_TEST(std::all_of(counts_host.data(),
+                         counts_host.data() + counts_host.size(),
+                         [](int count) { return count == 0; }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,219 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_DetailsTreeQuality.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(Refit)
+
+namespace tt = boost::test_tools;
+
+template <typename DeviceType>
+auto makeBoxes(std::vector<ArborX::Box> const &b)
+{
+  int const n = b.size();
+  Kokkos::View<ArborX::Box *, DeviceType> boxes("Testing::boxes", n);
+  auto boxes_host = Kokkos::create_mirror_view(boxes);
+  for (int i = 0; i < n; ++i)
+    boxes_host(i) = b[i];
+  Kokkos::deep_copy(boxes, boxes_host);
+  return boxes;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(refit_moving_boxes, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  std::vector<ArborX::Box> boxes;
+  for (int i = 0; i < 10; ++i)
+    boxes.push_back({{{(float)i, 0.f, 0.f}}, {{i + .5f, .5f, .5f}}});
+
+  Tree bvh(space, makeBoxes<DeviceType>(boxes));
+
+  // Translate all the boxes, the quality of the tree is preserved
+  std::vector<ArborX::Box> translated_boxes;
+  for (auto const &box : boxes)
+    translated_boxes.push_back(
+        {{{box.minCorner()[0], box.minCorner()[1] + 10.f, box.minCorner()[2]}},
+         {{box.maxCorner()[0], box.maxCorner()[1] + 10.f,
+           box.maxCorner()[2]}}});
+  auto const ratio = bvh.refit(space, makeBoxes<DeviceType>(translated_boxes));
+  BOOST_TEST(ratio == 1.f, tt::tolerance(1e-5f));
+  BOOST_TEST(ArborX::Details::equals(
+      static_cast<ArborX::Box>(bvh.bounds()),
+      {{{0.f, 10.f, 0.f}}, {{9.5f, 10.5f, .5f}}}));
+
+  // Old locations are empty, new ones are found
+  ARBORX_TEST_QUERY_TREE(
+      space, bvh,
+      makeIntersectsBoxQueries<DeviceType>({
+          {{{0.f, 0.f, 0.f}}, {{10.f, 1.f, 1.f}}},
+          {{{0.f, 10.f, 0.f}}, {{2.f, 11.f, 1.f}}},
+      }),
+      make_reference_solution<int>({0, 1, 2}, {0, 0, 3}));
+
+  // Shuffle the boxes, the tree degrades but the queries still give the same
+  // results as with a freshly built tree
+  std::vector<ArborX::Box> shuffled_boxes;
+  for (int i = 0; i < 10; ++i)
+    shuffled_boxes.push_back(boxes[(3 * i) % 10]);
+  auto const worse_ratio =
+      bvh.refit(space, makeBoxes<DeviceType>(shuffled_boxes));
+  BOOST_TEST(worse_ratio > 1.f);
+
+  Tree rebuilt_bvh(space, makeBoxes<DeviceType>(shuffled_boxes));
+  auto const queries = makeIntersectsBoxQueries<DeviceType>({
+      {{{0.f, 0.f, 0.f}}, {{.1f, .1f, .1f}}},
+      {{{2.1f, 0.f, 0.f}}, {{4.f, 1.f, 1.f}}},
+      {{{-1.f, -1.f, -1.f}}, {{20.f, 20.f, 20.f}}},
+      {},
+  });
+  BOOST_TEST(query(space, bvh, queries) == query(space, rebuilt_bvh, queries),
+             tt::per_element());
+  BOOST_TEST(ArborX::Details::equals(
+      static_cast<ArborX::Box>(bvh.bounds()),
+      static_cast<ArborX::Box>(rebuilt_bvh.bounds())));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(refit_quantized, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<ArborX::Box>,
+      ArborX::Details::DefaultIndexableGetter,
+      ArborX::Experimental::Quantized<ArborX::Box, std::uint8_t>>;
+
+  ExecutionSpace space;
+
+  std::vector<ArborX::Box> boxes;
+  for (int i = 0; i < 10; ++i)
+    boxes.push_back({{{(float)i, 0.f, 0.f}}, {{i + .5f, .5f, .5f}}});
+
+  Tree bvh(space, makeBoxes<DeviceType>(boxes));
+
+  std::vector<ArborX::Box> shuffled_boxes;
+  for (int i = 0; i < 10; ++i)
+    shuffled_boxes.push_back(boxes[(3 * i) % 10]);
+  BOOST_TEST(bvh.refit(space, makeBoxes<DeviceType>(shuffled_boxes)) > 1.f);
+
+  ArborX::BVH<MemorySpace> rebuilt_bvh(space,
+                                       makeBoxes<DeviceType>(shuffled_boxes));
+  auto const queries = makeIntersectsBoxQueries<DeviceType>({
+      {{{0.f, 0.f, 0.f}}, {{.1f, .1f, .1f}}},
+      {{{2.1f, 0.f, 0.f}}, {{4.f, 1.f, 1.f}}},
+      {{{.6f, .6f, .6f}}, {{.9f, .9f, .9f}}},
+      {{{-1.f, -1.f, -1.f}}, {{20.f, 20.f, 20.f}}},
+  });
+  BOOST_TEST(query(space, bvh, queries) == query(space, rebuilt_bvh, queries),
+             tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(refit_degenerate, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  Tree empty_bvh(space, makeBoxes<DeviceType>({}));
+  BOOST_TEST(empty_bvh.refit(space, makeBoxes<DeviceType>({})) == 1.f);
+  BOOST_TEST(empty_bvh.empty());
+
+  Tree bvh(space, makeBoxes<DeviceType>({{{{0., 0., 0.}}, {{1., 1., 1.}}}}));
+  BOOST_TEST(bvh.refit(space, makeBoxes<DeviceType>(
+                                  {{{{2., 2., 2.}}, {{3., 3., 3.}}}})) == 1.f);
+  BOOST_TEST(ArborX::Details::equals(static_cast<ArborX::Box>(bvh.bounds()),
+                                     {{{2., 2., 2.}}, {{3., 3., 3.}}}));
+  ARBORX_TEST_QUERY_TREE(
+      space, bvh,
+      makeIntersectsBoxQueries<DeviceType>({
+          {{{0., 0., 0.}}, {{1., 1., 1.}}},
+          {{{2.5, 2.5, 2.5}}, {{2.5, 2.5, 2.5}}},
+      }),
+      make_reference_solution<int>({0}, {0, 0, 1}));
+
+  BOOST_CHECK_THROW(bvh.refit(space, makeBoxes<DeviceType>({{}, {}})),
+                    ArborX::SearchException);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(tree_quality, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Experimental::computeTreeQuality;
+
+  ExecutionSpace space;
+
+  std::vector<ArborX::Box> boxes;
+  for (int i = 0; i < 10; ++i)
+    boxes.push_back({{{(float)i, 0.f, 0.f}}, {{i + .5f, .5f, .5f}}});
+
+  auto const count_leaves = [](std::vector<int> const &histogram) {
+    return std::accumulate(histogram.begin(), histogram.end(), 0);
+  };
+
+  ArborX::BVH<MemorySpace> bvh(space, makeBoxes<DeviceType>(boxes));
+  auto const quality = computeTreeQuality(space, bvh);
+  BOOST_TEST(quality.surface_area_heuristic_cost > 1.f);
+  // Disjoint boxes sorted along the curve do not overlap
+  BOOST_TEST(quality.sibling_overlap_volume == 0.f);
+  BOOST_TEST(quality.leaf_tightness == 1.f, tt::tolerance(1e-5f));
+  BOOST_TEST(count_leaves(quality.leaf_depth_histogram) == 10);
+  BOOST_TEST(quality.leaf_depth_histogram[0] == 0);
+
+  // Shuffling the boxes degrades the tree
+  std::vector<ArborX::Box> shuffled_boxes;
+  for (int i = 0; i < 10; ++i)
+    shuffled_boxes.push_back(boxes[(3 * i) % 10]);
+  bvh.refit(space, makeBoxes<DeviceType>(shuffled_boxes));
+  auto const refitted_quality = computeTreeQuality(space, bvh);
+  BOOST_TEST(refitted_quality.surface_area_heuristic_cost >
+             quality.surface_area_heuristic_cost);
+  BOOST_TEST(refitted_quality.sibling_overlap_volume > 0.f);
+  BOOST_TEST(refitted_quality.leaf_depth_histogram ==
+                 quality.leaf_depth_histogram,
+             tt::per_element());
+
+  // Quantized bounding volumes are looser
+  ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<ArborX::Box>,
+      ArborX::Details::DefaultIndexableGetter,
+      ArborX::Experimental::Quantized<ArborX::Box, std::uint8_t>>
+      quantized_bvh(space, makeBoxes<DeviceType>(boxes));
+  auto const quantized_quality = computeTreeQuality(space, quantized_bvh);
+  BOOST_TEST(quantized_quality.leaf_tightness <= 1.f);
+  BOOST_TEST(count_leaves(quantized_quality.leaf_depth_histogram) == 10);
+
+  ArborX::BVH<MemorySpace> one_leaf_bvh(
+      space, makeBoxes<DeviceType>({{{{0., 0., 0.}}, {{1., 1., 1.}}}}));
+  BOOST_TEST(computeTreeQuality(space, one_leaf_bvh).leaf_depth_histogram ==
+                 std::vector<int>{1},
+             tt::per_element());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,7 @@
  * SPDX-License-Identifier: BSD-3-Clause                                    *
  ****************************************************************************/
 
+#include "ArborXTest_Cloud.hpp"
 #include "ArborXTest_StdVectorToKokkosView.hpp"
 #include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
 #include "ArborX_EnableViewComparison.hpp"
@@ -17,6 +18,10 @@
 #include "BoostTest_CUDA_clang_workarounds.hpp"
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+#include <numeric>
+#include <vector>
+
 namespace ArborX
 {
 namespace Details
@@ -157,3 +162,181 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(minimum_spanning_tree, DeviceType,
             {0, 1, 10}, {1, 2, 9}, {2, 3, 8}, {3, 4, 7}, {0, 5, 10}}));
   }
 }
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(approximate_minimum_spanning_tree, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  ExecutionSpace exec_space;
+
+  int const n = 1000;
+  auto points = ArborXTest::make_random_cloud<ArborX::Point>(exec_space, n);
+
+  auto total_weight = [](auto const &edges) {
+    double weight = 0;
+    for (int e = 0; e < (int)edges.size(); ++e)
+      weight += edges(e).weight;
+    return weight;
+  };
+
+  for (int k : {1, 3})
+  {
+    using ArborX::Details::MinimumSpanningTree;
+    auto const exact_weight =
+        total_weight(Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace{},
+            MinimumSpanningTree<MemorySpace>(exec_space, points, k).edges));
+
+    for (float eps : {0.1f, 1.f})
+    {
+      auto edges = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{},
+          MinimumSpanningTree<MemorySpace>(exec_space, points, k, eps).edges);
+      BOOST_TEST((int)edges.size() == n - 1);
+
+      // The edges must connect all the points
+      std::vector<int> parents(n);
+      std::iota(parents.begin(), parents.end(), 0);
+      auto find = [&parents](int i) {
+        while (parents[i] != i)
+          i = parents[i] = parents[parents[i]];
+        return i;
+      };
+      int num_components = n;
+      for (int e = 0; e < n - 1; ++e)
+      {
+        int const i = find(edges(e).source);
+        int const j = find(edges(e).target);
+        if (i != j)
+        {
+          parents[i] = j;
+          --num_components;
+        }
+      }
+      BOOST_TEST(num_components == 1);
+
+      auto const weight = total_weight(edges);
+      BOOST_TEST(weight >= exact_weight * (1 - 1e-5));
+      BOOST_TEST(weight <= (1 + eps) * exact_weight * (1 + 1e-5));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(minimum_spanning_tree_statistics, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  ExecutionSpace exec_space;
+
+  int const n = 1000;
+  auto points = ArborXTest::make_random_cloud<ArborX::Point>(exec_space, n);
+
+  for (int k : {1, 3})
+  {
+    using ArborX::Details::MinimumSpanningTree;
+    ArborX::Details::BoruvkaStatistics statistics;
+    auto edges = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{},
+        MinimumSpanningTree<MemorySpace>(exec_space, points, k, 0, &statistics)
+            .edges);
+    auto reference = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{},
+        MinimumSpanningTree<MemorySpace>(exec_space, points, k).edges);
+    std::sort(edges.data(), edges.data() + edges.size());
+    std::sort(reference.data(), reference.data() + reference.size());
+    BOOST_TEST(edges == reference, boost::test_tools::per_element());
+
+    auto const &rounds = statistics.rounds;
+    BOOST_TEST_REQUIRE(!rounds.empty());
+    BOOST_TEST(rounds.front().num_components == n);
+    for (int r = 0; r < (int)rounds.size(); ++r)
+    {
+      // Every iteration at least halves the number of components
+      if (r > 0)
+        BOOST_TEST(2 * rounds[r].num_components <=
+                   rounds[r - 1].num_components);
+      BOOST_TEST(rounds[r].num_searched_points <= n);
+      BOOST_TEST(rounds[r].num_visited_nodes >= rounds[r].num_searched_points);
+      BOOST_TEST(rounds[r].search_time >= 0);
+    }
+    // The lower bounds do not prune anything in the first iteration
+    BOOST_TEST(rounds.front().num_searched_points == n);
+  }
+}
+
+namespace Test
+{
+template <class ExecutionSpace>
+auto build_minimum_spanning_forest(ExecutionSpace const &exec_space,
+                                   std::vector<int> const &offsets_host,
+                                   std::vector<int> const &indices_host,
+                                   std::vector<float> const &weights_host)
+{
+  auto offsets = toView<ExecutionSpace>(offsets_host, "Test::offsets");
+  auto indices = toView<ExecutionSpace>(indices_host, "Test::indices");
+  auto weights = toView<ExecutionSpace>(weights_host, "Test::weights");
+
+  using MemorySpace = typename ExecutionSpace::memory_space;
+  ArborX::Details::MinimumSpanningForest<MemorySpace> msf{exec_space, offsets,
+                                                          indices, weights};
+
+  auto edges_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, msf.edges);
+  std::sort(edges_host.data(), edges_host.data() + edges_host.size());
+  return edges_host;
+}
+} // namespace Test
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(minimum_spanning_forest, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Details::WeightedEdge;
+  ExecutionSpace exec_space;
+
+  { // non-symmetric graph with three connected components
+    //   1     3
+    // 0---1   3---4   5
+    //  \  |2
+    // 3 \ |
+    //     2
+    auto edges = Test::build_minimum_spanning_forest(
+        exec_space, {0, 2, 3, 3, 4, 4, 4}, {1, 2, 2, 4}, {1, 3, 2, 3});
+    BOOST_TEST(edges == (std::vector<WeightedEdge>{{0, 1, 1}, {1, 2, 2},
+                                                   {3, 4, 3}}),
+               boost::test_tools::per_element());
+  }
+
+  { // no edges
+    auto edges =
+        Test::build_minimum_spanning_forest(exec_space, {0, 0, 0}, {}, {});
+    BOOST_TEST(edges.size() == 0);
+  }
+
+  { // complete graph over points matches the Euclidean minimum spanning tree
+    std::vector<ArborX::Point> points{
+        {0, 0, 0}, {1, 0, 0}, {2, 0, 0}, {3, 0, 0}, {6, 0, 0}, {10, 0, 0},
+    };
+    int const n = points.size();
+    std::vector<int> offsets{0};
+    std::vector<int> indices;
+    std::vector<float> weights;
+    for (int i = 0; i < n; ++i)
+    {
+      for (int j = 0; j < n; ++j)
+        if (j != i)
+        {
+          indices.push_back(j);
+          weights.push_back(std::abs(points[i][0] - points[j][0]));
+        }
+      offsets.push_back(indices.size());
+    }
+
+    BOOST_TEST(Test::build_minimum_spanning_forest(exec_space, offsets,
+                                                   indices, weights) ==
+                   Test::build_minimum_spanning_tree(exec_space, points, 1),
+               boost::test_tools::per_element());
+  }
+}
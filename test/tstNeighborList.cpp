@@ -45,6 +45,18 @@ struct Filter
   }
 };
 
+struct WithinRadius
+{
+  float _radius;
+
+  template <class Geometry>
+  KOKKOS_FUNCTION auto operator()(Geometry const &geometry) const
+  {
+    return ArborX::intersects(
+        ArborX::Sphere{ArborX::Details::returnCentroid(geometry), _radius});
+  }
+};
+
 template <class Points>
 struct RadiusSearch
 {
@@ -115,12 +127,27 @@ auto compute_reference(ExecutionSpace const &exec_space, Points const &points,
 
 template <class ExecutionSpace, class Points>
 auto buildFullNeighborList(ExecutionSpace const &exec_space,
-                           Points const &points, float radius)
+                           Points const &points, float radius,
+                           int buffer_size = 0)
 {
   Kokkos::View<int *, ExecutionSpace> offsets("Test::offsets", 0);
   Kokkos::View<int *, ExecutionSpace> indices("Test::indices", 0);
   ArborX::Experimental::findFullNeighborList(exec_space, points, radius,
-                                             offsets, indices);
+                                             offsets, indices, buffer_size);
+  return make_compressed_storage(
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices));
+}
+
+template <class ExecutionSpace, class Points>
+auto buildHalfNeighborList(ExecutionSpace const &exec_space,
+                           Points const &points, float radius,
+                           int buffer_size = 0)
+{
+  Kokkos::View<int *, ExecutionSpace> offsets("Test::offsets", 0);
+  Kokkos::View<int *, ExecutionSpace> indices("Test::indices", 0);
+  ArborX::Experimental::findHalfNeighborList(exec_space, points, radius,
+                                             offsets, indices, buffer_size);
   return make_compressed_storage(
       Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
       Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices));
@@ -128,18 +155,33 @@ auto buildFullNeighborList(ExecutionSpace const &exec_space,
 
 template <class ExecutionSpace, class Points>
 auto buildHalfNeighborListAndExpandToFull(ExecutionSpace const &exec_space,
-                                          Points const &points, float radius)
+                                          Points const &points, float radius,
+                                          int buffer_size = 0)
 {
   Kokkos::View<int *, ExecutionSpace> offsets("Test::offsets", 0);
   Kokkos::View<int *, ExecutionSpace> indices("Test::indices", 0);
   ArborX::Experimental::findHalfNeighborList(exec_space, points, radius,
-                                             offsets, indices);
+                                             offsets, indices, buffer_size);
   ArborX::Details::expandHalfToFull(exec_space, offsets, indices);
   return make_compressed_storage(
       Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
       Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices));
 }
 
+template <class ExecutionSpace, class Tree, class PredicateGetter>
+auto selfJoin(ExecutionSpace const &exec_space, Tree const &tree,
+              PredicateGetter const &get_predicate,
+              ArborX::Experimental::SelfJoinOutput output)
+{
+  Kokkos::View<int *, ExecutionSpace> offsets("Test::offsets", 0);
+  Kokkos::View<int *, ExecutionSpace> indices("Test::indices", 0);
+  ArborX::Experimental::selfJoin(tree, exec_space, get_predicate, offsets,
+                                 indices, output);
+  return make_compressed_storage(
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices));
+}
+
 #define ARBORX_TEST_NEIGHBOR_LIST(exec_space, points, radius, offsets_ref,     \
                                   indices_ref)                                 \
   BOOST_TEST(Test::buildFullNeighborList(exec_space, points, radius) ==        \
@@ -203,6 +245,22 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(find_neighbor_list, DeviceType,
   ARBORX_TEST_NEIGHBOR_LIST(
       exec_space, points, 6.f, (std::vector<int>{0, 3, 6, 9, 12}),
       (std::vector<int>{1, 2, 3, 0, 2, 3, 0, 1, 3, 0, 1, 2}));
+
+  // Each pair of the half list is stored in the row of its smaller index
+  BOOST_TEST(Test::buildHalfNeighborList(exec_space, points, 2.f) ==
+                 make_compressed_storage(std::vector<int>{0, 1, 2, 3, 3},
+                                         std::vector<int>{1, 2, 3}),
+             boost::test_tools::per_element());
+  BOOST_TEST(Test::buildHalfNeighborList(exec_space, points, 6.f) ==
+                 make_compressed_storage(std::vector<int>{0, 3, 5, 6, 6},
+                                         std::vector<int>{1, 2, 3, 2, 3, 3}),
+             boost::test_tools::per_element());
+  for (int buffer_size : {1, 100})
+    BOOST_TEST(
+        Test::buildHalfNeighborList(exec_space, points, 6.f, buffer_size) ==
+            make_compressed_storage(std::vector<int>{0, 3, 5, 6, 6},
+                                    std::vector<int>{1, 2, 3, 2, 3, 3}),
+        boost::test_tools::per_element());
 }
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(
@@ -224,4 +282,135 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(
       Test::buildHalfNeighborListAndExpandToFull(exec_space, points, radius) ==
           Test::compute_reference<MemorySpace>(exec_space, points, radius),
       boost::test_tools::per_element());
+
+  // Single traversal, with an estimate that is too small and then one that
+  // is large enough
+  for (int buffer_size : {1, 100})
+  {
+    BOOST_TEST(
+        Test::buildFullNeighborList(exec_space, points, radius, buffer_size) ==
+            Test::compute_reference<MemorySpace>(exec_space, points, radius),
+        boost::test_tools::per_element());
+    BOOST_TEST(
+        Test::buildHalfNeighborListAndExpandToFull(exec_space, points, radius,
+                                                   buffer_size) ==
+            Test::compute_reference<MemorySpace>(exec_space, points, radius),
+        boost::test_tools::per_element());
+  }
+
+  // A hard estimate that is too small throws
+  BOOST_CHECK_THROW(
+      Test::buildFullNeighborList(exec_space, points, radius, -1),
+      ArborX::SearchException);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(verlet_neighbor_list, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using MemorySpace = typename DeviceType::memory_space;
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace exec_space;
+
+  using ArborX::Experimental::SelfJoinOutput;
+
+  auto points = ArborXTest::make_random_cloud<ArborX::Point>(exec_space, 100);
+  auto points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  float const cutoff = .3f;
+  float const skin = .1f;
+
+  ArborX::Experimental::VerletNeighborList<MemorySpace> full_list(cutoff,
+                                                                  skin);
+  ArborX::Experimental::VerletNeighborList<MemorySpace> half_list(
+      cutoff, skin, SelfJoinOutput::Half);
+
+  auto const check = [&](bool rebuild) {
+    BOOST_TEST(full_list.update(exec_space, points) == rebuild);
+    BOOST_TEST(half_list.update(exec_space, points) == rebuild);
+    BOOST_TEST(make_compressed_storage(
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       full_list.offsets()),
+                   Kokkos::create_mirror_view_and_copy(
+                       Kokkos::HostSpace{}, full_list.indices())) ==
+                   Test::buildFullNeighborList(exec_space, points, cutoff),
+               boost::test_tools::per_element());
+    // The half list needs to be expanded, which is done on copies
+    auto offsets = KokkosExt::clone(exec_space, half_list.offsets());
+    auto indices = KokkosExt::clone(exec_space, half_list.indices());
+    ArborX::Details::expandHalfToFull(exec_space, offsets, indices);
+    BOOST_TEST(
+        make_compressed_storage(
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                indices)) ==
+            Test::buildFullNeighborList(exec_space, points, cutoff),
+        boost::test_tools::per_element());
+  };
+  auto const move = [&](float displacement) {
+    for (int i = 0; i < (int)points_host.extent(0); ++i)
+      points_host(i)[i % 3] += (i % 2 == 0 ? displacement : -displacement);
+    Kokkos::deep_copy(points, points_host);
+  };
+
+  // The first update searches the pairs
+  check(true);
+  BOOST_TEST(full_list.numberOfRebuilds() == 1);
+
+  // Points moving by less than half the skin only filter the pairs
+  move(.02f);
+  check(false);
+  move(.02f);
+  check(false);
+  BOOST_TEST(full_list.numberOfRebuilds() == 1);
+
+  // The total displacement exceeds half the skin
+  move(.02f);
+  check(true);
+  BOOST_TEST(full_list.numberOfRebuilds() == 2);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(self_join, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using MemorySpace = typename DeviceType::memory_space;
+  using ExecutionSpace = typename DeviceType::execution_space;
+  ExecutionSpace exec_space;
+
+  using ArborX::Experimental::SelfJoinOutput;
+
+  auto points = ArborXTest::toView<ExecutionSpace>(
+      std::vector<ArborX::Point>{
+          {0.f, 0.f, 0.f},
+          {1.f, 1.f, 1.f},
+          {2.f, 2.f, 2.f},
+          {3.f, 3.f, 3.f},
+      },
+      "Test::four_points");
+
+  ArborX::BoundingVolumeHierarchy<MemorySpace> bvh(exec_space, points);
+  Test::WithinRadius const get_predicate{2.f};
+
+  BOOST_TEST(Test::selfJoin(exec_space, bvh, get_predicate,
+                            SelfJoinOutput::Half) ==
+                 make_compressed_storage(std::vector<int>{0, 1, 2, 3, 3},
+                                         std::vector<int>{1, 2, 3}),
+             boost::test_tools::per_element());
+  BOOST_TEST(Test::selfJoin(exec_space, bvh, get_predicate,
+                            SelfJoinOutput::Full) ==
+                 make_compressed_storage(std::vector<int>{0, 1, 3, 5, 6},
+                                         std::vector<int>{1, 0, 2, 1, 3, 2}),
+             boost::test_tools::per_element());
+
+  // Hierarchies storing values pass them to the callback. Each pair (i, i+1)
+  // is found exactly once and sets bit i of the mask.
+  ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<ArborX::Box>>
+      tree(exec_space, points);
+  Kokkos::View<int, MemorySpace> mask("Test::mask");
+  tree.selfJoin(
+      exec_space, get_predicate, KOKKOS_LAMBDA(auto const &v, auto const &w) {
+        Kokkos::atomic_add(&mask(), 1 << KokkosExt::min(v.index, w.index));
+      });
+  auto mask_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, mask);
+  BOOST_TEST(mask_host() == 0b111);
 }
@@ -0,0 +1,106 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_DBSCAN.hpp>
+#include <ArborX_OPTICS.hpp>
+
+#include "BoostTest_CUDA_clang_workarounds.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(OPTICS)
+
+namespace
+{
+
+// Check that two labelings describe the same clusters and the same noise
+template <typename Labels>
+bool samePartitions(Labels const &labels1, Labels const &labels2)
+{
+  int const n = labels1.size();
+  if ((int)labels2.size() != n)
+    return false;
+  for (int i = 0; i < n; ++i)
+  {
+    if ((labels1(i) == -1) != (labels2(i) == -1))
+      return false;
+    for (int j = i + 1; j < n; ++j)
+      if ((labels1(i) != -1 && labels1(i) == labels1(j)) !=
+          (labels2(i) != -1 && labels2(i) == labels2(j)))
+        return false;
+  }
+  return true;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(optics, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Point;
+  using ArborXTest::toView;
+
+  ExecutionSpace space;
+
+  // Clusters of various densities
+  std::vector<Point> cloud;
+  for (int i = 0; i < 20; ++i)
+    cloud.push_back({{0.1f * i, 0, 0}});
+  for (int i = 0; i < 20; ++i)
+    cloud.push_back({{10 + 0.45f * i, (i % 2 == 0 ? 0.2f : 0.f), 0}});
+  for (int i = 0; i < 5; ++i)
+    cloud.push_back({{0, 5.f * (i + 1), 3.f * i}});
+  auto const points = toView<DeviceType, Point>(cloud);
+
+  for (int core_min_size : {2, 3, 5})
+  {
+    auto const reachability =
+        ArborX::Experimental::optics(space, points, core_min_size);
+    BOOST_TEST(reachability._ordering.size() == cloud.size());
+
+    for (float eps : {0.05f, 0.15f, 0.33f, 0.7f, 4.f, 100.f})
+    {
+      auto const labels = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{}, ArborX::Experimental::dbscanFromReachability(
+                                   space, reachability, eps));
+      auto const labels_ref = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{},
+          ArborX::dbscan(space, points, eps, core_min_size,
+                         ArborX::DBSCAN::Parameters()
+                             .setImplementation(
+                                 ArborX::DBSCAN::Implementation::FDBSCAN)
+                             .setCorePointsOnly(true)));
+      BOOST_TEST(samePartitions(labels, labels_ref));
+    }
+  }
+
+  // Degenerate cases
+  for (std::vector<Point> const &degenerate_cloud :
+       {std::vector<Point>{}, std::vector<Point>{{{1, 1, 1}}},
+        std::vector<Point>{{{0, 0, 0}}, {{0.1, 0, 0}}}})
+  {
+    auto const degenerate_points =
+        toView<DeviceType, Point>(degenerate_cloud);
+    auto const reachability =
+        ArborX::Experimental::optics(space, degenerate_points, 3);
+    auto const labels = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace{},
+        ArborX::Experimental::dbscanFromReachability(space, reachability, 1.f));
+    BOOST_TEST(labels.size() == degenerate_cloud.size());
+    for (int i = 0; i < (int)labels.size(); ++i)
+      BOOST_TEST(labels(i) == -1);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
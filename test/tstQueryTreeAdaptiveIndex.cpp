@@ -0,0 +1,83 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_AdaptiveIndex.hpp>
+#include <ArborX_Box.hpp>
+#include <ArborX_Point.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(adaptive_index, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Box;
+  using ArborX::Point;
+
+  ExecutionSpace space;
+
+  // Points along the x-axis at (i, 0, 0)
+  int const n = 100;
+  std::vector<Point> points;
+  for (int i = 0; i < n; ++i)
+    points.push_back({(float)i, 0, 0});
+
+  ArborX::Experimental::AdaptiveIndex<MemorySpace> index(
+      space, ArborXTest::toView<DeviceType>(points));
+  BOOST_TEST(index.size() == n);
+  BOOST_TEST(
+      ArborX::Details::equals(index.bounds(), Box{{0, 0, 0}, {n - 1.f, 0, 0}}));
+
+  auto const spatial_predicates = makeIntersectsBoxQueries<DeviceType>(
+      {{{4.5, -1, -1}, {7.5, 1, 1}}, {{-3, -1, -1}, {-2, 1, 1}}});
+  auto const spatial_reference =
+      make_reference_solution<int>({5, 6, 7}, {0, 3, 3});
+  auto const nearest_predicates =
+      makeNearestQueries<DeviceType>({{{20.2, 0, 0}, 2}, {{-5, 0, 0}, 1}});
+  auto const nearest_reference =
+      make_reference_solution<int>({20, 21, 0}, {0, 2, 3});
+
+  // So few primitives are always brute forced by default
+  BOOST_TEST(index.usesBruteForce(2));
+  BOOST_TEST(index.usesBruteForce(10000));
+  index.setCostRatio(1.f);
+  BOOST_TEST(!index.usesBruteForce(10000));
+  // A small batch does not pay for building the tree
+  index.setCostRatio(10.f);
+  BOOST_TEST(index.usesBruteForce(10));
+
+  // Force either method
+  for (float cost_ratio : {1e9f, 0.f})
+  {
+    index.setCostRatio(cost_ratio);
+    BOOST_TEST(index.usesBruteForce(2) == (cost_ratio > 0));
+    ARBORX_TEST_QUERY_TREE(space, index, spatial_predicates,
+                           spatial_reference);
+    ARBORX_TEST_QUERY_TREE(space, index, nearest_predicates,
+                           nearest_reference);
+  }
+
+  // Once built, the tree is not charged for anymore
+  index.setCostRatio(10.f);
+  BOOST_TEST(!index.usesBruteForce(10));
+
+  index.calibrate(space);
+  BOOST_TEST(index.costRatio() > 0);
+  ARBORX_TEST_QUERY_TREE(space, index, spatial_predicates, spatial_reference);
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_BruteForce.hpp>
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_HyperSphere.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(brute_force_high_dimension, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  // Neither the blocks of 64 predicates and primitives nor the slices of 16
+  // coordinates are filled up
+  constexpr int DIM = 20;
+  using Point = ArborX::ExperimentalHyperGeometry::Point<DIM>;
+  using Sphere = ArborX::ExperimentalHyperGeometry::Sphere<DIM>;
+  using Box = ArborX::ExperimentalHyperGeometry::Box<DIM>;
+
+  ExecutionSpace space;
+
+  std::default_random_engine generator(0);
+  std::uniform_real_distribution<float> coordinate(0, 1);
+  std::uniform_real_distribution<float> radius(1, 1.5);
+
+  std::vector<Point> points(150);
+  std::vector<Box> boxes(points.size());
+  for (int i = 0; i < (int)points.size(); ++i)
+    for (int d = 0; d < DIM; ++d)
+    {
+      points[i][d] = coordinate(generator);
+      boxes[i].minCorner()[d] = points[i][d] - .05f;
+      boxes[i].maxCorner()[d] = points[i][d] + .05f;
+    }
+
+  std::vector<decltype(ArborX::intersects(Sphere{}))> predicates;
+  for (int i = 0; i < 70; ++i)
+  {
+    Point center;
+    for (int d = 0; d < DIM; ++d)
+      center[d] = coordinate(generator);
+    predicates.push_back(ArborX::intersects(Sphere{center, radius(generator)}));
+  }
+
+  // The distances expanded for the candidates must not lose any of the pairs
+  // tested exactly
+  auto make_reference = [&](auto const &values) {
+    std::vector<int> indices;
+    std::vector<int> offsets = {0};
+    for (auto const &predicate : predicates)
+    {
+      for (int i = 0; i < (int)values.size(); ++i)
+      {
+        Box bounding_volume;
+        bounding_volume += values[i];
+        if (predicate(bounding_volume))
+          indices.push_back(i);
+      }
+      offsets.push_back(indices.size());
+    }
+    BOOST_TEST(indices.size() > 0);
+    BOOST_TEST(indices.size() < values.size() * predicates.size());
+    return make_reference_solution<int>(indices, offsets);
+  };
+
+  auto const predicates_view = ArborXTest::toView<DeviceType>(predicates);
+  ARBORX_TEST_QUERY_TREE(space,
+                         (ArborX::BruteForce<MemorySpace, Box>(
+                             space, ArborXTest::toView<DeviceType>(points))),
+                         predicates_view, make_reference(points));
+  ARBORX_TEST_QUERY_TREE(space,
+                         (ArborX::BruteForce<MemorySpace, Box>(
+                             space, ArborXTest::toView<DeviceType>(boxes))),
+                         predicates_view, make_reference(boxes));
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_CachedTree.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(cached_tree, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Predicate = decltype(ArborX::intersects(ArborX::Sphere{}));
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  Tree const bvh(space, points);
+
+  // Small and large spheres, the latter having too many results to be cached
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  std::vector<std::pair<ArborX::Point, float>> spheres;
+  for (int i = 0; i < n; i += 3)
+    spheres.emplace_back(points_host(i), i % 2 == 0 ? 0.2f : 3.f);
+  auto const queries = makeIntersectsSphereQueries<DeviceType>(spheres);
+  auto const reference = query(space, bvh, queries);
+
+  ArborX::Experimental::CachedTree<Tree, Predicate> tree(space, bvh, 1000, 8);
+  BOOST_TEST(tree.size() == n);
+
+  auto cached_query = [&]() {
+    Kokkos::View<int *, MemorySpace> values("Testing::values", 0);
+    Kokkos::View<int *, MemorySpace> offsets("Testing::offsets", 0);
+    tree.query(space, queries, values, offsets);
+    return make_compressed_storage(
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values));
+  };
+
+  BOOST_TEST(cached_query() == reference, tt::per_element());
+  BOOST_TEST(tree.numHits() == 0);
+
+  // Same results from the cache
+  BOOST_TEST(cached_query() == reference, tt::per_element());
+  BOOST_TEST(tree.numHits() > 0);
+  BOOST_TEST(tree.numHits() < (int)spheres.size());
+
+  // Refitting the tree clears the cache
+  tree.refit(space, points);
+  BOOST_TEST(cached_query() == reference, tt::per_element());
+  BOOST_TEST(tree.numHits() == 0);
+}
@@ -158,6 +158,70 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(callback_nearest_predicate, TreeTypeTraits,
 }
 #endif
 
+// Inserts more values than are staged at once for each primitive found
+struct CustomCallbackMultipleInsertions
+{
+  static constexpr int multiplicity = 12;
+  template <typename Query, typename Insert>
+  KOKKOS_FUNCTION void operator()(Query const &, int index,
+                                  Insert const &insert) const
+  {
+    for (int k = 0; k < multiplicity; ++k)
+      insert(multiplicity * index + k);
+  }
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(callback_multiple_insertions, TreeTypeTraits,
+                              TreeTypeTraitsList)
+{
+  using Tree = typename TreeTypeTraits::type;
+  using ExecutionSpace = typename TreeTypeTraits::execution_space;
+  using DeviceType = typename TreeTypeTraits::device_type;
+  using MemorySpace = typename TreeTypeTraits::memory_space;
+  constexpr int multiplicity = CustomCallbackMultipleInsertions::multiplicity;
+
+  ExecutionSpace space;
+
+  auto const tree = make<Tree>(space, {
+                                          {{{0., 0., 0.}}, {{0., 0., 0.}}},
+                                          {{{1., 1., 1.}}, {{1., 1., 1.}}},
+                                          {{{2., 2., 2.}}, {{2., 2., 2.}}},
+                                          {{{3., 3., 3.}}, {{3., 3., 3.}}},
+                                      });
+  auto const predicates = makeIntersectsBoxQueries<DeviceType>({
+      {{{-.5, -.5, -.5}}, {{1.5, 1.5, 1.5}}},
+      {{{5., 5., 5.}}, {{6., 6., 6.}}},
+      static_cast<ArborX::Box>(tree.bounds()),
+  });
+
+  std::vector<int> offsets_ref = {0};
+  std::vector<int> values_ref;
+  for (int n : {2, 0, 4})
+  {
+    for (int i = 0; i < n * multiplicity; ++i)
+      values_ref.push_back(i);
+    offsets_ref.push_back(values_ref.size());
+  }
+
+  // Without buffer, with a buffer too small, and with a large enough buffer
+  for (int buffer_size : {0, 10, 100})
+  {
+    Kokkos::View<int *, MemorySpace> values("Testing::values", 0);
+    Kokkos::View<int *, MemorySpace> offsets("Testing::offsets", 0);
+    ArborX::query(
+        tree, space, predicates, CustomCallbackMultipleInsertions{}, values,
+        offsets,
+        ArborX::Experimental::TraversalPolicy().setBufferSize(buffer_size));
+    BOOST_TEST(make_compressed_storage(
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       offsets),
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       values)) ==
+                   make_compressed_storage(offsets_ref, values_ref),
+               tt::per_element());
+  }
+}
+
 #ifndef ARBORX_TEST_DISABLE_CALLBACK_EARLY_EXIT
 template <class DeviceType>
 struct Experimental_CustomCallbackEarlyExit
@@ -0,0 +1,114 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_CellList.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(cell_list, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Box;
+  using ArborX::Point;
+  using CellList = ArborX::Experimental::CellList<MemorySpace>;
+
+  ExecutionSpace space;
+
+  CellList empty_index;
+  BOOST_TEST(empty_index.empty());
+  ARBORX_TEST_QUERY_TREE(
+      space, empty_index, makeIntersectsSphereQueries<DeviceType>({}),
+      make_reference_solution<int>({}, {0}));
+  ARBORX_TEST_QUERY_TREE(
+      space, empty_index,
+      makeIntersectsSphereQueries<DeviceType>({{{0, 0, 0}, 1}}),
+      make_reference_solution<int>({}, {0, 0}));
+
+  // Points along the x-axis at (i, 0, 0)
+  int const n = 10;
+  std::vector<Point> points;
+  for (int i = 0; i < n; ++i)
+    points.push_back({(float)i, 0, 0});
+
+  CellList index(space, ArborXTest::toView<DeviceType>(points), 2.f);
+  BOOST_TEST(index.size() == n);
+  BOOST_TEST(
+      ArborX::Details::equals(index.bounds(), Box{{0, 0, 0}, {n - 1.f, 0, 0}}));
+  BOOST_TEST(index.extent(0) == 5);
+  BOOST_TEST(index.extent(1) == 1);
+  BOOST_TEST(index.extent(2) == 1);
+
+  // Spheres within a cell, across cells, and outside of the grid
+  ARBORX_TEST_QUERY_TREE(
+      space, index,
+      makeIntersectsSphereQueries<DeviceType>({{{4.5, 0, 0}, 0.6},
+                                               {{2, 1, 0}, 1.5},
+                                               {{-3, 0, 0}, 1},
+                                               {{12, 0, 0}, 3.5},
+                                               {{5, 0, 0}, 100}}),
+      make_reference_solution<int>({4, 5, 1, 2, 3, 9, 0, 1, 2, 3, 4, 5, 6, 7,
+                                    8, 9},
+                                   {0, 2, 5, 5, 6, 16}));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(cell_list_vs_bvh, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Point;
+
+  ExecutionSpace space;
+
+  std::default_random_engine generator(0);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  int const n = 1000;
+  std::vector<Point> points(n);
+  for (auto &point : points)
+    point = {distribution(generator), distribution(generator),
+             distribution(generator)};
+  auto const points_view = ArborXTest::toView<DeviceType>(points);
+
+  ArborX::BVH<MemorySpace> bvh(space, points_view);
+
+  for (float cell_size : {0.05f, 0.2f, 5.f})
+  {
+    ArborX::Experimental::CellList<MemorySpace> index(space, points_view,
+                                                      cell_size);
+
+    // Radii smaller and larger than the cells, including spheres partially
+    // outside of the domain
+    std::vector<std::pair<Point, float>> spheres;
+    for (int i = 0; i < 200; ++i)
+      spheres.push_back({{1.5f * distribution(generator),
+                          1.5f * distribution(generator),
+                          1.5f * distribution(generator)},
+                         0.15f * (i % 4)});
+    auto const predicates = makeIntersectsSphereQueries<DeviceType>(spheres);
+
+    auto const reference = query(space, bvh, predicates);
+    BOOST_TEST(query(space, index, predicates) == reference,
+               tt::per_element());
+  }
+}
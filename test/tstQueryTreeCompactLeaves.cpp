@@ -0,0 +1,105 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_CompactLeafBVH.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+namespace tt = boost::test_tools;
+
+namespace
+{
+// Value much larger than its indexable
+struct Particle
+{
+  ArborX::Point position;
+  int id;
+  float fields[16];
+};
+
+struct GetPosition
+{
+  KOKKOS_FUNCTION ArborX::Point const &operator()(Particle const &p) const
+  {
+    return p.position;
+  }
+};
+
+struct GetId
+{
+  template <typename Predicate, typename OutputFunctor>
+  KOKKOS_FUNCTION void operator()(Predicate const &, Particle const &p,
+                                  OutputFunctor const &out) const
+  {
+    out(p.id);
+  }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(compact_leaves, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree =
+      ArborX::Experimental::CompactLeafBVH<MemorySpace, Particle, GetPosition>;
+
+  ExecutionSpace space;
+
+  Tree empty_tree;
+  BOOST_TEST(empty_tree.empty());
+
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  std::vector<Particle> particles(n);
+  std::vector<std::pair<ArborX::Point, int>> nearest_queries;
+  std::vector<std::pair<ArborX::Point, float>> sphere_queries;
+  for (int i = 0; i < n; ++i)
+  {
+    particles[i].position = points_host(i);
+    particles[i].id = i;
+    if (i % 3 == 0)
+    {
+      nearest_queries.emplace_back(points_host(i), 4);
+      sphere_queries.emplace_back(points_host(i), 0.2f);
+    }
+  }
+
+  Tree const tree(space, ArborXTest::toView<DeviceType>(particles),
+                  GetPosition{});
+  BOOST_TEST(tree.size() == n);
+  BOOST_TEST(tree.values().extent_int(0) == n);
+
+  // Same results as a hierarchy storing the points in its leaves
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+  auto const spatial_predicates =
+      makeIntersectsSphereQueries<DeviceType>(sphere_queries);
+  auto const nearest_predicates =
+      makeNearestQueries<DeviceType>(nearest_queries);
+  BOOST_TEST(query<int>(space, tree, spatial_predicates, GetId{}) ==
+                 query(space, bvh, spatial_predicates),
+             tt::per_element());
+  BOOST_TEST(query<int>(space, tree, nearest_predicates, GetId{}) ==
+                 query(space, bvh, nearest_predicates),
+             tt::per_element());
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_Box.hpp>
+#include <ArborX_ConvexPolytope.hpp>
+#include <ArborX_KDOP.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_Point.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(convex_polytope, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Box;
+  using ArborX::Point;
+  using ArborX::Experimental::ConvexPolytope;
+
+  ExecutionSpace space;
+
+  // Frustum with its apex at the origin, looking along the z-axis with a
+  // field of view of 90 degrees, and clipped between z = 1 and z = 10
+  ConvexPolytope<6> frustum;
+  frustum.add({{0, 0, -1}, -1});
+  frustum.add({{0, 0, 1}, 10});
+  frustum.add({{1, 0, -1}, 0});
+  frustum.add({{-1, 0, -1}, 0});
+  frustum.add({{0, 1, -1}, 0});
+  frustum.add({{0, -1, -1}, 0});
+
+  ConvexPolytope<6> half_space;
+  half_space.add({{-1, 0, 0}, -2.5});
+
+  ConvexPolytope<6> nowhere;
+  nowhere.add({{0, 0, 1}, -1});
+
+  std::vector<decltype(ArborX::intersects(ConvexPolytope<6>{}))> predicates = {
+      ArborX::intersects(frustum), ArborX::intersects(half_space),
+      ArborX::intersects(nowhere)};
+
+  std::vector<Point> points;
+  std::vector<Box> boxes;
+  for (int i = 0; i < 10; ++i)
+    for (int j = 0; j < 10; ++j)
+      for (int k = 0; k < 10; ++k)
+      {
+        Point const p{i - 5.f, j - 5.f, (float)k};
+        points.push_back(p);
+        boxes.push_back({{p[0] - .25f, p[1] - .25f, p[2] - .25f},
+                         {p[0] + .25f, p[1] + .25f, p[2] + .25f}});
+      }
+
+  // The planes skipped below the nodes they contain must not change the
+  // results of testing the leaves against all of them
+  auto make_reference = [&](auto const &values) {
+    std::vector<int> indices;
+    std::vector<int> offsets = {0};
+    for (auto const &polytope : {frustum, half_space, nowhere})
+    {
+      for (int i = 0; i < (int)values.size(); ++i)
+        if (intersects(polytope, values[i]))
+          indices.push_back(i);
+      offsets.push_back(indices.size());
+    }
+    return make_reference_solution<int>(indices, offsets);
+  };
+
+  auto const predicates_view = ArborXTest::toView<DeviceType>(predicates);
+  auto const points_view = ArborXTest::toView<DeviceType>(points);
+  auto const boxes_view = ArborXTest::toView<DeviceType>(boxes);
+
+  ARBORX_TEST_QUERY_TREE(space, ArborX::BVH<MemorySpace>(space, points_view),
+                         predicates_view, make_reference(points));
+  ARBORX_TEST_QUERY_TREE(space, ArborX::BVH<MemorySpace>(space, boxes_view),
+                         predicates_view, make_reference(boxes));
+  using KDOP = ArborX::Experimental::KDOP<14>;
+  ARBORX_TEST_QUERY_TREE(
+      space,
+      (ArborX::BasicBoundingVolumeHierarchy<
+          MemorySpace, ArborX::Details::PairIndexVolume<Box>,
+          ArborX::Details::DefaultIndexableGetter, KDOP>(space, boxes_view)),
+      predicates_view, make_reference(boxes));
+}
@@ -11,6 +11,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
 #include <vector>
 
 #include "Search_UnitTestHelpers.hpp"
@@ -370,6 +371,46 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(not_exceeding_stack_capacity_spatial_predicate,
   BOOST_TEST(KokkosExt::lastElement(space, offset) == n);
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(deep_hierarchy_spatial_predicate, TreeTypeTraits,
+                              TreeTypeTraitsList)
+{
+  using Tree = typename TreeTypeTraits::type;
+  using ExecutionSpace = typename TreeTypeTraits::execution_space;
+  using DeviceType = typename TreeTypeTraits::device_type;
+
+  // Clusters of boxes at exponentially decreasing distances from the origin,
+  // alternating between the axes, yield a very unbalanced hierarchy
+  std::vector<ArborX::Box> boxes;
+  int const num_clusters = 60;
+  int const cluster_size = 8;
+  for (int k = 0; k < num_clusters; ++k)
+  {
+    float const scale = std::ldexp(1.f, -k / 3);
+    for (int j = 0; j < cluster_size; ++j)
+    {
+      ArborX::Point corner{{0.f, 0.f, 0.f}};
+      corner[k % 3] = scale * (1 + .1f * j);
+      ArborX::Point other = corner;
+      other[k % 3] += .05f * scale;
+      boxes.push_back({corner, other});
+    }
+  }
+  int const n = boxes.size();
+  ExecutionSpace space;
+  auto const tree = make<Tree>(space, boxes);
+
+  Kokkos::View<int *, DeviceType> indices("indices", 0);
+  Kokkos::View<int *, DeviceType> offset("offset", 0);
+  // spatial query that is satisfied by all leaves in the tree
+  BOOST_CHECK_NO_THROW(ArborX::query(tree, space,
+                                     makeIntersectsBoxQueries<DeviceType>({
+                                         {},
+                                         {{{0., 0., 0.}}, {{2., 2., 2.}}},
+                                     }),
+                                     indices, offset));
+  BOOST_TEST(KokkosExt::lastElement(space, offset) == n);
+}
+
 #ifndef ARBORX_TEST_DISABLE_NEAREST_QUERY
 BOOST_AUTO_TEST_CASE_TEMPLATE(not_exceeding_stack_capacity_nearest_predicate,
                               TreeTypeTraits, TreeTypeTraitsList)
@@ -0,0 +1,81 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_DoubleBufferedTree.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(double_buffered_tree, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+  auto const instances =
+      Kokkos::Experimental::partition_space(space, std::vector<int>{1, 1});
+  auto const &build_space = instances[0];
+  auto const &query_space = instances[1];
+
+  ArborX::Experimental::DoubleBufferedTree<Tree> trees;
+  BOOST_TEST(trees.empty());
+  BOOST_TEST(!trees.backReady());
+
+  // Frames of different sizes, each one built while the previous one is
+  // searched
+  std::vector<int> const sizes{100, 300, 200};
+  auto const makeFrame = [&](int f) {
+    auto frame = ArborXTest::make_random_cloud<ArborX::Point>(
+        space, sizes[f], 1.f, 1.f, 1.f, f);
+    space.fence();
+    return frame;
+  };
+  auto points = makeFrame(0);
+  trees.build(build_space, points);
+  BOOST_TEST(trees.backReady());
+  trees.swap(build_space, query_space);
+  for (int f = 0; f < (int)sizes.size(); ++f)
+  {
+    auto const points_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+    std::vector<std::pair<ArborX::Point, float>> spheres;
+    for (int i = 0; i < sizes[f]; i += 4)
+      spheres.emplace_back(points_host(i), 0.2f);
+    auto const queries = makeIntersectsSphereQueries<DeviceType>(spheres);
+    auto const reference = query(space, Tree(space, points), queries);
+
+    auto next_points = points;
+    if (f + 1 < (int)sizes.size())
+    {
+      next_points = makeFrame(f + 1);
+      trees.build(build_space, next_points);
+    }
+    BOOST_TEST(trees.size() == sizes[f]);
+    BOOST_TEST(query(query_space, trees, queries) == reference,
+               tt::per_element());
+    if (trees.backReady())
+      trees.swap(build_space, query_space);
+    points = next_points;
+  }
+}
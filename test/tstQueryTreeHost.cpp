@@ -0,0 +1,113 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include <ArborX_HostQuery.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(HostQuery)
+
+namespace tt = boost::test_tools;
+
+// Sorted indices of the values found for each predicate
+template <typename Queries>
+std::vector<std::vector<int>>
+hostQueryResults(ArborX::BVH<Kokkos::HostSpace> const &bvh,
+                 Queries const &queries)
+{
+  using ExecutionSpace = Kokkos::DefaultHostExecutionSpace;
+  int const n = queries.extent(0);
+
+  // The predicates are searched concurrently by the threads of the host
+  std::vector<std::vector<int>> results(n);
+  Kokkos::parallel_for(
+      "Testing::host_queries", Kokkos::RangePolicy<ExecutionSpace>(0, n),
+      [&](int i) {
+        ArborX::Experimental::queryOnHost(
+            bvh, queries(i),
+            [&](auto const &, int index) { results[i].push_back(index); });
+        std::sort(results[i].begin(), results[i].end());
+      });
+  return results;
+}
+
+template <typename Queries>
+std::vector<std::vector<int>>
+batchedQueryResults(ArborX::BVH<Kokkos::HostSpace> const &bvh,
+                    Queries const &queries)
+{
+  using ExecutionSpace = Kokkos::DefaultHostExecutionSpace;
+  int const n = queries.extent(0);
+
+  Kokkos::View<int *, Kokkos::HostSpace> indices("Testing::indices", 0);
+  Kokkos::View<int *, Kokkos::HostSpace> offset("Testing::offset", 0);
+  ArborX::query(bvh, ExecutionSpace{}, queries, indices, offset);
+  std::vector<std::vector<int>> results(n);
+  for (int i = 0; i < n; ++i)
+  {
+    results[i].assign(indices.data() + offset(i),
+                      indices.data() + offset(i + 1));
+    std::sort(results[i].begin(), results[i].end());
+  }
+  return results;
+}
+
+template <typename Queries>
+void checkHostQueries(ArborX::BVH<Kokkos::HostSpace> const &bvh,
+                      Queries const &queries)
+{
+  auto const results = hostQueryResults(bvh, queries);
+  auto const reference = batchedQueryResults(bvh, queries);
+  for (int i = 0; i < (int)queries.extent(0); ++i)
+    BOOST_TEST(results[i] == reference[i], tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(host_query)
+{
+  using ExecutionSpace = Kokkos::DefaultHostExecutionSpace;
+  ExecutionSpace space;
+
+  int const n = 500;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  ArborX::BVH<Kokkos::HostSpace> const bvh(space, points);
+
+  int const n_queries = 100;
+  Kokkos::View<ArborX::Intersects<ArborX::Sphere> *, Kokkos::HostSpace>
+      spatial_queries("Testing::spatial_queries", n_queries);
+  Kokkos::View<ArborX::Nearest<ArborX::Point> *, Kokkos::HostSpace>
+      nearest_queries("Testing::nearest_queries", n_queries);
+  for (int i = 0; i < n_queries; ++i)
+  {
+    spatial_queries(i) = ArborX::intersects(ArborX::Sphere{points(i), 0.1f});
+    nearest_queries(i) = ArborX::nearest(points(i), 1 + i % 10);
+  }
+
+  checkHostQueries(bvh, spatial_queries);
+  checkHostQueries(bvh, nearest_queries);
+
+  // Degenerate hierarchies
+  for (int size : {0, 1})
+  {
+    ArborX::BVH<Kokkos::HostSpace> const small_bvh(
+        space, Kokkos::subview(points, Kokkos::make_pair(0, size)));
+    checkHostQueries(small_bvh, spatial_queries);
+    checkHostQueries(small_bvh, nearest_queries);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,107 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_InstancePartitionedBVH.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+namespace tt = boost::test_tools;
+
+// Output by the callback in place of the index of the primitive
+struct TenTimesIndex
+{
+  template <typename Predicate, typename OutputFunctor>
+  KOKKOS_FUNCTION void operator()(Predicate const &, int index,
+                                  OutputFunctor const &out) const
+  {
+    out(10 * index);
+  }
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(instance_partitioned_bvh_vs_bvh, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Point;
+
+  ExecutionSpace space;
+
+  std::default_random_engine generator(0);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  int const n = 1000;
+  std::vector<Point> points(n);
+  for (auto &point : points)
+    point = {distribution(generator), distribution(generator),
+             distribution(generator)};
+  auto const points_view = ArborXTest::toView<DeviceType>(points);
+
+  std::vector<std::pair<Point, float>> spheres;
+  for (int i = 0; i < 200; ++i)
+    spheres.push_back({{1.5f * distribution(generator),
+                        1.5f * distribution(generator),
+                        1.5f * distribution(generator)},
+                       0.15f * (i % 4)});
+  auto const predicates = makeIntersectsSphereQueries<DeviceType>(spheres);
+
+  ArborX::BVH<MemorySpace> bvh(space, points_view);
+  auto const reference = query(space, bvh, predicates);
+
+  auto const query_partitioned = [&](auto const &instances, auto const &tree,
+                                     auto const &...callback) {
+    Kokkos::View<int *, DeviceType> values("Testing::values", 0);
+    Kokkos::View<int *, DeviceType> offsets("Testing::offsets", 0);
+    tree.query(instances, predicates, callback..., values, offsets);
+    return make_compressed_storage(
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offsets),
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, values));
+  };
+
+  // More parts than primitives leaves some of them empty
+  for (int num_parts : {1, 3, 8})
+  {
+    std::vector<ExecutionSpace> instances;
+    for (auto const &instance : Kokkos::Experimental::partition_space(
+             space, std::vector<int>(num_parts, 1)))
+      instances.push_back(instance);
+    ArborX::Experimental::InstancePartitionedBVH<MemorySpace> tree(
+        instances, points_view);
+    BOOST_TEST(tree.size() == n);
+    BOOST_TEST(tree.numberOfParts() == num_parts);
+    BOOST_TEST(query_partitioned(instances, tree) == reference,
+               tt::per_element());
+  }
+
+  // The output of the callback is stored in place of the indices
+  std::vector<ExecutionSpace> instances(2, space);
+  ArborX::Experimental::InstancePartitionedBVH<MemorySpace> tree(
+      instances, points_view);
+  BOOST_TEST(query_partitioned(instances, tree, TenTimesIndex{}) ==
+                 query<int>(space, bvh, predicates, TenTimesIndex{}),
+             tt::per_element());
+
+  ArborX::Experimental::InstancePartitionedBVH<MemorySpace> empty_tree;
+  BOOST_TEST(empty_tree.empty());
+  BOOST_TEST(query_partitioned(instances, empty_tree) ==
+                 make_reference_solution<int>(
+                     {}, std::vector<int>(spheres.size() + 1, 0)),
+             tt::per_element());
+}
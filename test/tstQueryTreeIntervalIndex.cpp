@@ -0,0 +1,125 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_IntervalIndex.hpp>
+#include <ArborX_Predicates.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+namespace tt = boost::test_tools;
+
+using Interval = ArborX::ExperimentalHyperGeometry::Box<1>;
+
+template <typename DeviceType>
+auto makeIntersectsIntervalQueries(std::vector<Interval> const &intervals)
+{
+  std::vector<decltype(ArborX::intersects(Interval{}))> queries;
+  for (auto const &interval : intervals)
+    queries.push_back(ArborX::intersects(interval));
+  return ArborXTest::toView<DeviceType>(queries);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(interval_index, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Point = ArborX::ExperimentalHyperGeometry::Point<1>;
+  using IntervalIndex = ArborX::Experimental::IntervalIndex<MemorySpace>;
+
+  ExecutionSpace space;
+
+  IntervalIndex empty_index;
+  BOOST_TEST(empty_index.empty());
+  ARBORX_TEST_QUERY_TREE(
+      space, empty_index,
+      makeIntersectsIntervalQueries<DeviceType>({{{0}, {1}}}),
+      make_reference_solution<int>({}, {0, 0}));
+
+  // Time stamps listed out of order, with a duplicate
+  IntervalIndex points(
+      space, ArborXTest::toView<DeviceType>(
+                 std::vector<Point>{{{3}}, {{1}}, {{4}}, {{1}}, {{5}}, {{9}}}));
+  BOOST_TEST(points.size() == 6);
+  BOOST_TEST(points.bounds().minCorner()[0] == 1);
+  BOOST_TEST(points.bounds().maxCorner()[0] == 9);
+  ARBORX_TEST_QUERY_TREE(
+      space, points,
+      makeIntersectsIntervalQueries<DeviceType>(
+          {{{0}, {1}}, {{1.5}, {4}}, {{6}, {8}}, {{9}, {12}}, {{-5}, {20}}}),
+      make_reference_solution<int>({1, 3, 0, 2, 5, 0, 1, 2, 3, 4, 5},
+                                   {0, 2, 4, 4, 5, 11}));
+
+  // A long time window starting first has to be found past the ones nested in
+  // it
+  IntervalIndex windows(
+      space, ArborXTest::toView<DeviceType>(std::vector<Interval>{
+                 {{2}, {3}}, {{0}, {10}}, {{4}, {5}}, {{11}, {12}}}));
+  ARBORX_TEST_QUERY_TREE(
+      space, windows,
+      makeIntersectsIntervalQueries<DeviceType>(
+          {{{6}, {7}}, {{3}, {4}}, {{10}, {11}}, {{13}, {14}}}),
+      make_reference_solution<int>({1, 0, 1, 2, 1, 3}, {0, 1, 4, 6, 6}));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(interval_index_vs_brute_force, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  std::default_random_engine generator(0);
+  std::uniform_real_distribution<float> start(0.f, 100.f);
+  std::exponential_distribution<float> duration(1.f);
+  auto const make_intervals = [&](int n) {
+    std::vector<Interval> intervals(n);
+    for (auto &interval : intervals)
+    {
+      float const t = start(generator);
+      interval = {{t}, {t + duration(generator)}};
+    }
+    return intervals;
+  };
+
+  auto const intervals = make_intervals(1000);
+  auto const windows = make_intervals(200);
+
+  std::vector<int> offsets = {0};
+  std::vector<int> indices;
+  for (auto const &window : windows)
+  {
+    for (int i = 0; i < (int)intervals.size(); ++i)
+      if (std::max(window.minCorner()[0], intervals[i].minCorner()[0]) <=
+          std::min(window.maxCorner()[0], intervals[i].maxCorner()[0]))
+        indices.push_back(i);
+    offsets.push_back(indices.size());
+  }
+
+  ArborX::Experimental::IntervalIndex<MemorySpace> index(
+      space, ArborXTest::toView<DeviceType>(intervals));
+  BOOST_TEST(query(space, index,
+                   makeIntersectsIntervalQueries<DeviceType>(windows)) ==
+                 make_reference_solution(indices, offsets),
+             tt::per_element());
+}
@@ -261,4 +261,49 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(structured_grid, TreeTypeTraits,
                          make_reference_solution(indices_ref, offset_ref));
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(structure_of_arrays, TreeTypeTraits,
+                              TreeTypeTraitsList)
+{
+  using Tree = typename TreeTypeTraits::type;
+  using ExecutionSpace = typename TreeTypeTraits::execution_space;
+  using DeviceType = typename TreeTypeTraits::device_type;
+
+  // Nodes of a structured grid with their coordinates in separate views
+  int const nx = 11;
+  int const ny = 7;
+  int const nz = 5;
+  int const n = nx * ny * nz;
+  Kokkos::View<float *, DeviceType> x("x", n);
+  Kokkos::View<float *, DeviceType> y("y", n);
+  Kokkos::View<float *, DeviceType> z("z", n);
+  Kokkos::parallel_for(
+      "fill_coordinates", Kokkos::RangePolicy<ExecutionSpace>(0, n),
+      KOKKOS_LAMBDA(int l) {
+        x(l) = l % nx;
+        y(l) = (l / nx) % ny;
+        z(l) = l / (nx * ny);
+      });
+
+  Tree const tree(ExecutionSpace{},
+                  ArborX::Experimental::makeStructureOfArrays(x, y, z));
+
+  Kokkos::View<decltype(ArborX::intersects(ArborX::Box{})) *, DeviceType>
+      queries("queries", n);
+  Kokkos::parallel_for(
+      "fill_queries", Kokkos::RangePolicy<ExecutionSpace>(0, n),
+      KOKKOS_LAMBDA(int l) {
+        ArborX::Point const p{{x(l), y(l), z(l)}};
+        queries(l) = ArborX::intersects(
+            ArborX::Box{{{p[0] - .25f, p[1] - .25f, p[2] - .25f}},
+                        {{p[0] + .25f, p[1] + .25f, p[2] + .25f}}});
+      });
+
+  std::vector<int> offset_ref(n + 1);
+  std::vector<int> indices_ref(n);
+  std::iota(offset_ref.begin(), offset_ref.end(), 0);
+  std::iota(indices_ref.begin(), indices_ref.end(), 0);
+  ARBORX_TEST_QUERY_TREE(ExecutionSpace{}, tree, queries,
+                         make_reference_solution(indices_ref, offset_ref));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,66 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_MixedLeafBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(mixed_leaves, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::Experimental::MixedLeafBVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  Tree empty_tree;
+  BOOST_TEST(empty_tree.empty());
+
+  // Mostly points, every fifth one being grown into a box
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  std::vector<ArborX::Box> boxes(n);
+  std::vector<std::pair<ArborX::Point, float>> spheres;
+  for (int i = 0; i < n; ++i)
+  {
+    auto const &p = points_host(i);
+    float const h = (i % 5 == 0 ? 0.1f : 0.f);
+    boxes[i] = {{p[0] - h, p[1] - h, p[2] - h}, {p[0] + h, p[1] + h, p[2] + h}};
+    if (i % 3 == 0)
+      spheres.emplace_back(p, 0.2f);
+  }
+  auto const boxes_view = ArborXTest::toView<DeviceType>(boxes);
+
+  Tree const tree(space, boxes_view);
+  BOOST_TEST(tree.size() == n);
+  BOOST_TEST(tree.numberOfPoints() == n - n / 5);
+
+  // Same results as a hierarchy storing boxes in all its leaves
+  ArborX::BVH<MemorySpace> const bvh(space, boxes_view);
+  auto const queries = makeIntersectsSphereQueries<DeviceType>(spheres);
+  BOOST_TEST(query(space, tree, queries) == query(space, bvh, queries),
+             tt::per_element());
+}
@@ -0,0 +1,66 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_HyperSphere.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(float_bounding_volumes_over_double_points,
+                              DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Point = ArborX::ExperimentalHyperGeometry::Point<3, double>;
+  using Sphere = ArborX::ExperimentalHyperGeometry::Sphere<3, double>;
+  using Box = ArborX::ExperimentalHyperGeometry::Box<3, float>;
+
+  ExecutionSpace space;
+
+  // Points closer to each other than the single precision spacing around 1,
+  // so that the bounding volumes of the tree cannot tell them apart
+  double const h = 0x1p-30;
+  std::vector<Point> points;
+  for (int i = 0; i < 10; ++i)
+    points.push_back({1 + i * h, 0, 0});
+
+  std::vector<decltype(ArborX::intersects(Sphere{}))> spatial_predicates = {
+      ArborX::intersects(Sphere{{1 + 4 * h, 0, 0}, 1.5 * h}),
+      ArborX::intersects(Sphere{{1 + 9.5 * h, 0, 0}, .6 * h})};
+  std::vector<decltype(ArborX::nearest(Point{}))> nearest_predicates = {
+      ArborX::nearest(Point{1 + 7.2 * h, 0, 0}, 1),
+      ArborX::nearest(Point{1 - 3 * h, 0, 0}, 1)};
+
+  using Value = ArborX::Details::PairIndexVolume<Point>;
+  ArborX::BasicBoundingVolumeHierarchy<MemorySpace, Value,
+                                       ArborX::Details::DefaultIndexableGetter,
+                                       Box> const
+      tree(space, ArborXTest::toView<DeviceType>(points));
+
+  // The bounding volumes are rounded outwards, and the points are tested in
+  // double precision at the leaves
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, ArborXTest::toView<DeviceType>(spatial_predicates),
+      make_reference_solution<int>({3, 4, 5, 9}, {0, 3, 4}));
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, ArborXTest::toView<DeviceType>(nearest_predicates),
+      make_reference_solution<int>({7, 0}, {0, 1, 2}));
+}
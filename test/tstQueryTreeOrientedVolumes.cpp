@@ -0,0 +1,82 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperCapsule.hpp>
+#include <ArborX_HyperOBB.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+using Point = ArborX::ExperimentalHyperGeometry::Point<3>;
+using Box = ArborX::ExperimentalHyperGeometry::Box<3>;
+using OBB = ArborX::ExperimentalHyperGeometry::OBB<3>;
+using Capsule = ArborX::ExperimentalHyperGeometry::Capsule<3>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(intersects_oriented_volumes, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  // 5x5 grid of points in the z = 0 plane, point (i, j) having index 5i + j
+  std::vector<Point> points;
+  for (int i = 0; i < 5; ++i)
+    for (int j = 0; j < 5; ++j)
+      points.push_back({(float)i, (float)j, 0});
+
+  float const s = 1 / std::sqrt(2.f);
+  // Thin box along the diagonal i == j
+  OBB const diagonal{
+      {2, 2, 0}, {{Point{s, s, 0}, Point{-s, s, 0}, Point{0, 0, 1}}},
+      {3.2f, .1f, .1f}};
+  // Thin capsule along the antidiagonal i + j == 4
+  Capsule const antidiagonal{{0, 4, 0}, {4, 0, 0}, .1f};
+
+  std::vector<decltype(ArborX::intersects(diagonal))> obb_predicates = {
+      ArborX::intersects(diagonal)};
+  std::vector<decltype(ArborX::intersects(antidiagonal))>
+      capsule_predicates = {ArborX::intersects(antidiagonal)};
+
+  auto check = [&](auto const &tree) {
+    ARBORX_TEST_QUERY_TREE(
+        space, tree, ArborXTest::toView<DeviceType>(obb_predicates),
+        make_reference_solution<int>({0, 6, 12, 18, 24}, {0, 5}));
+    ARBORX_TEST_QUERY_TREE(
+        space, tree, ArborXTest::toView<DeviceType>(capsule_predicates),
+        make_reference_solution<int>({4, 8, 12, 16, 20}, {0, 5}));
+  };
+
+  using Value = ArborX::Details::PairIndexVolume<Point>;
+  using IndexableGetter = ArborX::Details::DefaultIndexableGetter;
+  auto const points_view = ArborXTest::toView<DeviceType>(points);
+  check(ArborX::BasicBoundingVolumeHierarchy<MemorySpace, Value,
+                                             IndexableGetter, Box>(
+      space, points_view));
+  check(ArborX::BasicBoundingVolumeHierarchy<MemorySpace, Value,
+                                             IndexableGetter, OBB>(
+      space, points_view));
+  check(ArborX::BasicBoundingVolumeHierarchy<MemorySpace, Value,
+                                             IndexableGetter, Capsule>(
+      space, points_view));
+}
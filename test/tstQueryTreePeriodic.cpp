@@ -0,0 +1,70 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_Box.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_Periodic.hpp>
+#include <ArborX_Point.hpp>
+#include <ArborX_Sphere.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(periodic, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Box;
+  using ArborX::Point;
+  using ArborX::Sphere;
+  using ArborX::Experimental::Periodic;
+
+  ExecutionSpace space;
+
+  // Points along the x-axis at (i + 0.5, 0, 0) in a periodic domain of side 10
+  int const n = 10;
+  std::vector<Point> points;
+  for (int i = 0; i < n; ++i)
+    points.push_back({i + .5f, 0, 0});
+  Box const domain{{0, 0, 0}, {10, 10, 10}};
+
+  ArborX::BVH<MemorySpace> tree(space, ArborXTest::toView<DeviceType>(points));
+
+  // Spheres wrapping around the domain along one and several dimensions
+  std::vector<decltype(ArborX::intersects(Periodic<Sphere>{}))> spheres = {
+      ArborX::intersects(Periodic{Sphere{{0, 0, 0}, 1}, domain}),
+      ArborX::intersects(Periodic{Sphere{{5, 9.8, .1}, .6}, domain}),
+      ArborX::intersects(Periodic{Sphere{{5, 5, 5}, 1}, domain})};
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, ArborXTest::toView<DeviceType>(spheres),
+      make_reference_solution<int>({0, 9, 4, 5}, {0, 2, 4, 4}));
+
+  std::vector<decltype(ArborX::intersects(Periodic<Box>{}))> boxes = {
+      ArborX::intersects(Periodic{Box{{9, -1, -1}, {11, 1, 1}}, domain}),
+      ArborX::intersects(Periodic{Box{{-4, 9, 9}, {-2, 11, 11}}, domain})};
+  ARBORX_TEST_QUERY_TREE(space, tree, ArborXTest::toView<DeviceType>(boxes),
+                         make_reference_solution<int>({0, 9, 6, 7}, {0, 2, 4}));
+
+  // The nearest neighbors include the images across the boundary
+  std::vector<decltype(ArborX::nearest(Periodic<Point>{}))> nearest = {
+      ArborX::nearest(Periodic{Point{.2, 0, 0}, domain}, 3),
+      ArborX::nearest(Periodic{Point{9.9, 10, -10}, domain}, 2)};
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, ArborXTest::toView<DeviceType>(nearest),
+      make_reference_solution<int>({0, 1, 9, 0, 9}, {0, 3, 5}));
+}
@@ -11,10 +11,12 @@
 
 #include "ArborXTest_StdVectorToKokkosView.hpp"
 #include <ArborX.hpp>
+#include <ArborX_IndexedTriangles.hpp>
 #include <ArborX_Ray.hpp>
 
 #include <boost/test/unit_test.hpp>
 
+#include <cstdlib> // abs
 #include <numeric> //iota
 #include <vector>
 
@@ -298,4 +300,286 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(single_leaf_tree_ordered_spatial_predicate,
                          make_reference_solution<int>({0}, {0, 1, 1}));
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(closest_hit_ordered_spatial_predicate,
+                              DeviceType, ARBORX_TEST_DEVICE_TYPES)
+{
+  using MemorySpace = typename DeviceType::memory_space;
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+  using ArborX::Experimental::ordered_intersects;
+  using ArborX::Experimental::Ray;
+
+  std::vector<ArborX::Box> boxes;
+  int const n = 10;
+  for (int i = 0; i < n; ++i)
+    boxes.push_back({{{(float)i, (float)i, (float)i}},
+                     {{(float)i + 1, (float)i + 1, (float)i + 1}}});
+  auto const tree = make<Tree>(ExecutionSpace{}, boxes);
+
+  std::vector<Ray> const rays = {
+      {{0, 0, 0}, {1, 1, 1}},
+      {{(float)n, (float)n, (float)n}, {-1, -1, -1}},
+      {{-1, -1, -1}, {-1, -1, -1}},
+  };
+  Kokkos::View<decltype(ordered_intersects(Ray{}, 1)) *, DeviceType> queries(
+      "Testing::closest_hit_predicates", rays.size());
+  auto queries_host = Kokkos::create_mirror_view(queries);
+  for (int i = 0; i < (int)rays.size(); ++i)
+    queries_host(i) = ordered_intersects(rays[i], 1);
+  Kokkos::deep_copy(queries, queries_host);
+
+  ARBORX_TEST_QUERY_TREE(
+      ExecutionSpace{}, tree, queries,
+      make_reference_solution<int>({0, n - 1}, {0, 1, 2, 2}));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ray_triangle_mesh, DeviceType,
+                              ARBORX_TEST_DEVICE_TYPES)
+{
+  using MemorySpace = typename DeviceType::memory_space;
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using Point = ArborX::ExperimentalHyperGeometry::Point<3>;
+  using Triangle = ArborX::ExperimentalHyperGeometry::Triangle<3>;
+  using Tree = ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<Triangle>>;
+  using ArborX::Experimental::ordered_intersects;
+  using ArborX::Experimental::Ray;
+
+  ExecutionSpace space;
+
+  // Triangles in the planes x = i, covering the lower half of [0, 1]^2 in y
+  // and z
+  std::vector<Triangle> triangles;
+  int const n = 10;
+  for (int i = 0; i < n; ++i)
+  {
+    auto const x = (float)i;
+    triangles.push_back({Point{x, 0, 0}, Point{x, 1, 0}, Point{x, 0, 1}});
+  }
+  Tree const tree(space, ArborXTest::toView<DeviceType>(triangles, "mesh"));
+
+  std::vector<Ray> const rays = {
+      {{-1, .25, .25}, {1, 0, 0}},
+      {{(float)n, .25, .25}, {-1, 0, 0}},
+      {{-1, .75, .75}, {1, 0, 0}},
+  };
+  Kokkos::View<decltype(ArborX::intersects(Ray{})) *, DeviceType>
+      intersects_queries("Testing::intersects_ray_predicates", rays.size());
+  Kokkos::View<decltype(ordered_intersects(Ray{}, 1)) *, DeviceType>
+      closest_hit_queries("Testing::closest_hit_predicates", rays.size());
+  auto intersects_queries_host = Kokkos::create_mirror_view(intersects_queries);
+  auto closest_hit_queries_host =
+      Kokkos::create_mirror_view(closest_hit_queries);
+  for (int i = 0; i < (int)rays.size(); ++i)
+  {
+    intersects_queries_host(i) = ArborX::intersects(rays[i]);
+    closest_hit_queries_host(i) = ordered_intersects(rays[i], 1);
+  }
+  Kokkos::deep_copy(intersects_queries, intersects_queries_host);
+  Kokkos::deep_copy(closest_hit_queries, closest_hit_queries_host);
+
+  std::vector<int> all(n);
+  std::iota(all.begin(), all.end(), 0);
+  auto through_all = all;
+  through_all.insert(through_all.end(), all.begin(), all.end());
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, intersects_queries,
+      make_reference_solution<int>(through_all, {0, n, 2 * n, 2 * n}));
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, closest_hit_queries,
+      make_reference_solution<int>({0, n - 1}, {0, 1, 2, 2}));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ray_sphere_primitives, DeviceType,
+                              ARBORX_TEST_DEVICE_TYPES)
+{
+  using MemorySpace = typename DeviceType::memory_space;
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using Tree = ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<ArborX::Sphere>>;
+  using ArborX::Experimental::ordered_intersects;
+  using ArborX::Experimental::Ray;
+
+  ExecutionSpace space;
+
+  // Spheres along the x axis, the kind of primitives a fixed-radius search
+  // is cast onto rays against
+  std::vector<ArborX::Sphere> spheres;
+  int const n = 10;
+  for (int i = 0; i < n; ++i)
+    spheres.push_back({{(float)i, 0, 0}, .25f});
+  Tree const tree(space, ArborXTest::toView<DeviceType>(spheres, "spheres"));
+
+  std::vector<Ray> const rays = {
+      {{-1, 0, 0}, {1, 0, 0}},
+      {{(float)n, .1, 0}, {-1, 0, 0}},
+      {{-1, .5, 0}, {1, 0, 0}},
+      {{3, -1, 0}, {0, 1, 0}},
+  };
+  Kokkos::View<decltype(ArborX::intersects(Ray{})) *, DeviceType>
+      intersects_queries("Testing::intersects_ray_predicates", rays.size());
+  Kokkos::View<decltype(ordered_intersects(Ray{}, 1)) *, DeviceType>
+      closest_hit_queries("Testing::closest_hit_predicates", rays.size());
+  auto intersects_queries_host = Kokkos::create_mirror_view(intersects_queries);
+  auto closest_hit_queries_host =
+      Kokkos::create_mirror_view(closest_hit_queries);
+  for (int i = 0; i < (int)rays.size(); ++i)
+  {
+    intersects_queries_host(i) = ArborX::intersects(rays[i]);
+    closest_hit_queries_host(i) = ordered_intersects(rays[i], 1);
+  }
+  Kokkos::deep_copy(intersects_queries, intersects_queries_host);
+  Kokkos::deep_copy(closest_hit_queries, closest_hit_queries_host);
+
+  std::vector<int> all(n);
+  std::iota(all.begin(), all.end(), 0);
+  auto through_all = all;
+  through_all.insert(through_all.end(), all.begin(), all.end());
+  through_all.push_back(3);
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, intersects_queries,
+      make_reference_solution<int>(through_all,
+                                   {0, n, 2 * n, 2 * n, 2 * n + 1}));
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, closest_hit_queries,
+      make_reference_solution<int>({0, n - 1, 3}, {0, 1, 2, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ray_indexed_triangle_mesh, DeviceType,
+                              ARBORX_TEST_DEVICE_TYPES)
+{
+  using MemorySpace = typename DeviceType::memory_space;
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using Point = ArborX::ExperimentalHyperGeometry::Point<3>;
+  using ArborX::Experimental::CompactIndexedTriangle;
+  using ArborX::Experimental::IndexedTriangle;
+  using ArborX::Experimental::ordered_intersects;
+  using ArborX::Experimental::Ray;
+  using Getter = ArborX::Experimental::IndexedTriangleGetter<MemorySpace>;
+
+  ExecutionSpace space;
+
+  // Same triangles as above, given by the indices of their vertices and
+  // listed in reverse order, so that their index differs from their position
+  std::vector<Point> vertices;
+  std::vector<IndexedTriangle> triangles;
+  int const n = 10;
+  for (int i = 0; i < n; ++i)
+  {
+    auto const x = (float)i;
+    vertices.push_back({x, 0, 0});
+    vertices.push_back({x, 1, 0});
+    vertices.push_back({x, 0, 1});
+  }
+  for (int i = n - 1; i >= 0; --i)
+  {
+    unsigned int const v = 3 * i;
+    triangles.push_back({(unsigned int)i, {v, v + 1, v + 2}});
+  }
+  auto const vertices_view =
+      ArborXTest::toView<DeviceType>(vertices, "Test::vertices");
+  auto const triangles_view =
+      ArborXTest::toView<DeviceType>(triangles, "Test::triangles");
+
+  std::vector<Ray> const rays = {
+      {{-1, .25, .25}, {1, 0, 0}},
+      {{(float)n, .25, .25}, {-1, 0, 0}},
+      {{-1, .75, .75}, {1, 0, 0}},
+  };
+  Kokkos::View<decltype(ArborX::intersects(Ray{})) *, DeviceType>
+      intersects_queries("Testing::intersects_ray_predicates", rays.size());
+  Kokkos::View<decltype(ordered_intersects(Ray{}, 1)) *, DeviceType>
+      closest_hit_queries("Testing::closest_hit_predicates", rays.size());
+  auto intersects_queries_host = Kokkos::create_mirror_view(intersects_queries);
+  auto closest_hit_queries_host =
+      Kokkos::create_mirror_view(closest_hit_queries);
+  for (int i = 0; i < (int)rays.size(); ++i)
+  {
+    intersects_queries_host(i) = ArborX::intersects(rays[i]);
+    closest_hit_queries_host(i) = ordered_intersects(rays[i], 1);
+  }
+  Kokkos::deep_copy(intersects_queries, intersects_queries_host);
+  Kokkos::deep_copy(closest_hit_queries, closest_hit_queries_host);
+
+  std::vector<int> all(n);
+  std::iota(all.begin(), all.end(), 0);
+  auto through_all = all;
+  through_all.insert(through_all.end(), all.begin(), all.end());
+
+  using Tree = ArborX::BasicBoundingVolumeHierarchy<MemorySpace,
+                                                    IndexedTriangle, Getter>;
+  Tree const tree(space, triangles_view, Getter{vertices_view});
+  BOOST_TEST((int)tree.size() == n);
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, intersects_queries,
+      make_reference_solution<int>(through_all, {0, n, 2 * n, 2 * n}));
+  ARBORX_TEST_QUERY_TREE(
+      space, tree, closest_hit_queries,
+      make_reference_solution<int>({0, n - 1}, {0, 1, 2, 2}));
+
+  using CompactTree =
+      ArborX::BasicBoundingVolumeHierarchy<MemorySpace, CompactIndexedTriangle,
+                                           Getter>;
+  CompactTree const compact_tree(
+      space,
+      ArborX::Experimental::compressIndexedTriangles(space, triangles_view),
+      Getter{vertices_view});
+  BOOST_TEST((int)compact_tree.size() == n);
+  ARBORX_TEST_QUERY_TREE(
+      space, compact_tree, intersects_queries,
+      make_reference_solution<int>(through_all, {0, n, 2 * n, 2 * n}));
+  ARBORX_TEST_QUERY_TREE(
+      space, compact_tree, closest_hit_queries,
+      make_reference_solution<int>({0, n - 1}, {0, 1, 2, 2}));
+
+  // Offsets to the other vertices must fit in 16 bits
+  std::vector<IndexedTriangle> far_apart = {{0, {0, 1, 40000}}};
+  BOOST_CHECK_THROW(
+      ArborX::Experimental::compressIndexedTriangles(
+          space, ArborXTest::toView<DeviceType>(far_apart, "Test::far_apart")),
+      ArborX::SearchException);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ray_predicate_sorting, DeviceType,
+                              ARBORX_TEST_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Experimental::Ray;
+
+  ExecutionSpace space;
+
+  // Rays going both ways from the same few origins are ordered by direction
+  // as well as by origin
+  std::vector<Ray> rays;
+  for (int i = 0; i < 4; ++i)
+  {
+    auto const x = (float)(i / 2);
+    rays.push_back({{x, 0, 0}, {i % 2 == 0 ? 1.f : -1.f, 0, 0}});
+  }
+  rays.push_back({{0, 0, 0}, {1, 0, 0}});
+  rays.push_back({{0, 0, 0}, {-1, 0, 0}});
+  Kokkos::View<decltype(ArborX::intersects(Ray{})) *, DeviceType> queries(
+      "Testing::intersects_ray_predicates", rays.size());
+  auto queries_host = Kokkos::create_mirror_view(queries);
+  for (int i = 0; i < (int)rays.size(); ++i)
+    queries_host(i) = ArborX::intersects(rays[i]);
+  Kokkos::deep_copy(queries, queries_host);
+
+  ArborX::ExperimentalHyperGeometry::Box<3> const scene_bounding_box{
+      {0, -1, -1}, {1, 1, 1}};
+  auto const permutation =
+      ArborX::Details::BatchedQueries<DeviceType>::sortPredicates(
+          space, false, scene_bounding_box, queries);
+  auto const permutation_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, permutation);
+  BOOST_TEST(permutation_host.size() == rays.size());
+
+  // The rays from the first origin going the same way are next to each other
+  std::vector<int> positions(rays.size());
+  for (int i = 0; i < (int)rays.size(); ++i)
+    positions[permutation_host(i)] = i;
+  BOOST_TEST(std::abs(positions[0] - positions[4]) == 1);
+  BOOST_TEST(std::abs(positions[1] - positions[5]) == 1);
+}
@@ -0,0 +1,81 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_HyperBox.hpp>
+#include <ArborX_HyperPoint.hpp>
+#include <ArborX_HyperSphere.hpp>
+#include <ArborX_LinearBVH.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(sphere_bounding_volume_high_dimension,
+                              DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  constexpr int DIM = 12;
+  using Point = ArborX::ExperimentalHyperGeometry::Point<DIM>;
+  using Sphere = ArborX::ExperimentalHyperGeometry::Sphere<DIM>;
+  using Box = ArborX::ExperimentalHyperGeometry::Box<DIM>;
+
+  ExecutionSpace space;
+
+  std::default_random_engine generator(0);
+  std::uniform_real_distribution<float> coordinate(0, 1);
+
+  std::vector<Point> points(500);
+  for (auto &point : points)
+    for (int d = 0; d < DIM; ++d)
+      point[d] = coordinate(generator);
+
+  std::vector<decltype(ArborX::intersects(Sphere{}))> spatial_predicates;
+  std::vector<decltype(ArborX::nearest(Point{}))> nearest_predicates;
+  for (int i = 0; i < 50; ++i)
+  {
+    Point center;
+    for (int d = 0; d < DIM; ++d)
+      center[d] = coordinate(generator);
+    spatial_predicates.push_back(ArborX::intersects(Sphere{center, .8f}));
+    nearest_predicates.push_back(ArborX::nearest(center, 1 + i % 10));
+  }
+
+  using Value = ArborX::Details::PairIndexVolume<Point>;
+  using IndexableGetter = ArborX::Details::DefaultIndexableGetter;
+  auto const points_view = ArborXTest::toView<DeviceType>(points);
+  ArborX::BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
+                                       Box> const box_tree(space, points_view);
+  ArborX::BasicBoundingVolumeHierarchy<MemorySpace, Value, IndexableGetter,
+                                       Sphere> const
+      sphere_tree(space, points_view);
+
+  // The root sphere contains all the points
+  for (auto const &point : points)
+    BOOST_TEST(ArborX::Details::intersects(point, sphere_tree.bounds()));
+
+  // Both hierarchies are exact, only their pruning differs
+  auto const spatial_predicates_view =
+      ArborXTest::toView<DeviceType>(spatial_predicates);
+  ARBORX_TEST_QUERY_TREE(space, sphere_tree, spatial_predicates_view,
+                         query(space, box_tree, spatial_predicates_view));
+  auto const nearest_predicates_view =
+      ArborXTest::toView<DeviceType>(nearest_predicates);
+  ARBORX_TEST_QUERY_TREE(space, sphere_tree, nearest_predicates_view,
+                         query(space, box_tree, nearest_predicates_view));
+}
@@ -0,0 +1,79 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_Box.hpp>
+#include <ArborX_KDOP.hpp>
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_SweptBox.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(swept_box_and_segment, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Box;
+  using ArborX::Experimental::ordered_intersects;
+  using ArborX::Experimental::Segment;
+  using ArborX::Experimental::SweptBox;
+
+  ExecutionSpace space;
+
+  // Unit boxes along the x-axis, box i spanning [2i, 2i + 1]
+  int const n = 10;
+  std::vector<Box> boxes;
+  for (int i = 0; i < n; ++i)
+    boxes.push_back({{2.f * i, 0, 0}, {2.f * i + 1, 1, 1}});
+
+  Box const moving{{-2, .25, .25}, {-1, .75, .75}};
+
+  std::vector<decltype(ArborX::intersects(SweptBox{}))> spatial_predicates = {
+      ArborX::intersects(SweptBox{moving, {4.5, 0, 0}}),
+      ArborX::intersects(SweptBox{moving, {4.5, 4, 0}}),
+      ArborX::intersects(Segment{{3.5, .5, .5}, {8.5, .5, .5}})};
+
+  // The earliest contacts are found first
+  std::vector<decltype(ordered_intersects(SweptBox{}))> ordered_predicates = {
+      ordered_intersects(SweptBox{moving, {30, 0, 0}}, 1),
+      ordered_intersects(SweptBox{moving, {30, 0, 0}}, 3),
+      ordered_intersects(SweptBox{moving, {-30, 0, 0}}, 3),
+      ordered_intersects(SweptBox{{{30, 0, 0}, {31, 1, 1}}, {-40, 0, 0}}, 2)};
+  std::vector<decltype(ordered_intersects(Segment{}))> ordered_segments = {
+      ordered_intersects(Segment{{5.5, .5, .5}, {-1, .5, .5}}, 1)};
+
+  auto check = [&](auto const &tree) {
+    ARBORX_TEST_QUERY_TREE(
+        space, tree, ArborXTest::toView<DeviceType>(spatial_predicates),
+        make_reference_solution<int>({0, 1, 2, 3, 4}, {0, 2, 2, 5}));
+    ARBORX_TEST_QUERY_TREE(
+        space, tree, ArborXTest::toView<DeviceType>(ordered_predicates),
+        make_reference_solution<int>({0, 0, 1, 2, 9, 8}, {0, 1, 4, 4, 6}));
+    ARBORX_TEST_QUERY_TREE(space, tree,
+                           ArborXTest::toView<DeviceType>(ordered_segments),
+                           make_reference_solution<int>({2}, {0, 1}));
+  };
+
+  auto const boxes_view = ArborXTest::toView<DeviceType>(boxes);
+  check(ArborX::BVH<MemorySpace>(space, boxes_view));
+  using KDOP = ArborX::Experimental::KDOP<14>;
+  check(ArborX::BasicBoundingVolumeHierarchy<
+        MemorySpace, ArborX::Details::PairIndexVolume<Box>,
+        ArborX::Details::DefaultIndexableGetter, KDOP>(space, boxes_view));
+}
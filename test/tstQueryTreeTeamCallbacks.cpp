@@ -0,0 +1,129 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_StdVectorToKokkosView.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_Point.hpp>
+#include <ArborX_Sphere.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+// Counts the values found for each predicate and sums their indices
+template <typename MemorySpace>
+struct CountAndSumTeamCallback
+{
+  using tag = ArborX::Experimental::TeamCallbackTag;
+
+  Kokkos::View<int *, MemorySpace> _counts;
+  Kokkos::View<int *, MemorySpace> _sums;
+
+  template <typename TeamMember, typename Predicate, typename Values>
+  KOKKOS_FUNCTION void operator()(TeamMember const &team,
+                                  Predicate const &predicate,
+                                  Values const &values) const
+  {
+    int const n = values.size();
+    int sum = 0;
+    Kokkos::parallel_reduce(
+        Kokkos::TeamThreadRange(team, n),
+        [&](int i, int &update) { update += values(i); }, sum);
+    Kokkos::single(Kokkos::PerTeam(team), [&]() {
+      int const i = ArborX::getData(predicate);
+      _counts(i) += n;
+      _sums(i) += sum;
+    });
+  }
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(team_callbacks, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using ArborX::Point;
+
+  ExecutionSpace space;
+
+  // Points on a grid at (i, j, k)
+  int const n = 10;
+  std::vector<Point> points;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      for (int k = 0; k < n; ++k)
+        points.push_back({(float)i, (float)j, (float)k});
+
+  // Some of the spheres find more values than are passed to a callback at
+  // once, and one of them finds none
+  std::vector<ArborX::Sphere> spheres = {{{4.5, 4.5, 4.5}, 1.f},
+                                         {{0, 0, 0}, 3.f},
+                                         {{4.5, 4.5, 4.5}, 20.f},
+                                         {{-5, -5, -5}, 1.f}};
+  std::vector<decltype(ArborX::attach(ArborX::intersects(ArborX::Sphere{}),
+                                      0))>
+      predicates;
+  std::vector<int> counts_ref;
+  std::vector<int> sums_ref;
+  for (int q = 0; q < (int)spheres.size(); ++q)
+  {
+    predicates.push_back(ArborX::attach(ArborX::intersects(spheres[q]), q));
+    counts_ref.push_back(0);
+    sums_ref.push_back(0);
+    for (int i = 0; i < (int)points.size(); ++i)
+      if (ArborX::Details::intersects(points[i], spheres[q]))
+      {
+        ++counts_ref[q];
+        sums_ref[q] += i;
+      }
+  }
+  BOOST_TEST(counts_ref[2] == n * n * n);
+  BOOST_TEST(counts_ref[3] == 0);
+
+  auto const predicates_view = ArborXTest::toView<DeviceType>(predicates);
+  for (auto const &tree :
+       {ArborX::BVH<MemorySpace>(space, ArborXTest::toView<DeviceType>(points)),
+        ArborX::BVH<MemorySpace>(
+            space, ArborXTest::toView<DeviceType>(std::vector<Point>{
+                       {4, 4, 4}}))})
+  {
+    int const n_queries = predicates.size();
+    Kokkos::View<int *, MemorySpace> counts("Testing::counts", n_queries);
+    Kokkos::View<int *, MemorySpace> sums("Testing::sums", n_queries);
+    tree.query(space, predicates_view,
+               CountAndSumTeamCallback<MemorySpace>{counts, sums});
+
+    auto const counts_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, counts);
+    auto const sums_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, sums);
+    if (tree.size() == 1)
+    {
+      // Only the first and the third sphere contain the single point
+      std::vector<int> one_leaf_ref = {1, 0, 1, 0};
+      for (int q = 0; q < n_queries; ++q)
+      {
+        BOOST_TEST(counts_host(q) == one_leaf_ref[q]);
+        BOOST_TEST(sums_host(q) == 0);
+      }
+      continue;
+    }
+    for (int q = 0; q < n_queries; ++q)
+    {
+      BOOST_TEST(counts_host(q) == counts_ref[q]);
+      BOOST_TEST(sums_host(q) == sums_ref[q]);
+    }
+  }
+}
@@ -9,15 +9,25 @@
  * SPDX-License-Identifier: BSD-3-Clause                                    *
  ****************************************************************************/
 
+#include "ArborXTest_Cloud.hpp"
+#include "ArborXTest_StdVectorToKokkosView.hpp"
 #include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_CoProcessedQuery.hpp>
 #include <ArborX_LinearBVH.hpp>
+#include <ArborX_NearestWarmStart.hpp>
+#include <ArborX_StreamingQuery.hpp>
+#include <ArborX_TreeSerialization.hpp>
 
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <numeric>
 #include <random>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "Search_UnitTestHelpers.hpp"
 
@@ -175,4 +185,1454 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(unsorted_predicates, DeviceType,
   }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(predicate_permutation, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 200;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+
+  std::vector<std::pair<ArborX::Point, int>> query_points;
+  for (int i = 0; i < n; i += 3)
+    query_points.emplace_back(points_host(i), 4);
+  int const n_queries = query_points.size();
+  auto const queries = makeNearestQueries<DeviceType>(query_points);
+
+  auto query_with_policy = [&](auto const &bvh, auto const &policy) {
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::query(bvh, space, queries, indices, offset, policy);
+    return make_compressed_storage(
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset),
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices));
+  };
+
+  // The permutation computed by the first query is reused against another
+  // hierarchy over the same points
+  ArborX::Experimental::PredicatePermutation permutation;
+  auto const policy =
+      ArborX::Experimental::TraversalPolicy().setPredicatePermutation(
+          permutation);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+  auto const reference = query(space, bvh, queries);
+  BOOST_TEST(query_with_policy(bvh, policy) == reference, tt::per_element());
+  ArborX::BVH<MemorySpace> const other_bvh(
+      space, points, ArborX::Experimental::Hilbert64());
+  BOOST_TEST(query_with_policy(other_bvh, policy) == reference,
+             tt::per_element());
+
+  // The ordering does not change the results
+  Kokkos::View<unsigned int *, MemorySpace> reversed("Testing::reversed",
+                                                     n_queries);
+  Kokkos::parallel_for(
+      "Testing::reverse_predicates",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n_queries),
+      KOKKOS_LAMBDA(int i) { reversed(i) = n_queries - 1 - i; });
+  BOOST_TEST(query_with_policy(
+                 bvh, ArborX::Experimental::TraversalPolicy()
+                          .setPredicatePermutation(
+                              ArborX::Experimental::PredicatePermutation(
+                                  reversed))) == reference,
+             tt::per_element());
+
+  // The permutation must match the predicates
+  auto const fewer_queries = makeNearestQueries<DeviceType>(
+      {query_points.begin(), query_points.begin() + 5});
+  Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+  Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+  BOOST_CHECK_THROW(ArborX::query(bvh, space, fewer_queries, indices, offset,
+                                  policy),
+                    ArborX::SearchException);
+  permutation.reset();
+  BOOST_CHECK_NO_THROW(ArborX::query(bvh, space, fewer_queries, indices,
+                                     offset, policy));
+}
+
+namespace Test
+{
+// 64 bytes of data attached to each predicate
+struct Payload
+{
+  int index;
+  float values[15];
+};
+
+struct CheckPayload
+{
+  template <typename Predicate, typename OutputFunctor>
+  KOKKOS_FUNCTION void operator()(Predicate const &predicate, int i,
+                                  OutputFunctor const &out) const
+  {
+    auto const &payload = ArborX::getData(predicate);
+    bool valid = true;
+    for (auto value : payload.values)
+      valid = valid && (value == payload.index);
+    out(valid ? i : -1);
+  }
+};
+} // namespace Test
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(large_attachments, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  using PlainPredicate = ArborX::Intersects<ArborX::Sphere>;
+  using Predicate = decltype(ArborX::attach(PlainPredicate{}, Test::Payload{}));
+  using Predicates = Kokkos::View<Predicate *, DeviceType>;
+
+  // The reordered predicates only carry the attached index besides the
+  // geometry, the payload is read from the original predicates
+  using PermutedPredicates = ArborX::Details::PermutedData<
+      Predicates, Kokkos::View<unsigned int *, DeviceType>,
+      true /*AttachIndices*/>;
+  using Access =
+      ArborX::AccessTraits<PermutedPredicates, ArborX::PredicatesTag>;
+  static_assert(
+      std::is_same_v<std::decay_t<decltype(Access::get(
+                         std::declval<PermutedPredicates const &>(), 0))>,
+                     ArborX::Details::PredicateWithAttachedIndex<PlainPredicate,
+                                                                 Predicate>>);
+
+  int const n = 200;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  Kokkos::View<PlainPredicate *, DeviceType> plain_queries(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                         "Testing::plain_queries"),
+      n);
+  Predicates queries(Kokkos::view_alloc(space, Kokkos::WithoutInitializing,
+                                        "Testing::queries"),
+                     n);
+  Kokkos::parallel_for(
+      "Testing::make_queries", Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) {
+        Test::Payload payload{i, {}};
+        for (auto &value : payload.values)
+          value = i;
+        plain_queries(i) = ArborX::intersects(ArborX::Sphere{points(i), 0.2f});
+        queries(i) = ArborX::attach(plain_queries(i), payload);
+      });
+  auto const reference = query(space, bvh, plain_queries);
+
+  Kokkos::View<unsigned int *, MemorySpace> reversed("Testing::reversed", n);
+  Kokkos::parallel_for(
+      "Testing::reverse_predicates",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n),
+      KOKKOS_LAMBDA(int i) { reversed(i) = n - 1 - i; });
+  for (auto const &policy :
+       {ArborX::Experimental::TraversalPolicy().setPredicateSorting(false),
+        ArborX::Experimental::TraversalPolicy().setPredicatePermutation(
+            ArborX::Experimental::PredicatePermutation(reversed))})
+  {
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::query(bvh, space, queries, Test::CheckPayload{}, indices, offset,
+                  policy);
+    BOOST_TEST(make_compressed_storage(
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       offset),
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       indices)) == reference,
+               tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(adaptive_predicate_sorting, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  // Points along the x-axis, queried in order, in reverse order, and
+  // shuffled
+  int const n = 1000;
+  std::vector<ArborX::Box> boxes;
+  for (int i = 0; i < n; ++i)
+    boxes.push_back({{{(float)i, 0., 0.}}, {{(float)i, 0., 0.}}});
+  auto const bvh = make<ArborX::BVH<MemorySpace>>(space, boxes);
+
+  std::vector<std::pair<ArborX::Point, float>> sorted;
+  for (int i = 0; i < n; ++i)
+    sorted.push_back({{{(float)i, 0., 0.}}, .5f});
+  auto reversed = sorted;
+  std::reverse(reversed.begin(), reversed.end());
+  auto shuffled = sorted;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::default_random_engine());
+
+  using BatchedQueries = ArborX::Details::BatchedQueries<DeviceType>;
+  ArborX::ExperimentalHyperGeometry::Box<3> scene_bounding_box{};
+  ArborX::Details::expand(scene_bounding_box, bvh.bounds());
+
+  auto const policy =
+      ArborX::Experimental::TraversalPolicy().setAdaptivePredicateSorting(
+          true);
+  for (auto const &[points, coherent] :
+       {std::make_pair(sorted, true), std::make_pair(reversed, false),
+        std::make_pair(shuffled, false)})
+  {
+    auto const queries = makeIntersectsSphereQueries<DeviceType>(points);
+    BOOST_TEST(BatchedQueries::arePredicatesCoherent(
+                   space, scene_bounding_box, queries) == coherent);
+    BOOST_TEST(BatchedQueries::sortsPredicates(space, policy,
+                                               scene_bounding_box, queries,
+                                               "Testing") == !coherent);
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::query(bvh, space, queries, indices, offset, policy);
+    BOOST_TEST(make_compressed_storage(
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       offset),
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       indices)) ==
+                   query(space, bvh, queries),
+               tt::per_element());
+  }
+
+  // Small batches are never sorted, and the other settings prevail
+  auto const few_queries = makeIntersectsSphereQueries<DeviceType>(
+      {shuffled.begin(), shuffled.begin() + 10});
+  BOOST_TEST(!BatchedQueries::sortsPredicates(space, policy,
+                                              scene_bounding_box, few_queries,
+                                              "Testing"));
+  BOOST_TEST(BatchedQueries::sortsPredicates(
+      space, ArborX::Experimental::TraversalPolicy(), scene_bounding_box,
+      few_queries, "Testing"));
+  BOOST_TEST(!BatchedQueries::sortsPredicates(
+      space, ArborX::Experimental::TraversalPolicy(policy).setPredicateSorting(
+                 false),
+      scene_bounding_box, few_queries, "Testing"));
+}
+
+template <class DeviceType>
+struct CountHitsAndExitEarly
+{
+  Kokkos::View<int *, DeviceType, Kokkos::MemoryTraits<Kokkos::Atomic>> counts;
+  template <class Predicate, typename Value>
+  KOKKOS_FUNCTION auto operator()(Predicate const &predicate,
+                                  Value const &) const
+  {
+    int i = getData(predicate);
+    if (++counts(i) <= i)
+      return ArborX::CallbackTreeTraversalControl::normal_continuation;
+    return ArborX::CallbackTreeTraversalControl::early_exit;
+  }
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(packet_traversal, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, boxes);
+
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < n; i += 2)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 7) % n));
+    query_boxes.push_back(box);
+  }
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+
+  auto const reference = query(space, bvh, queries);
+  for (int packet_size : {1, 3, 12, 32})
+  {
+    for (bool sort_predicates : {true, false})
+    {
+      Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+      Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+      ArborX::query(bvh, space, queries, indices, offset,
+                    ArborX::Experimental::TraversalPolicy()
+                        .setPacketSize(packet_size)
+                        .setPredicateSorting(sort_predicates));
+      BOOST_TEST(make_compressed_storage(
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         offset),
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         indices)) ==
+                     reference,
+                 tt::per_element());
+    }
+
+    // Predicates in a packet exit independently
+    int const m = 40;
+    Kokkos::View<int *, DeviceType> counts("Testing::counts", m);
+    std::vector<int> ids(m);
+    std::iota(ids.begin(), ids.end(), 0);
+    auto const b = static_cast<ArborX::Box>(bvh.bounds());
+    bvh.query(space,
+              makeIntersectsBoxWithAttachmentQueries<DeviceType, int>(
+                  std::vector<ArborX::Box>(m, b), ids),
+              CountHitsAndExitEarly<DeviceType>{counts},
+              ArborX::Experimental::TraversalPolicy().setPacketSize(
+                  packet_size));
+    std::vector<int> counts_ref(m);
+    std::iota(counts_ref.begin(), counts_ref.end(), 1);
+    auto const counts_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, counts);
+    BOOST_TEST(counts_host == counts_ref, tt::per_element());
+  }
+}
+
+struct DoNothingCallback
+{
+  template <typename Predicate>
+  KOKKOS_FUNCTION void operator()(Predicate const &, int) const
+  {}
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(leaf_blocks, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  std::vector<std::pair<ArborX::Point, float>> spheres;
+  for (int i = 0; i < n; i += 3)
+    spheres.emplace_back(points_host(i), 0.1f * (i % 4));
+  auto const queries = makeIntersectsSphereQueries<DeviceType>(spheres);
+
+  // The leaves of a PLOC hierarchy need not follow each other along the
+  // ropes, and are then tested one by one
+  using Hierarchy = ArborX::Experimental::ConstructionPolicy::Hierarchy;
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+  {
+    ArborX::BVH<MemorySpace> const bvh(
+        space, points,
+        ArborX::Experimental::ConstructionPolicy().setHierarchy(hierarchy));
+
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::query(bvh, space, queries, indices, offset,
+                  ArborX::Experimental::TraversalPolicy().setLeafBlocks(true));
+    BOOST_TEST(make_compressed_storage(
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       offset),
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       indices)) ==
+                   query(space, bvh, queries),
+               tt::per_element());
+  }
+
+  // The blocks of a linear hierarchy span whole subtrees, some of whose
+  // internal nodes are then not visited. This takes blocks of more than the
+  // two leaves of a parent.
+  if constexpr (KokkosExt::is_accessible_from<Kokkos::HostSpace,
+                                              ExecutionSpace>::value)
+  {
+    using Statistics = ArborX::Experimental::TraversalStatistics;
+    ArborX::BVH<MemorySpace> const bvh(space, points);
+    auto internal_node_visits = [&](bool leaf_blocks) {
+      Statistics statistics;
+      bvh.query(space, queries, DoNothingCallback{},
+                ArborX::Experimental::TraversalPolicy()
+                    .setLeafBlocks(leaf_blocks)
+                    .setStatistics(statistics));
+      return statistics.total(Statistics::internal_node_visits);
+    };
+    BOOST_TEST(internal_node_visits(true) < internal_node_visits(false));
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(nearest_scratch_memory, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  // The largest k is too large for the heaps to fit in scratch memory
+  for (int k : {1, 5, 32, n + 1, 10 * n})
+  {
+    std::vector<std::pair<ArborX::Point, int>> query_points;
+    for (int i = 0; i < n; i += 3)
+      query_points.emplace_back(points_host(i), (i % 2 == 0) ? k : k / 2);
+    auto const queries = makeNearestQueries<DeviceType>(query_points);
+
+    auto const reference = query(space, bvh, queries);
+    for (bool sort_predicates : {true, false})
+    {
+      Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+      Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+      ArborX::query(bvh, space, queries, indices, offset,
+                    ArborX::Experimental::TraversalPolicy()
+                        .setNearestScratchMemory(true)
+                        .setPredicateSorting(sort_predicates));
+      BOOST_TEST(make_compressed_storage(
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         offset),
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         indices)) ==
+                     reference,
+                 tt::per_element());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(nearest_stackless, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+
+  using Hierarchy = ArborX::Experimental::ConstructionPolicy::Hierarchy;
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC})
+  {
+    ArborX::BVH<MemorySpace> const bvh(
+        space, points,
+        ArborX::Experimental::ConstructionPolicy().setHierarchy(hierarchy));
+    // More neighbors than leaves, for which the heaps are seeded with all of
+    // them
+    for (int k : {1, 5, 32, n + 1})
+    {
+      std::vector<std::pair<ArborX::Point, int>> query_points;
+      for (int i = 0; i < n; i += 3)
+        query_points.emplace_back(points_host(i), (i % 2 == 0) ? k : k / 2);
+      auto const queries = makeNearestQueries<DeviceType>(query_points);
+
+      Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+      Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+      ArborX::query(
+          bvh, space, queries, indices, offset,
+          ArborX::Experimental::TraversalPolicy().setNearestStackless(true));
+      BOOST_TEST(make_compressed_storage(
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         offset),
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         indices)) ==
+                     query(space, bvh, queries),
+                 tt::per_element());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(traversal_schedule, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  std::vector<std::pair<ArborX::Point, float>> query_spheres;
+  std::vector<std::pair<ArborX::Point, int>> query_points;
+  for (int i = 0; i < n; i += 3)
+  {
+    query_spheres.emplace_back(points_host(i), (i % 7) * 0.05f);
+    query_points.emplace_back(points_host(i), 1 + i % 10);
+  }
+
+  // The schedule must not change the results. Persistent threads are only
+  // used on devices, fewer of them than predicates.
+  auto const check = [&](auto const &queries) {
+    auto const reference = query(space, bvh, queries);
+    for (int chunk_size : {0, 1, 16})
+      for (int persistent_threads : {0, 7})
+      {
+        Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+        Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+        ArborX::query(bvh, space, queries, indices, offset,
+                      ArborX::Experimental::TraversalPolicy()
+                          .setDynamicChunkSize(chunk_size)
+                          .setPersistentThreads(persistent_threads));
+        BOOST_TEST(make_compressed_storage(
+                       Kokkos::create_mirror_view_and_copy(
+                           Kokkos::HostSpace{}, offset),
+                       Kokkos::create_mirror_view_and_copy(
+                           Kokkos::HostSpace{}, indices)) == reference,
+                   tt::per_element());
+      }
+  };
+  check(makeIntersectsSphereQueries<DeviceType>(query_spheres));
+  check(makeNearestQueries<DeviceType>(query_points));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(nearest_workspace, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 200;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+
+  // The same workspace is grown and reused by queries of various sizes
+  ArborX::Experimental::NearestQueryWorkspace workspace;
+  for (auto [n_queries, k] : {std::make_tuple(10, 3), std::make_tuple(50, 7),
+                              std::make_tuple(20, 2), std::make_tuple(0, 2),
+                              std::make_tuple(n, n + 3)})
+  {
+    std::vector<std::pair<ArborX::Point, int>> query_points;
+    for (int i = 0; i < n_queries; ++i)
+      query_points.emplace_back(points_host(i), k);
+    auto const queries = makeNearestQueries<DeviceType>(query_points);
+
+    auto const reference = query(space, bvh, queries);
+    for (int number_of_neighbors : {0, k})
+    {
+      for (bool scratch_memory : {false, true})
+      {
+        Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+        Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+        ArborX::query(bvh, space, queries, indices, offset,
+                      ArborX::Experimental::TraversalPolicy()
+                          .setNearestWorkspace(workspace)
+                          .setNumberOfNeighbors(number_of_neighbors)
+                          .setNearestScratchMemory(scratch_memory));
+        BOOST_TEST(make_compressed_storage(
+                       Kokkos::create_mirror_view_and_copy(
+                           Kokkos::HostSpace{}, offset),
+                       Kokkos::create_mirror_view_and_copy(
+                           Kokkos::HostSpace{}, indices)) == reference,
+                   tt::per_element());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(workspace, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  int const n = 200;
+  auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+  std::vector<ArborX::Box> query_boxes;
+  std::vector<std::pair<ArborX::Point, int>> query_points;
+  for (int i = 0; i < n; i += 3)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 5) % n));
+    query_boxes.push_back(box);
+    query_points.emplace_back(ArborX::Details::returnCentroid(box), 1 + i % 4);
+  }
+  auto const spatial_queries =
+      makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  auto const nearest_queries = makeNearestQueries<DeviceType>(query_points);
+
+  Tree const reference_tree(space, boxes);
+  auto const spatial_reference = query(space, reference_tree, spatial_queries);
+  auto const nearest_reference = query(space, reference_tree, nearest_queries);
+
+  auto check = [&](Tree const &tree,
+                   ArborX::Experimental::TraversalPolicy const &policy) {
+    for (bool single_pass : {false, true})
+    {
+      Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+      Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+      ArborX::query(tree, space, spatial_queries, indices, offset,
+                    ArborX::Experimental::TraversalPolicy(policy)
+                        .setSinglePass(single_pass)
+                        .setBufferSize(single_pass ? 2 : 0));
+      BOOST_TEST(make_compressed_storage(
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         offset),
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         indices)) ==
+                     spatial_reference,
+                 tt::per_element());
+    }
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::query(tree, space, nearest_queries, indices, offset, policy);
+    BOOST_TEST(make_compressed_storage(
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       offset),
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       indices)) ==
+                   nearest_reference,
+               tt::per_element());
+  };
+
+  // The hierarchies do not keep any of the storage of the workspace, which
+  // is reused by the following constructions and queries
+  ArborX::Experimental::Workspace workspace;
+  using Hierarchy = ArborX::Experimental::ConstructionPolicy::Hierarchy;
+  std::vector<Tree> trees;
+  for (auto hierarchy : {Hierarchy::Linear, Hierarchy::PLOC, Hierarchy::Linear})
+    trees.emplace_back(space, boxes, ArborX::Experimental::Morton64{},
+                       ArborX::Experimental::ConstructionPolicy()
+                           .setHierarchy(hierarchy)
+                           .setWorkspace(workspace));
+  auto const policy =
+      ArborX::Experimental::TraversalPolicy().setWorkspace(workspace);
+  for (auto const &tree : trees)
+    check(tree, policy);
+
+  // Smaller temporaries are taken from the larger storage
+  Tree const small_tree(
+      space, Kokkos::subview(boxes, Kokkos::make_pair(0, n / 2)),
+      ArborX::Experimental::Morton64{},
+      ArborX::Experimental::ConstructionPolicy().setWorkspace(workspace));
+  BOOST_TEST(small_tree.size() == n / 2);
+  check(trees.front(), policy);
+
+  // The default workspace serves the calls that are not given one
+  workspace.release();
+  ArborX::Experimental::defaultWorkspace() = workspace;
+  check(Tree(space, boxes), ArborX::Experimental::TraversalPolicy());
+  ArborX::Experimental::defaultWorkspace().reset();
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(asynchronous, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 200;
+  auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, boxes);
+
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+  std::vector<ArborX::Box> query_boxes;
+  std::vector<std::pair<ArborX::Point, int>> query_points;
+  for (int i = 0; i < n; i += 2)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 7) % n));
+    query_boxes.push_back(box);
+    query_points.emplace_back(boxes_host(i).minCorner(), 4);
+  }
+  auto const spatial_queries =
+      makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  auto const nearest_queries = makeNearestQueries<DeviceType>(query_points);
+
+  auto const checkResults = [&](auto const &queries, int buffer_size,
+                                int number_of_neighbors) {
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::Experimental::QueryFuture future;
+    ArborX::query(bvh, space, queries, indices, offset,
+                  ArborX::Experimental::TraversalPolicy()
+                      .setBufferSize(buffer_size)
+                      .setNumberOfNeighbors(number_of_neighbors)
+                      .setAsynchronous(future));
+    future.wait();
+    BOOST_TEST(make_compressed_storage(
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       offset),
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       indices)) ==
+                   query(space, bvh, queries),
+               tt::per_element());
+  };
+
+  checkResults(spatial_queries, n, 0);
+  checkResults(spatial_queries, -n, 0);
+  checkResults(nearest_queries, 0, 4);
+
+  // Buffer size insufficient
+  {
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::Experimental::QueryFuture future;
+    ArborX::query(bvh, space, spatial_queries, indices, offset,
+                  ArborX::Experimental::TraversalPolicy()
+                      .setBufferSize(1)
+                      .setAsynchronous(future));
+    BOOST_CHECK_THROW(future.wait(), ArborX::SearchException);
+    // The future is reset once waited on
+    BOOST_CHECK_NO_THROW(future.wait());
+  }
+
+  // Replayed queries reuse the storage and the predicate ordering of their
+  // plan, and alternate between two output buffers
+  auto const checkReplayedResults = [&](auto const &queries, int buffer_size,
+                                        int number_of_neighbors) {
+    auto const reference = query(space, bvh, queries);
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::Experimental::QueryPlan plan;
+    auto const policy = ArborX::Experimental::TraversalPolicy()
+                            .setBufferSize(buffer_size)
+                            .setNumberOfNeighbors(number_of_neighbors)
+                            .setQueryPlan(plan);
+    for (int replay = 0; replay < 3; ++replay)
+    {
+      ArborX::query(bvh, space, queries, indices, offset, policy);
+      plan.future().wait();
+      BOOST_TEST(make_compressed_storage(
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         offset),
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         indices)) == reference,
+                 tt::per_element());
+    }
+  };
+  checkReplayedResults(spatial_queries, n, 0);
+  checkReplayedResults(nearest_queries, 0, 4);
+
+  // Sizes must be known in advance
+  Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+  Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+  ArborX::Experimental::QueryFuture future;
+  BOOST_CHECK_THROW(
+      ArborX::query(
+          bvh, space, spatial_queries, indices, offset,
+          ArborX::Experimental::TraversalPolicy().setAsynchronous(future)),
+      ArborX::SearchException);
+  BOOST_CHECK_THROW(
+      ArborX::query(
+          bvh, space, nearest_queries, indices, offset,
+          ArborX::Experimental::TraversalPolicy().setAsynchronous(future)),
+      ArborX::SearchException);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(single_pass, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 200;
+  auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, boxes);
+
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < n; i += 2)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 7) % n));
+    query_boxes.push_back(box);
+  }
+  // Some queries find every box
+  query_boxes.push_back(static_cast<ArborX::Box>(bvh.bounds()));
+  query_boxes.push_back({});
+  query_boxes.push_back(static_cast<ArborX::Box>(bvh.bounds()));
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+
+  auto const reference = query(space, bvh, queries);
+  for (int buffer_size : {0, 1, 40, 2 * n, -2 * n})
+  {
+    for (bool sort_predicates : {true, false})
+    {
+      Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+      Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+      ArborX::query(bvh, space, queries, indices, offset,
+                    ArborX::Experimental::TraversalPolicy()
+                        .setSinglePass(true)
+                        .setBufferSize(buffer_size)
+                        .setPredicateSorting(sort_predicates));
+      BOOST_TEST(indices.extent_int(0) ==
+                 KokkosExt::lastElement(space, offset));
+      BOOST_TEST(make_compressed_storage(
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         offset),
+                     Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                         indices)) ==
+                     reference,
+                 tt::per_element());
+    }
+  }
+
+  // Pool too small
+  Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+  Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+  BOOST_CHECK_THROW(ArborX::query(bvh, space, queries, indices, offset,
+                                  ArborX::Experimental::TraversalPolicy()
+                                      .setSinglePass(true)
+                                      .setBufferSize(-1)),
+                    ArborX::SearchException);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(max_results_per_predicate, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 200;
+  auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, boxes);
+
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < n; i += 2)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 7) % n));
+    query_boxes.push_back(box);
+  }
+  query_boxes.push_back(static_cast<ArborX::Box>(bvh.bounds()));
+  query_boxes.push_back({});
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  int const n_queries = query_boxes.size();
+
+  Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+  Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+  ArborX::query(bvh, space, queries, indices, offset);
+  auto const indices_ref =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices);
+  auto const offset_ref =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset);
+
+  // The predicates keep as many of their results as allowed
+  for (int max_results : {1, 5, 2 * n})
+  {
+    for (bool sort_predicates : {true, false})
+    {
+      ArborX::query(bvh, space, queries, indices, offset,
+                    ArborX::Experimental::TraversalPolicy()
+                        .setMaxResultsPerPredicate(max_results)
+                        .setPredicateSorting(sort_predicates));
+      BOOST_TEST(indices.extent_int(0) ==
+                 KokkosExt::lastElement(space, offset));
+      auto const indices_host =
+          Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices);
+      auto const offset_host =
+          Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset);
+      for (int q = 0; q < n_queries; ++q)
+      {
+        std::vector<int> const row(indices_ref.data() + offset_ref(q),
+                                   indices_ref.data() + offset_ref(q + 1));
+        BOOST_TEST(offset_host(q + 1) - offset_host(q) ==
+                   std::min<int>(max_results, row.size()));
+        for (int j = offset_host(q); j < offset_host(q + 1); ++j)
+          BOOST_TEST(std::count(row.begin(), row.end(), indices_host(j)) == 1);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(streaming, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 200;
+  auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, boxes);
+
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < n; ++i)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 7) % n));
+    query_boxes.push_back(box);
+  }
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  auto const reference = query(space, bvh, queries);
+
+  // The predicates reside on the host and the chunks are handed over in order
+  auto const host_queries =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, queries);
+  for (int chunk_size : {1, 7, n, 2 * n})
+  {
+    std::vector<int> indices;
+    std::vector<int> offset = {0};
+    ArborX::Experimental::queryStreaming(
+        space, bvh, host_queries,
+        [&](int first, auto const &chunk_offset, auto const &chunk_indices) {
+          BOOST_TEST(first + 1 == (int)offset.size());
+          for (int i = 1; i < chunk_offset.extent_int(0); ++i)
+            offset.push_back(offset.back() + chunk_offset(i) -
+                             chunk_offset(i - 1));
+          for (int j = 0; j < chunk_indices.extent_int(0); ++j)
+            indices.push_back(chunk_indices(j));
+        },
+        chunk_size);
+    BOOST_TEST(make_compressed_storage(offset, indices) == reference,
+               tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(co_processing, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 200;
+  auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, boxes);
+  auto const host_bvh =
+      ArborX::Experimental::copyTree<ArborX::BVH<Kokkos::HostSpace>>(space,
+                                                                     bvh);
+  BOOST_TEST(host_bvh.size() == bvh.size());
+
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+  std::vector<ArborX::Box> query_boxes;
+  std::vector<std::pair<ArborX::Point, int>> query_points;
+  for (int i = 0; i < n; ++i)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 7) % n));
+    query_boxes.push_back(box);
+    query_points.emplace_back(boxes_host(i).minCorner(), 3);
+  }
+  auto const spatial_queries =
+      makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  auto const nearest_queries = makeNearestQueries<DeviceType>(query_points);
+  auto const spatial_reference = query(space, bvh, spatial_queries);
+  auto const nearest_reference = query(space, bvh, nearest_queries);
+
+  Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+  Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+  auto const results = [&]() {
+    return make_compressed_storage(
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset),
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices));
+  };
+  for (float host_fraction : {0.f, 0.3f, 1.f})
+  {
+    float fraction = ArborX::Experimental::queryCoProcessed(
+        space, bvh, host_bvh, spatial_queries, indices, offset,
+        host_fraction);
+    BOOST_TEST(fraction >= 0.f);
+    BOOST_TEST(fraction <= 1.f);
+    BOOST_TEST(results() == spatial_reference, tt::per_element());
+
+    fraction = ArborX::Experimental::queryCoProcessed(
+        space, bvh, host_bvh, nearest_queries, indices, offset,
+        host_fraction);
+    BOOST_TEST(results() == nearest_reference, tt::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(batches, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 200;
+  auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, boxes);
+
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+  std::vector<ArborX::Box> query_boxes;
+  std::vector<std::pair<ArborX::Point, int>> query_points;
+  for (int i = 0; i < n; i += 2)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 7) % n));
+    query_boxes.push_back(box);
+    query_points.emplace_back(boxes_host(i).minCorner(), 1 + i % 5);
+  }
+  query_boxes.push_back(static_cast<ArborX::Box>(bvh.bounds()));
+  query_boxes.push_back({});
+  auto const spatial_queries =
+      makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  auto const nearest_queries = makeNearestQueries<DeviceType>(query_points);
+
+  auto const check = [&](auto const &queries, auto const &policy) {
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::query(bvh, space, queries, indices, offset, policy);
+    BOOST_TEST(indices.extent_int(0) == KokkosExt::lastElement(space, offset));
+    BOOST_TEST(make_compressed_storage(
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       offset),
+                   Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{},
+                                                       indices)) ==
+                   query(space, bvh, queries),
+               tt::per_element());
+  };
+
+  for (int batch_size : {1, 7, 64, n / 2})
+  {
+    for (bool sort_predicates : {true, false})
+    {
+      auto const policy = ArborX::Experimental::TraversalPolicy()
+                              .setBatchSize(batch_size)
+                              .setBufferSize(-1)
+                              .setPredicateSorting(sort_predicates);
+      check(spatial_queries, policy);
+      check(nearest_queries, policy);
+    }
+  }
+
+  // Batches of a few predicates given the memory limit
+  auto const policy =
+      ArborX::Experimental::TraversalPolicy().setTemporaryMemoryLimit(1000);
+  check(spatial_queries, policy);
+  check(nearest_queries, policy);
+}
+
+template <int K, typename DeviceType, typename ExecutionSpace, typename Tree>
+void checkFixedNearest(ExecutionSpace const &space, Tree const &bvh,
+                       std::vector<ArborX::Point> const &query_points)
+{
+  int const n_queries = query_points.size();
+  Kokkos::View<ArborX::Experimental::FixedNearest<ArborX::Point, K> *,
+               DeviceType>
+      queries("Testing::fixed_nearest_queries", n_queries);
+  auto queries_host = Kokkos::create_mirror_view(queries);
+  std::vector<std::pair<ArborX::Point, int>> reference_queries;
+  for (int q = 0; q < n_queries; ++q)
+  {
+    queries_host(q) = ArborX::Experimental::fixed_nearest<K>(query_points[q]);
+    reference_queries.emplace_back(query_points[q], K);
+  }
+  Kokkos::deep_copy(queries, queries_host);
+
+  BOOST_TEST(query(space, bvh, queries) ==
+                 query(space, bvh,
+                       makeNearestQueries<DeviceType>(reference_queries)),
+             tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(fixed_nearest, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  std::vector<ArborX::Point> query_points;
+  for (int i = 0; i < n; i += 3)
+    query_points.push_back(points_host(i));
+
+  static_assert(ArborX::Details::fixed_number_of_neighbors_v<
+                    ArborX::Experimental::FixedNearest<ArborX::Point, 4>> == 4);
+  static_assert(ArborX::Details::fixed_number_of_neighbors_v<
+                    ArborX::Nearest<ArborX::Point>> == 0);
+
+  checkFixedNearest<1, DeviceType>(space, bvh, query_points);
+  checkFixedNearest<4, DeviceType>(space, bvh, query_points);
+  checkFixedNearest<16, DeviceType>(space, bvh, query_points);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(predicate_variant, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  auto const points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  constexpr int k = 4;
+  using Variant = ArborX::Experimental::PredicateVariant<
+      ArborX::Intersects<ArborX::Sphere>,
+      ArborX::Experimental::FixedNearest<ArborX::Point, k>>;
+
+  auto const points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  int const n_queries = n / 3;
+  Kokkos::View<decltype(ArborX::attach(Variant{}, 0)) *, DeviceType> queries(
+      "Testing::variant_queries", n_queries);
+  auto queries_host = Kokkos::create_mirror_view(queries);
+  std::vector<std::pair<ArborX::Point, float>> query_spheres;
+  for (int q = 0; q < n_queries; ++q)
+  {
+    auto const &point = points_host(3 * q);
+    if (q % 2 == 0)
+    {
+      float const radius = (q % 7) * 0.05f;
+      queries_host(q) =
+          ArborX::attach(Variant{ArborX::intersects(ArborX::Sphere{
+                             point, radius})},
+                         q);
+      query_spheres.emplace_back(point, radius);
+    }
+    else
+      queries_host(q) = ArborX::attach(
+          Variant{ArborX::Experimental::fixed_nearest<k>(point)}, q);
+  }
+  Kokkos::deep_copy(queries, queries_host);
+
+  Kokkos::View<int *, DeviceType> counts("Testing::counts", n_queries);
+  bvh.query(
+      space, queries, KOKKOS_LAMBDA(auto const &predicate, auto) {
+        Kokkos::atomic_increment(&counts(ArborX::getData(predicate)));
+      });
+  auto const counts_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, counts);
+
+  // Spatial alternatives find as many values as the separate queries, and
+  // nearest ones always find k of them
+  auto const reference =
+      query(space, bvh, makeIntersectsSphereQueries<DeviceType>(query_spheres));
+  for (int q = 0; q < n_queries; ++q)
+  {
+    int const expected =
+        (q % 2 == 0)
+            ? reference.offsets(q / 2 + 1) - reference.offsets(q / 2)
+            : k;
+    BOOST_TEST(counts_host(q) == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(approximate_nearest, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 100;
+  std::vector<ArborX::Point> points_host(n);
+  for (int i = 0; i < n; ++i)
+    points_host[i] = {(float)i, 0.f, 0.f};
+  auto const points = ArborXTest::toView<ExecutionSpace>(points_host);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  int const k = 5;
+  float const epsilon = 0.5f;
+  std::vector<float> xs;
+  for (int i = 0; i < n; i += 7)
+    xs.push_back(i + 0.3f);
+  int const n_queries = xs.size();
+
+  using ArborX::Experimental::approximate_nearest;
+  for (int max_visited_nodes : {0, 1})
+  {
+    Kokkos::View<ArborX::Experimental::ApproximateNearest<ArborX::Point> *,
+                 DeviceType>
+        queries("Testing::approximate_nearest_queries", n_queries);
+    auto queries_host = Kokkos::create_mirror_view(queries);
+    for (int q = 0; q < n_queries; ++q)
+      queries_host(q) = approximate_nearest(ArborX::Point{xs[q], 0.f, 0.f}, k,
+                                            epsilon, max_visited_nodes);
+    Kokkos::deep_copy(queries, queries_host);
+
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::query(bvh, space, queries, indices, offset);
+    auto const indices_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices);
+    auto const offset_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset);
+
+    for (int q = 0; q < n_queries; ++q)
+    {
+      std::vector<float> distances(n);
+      for (int i = 0; i < n; ++i)
+        distances[i] = std::abs(xs[q] - i);
+      std::nth_element(distances.begin(), distances.begin() + k - 1,
+                       distances.end());
+      float const kth_distance = distances[k - 1];
+
+      // The search may give up before finding all the neighbors
+      int const count = offset_host(q + 1) - offset_host(q);
+      if (max_visited_nodes > 0)
+      {
+        BOOST_TEST(count <= k);
+        continue;
+      }
+      BOOST_TEST(count == k);
+      for (int j = offset_host(q); j < offset_host(q + 1); ++j)
+        BOOST_TEST(std::abs(xs[q] - indices_host(j)) <=
+                   (1 + epsilon) * kth_distance);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(nearest_within, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+
+  ExecutionSpace space;
+
+  int const n = 100;
+  std::vector<ArborX::Point> points_host(n);
+  for (int i = 0; i < n; ++i)
+    points_host[i] = {(float)i, 0.f, 0.f};
+  auto const points = ArborXTest::toView<ExecutionSpace>(points_host);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  int const k = 3;
+  float const max_distance = 1.5f;
+  // Neighbors at exactly the largest distance are found, and no more than k
+  // of them
+  std::vector<float> xs = {-10.f, -1.5f, 0.2f, 50.f, 50.5f, 120.f};
+  int const n_queries = xs.size();
+
+  for (bool scratch_memory : {false, true})
+  {
+    Kokkos::View<ArborX::Experimental::NearestWithin<ArborX::Point> *,
+                 DeviceType>
+        queries("Testing::nearest_within_queries", n_queries);
+    auto queries_host = Kokkos::create_mirror_view(queries);
+    for (int q = 0; q < n_queries; ++q)
+      queries_host(q) = ArborX::Experimental::nearest_within(
+          ArborX::Point{xs[q], 0.f, 0.f}, k, max_distance);
+    Kokkos::deep_copy(queries, queries_host);
+
+    Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+    Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+    ArborX::query(bvh, space, queries, indices, offset,
+                  ArborX::Experimental::TraversalPolicy()
+                      .setNearestScratchMemory(scratch_memory));
+    auto const indices_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, indices);
+    auto const offset_host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, offset);
+
+    for (int q = 0; q < n_queries; ++q)
+    {
+      int expected_count = 0;
+      for (int i = 0; i < n; ++i)
+        expected_count += (std::abs(xs[q] - i) <= max_distance);
+      BOOST_TEST(offset_host(q + 1) - offset_host(q) ==
+                 std::min(k, expected_count));
+      for (int j = offset_host(q); j < offset_host(q + 1); ++j)
+        BOOST_TEST(std::abs(xs[q] - indices_host(j)) <= max_distance);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(traversal_statistics, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Statistics = ArborX::Experimental::TraversalStatistics;
+
+  ExecutionSpace space;
+
+  int const n = 100;
+  std::vector<ArborX::Point> points_host(n);
+  for (int i = 0; i < n; ++i)
+    points_host[i] = {(float)i, 0.f, 0.f};
+  ArborX::BVH<MemorySpace> const bvh(
+      space, ArborXTest::toView<ExecutionSpace>(points_host));
+
+  auto const sum = [](std::vector<unsigned long long> const &histogram) {
+    return std::accumulate(histogram.begin(), histogram.end(), 0ull);
+  };
+
+  // Boxes containing 3, 1 and none of the points
+  auto const spatial_queries = makeIntersectsBoxQueries<DeviceType>({
+      {{{9.5, -1, -1}}, {{12.5, 1, 1}}},
+      {{{50, 0, 0}}, {{50, 0, 0}}},
+      {{{-5, -1, -1}}, {{-4, 1, 1}}},
+  });
+  Statistics statistics;
+  BOOST_TEST(statistics.total(Statistics::leaf_tests) == 0);
+  bvh.query(space, spatial_queries, DoNothingCallback{},
+            ArborX::Experimental::TraversalPolicy().setStatistics(statistics));
+  for (auto counter :
+       {Statistics::internal_node_visits, Statistics::leaf_tests,
+        Statistics::callback_invocations, Statistics::max_stack_depth,
+        Statistics::early_exits})
+    BOOST_TEST(sum(statistics.histogram(counter)) == 3);
+  BOOST_TEST(statistics.total(Statistics::callback_invocations) == 4);
+  BOOST_TEST(statistics.histogram(Statistics::callback_invocations)[0] == 1);
+  BOOST_TEST(statistics.histogram(Statistics::callback_invocations)[1] == 1);
+  BOOST_TEST(statistics.histogram(Statistics::callback_invocations)[2] == 1);
+  BOOST_TEST(statistics.total(Statistics::leaf_tests) >= 4);
+  BOOST_TEST(statistics.total(Statistics::internal_node_visits) >= 3);
+  BOOST_TEST(statistics.total(Statistics::internal_node_visits) <
+             3 * (n - 1));
+  BOOST_TEST(statistics.total(Statistics::early_exits) == 0);
+
+  // Accumulated across calls until reset
+  auto const nearest_queries = makeNearestQueries<DeviceType>({
+      {{{20.2, 0, 0}}, 2},
+      {{{-5, 0, 0}}, 1},
+  });
+  bvh.query(space, nearest_queries, DoNothingCallback{},
+            ArborX::Experimental::TraversalPolicy().setStatistics(statistics));
+  BOOST_TEST(sum(statistics.histogram(Statistics::leaf_tests)) == 5);
+  BOOST_TEST(statistics.total(Statistics::callback_invocations) == 4 + 3);
+  BOOST_TEST(statistics.total(Statistics::max_stack_depth) > 0);
+
+  statistics.reset();
+  BOOST_TEST(sum(statistics.histogram(Statistics::leaf_tests)) == 0);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(traversal_statistics_node_visits, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Statistics = ArborX::Experimental::TraversalStatistics;
+
+  ExecutionSpace space;
+
+  int const n = 100;
+  int const num_nodes = 2 * n - 1;
+  std::vector<ArborX::Point> points_host(n);
+  for (int i = 0; i < n; ++i)
+    points_host[i] = {(float)i, 0.f, 0.f};
+  ArborX::BVH<MemorySpace> const bvh(
+      space, ArborXTest::toView<ExecutionSpace>(points_host));
+
+  auto const queries = makeIntersectsBoxQueries<DeviceType>({
+      {{{9.5, -1, -1}}, {{12.5, 1, 1}}},
+      {{{50, 0, 0}}, {{50, 0, 0}}},
+      {{{-5, -1, -1}}, {{-4, 1, 1}}},
+      {{{-1, -1, -1}}, {{100, 1, 1}}},
+  });
+
+  // Not recorded unless enabled
+  Statistics statistics;
+  bvh.query(space, queries, DoNothingCallback{},
+            ArborX::Experimental::TraversalPolicy().setStatistics(statistics));
+  BOOST_TEST(statistics.nodeVisits<MemorySpace>(space, num_nodes).size() == 0);
+
+  statistics.reset();
+  statistics.enableNodeVisits();
+  bvh.query(space, queries, DoNothingCallback{},
+            ArborX::Experimental::TraversalPolicy().setStatistics(statistics));
+  auto const node_visits = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace{},
+      statistics.nodeVisits<MemorySpace>(space, num_nodes));
+  BOOST_TEST(node_visits.size() == num_nodes);
+
+  // Every traversal starts at the root, the last query visits all the nodes,
+  // and the visits add up to the counters of the traversals
+  int const root = n;
+  BOOST_TEST(node_visits(root) == 4);
+  unsigned long long sum = 0;
+  for (int node = 0; node < num_nodes; ++node)
+  {
+    BOOST_TEST(node_visits(node) >= 1);
+    sum += node_visits(node);
+  }
+  BOOST_TEST(sum == statistics.total(Statistics::internal_node_visits) +
+                        statistics.total(Statistics::leaf_tests));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(warm_started_nearest, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Statistics = ArborX::Experimental::TraversalStatistics;
+
+  ExecutionSpace space;
+
+  int const n = 300;
+  int const k = 5;
+  auto points = ArborXTest::make_random_cloud<ArborX::Point>(space, n);
+  auto points_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, points);
+  std::vector<ArborX::Point> query_points;
+  for (int i = 0; i < n; i += 3)
+    query_points.push_back(points_host(i));
+  auto const geometries =
+      ArborXTest::toView<DeviceType>(query_points, "Testing::query_points");
+
+  // Neighbors at the previous step
+  Kokkos::View<int *, DeviceType> indices("Testing::indices", 0);
+  Kokkos::View<int *, DeviceType> offset("Testing::offset", 0);
+  ArborX::query(ArborX::BVH<MemorySpace>(space, points), space,
+                makeNearestQueries<DeviceType>([&] {
+                  std::vector<std::pair<ArborX::Point, int>> queries;
+                  for (auto const &point : query_points)
+                    queries.emplace_back(point, k);
+                  return queries;
+                }()),
+                indices, offset);
+
+  // The primitives move a little
+  for (int i = 0; i < n; ++i)
+    for (int d = 0; d < 3; ++d)
+      points_host(i)[d] += 0.01f * std::sin(7.f * i + d);
+  Kokkos::deep_copy(points, points_host);
+  ArborX::BVH<MemorySpace> const bvh(space, points);
+
+  Kokkos::View<ArborX::Nearest<ArborX::Point> *, DeviceType> cold_queries(
+      "Testing::cold_queries", query_points.size());
+  Kokkos::parallel_for(
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, query_points.size()),
+      KOKKOS_LAMBDA(int q) {
+        cold_queries(q) = ArborX::nearest(geometries(q), k);
+      });
+  auto const warm_queries =
+      ArborX::Experimental::makeWarmStartedNearestQueries(
+          space, geometries, points, offset, indices, k);
+  BOOST_TEST(query(space, bvh, warm_queries) == query(space, bvh, cold_queries),
+             tt::per_element());
+
+  // Fewer nodes are visited than without the previous neighbors
+  Statistics cold_statistics;
+  bvh.query(space, cold_queries, DoNothingCallback{},
+            ArborX::Experimental::TraversalPolicy().setStatistics(
+                cold_statistics));
+  Statistics warm_statistics;
+  bvh.query(space, warm_queries, DoNothingCallback{},
+            ArborX::Experimental::TraversalPolicy().setStatistics(
+                warm_statistics));
+  BOOST_TEST(warm_statistics.total(Statistics::leaf_tests) <=
+             cold_statistics.total(Statistics::leaf_tests));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -274,6 +274,38 @@ BOOST_AUTO_TEST_CASE(ray_box_distance)
   BOOST_TEST(ArborX::Experimental::distance(Ray{{.5, .5, -.5}, {0, 0, -1}}, unit_box) == inf);
 }
 
+BOOST_AUTO_TEST_CASE(precomputed_ray_box, *boost::unit_test::tolerance(1e-6f))
+{
+  using ArborX::Box;
+  using ArborX::Experimental::precompute;
+  using ArborX::Experimental::Ray;
+
+  constexpr Box unit_box{{0, 0, 0}, {1, 1, 1}};
+
+  // The slab test of the precomputed ray agrees with the one of the ray,
+  // including when the origin is on the box with 0*inf
+  for (auto const &ray : {Ray{{.5, .5, .5}, {1, 1, 1}},
+                          Ray{{-1, .5, .5}, {1, 0, 0}},
+                          Ray{{-1, .5, .5}, {-1, 0, 0}},
+                          Ray{{2, .5, .5}, {-1, 0, 0}},
+                          Ray{{2, -.5, .5}, {-1, 0, 0}},
+                          Ray{{1, 2, 3}, {4, 5, 6}},
+                          Ray{{1, 2, 3}, {-1, -2, -3}},
+                          Ray{{0, 0, 0}, {0, 1, -1}},
+                          Ray{{0, 0, 0}, {-1, 0, 0}},
+                          Ray{{1, 1, 1}, {1, 0, 0}},
+                          Ray{{0, 1.5, 1.5}, {0, -1, -1}},
+                          Ray{{0, 1.5, 1.5}, {0, 1, 1}},
+                          Ray{{1.5, 1, 1}, {-1, 0, -2.1}}})
+  {
+    bool const hit = intersects(ray, unit_box);
+    BOOST_TEST(intersects(precompute(ray), unit_box) == hit);
+    if (hit)
+      BOOST_TEST(distance(precompute(ray), unit_box) ==
+                 distance(ray, unit_box));
+  }
+}
+
 // NOTE until boost 1.70 need to cast both operands when comparing floating
 // points
 BOOST_AUTO_TEST_CASE(overlap_distance_sphere,
@@ -408,6 +440,37 @@ BOOST_AUTO_TEST_CASE(ray_sphere_intersection,
 #undef ARBORX_TEST_RAY_SPHERE_INTERSECTION
 #undef ARBORX_TEST_RAY_SPHERE_NO_INTERSECTION
 
+BOOST_AUTO_TEST_CASE(intersects_sphere, *boost::unit_test::tolerance(1e-6f))
+{
+  using ArborX::Sphere;
+  using ArborX::Experimental::Ray;
+
+  constexpr Sphere unit_sphere{{0, 0, 0}, 1};
+#ifdef _MSC_VER
+  auto const inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
+#else
+  constexpr auto inf = KokkosExt::ArithmeticTraits::infinity<float>::value;
+#endif
+
+  // sphere in front of the ray
+  BOOST_TEST(intersects(Ray{{-2, 0, 0}, {1, 0, 0}}, unit_sphere));
+  BOOST_TEST(distance(Ray{{-2, 0, 0}, {1, 0, 0}}, unit_sphere) == 1.f);
+  BOOST_TEST(intersects(Ray{{1, -2, 0}, {0, 1, 0}}, unit_sphere));
+  BOOST_TEST(distance(Ray{{1, -2, 0}, {0, 1, 0}}, unit_sphere) == 2.f);
+
+  // ray origin inside the sphere
+  BOOST_TEST(intersects(Ray{{.5, 0, 0}, {0, 0, 1}}, unit_sphere));
+  BOOST_TEST(distance(Ray{{.5, 0, 0}, {0, 0, 1}}, unit_sphere) == 0.f);
+  BOOST_TEST(intersects(Ray{{1, 0, 0}, {1, 0, 0}}, unit_sphere));
+  BOOST_TEST(distance(Ray{{1, 0, 0}, {1, 0, 0}}, unit_sphere) == 0.f);
+
+  // sphere behind the ray, or missed by it
+  BOOST_TEST(!intersects(Ray{{-2, 0, 0}, {-1, 0, 0}}, unit_sphere));
+  BOOST_TEST(distance(Ray{{-2, 0, 0}, {-1, 0, 0}}, unit_sphere) == inf);
+  BOOST_TEST(!intersects(Ray{{-2, -2, -2}, {1, 0, 0}}, unit_sphere));
+  BOOST_TEST(distance(Ray{{-2, -2, -2}, {1, 0, 0}}, unit_sphere) == inf);
+}
+
 BOOST_AUTO_TEST_CASE(intersects_triangle)
 {
   using ArborX::Experimental::Ray;
@@ -0,0 +1,120 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+#include <ArborX_Box.hpp>
+#include <ArborX_KDOP.hpp>
+#include <ArborX_SweptBox.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+
+BOOST_AUTO_TEST_CASE(swept_box_intersects_box)
+{
+  using ArborX::Box;
+  using ArborX::Experimental::SweptBox;
+
+  constexpr Box unit_box{{0, 0, 0}, {1, 1, 1}};
+  constexpr Box moving{{-3, .25, .25}, {-2, .75, .75}};
+
+  // reaches the box during the step
+  BOOST_TEST(intersects(SweptBox{moving, {4, 0, 0}}, unit_box));
+  BOOST_TEST(intersects(SweptBox{moving, {2, 0, 0}}, unit_box));
+  // stops short of it
+  BOOST_TEST(!intersects(SweptBox{moving, {1.5, 0, 0}}, unit_box));
+  // moves away from it
+  BOOST_TEST(!intersects(SweptBox{moving, {-4, 0, 0}}, unit_box));
+  // passes next to it
+  BOOST_TEST(!intersects(SweptBox{moving, {4, 2, 0}}, unit_box));
+  // overlaps it from the start without moving
+  BOOST_TEST(intersects(SweptBox{unit_box, {0, 0, 0}}, unit_box));
+  BOOST_TEST(!intersects(SweptBox{moving, {0, 0, 0}}, unit_box));
+  // empty boxes are never hit
+  BOOST_TEST(!intersects(SweptBox{moving, {4, 0, 0}}, Box{}));
+  BOOST_TEST(!intersects(SweptBox{Box{}, {4, 0, 0}}, unit_box));
+
+  // the interval of contact is that of the overlap of the moving box
+  float tmin;
+  float tmax;
+  BOOST_TEST(intersection(SweptBox{moving, {4, 0, 0}}, unit_box, tmin, tmax));
+  BOOST_TEST(tmin == .5f);
+  BOOST_TEST(tmax == 1.f);
+  BOOST_TEST(intersection(SweptBox{moving, {8, 0, 0}}, unit_box, tmin, tmax));
+  BOOST_TEST(tmin == .25f);
+  BOOST_TEST(tmax == .5f);
+
+  // the time of impact is the first contact
+  BOOST_TEST(distance(SweptBox{moving, {4, 0, 0}}, unit_box) == .5f);
+  BOOST_TEST(distance(SweptBox{unit_box, {4, 0, 0}}, unit_box) == 0.f);
+  BOOST_TEST(std::isinf(distance(SweptBox{moving, {1, 0, 0}}, unit_box)));
+}
+
+BOOST_AUTO_TEST_CASE(swept_box_intersects_point)
+{
+  using ArborX::Box;
+  using ArborX::Point;
+  using ArborX::Experimental::SweptBox;
+
+  constexpr Box moving{{0, 0, 0}, {1, 1, 1}};
+  BOOST_TEST(intersects(SweptBox{moving, {0, 0, 2}}, Point{.5, .5, 2.5}));
+  BOOST_TEST(!intersects(SweptBox{moving, {0, 0, 2}}, Point{.5, .5, 3.5}));
+  BOOST_TEST(!intersects(SweptBox{moving, {0, 0, 2}}, Point{1.5, .5, 2.5}));
+  BOOST_TEST(distance(SweptBox{moving, {0, 0, 2}}, Point{.5, .5, 2}) == .5f);
+}
+
+BOOST_AUTO_TEST_CASE(segment_intersects_box)
+{
+  using ArborX::Box;
+  using ArborX::Experimental::Segment;
+
+  constexpr Box unit_box{{0, 0, 0}, {1, 1, 1}};
+
+  BOOST_TEST(intersects(Segment{{-1, .5, .5}, {3, .5, .5}}, unit_box));
+  BOOST_TEST(intersects(Segment{{.5, .5, .5}, {.6, .6, .6}}, unit_box));
+  BOOST_TEST(!intersects(Segment{{-1, .5, .5}, {-.5, .5, .5}}, unit_box));
+  BOOST_TEST(!intersects(Segment{{-1, 1.5, .5}, {3, 1.5, .5}}, unit_box));
+  // segment along a diagonal cutting a corner
+  BOOST_TEST(intersects(Segment{{-.5, .5, .5}, {.5, -.5, .5}}, unit_box));
+  BOOST_TEST(!intersects(Segment{{-.6, .5, .5}, {.5, -.6, .5}}, unit_box));
+
+  BOOST_TEST(distance(Segment{{-1, .5, .5}, {3, .5, .5}}, unit_box) == .25f);
+  BOOST_TEST(distance(Segment{{3, .5, .5}, {-1, .5, .5}}, unit_box) == .5f);
+}
+
+BOOST_AUTO_TEST_CASE(swept_box_intersects_kdop)
+{
+  using ArborX::Box;
+  using ArborX::Point;
+  using ArborX::Experimental::KDOP;
+  using ArborX::Experimental::Segment;
+  using ArborX::Experimental::SweptBox;
+
+  // unit cube with the (1, 1, z) edge chopped away
+  KDOP<18> x;
+  for (auto const &point : {Point{0, 0, 0}, Point{1, 0, 0}, Point{1, .5, 0},
+                            Point{.5, 1, 0}, Point{0, 1, 0}, Point{0, 0, 1},
+                            Point{1, 0, 1}, Point{1, .5, 1}, Point{.5, 1, 1},
+                            Point{0, 1, 1}})
+    x += point;
+
+  // through the chopped edge, which a box would not miss
+  Segment const segment{{1.4, .4, .5}, {.4, 1.4, .5}};
+  BOOST_TEST(!intersects(segment, x));
+  BOOST_TEST(intersects(segment, (Box)x));
+  // into its side
+  BOOST_TEST(intersects(Segment{{2, .25, .5}, {0, .25, .5}}, x));
+  BOOST_TEST(distance(Segment{{2, .25, .5}, {0, .25, .5}}, x) == .5f);
+
+  constexpr Box moving{{-2, 0, 0}, {-1, .5, .5}};
+  BOOST_TEST(intersects(SweptBox{moving, {2, 0, 0}}, x));
+  BOOST_TEST(distance(SweptBox{moving, {2, 0, 0}}, x) == .5f);
+  BOOST_TEST(!intersects(SweptBox{moving, {.5, 0, 0}}, x));
+  BOOST_TEST(!intersects(SweptBox{moving, {2, 0, 0}}, KDOP<18>{}));
+}
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * Copyright (c) 2017-2023 by the ArborX authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the ArborX library. ArborX is                       *
+ * distributed under a BSD 3-clause license. For the licensing terms see    *
+ * the LICENSE file in the top-level directory.                             *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "ArborXTest_Cloud.hpp"
+#include "ArborX_EnableDeviceTypes.hpp" // ARBORX_DEVICE_TYPES
+#include <ArborX_LinearBVH.hpp>
+#include <ArborX_TreeSerialization.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Search_UnitTestHelpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(TreeSerialization)
+
+namespace tt = boost::test_tools;
+
+// Copy the serialized tree into a buffer with the alignment of a
+// memory-mapped file
+struct AlignedBuffer
+{
+  AlignedBuffer(std::string const &str)
+      : _storage(str.size() + 64)
+      , _size(str.size())
+  {
+    void *ptr = _storage.data();
+    std::size_t space = _storage.size();
+    _data = std::align(64, _size, ptr, space);
+    std::copy(str.begin(), str.end(), static_cast<char *>(_data));
+  }
+  std::vector<char> _storage;
+  std::size_t _size;
+  void *_data;
+};
+
+template <typename ExecutionSpace, typename Tree, typename Boxes>
+void checkSameQueryResults(ExecutionSpace const &space, Tree const &tree,
+                           Tree const &other_tree, Boxes const &boxes)
+{
+  BOOST_TEST(tree.size() == other_tree.size());
+  BOOST_TEST(ArborX::Details::equals(
+      static_cast<ArborX::Box>(tree.bounds()),
+      static_cast<ArborX::Box>(other_tree.bounds())));
+
+  auto const boxes_host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, boxes);
+  std::vector<ArborX::Box> query_boxes;
+  for (int i = 0; i < (int)boxes_host.extent(0); i += 3)
+  {
+    auto box = boxes_host(i);
+    ArborX::Details::expand(box, boxes_host((i + 1) % boxes_host.extent(0)));
+    query_boxes.push_back(box);
+  }
+  using DeviceType =
+      Kokkos::Device<ExecutionSpace, typename Tree::memory_space>;
+  auto const queries = makeIntersectsBoxQueries<DeviceType>(query_boxes);
+  BOOST_TEST(query(space, tree, queries) == query(space, other_tree, queries),
+             tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(save_and_load, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+
+  ExecutionSpace space;
+
+  for (int n : {0, 1, 2, 100})
+  {
+    auto const boxes =
+        ArborXTest::make_random_cloud<ArborX::Box>(space, n ? n : 1);
+    auto const primitives = Kokkos::subview(boxes, Kokkos::make_pair(0, n));
+    Tree tree(space, primitives);
+
+    std::stringstream ss;
+    ArborX::Experimental::saveTree(space, tree, ss);
+
+    auto const loaded_tree =
+        ArborX::Experimental::loadTree<Tree>(space, ss);
+    checkSameQueryResults(space, tree, loaded_tree, boxes);
+
+    AlignedBuffer buffer(ss.str());
+    auto const mapped_tree = ArborX::Experimental::loadTree<Tree>(
+        space, buffer._data, buffer._size);
+    checkSameQueryResults(space, tree, mapped_tree, boxes);
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(load_and_refit, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<ArborX::Box>,
+      ArborX::Details::DefaultIndexableGetter,
+      ArborX::Experimental::Quantized<ArborX::Box>>;
+
+  ExecutionSpace space;
+
+  auto const boxes = ArborXTest::make_random_cloud<ArborX::Box>(space, 50);
+  Tree tree(space, boxes);
+
+  std::stringstream ss;
+  ArborX::Experimental::saveTree(space, tree, ss);
+  auto loaded_tree = ArborX::Experimental::loadTree<Tree>(space, ss);
+  checkSameQueryResults(space, tree, loaded_tree, boxes);
+
+  // The quality of the hierarchy at construction is preserved
+  BOOST_TEST(tree.refit(space, boxes) == 1.f, tt::tolerance(1e-5f));
+  BOOST_TEST(loaded_tree.refit(space, boxes) == 1.f, tt::tolerance(1e-5f));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(load_invalid, DeviceType, ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using MemorySpace = typename DeviceType::memory_space;
+  using Tree = ArborX::BVH<MemorySpace>;
+  using QuantizedTree = ArborX::BasicBoundingVolumeHierarchy<
+      MemorySpace, ArborX::Details::PairIndexVolume<ArborX::Box>,
+      ArborX::Details::DefaultIndexableGetter,
+      ArborX::Experimental::Quantized<ArborX::Box>>;
+
+  ExecutionSpace space;
+
+  std::stringstream garbage("not a tree");
+  BOOST_CHECK_THROW(ArborX::Experimental::loadTree<Tree>(space, garbage),
+                    ArborX::SearchException);
+
+  // Node layouts do not match
+  std::stringstream ss;
+  ArborX::Experimental::saveTree(
+      space, Tree(space, ArborXTest::make_random_cloud<ArborX::Box>(space, 10)),
+      ss);
+  BOOST_CHECK_THROW(ArborX::Experimental::loadTree<QuantizedTree>(space, ss),
+                    ArborX::SearchException);
+
+  // Truncated
+  auto const str = ss.str();
+  std::stringstream truncated(str.substr(0, str.size() - 1));
+  BOOST_CHECK_THROW(ArborX::Experimental::loadTree<Tree>(space, truncated),
+                    ArborX::SearchException);
+  AlignedBuffer buffer(str.substr(0, str.size() - 1));
+  BOOST_CHECK_THROW(
+      ArborX::Experimental::loadTree<Tree>(space, buffer._data, buffer._size),
+      ArborX::SearchException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
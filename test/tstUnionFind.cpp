@@ -16,6 +16,8 @@
 #include "BoostTest_CUDA_clang_workarounds.hpp"
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(UnionFind)
 
 template <typename ExecutionSpace, typename UnionFind>
@@ -110,4 +112,53 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(union_find, DeviceType, ARBORX_DEVICE_TYPES)
                                          (std::vector<int>{0, 0, 0, 0, 0}));
 }
 
+template <ArborX::Details::UnionFindVariant Variant, typename ExecutionSpace>
+void test_union_find_variant(ExecutionSpace const &space)
+{
+  using MemorySpace = typename ExecutionSpace::memory_space;
+#ifdef KOKKOS_ENABLE_SERIAL
+  using UnionFind = ArborX::Details::UnionFind<
+      MemorySpace,
+      /*DoSerial=*/std::is_same_v<ExecutionSpace, Kokkos::Serial>, Variant>;
+#else
+  using UnionFind = ArborX::Details::UnionFind<MemorySpace, false, Variant>;
+#endif
+
+  int const n = 1000;
+
+  Kokkos::View<int *, MemorySpace> labels(
+      Kokkos::view_alloc(space, Kokkos::WithoutInitializing, "Test::labels"),
+      n);
+  ArborX::iota(space, labels);
+  UnionFind union_find(labels);
+
+  // Two interleaved chains, merged concurrently
+  Kokkos::parallel_for(
+      "Test::merge_chains",
+      Kokkos::RangePolicy<ExecutionSpace>(space, 0, n - 2),
+      KOKKOS_LAMBDA(int i) { union_find.merge(i + 2, i); });
+
+  std::vector<int> ref(n);
+  for (int i = 0; i < n; ++i)
+    ref[i] = i % 2;
+  ARBORX_TEST_UNION_FIND_REPRESENTATIVES(space, union_find, ref);
+
+  merge(space, union_find, n - 1, n - 2);
+  ARBORX_TEST_UNION_FIND_REPRESENTATIVES(space, union_find,
+                                         std::vector<int>(n, 0));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(union_find_variants, DeviceType,
+                              ARBORX_DEVICE_TYPES)
+{
+  using ExecutionSpace = typename DeviceType::execution_space;
+  using ArborX::Details::UnionFindVariant;
+
+  ExecutionSpace space;
+
+  test_union_find_variant<UnionFindVariant::ECL>(space);
+  test_union_find_variant<UnionFindVariant::PATH_HALVING>(space);
+  test_union_find_variant<UnionFindVariant::UNION_BY_INDEX>(space);
+}
+
 BOOST_AUTO_TEST_SUITE_END()